@@ -0,0 +1,191 @@
+//
+//  AssetChunkIndex.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetChunkIndex.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
+#include "AssetFileReader.h"
+#include "AssetServerLogging.h"
+
+AssetChunkIndex::AssetChunkIndex(const QDir& filesDirectory, const QDir& manifestsDirectory) :
+    _filesDirectory(filesDirectory),
+    _manifestsDirectory(manifestsDirectory)
+{
+}
+
+void AssetChunkIndex::load() {
+    auto manifestFiles = _manifestsDirectory.entryInfoList(QDir::Files);
+    for (const auto& fileInfo : manifestFiles) {
+        auto hash = fileInfo.fileName();
+        if (!AssetUtils::isValidHash(hash)) {
+            continue;
+        }
+
+        QFile file { fileInfo.absoluteFilePath() };
+        AssetUtils::AssetManifest manifest;
+        if (!_filesDirectory.exists(hash) || !file.open(QIODevice::ReadOnly) ||
+            !AssetUtils::AssetManifest::fromByteArray(file.readAll(), manifest) || manifest.hash.toHex() != hash) {
+            qCDebug(asset_server) << "Removing stale chunk manifest" << hash;
+            file.remove();
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        indexManifest(hash, manifest);
+    }
+
+    qCInfo(asset_server) << "Indexed" << _chunks.size() << "chunks of" << _assetChunks.size() << "chunked assets.";
+}
+
+bool AssetChunkIndex::getManifest(const AssetUtils::AssetHash& hash, AssetUtils::AssetManifest& manifest,
+                                  QByteArray* smallAssetData) {
+    QFile manifestFile { _manifestsDirectory.filePath(hash) };
+    if (manifestFile.open(QIODevice::ReadOnly) && AssetUtils::AssetManifest::fromByteArray(manifestFile.readAll(), manifest)) {
+        ++_numManifestsServed;
+        return true;
+    }
+
+    QFile file { _filesDirectory.filePath(hash) };
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    manifest = AssetUtils::AssetManifest();
+    if (file.size() < AssetUtils::MIN_CHUNKED_ASSET_SIZE) {
+        if (smallAssetData) {
+            *smallAssetData = file.readAll();
+        }
+        return true;
+    }
+
+    // first request for an asset stored before it could be chunked
+    auto data = file.map(0, file.size());
+    if (data) {
+        manifest = AssetUtils::createManifest(reinterpret_cast<const char*>(data), file.size());
+        file.unmap(data);
+    } else {
+        manifest = AssetUtils::createManifest(file.readAll());
+    }
+
+    if (manifest.hash.toHex() != hash) {
+        qCWarning(asset_server) << "Asset file" << hash << "does not match its hash, not chunking it";
+        manifest = AssetUtils::AssetManifest();
+        return false;
+    }
+
+    addManifest(manifest);
+    ++_numManifestsServed;
+    return true;
+}
+
+void AssetChunkIndex::addManifest(const AssetUtils::AssetManifest& manifest) {
+    AssetUtils::AssetHash hash = manifest.hash.toHex();
+    if (!writeManifest(hash, manifest)) {
+        qCWarning(asset_server) << "Failed to write chunk manifest for" << hash;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_assetChunks.contains(hash)) {
+        indexManifest(hash, manifest);
+    }
+}
+
+bool AssetChunkIndex::writeManifest(const AssetUtils::AssetHash& hash, const AssetUtils::AssetManifest& manifest) {
+    QSaveFile file { _manifestsDirectory.filePath(hash) };
+    return file.open(QIODevice::WriteOnly) && file.write(manifest.toByteArray()) >= 0 && file.commit();
+}
+
+void AssetChunkIndex::indexManifest(const AssetUtils::AssetHash& hash, const AssetUtils::AssetManifest& manifest) {
+    auto& chunkHashes = _assetChunks[hash];
+    chunkHashes.reserve((int)manifest.chunks.size());
+    for (const auto& chunk : manifest.chunks) {
+        _chunks.insert(chunk.hash, { hash, chunk.offset, chunk.size });
+        chunkHashes.append(chunk.hash);
+    }
+}
+
+bool AssetChunkIndex::hasChunk(const QByteArray& chunkHash) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _chunks.contains(chunkHash);
+}
+
+bool AssetChunkIndex::readChunk(const QByteArray& chunkHash, QByteArray& data) const {
+    QList<ChunkLocation> locations;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        locations = _chunks.values(chunkHash);
+    }
+
+    // any asset holding the chunk will do, skip the ones removed since
+    for (const auto& location : locations) {
+        AssetFileReader file { _filesDirectory.filePath(location.asset) };
+        if (!file.open()) {
+            continue;
+        }
+
+        data.clear();
+        data.reserve(location.size);
+        bool success = file.readRange(location.offset, location.size, [&](const char* chunk, qint64 size) {
+            data.append(chunk, size);
+            return true;
+        });
+
+        if (success && AssetUtils::hashData(data) == chunkHash) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AssetChunkIndex::removeAsset(const AssetUtils::AssetHash& hash) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _assetChunks.find(hash);
+        if (it != _assetChunks.end()) {
+            for (const auto& chunkHash : it.value()) {
+                auto location = _chunks.find(chunkHash);
+                while (location != _chunks.end() && location.key() == chunkHash) {
+                    if (location->asset == hash) {
+                        location = _chunks.erase(location);
+                    } else {
+                        ++location;
+                    }
+                }
+            }
+            _assetChunks.erase(it);
+        }
+    }
+
+    QFile::remove(_manifestsDirectory.filePath(hash));
+}
+
+void AssetChunkIndex::recordUpload(qint64 assetSize, qint64 bytesReceived) {
+    ++_numChunkedUploads;
+    _uploadBytesReceived += bytesReceived;
+    _uploadBytesReused += assetSize - bytesReceived;
+}
+
+QJsonObject AssetChunkIndex::getStats() const {
+    static const double BYTES_PER_MEGABYTE = 1024.0 * 1024.0;
+
+    QJsonObject stats;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        stats["1. Chunked Assets"] = _assetChunks.size();
+        stats["2. Indexed Chunks"] = _chunks.size();
+    }
+    stats["3. Chunked Uploads"] = (double)_numChunkedUploads;
+    stats["4. Upload Received (MB)"] = _uploadBytesReceived / BYTES_PER_MEGABYTE;
+    stats["5. Upload Reused (MB)"] = _uploadBytesReused / BYTES_PER_MEGABYTE;
+    stats["6. Manifests Served"] = (double)_numManifestsServed;
+    return stats;
+}
@@ -0,0 +1,77 @@
+//
+//  AssetChunkIndex.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetChunkIndex_h
+#define hifi_AssetChunkIndex_h
+
+#include <atomic>
+#include <mutex>
+
+#include <QtCore/QDir>
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMultiHash>
+
+#include <AssetChunking.h>
+#include <AssetUtils.h>
+
+// Locates content-defined chunks inside the asset files the server already stores.
+// Assets stay whole on disk, so GETs, baking and backups are unchanged; a chunk shared by
+// several assets is only ever transferred once and is read back from whichever file holds it.
+// The manifest of each chunked asset is kept next to the files, keyed by asset hash.
+// Thread-safe, used from the transfer tasks.
+class AssetChunkIndex {
+public:
+    AssetChunkIndex(const QDir& filesDirectory, const QDir& manifestsDirectory);
+
+    // Index the manifests stored on disk
+    void load();
+
+    // Get the manifest of a stored asset, chunking the file the first time it is asked for.
+    // Returns false if there is no such asset; assets below AssetUtils::MIN_CHUNKED_ASSET_SIZE get an empty manifest,
+    // and are read into smallAssetData when it is given.
+    bool getManifest(const AssetUtils::AssetHash& hash, AssetUtils::AssetManifest& manifest,
+                     QByteArray* smallAssetData = nullptr);
+
+    // Record the manifest of an asset that was just stored
+    void addManifest(const AssetUtils::AssetManifest& manifest);
+
+    bool hasChunk(const QByteArray& chunkHash) const;
+    bool readChunk(const QByteArray& chunkHash, QByteArray& data) const;
+
+    void removeAsset(const AssetUtils::AssetHash& hash);
+
+    void recordUpload(qint64 assetSize, qint64 bytesReceived);
+    QJsonObject getStats() const;
+
+private:
+    struct ChunkLocation {
+        AssetUtils::AssetHash asset;
+        AssetUtils::DataOffset offset;
+        AssetUtils::DataOffset size;
+    };
+
+    void indexManifest(const AssetUtils::AssetHash& hash, const AssetUtils::AssetManifest& manifest);
+    bool writeManifest(const AssetUtils::AssetHash& hash, const AssetUtils::AssetManifest& manifest);
+
+    const QDir _filesDirectory;
+    const QDir _manifestsDirectory;
+
+    mutable std::mutex _mutex;
+    QMultiHash<QByteArray, ChunkLocation> _chunks;
+    QHash<AssetUtils::AssetHash, QList<QByteArray>> _assetChunks;
+
+    std::atomic<uint64_t> _numChunkedUploads { 0 };
+    std::atomic<uint64_t> _uploadBytesReceived { 0 };
+    std::atomic<uint64_t> _uploadBytesReused { 0 };
+    std::atomic<uint64_t> _numManifestsServed { 0 };
+};
+
+#endif // hifi_AssetChunkIndex_h
@@ -0,0 +1,71 @@
+//
+//  AssetFileReader.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetFileReader.h"
+
+#include <algorithm>
+
+#include "AssetServerLogging.h"
+
+const qint64 AssetFileReader::DEFAULT_CHUNK_SIZE = 1 << 20;
+
+AssetFileReader::AssetFileReader(const QString& filePath, qint64 chunkSize) :
+    _file(filePath),
+    _chunkSize(std::max(chunkSize, (qint64)1))
+{
+}
+
+bool AssetFileReader::open() {
+    return _file.open(QIODevice::ReadOnly);
+}
+
+void AssetFileReader::close() {
+    _file.close();
+}
+
+bool AssetFileReader::readRange(qint64 offset, qint64 size, const ChunkWriter& writer) {
+    if (offset < 0 || size < 0 || offset + size > _file.size()) {
+        return false;
+    }
+
+    qint64 end = offset + size;
+    while (offset < end) {
+        qint64 chunkSize = std::min(_chunkSize, end - offset);
+
+        if (_mapped) {
+            uchar* chunk = _file.map(offset, chunkSize);
+            if (chunk) {
+                bool written = writer(reinterpret_cast<const char*>(chunk), chunkSize);
+                // dropping the mapping right away keeps the pages of the range out of the resident set
+                _file.unmap(chunk);
+                if (!written) {
+                    return false;
+                }
+                offset += chunkSize;
+                continue;
+            }
+
+            qCDebug(asset_server) << "Could not map" << _file.fileName() << ", falling back to buffered reads";
+            _mapped = false;
+        }
+
+        if (_buffer.size() < chunkSize) {
+            _buffer.resize((int)std::min(_chunkSize, size));
+        }
+        if (!_file.seek(offset) || _file.read(_buffer.data(), chunkSize) != chunkSize) {
+            return false;
+        }
+        if (!writer(_buffer.constData(), chunkSize)) {
+            return false;
+        }
+        offset += chunkSize;
+    }
+    return true;
+}
@@ -0,0 +1,49 @@
+//
+//  AssetFileReader.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetFileReader_h
+#define hifi_AssetFileReader_h
+
+#include <functional>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+
+// Reads a byte range of an asset file in bounded chunks handed straight to a writer.
+// Each chunk is read from a memory mapping of that part of the file, unmapped once written,
+// or through a single reusable buffer when the file can't be mapped.
+// The reader never holds more than one chunk of the range, what the writer keeps is up to it.
+// Paired with a SegmentedPacketListWriter, an asset reply is queued a bounded segment at a time.
+class AssetFileReader {
+public:
+    using ChunkWriter = std::function<bool(const char* data, qint64 size)>;
+
+    static const qint64 DEFAULT_CHUNK_SIZE;
+
+    AssetFileReader(const QString& filePath, qint64 chunkSize = DEFAULT_CHUNK_SIZE);
+
+    bool open();
+    void close();
+    qint64 size() const { return _file.size(); }
+
+    // Call the writer on each consecutive chunk of [offset, offset + size).
+    // Returns false if the range is out of the file, a read failed or the writer returned false.
+    bool readRange(qint64 offset, qint64 size, const ChunkWriter& writer);
+
+    bool isMapped() const { return _mapped; }
+
+private:
+    QFile _file;
+    qint64 _chunkSize;
+    QByteArray _buffer;
+    bool _mapped { true };
+};
+
+#endif // hifi_AssetFileReader_h
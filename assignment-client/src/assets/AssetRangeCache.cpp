@@ -0,0 +1,148 @@
+//
+//  AssetRangeCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetRangeCache.h"
+
+#include <algorithm>
+
+#include <QtCore/QHash>
+
+const qint64 AssetRangeCache::DEFAULT_CAPACITY = 256 * 1024 * 1024;
+const qint64 AssetRangeCache::DEFAULT_MAX_ENTRY_SIZE = 16 * 1024 * 1024;
+
+size_t AssetRangeCache::KeyHash::operator()(const Key& key) const {
+    return qHash(key.hash) ^ qHash(key.offset) ^ (qHash(key.size) << 1);
+}
+
+AssetRangeCache::AssetRangeCache(qint64 capacity, qint64 maxEntrySize) :
+    _capacity(capacity),
+    _maxEntrySize(std::min(maxEntrySize, capacity))
+{
+}
+
+bool AssetRangeCache::get(const QString& hash, qint64 offset, qint64 size, const Loader& loader, QByteArray& data) {
+    if (!isCacheable(size)) {
+        return loader(data);
+    }
+
+    Key key { hash, offset, size };
+    std::promise<Result> promise;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        auto entry = _entries.find(key);
+        if (entry != _entries.end()) {
+            _lru.splice(_lru.begin(), _lru, entry->second.lruPosition);
+            data = entry->second.data;
+            ++_hits;
+            _bytesServedFromMemory += size;
+            return true;
+        }
+
+        auto pending = _inFlight.find(key);
+        if (pending != _inFlight.end()) {
+            auto future = pending->second;
+            lock.unlock();
+
+            ++_coalesced;
+            const auto& result = future.get();
+            if (result.first) {
+                data = result.second;
+                _bytesServedFromMemory += size;
+            }
+            return result.first;
+        }
+
+        ++_misses;
+        _inFlight.emplace(key, promise.get_future().share());
+    }
+
+    try {
+        bool success = loader(data) && data.size() == size;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _inFlight.erase(key);
+            if (success) {
+                insert(key, data);
+            }
+        }
+        promise.set_value({ success, success ? data : QByteArray() });
+
+        return success;
+    } catch (...) {
+        // the requests waiting on this load get the same exception, and the next one loads the range again
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _inFlight.erase(key);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+void AssetRangeCache::insert(const Key& key, const QByteArray& data) {
+    // a concurrent invalidate may have raced a load, the newest data wins
+    auto existing = _entries.find(key);
+    if (existing != _entries.end()) {
+        remove(existing->second.lruPosition);
+    }
+
+    while (!_lru.empty() && _usedBytes + data.size() > _capacity) {
+        evict(std::prev(_lru.end()));
+    }
+
+    _lru.push_front(key);
+    _entries.emplace(key, Entry { data, _lru.begin() });
+    _usedBytes += data.size();
+}
+
+void AssetRangeCache::remove(LRU::iterator position) {
+    auto entry = _entries.find(*position);
+    _usedBytes -= entry->second.data.size();
+    _entries.erase(entry);
+    _lru.erase(position);
+}
+
+void AssetRangeCache::evict(LRU::iterator position) {
+    remove(position);
+    ++_evictions;
+}
+
+void AssetRangeCache::invalidate(const QString& hash) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto it = _lru.begin(); it != _lru.end();) {
+        auto position = it++;
+        if (position->hash == hash) {
+            remove(position);
+        }
+    }
+}
+
+void AssetRangeCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _lru.clear();
+    _usedBytes = 0;
+}
+
+AssetRangeCache::Stats AssetRangeCache::getStats() const {
+    Stats stats;
+    stats.hits = _hits;
+    stats.misses = _misses;
+    stats.coalesced = _coalesced;
+    stats.evictions = _evictions;
+    stats.bytesServedFromMemory = _bytesServedFromMemory;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    stats.usedBytes = _usedBytes;
+    stats.numEntries = _entries.size();
+    return stats;
+}
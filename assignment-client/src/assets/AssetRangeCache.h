@@ -0,0 +1,101 @@
+//
+//  AssetRangeCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetRangeCache_h
+#define hifi_AssetRangeCache_h
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+// Size-bounded LRU of asset byte ranges served by the asset server.
+// Assets are content addressed so a cached range never goes stale; it only has to be dropped
+// when the file behind the hash is deleted. Concurrent requests for a range that is
+// still being loaded wait for that single load instead of reading the file again.
+class AssetRangeCache {
+public:
+    // Fill `data` with the requested range, return false if it could not be read
+    using Loader = std::function<bool(QByteArray& data)>;
+
+    static const qint64 DEFAULT_CAPACITY;
+    static const qint64 DEFAULT_MAX_ENTRY_SIZE;
+
+    struct Stats {
+        uint64_t hits { 0 };
+        uint64_t misses { 0 };
+        uint64_t coalesced { 0 };
+        uint64_t evictions { 0 };
+        uint64_t bytesServedFromMemory { 0 };
+        qint64 usedBytes { 0 };
+        size_t numEntries { 0 };
+    };
+
+    AssetRangeCache(qint64 capacity = DEFAULT_CAPACITY, qint64 maxEntrySize = DEFAULT_MAX_ENTRY_SIZE);
+
+    // Ranges larger than this are streamed from disk and never enter the cache
+    bool isCacheable(qint64 size) const { return size > 0 && size <= _maxEntrySize; }
+
+    // Get the range of the asset with this hex hash from memory, from an identical load in flight, or by calling the loader.
+    // If the loader throws, the exception reaches this caller and every one that was waiting on that load.
+    bool get(const QString& hash, qint64 offset, qint64 size, const Loader& loader, QByteArray& data);
+
+    // Drop every cached range of an asset, keyed by its hex hash
+    void invalidate(const QString& hash);
+    void clear();
+
+    Stats getStats() const;
+
+private:
+    struct Key {
+        QString hash;
+        qint64 offset;
+        qint64 size;
+
+        bool operator==(const Key& other) const {
+            return offset == other.offset && size == other.size && hash == other.hash;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+    using Result = std::pair<bool, QByteArray>;
+    using LRU = std::list<Key>;
+    struct Entry {
+        QByteArray data;
+        LRU::iterator lruPosition;
+    };
+
+    void insert(const Key& key, const QByteArray& data);
+    void remove(LRU::iterator position);
+    void evict(LRU::iterator position);
+
+    const qint64 _capacity;
+    const qint64 _maxEntrySize;
+
+    mutable std::mutex _mutex;
+    LRU _lru; // most recently used first
+    std::unordered_map<Key, Entry, KeyHash> _entries;
+    std::unordered_map<Key, std::shared_future<Result>, KeyHash> _inFlight;
+    qint64 _usedBytes { 0 };
+
+    std::atomic<uint64_t> _hits { 0 };
+    std::atomic<uint64_t> _misses { 0 };
+    std::atomic<uint64_t> _coalesced { 0 };
+    std::atomic<uint64_t> _evictions { 0 };
+    std::atomic<uint64_t> _bytesServedFromMemory { 0 };
+};
+
+#endif // hifi_AssetRangeCache_h
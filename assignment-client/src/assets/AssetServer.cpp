@@ -35,10 +35,14 @@
 #include <PathUtils.h>
 #include <image/TextureProcessing.h>
 
+#include "AssetChunkIndex.h"
 #include "AssetServerLogging.h"
 #include "BakeAssetTask.h"
+#include "BakeScheduler.h"
+#include "ChunkQueryTask.h"
 #include "SendAssetTask.h"
 #include "UploadAssetTask.h"
+#include "UploadChunkedAssetTask.h"
 
 static const uint8_t MIN_CORES_FOR_MULTICORE = 4;
 static const uint8_t CPU_AFFINITY_COUNT_HIGH = 2;
@@ -125,7 +129,7 @@ void AssetServer::bakeAsset(const AssetUtils::AssetHash& assetHash, const AssetU
         connect(task.get(), &BakeAssetTask::bakeFailed, this, &AssetServer::handleFailedBake);
         connect(task.get(), &BakeAssetTask::bakeAborted, this, &AssetServer::handleAbortedBake);
 
-        _bakingTaskPool.start(task.get());
+        _bakeScheduler->schedule(task, assetHash, assetPath, QFileInfo(filePath).size());
     } else {
         qDebug() << "Already in queue";
     }
@@ -295,6 +299,7 @@ AssetServer::AssetServer(ReceivedMessage& message) :
     ThreadedAssignment(message),
     _transferTaskPool(this),
     _bakingTaskPool(this),
+    _bakeScheduler(new BakeScheduler(_bakingTaskPool, this)),
     _filesizeLimit(AssetUtils::MAX_UPLOAD_SIZE)
 {
     BAKEABLE_TEXTURE_EXTENSIONS = image::getSupportedFormats();
@@ -304,11 +309,12 @@ AssetServer::AssetServer(ReceivedMessage& message) :
     // so the ideal is greater than the number of cores on the system.
     static const int TASK_POOL_THREAD_COUNT = 50;
     _transferTaskPool.setMaxThreadCount(TASK_POOL_THREAD_COUNT);
-    _bakingTaskPool.setMaxThreadCount(1);
 
     // Queue all requests until the Asset Server is fully setup
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
-    packetReceiver.registerListenerForTypes({ PacketType::AssetGet, PacketType::AssetGetInfo, PacketType::AssetUpload, PacketType::AssetMappingOperation }, this, "queueRequests");
+    packetReceiver.registerListenerForTypes({ PacketType::AssetGet, PacketType::AssetGetInfo, PacketType::AssetUpload,
+                                             PacketType::AssetUploadChunked, PacketType::AssetChunkQuery,
+                                             PacketType::AssetMappingOperation }, this, "queueRequests");
 
 #ifdef Q_OS_WIN
     updateConsumedCores();
@@ -330,6 +336,11 @@ void AssetServer::aboutToFinish() {
     // remove pending transfer tasks
     _transferTaskPool.clear();
 
+    // remove pending bakes that the scheduler never started
+    for (auto& hash : _bakeScheduler->clearQueue()) {
+        _pendingBakes.remove(hash);
+    }
+
     // abort each of our still running bake tasks, remove pending bakes that were never put on the thread pool
     auto it = _pendingBakes.begin();
     while (it != _pendingBakes.end()) {
@@ -363,6 +374,7 @@ void AssetServer::run() {
 }
 
 static const QString ASSET_FILES_SUBDIR = "files";
+static const QString ASSET_MANIFESTS_SUBDIR = "manifests";
 
 void AssetServer::completeSetup() {
     auto nodeList = DependencyManager::get<NodeList>();
@@ -424,6 +436,24 @@ void AssetServer::completeSetup() {
         return;
     }
 
+    // chunk manifests live next to the files they describe
+    QDir manifestsDirectory = _resourcesDirectory;
+    if (!_resourcesDirectory.mkpath(ASSET_MANIFESTS_SUBDIR) || !manifestsDirectory.cd(ASSET_MANIFESTS_SUBDIR)) {
+        qCCritical(asset_server) << "Unable to create manifest directory for asset-server files. Stopping assignment.";
+        setFinished(true);
+        return;
+    }
+    _chunkIndex = std::make_shared<AssetChunkIndex>(_filesDirectory, manifestsDirectory);
+
+    // bound the oven processes baking at once
+    static const QString MAX_CONCURRENT_BAKES_OPTION = "max_concurrent_bakes";
+    static const QString BAKE_MEMORY_BUDGET_OPTION = "bake_memory_budget";
+    static const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
+    auto maxConcurrentBakes = assetServerObject[MAX_CONCURRENT_BAKES_OPTION].toInt(0);
+    auto bakeMemoryBudget = (qint64)assetServerObject[BAKE_MEMORY_BUDGET_OPTION].toInt(0) * BYTES_PER_MEGABYTE;
+    _bakeScheduler->setLimits(maxConcurrentBakes > 0 ? maxConcurrentBakes : BakeScheduler::DEFAULT_MAX_CONCURRENT_BAKES,
+                              bakeMemoryBudget > 0 ? bakeMemoryBudget : BakeScheduler::DEFAULT_MEMORY_BUDGET);
+
     // load whatever mappings we currently have from the local file
     if (loadMappingsFromFile()) {
         qCInfo(asset_server) << "Serving files from: " << _filesDirectory.path();
@@ -441,6 +471,8 @@ void AssetServer::completeSetup() {
             cleanupBakedFilesForDeletedAssets();
         }
 
+        _chunkIndex->load();
+
         nodeList->addSetOfNodeTypesToNodeInterestSet({ NodeType::Agent, NodeType::EntityScriptServer });
 
         bakeAssets();
@@ -467,6 +499,8 @@ void AssetServer::completeSetup() {
     packetReceiver.registerListener(PacketType::AssetGet, this, "handleAssetGet");
     packetReceiver.registerListener(PacketType::AssetGetInfo, this, "handleAssetGetInfo");
     packetReceiver.registerListener(PacketType::AssetUpload, this, "handleAssetUpload");
+    packetReceiver.registerListener(PacketType::AssetUploadChunked, this, "handleAssetUpload");
+    packetReceiver.registerListener(PacketType::AssetChunkQuery, this, "handleAssetChunkQuery");
     packetReceiver.registerListener(PacketType::AssetMappingOperation, this, "handleAssetMappingOperation");
 
     replayRequests();
@@ -540,6 +574,8 @@ void AssetServer::cleanupUnmappedFiles() {
 
                 if (removeableFile.remove()) {
                     qCDebug(asset_server) << "\tDeleted" << filename << "from asset files directory since it is unmapped.";
+                    _rangeCache->invalidate(filename);
+                    _chunkIndex->removeAsset(filename);
 
                     removeBakedPathsForDeletedAsset(filename);
                 } else {
@@ -684,6 +720,9 @@ void AssetServer::handleGetMappingOperation(ReceivedMessage& message, NLPacketLi
             replyPacket.write(QByteArray::fromHex(originalAssetHash.toUtf8()));
             replyPacket.writePrimitive(wasRedirected);
 
+            // clients are waiting on this asset, bake it ahead of the ones nobody asked for yet
+            _bakeScheduler->noteDemand(originalAssetHash);
+
             auto query = QUrlQuery(url.query());
             bool isSkybox = query.hasQueryItem("skybox");
             if (isSkybox && !loaded) {
@@ -867,7 +906,20 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _filesDirectory, _rangeCache);
+    _transferTaskPool.start(task);
+}
+
+void AssetServer::handleAssetChunkQuery(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    auto minSize = qint64(sizeof(MessageID) + sizeof(AssetUtils::AssetChunkQueryType));
+
+    if (message->getSize() < minSize) {
+        qCDebug(asset_server) << "ERROR bad chunk query";
+        return;
+    }
+
+    // manifests may have to be computed from the file, keep that off this thread
+    auto task = new ChunkQueryTask(message, senderNode, _chunkIndex);
     _transferTaskPool.start(task);
 }
 
@@ -879,10 +931,17 @@ void AssetServer::handleAssetUpload(QSharedPointer<ReceivedMessage> message, Sha
 
 
     if (canWriteToAssetServer) {
-        qCDebug(asset_server) << "Starting an UploadAssetTask for upload from" << message->getSourceID();
+        if (message->getType() == PacketType::AssetUploadChunked) {
+            qCDebug(asset_server) << "Starting an UploadChunkedAssetTask for upload from" << message->getSourceID();
 
-        auto task = new UploadAssetTask(message, senderNode, _filesDirectory, _filesizeLimit);
-        _transferTaskPool.start(task);
+            auto task = new UploadChunkedAssetTask(message, senderNode, _filesDirectory, _filesizeLimit, _chunkIndex);
+            _transferTaskPool.start(task);
+        } else {
+            qCDebug(asset_server) << "Starting an UploadAssetTask for upload from" << message->getSourceID();
+
+            auto task = new UploadAssetTask(message, senderNode, _filesDirectory, _filesizeLimit, _chunkIndex);
+            _transferTaskPool.start(task);
+        }
     } else {
         // this is a node the domain told us is not allowed to rez entities
         // for now this also means it isn't allowed to add assets
@@ -957,6 +1016,24 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     });
 
+    static const double BYTES_PER_MEGABYTE = 1024.0 * 1024.0;
+    auto cacheStats = _rangeCache->getStats();
+    auto cacheRequests = cacheStats.hits + cacheStats.misses + cacheStats.coalesced;
+    QJsonObject rangeCacheStats;
+    rangeCacheStats["1. Hits"] = (double)cacheStats.hits;
+    rangeCacheStats["2. Misses"] = (double)cacheStats.misses;
+    rangeCacheStats["3. Coalesced"] = (double)cacheStats.coalesced;
+    rangeCacheStats["4. Hit Rate (%)"] = cacheRequests > 0 ? 100.0 * (cacheStats.hits + cacheStats.coalesced) / cacheRequests : 0.0;
+    rangeCacheStats["5. Served From Memory (MB)"] = cacheStats.bytesServedFromMemory / BYTES_PER_MEGABYTE;
+    rangeCacheStats["6. Evictions"] = (double)cacheStats.evictions;
+    rangeCacheStats["7. Entries"] = (int)cacheStats.numEntries;
+    rangeCacheStats["8. Used (MB)"] = cacheStats.usedBytes / BYTES_PER_MEGABYTE;
+    serverStats["Asset Range Cache"] = rangeCacheStats;
+    serverStats["Bake Scheduler"] = _bakeScheduler->getStats();
+    if (_chunkIndex) {
+        serverStats["Chunked Transfers"] = _chunkIndex->getStats();
+    }
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
@@ -1174,6 +1251,8 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
 
             if (removeableFile.remove()) {
                 qCDebug(asset_server) << "\tDeleted" << hash << "from asset files directory since it is now unmapped.";
+                _rangeCache->invalidate(hash);
+                _chunkIndex->removeAsset(hash);
 
                 removeBakedPathsForDeletedAsset(hash);
             } else {
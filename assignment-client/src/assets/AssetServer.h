@@ -18,6 +18,7 @@
 
 #include <ThreadedAssignment.h>
 
+#include "AssetRangeCache.h"
 #include "AssetUtils.h"
 #include "ReceivedMessage.h"
 
@@ -68,7 +69,9 @@ struct AssetMeta {
     QString redirectTarget;
 };
 
+class AssetChunkIndex;
 class BakeAssetTask;
+class BakeScheduler;
 
 class AssetServer : public ThreadedAssignment {
     Q_OBJECT
@@ -87,6 +90,7 @@ private slots:
     void handleAssetGetInfo(QSharedPointer<ReceivedMessage> packet, SharedNodePointer senderNode);
     void handleAssetGet(QSharedPointer<ReceivedMessage> packet, SharedNodePointer senderNode);
     void handleAssetUpload(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer senderNode);
+    void handleAssetChunkQuery(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAssetMappingOperation(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
     void sendStatsPacket() override;
@@ -156,8 +160,15 @@ private:
     /// Task pool for handling uploads and downloads of assets
     QThreadPool _transferTaskPool;
 
+    /// Hot asset ranges shared by the send tasks
+    std::shared_ptr<AssetRangeCache> _rangeCache { std::make_shared<AssetRangeCache>() };
+
+    /// Chunks of the stored assets, for incremental transfers
+    std::shared_ptr<AssetChunkIndex> _chunkIndex;
+
     QHash<AssetUtils::AssetHash, std::shared_ptr<BakeAssetTask>> _pendingBakes;
     QThreadPool _bakingTaskPool;
+    BakeScheduler* _bakeScheduler;
 
     QMutex _queuedRequestsMutex;
     bool _isQueueingRequests { true };
@@ -0,0 +1,178 @@
+//
+//  BakeScheduler.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakeScheduler.h"
+
+#include <algorithm>
+#include <thread>
+
+#include <QtCore/QJsonArray>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "AssetServerLogging.h"
+#include "BakeAssetTask.h"
+
+const int BakeScheduler::DEFAULT_MAX_CONCURRENT_BAKES = std::max(1, std::min(4, (int)std::thread::hardware_concurrency() / 2));
+const qint64 BakeScheduler::DEFAULT_MEMORY_BUDGET = 2LL * 1024 * 1024 * 1024;
+
+// An oven holds the source asset and its decoded form (mesh buffers, decompressed texture mips)
+static const qint64 BAKE_MEMORY_PER_ASSET_BYTE = 8;
+static const qint64 BAKE_PROCESS_MEMORY = 64 * 1024 * 1024;
+
+static const size_t NUM_RECENT_BAKES_IN_STATS = 10;
+static const double BYTES_PER_MEGABYTE = 1024.0 * 1024.0;
+
+BakeScheduler::BakeScheduler(QThreadPool& pool, QObject* parent) :
+    QObject(parent),
+    _pool(pool)
+{
+    setLimits(DEFAULT_MAX_CONCURRENT_BAKES, DEFAULT_MEMORY_BUDGET);
+}
+
+void BakeScheduler::setLimits(int maxConcurrentBakes, qint64 memoryBudget) {
+    _maxConcurrentBakes = std::max(1, maxConcurrentBakes);
+    _memoryBudget = std::max((qint64)0, memoryBudget);
+
+    // every running bake blocks a pool thread while it waits for its oven
+    _pool.setMaxThreadCount(_maxConcurrentBakes);
+
+    startBakes();
+}
+
+qint64 BakeScheduler::estimateBakeMemory(qint64 assetSize) {
+    return BAKE_PROCESS_MEMORY + assetSize * BAKE_MEMORY_PER_ASSET_BYTE;
+}
+
+void BakeScheduler::schedule(std::shared_ptr<BakeAssetTask> task, const AssetUtils::AssetHash& hash,
+                             const AssetUtils::AssetPath& path, qint64 assetSize) {
+    if (_queued.contains(hash) || _running.contains(hash)) {
+        return;
+    }
+
+    auto it = _queued.insert(hash, { task, path, assetSize, estimateBakeMemory(assetSize), 0, usecTimestampNow() });
+    pushPriority(hash, it.value());
+
+    connect(task.get(), &BakeAssetTask::bakeComplete, this, [this, hash] { bakeFinished(hash, "Complete"); });
+    connect(task.get(), &BakeAssetTask::bakeFailed, this, [this, hash] { bakeFinished(hash, "Failed"); });
+    connect(task.get(), &BakeAssetTask::bakeAborted, this, [this, hash] { bakeFinished(hash, "Aborted"); });
+
+    startBakes();
+}
+
+void BakeScheduler::noteDemand(const AssetUtils::AssetHash& hash) {
+    auto it = _queued.find(hash);
+    if (it != _queued.end()) {
+        ++it->demand;
+        pushPriority(hash, it.value());
+    }
+}
+
+void BakeScheduler::pushPriority(const AssetUtils::AssetHash& hash, const QueuedBake& bake) {
+    _priorities.push({ bake.demand, bake.assetSize, _nextSequence++, hash });
+}
+
+void BakeScheduler::startBakes() {
+    while (!_priorities.empty() && _running.size() < _maxConcurrentBakes) {
+        const auto& top = _priorities.top();
+        auto it = _queued.find(top.hash);
+        if (it == _queued.end() || it->demand != top.demand) {
+            // stale entry, the bake was started, dropped or its demand went up since
+            _priorities.pop();
+            continue;
+        }
+
+        // the first bake always runs, even if the estimate alone exceeds the budget
+        if (!_running.isEmpty() && _runningMemory + it->estimatedMemory > _memoryBudget) {
+            break;
+        }
+
+        auto hash = top.hash;
+        _priorities.pop();
+
+        auto bake = it.value();
+        _queued.erase(it);
+
+        _running.insert(hash, { bake.path, bake.estimatedMemory, bake.queuedAt, usecTimestampNow() });
+        _runningMemory += bake.estimatedMemory;
+
+        qCDebug(asset_server) << "Starting bake of" << bake.path << "demand" << bake.demand
+            << "running" << _running.size() << "queued" << _queued.size();
+        _pool.start(bake.task.get());
+    }
+}
+
+void BakeScheduler::bakeFinished(const AssetUtils::AssetHash& hash, const QString& result) {
+    auto it = _running.find(hash);
+    if (it == _running.end()) {
+        return;
+    }
+
+    auto now = usecTimestampNow();
+    CompletedBake completed { it->path, it->startedAt - it->queuedAt, now - it->startedAt, result };
+    _runningMemory -= it->estimatedMemory;
+    _running.erase(it);
+
+    if (result == "Complete") {
+        ++_numCompleted;
+    } else if (result == "Failed") {
+        ++_numFailed;
+    } else {
+        ++_numAborted;
+    }
+    _totalBakeUsecs += completed.bakeUsecs;
+    _totalWaitUsecs += completed.waitUsecs;
+    _maxBakeUsecs = std::max(_maxBakeUsecs, completed.bakeUsecs);
+
+    _recentBakes.push_front(completed);
+    if (_recentBakes.size() > NUM_RECENT_BAKES_IN_STATS) {
+        _recentBakes.pop_back();
+    }
+
+    startBakes();
+}
+
+QList<AssetUtils::AssetHash> BakeScheduler::clearQueue() {
+    auto hashes = _queued.keys();
+    _queued.clear();
+    _priorities = std::priority_queue<Priority>();
+    return hashes;
+}
+
+QJsonObject BakeScheduler::getStats() const {
+    auto numFinished = _numCompleted + _numFailed + _numAborted;
+
+    QJsonObject stats;
+    stats["1. Queued"] = _queued.size();
+    stats["2. Running"] = _running.size();
+    stats["3. Max Concurrent"] = _maxConcurrentBakes;
+    stats["4. Memory In Use (MB)"] = _runningMemory / BYTES_PER_MEGABYTE;
+    stats["5. Memory Budget (MB)"] = _memoryBudget / BYTES_PER_MEGABYTE;
+    stats["6. Completed"] = (double)_numCompleted;
+    stats["7. Failed"] = (double)_numFailed;
+    stats["8. Aborted"] = (double)_numAborted;
+    stats["9. Avg Bake (ms)"] = numFinished > 0 ? (double)_totalBakeUsecs / numFinished / USECS_PER_MSEC : 0.0;
+    stats["10. Max Bake (ms)"] = (double)_maxBakeUsecs / USECS_PER_MSEC;
+    stats["11. Avg Wait (ms)"] = numFinished > 0 ? (double)_totalWaitUsecs / numFinished / USECS_PER_MSEC : 0.0;
+
+    QJsonArray recentBakes;
+    for (const auto& bake : _recentBakes) {
+        QJsonObject recent;
+        recent["path"] = bake.path;
+        recent["result"] = bake.result;
+        recent["wait_ms"] = (double)bake.waitUsecs / USECS_PER_MSEC;
+        recent["bake_ms"] = (double)bake.bakeUsecs / USECS_PER_MSEC;
+        recentBakes.append(recent);
+    }
+    stats["12. Recent Bakes"] = recentBakes;
+
+    return stats;
+}
@@ -0,0 +1,129 @@
+//
+//  BakeScheduler.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakeScheduler_h
+#define hifi_BakeScheduler_h
+
+#include <deque>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QThreadPool>
+
+#include <AssetUtils.h>
+
+class BakeAssetTask;
+
+// Decides which bakes run and when. Each BakeAssetTask drives its own oven process, the scheduler
+// only bounds how many of them run at once, by process count and by an estimate of the memory
+// an oven needs for an asset of that size.
+// Queued bakes are ordered by client demand (mapping requests for the unbaked asset), then
+// smallest asset first so a large content pack can't hold back everything behind it.
+// Must be used from the thread of the asset server.
+class BakeScheduler : public QObject {
+    Q_OBJECT
+public:
+    static const int DEFAULT_MAX_CONCURRENT_BAKES;
+    static const qint64 DEFAULT_MEMORY_BUDGET;
+
+    BakeScheduler(QThreadPool& pool, QObject* parent = nullptr);
+
+    void setLimits(int maxConcurrentBakes, qint64 memoryBudget);
+    int getMaxConcurrentBakes() const { return _maxConcurrentBakes; }
+    qint64 getMemoryBudget() const { return _memoryBudget; }
+
+    void schedule(std::shared_ptr<BakeAssetTask> task, const AssetUtils::AssetHash& hash,
+                  const AssetUtils::AssetPath& path, qint64 assetSize);
+
+    // A client asked for the asset while only the unbaked version exists
+    void noteDemand(const AssetUtils::AssetHash& hash);
+
+    // Drop the bakes that were never started, returns their hashes
+    QList<AssetUtils::AssetHash> clearQueue();
+
+    int getQueueDepth() const { return _queued.size(); }
+    int getNumRunning() const { return _running.size(); }
+
+    QJsonObject getStats() const;
+
+    static qint64 estimateBakeMemory(qint64 assetSize);
+
+private:
+    struct QueuedBake {
+        std::shared_ptr<BakeAssetTask> task;
+        AssetUtils::AssetPath path;
+        qint64 assetSize;
+        qint64 estimatedMemory;
+        int demand { 0 };
+        quint64 queuedAt;
+    };
+
+    struct RunningBake {
+        AssetUtils::AssetPath path;
+        qint64 estimatedMemory;
+        quint64 queuedAt;
+        quint64 startedAt;
+    };
+
+    struct Priority {
+        int demand;
+        qint64 assetSize;
+        quint64 sequence;
+        AssetUtils::AssetHash hash;
+
+        // std::priority_queue keeps the largest on top
+        bool operator<(const Priority& other) const {
+            if (demand != other.demand) {
+                return demand < other.demand;
+            }
+            if (assetSize != other.assetSize) {
+                return assetSize > other.assetSize;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    struct CompletedBake {
+        AssetUtils::AssetPath path;
+        quint64 waitUsecs;
+        quint64 bakeUsecs;
+        QString result;
+    };
+
+    void pushPriority(const AssetUtils::AssetHash& hash, const QueuedBake& bake);
+    void startBakes();
+    void bakeFinished(const AssetUtils::AssetHash& hash, const QString& result);
+
+    QThreadPool& _pool;
+    int _maxConcurrentBakes;
+    qint64 _memoryBudget;
+
+    QHash<AssetUtils::AssetHash, QueuedBake> _queued;
+    // Entries whose demand is out of date with _queued are skipped when popped
+    std::priority_queue<Priority> _priorities;
+    quint64 _nextSequence { 0 };
+
+    QHash<AssetUtils::AssetHash, RunningBake> _running;
+    qint64 _runningMemory { 0 };
+
+    std::deque<CompletedBake> _recentBakes;
+    quint64 _numCompleted { 0 };
+    quint64 _numFailed { 0 };
+    quint64 _numAborted { 0 };
+    quint64 _totalBakeUsecs { 0 };
+    quint64 _maxBakeUsecs { 0 };
+    quint64 _totalWaitUsecs { 0 };
+};
+
+#endif // hifi_BakeScheduler_h
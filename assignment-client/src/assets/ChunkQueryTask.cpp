@@ -0,0 +1,80 @@
+//
+//  ChunkQueryTask.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ChunkQueryTask.h"
+
+#include <NLPacketList.h>
+#include <NodeList.h>
+
+#include "AssetServerLogging.h"
+#include "ClientServerUtils.h"
+
+ChunkQueryTask::ChunkQueryTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& senderNode,
+                               std::shared_ptr<AssetChunkIndex> chunkIndex) :
+    _message(message),
+    _senderNode(senderNode),
+    _chunkIndex(chunkIndex)
+{
+}
+
+void ChunkQueryTask::run() {
+    MessageID messageID;
+    _message->readPrimitive(&messageID);
+
+    AssetUtils::AssetChunkQueryType queryType;
+    _message->readPrimitive(&queryType);
+
+    auto replyPacketList = NLPacketList::create(PacketType::AssetChunkQueryReply, QByteArray(), true, true);
+    replyPacketList->writePrimitive(messageID);
+
+    if (queryType == AssetUtils::AssetChunkQueryType::GetManifest) {
+        QString hexHash = _message->read(AssetUtils::SHA256_HASH_LENGTH).toHex();
+
+        AssetUtils::AssetManifest manifest;
+        QByteArray smallAssetData;
+        if (_chunkIndex->getManifest(hexHash, manifest, &smallAssetData)) {
+            replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
+            if (!manifest.chunks.empty()) {
+                replyPacketList->writePrimitive(AssetUtils::AssetManifestReplyType::ChunkManifest);
+                replyPacketList->write(manifest.toByteArray());
+            } else {
+                // too small to be chunked, the client gets the asset itself rather than asking again
+                replyPacketList->writePrimitive(AssetUtils::AssetManifestReplyType::WholeAsset);
+                replyPacketList->write(smallAssetData);
+            }
+        } else {
+            replyPacketList->writePrimitive(AssetUtils::AssetServerError::AssetNotFound);
+        }
+    } else if (queryType == AssetUtils::AssetChunkQueryType::HasChunks) {
+        uint32_t numChunks;
+        _message->readPrimitive(&numChunks);
+
+        if (_message->getBytesLeftToRead() < (qint64)numChunks * (qint64)AssetUtils::SHA256_HASH_LENGTH) {
+            replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
+        } else {
+            QByteArray hasChunks(numChunks, 0);
+            for (uint32_t i = 0; i < numChunks; ++i) {
+                hasChunks[i] = _chunkIndex->hasChunk(_message->read(AssetUtils::SHA256_HASH_LENGTH)) ? 1 : 0;
+            }
+            replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
+            replyPacketList->write(hasChunks);
+        }
+    } else {
+        qCWarning(asset_server) << "Unknown chunk query type" << queryType;
+        replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    if (_senderNode) {
+        nodeList->sendPacketList(std::move(replyPacketList), *_senderNode);
+    } else {
+        nodeList->sendPacketList(std::move(replyPacketList), _message->getSenderSockAddr());
+    }
+}
@@ -0,0 +1,37 @@
+//
+//  ChunkQueryTask.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ChunkQueryTask_h
+#define hifi_ChunkQueryTask_h
+
+#include <memory>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QSharedPointer>
+
+#include "AssetChunkIndex.h"
+#include "Node.h"
+#include "ReceivedMessage.h"
+
+// Answers AssetChunkQuery packets: the manifest of an asset, or which of a list of chunks the server has
+class ChunkQueryTask : public QRunnable {
+public:
+    ChunkQueryTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& senderNode,
+                   std::shared_ptr<AssetChunkIndex> chunkIndex);
+
+    void run() override;
+
+private:
+    QSharedPointer<ReceivedMessage> _message;
+    SharedNodePointer _senderNode;
+    std::shared_ptr<AssetChunkIndex> _chunkIndex;
+};
+
+#endif // hifi_ChunkQueryTask_h
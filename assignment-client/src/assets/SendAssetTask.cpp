@@ -13,24 +13,39 @@
 
 #include <cmath>
 
-#include <QFile>
+#include <QtCore/QThreadPool>
 
 #include <DependencyManager.h>
 #include <NetworkLogging.h>
 #include <NLPacket.h>
 #include <NLPacketList.h>
 #include <NodeList.h>
+#include <SegmentedPacketListWriter.h>
 #include <udt/Packet.h>
 
+#include "AssetFileReader.h"
 #include "AssetUtils.h"
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+// Reads the next segment of a reply, off the thread of the send queue that asked for it
+class ReadReplySegmentTask : public QRunnable {
+public:
+    ReadReplySegmentTask(std::function<void()> read) : _read(read) {}
+
+    void run() override { _read(); }
+
+private:
+    std::function<void()> _read;
+};
+
+SendAssetTask::SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                             std::shared_ptr<AssetRangeCache> rangeCache) :
     QRunnable(),
     _message(message),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _rangeCache(rangeCache)
 {
     
 }
@@ -54,6 +69,19 @@ void SendAssetTask::run() {
         << byteRange.fromInclusive << " to " << byteRange.toExclusive;
     
     qDebug() << "Starting task to send asset: " << hexHash << " for messageID " << messageID;
+
+    // the reply is sent a segment at a time from the send queue callbacks, long after this task is gone
+    auto senderNode = _senderNode;
+    auto senderSockAddr = _message->getSenderSockAddr();
+    auto sendReply = [senderNode, senderSockAddr](std::unique_ptr<NLPacketList> packetList) {
+        auto nodeList = DependencyManager::get<NodeList>();
+        if (senderNode) {
+            return nodeList->sendPacketList(std::move(packetList), *senderNode) >= 0;
+        } else {
+            return nodeList->sendPacketList(std::move(packetList), senderSockAddr) >= 0;
+        }
+    };
+
     auto replyPacketList = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
 
     replyPacketList->write(assetHash);
@@ -65,16 +93,16 @@ void SendAssetTask::run() {
     } else {
         QString filePath = _resourcesDir.filePath(QString(hexHash));
         
-        QFile file { filePath };
+        auto file = std::make_shared<AssetFileReader>(filePath);
 
-        if (file.open(QIODevice::ReadOnly)) {
+        if (file->open()) {
 
             // first fixup the range based on the now known file size
-            byteRange.fixupRange(file.size());
+            byteRange.fixupRange(file->size());
 
             // check if we're being asked to read data that we just don't have
             // because of the file size
-            if (file.size() < byteRange.fromInclusive || file.size() < byteRange.toExclusive) {
+            if (file->size() < byteRange.fromInclusive || file->size() < byteRange.toExclusive) {
                 replyPacketList->writePrimitive(AssetUtils::AssetServerError::InvalidByteRange);
                 qCDebug(networking) << "Bad byte range: " << hexHash << " "
                     << byteRange.fromInclusive << ":" << byteRange.toExclusive;
@@ -82,39 +110,74 @@ void SendAssetTask::run() {
                 // we have a valid byte range, handle it and send the asset
                 auto size = byteRange.size();
 
-                if (byteRange.fromInclusive >= 0) {
-
-                    // this range is positive, meaning we just need to seek into the file and then read from there
-                    file.seek(byteRange.fromInclusive);
-                    replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
-                    replyPacketList->write(file.read(size));
+                // a positive range reads from its start, a negative one reads back from the end of the file
+                auto offset = (byteRange.fromInclusive >= 0) ? byteRange.fromInclusive : file->size() + byteRange.fromInclusive;
+
+                replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
+                replyPacketList->writePrimitive(size);
+
+                SegmentedPacketListWriter::Source source;
+                if (_rangeCache && _rangeCache->isCacheable(size)) {
+                    // hot ranges are served from memory, identical reads in flight share a single load
+                    QByteArray data;
+                    bool isLoaded = _rangeCache->get(hexHash, offset, size, [&](QByteArray& loaded) {
+                        loaded.reserve(size);
+                        return file->readRange(offset, size, [&](const char* chunk, qint64 chunkSize) {
+                            loaded.append(chunk, chunkSize);
+                            return true;
+                        });
+                    }, data);
+                    if (isLoaded && data.size() == size) {
+                        source = [data, position = (qint64)0](qint64 bytesToRead,
+                                                              const SegmentedPacketListWriter::ChunkWriter& writer) mutable {
+                            bool written = writer(data.constData() + position, bytesToRead);
+                            position += bytesToRead;
+                            return written;
+                        };
+                    }
                 } else {
-                    // this range is negative, at least the first part of the read will be back into the end of the file
-
-                    // seek to the part of the file where the negative range begins
-                    file.seek(file.size() + byteRange.fromInclusive);
-
-                    replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
-                    replyPacketList->writePrimitive(size);
+                    // the file is copied chunk by chunk straight into the packets, never as a whole
+                    source = [file, offset](qint64 bytesToRead, const SegmentedPacketListWriter::ChunkWriter& writer) mutable {
+                        bool read = file->readRange(offset, bytesToRead, writer);
+                        offset += bytesToRead;
+                        return read;
+                    };
+                }
 
-                    // first write everything from the negative range to the end of the file
-                    replyPacketList->write(file.read(size));
+                // the reply goes out a bounded segment at a time, the next one is read on the global pool
+                // once the connection has taken the one before, and a reply to a dead connection is dropped
+                bool isSending = false;
+                if (source) {
+                    auto replyWriter = SegmentedPacketListWriter::create(std::move(replyPacketList), size, source, sendReply,
+                                                                         [](std::function<void()> work) {
+                        QThreadPool::globalInstance()->start(new ReadReplySegmentTask(work));
+                    });
+                    replyWriter->setFinishedCallback([hexHash](bool success) {
+                        if (!success) {
+                            // the start of the asset was already out, the client fails a reply that ends short
+                            qCWarning(networking) << "Failed sending asset: " << hexHash;
+                        }
+                    });
+                    isSending = replyWriter->start();
                 }
 
-                qCDebug(networking) << "Sending asset: " << hexHash;
+                if (isSending) {
+                    qCDebug(networking) << "Sending asset: " << hexHash;
+                } else {
+                    qCWarning(networking) << "Failed reading asset: " << hexHash;
+                    replyPacketList = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+                    replyPacketList->write(assetHash);
+                    replyPacketList->writePrimitive(messageID);
+                    replyPacketList->writePrimitive(AssetUtils::AssetServerError::FileOperationFailed);
+                }
             }
-            file.close();
         } else {
             qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
             replyPacketList->writePrimitive(AssetUtils::AssetServerError::AssetNotFound);
         }
     }
 
-    auto nodeList = DependencyManager::get<NodeList>();
-    if (_senderNode) {
-        nodeList->sendPacketList(std::move(replyPacketList), *_senderNode);
-    } else {
-        nodeList->sendPacketList(std::move(replyPacketList), _message->getSenderSockAddr());
+    if (replyPacketList) {
+        sendReply(std::move(replyPacketList));
     }
 }
@@ -17,6 +17,7 @@
 #include <QtCore/QString>
 #include <QtCore/QRunnable>
 
+#include "AssetRangeCache.h"
 #include "AssetUtils.h"
 #include "AssetServer.h"
 #include "Node.h"
@@ -25,7 +26,8 @@ class NLPacket;
 
 class SendAssetTask : public QRunnable {
 public:
-    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir);
+    SendAssetTask(QSharedPointer<ReceivedMessage> message, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                  std::shared_ptr<AssetRangeCache> rangeCache = nullptr);
 
     void run() override;
 
@@ -33,6 +35,7 @@ private:
     QSharedPointer<ReceivedMessage> _message;
     SharedNodePointer _senderNode;
     QDir _resourcesDir;
+    std::shared_ptr<AssetRangeCache> _rangeCache;
 };
 
 #endif
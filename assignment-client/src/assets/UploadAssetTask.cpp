@@ -21,11 +21,12 @@
 #include "ClientServerUtils.h"
 
 UploadAssetTask::UploadAssetTask(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode,
-                                 const QDir& resourcesDir, uint64_t filesizeLimit) :
+                                 const QDir& resourcesDir, uint64_t filesizeLimit, std::shared_ptr<AssetChunkIndex> chunkIndex) :
     _receivedMessage(receivedMessage),
     _senderNode(senderNode),
     _resourcesDir(resourcesDir),
-    _filesizeLimit(filesizeLimit)
+    _filesizeLimit(filesizeLimit),
+    _chunkIndex(chunkIndex)
 {
     
 }
@@ -89,6 +90,11 @@ void UploadAssetTask::run() {
                 qDebug() << "Wrote file" << hexHash << "to disk. Upload complete";
                 file.close();
 
+                // index its chunks so later versions of this asset can be uploaded incrementally
+                if (_chunkIndex && (qint64)fileSize >= AssetUtils::MIN_CHUNKED_ASSET_SIZE) {
+                    _chunkIndex->addManifest(AssetUtils::createManifest(fileData));
+                }
+
                 replyPacket->writePrimitive(AssetUtils::AssetServerError::NoError);
                 replyPacket->write(hash);
             } else {
@@ -0,0 +1,137 @@
+//
+//  UploadChunkedAssetTask.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "UploadChunkedAssetTask.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
+#include <NLPacket.h>
+#include <NodeList.h>
+
+#include "AssetServerLogging.h"
+#include "ClientServerUtils.h"
+
+UploadChunkedAssetTask::UploadChunkedAssetTask(QSharedPointer<ReceivedMessage> receivedMessage, QSharedPointer<Node> senderNode,
+                                               const QDir& resourcesDir, uint64_t filesizeLimit,
+                                               std::shared_ptr<AssetChunkIndex> chunkIndex) :
+    _receivedMessage(receivedMessage),
+    _senderNode(senderNode),
+    _resourcesDir(resourcesDir),
+    _filesizeLimit(filesizeLimit),
+    _chunkIndex(chunkIndex)
+{
+}
+
+void UploadChunkedAssetTask::run() {
+    auto data = _receivedMessage->getMessage();
+
+    QBuffer buffer { &data };
+    buffer.open(QIODevice::ReadOnly);
+
+    MessageID messageID;
+    buffer.read(reinterpret_cast<char*>(&messageID), sizeof(messageID));
+
+    uint32_t manifestSize;
+    buffer.read(reinterpret_cast<char*>(&manifestSize), sizeof(manifestSize));
+
+    AssetUtils::AssetManifest manifest;
+    bool validManifest = AssetUtils::AssetManifest::fromByteArray(buffer.read(manifestSize), manifest);
+
+    auto replyPacket = NLPacket::create(PacketType::AssetUploadReply, -1, true);
+    replyPacket->writePrimitive(messageID);
+
+    AssetUtils::AssetServerError error;
+    if (!validManifest) {
+        qCWarning(asset_server) << "Received a chunked upload with an invalid manifest";
+        error = AssetUtils::AssetServerError::FileOperationFailed;
+    } else if ((uint64_t)manifest.size > _filesizeLimit) {
+        error = AssetUtils::AssetServerError::AssetTooLarge;
+    } else {
+        error = storeAsset(buffer, manifest);
+    }
+
+    replyPacket->writePrimitive(error);
+    if (error == AssetUtils::AssetServerError::NoError) {
+        replyPacket->write(manifest.hash);
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    if (_senderNode) {
+        nodeList->sendPacket(std::move(replyPacket), *_senderNode);
+    } else {
+        nodeList->sendPacket(std::move(replyPacket), _receivedMessage->getSenderSockAddr());
+    }
+}
+
+AssetUtils::AssetServerError UploadChunkedAssetTask::storeAsset(QIODevice& message, const AssetUtils::AssetManifest& manifest) {
+    QString hexHash = manifest.hash.toHex();
+    auto filePath = _resourcesDir.filePath(hexHash);
+
+    qDebug() << "UploadChunkedAssetTask assembling" << hexHash << "from" << manifest.chunks.size() << "chunks";
+
+    QSaveFile file { filePath };
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open" << hexHash << "for writing - upload failed.";
+        return AssetUtils::AssetServerError::FileOperationFailed;
+    }
+
+    QCryptographicHash assetHash(QCryptographicHash::Sha256);
+    qint64 bytesReceived = 0;
+    QByteArray chunkData;
+
+    for (const auto& chunk : manifest.chunks) {
+        uint8_t included = 0;
+        if (message.read(reinterpret_cast<char*>(&included), sizeof(included)) != sizeof(included)) {
+            file.cancelWriting();
+            return AssetUtils::AssetServerError::FileOperationFailed;
+        }
+
+        if (included) {
+            chunkData = message.read(chunk.size);
+            bytesReceived += chunkData.size();
+            if (chunkData.size() != chunk.size || AssetUtils::hashData(chunkData) != chunk.hash) {
+                qWarning() << "Chunk of" << hexHash << "at" << chunk.offset << "does not match the manifest - upload failed.";
+                file.cancelWriting();
+                return AssetUtils::AssetServerError::FileOperationFailed;
+            }
+        } else if (!_chunkIndex->readChunk(chunk.hash, chunkData)) {
+            qDebug() << "Chunk of" << hexHash << "at" << chunk.offset << "is no longer stored, asking for a whole upload.";
+            file.cancelWriting();
+            return AssetUtils::AssetServerError::MissingChunks;
+        }
+
+        assetHash.addData(chunkData);
+        if (file.write(chunkData) != chunkData.size()) {
+            file.cancelWriting();
+            return AssetUtils::AssetServerError::FileOperationFailed;
+        }
+    }
+
+    if (assetHash.result() != manifest.hash) {
+        qWarning() << "Assembled file does not match its hash" << hexHash << "- upload failed.";
+        file.cancelWriting();
+        return AssetUtils::AssetServerError::FileOperationFailed;
+    }
+
+    if (!file.commit()) {
+        qWarning() << "Failed to write file" << hexHash << "- upload failed.";
+        return AssetUtils::AssetServerError::FileOperationFailed;
+    }
+
+    qDebug() << "Wrote file" << hexHash << "to disk from" << bytesReceived << "received of" << manifest.size << "bytes. Upload complete";
+
+    _chunkIndex->addManifest(manifest);
+    _chunkIndex->recordUpload(manifest.size, bytesReceived);
+
+    return AssetUtils::AssetServerError::NoError;
+}
@@ -0,0 +1,44 @@
+//
+//  UploadChunkedAssetTask.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_UploadChunkedAssetTask_h
+#define hifi_UploadChunkedAssetTask_h
+
+#include <memory>
+
+#include <QtCore/QDir>
+#include <QtCore/QRunnable>
+#include <QtCore/QSharedPointer>
+
+#include "AssetChunkIndex.h"
+#include "ReceivedMessage.h"
+
+class Node;
+
+// Stores an asset uploaded as a manifest plus the chunks the server didn't have.
+// The other chunks are copied from the asset files that already hold them.
+class UploadChunkedAssetTask : public QRunnable {
+public:
+    UploadChunkedAssetTask(QSharedPointer<ReceivedMessage> message, QSharedPointer<Node> senderNode,
+                           const QDir& resourcesDir, uint64_t filesizeLimit, std::shared_ptr<AssetChunkIndex> chunkIndex);
+
+    void run() override;
+
+private:
+    AssetUtils::AssetServerError storeAsset(QIODevice& message, const AssetUtils::AssetManifest& manifest);
+
+    QSharedPointer<ReceivedMessage> _receivedMessage;
+    QSharedPointer<Node> _senderNode;
+    QDir _resourcesDir;
+    uint64_t _filesizeLimit;
+    std::shared_ptr<AssetChunkIndex> _chunkIndex;
+};
+
+#endif // hifi_UploadChunkedAssetTask_h
@@ -11,31 +11,105 @@
 
 #include "MessagesMixer.h"
 
+#include <algorithm>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QJsonObject>
 #include <QBuffer>
 #include <LogHandler.h>
 #include <MessagesClient.h>
 #include <NodeList.h>
+#include <NumericalConstants.h>
+#include <PortableHighResolutionClock.h>
 #include <udt/PacketHeaders.h>
 
+#include "../AssignmentClientLogging.h"
+
 const QString MESSAGES_MIXER_LOGGING_NAME = "messages-mixer";
 
-MessagesMixer::MessagesMixer(ReceivedMessage& message) : ThreadedAssignment(message)
+static void sendMessagesPayloads(LimitedNodeList& nodeList, const Node& node, const QByteArray& payloads) {
+    auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+    packetList->write(payloads);
+    nodeList.sendPacketList(std::move(packetList), node);
+}
+
+MessagesMixer::MessagesMixer(ReceivedMessage& message) :
+    ThreadedAssignment(message),
+    _coalesceTimer(this)
 {
-    connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeKilled, this, &MessagesMixer::nodeKilled);
-    auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
+    auto nodeList = DependencyManager::get<NodeList>();
+    connect(nodeList.data(), &NodeList::nodeKilled, this, &MessagesMixer::nodeKilled);
+    connect(nodeList.data(), &NodeList::nodeActivated, this, &MessagesMixer::nodeActivated);
+    connect(nodeList.data(), &NodeList::uuidChanged, this, &MessagesMixer::updateMessagesMixers);
+    connect(&_coalesceTimer, &QTimer::timeout, this, &MessagesMixer::sendCoalescedMessages);
+    auto& packetReceiver = nodeList->getPacketReceiver();
     packetReceiver.registerListener(PacketType::MessagesData, this, "handleMessages");
     packetReceiver.registerListener(PacketType::MessagesSubscribe, this, "handleMessagesSubscribe");
     packetReceiver.registerListener(PacketType::MessagesUnsubscribe, this, "handleMessagesUnsubscribe");
 }
 
 void MessagesMixer::nodeKilled(SharedNodePointer killedNode) {
-    for (auto& channel : _channelSubscribers) {
-        channel.remove(killedNode->getUUID());
+    _subscribers.removeNode(killedNode->getUUID());
+    _coalescedMessages.remove(killedNode->getUUID());
+
+    if (killedNode->getType() == NodeType::MessagesMixer) {
+        updateMessagesMixers();
+    }
+}
+
+void MessagesMixer::nodeActivated(SharedNodePointer activatedNode) {
+    if (activatedNode->getType() == NodeType::MessagesMixer) {
+        updateMessagesMixers();
+    }
+}
+
+void MessagesMixer::updateMessagesMixers() {
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    _otherMessagesMixers.clear();
+    nodeList->eachMatchingNode([](const SharedNodePointer& node)->bool {
+        return node->getType() == NodeType::MessagesMixer && node->getActiveSocket();
+    }, [&](const SharedNodePointer& node) {
+        _otherMessagesMixers.push_back(node);
+    });
+
+    _messagesMixerIDs.clear();
+    _messagesMixerIDs.push_back(nodeList->getSessionUUID());
+    for (const auto& messagesMixer : _otherMessagesMixers) {
+        _messagesMixerIDs.push_back(messagesMixer->getUUID());
+    }
+
+    qCDebug(assignment_client) << "Messages mixer is sharing channels with" << _otherMessagesMixers.size()
+                               << "other messages mixers";
+
+    // the subscribers of channels that moved to another mixer subscribe there when they see the change too
+    int numMovedChannels = 0;
+    for (const auto& channel : _subscribers.getChannels()) {
+        if (otherOwnerOfChannel(channel)) {
+            _subscribers.removeChannel(channel);
+            ++numMovedChannels;
+        }
+    }
+
+    if (numMovedChannels > 0) {
+        qCDebug(assignment_client) << numMovedChannels << "channels moved to other messages mixers";
     }
 }
 
+SharedNodePointer MessagesMixer::otherOwnerOfChannel(const QString& channel) const {
+    if (_otherMessagesMixers.empty()) {
+        return SharedNodePointer();
+    }
+
+    auto owner = MessagesClient::channelOwner(channel, _messagesMixerIDs);
+    for (const auto& messagesMixer : _otherMessagesMixers) {
+        if (messagesMixer->getUUID() == owner) {
+            return messagesMixer;
+        }
+    }
+    return SharedNodePointer();
+}
+
 void MessagesMixer::handleMessages(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
     QString channel, message;
     QByteArray data;
@@ -43,29 +117,103 @@ void MessagesMixer::handleMessages(QSharedPointer<ReceivedMessage> receivedMessa
     bool isText;
     MessagesClient::decodeMessagesPacket(receivedMessage, channel, isText, message, data, senderID);
 
+    ++_numMessages;
+
+    // a sender that doesn't know all the messages mixers yet may send us messages for another's channel,
+    // hand those on to the owner, unless they come from another messages mixer, which thought we owned it
+    SharedNodePointer owner;
+    if (senderNode->getType() != NodeType::MessagesMixer) {
+        owner = otherOwnerOfChannel(channel);
+    }
+
+    const auto& subscribers = _subscribers.getSubscribers(channel);
+    if (!owner && subscribers.empty()) {
+        return;
+    }
+
+    // the packet lists differ for each subscriber, but what goes in them doesn't, encode that once
+    auto payload = MessagesClient::encodeMessagesPayload(channel, isText, isText ? message.toUtf8() : data, senderID);
+
     auto nodeList = DependencyManager::get<NodeList>();
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-        return node->getActiveSocket() && _channelSubscribers[channel].contains(node->getUUID());
-    },
-        [&](const SharedNodePointer& node) {
-        auto packetList = isText ? MessagesClient::encodeMessagesPacket(channel, message, senderID) :
-                                   MessagesClient::encodeMessagesDataPacket(channel, data, senderID);
-        nodeList->sendPacketList(std::move(packetList), *node);
-    });
+    if (owner) {
+        sendMessagesPayloads(*nodeList, *owner, payload);
+        ++_numForwardedMessages;
+        return;
+    }
+
+    bool isCoalescing = _coalesceTimer.isActive();
+
+    for (const auto& node : subscribers) {
+        if (!node->getActiveSocket()) {
+            continue;
+        }
+
+        ++_numDeliveries;
+        if (isCoalescing) {
+            auto& coalesced = _coalescedMessages[node->getUUID()];
+            coalesced.node = node;
+            coalesced.payloads.append(payload);
+        } else {
+            sendMessagesPayloads(*nodeList, *node, payload);
+        }
+    }
+
+    if (isCoalescing) {
+        _coalescedReceiveTimes.push_back(receivedMessage->getFirstPacketReceiveTime());
+    } else {
+        recordFanOut(receivedMessage->getFirstPacketReceiveTime());
+    }
+}
+
+void MessagesMixer::sendCoalescedMessages() {
+    if (_coalescedMessages.isEmpty()) {
+        return;
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    for (const auto& coalesced : _coalescedMessages) {
+        sendMessagesPayloads(*nodeList, *coalesced.node, coalesced.payloads);
+        ++_numCoalescedPacketLists;
+    }
+    _coalescedMessages.clear();
+
+    for (auto receiveTime : _coalescedReceiveTimes) {
+        recordFanOut(receiveTime);
+    }
+    _coalescedReceiveTimes.clear();
+}
+
+void MessagesMixer::recordFanOut(quint64 receiveTime) {
+    if (receiveTime == 0) {
+        return;
+    }
+
+    // the receive time is on the high resolution clock, in microseconds
+    quint64 now = std::chrono::duration_cast<std::chrono::microseconds>(
+        p_high_resolution_clock::now().time_since_epoch()).count();
+    quint64 fanOutUsecs = now > receiveTime ? now - receiveTime : 0;
+
+    ++_numFannedOutMessages;
+    _sumFanOutUsecs += fanOutUsecs;
+    _maxFanOutUsecs = std::max(_maxFanOutUsecs, fanOutUsecs);
 }
 
 void MessagesMixer::handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     QString channel = QString::fromUtf8(message->getMessage());
-    _channelSubscribers[channel] << senderNode->getUUID();
+
+    // a subscriber that doesn't know the owner of the channel yet subscribes there once it does,
+    // until then it would only hold on to a subscription nothing is ever delivered to
+    if (otherOwnerOfChannel(channel)) {
+        return;
+    }
+
+    _subscribers.subscribe(channel, senderNode);
 }
 
 void MessagesMixer::handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     QString channel = QString::fromUtf8(message->getMessage());
-    if (_channelSubscribers.contains(channel)) {
-        _channelSubscribers[channel].remove(senderNode->getUUID());
-    }
+    _subscribers.unsubscribe(channel, senderNode->getUUID());
 }
 
 void MessagesMixer::sendStatsPacket() {
@@ -81,11 +229,70 @@ void MessagesMixer::sendStatsPacket() {
     });
 
     statsObject["messages"] = messagesMixerObject;
+
+    auto now = usecTimestampNow();
+    float elapsedSeconds = _lastStatsTime > 0 ? (float)(now - _lastStatsTime) / USECS_PER_SECOND : 0.0f;
+    auto perSecond = [&](int count) {
+        return elapsedSeconds > 0.0f ? count / elapsedSeconds : 0.0f;
+    };
+
+    statsObject["channels"] = _subscribers.getNumChannels();
+    statsObject["subscriptions"] = _subscribers.getNumSubscriptions();
+    statsObject["messages_per_second"] = perSecond(_numMessages);
+    statsObject["deliveries_per_second"] = perSecond(_numDeliveries);
+    statsObject["forwarded_per_second"] = perSecond(_numForwardedMessages);
+    statsObject["other_messages_mixers"] = (int)_otherMessagesMixers.size();
+    statsObject["coalesced_packet_lists_per_second"] = perSecond(_numCoalescedPacketLists);
+    statsObject["avg_fanout_usecs"] = _numFannedOutMessages > 0 ? (double)_sumFanOutUsecs / _numFannedOutMessages : 0.0;
+    statsObject["max_fanout_usecs"] = (double)_maxFanOutUsecs;
+
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
+
+    _lastStatsTime = now;
+    _numMessages = 0;
+    _numDeliveries = 0;
+    _numForwardedMessages = 0;
+    _numCoalescedPacketLists = 0;
+    _numFannedOutMessages = 0;
+    _sumFanOutUsecs = 0;
+    _maxFanOutUsecs = 0;
+}
+
+void MessagesMixer::domainSettingsRequestComplete() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    parseDomainServerSettings(nodeList->getDomainHandler().getSettingsObject());
+}
+
+void MessagesMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
+    const QString MESSAGES_MIXER_SETTINGS_KEY = "messages_mixer";
+    QJsonObject messagesMixerGroupObject = domainSettings[MESSAGES_MIXER_SETTINGS_KEY].toObject();
+
+    const QString COALESCE_INTERVAL = "coalesce_interval";
+    bool ok;
+    int coalesceInterval = messagesMixerGroupObject[COALESCE_INTERVAL].toString().toInt(&ok);
+    if (!ok || coalesceInterval < 0) {
+        coalesceInterval = 0;
+    }
+
+    if (coalesceInterval > 0) {
+        qCDebug(assignment_client) << "Messages mixer will coalesce messages for each subscriber every"
+                                   << coalesceInterval << "ms";
+        _coalesceTimer.start(coalesceInterval);
+    } else {
+        qCDebug(assignment_client) << "Messages mixer will send messages as they arrive";
+        _coalesceTimer.stop();
+        sendCoalescedMessages();
+    }
 }
 
 void MessagesMixer::run() {
+    // the settings only tune how messages go out, don't wait for them to start handing them on
+    DomainHandler& domainHandler = DependencyManager::get<NodeList>()->getDomainHandler();
+    connect(&domainHandler, &DomainHandler::settingsReceived, this, &MessagesMixer::domainSettingsRequestComplete);
+
     ThreadedAssignment::commonInit(MESSAGES_MIXER_LOGGING_NAME, NodeType::MessagesMixer);
     auto nodeList = DependencyManager::get<NodeList>();
-    nodeList->addSetOfNodeTypesToNodeInterestSet({ NodeType::Agent, NodeType::EntityScriptServer });
+    nodeList->addSetOfNodeTypesToNodeInterestSet({
+        NodeType::Agent, NodeType::EntityScriptServer, NodeType::MessagesMixer
+    });
 }
@@ -15,6 +15,12 @@
 #ifndef hifi_MessagesMixer_h
 #define hifi_MessagesMixer_h
 
+#include <vector>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QTimer>
+
+#include <MessagesSubscribers.h>
 #include <ThreadedAssignment.h>
 
 /// Handles assignments of type MessagesMixer - distribution of avatar data to various clients
@@ -26,15 +32,47 @@ public:
 public slots:
     void run() override;
     void nodeKilled(SharedNodePointer killedNode);
+    void nodeActivated(SharedNodePointer activatedNode);
     void sendStatsPacket() override;
 
 private slots:
+    void domainSettingsRequestComplete();
+    void sendCoalescedMessages();
     void handleMessages(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
 private:
-    QHash<QString,QSet<QUuid>> _channelSubscribers;
+    struct CoalescedMessages {
+        SharedNodePointer node;
+        QByteArray payloads;
+    };
+
+    void parseDomainServerSettings(const QJsonObject& domainSettings);
+    void recordFanOut(quint64 receiveTime);
+    void updateMessagesMixers();
+    SharedNodePointer otherOwnerOfChannel(const QString& channel) const;
+
+    MessagesSubscribers _subscribers;
+
+    // the other messages mixers in the domain, that the channels are shared out between
+    std::vector<SharedNodePointer> _otherMessagesMixers;
+    std::vector<QUuid> _messagesMixerIDs;
+
+    // when coalescing, the messages for each subscriber wait here for the next tick
+    QTimer _coalesceTimer;
+    QHash<QUuid, CoalescedMessages> _coalescedMessages;
+    std::vector<quint64> _coalescedReceiveTimes;
+
+    // stats since the last stats packet
+    quint64 _lastStatsTime { 0 };
+    int _numMessages { 0 };
+    int _numDeliveries { 0 };
+    int _numForwardedMessages { 0 };
+    int _numCoalescedPacketLists { 0 };
+    int _numFannedOutMessages { 0 };
+    quint64 _sumFanOutUsecs { 0 };
+    quint64 _maxFanOutUsecs { 0 };
 };
 
 #endif // hifi_MessagesMixer_h
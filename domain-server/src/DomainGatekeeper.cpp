@@ -11,20 +11,21 @@
 
 #include "DomainGatekeeper.h"
 
-#include <openssl/err.h>
-#include <openssl/rsa.h>
-#include <openssl/x509.h>
 #include <random>
+#include <vector>
 
 #include <QDataStream>
 
 #include <AccountManager.h>
 #include <Assignment.h>
+#include <PortableHighResolutionClock.h>
 
 #include "DomainServer.h"
 #include "DomainServerNodeData.h"
+#include "UserSignatureVerifier.h"
 
 using SharedAssignmentPointer = QSharedPointer<Assignment>;
+using namespace std::chrono;
 
 DomainGatekeeper::DomainGatekeeper(DomainServer* server) :
     _server(server)
@@ -104,13 +105,22 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
             }
         }
 
-        node = processAgentConnectRequest(nodeConnection, username, usernameSignature);
+        node = processAgentConnectRequest(nodeConnection, username, usernameSignature, message->getFirstPacketReceiveTime());
     }
 
+    if (!node && _pendingUserSignatures.contains(username.toLower())) {
+        // this connect request picks back up in handleVerifiedUserSignature once the user's signature has been checked
+        return;
+    }
+
+    finishConnectRequest(node, nodeConnection, username, message->getFirstPacketReceiveTime());
+}
+
+void DomainGatekeeper::finishConnectRequest(const SharedNodePointer& node, const NodeConnectionData& nodeConnection,
+                                            const QString& username, quint64 requestReceiveTime) {
     if (node) {
         // set the sending sock addr and node interest set on this node
         DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
-        nodeData->setSendingSockAddr(message->getSenderSockAddr());
 
         // guard against patched agents asking to hear about other agents
         auto safeInterestSet = nodeConnection.interestList.toSet();
@@ -118,12 +128,17 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
             safeInterestSet.remove(NodeType::Agent);
         }
 
-        nodeData->setNodeInterestSet(safeInterestSet);
-        nodeData->setPlaceName(nodeConnection.placeName);
+        {
+            // the sending sock addr is checked against packets on the node list thread
+            QWriteLocker nodeStateLocker(&_server->_nodeStateLock);
+            nodeData->setSendingSockAddr(nodeConnection.senderSockAddr);
+            nodeData->setNodeInterestSet(safeInterestSet);
+            nodeData->setPlaceName(nodeConnection.placeName);
+        }
 
         QMetaEnum metaEnum = QMetaEnum::fromType<LimitedNodeList::ConnectReason>();
         qDebug() << "Allowed connection from node" << uuidStringWithoutCurlyBraces(node->getUUID()) 
-            << "on" << message->getSenderSockAddr() 
+            << "on" << nodeConnection.senderSockAddr 
             << "with MAC" << nodeConnection.hardwareAddress 
             << "and machine fingerprint" << nodeConnection.machineFingerprint 
             << "user" << username 
@@ -131,11 +146,18 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
             << "previous connection uptime" << nodeConnection.previousConnectionUpTime/USECS_PER_MSEC << "msec"
             << "sysinfo" << nodeConnection.SystemInfo;
 
+        auto now = duration_cast<microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
+        qint64 connectLatency = now - (qint64)requestReceiveTime;
+        _connectLatencyMedian.updatePercentile(connectLatency);
+        _connectLatencyP90.updatePercentile(connectLatency);
+        _connectLatencyP99.updatePercentile(connectLatency);
+        ++_numConnects;
+
         // signal that we just connected a node so the DomainServer can get it a list
         // and broadcast its presence right away
-        emit connectedNode(node, message->getFirstPacketReceiveTime());
+        emit connectedNode(node, requestReceiveTime);
     } else {
-        qDebug() << "Refusing connection from node at" << message->getSenderSockAddr()
+        qDebug() << "Refusing connection from node at" << nodeConnection.senderSockAddr
             << "with hardware address" << nodeConnection.hardwareAddress
             << "and machine fingerprint" << nodeConnection.machineFingerprint
             << "sysinfo" << nodeConnection.SystemInfo;
@@ -144,6 +166,35 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
 
 NodePermissions DomainGatekeeper::setPermissionsForUser(bool isLocalUser, QString verifiedUsername, const QHostAddress& senderAddress,
                                                         const QString& hardwareAddress, const QUuid& machineFingerprint) {
+    QString cacheKey = QString("%1|%2|%3|%4|%5").arg(isLocalUser).arg(verifiedUsername)
+        .arg(senderAddress.toString()).arg(hardwareAddress).arg(machineFingerprint.toString());
+
+    auto cachedPerms = _permissionsCache.constFind(cacheKey);
+    if (cachedPerms != _permissionsCache.constEnd()) {
+        ++_numPermissionsCacheHits;
+        return *cachedPerms;
+    }
+
+    ++_numPermissionsCacheMisses;
+    NodePermissions userPerms = computePermissionsForUser(isLocalUser, verifiedUsername, senderAddress,
+                                                          hardwareAddress, machineFingerprint);
+
+    // anonymous users are cached by address, don't let a domain that sees a lot of them grow this without bound
+    static const int MAX_PERMISSIONS_CACHE_SIZE = 10000;
+    if (_permissionsCache.size() >= MAX_PERMISSIONS_CACHE_SIZE) {
+        invalidatePermissionsCache();
+    }
+    _permissionsCache.insert(cacheKey, userPerms);
+    return userPerms;
+}
+
+void DomainGatekeeper::invalidatePermissionsCache() {
+    _permissionsCache.clear();
+}
+
+NodePermissions DomainGatekeeper::computePermissionsForUser(bool isLocalUser, QString verifiedUsername,
+                                                            const QHostAddress& senderAddress,
+                                                            const QString& hardwareAddress, const QUuid& machineFingerprint) {
     NodePermissions userPerms;
 
     userPerms.setAll(false);
@@ -267,11 +318,15 @@ void DomainGatekeeper::updateNodePermissions() {
     // we reprocess the permissions map and update the nodes here.  The node list is frequently sent out to all
     // the connected nodes, so these changes are propagated to other nodes.
 
+    // whatever changed may have changed the permissions we worked out before as well
+    invalidatePermissionsCache();
+
     QList<SharedNodePointer> nodesToKill;
+    std::vector<std::pair<SharedNodePointer, NodePermissions>> updatedPermissions;
 
     auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
     QWeakPointer<LimitedNodeList> limitedNodeListWeak = limitedNodeList;
-    limitedNodeList->eachNode([this, limitedNodeListWeak, &nodesToKill](const SharedNodePointer& node){
+    limitedNodeList->eachNode([this, limitedNodeListWeak, &updatedPermissions](const SharedNodePointer& node){
         // the id and the username in NodePermissions will often be the same, but id is set before
         // authentication and verifiedUsername is only set once they user's key has been confirmed.
         QString verifiedUsername = node->getPermissions().getVerifiedUserName();
@@ -312,14 +367,31 @@ void DomainGatekeeper::updateNodePermissions() {
             userPerms = setPermissionsForUser(isLocalUser, verifiedUsername, connectingAddr.getAddress(), hardwareAddress, machineFingerprint);
         }
 
-        node->setPermissions(userPerms);
+        updatedPermissions.emplace_back(node, userPerms);
+    });
+
+    {
+        // the permissions go out with the node in the domain lists the check-in workers build,
+        // and those take the node state lock before the node list's, so it can't be taken in eachNode
+        QWriteLocker nodeStateLocker(&_server->_nodeStateLock);
 
-        if (!userPerms.can(NodePermissions::Permission::canConnectToDomain)) {
-            qDebug() << "node" << node->getUUID() << "no longer has permission to connect.";
-            // hang up on this node
-            nodesToKill << node;
+        for (const auto& nodePermissions : updatedPermissions) {
+            const auto& node = nodePermissions.first;
+            const auto& userPerms = nodePermissions.second;
+
+            if (node->getPermissions().permissions != userPerms.permissions) {
+                // let nodes that have this one know about the change
+                _server->domainListEntryChanged(node);
+            }
+            node->setPermissions(userPerms);
+
+            if (!userPerms.can(NodePermissions::Permission::canConnectToDomain)) {
+                qDebug() << "node" << node->getUUID() << "no longer has permission to connect.";
+                // hang up on this node
+                nodesToKill << node;
+            }
         }
-    });
+    }
 
     foreach (auto node, nodesToKill) {
         emit killNode(node);
@@ -383,7 +455,11 @@ SharedNodePointer DomainGatekeeper::processAssignmentConnectRequest(const NodeCo
     userPerms.permissions |= NodePermissions::Permission::canWriteToAssetServer;
     userPerms.permissions |= NodePermissions::Permission::canReplaceDomainContent;
     userPerms.permissions |= NodePermissions::Permission::canGetAndSetPrivateUserData;
-    newNode->setPermissions(userPerms);
+    {
+        // the node is already in the node list, where a check-in worker can be putting it in a domain list
+        QWriteLocker nodeStateLocker(&_server->_nodeStateLock);
+        newNode->setPermissions(userPerms);
+    }
     return newNode;
 }
 
@@ -392,20 +468,8 @@ const QString MAXIMUM_USER_CAPACITY_REDIRECT_LOCATION = "security.maximum_user_c
 
 SharedNodePointer DomainGatekeeper::processAgentConnectRequest(const NodeConnectionData& nodeConnection,
                                                                const QString& username,
-                                                               const QByteArray& usernameSignature) {
-
-    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
-
-    // start with empty permissions
-    NodePermissions userPerms(NodePermissionsKey(username, 0));
-    userPerms.setAll(false);
-
-    // check if this user is on our local machine - if this is true set permissions to those for a "localhost" connection
-    QHostAddress senderHostAddress = nodeConnection.senderSockAddr.getAddress();
-    bool isLocalUser =
-        (senderHostAddress == limitedNodeList->getLocalSockAddr().getAddress() || senderHostAddress == QHostAddress::LocalHost);
-
-    QString verifiedUsername; // if this remains empty, consider this an anonymous connection attempt
+                                                               const QByteArray& usernameSignature,
+                                                               quint64 requestReceiveTime) {
     if (!username.isEmpty()) {
         const QUuid& connectionToken = _connectionTokenHash.value(username.toLower());
 
@@ -420,22 +484,30 @@ SharedNodePointer DomainGatekeeper::processAgentConnectRequest(const NodeConnect
             qDebug() << "stalling login because we have no username-signature:" << username;
 #endif
             return SharedNodePointer();
-        } else if (verifyUserSignature(username, usernameSignature, nodeConnection.senderSockAddr)) {
-            // they sent us a username and the signature verifies it
-            getGroupMemberships(username);
-            verifiedUsername = username.toLower();
         } else {
-            // they sent us a username, but it didn't check out
-            requestUserPublicKey(username);
-#ifdef WANT_DEBUG
-            qDebug() << "stalling login because signature verification failed:" << username;
-#endif
+            // they sent us a username and a signature, check it before we go any further
+            verifyUserSignature(nodeConnection, username, usernameSignature, requestReceiveTime);
             return SharedNodePointer();
         }
     }
 
-    userPerms = setPermissionsForUser(isLocalUser, verifiedUsername, nodeConnection.senderSockAddr.getAddress(),
-                                      nodeConnection.hardwareAddress, nodeConnection.machineFingerprint);
+    // no username, consider this an anonymous connection attempt
+    return processVerifiedAgentConnectRequest(nodeConnection, username, QString());
+}
+
+SharedNodePointer DomainGatekeeper::processVerifiedAgentConnectRequest(const NodeConnectionData& nodeConnection,
+                                                                       const QString& username,
+                                                                       const QString& verifiedUsername) {
+
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+
+    // check if this user is on our local machine - if this is true set permissions to those for a "localhost" connection
+    QHostAddress senderHostAddress = nodeConnection.senderSockAddr.getAddress();
+    bool isLocalUser =
+        (senderHostAddress == limitedNodeList->getLocalSockAddr().getAddress() || senderHostAddress == QHostAddress::LocalHost);
+
+    NodePermissions userPerms = setPermissionsForUser(isLocalUser, verifiedUsername, nodeConnection.senderSockAddr.getAddress(),
+                                                      nodeConnection.hardwareAddress, nodeConnection.machineFingerprint);
 
     if (!userPerms.can(NodePermissions::Permission::canConnectToDomain)) {
         sendConnectionDeniedPacket("You lack the required permissions to connect to this domain.",
@@ -492,7 +564,10 @@ SharedNodePointer DomainGatekeeper::processAgentConnectRequest(const NodeConnect
     SharedNodePointer newNode = addVerifiedNodeFromConnectRequest(nodeConnection);
 
     // set the edit rights for this user
-    newNode->setPermissions(userPerms);
+    {
+        QWriteLocker nodeStateLocker(&_server->_nodeStateLock);
+        newNode->setPermissions(userPerms);
+    }
 
     // grab the linked data for our new node so we can set the username
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(newNode->getLinkedData());
@@ -558,11 +633,16 @@ void DomainGatekeeper::cleanupICEPeerForNode(const QUuid& nodeID) {
     }
 }
 
-bool DomainGatekeeper::verifyUserSignature(const QString& username,
-                                           const QByteArray& usernameSignature,
-                                           const HifiSockAddr& senderSockAddr) {
+void DomainGatekeeper::verifyUserSignature(const NodeConnectionData& nodeConnection, const QString& username,
+                                           const QByteArray& usernameSignature, quint64 requestReceiveTime) {
     // it's possible this user can be allowed to connect, but we need to check their username signature
     auto lowerUsername = username.toLower();
+
+    if (_pendingUserSignatures.contains(lowerUsername)) {
+        // we're already checking a signature from this user, they'll re-send their connect request if that one fails
+        return;
+    }
+
     KeyFlagPair publicKeyPair = _userPublicKeys.value(lowerUsername);
 
     QByteArray publicKeyArray = publicKeyPair.first;
@@ -570,69 +650,76 @@ bool DomainGatekeeper::verifyUserSignature(const QString& username,
 
     const QUuid& connectionToken = _connectionTokenHash.value(lowerUsername);
 
-    if (!publicKeyArray.isEmpty() && !connectionToken.isNull()) {
-        // if we do have a public key for the user, check for a signature match
+    if (publicKeyArray.isEmpty() || connectionToken.isNull()) {
+        qDebug() << "Insufficient data to decrypt username signature - delaying connection.";
+        requestUserPublicKey(username); // no joy.  maybe next time?
+        return;
+    }
 
-        const unsigned char* publicKeyData = reinterpret_cast<const unsigned char*>(publicKeyArray.constData());
+    // hold on to the connect request while the RSA verification runs on the verification pool
+    _pendingUserSignatures.insert(lowerUsername,
+                                  { nodeConnection, username, connectionToken, isOptimisticKey, requestReceiveTime });
 
-        // first load up the public key into an RSA struct
-        RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, publicKeyArray.size());
+    auto verifier = new UserSignatureVerifier(lowerUsername, publicKeyArray, connectionToken, usernameSignature);
+    connect(verifier, &UserSignatureVerifier::verifiedUserSignature, this, &DomainGatekeeper::handleVerifiedUserSignature);
+    _signatureVerificationPool.start(verifier);
+}
 
-        QByteArray lowercaseUsernameUTF8 = lowerUsername.toUtf8();
-        QByteArray usernameWithToken = QCryptographicHash::hash(lowercaseUsernameUTF8.append(connectionToken.toRfc4122()),
-                                                                QCryptographicHash::Sha256);
+void DomainGatekeeper::handleVerifiedUserSignature(QString lowerUsername, bool isValidKey, bool isMatch) {
+    auto it = _pendingUserSignatures.find(lowerUsername);
+    if (it == _pendingUserSignatures.end()) {
+        return;
+    }
 
-        if (rsaPublicKey) {
-            int decryptResult = RSA_verify(NID_sha256,
-                                           reinterpret_cast<const unsigned char*>(usernameWithToken.constData()),
-                                           usernameWithToken.size(),
-                                           reinterpret_cast<const unsigned char*>(usernameSignature.constData()),
-                                           usernameSignature.size(),
-                                           rsaPublicKey);
+    PendingUserSignature pending = *it;
+    _pendingUserSignatures.erase(it);
 
-            if (decryptResult == 1) {
-                qDebug() << "Username signature matches for" << username;
+    const HifiSockAddr& senderSockAddr = pending.nodeConnection.senderSockAddr;
 
-                // free up the public key and remove connection token before we return
-                RSA_free(rsaPublicKey);
-                _connectionTokenHash.remove(username);
+    if (_connectionTokenHash.value(lowerUsername) != pending.connectionToken) {
+        // the token this signature was made over is gone, the user will have to sign the current one
+        return;
+    }
 
-                return true;
+    if (!isValidKey) {
+        // we can't let this user in since we couldn't convert their public key to an RSA key we could use
+        qDebug() << "Couldn't convert data to RSA key for" << pending.username << "- denying connection.";
+        sendConnectionDeniedPacket("Couldn't convert data to RSA key.", senderSockAddr,
+            DomainHandler::ConnectionRefusedReason::LoginError);
+        requestUserPublicKey(pending.username);
+        return;
+    }
 
-            } else {
-                // we only send back a LoginError if this wasn't an "optimistic" key
-                // (a key that we hoped would work but is probably stale)
+    if (!isMatch) {
+        // we only send back a LoginError if this wasn't an "optimistic" key
+        // (a key that we hoped would work but is probably stale)
+        if (!pending.isOptimisticKey) {
+            qDebug() << "Error decrypting username signature for" << pending.username << "- denying connection.";
+            sendConnectionDeniedPacket("Error decrypting username signature.", senderSockAddr,
+                DomainHandler::ConnectionRefusedReason::LoginError);
+        } else {
+            qDebug() << "Error decrypting username signature for" << pending.username << "with optimisitic key -"
+                << "re-requesting public key and delaying connection";
+        }
 
-                if (!senderSockAddr.isNull() && !isOptimisticKey) {
-                    qDebug() << "Error decrypting username signature for" << username << "- denying connection.";
-                    sendConnectionDeniedPacket("Error decrypting username signature.", senderSockAddr,
-                        DomainHandler::ConnectionRefusedReason::LoginError);
-                } else if (!senderSockAddr.isNull()) {
-                    qDebug() << "Error decrypting username signature for" << username << "with optimisitic key -"
-                        << "re-requesting public key and delaying connection";
-                }
+        // they sent us a username, but it didn't check out
+        requestUserPublicKey(pending.username);
+#ifdef WANT_DEBUG
+        qDebug() << "stalling login because signature verification failed:" << pending.username;
+#endif
+        return;
+    }
 
-                // free up the public key, we don't need it anymore
-                RSA_free(rsaPublicKey);
-            }
+    qDebug() << "Username signature matches for" << pending.username;
 
-        } else {
+    // the connection token has been used, remove it
+    _connectionTokenHash.remove(lowerUsername);
 
-            // we can't let this user in since we couldn't convert their public key to an RSA key we could use
-            if (!senderSockAddr.isNull()) {
-                qDebug() << "Couldn't convert data to RSA key for" << username << "- denying connection.";
-                sendConnectionDeniedPacket("Couldn't convert data to RSA key.", senderSockAddr,
-                    DomainHandler::ConnectionRefusedReason::LoginError);
-            }
-        }
-    } else {
-        if (!senderSockAddr.isNull()) {
-            qDebug() << "Insufficient data to decrypt username signature - delaying connection.";
-        }
-    }
+    // they sent us a username and the signature verifies it
+    getGroupMemberships(pending.username);
 
-    requestUserPublicKey(username); // no joy.  maybe next time?
-    return false;
+    SharedNodePointer node = processVerifiedAgentConnectRequest(pending.nodeConnection, pending.username, lowerUsername);
+    finishConnectRequest(node, pending.nodeConnection, pending.username, pending.requestReceiveTime);
 }
 
 bool DomainGatekeeper::isWithinMaxCapacity() {
@@ -950,6 +1037,7 @@ void DomainGatekeeper::getIsGroupMemberJSONCallback(QNetworkReply* requestReply)
             QUuid rankID = QUuid(rank["id"].toString());
             _server->_settingsManager.recordGroupMembership(username, groupID, rankID);
         }
+        invalidatePermissionsCache();
     } else {
         qDebug() << "getIsGroupMember api call returned:" << QJsonDocument(jsonObject).toJson(QJsonDocument::Compact);
     }
@@ -1001,6 +1089,7 @@ void DomainGatekeeper::getDomainOwnerFriendsListJSONCallback(QNetworkReply* requ
         for (int i = 0; i < friends.size(); i++) {
             _domainOwnerFriends += friends.at(i).toString().toLower();
         }
+        invalidatePermissionsCache();
     } else {
         qDebug() << "getDomainOwnerFriendsList api call returned:" << QJsonDocument(jsonObject).toJson(QJsonDocument::Compact);
     }
@@ -1034,6 +1123,19 @@ void DomainGatekeeper::refreshGroupsCache() {
 #endif
 }
 
+QJsonObject DomainGatekeeper::getStatsJSON() const {
+    QJsonObject statsJSON;
+    statsJSON["connects"] = _numConnects;
+    statsJSON["pending_signature_checks"] = _pendingUserSignatures.size();
+    statsJSON["connect_latency_p50_usecs"] = _connectLatencyMedian.getValueAtPercentile();
+    statsJSON["connect_latency_p90_usecs"] = _connectLatencyP90.getValueAtPercentile();
+    statsJSON["connect_latency_p99_usecs"] = _connectLatencyP99.getValueAtPercentile();
+    statsJSON["permissions_cache_size"] = _permissionsCache.size();
+    statsJSON["permissions_cache_hits"] = _numPermissionsCacheHits;
+    statsJSON["permissions_cache_misses"] = _numPermissionsCacheMisses;
+    return statsJSON;
+}
+
 void DomainGatekeeper::initLocalIDManagement() {
     std::uniform_int_distribution<quint16> sixteenBitRand;
     std::random_device randomDevice;
@@ -17,11 +17,14 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include <QtCore/QJsonObject>
 #include <QtCore/QObject>
+#include <QtCore/QThreadPool>
 #include <QtNetwork/QNetworkReply>
 
 #include <DomainHandler.h>
 
+#include <MovingPercentile.h>
 #include <NLPacket.h>
 #include <Node.h>
 #include <UUIDHasher.h>
@@ -40,10 +43,12 @@ public:
                                 const QUuid& walletUUID, const QString& nodeVersion);
     QUuid assignmentUUIDForPendingAssignment(const QUuid& tempUUID);
 
-    void cleanupICEPeerForNode(const QUuid& nodeID);
+    Q_INVOKABLE void cleanupICEPeerForNode(const QUuid& nodeID);
 
     Node::LocalID findOrCreateLocalID(const QUuid& uuid);
 
+    QJsonObject getStatsJSON() const;
+
     static void sendProtocolMismatchConnectionDenial(const HifiSockAddr& senderSockAddr);
 public slots:
     void processConnectRequestPacket(QSharedPointer<ReceivedMessage> message);
@@ -68,19 +73,29 @@ signals:
 
 public slots:
     void updateNodePermissions();
+    void invalidatePermissionsCache();
 
 private slots:
     void handlePeerPingTimeout();
+    void handleVerifiedUserSignature(QString lowerUsername, bool isValidKey, bool isMatch);
 private:
     SharedNodePointer processAssignmentConnectRequest(const NodeConnectionData& nodeConnection,
                                                       const PendingAssignedNodeData& pendingAssignment);
     SharedNodePointer processAgentConnectRequest(const NodeConnectionData& nodeConnection,
                                                  const QString& username,
-                                                 const QByteArray& usernameSignature);
+                                                 const QByteArray& usernameSignature,
+                                                 quint64 requestReceiveTime);
+    SharedNodePointer processVerifiedAgentConnectRequest(const NodeConnectionData& nodeConnection,
+                                                         const QString& username,
+                                                         const QString& verifiedUsername);
     SharedNodePointer addVerifiedNodeFromConnectRequest(const NodeConnectionData& nodeConnection);
+    void finishConnectRequest(const SharedNodePointer& node, const NodeConnectionData& nodeConnection,
+                              const QString& username, quint64 requestReceiveTime);
     
-    bool verifyUserSignature(const QString& username, const QByteArray& usernameSignature,
-                             const HifiSockAddr& senderSockAddr);
+    // starts a check of the user's signature on the verification pool, the connect request is picked back up
+    // in handleVerifiedUserSignature once that is done
+    void verifyUserSignature(const NodeConnectionData& nodeConnection, const QString& username,
+                             const QByteArray& usernameSignature, quint64 requestReceiveTime);
     bool isWithinMaxCapacity();
     
     bool shouldAllowConnectionFromNode(const QString& username, const QByteArray& usernameSignature,
@@ -122,6 +137,31 @@ private:
 
     NodePermissions setPermissionsForUser(bool isLocalUser, QString verifiedUsername, const QHostAddress& senderAddress, 
                                           const QString& hardwareAddress, const QUuid& machineFingerprint);
+    NodePermissions computePermissionsForUser(bool isLocalUser, QString verifiedUsername, const QHostAddress& senderAddress,
+                                              const QString& hardwareAddress, const QUuid& machineFingerprint);
+
+    // the permissions worked out for each combination of the inputs to setPermissionsForUser, so that connecting users
+    // don't each walk the permissions tables and their groups again - cleared whenever any of those inputs change
+    QHash<QString, NodePermissions> _permissionsCache;
+    int _numPermissionsCacheHits { 0 };
+    int _numPermissionsCacheMisses { 0 };
+
+    // agent connect requests waiting on a check of their user's signature, by lowercase username
+    struct PendingUserSignature {
+        NodeConnectionData nodeConnection;
+        QString username;
+        QUuid connectionToken;
+        bool isOptimisticKey;
+        quint64 requestReceiveTime;
+    };
+    QHash<QString, PendingUserSignature> _pendingUserSignatures;
+
+    // time from the connect request arriving to the node being added, including any wait for a signature check
+    static const int NUM_CONNECT_LATENCY_SAMPLES = 500;
+    MovingPercentile _connectLatencyMedian { NUM_CONNECT_LATENCY_SAMPLES, 0.5f };
+    MovingPercentile _connectLatencyP90 { NUM_CONNECT_LATENCY_SAMPLES, 0.9f };
+    MovingPercentile _connectLatencyP99 { NUM_CONNECT_LATENCY_SAMPLES, 0.99f };
+    int _numConnects { 0 }; // connects allowed since the domain-server started, not the nodes connected now
 
     void getGroupMemberships(const QString& username);
     // void getIsGroupMember(const QString& username, const QUuid groupID);
@@ -136,6 +176,9 @@ private:
 
     Node::LocalID _currentLocalID;
     Node::LocalID _idIncrement;
+
+    // last, so that any signature checks still running are waited on before the rest of the gatekeeper goes away
+    QThreadPool _signatureVerificationPool;
 };
 
 
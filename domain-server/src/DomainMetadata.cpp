@@ -166,6 +166,8 @@ void DomainMetadata::maybeUpdateUsers() {
     QVariantMap userHostnames;
 
     // figure out the breakdown of currently connected interface clients
+    // the place names are updated by check-ins
+    QReadLocker nodeStateLocker(&static_cast<DomainServer*>(parent())->_nodeStateLock);
     nodeList->eachNode([&numConnected, &numConnectedAnonymously, &userHostnames](const SharedNodePointer& node) {
         auto linkedData = node->getLinkedData();
         if (linkedData) {
@@ -27,6 +27,7 @@
 #include <QTimer>
 #include <QUrlQuery>
 #include <QCommandLineParser>
+#include <QRunnable>
 #include <QUuid>
 
 #include <AccountManager.h>
@@ -42,6 +43,7 @@
 #include <SettingHandle.h>
 #include <SharedUtil.h>
 #include <ShutdownEventListener.h>
+#include <ThreadHelpers.h>
 #include <UUID.h>
 #include <LogHandler.h>
 #include <PathUtils.h>
@@ -222,6 +224,8 @@ DomainServer::DomainServer(int argc, char* argv[]) :
     // if permissions are updated, relay the changes to the Node datastructures
     connect(&_settingsManager, &DomainServerSettingsManager::updateNodePermissions,
             &_gatekeeper, &DomainGatekeeper::updateNodePermissions);
+    connect(&_settingsManager, &DomainServerSettingsManager::permissionsChanged,
+            &_gatekeeper, &DomainGatekeeper::invalidatePermissionsCache);
     connect(&_settingsManager, &DomainServerSettingsManager::settingsUpdated,
             this, &DomainServer::updateReplicatedNodes);
     connect(&_settingsManager, &DomainServerSettingsManager::settingsUpdated,
@@ -425,6 +429,12 @@ DomainServer::~DomainServer() {
 
     DependencyManager::destroy<AccountManager>();
 
+    // stop taking check-ins and let the ones in progress finish before the LimitedNodeList goes
+    if (auto nodeList = DependencyManager::get<LimitedNodeList>()) {
+        nodeList->getPacketReceiver().unregisterListener(this);
+    }
+    _checkInPool.waitForDone();
+
     // cleanup the AssetClient thread
     DependencyManager::destroy<AssetClient>();
     _assetClientThread.quit();
@@ -655,11 +665,21 @@ bool DomainServer::isPacketVerified(const udt::Packet& packet) {
 
             DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(sourceNode->getLinkedData());
 
-            bool exactAddressMatch = nodeData->getSendingSockAddr() == packet.getSenderSockAddr();
-            bool bothPrivateAddresses = nodeData->getSendingSockAddr().hasPrivateAddress()
-                && packet.getSenderSockAddr().hasPrivateAddress();
+            bool exactAddressMatch = false;
+            bool bothPrivateAddresses = false;
+            if (nodeData) {
+                // we're on the node list thread, the gatekeeper sets the sending sock addr from the main thread
+                HifiSockAddr sendingSockAddr;
+                {
+                    QReadLocker nodeStateLocker(&_nodeStateLock);
+                    sendingSockAddr = nodeData->getSendingSockAddr();
+                }
+
+                exactAddressMatch = sendingSockAddr == packet.getSenderSockAddr();
+                bothPrivateAddresses = sendingSockAddr.hasPrivateAddress() && packet.getSenderSockAddr().hasPrivateAddress();
+            }
 
-            if (nodeData && (exactAddressMatch || bothPrivateAddresses)) {
+            if (exactAddressMatch || bothPrivateAddresses) {
                 // to the best of our ability we've verified that this packet comes from the right place
                 // let the NodeList do its checks now (but pass it the sourceNode so it doesn't need to look it up again)
                 return nodeList->isPacketVerifiedWithSource(packet, sourceNode.data());
@@ -683,6 +703,7 @@ bool DomainServer::isPacketVerified(const udt::Packet& packet) {
 void DomainServer::setupNodeListAndAssignments() {
     const QString CUSTOM_LOCAL_PORT_OPTION = "metaverse.local_port";
     static const QString ENABLE_PACKET_AUTHENTICATION = "metaverse.enable_packet_verification";
+    static const QString PACKET_VERIFICATION_METHOD = "metaverse.packet_verification_method";
 
     QVariant localPortValue = _settingsManager.valueOrDefaultValueForKeyPath(CUSTOM_LOCAL_PORT_OPTION);
     int domainServerPort = localPortValue.toInt();
@@ -752,6 +773,10 @@ void DomainServer::setupNodeListAndAssignments() {
     bool isAuthEnabled = _settingsManager.valueOrDefaultValueForKeyPath(ENABLE_PACKET_AUTHENTICATION).toBool();
     nodeList->setAuthenticatePackets(isAuthEnabled);
 
+    // the nodes are told which hash to use along with each connection secret
+    QString verificationMethod = _settingsManager.valueOrDefaultValueForKeyPath(PACKET_VERIFICATION_METHOD).toString();
+    _connectionSecretAuthMethod = verificationMethod == "md5" ? HMACAuth::MD5 : HMACAuth::SIPHASH;
+
     connect(nodeList.data(), &LimitedNodeList::nodeAdded, this, &DomainServer::nodeAdded);
     connect(nodeList.data(), &LimitedNodeList::nodeKilled, this, &DomainServer::nodeKilled);
     connect(nodeList.data(), &LimitedNodeList::localSockAddrChanged, this,
@@ -762,7 +787,8 @@ void DomainServer::setupNodeListAndAssignments() {
     // register as the packet receiver for the types we want
     PacketReceiver& packetReceiver = nodeList->getPacketReceiver();
     packetReceiver.registerListener(PacketType::RequestAssignment, this, "processRequestAssignmentPacket");
-    packetReceiver.registerListener(PacketType::DomainListRequest, this, "processListRequestPacket");
+    // check-ins are handed to the check-in pool straight from the NodeList thread, see processListRequestPacket
+    packetReceiver.registerDirectListener(PacketType::DomainListRequest, this, "processListRequestPacket");
     packetReceiver.registerListener(PacketType::DomainServerPathQuery, this, "processPathQueryPacket");
     packetReceiver.registerListener(PacketType::NodeJsonStats, this, "processNodeJSONStatsPacket");
     packetReceiver.registerListener(PacketType::DomainDisconnectRequest, this, "processNodeDisconnectRequestPacket");
@@ -789,12 +815,21 @@ void DomainServer::setupNodeListAndAssignments() {
     packetReceiver.registerListener(PacketType::DomainContentReplacementFromUrl, this, "handleDomainContentReplacementFromURLRequest");
 
     // set a custom packetVersionMatch as the verify packet operator for the udt::Socket
-    nodeList->setPacketFilterOperator(&DomainServer::isPacketVerified);
+    nodeList->setPacketFilterOperator([this](const udt::Packet& packet) { return isPacketVerified(packet); });
 
     _assetClientThread.setObjectName("AssetClient Thread");
     auto assetClient = DependencyManager::set<AssetClient>();
     assetClient->moveToThread(&_assetClientThread);
     _assetClientThread.start();
+
+    // a few check-ins can have their domain lists built at once, each under a read lock of the node state
+    static const int MAX_CHECK_IN_THREADS = 4;
+    _checkInPool.setMaxThreadCount(std::max(1, std::min(QThread::idealThreadCount() - 1, MAX_CHECK_IN_THREADS)));
+
+    // packets are received on a thread of their own, so that nodes are heard from and checked in
+    // while the main thread is busy with the web admin or saving settings
+    moveToNewNamedThread(nodeList.data(), "NodeList Thread", QThread::TimeCriticalPriority);
+
     // add whatever static assignments that have been parsed to the queue
     addStaticAssignmentsToQueue();
 }
@@ -874,7 +909,7 @@ void DomainServer::setupAutomaticNetworking() {
                             this, &DomainServer::performIPAddressUpdate);
 
                     // have the LNL enable public socket updating via STUN
-                    nodeList->startSTUNPublicSocketUpdate();
+                    QMetaObject::invokeMethod(nodeList.data(), "startSTUNPublicSocketUpdate");
                 }
             } else {
                 qCCritical(domain_server) << "PAGE: Cannot enable domain-server automatic networking without a domain ID."
@@ -912,7 +947,7 @@ void DomainServer::setupICEHeartbeatForFullNetworking() {
             this, &DomainServer::sendHeartbeatToIceServer);
 
     // we need this DS to know what our public IP is - start trying to figure that out now
-    limitedNodeList->startSTUNPublicSocketUpdate();
+    QMetaObject::invokeMethod(limitedNodeList.data(), "startSTUNPublicSocketUpdate");
 
     // to send ICE heartbeats we'd better have a private key locally with an uploaded public key
     // if we have an access token and we don't have a private key or the current domain ID has changed
@@ -1060,29 +1095,52 @@ void DomainServer::populateDefaultStaticAssignmentsExcludingTypes(const QSet<Ass
             }
 
             // type has not been set from a command line or config file config, use the default
-            // by clearing whatever exists and writing a single default assignment with no payload
-            Assignment* newAssignment = new Assignment(Assignment::CreateCommand, (Assignment::Type) defaultedType);
-            addStaticAssignmentToAssignmentHash(newAssignment);
+            // by clearing whatever exists and writing a single default assignment with no payload,
+            // except for the messages mixer, which can share the channels out between a few
+            int numInstances = defaultedType == Assignment::MessagesMixerType ? numMessagesMixers() : 1;
+            for (int i = 0; i < numInstances; ++i) {
+                Assignment* newAssignment = new Assignment(Assignment::CreateCommand, (Assignment::Type) defaultedType);
+                addStaticAssignmentToAssignmentHash(newAssignment);
+            }
         }
     }
 }
 
-void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
-    QDataStream packetStream(message->getMessage());
-    NodeConnectionData nodeRequestData = NodeConnectionData::fromDataStream(packetStream, message->getSenderSockAddr(), false);
+namespace {
+    // a check-in, run on the check-in pool
+    class CheckInRunnable : public QRunnable {
+    public:
+        CheckInRunnable(std::function<void()> checkIn) : _checkIn(std::move(checkIn)) {}
 
-    // update this node's sockets in case they have changed
-    sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
-    sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+        void run() override { _checkIn(); }
 
-    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
+    private:
+        std::function<void()> _checkIn;
+    };
+}
 
-    if (!nodeData->hasCheckedIn()) {
-        nodeData->setHasCheckedIn(true);
+static quint64 highResolutionUsecsNow() {
+    return duration_cast<microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
+}
 
-        // on first check in, make sure we've cleaned up any ICE peer for this node
-        _gatekeeper.cleanupICEPeerForNode(sendingNode->getUUID());
-    }
+void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    // this is called on the NodeList thread, which we don't want to hold up building domain lists
+    ++_numPendingCheckIns;
+    _checkInPool.start(new CheckInRunnable([this, message, sendingNode] {
+        processListRequest(message, sendingNode);
+    }));
+}
+
+void DomainServer::processListRequest(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    quint64 receiveTime = message->getFirstPacketReceiveTime();
+    quint64 startTime = highResolutionUsecsNow();
+
+    QDataStream packetStream(message->getMessage());
+    NodeConnectionData nodeRequestData = NodeConnectionData::fromDataStream(packetStream, message->getSenderSockAddr(), false);
+
+    // the latest domain list this node has all of
+    quint32 ackedDomainListVersion;
+    packetStream >> ackedDomainListVersion;
 
     // guard against patched agents asking to hear about other agents
     auto safeInterestSet = nodeRequestData.interestList.toSet();
@@ -1090,16 +1148,56 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
         safeInterestSet.remove(NodeType::Agent);
     }
 
-    // update the NodeInterestSet in case there have been any changes
-    nodeData->setNodeInterestSet(safeInterestSet);
+    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
+    bool isFirstCheckIn = false;
+
+    {
+        QWriteLocker nodeStateLocker(&_nodeStateLock);
 
-    // update the connecting hostname in case it has changed
-    nodeData->setPlaceName(nodeRequestData.placeName);
+        nodeData->setAckedDomainListVersion(ackedDomainListVersion);
 
-    // client-side send time of last connect/domain list request
-    nodeData->setLastDomainCheckinTimestamp(nodeRequestData.lastPingTimestamp);
+        // update this node's sockets in case they have changed
+        if (sendingNode->getPublicSocket() != nodeRequestData.publicSockAddr
+            || sendingNode->getLocalSocket() != nodeRequestData.localSockAddr) {
+            sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
+            sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+            domainListEntryChanged(sendingNode);
+        }
+
+        if (!nodeData->hasCheckedIn()) {
+            nodeData->setHasCheckedIn(true);
+            isFirstCheckIn = true;
+        }
+
+        if (safeInterestSet != nodeData->getNodeInterestSet()) {
+            // the lists this node has don't have the node types it is now interested in, its next one has to be in full
+            nodeData->setMinDomainListBaseVersion(++_domainListVersion);
+
+            // update the NodeInterestSet
+            nodeData->setNodeInterestSet(safeInterestSet);
+        }
+
+        // update the connecting hostname in case it has changed
+        if (nodeData->getPlaceName() != nodeRequestData.placeName) {
+            nodeData->setPlaceName(nodeRequestData.placeName);
+        }
 
-    sendDomainListToNode(sendingNode, message->getFirstPacketReceiveTime(), message->getSenderSockAddr(), false);
+        // client-side send time of last connect/domain list request
+        nodeData->setLastDomainCheckinTimestamp(nodeRequestData.lastPingTimestamp);
+    }
+
+    if (isFirstCheckIn) {
+        // on first check in, make sure we've cleaned up any ICE peer for this node - the gatekeeper is on the main thread
+        QMetaObject::invokeMethod(&_gatekeeper, "cleanupICEPeerForNode", Q_ARG(QUuid, sendingNode->getUUID()));
+    }
+
+    sendDomainListToNode(sendingNode, receiveTime, message->getSenderSockAddr(), false);
+
+    quint64 finishTime = highResolutionUsecsNow();
+    _checkInQueueLatency.addSample(startTime - receiveTime);
+    _checkInProcessingLatency.addSample(finishTime - startTime);
+    _checkInLatency.addSample(finishTime - receiveTime);
+    --_numPendingCheckIns;
 }
 
 bool DomainServer::isInInterestSet(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
@@ -1164,6 +1262,18 @@ QUrl DomainServer::oauthAuthorizationURL(const QUuid& stateUUID) {
 void DomainServer::handleConnectedNode(SharedNodePointer newNode, quint64 requestReceiveTime) {
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(newNode->getLinkedData());
 
+    {
+        QWriteLocker nodeStateLocker(&_nodeStateLock);
+
+        // this node goes in the next domain list delta of each of the nodes interested in it
+        domainListEntryChanged(newNode);
+
+        if (shouldReplicateNode(*newNode)) {
+            qDebug() << "Setting node to replicated: " << newNode->getUUID();
+            newNode->setIsReplicated(true);
+        }
+    }
+
     // reply back to the user with a PacketType::DomainList
     sendDomainListToNode(newNode, requestReceiveTime, nodeData->getSendingSockAddr(), true);
 
@@ -1172,25 +1282,82 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode, quint64 reques
         emit userConnected();
     }
 
-    if (shouldReplicateNode(*newNode)) {
-        qDebug() << "Setting node to replicated: " << newNode->getUUID();
-        newNode->setIsReplicated(true);
-    }
-
     // send out this node to our other connected nodes
     broadcastNewNode(newNode);
 }
 
+void DomainServer::domainListEntryChanged(const SharedNodePointer& node) {
+    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+    if (nodeData) {
+        nodeData->setDomainListEntryVersion(++_domainListVersion);
+    }
+}
+
+quint32 DomainServer::domainListBaseVersionForNode(const DomainServerNodeData& nodeData, bool newConnection) {
+    // send everything every so often anyways, so that a node can't drift from what we have for long
+    static const quint64 FULL_DOMAIN_LIST_INTERVAL_USECS = 30 * USECS_PER_SECOND;
+
+    quint32 ackedVersion = nodeData.getAckedDomainListVersion();
+
+    // the node has to have all of a list we sent it, new enough that we still know what changed since
+    if (newConnection || ackedVersion == 0 || ackedVersion > nodeData.getLastSentDomainListVersion()
+        || ackedVersion < nodeData.getMinDomainListBaseVersion() || ackedVersion < _minDomainListBaseVersion
+        || usecTimestampNow() - nodeData.getLastFullDomainListTime() > FULL_DOMAIN_LIST_INTERVAL_USECS) {
+        return 0;
+    }
+
+    return ackedVersion;
+}
+
 void DomainServer::sendDomainListToNode(const SharedNodePointer& node, quint64 requestPacketReceiveTime, const HifiSockAddr &senderSockAddr, bool newConnection) {
     const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID +
         NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID + 4;
 
+    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+
+    // other check-ins can build their lists alongside this one, but nothing can change what goes in them until it's built
+    QReadLocker nodeStateLocker(&_nodeStateLock);
+    quint32 domainListVersion = _domainListVersion;
+
+    // if the node has all of a recent list, only send it the nodes that have been added, changed or removed since
+    quint32 baseVersion = domainListBaseVersionForNode(*nodeData, newConnection);
+
+    // work out the entries before the header, which says how many there are
+    std::vector<SharedNodePointer> changedNodes;
+    std::vector<QUuid> removedNodeIDs;
+    int numBytesSaved = 0;
+
+    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
+    auto& nodeInterestSet = nodeData->getNodeInterestSet();
+
+    // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
+    if (nodeInterestSet.size() > 0 && nodeData->isAuthenticated()) {
+        // if this authenticated node has any interest types, send back those nodes as well
+        limitedNodeList->eachNode([&](const SharedNodePointer& otherNode) {
+            if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
+                auto otherNodeData = static_cast<DomainServerNodeData*>(otherNode->getLinkedData());
+
+                if (baseVersion == 0 || !otherNodeData || otherNodeData->getDomainListEntryVersion() > baseVersion) {
+                    changedNodes.push_back(otherNode);
+                } else {
+                    numBytesSaved += otherNodeData->getDomainListEntrySize();
+                }
+            }
+        });
+
+        if (baseVersion > 0) {
+            for (auto it = _removedDomainListNodes.rbegin();
+                 it != _removedDomainListNodes.rend() && it->version > baseVersion; ++it) {
+                removedNodeIDs.push_back(it->nodeID);
+            }
+        }
+    }
+
     // setup the extended header for the domain list packets
     // this data is at the beginning of each of the domain list packets
     QByteArray extendedHeader(NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES, 0);
     QDataStream extendedHeaderStream(&extendedHeader, QIODevice::WriteOnly);
-    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
-    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
 
     extendedHeaderStream << limitedNodeList->getSessionUUID();
     extendedHeaderStream << limitedNodeList->getSessionLocalID();
@@ -1202,40 +1369,65 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, quint64 r
     extendedHeaderStream << quint64(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count());
     extendedHeaderStream << quint64(duration_cast<microseconds>(p_high_resolution_clock::now().time_since_epoch()).count()) - requestPacketReceiveTime;
     extendedHeaderStream << newConnection;
+    extendedHeaderStream << domainListVersion;
+    extendedHeaderStream << baseVersion;
+    extendedHeaderStream << quint32(removedNodeIDs.size() + changedNodes.size());
     auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
 
     // always send the node their own UUID back
     QDataStream domainListStream(domainListPackets.get());
 
-    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
-    auto& nodeInterestSet = nodeData->getNodeInterestSet();
+    for (const auto& removedNodeID : removedNodeIDs) {
+        domainListPackets->startSegment();
+        domainListStream << (quint8)LimitedNodeList::DomainListRemovedNode << removedNodeID;
+        domainListPackets->endSegment();
 
-    if (nodeInterestSet.size() > 0) {
+        numBytesSaved -= (int)(sizeof(quint8) + NUM_BYTES_RFC4122_UUID);
+    }
 
-        // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
-        if (nodeData->isAuthenticated()) {
-            // if this authenticated node has any interest types, send back those nodes as well
-            limitedNodeList->eachNode([this, node, &domainListPackets, &domainListStream](const SharedNodePointer& otherNode) {
-                if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
+    for (const auto& otherNode : changedNodes) {
+        QByteArray entry;
+        QDataStream entryStream(&entry, QIODevice::WriteOnly);
 
-                    // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
+        // don't send avatar nodes to other avatars, that will come from avatar mixer
+        entryStream << (quint8)LimitedNodeList::DomainListNode << *otherNode.data();
 
-                    // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
+        // pack the secret that these two nodes will use to communicate with each other
+        entryStream << connectionSecretForNodes(node, otherNode);
+        entryStream << (quint8)_connectionSecretAuthMethod;
 
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
-                }
-            });
+        auto otherNodeData = static_cast<DomainServerNodeData*>(otherNode->getLinkedData());
+        if (otherNodeData) {
+            otherNodeData->setDomainListEntrySize(entry.size());
         }
+
+        // since we're about to add a node to the packet we start a segment
+        domainListPackets->startSegment();
+        domainListPackets->write(entry);
+
+        // we've added the node we wanted so end the segment now
+        domainListPackets->endSegment();
     }
 
     // send an empty list to the node, in case there were no other nodes
     domainListPackets->closeCurrentPacket(true);
 
+    nodeStateLocker.unlock();
+
+    {
+        QWriteLocker nodeStateWriteLocker(&_nodeStateLock);
+
+        nodeData->setLastSentDomainListVersion(domainListVersion);
+        if (baseVersion == 0) {
+            nodeData->setLastFullDomainListTime(usecTimestampNow());
+            ++_numFullDomainLists;
+        } else {
+            ++_numDeltaDomainLists;
+            _numDomainListBytesSaved += numBytesSaved;
+        }
+        _numDomainListBytesSent += domainListPackets->getDataSize();
+    }
+
     // write the PacketList to this node
     limitedNodeList->sendPacketList(std::move(domainListPackets), *node);
 }
@@ -1245,6 +1437,8 @@ QUuid DomainServer::connectionSecretForNodes(const SharedNodePointer& nodeA, con
     DomainServerNodeData* nodeBData = static_cast<DomainServerNodeData*>(nodeB->getLinkedData());
 
     if (nodeAData && nodeBData) {
+        QMutexLocker connectionSecretsLocker(&_connectionSecretsMutex);
+
         QUuid& secretUUID = nodeAData->getSessionSecretHash()[nodeB->getUUID()];
 
         if (secretUUID.isNull()) {
@@ -1268,6 +1462,8 @@ void DomainServer::broadcastNewNode(const SharedNodePointer& addedNode) {
 
     auto addNodePacket = NLPacket::create(PacketType::DomainServerAddedNode);
 
+    QReadLocker nodeStateLocker(&_nodeStateLock);
+
     // setup the add packet for this new node
     QDataStream addNodeStream(addNodePacket.get());
 
@@ -1293,6 +1489,7 @@ void DomainServer::broadcastNewNode(const SharedNodePointer& addedNode) {
 
                 // replace the bytes at the end of the packet for the connection secret between these nodes
                 addNodePacket->write(rfcConnectionSecret);
+                addNodePacket->writePrimitive((quint8)_connectionSecretAuthMethod);
 
                 limitedNodeList->sendUnreliablePacket(*addNodePacket, *node);
             }
@@ -2092,6 +2289,7 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             QJsonObject assignedNodesJSON;
 
             // enumerate the NodeList to find the assigned nodes
+            QReadLocker nodeStateLocker(&_nodeStateLock);
             nodeList->eachNode([this, &assignedNodesJSON](const SharedNodePointer& node){
                 DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
 
@@ -2147,6 +2345,35 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             QJsonDocument transactionsDocument(rootObject);
             connection->respond(HTTPConnection::StatusCode200, transactionsDocument.toJson(), qPrintable(JSON_MIME_TYPE));
 
+            return true;
+        } else if (url.path() == "/stats.json") {
+            // stats for the domain-server itself, those for the assignment-clients are at /nodes/<uuid>.json
+            QJsonObject statsJSON;
+            statsJSON["gatekeeper"] = _gatekeeper.getStatsJSON();
+
+            {
+                QReadLocker nodeStateLocker(&_nodeStateLock);
+
+                QJsonObject domainListJSON;
+                domainListJSON["version"] = (qint64)_domainListVersion;
+                domainListJSON["full_lists_sent"] = (qint64)_numFullDomainLists;
+                domainListJSON["delta_lists_sent"] = (qint64)_numDeltaDomainLists;
+                domainListJSON["bytes_sent"] = (qint64)_numDomainListBytesSent;
+                domainListJSON["bytes_saved"] = (qint64)_numDomainListBytesSaved;
+                statsJSON["domain_list"] = domainListJSON;
+            }
+
+            QJsonObject checkInJSON;
+            checkInJSON["workers"] = _checkInPool.maxThreadCount();
+            checkInJSON["pending"] = (int)_numPendingCheckIns;
+            checkInJSON["latency"] = _checkInLatency.getStatsJSON();
+            checkInJSON["queue_latency"] = _checkInQueueLatency.getStatsJSON();
+            checkInJSON["processing_latency"] = _checkInProcessingLatency.getStatsJSON();
+            statsJSON["check_in"] = checkInJSON;
+
+            QJsonDocument statsDocument(statsJSON);
+            connection->respond(HTTPConnection::StatusCode200, statsDocument.toJson(), qPrintable(JSON_MIME_TYPE));
+
             return true;
         } else if (url.path() == QString("%1.json").arg(URI_NODES)) {
             // setup the JSON
@@ -2154,10 +2381,13 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             QJsonArray nodesJSONArray;
 
             // enumerate the NodeList to find the assigned nodes
-            nodeList->eachNode([this, &nodesJSONArray](const SharedNodePointer& node){
-                // add the node using the UUID as the key
-                nodesJSONArray.append(jsonObjectForNode(node));
-            });
+            {
+                QReadLocker nodeStateLocker(&_nodeStateLock);
+                nodeList->eachNode([this, &nodesJSONArray](const SharedNodePointer& node){
+                    // add the node using the UUID as the key
+                    nodesJSONArray.append(jsonObjectForNode(node));
+                });
+            }
 
             rootJSON["nodes"] = nodesJSONArray;
 
@@ -2519,7 +2749,7 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             return true;
         } else if (allNodesDeleteRegex.indexIn(url.path()) != -1) {
             qDebug() << "Received request to kill all nodes.";
-            nodeList->eraseAllNodes(url.path());
+            QMetaObject::invokeMethod(nodeList.data(), "eraseAllNodes", Q_ARG(QString, url.path()));
 
             return true;
         }
@@ -3052,10 +3282,12 @@ void DomainServer::updateReplicatedNodes() {
         }
     }
 
+    std::vector<SharedNodePointer> changedNodes;
+
     auto nodeList = DependencyManager::get<LimitedNodeList>();
     nodeList->eachMatchingNode([](const SharedNodePointer& otherNode) -> bool {
             return otherNode->getType() == NodeType::Agent;
-        }, [this](const SharedNodePointer& otherNode) {
+        }, [this, &changedNodes](const SharedNodePointer& otherNode) {
             auto shouldReplicate = shouldReplicateNode(*otherNode);
             auto isReplicated = otherNode->isReplicated();
             if (isReplicated && !shouldReplicate) {
@@ -3065,9 +3297,18 @@ void DomainServer::updateReplicatedNodes() {
                 qDebug() << "Setting node to replicated:"
                     << otherNode->getPermissions().getVerifiedUserName() << otherNode->getUUID();
             }
-            otherNode->setIsReplicated(shouldReplicate);
+            if (isReplicated != shouldReplicate) {
+                changedNodes.push_back(otherNode);
+            }
         }
     );
+
+    // the node state lock can't be taken inside eachMatchingNode, check-ins take it first
+    QWriteLocker nodeStateLocker(&_nodeStateLock);
+    for (const auto& changedNode : changedNodes) {
+        changedNode->setIsReplicated(!changedNode->isReplicated());
+        domainListEntryChanged(changedNode);
+    }
 }
 
 bool DomainServer::shouldReplicateNode(const Node& node) {
@@ -3089,6 +3330,15 @@ bool DomainServer::isAssetServerEnabled() {
     return _settingsManager.valueOrDefaultValueForKeyPath(ASSET_SERVER_ENABLED_KEYPATH).toBool();
 }
 
+int DomainServer::numMessagesMixers() {
+    static const QString NUM_MESSAGES_MIXERS_KEYPATH = "messages_mixer.num_mixers";
+    static const int MAX_MESSAGES_MIXERS = 16;
+
+    bool ok;
+    int numMixers = _settingsManager.valueOrDefaultValueForKeyPath(NUM_MESSAGES_MIXERS_KEYPATH).toString().toInt(&ok);
+    return ok ? qBound(1, numMixers, MAX_MESSAGES_MIXERS) : 1;
+}
+
 void DomainServer::nodeAdded(SharedNodePointer node) {
     // we don't use updateNodeWithData, so add the DomainServerNodeData to the node here
     node->setLinkedData(std::unique_ptr<DomainServerNodeData> { new DomainServerNodeData() });
@@ -3110,11 +3360,23 @@ void DomainServer::nodeKilled(SharedNodePointer node) {
             }
         }
 
-        // cleanup the connection secrets that we set up for this node (on the other nodes)
-        foreach (const QUuid& otherNodeSessionUUID, nodeData->getSessionSecretHash().keys()) {
-            SharedNodePointer otherNode = DependencyManager::get<LimitedNodeList>()->nodeWithUUID(otherNodeSessionUUID);
-            if (otherNode) {
-                static_cast<DomainServerNodeData*>(otherNode->getLinkedData())->getSessionSecretHash().remove(node->getUUID());
+        {
+            QWriteLocker nodeStateLocker(&_nodeStateLock);
+
+            // cleanup the connection secrets that we set up for this node (on the other nodes)
+            foreach (const QUuid& otherNodeSessionUUID, nodeData->getSessionSecretHash().keys()) {
+                SharedNodePointer otherNode = DependencyManager::get<LimitedNodeList>()->nodeWithUUID(otherNodeSessionUUID);
+                if (otherNode) {
+                    static_cast<DomainServerNodeData*>(otherNode->getLinkedData())->getSessionSecretHash().remove(node->getUUID());
+                }
+            }
+
+            // nodes that have this one get told it's gone with their next domain list delta
+            _removedDomainListNodes.push_back({ ++_domainListVersion, node->getUUID() });
+            if (_removedDomainListNodes.size() > MAX_REMOVED_DOMAIN_LIST_NODES) {
+                // any node whose list is older than the removal we forget about needs a full list again
+                _minDomainListBaseVersion = _removedDomainListNodes.front().version;
+                _removedDomainListNodes.pop_front();
             }
         }
 
@@ -3336,6 +3598,9 @@ void DomainServer::broadcastNodeDisconnect(const SharedNodePointer& disconnected
     removedNodePacket->reset();
     removedNodePacket->write(disconnectedNode->getUUID().toRfc4122());
 
+    // the interest sets are changed by check-ins
+    QReadLocker nodeStateLocker(&_nodeStateLock);
+
     // broadcast out the DomainServerRemovedNode message
     limitedNodeList->eachMatchingNode([this, &disconnectedNode](const SharedNodePointer& otherNode) -> bool {
         // only send the removed node packet to nodes that care about the type of node this was
@@ -12,13 +12,19 @@
 #ifndef hifi_DomainServer_h
 #define hifi_DomainServer_h
 
+#include <atomic>
+#include <deque>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QHash>
 #include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
 #include <QtCore/QQueue>
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QStringList>
 #include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <QtCore/QUrl>
 #include <QHostAddress>
 #include <QAbstractNativeEventFilter>
@@ -32,6 +38,7 @@
 #include "DomainMetadata.h"
 #include "DomainServerSettingsManager.h"
 #include "DomainServerWebSessionData.h"
+#include "LatencyHistogram.h"
 #include "WalletTransaction.h"
 #include "DomainContentBackupManager.h"
 
@@ -48,6 +55,8 @@ typedef QMultiHash<QUuid, WalletTransaction*> TransactionHash;
 using Subnet = QPair<QHostAddress, int>;
 using SubnetList = std::vector<Subnet>;
 
+class DomainServerNodeData;
+
 const int INVALID_ICE_LOOKUP_ID = -1;
 
 enum ReplicationServerDirection {
@@ -77,6 +86,7 @@ public:
     static const QString REPLACEMENT_FILE_EXTENSION;
 
     bool isAssetServerEnabled();
+    int numMessagesMixers();
 
     void screensharePresence(QString roomname, QString username, int expiration_seconds = 0);
 
@@ -165,7 +175,7 @@ private:
 
     void getTemporaryName(bool force = false);
 
-    static bool isPacketVerified(const udt::Packet& packet);
+    bool isPacketVerified(const udt::Packet& packet);
 
     bool resetAccountManagerAccessToken();
 
@@ -181,7 +191,13 @@ private:
     void handleKillNode(SharedNodePointer nodeToKill);
     void broadcastNodeDisconnect(const SharedNodePointer& disconnnectedNode);
 
+    // runs on the check-in pool
+    void processListRequest(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
+
     void sendDomainListToNode(const SharedNodePointer& node, quint64 requestPacketReceiveTime, const HifiSockAddr& senderSockAddr, bool newConnection);
+    quint32 domainListBaseVersionForNode(const DomainServerNodeData& nodeData, bool newConnection);
+    // the caller must hold _nodeStateLock for writing
+    void domainListEntryChanged(const SharedNodePointer& node);
 
     bool isInInterestSet(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
 
@@ -278,6 +294,37 @@ private:
 
     DomainType _type { DomainType::NonMetaverse };
 
+    HMACAuth::AuthMethod _connectionSecretAuthMethod { HMACAuth::SIPHASH };
+
+    // bumped whenever a node is added, changed or removed, so each node can be sent only what changed
+    // since the last domain list it has all of
+    quint32 _domainListVersion { 0 };
+    struct RemovedDomainListNode {
+        quint32 version;
+        QUuid nodeID;
+    };
+    static const size_t MAX_REMOVED_DOMAIN_LIST_NODES = 1000;
+    std::deque<RemovedDomainListNode> _removedDomainListNodes;
+    quint32 _minDomainListBaseVersion { 0 };
+
+    quint64 _numFullDomainLists { 0 };
+    quint64 _numDeltaDomainLists { 0 };
+    quint64 _numDomainListBytesSent { 0 };
+    qint64 _numDomainListBytesSaved { 0 };
+
+    // check-ins are handled on the check-in pool, away from the web admin and settings work on the main thread,
+    // _nodeStateLock guards the domain list state above along with the node sockets, permissions and
+    // DomainServerNodeData that check-ins read and write - take it before any node list eachNode, never inside one
+    QReadWriteLock _nodeStateLock;
+    // the connection secret hashes, which domain lists built side by side under a read lock can each add to
+    QMutex _connectionSecretsMutex;
+
+    // from a check-in being received to its domain list going out, split into the wait for a worker and the work
+    LatencyHistogram _checkInLatency;
+    LatencyHistogram _checkInQueueLatency;
+    LatencyHistogram _checkInProcessingLatency;
+    std::atomic<int> _numPendingCheckIns { 0 };
+
     friend class DomainGatekeeper;
     friend class DomainMetadata;
 
@@ -300,6 +347,8 @@ private:
     std::unordered_map<int, std::unique_ptr<QTemporaryFile>> _pendingContentFiles;
 
     QThread _assetClientThread;
+
+    QThreadPool _checkInPool;
 };
 
 
@@ -12,6 +12,8 @@
 #ifndef hifi_DomainServerNodeData_h
 #define hifi_DomainServerNodeData_h
 
+#include <atomic>
+
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QHash>
 #include <QtCore/QUuid>
@@ -75,6 +77,29 @@ public:
 
     bool hasCheckedIn() const { return _hasCheckedIn; }
     void setHasCheckedIn(bool hasCheckedIn) { _hasCheckedIn = hasCheckedIn; }
+
+    // the domain list version at which this node's entry in other nodes' domain lists last changed
+    quint32 getDomainListEntryVersion() const { return _domainListEntryVersion; }
+    void setDomainListEntryVersion(quint32 version) { _domainListEntryVersion = version; }
+
+    // the size of this node's entry the last time it went out, to count what leaving it out of a delta saved
+    //   this is set by check-in workers building domain lists side by side, so it is atomic
+    int getDomainListEntrySize() const { return _domainListEntrySize; }
+    void setDomainListEntrySize(int size) { _domainListEntrySize = size; }
+
+    // the latest domain list this node has told us it received all of
+    quint32 getAckedDomainListVersion() const { return _ackedDomainListVersion; }
+    void setAckedDomainListVersion(quint32 version) { _ackedDomainListVersion = version; }
+
+    quint32 getLastSentDomainListVersion() const { return _lastSentDomainListVersion; }
+    void setLastSentDomainListVersion(quint32 version) { _lastSentDomainListVersion = version; }
+
+    // a delta can only be sent on top of a list at least this new, older ones were missing what this node now needs
+    quint32 getMinDomainListBaseVersion() const { return _minDomainListBaseVersion; }
+    void setMinDomainListBaseVersion(quint32 version) { _minDomainListBaseVersion = version; }
+
+    quint64 getLastFullDomainListTime() const { return _lastFullDomainListTime; }
+    void setLastFullDomainListTime(quint64 time) { _lastFullDomainListTime = time; }
     
 private:
     QJsonObject overrideValuesIfNeeded(const QJsonObject& newStats);
@@ -102,6 +127,13 @@ private:
     bool _wasAssigned { false };
 
     bool _hasCheckedIn { false };
+
+    quint32 _domainListEntryVersion { 0 };
+    std::atomic<int> _domainListEntrySize { 0 };
+    quint32 _ackedDomainListVersion { 0 };
+    quint32 _lastSentDomainListVersion { 0 };
+    quint32 _minDomainListBaseVersion { 0 };
+    quint64 _lastFullDomainListTime { 0 };
 };
 
 #endif // hifi_DomainServerNodeData_h
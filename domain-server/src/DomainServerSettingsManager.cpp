@@ -649,6 +649,8 @@ void DomainServerSettingsManager::packPermissions() {
     packPermissionsForMap("permissions", _groupForbiddens, GROUP_FORBIDDENS_KEYPATH);
 
     persistToFile();
+
+    emit permissionsChanged();
 }
 
 bool DomainServerSettingsManager::unpackPermissionsForKeypath(const QString& keyPath,
@@ -765,6 +767,8 @@ void DomainServerSettingsManager::unpackPermissions() {
 
     if (needPack) {
         packPermissions();
+    } else {
+        emit permissionsChanged();
     }
 
 #ifdef WANT_DEBUG
@@ -136,6 +136,7 @@ public:
 signals:
     void updateNodePermissions();
     void settingsUpdated();
+    void permissionsChanged();
 
 public slots:
     void apiGetGroupIDJSONCallback(QNetworkReply* requestReply);
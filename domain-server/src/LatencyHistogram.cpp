@@ -0,0 +1,84 @@
+//
+//  LatencyHistogram.cpp
+//  domain-server/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore/QJsonArray>
+
+// the upper bound of each bucket but the last, which has everything larger
+static const std::array<quint64, LatencyHistogram::NUM_BUCKETS - 1> BUCKET_BOUNDS_USECS {{
+    100, 200, 500,
+    1000, 2000, 5000,
+    10000, 20000, 50000,
+    100000, 200000, 500000,
+    1000000, 2000000
+}};
+
+int LatencyHistogram::bucketForSample(quint64 usecs) {
+    return (int)(std::lower_bound(BUCKET_BOUNDS_USECS.begin(), BUCKET_BOUNDS_USECS.end(), usecs) - BUCKET_BOUNDS_USECS.begin());
+}
+
+void LatencyHistogram::addSample(quint64 usecs) {
+    ++_buckets[bucketForSample(usecs)];
+    ++_numSamples;
+    _totalUsecs += usecs;
+
+    quint64 maxUsecs = _maxUsecs;
+    while (usecs > maxUsecs && !_maxUsecs.compare_exchange_weak(maxUsecs, usecs)) {}
+}
+
+quint64 LatencyHistogram::getValueAtPercentile(float percentile) const {
+    quint64 numSamples = _numSamples;
+    if (numSamples == 0) {
+        return 0;
+    }
+
+    // the number of samples at or under the value we're after
+    quint64 rank = std::max((quint64)1, (quint64)std::ceil(percentile * numSamples));
+
+    quint64 numCounted = 0;
+    for (int i = 0; i < NUM_BUCKETS - 1; ++i) {
+        numCounted += _buckets[i];
+        if (numCounted >= rank) {
+            return std::min(BUCKET_BOUNDS_USECS[i], (quint64)_maxUsecs);
+        }
+    }
+
+    return _maxUsecs;
+}
+
+QJsonObject LatencyHistogram::getStatsJSON() const {
+    quint64 numSamples = _numSamples;
+
+    QJsonObject statsJSON;
+    statsJSON["count"] = (qint64)numSamples;
+    statsJSON["mean_usecs"] = numSamples > 0 ? (qint64)(_totalUsecs / numSamples) : 0;
+    statsJSON["max_usecs"] = (qint64)_maxUsecs;
+    statsJSON["p50_usecs"] = (qint64)getValueAtPercentile(0.5f);
+    statsJSON["p90_usecs"] = (qint64)getValueAtPercentile(0.9f);
+    statsJSON["p99_usecs"] = (qint64)getValueAtPercentile(0.99f);
+
+    // in order, each with the largest latency it counts - the last one has no limit
+    QJsonArray bucketsJSON;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        QJsonObject bucketJSON;
+        if (i < NUM_BUCKETS - 1) {
+            bucketJSON["max_usecs"] = (qint64)BUCKET_BOUNDS_USECS[i];
+        }
+        bucketJSON["count"] = (qint64)_buckets[i];
+        bucketsJSON.append(bucketJSON);
+    }
+    statsJSON["buckets"] = bucketsJSON;
+
+    return statsJSON;
+}
@@ -0,0 +1,45 @@
+//
+//  LatencyHistogram.h
+//  domain-server/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_LatencyHistogram_h
+#define hifi_LatencyHistogram_h
+
+#include <array>
+#include <atomic>
+
+#include <QtCore/QJsonObject>
+
+/// Counts latencies into fixed, roughly logarithmic buckets, so that percentiles can be read off without keeping samples
+///   LatencyHistogram is thread-safe, samples can be added from any thread
+class LatencyHistogram {
+public:
+    static const int NUM_BUCKETS = 15;
+
+    void addSample(quint64 usecs);
+
+    quint64 getNumSamples() const { return _numSamples; }
+
+    // the upper bound of the bucket the percentile falls in, or the largest sample if that is in the last bucket
+    quint64 getValueAtPercentile(float percentile) const;
+
+    QJsonObject getStatsJSON() const;
+
+private:
+    static int bucketForSample(quint64 usecs);
+
+    std::array<std::atomic<quint64>, NUM_BUCKETS> _buckets {};
+    std::atomic<quint64> _numSamples { 0 };
+    std::atomic<quint64> _totalUsecs { 0 };
+    std::atomic<quint64> _maxUsecs { 0 };
+};
+
+#endif // hifi_LatencyHistogram_h
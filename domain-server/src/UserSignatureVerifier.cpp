@@ -0,0 +1,54 @@
+//
+//  UserSignatureVerifier.cpp
+//  domain-server/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "UserSignatureVerifier.h"
+
+#include <openssl/err.h>
+#include <openssl/rsa.h>
+#include <openssl/x509.h>
+
+#include <QtCore/QCryptographicHash>
+
+UserSignatureVerifier::UserSignatureVerifier(const QString& lowerUsername, const QByteArray& publicKey,
+                                             const QUuid& connectionToken, const QByteArray& usernameSignature) :
+    _lowerUsername(lowerUsername),
+    _publicKey(publicKey),
+    _connectionToken(connectionToken),
+    _usernameSignature(usernameSignature)
+{
+}
+
+void UserSignatureVerifier::run() {
+    const unsigned char* publicKeyData = reinterpret_cast<const unsigned char*>(_publicKey.constData());
+
+    // first load up the public key into an RSA struct
+    RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, _publicKey.size());
+
+    if (!rsaPublicKey) {
+        emit verifiedUserSignature(_lowerUsername, false, false);
+        return;
+    }
+
+    QByteArray lowercaseUsernameUTF8 = _lowerUsername.toUtf8();
+    QByteArray usernameWithToken = QCryptographicHash::hash(lowercaseUsernameUTF8.append(_connectionToken.toRfc4122()),
+                                                            QCryptographicHash::Sha256);
+
+    int decryptResult = RSA_verify(NID_sha256,
+                                   reinterpret_cast<const unsigned char*>(usernameWithToken.constData()),
+                                   usernameWithToken.size(),
+                                   reinterpret_cast<const unsigned char*>(_usernameSignature.constData()),
+                                   _usernameSignature.size(),
+                                   rsaPublicKey);
+
+    // free up the public key, we don't need it anymore
+    RSA_free(rsaPublicKey);
+
+    emit verifiedUserSignature(_lowerUsername, true, decryptResult == 1);
+}
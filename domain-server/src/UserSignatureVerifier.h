@@ -0,0 +1,41 @@
+//
+//  UserSignatureVerifier.h
+//  domain-server/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_UserSignatureVerifier_h
+#define hifi_UserSignatureVerifier_h
+
+#include <QtCore/QObject>
+#include <QtCore/QRunnable>
+#include <QtCore/QUuid>
+
+/// Checks the signature a connecting user made over their connection token against their public key,
+///   off of the main thread so that a crowd of connecting users doesn't hold up the domain-server's event loop
+class UserSignatureVerifier : public QObject, public QRunnable {
+    Q_OBJECT
+public:
+    UserSignatureVerifier(const QString& lowerUsername, const QByteArray& publicKey,
+                          const QUuid& connectionToken, const QByteArray& usernameSignature);
+
+    virtual void run() override;
+
+signals:
+    // isValidKey is false if the public key couldn't be loaded, in which case isMatch is always false
+    void verifiedUserSignature(QString lowerUsername, bool isValidKey, bool isMatch);
+
+private:
+    QString _lowerUsername;
+    QByteArray _publicKey;
+    QUuid _connectionToken;
+    QByteArray _usernameSignature;
+};
+
+#endif // hifi_UserSignatureVerifier_h
@@ -131,6 +131,10 @@ Item {
                         visible: root.expanded
                         text: "Avatars NOT Updated: " + root.notUpdatedAvatarCount
                     }
+                    StatText {
+                        visible: root.expanded
+                        text: "Anim LOD Reduced/Minimal: " + root.reducedAnimLODAvatarCount + "/" + root.minimalAnimLODAvatarCount
+                    }
                     StatText {
                         visible: root.expanded
                         text: "Total picks:\n    " +
@@ -423,6 +427,12 @@ Item {
                         text: " out of view: " + root.itemOutOfView +
                             " too small: " + root.itemTooSmall;
                     }
+                    StatText {
+                        visible: root.expanded;
+                        text: "Scene transactions: " + root.sceneTransactions +
+                            " pending resets: " + root.scenePendingResets +
+                            " time: " + root.sceneTransactionTime.toFixed(2) + " ms";
+                    }
                     StatText {
                         visible: root.expanded;
                         text: "Shadows rendered / considered: " +
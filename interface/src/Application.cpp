@@ -2201,12 +2201,21 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
         SharedNodePointer audioMixerNode = nodeList->soloNodeOfType(NodeType::AudioMixer);
         SharedNodePointer avatarMixerNode = nodeList->soloNodeOfType(NodeType::AvatarMixer);
         SharedNodePointer assetServerNode = nodeList->soloNodeOfType(NodeType::AssetServer);
-        SharedNodePointer messagesMixerNode = nodeList->soloNodeOfType(NodeType::MessagesMixer);
         properties["entity_ping"] = entityServerNode ? entityServerNode->getPingMs() : -1;
         properties["audio_ping"] = audioMixerNode ? audioMixerNode->getPingMs() : -1;
         properties["avatar_ping"] = avatarMixerNode ? avatarMixerNode->getPingMs() : -1;
         properties["asset_ping"] = assetServerNode ? assetServerNode->getPingMs() : -1;
-        properties["messages_ping"] = messagesMixerNode ? messagesMixerNode->getPingMs() : -1;
+
+        // a domain can have several messages mixers, each with its share of the channels
+        int totalMessagesPing = 0;
+        int numMessagesMixers = 0;
+        nodeList->eachMatchingNode([](const SharedNodePointer& node)->bool {
+            return node->getType() == NodeType::MessagesMixer;
+        }, [&](const SharedNodePointer& node) {
+            totalMessagesPing += node->getPingMs();
+            ++numMessagesMixers;
+        });
+        properties["messages_ping"] = numMessagesMixers ? totalMessagesPing / numMessagesMixers : -1;
         properties["atp_in_kbps"] = assetServerNode ? assetServerNode->getInboundKbps() : 0.0f;
 
         auto loadingRequests = ResourceCache::getLoadingRequests();
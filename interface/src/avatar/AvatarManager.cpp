@@ -340,6 +340,14 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
                     avatar->_transit.reset();
                     avatar->setIsNewAvatar(false);
                 }
+                if (inView) {
+                    float screenSize = 0.0f;
+                    for (const auto& view : views) {
+                        float distance = glm::distance(view.getPosition(), avatar->getWorldPosition());
+                        screenSize = std::max(screenSize, avatar->getBoundingRadius() / std::max(distance, EPSILON));
+                    }
+                    avatar->getSkeletonModel()->getRig().setAnimLODScreenSize(screenSize);
+                }
                 avatar->simulate(deltaTime, inView);
                 if (avatar->getSkeletonModel()->isLoaded() && avatar->getWorkloadRegion() == workload::Region::R1) {
                     _myAvatar->addAvatarHandsToFlow(avatar);
@@ -976,6 +984,34 @@ float AvatarManager::getAvatarSortCoefficient(const QString& name) {
     return 0.0f;
 }
 
+QVariantMap AvatarManager::getAnimationLODBands() const {
+    Rig::AnimLODConfig config = Rig::getAnimLODConfig();
+    QVariantMap bands;
+    bands["reducedScreenSize"] = config.reducedScreenSize;
+    bands["minimalScreenSize"] = config.minimalScreenSize;
+    bands["reducedUpdateRate"] = config.reducedUpdateRate;
+    bands["minimalUpdateRate"] = config.minimalUpdateRate;
+    return bands;
+}
+
+void AvatarManager::setAnimationLODBands(const QVariantMap& bands) {
+    Rig::AnimLODConfig config = Rig::getAnimLODConfig();
+    if (bands.contains("reducedScreenSize")) {
+        config.reducedScreenSize = bands["reducedScreenSize"].toFloat();
+    }
+    if (bands.contains("minimalScreenSize")) {
+        config.minimalScreenSize = bands["minimalScreenSize"].toFloat();
+    }
+    if (bands.contains("reducedUpdateRate")) {
+        config.reducedUpdateRate = bands["reducedUpdateRate"].toFloat();
+    }
+    if (bands.contains("minimalUpdateRate")) {
+        config.minimalUpdateRate = bands["minimalUpdateRate"].toFloat();
+    }
+    config.minimalScreenSize = std::min(config.minimalScreenSize, config.reducedScreenSize);
+    Rig::setAnimLODConfig(config);
+}
+
 // HACK
 void AvatarManager::setAvatarSortCoefficient(const QString& name, const QScriptValue& value) {
     bool somethingChanged = false;
@@ -232,6 +232,23 @@ public:
      */
     Q_INVOKABLE void setAvatarSortCoefficient(const QString& name, const QScriptValue& value);
 
+    /**jsdoc
+     * Gets the bands used to pick the animation level of detail of other avatars.
+     * @function AvatarManager.getAnimationLODBands
+     * @returns {object} The bands: <code>reducedScreenSize</code> and <code>minimalScreenSize</code> are the ratios of an
+     *     avatar's bounding radius to its distance from the camera below which the avatar is animated at a reduced or
+     *     minimal level of detail; <code>reducedUpdateRate</code> and <code>minimalUpdateRate</code> are the rates, in Hz,
+     *     at which those avatars are updated.
+     */
+    Q_INVOKABLE QVariantMap getAnimationLODBands() const;
+
+    /**jsdoc
+     * Sets the bands used to pick the animation level of detail of other avatars.
+     * @function AvatarManager.setAnimationLODBands
+     * @param {object} bands - The bands to change. See {@link AvatarManager.getAnimationLODBands|getAnimationLODBands}.
+     */
+    Q_INVOKABLE void setAnimationLODBands(const QVariantMap& bands);
+
     /**jsdoc
      * Gets PAL (People Access List) data for one or more avatars. Using this method is faster than iterating over each avatar 
      * and obtaining data about each individually.
@@ -261,17 +261,26 @@ void OtherAvatar::simulate(float deltaTime, bool inView) {
         PROFILE_RANGE(simulation, "updateJoints");
         if (inView) {
             Head* head = getHead();
-            if (_hasNewJointData || _transit.isActive()) {
-                _skeletonModel->getRig().copyJointsFromJointData(_jointData);
-                glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
-                _skeletonModel->getRig().computeExternalPoses(rootTransform);
+            // distant avatars pick up new joint data at the rate of their animation LOD, and are interpolated in between
+            Rig& rig = _skeletonModel->getRig();
+            bool jointsChanged = false;
+            if (rig.tickAnimLOD(deltaTime, _hasNewJointData) || _transit.isActive()) {
+                rig.copyJointsFromJointData(_jointData);
+                _hasNewJointData = false;
                 _jointDataSimulationRate.increment();
+                jointsChanged = true;
+            }
+            if (rig.interpolateAnimLOD()) {
+                jointsChanged = true;
+            }
+            if (jointsChanged) {
+                glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
+                rig.computeExternalPoses(rootTransform);
 
                 head->simulate(deltaTime);
                 _skeletonModel->simulate(deltaTime, true);
 
                 locationChanged(); // joints changed, so if there are any children, update them.
-                _hasNewJointData = false;
 
                 glm::vec3 headPosition = getWorldPosition();
                 if (!_skeletonModel->getHeadPosition(headPosition)) {
@@ -77,6 +77,10 @@ void GraphicsEngine::initializeRender() {
     _renderEngine->load();
     _renderEngine->registerScene(_renderScene);
 
+    // Spread the item resets of large content loads over several frames instead of stalling one
+    const uint64_t SCENE_TRANSACTION_TIME_BUDGET = 4 * USECS_PER_MSEC;
+    _renderScene->setTransactionTimeBudget(SCENE_TRANSACTION_TIME_BUDGET);
+
     // Now that OpenGL is initialized, we are sure we have a valid context and can create the various pipeline shaders with success.
     DependencyManager::get<GeometryCache>()->initializeShapePipelines();
 }
@@ -89,6 +93,7 @@ void GraphicsEngine::shutdown() {
     // The cleanup process enqueues the transactions but does not process them.  Calling this here will force the actual
     // removal of the items.
     // See https://highfidelity.fogbugz.com/f/cases/5328
+    _renderScene->setTransactionTimeBudget(0); // no resets left pending
     _renderScene->enqueueFrame(); // flush all the transactions
     _renderScene->processTransactionQueue(); // process and apply deletions
 
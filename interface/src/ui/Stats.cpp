@@ -27,6 +27,7 @@
 #include <PerfStat.h>
 #include <plugins/DisplayPlugin.h>
 #include <PickManager.h>
+#include <Rig.h>
 
 #include <gl/Context.h>
 
@@ -130,6 +131,8 @@ void Stats::updateStats(bool force) {
     STAT_UPDATE(updatedAvatarCount, avatarManager->getNumAvatarsUpdated());
     STAT_UPDATE(updatedHeroAvatarCount, avatarManager->getNumHeroAvatarsUpdated());
     STAT_UPDATE(notUpdatedAvatarCount, avatarManager->getNumAvatarsNotUpdated());
+    STAT_UPDATE(reducedAnimLODAvatarCount, Rig::getNumRigsInAnimLOD(Rig::AnimLOD::Reduced));
+    STAT_UPDATE(minimalAnimLODAvatarCount, Rig::getNumRigsInAnimLOD(Rig::AnimLOD::Minimal));
     STAT_UPDATE(serverCount, (int)nodeList->size());
     STAT_UPDATE_FLOAT(renderrate, qApp->getRenderLoopRate(), 0.1f);
     RefreshRateManager& refreshRateManager = qApp->getRefreshRateManager();
@@ -188,7 +191,6 @@ void Stats::updateStats(bool force) {
     SharedNodePointer audioMixerNode = nodeList->soloNodeOfType(NodeType::AudioMixer);
     SharedNodePointer avatarMixerNode = nodeList->soloNodeOfType(NodeType::AvatarMixer);
     SharedNodePointer assetServerNode = nodeList->soloNodeOfType(NodeType::AssetServer);
-    SharedNodePointer messageMixerNode = nodeList->soloNodeOfType(NodeType::MessagesMixer);
 
     if (assetServerNode) {
         STAT_UPDATE_FLOAT(assetMbpsIn, assetServerNode->getInboundKbps() / 1000.0f, 0.01f);
@@ -206,14 +208,15 @@ void Stats::updateStats(bool force) {
     STAT_UPDATE(audioPacketLoss, audioMixerNode ? largestLossRate : -1);
     STAT_UPDATE(avatarPing, avatarMixerNode ? avatarMixerNode->getPingMs() : -1);
     STAT_UPDATE(assetPing, assetServerNode ? assetServerNode->getPingMs() : -1);
-    STAT_UPDATE(messagePing, messageMixerNode ? messageMixerNode->getPingMs() : -1);
 
-    //// Now handle entity servers, since there could be more than one, we average their ping times
+    //// Now handle entity servers and messages mixers, since there could be more than one, we average their ping times
     int totalPingOctree = 0;
     int octreeServerCount = 0;
     int pingOctreeMax = 0;
     int totalEntityKbps = 0;
-    nodeList->eachNode([&totalPingOctree, &totalEntityKbps, &octreeServerCount, &pingOctreeMax](const SharedNodePointer& node) {
+    int totalPingMessages = 0;
+    int messagesMixerCount = 0;
+    nodeList->eachNode([&](const SharedNodePointer& node) {
         // TODO: this should also support entities
         if (node->getType() == NodeType::EntityServer) {
             totalPingOctree += node->getPingMs();
@@ -222,10 +225,14 @@ void Stats::updateStats(bool force) {
             if (pingOctreeMax < node->getPingMs()) {
                 pingOctreeMax = node->getPingMs();
             }
+        } else if (node->getType() == NodeType::MessagesMixer) {
+            totalPingMessages += node->getPingMs();
+            messagesMixerCount++;
         }
     });
 
-    // update the entities ping with the average for all connected entity servers
+    // update the messages and entities pings with the averages for all connected messages mixers and entity servers
+    STAT_UPDATE(messagePing, messagesMixerCount ? totalPingMessages / messagesMixerCount : -1);
     STAT_UPDATE(entitiesPing, octreeServerCount ? totalPingOctree / octreeServerCount : -1);
 
     // Third column, avatar stats
@@ -410,6 +417,11 @@ void Stats::updateStats(bool force) {
         STAT_UPDATE(gpuFreeMemory, (int)BYTES_TO_MB(gpu::Context::getFreeGPUMemSize()));
         STAT_UPDATE(rectifiedTextureCount, (int)RECTIFIED_TEXTURE_COUNT.load());
         STAT_UPDATE(decimatedTextureCount, (int)DECIMATED_TEXTURE_COUNT.load());
+
+        auto transactionStats = qApp->getMain3DScene()->getTransactionStats();
+        STAT_UPDATE(sceneTransactions, (int)transactionStats.numQueuedTransactions);
+        STAT_UPDATE(scenePendingResets, (int)transactionStats.numPendingResets);
+        STAT_UPDATE_FLOAT(sceneTransactionTime, (float)transactionStats.processingTime / (float)USECS_PER_MSEC, 0.01f);
     }
 
     gpu::ContextStats gpuFrameStats;
@@ -55,6 +55,8 @@ private: \
  * @property {number} updatedAvatarCount - <em>Read-only.</em>
  * @property {number} updatedHeroAvatarCount - <em>Read-only.</em>
  * @property {number} notUpdatedAvatarCount - <em>Read-only.</em>
+ * @property {number} reducedAnimLODAvatarCount - <em>Read-only.</em>
+ * @property {number} minimalAnimLODAvatarCount - <em>Read-only.</em>
  * @property {number} packetInCount - <em>Read-only.</em>
  * @property {number} packetOutCount - <em>Read-only.</em>
  * @property {number} mbpsIn - <em>Read-only.</em>
@@ -103,6 +105,9 @@ private: \
  * @property {number} itemOutOfView - <em>Read-only.</em>
  * @property {number} itemTooSmall - <em>Read-only.</em>
  * @property {number} itemRendered - <em>Read-only.</em>
+ * @property {number} sceneTransactions - <em>Read-only.</em>
+ * @property {number} scenePendingResets - <em>Read-only.</em>
+ * @property {number} sceneTransactionTime - <em>Read-only.</em>
  * @property {number} shadowConsidered - <em>Read-only.</em>
  * @property {number} shadowOutOfView - <em>Read-only.</em>
  * @property {number} shadowTooSmall - <em>Read-only.</em>
@@ -219,6 +224,8 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(int, updatedAvatarCount, 0)
     STATS_PROPERTY(int, updatedHeroAvatarCount, 0)
     STATS_PROPERTY(int, notUpdatedAvatarCount, 0)
+    STATS_PROPERTY(int, reducedAnimLODAvatarCount, 0)
+    STATS_PROPERTY(int, minimalAnimLODAvatarCount, 0)
     STATS_PROPERTY(int, packetInCount, 0)
     STATS_PROPERTY(int, packetOutCount, 0)
     STATS_PROPERTY(float, mbpsIn, 0)
@@ -268,6 +275,9 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(int, itemOutOfView, 0)
     STATS_PROPERTY(int, itemTooSmall, 0)
     STATS_PROPERTY(int, itemRendered, 0)
+    STATS_PROPERTY(int, sceneTransactions, 0)
+    STATS_PROPERTY(int, scenePendingResets, 0)
+    STATS_PROPERTY(float, sceneTransactionTime, 0)
     STATS_PROPERTY(int, shadowConsidered, 0)
     STATS_PROPERTY(int, shadowOutOfView, 0)
     STATS_PROPERTY(int, shadowTooSmall, 0)
@@ -489,6 +499,20 @@ signals:
      */
     void notUpdatedAvatarCountChanged();
 
+    /**jsdoc
+     * Triggered when the value of the <code>reducedAnimLODAvatarCount</code> property changes.
+     * @function Stats.reducedAnimLODAvatarCountChanged
+     * @returns {Signal}
+     */
+    void reducedAnimLODAvatarCountChanged();
+
+    /**jsdoc
+     * Triggered when the value of the <code>minimalAnimLODAvatarCount</code> property changes.
+     * @function Stats.minimalAnimLODAvatarCountChanged
+     * @returns {Signal}
+     */
+    void minimalAnimLODAvatarCountChanged();
+
     /**jsdoc
      * Triggered when the value of the <code>packetInCount</code> property changes.
      * @function Stats.packetInCountChanged
@@ -820,6 +844,27 @@ signals:
      */
     void itemRenderedChanged();
 
+    /**jsdoc
+     * Triggered when the value of the <code>sceneTransactions</code> property changes.
+     * @function Stats.sceneTransactionsChanged
+     * @returns {Signal}
+     */
+    void sceneTransactionsChanged();
+
+    /**jsdoc
+     * Triggered when the value of the <code>scenePendingResets</code> property changes.
+     * @function Stats.scenePendingResetsChanged
+     * @returns {Signal}
+     */
+    void scenePendingResetsChanged();
+
+    /**jsdoc
+     * Triggered when the value of the <code>sceneTransactionTime</code> property changes.
+     * @function Stats.sceneTransactionTimeChanged
+     * @returns {Signal}
+     */
+    void sceneTransactionTimeChanged();
+
     /**jsdoc
      * Triggered when the value of the <code>shadowConsidered</code> property changes.
      * @function Stats.shadowConsideredChanged
@@ -12,6 +12,7 @@
 #include "Rig.h"
 
 #include <glm/gtx/vector_angle.hpp>
+#include <atomic>
 #include <queue>
 #include <QScriptValueIterator>
 #include <QWriteLocker>
@@ -39,6 +40,10 @@ static int nextRigId = 1;
 static std::map<int, Rig*> rigRegistry;
 static std::mutex rigRegistryMutex;
 
+static Rig::AnimLODConfig animLODConfig;
+static std::mutex animLODConfigMutex;
+static std::atomic<int> numRigsPerAnimLOD[(int)Rig::AnimLOD::NumLODs];
+
 static bool isEqual(const float p, float q) {
     const float EPSILON = 0.00001f;
     return fabsf(p - q) <= EPSILON;
@@ -309,6 +314,8 @@ Rig::Rig() {
     _rigId = nextRigId;
     rigRegistry[_rigId] = this;
     nextRigId++;
+
+    numRigsPerAnimLOD[(int)_animLOD]++;
 }
 
 Rig::~Rig() {
@@ -319,6 +326,101 @@ Rig::~Rig() {
     if (iter != rigRegistry.end()) {
         rigRegistry.erase(iter);
     }
+
+    numRigsPerAnimLOD[(int)_animLOD]--;
+}
+
+void Rig::setAnimLODConfig(const AnimLODConfig& config) {
+    std::lock_guard<std::mutex> guard(animLODConfigMutex);
+    animLODConfig = config;
+}
+
+Rig::AnimLODConfig Rig::getAnimLODConfig() {
+    std::lock_guard<std::mutex> guard(animLODConfigMutex);
+    return animLODConfig;
+}
+
+int Rig::getNumRigsInAnimLOD(AnimLOD lod) {
+    if (lod >= AnimLOD::NumLODs) {
+        return 0;
+    }
+    return numRigsPerAnimLOD[(int)lod];
+}
+
+void Rig::setAnimLODScreenSize(float screenSize) {
+    AnimLODConfig config = getAnimLODConfig();
+
+    // a rig must grow past its current band by this factor before it moves to a finer LOD,
+    // which keeps avatars standing near a threshold from flipping back and forth every frame.
+    const float ANIM_LOD_HYSTERESIS = 1.1f;
+    float minimalThreshold = config.minimalScreenSize * (_animLOD == AnimLOD::Minimal ? ANIM_LOD_HYSTERESIS : 1.0f);
+    float reducedThreshold = config.reducedScreenSize * (_animLOD != AnimLOD::Full ? ANIM_LOD_HYSTERESIS : 1.0f);
+
+    AnimLOD lod = AnimLOD::Full;
+    if (screenSize < minimalThreshold) {
+        lod = AnimLOD::Minimal;
+    } else if (screenSize < reducedThreshold) {
+        lod = AnimLOD::Reduced;
+    }
+    setAnimLOD(lod, config);
+}
+
+void Rig::setAnimLOD(AnimLOD lod, const AnimLODConfig& config) {
+    const float MIN_ANIM_LOD_UPDATE_RATE = 1.0f; // hz
+    switch (lod) {
+        case AnimLOD::Reduced:
+            _animLODPeriod = 1.0f / std::max(config.reducedUpdateRate, MIN_ANIM_LOD_UPDATE_RATE);
+            break;
+        case AnimLOD::Minimal:
+            _animLODPeriod = 1.0f / std::max(config.minimalUpdateRate, MIN_ANIM_LOD_UPDATE_RATE);
+            break;
+        default:
+            _animLODPeriod = 0.0f;
+            break;
+    }
+
+    if (lod != _animLOD) {
+        numRigsPerAnimLOD[(int)_animLOD]--;
+        numRigsPerAnimLOD[(int)lod]++;
+        _animLOD = lod;
+
+        // restart interpolation from whatever is on screen now
+        _animLODPrevPoses.clear();
+        _animLODTargetPoses.clear();
+    }
+}
+
+bool Rig::tickAnimLOD(float deltaTime, bool hasNewJointData) {
+    // the timer stops at a full period, so that joint data arriving after a quiet spell is taken on right away.
+    _animLODTimer = std::min(_animLODTimer + deltaTime, _animLODPeriod);
+    if (hasNewJointData && _animLODTimer >= _animLODPeriod) {
+        _animLODTimer = 0.0f;
+        return true;
+    }
+    return false;
+}
+
+bool Rig::interpolateAnimLOD() {
+    size_t numJoints = _animLODTargetPoses.size();
+    if (numJoints == 0) {
+        return false;
+    }
+
+    bool posesChanged = false;
+    float alpha = _animLODPeriod > 0.0f ? glm::clamp(_animLODTimer / _animLODPeriod, 0.0f, 1.0f) : 1.0f;
+    if (_animLODPrevPoses.size() == numJoints && _internalPoseSet._relativePoses.size() == numJoints) {
+        ::blend(numJoints, _animLODPrevPoses.data(), _animLODTargetPoses.data(), alpha, _internalPoseSet._relativePoses.data());
+        posesChanged = true;
+    } else {
+        // nothing to interpolate from, copyJointsFromJointData() has already put the target poses in place.
+        alpha = 1.0f;
+    }
+
+    if (alpha >= 1.0f) {
+        _animLODPrevPoses.clear();
+        _animLODTargetPoses.clear();
+    }
+    return posesChanged;
 }
 
 void Rig::overrideAnimation(const QString& url, float fps, bool loop, float firstFrame, float lastFrame) {
@@ -2651,6 +2753,12 @@ void Rig::copyJointsFromJointData(const QVector<JointData>& jointDataVec) {
     // convert rotations from absolute to parent relative.
     _animSkeleton->convertAbsoluteRotationsToRelative(rotations);
 
+    // below full animation LOD, interpolateAnimLOD() moves from the poses on screen now to the new ones.
+    bool useAnimLOD = _animLOD != AnimLOD::Full;
+    if (useAnimLOD) {
+        _animLODPrevPoses = _internalPoseSet._relativePoses;
+    }
+
     // store new relative poses
     if (numJoints != (int)_internalPoseSet._relativePoses.size()) {
         _internalPoseSet._relativePoses = _animSkeleton->getRelativeDefaultPoses();
@@ -2666,6 +2774,10 @@ void Rig::copyJointsFromJointData(const QVector<JointData>& jointDataVec) {
             _internalPoseSet._relativePoses[i].trans() = data.translation;
         }
     }
+
+    if (useAnimLOD) {
+        _animLODTargetPoses = _internalPoseSet._relativePoses;
+    }
 }
 
 void Rig::computeExternalPoses(const glm::mat4& modelOffsetMat) {
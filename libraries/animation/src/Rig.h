@@ -258,6 +258,38 @@ public:
     bool getNetworkGraphActive() const;
     void setDirectionalBlending(const QString& targetName, const glm::vec3& blendingTarget, const QString& alphaName, float alpha);
 
+    // Animation level of detail, chosen from the apparent size of the rig on screen.
+    enum class AnimLOD : uint8_t {
+        Full = 0,  // takes on new joint data every frame
+        Reduced,   // takes on new joint data at reducedUpdateRate, interpolated in between
+        Minimal,   // takes on new joint data at minimalUpdateRate, interpolated in between
+        NumLODs
+    };
+
+    struct AnimLODConfig {
+        float reducedScreenSize { 0.04f };  // bounding radius / view distance below which a rig is Reduced
+        float minimalScreenSize { 0.01f };  // bounding radius / view distance below which a rig is Minimal
+        float reducedUpdateRate { 15.0f };  // hz
+        float minimalUpdateRate { 5.0f };   // hz
+    };
+
+    // thread-safe
+    static void setAnimLODConfig(const AnimLODConfig& config);
+    static AnimLODConfig getAnimLODConfig();
+    static int getNumRigsInAnimLOD(AnimLOD lod);
+
+    // screenSize is the ratio of the rig's bounding radius to its distance from the closest view.
+    void setAnimLODScreenSize(float screenSize);
+    AnimLOD getAnimLOD() const { return _animLOD; }
+
+    // Advances the LOD clock by deltaTime and returns true when the rig is due to take on new joint data.
+    // A tick is only used up when hasNewJointData is true.
+    bool tickAnimLOD(float deltaTime, bool hasNewJointData);
+
+    // Moves the relative poses towards those last given to copyJointsFromJointData(), trailing them by one LOD period.
+    // Returns true if the poses changed, in which case computeExternalPoses() should follow.
+    bool interpolateAnimLOD();
+
 signals:
     void onLoadComplete();
     void onLoadFailed();
@@ -278,6 +310,7 @@ protected:
                     const AnimPose& leftFootPose, const AnimPose& rightFootPose,
                     const glm::mat4& rigToSensorMatrix, const glm::mat4& sensorToRigMatrix);
     void updateReactions(const ControllerParameters& params);
+    void setAnimLOD(AnimLOD lod, const AnimLODConfig& config);
 
     void updateEyeJoint(int index, const glm::vec3& modelTranslation, const glm::quat& modelRotation, const glm::vec3& lookAt, const glm::vec3& saccade);
     void calcAnimAlpha(float speed, const std::vector<float>& referenceSpeeds, float* alphaOut) const;
@@ -479,6 +512,12 @@ protected:
     ControllerParameters _previousControllerParameters;
     Flow _internalFlow;
     Flow _networkFlow;
+
+    AnimLOD _animLOD { AnimLOD::Full };
+    float _animLODPeriod { 0.0f };
+    float _animLODTimer { 0.0f };
+    AnimPoseVec _animLODPrevPoses;    // geometry space relative to parent, pose on screen when the last joint data came in
+    AnimPoseVec _animLODTargetPoses;  // geometry space relative to parent, pose from the last joint data
 };
 
 #endif /* defined(__hifi__Rig__) */
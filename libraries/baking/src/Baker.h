@@ -29,6 +29,7 @@ public:
     QStringList getWarnings() const { return _warningList; }
 
     std::vector<QString> getOutputFiles() const { return _outputFiles; }
+    std::vector<QString> getInputFiles() const { return _inputFiles; }
 
     virtual void setIsFinished(bool isFinished);
     bool isFinished() const { return _isFinished.load(); }
@@ -55,6 +56,10 @@ protected:
     // include the .fbx, a .fst pointing to the fbx, and all of the fbx texture files.
     std::vector<QString> _outputFiles;
 
+    // List of local files the bake read, including those of its sub-bakes. A missing file is listed too,
+    // since creating it would change the output.
+    std::vector<QString> _inputFiles;
+
     QStringList _errorList;
     QStringList _warningList;
 
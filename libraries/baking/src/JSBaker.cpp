@@ -45,6 +45,7 @@ void JSBaker::loadScript() {
     if (_jsURL.isLocalFile()) {
         // load up the local file
         QFile localScript(_jsURL.toLocalFile());
+        _inputFiles.push_back(localScript.fileName());
         if (!localScript.open(QIODevice::ReadOnly | QIODevice::Text)) {
             handleError("Error opening " + _jsURL.fileName() + " for reading");
             return;
@@ -137,6 +137,7 @@ void ModelBaker::saveSourceModel() {
     if (_modelURL.isLocalFile()) {
         // load up the local file
         QFile localModelURL { _modelURL.toLocalFile() };
+        _inputFiles.push_back(localModelURL.fileName());
 
         qDebug() << "Local file url: " << _modelURL << _modelURL.toString() << _modelURL.toLocalFile() << ", copying to: " << _originalOutputModelPath;
 
@@ -212,7 +213,9 @@ void ModelBaker::bakeSourceCopy() {
         handleError("Error opening " + _originalOutputModelPath + " for reading");
         return;
     }
-    hifi::ByteArray modelData = modelFile.readAll();
+    // Map the source rather than reading it into memory, the binary FBX parser works on it in place
+    uchar* mappedModel = modelFile.map(0, modelFile.size());
+    hifi::ByteArray modelData = mappedModel ? hifi::ByteArray::fromRawData((const char*)mappedModel, (int)modelFile.size()) : modelFile.readAll();
 
     std::vector<hifi::ByteArray> dracoMeshes;
     std::vector<std::vector<hifi::ByteArray>> dracoMaterialLists; // Material order for per-mesh material lookup used by dracoMeshes
@@ -223,6 +226,10 @@ void ModelBaker::bakeSourceCopy() {
             handleError("Could not recognize file type of model file " + _originalOutputModelPath);
             return;
         }
+        if (mappedModel && !std::dynamic_pointer_cast<FBXSerializer>(serializer)) {
+            // Other serializers can keep references to the data they are given, which must not outlive the mapping
+            modelData = modelFile.readAll();
+        }
         hifi::VariantHash serializerMapping = _mapping;
         serializerMapping["combineParts"] = true; // set true so that OBJSerializer reads material info from material library
         serializerMapping["deduplicateIndices"] = true; // Draco compression also deduplicates, but we might as well shave it off to save on some earlier processing (currently FBXSerializer only)
@@ -282,6 +289,10 @@ void ModelBaker::handleFinishedMaterialBaker() {
     auto baker = qobject_cast<MaterialBaker*>(sender());
 
     if (baker) {
+        for (auto& inputFile : baker->getInputFiles()) {
+            _inputFiles.push_back(inputFile);
+        }
+
         if (!baker->hasErrors()) {
             // this MaterialBaker is done and everything went according to plan
             qCDebug(model_baking) << "Adding baked material to FST mapping " << baker->getBakedMaterialData();
@@ -330,6 +341,10 @@ void ModelBaker::handleFinishedMaterialMapBaker() {
     auto baker = qobject_cast<MaterialBaker*>(sender());
 
     if (baker) {
+        for (auto& inputFile : baker->getInputFiles()) {
+            _inputFiles.push_back(inputFile);
+        }
+
         if (!baker->hasErrors()) {
             // this MaterialBaker is done and everything went according to plan
             qCDebug(model_baking) << "Adding baked material to FST mapping " << baker->getBakedMaterialData();
@@ -11,6 +11,8 @@
 
 #include "OBJBaker.h"
 
+#include <QtCore/QFile>
+
 #include <PathUtils.h>
 #include <NetworkAccessManager.h>
 
@@ -35,6 +37,24 @@ const QByteArray CONNECTIONS_NODE_PROPERTY = "OO";
 const QByteArray CONNECTIONS_NODE_PROPERTY_1 = "OP";
 const QByteArray MESH = "Mesh";
 
+void OBJBaker::bakeSourceCopy() {
+    // OBJSerializer pulls its material libraries in by itself, list them the way it resolves them
+    if (_modelURL.isLocalFile()) {
+        QFile modelFile(_originalOutputModelPath);
+        if (modelFile.open(QIODevice::ReadOnly)) {
+            while (!modelFile.atEnd()) {
+                auto line = modelFile.readLine().simplified();
+                if (line.startsWith("mtllib ")) {
+                    auto libraryName = QString::fromUtf8(line.mid(line.indexOf(' ') + 1));
+                    _inputFiles.push_back(_modelURL.resolved(QUrl(libraryName).fileName()).toLocalFile());
+                }
+            }
+        }
+    }
+
+    ModelBaker::bakeSourceCopy();
+}
+
 void OBJBaker::bakeProcessedSource(const hfm::Model::Pointer& hfmModel, const std::vector<hifi::ByteArray>& dracoMeshes, const std::vector<std::vector<hifi::ByteArray>>& dracoMaterialLists) {
     // Write OBJ Data as FBX tree nodes
     createFBXNodeTree(_rootNode, hfmModel, dracoMeshes[0], dracoMaterialLists[0]);
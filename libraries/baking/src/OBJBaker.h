@@ -24,6 +24,7 @@ public:
     using ModelBaker::ModelBaker;
 
 protected:
+    virtual void bakeSourceCopy() override;
     virtual void bakeProcessedSource(const hfm::Model::Pointer& hfmModel, const std::vector<hifi::ByteArray>& dracoMeshes, const std::vector<std::vector<hifi::ByteArray>>& dracoMaterialLists) override;
 
 private:
@@ -81,6 +81,7 @@ void TextureBaker::loadTexture() {
     if (_textureURL.isLocalFile()) {
         // load up the local file
         QFile localTexture { _textureURL.toLocalFile() };
+        _inputFiles.push_back(localTexture.fileName());
 
         if (!localTexture.open(QIODevice::ReadOnly)) {
             handleError("Unable to open texture " + _textureURL.toString());
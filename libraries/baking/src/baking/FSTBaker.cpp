@@ -105,6 +105,11 @@ void FSTBaker::handleModelBakerEnded() {
         _outputFiles.push_back(outputFile);
     }
 
+    // The FST itself is already listed, add the model it points to and everything that model read
+    for (auto& inputFile : _modelBaker->getInputFiles()) {
+        _inputFiles.push_back(inputFile);
+    }
+
 }
 
 void FSTBaker::handleModelBakerAborted() {
@@ -123,6 +123,7 @@ public:
     HFMModel::Pointer read(const hifi::ByteArray& data, const hifi::VariantHash& mapping, const hifi::URL& url = hifi::URL()) override;
 
     FBXNode _rootNode;
+    static FBXNode parseFBX(const hifi::ByteArray& data);
     static FBXNode parseFBX(QIODevice* device);
 
     HFMModel* extractHFMModel(const hifi::VariantHash& mapping, const QString& url);
@@ -21,189 +21,187 @@
 #include <QtCore/QtEndian>
 #include <QtCore/QFileInfo>
 
+#include <algorithm>
+#include <atomic>
+
+#include <zlib.h>
+
 #include <shared/NsightHelpers.h>
 #include <hfm/ModelFormatLogging.h>
+#include <TBBHelpers.h>
 
-template<class T>
-int streamSize() {
-    return sizeof(T);
-}
+// Reads the binary format straight out of an in-memory buffer, which can be a memory-mapped file.
+// Everything that ends up in the FBXNode tree is copied out of the buffer, so it doesn't need to outlive the parse.
+class BinaryFBXReader {
+public:
+    BinaryFBXReader(const hifi::ByteArray& data) : _data(data.constData()), _size((size_t)data.size()) {}
 
-template<bool>
-int streamSize() {
-    return 1;
-}
+    size_t getPosition() const { return _position; }
+    bool atEnd() const { return _position >= _size; }
 
-template<class T>
-QVariant readBinaryArray(QDataStream& in, int& position) {
-    quint32 arrayLength;
-    quint32 encoding;
-    quint32 compressedLength;
+    void skip(size_t length) { readRaw(length); }
 
-    in >> arrayLength;
+    const char* readRaw(size_t length) {
+        if (length > _size - _position) {
+            throw QString("FBX file most likely corrupt: unexpected end of file");
+        }
+        const char* data = _data + _position;
+        _position += length;
+        return data;
+    }
+
+    template<class T>
+    T read() {
+        T value;
+        memcpy(&value, readRaw(sizeof(T)), sizeof(T));
+        toHostByteOrder(reinterpret_cast<char*>(&value), sizeof(T), sizeof(T));
+        return value;
+    }
+
+    template<class T>
+    QVariant readArray();
+
+    void inflateDeferredArrays();
+
+private:
+    static void toHostByteOrder(char* data, size_t length, size_t elementSize) {
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+        for (char* element = data; element < data + length; element += elementSize) {
+            std::reverse(element, element + elementSize);
+        }
+#endif
+    }
+
+    struct DeferredInflate {
+        const char* compressed;
+        quint32 compressedLength;
+        char* destination;
+        size_t length;
+        size_t elementSize;
+    };
+
+    const char* _data;
+    size_t _size;
+    size_t _position { 0 };
+    std::vector<DeferredInflate> _deferredInflates;
+};
+
+template<class T>
+QVariant BinaryFBXReader::readArray() {
+    quint32 arrayLength = read<quint32>();
     if (arrayLength > std::numeric_limits<int>::max() / sizeof(T)) { // Upcoming byte containers are limited to max signed int
         throw QString("FBX file most likely corrupt: binary data exceeds data limits");
     }
-    in >> encoding;
-    in >> compressedLength;
+    quint32 encoding = read<quint32>();
+    quint32 compressedLength = read<quint32>();
     if (compressedLength > std::numeric_limits<int>::max() / sizeof(T)) { // Upcoming byte containers are limited to max signed int
         throw QString("FBX file most likely corrupt: compressed binary data exceeds data limits");
     }
-    position += sizeof(quint32) * 3;
-
-    QVector<T> values;
-    if ((int)QSysInfo::ByteOrder == (int)in.byteOrder()) {
-        values.resize(arrayLength);
-        hifi::ByteArray arrayData;
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            hifi::ByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            arrayData = qUncompress(compressed);
-            if (arrayData.isEmpty() ||
-                (unsigned int)arrayData.size() != (sizeof(T) * arrayLength)) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-        } else {
-            arrayData.resize(sizeof(T) * arrayLength);
-            position += sizeof(T) * arrayLength;
-            in.readRawData(arrayData.data(), arrayData.size());
-        }
 
-        if (arrayData.size() > 0) {
-            memcpy(&values[0], arrayData.constData(), arrayData.size());
-        }
-    } else {
-        values.reserve(arrayLength);
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            hifi::ByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            hifi::ByteArray uncompressed = qUncompress(compressed);
-            if (uncompressed.isEmpty()) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-            QDataStream uncompressedIn(uncompressed);
-            uncompressedIn.setByteOrder(QDataStream::LittleEndian);
-            uncompressedIn.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                uncompressedIn >> value;
-                values.append(value);
-            }
-        } else {
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                in >> value;
-                position += streamSize<T>();
-                values.append(value);
-            }
+    QVector<T> values(arrayLength);
+    size_t length = sizeof(T) * arrayLength;
+    char* destination = reinterpret_cast<char*>(values.data());
+    if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
+        const char* compressed = readRaw(compressedLength);
+        if (length > 0) {
+            // Inflated later, together with all the other arrays, straight into the vector's storage.
+            // The storage is shared with the returned QVariant, and nothing reads or detaches it until then.
+            _deferredInflates.push_back({ compressed, compressedLength, destination, length, sizeof(T) });
         }
+    } else if (length > 0) {
+        memcpy(destination, readRaw(length), length);
+        toHostByteOrder(destination, length, sizeof(T));
     }
     return QVariant::fromValue(values);
 }
 
-QVariant parseBinaryFBXProperty(QDataStream& in, int& position) {
-    char ch;
-    in.device()->getChar(&ch);
-    position++;
+void BinaryFBXReader::inflateDeferredArrays() {
+    // Inflating dominates the parse of large binary files, and every array is independent
+    std::atomic<bool> corrupt { false };
+    tbb::parallel_for((size_t)0, _deferredInflates.size(), [&](size_t i) {
+        const auto& inflate = _deferredInflates[i];
+        uLongf inflatedLength = (uLongf)inflate.length;
+        if (uncompress(reinterpret_cast<Bytef*>(inflate.destination), &inflatedLength,
+                       reinterpret_cast<const Bytef*>(inflate.compressed), inflate.compressedLength) != Z_OK ||
+            inflatedLength != inflate.length) {
+            corrupt = true;
+            return;
+        }
+        toHostByteOrder(inflate.destination, inflate.length, inflate.elementSize);
+    });
+    _deferredInflates.clear();
+
+    if (corrupt) {
+        throw QString("corrupt fbx file");
+    }
+}
+
+QVariant parseBinaryFBXProperty(BinaryFBXReader& in) {
+    char ch = in.read<char>();
     switch (ch) {
         case 'Y': {
-            qint16 value;
-            in >> value;
-            position += sizeof(qint16);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<qint16>());
         }
         case 'C': {
-            bool value;
-            in >> value;
-            position++;
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<quint8>() != 0);
         }
         case 'I': {
-            qint32 value;
-            in >> value;
-            position += sizeof(qint32);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<qint32>());
         }
         case 'F': {
-            float value;
-            in >> value;
-            position += sizeof(float);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<float>());
         }
         case 'D': {
-            double value;
-            in >> value;
-            position += sizeof(double);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<double>());
         }
         case 'L': {
-            qint64 value;
-            in >> value;
-            position += sizeof(qint64);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<qint64>());
         }
         case 'f': {
-            return readBinaryArray<float>(in, position);
+            return in.readArray<float>();
         }
         case 'd': {
-            return readBinaryArray<double>(in, position);
+            return in.readArray<double>();
         }
         case 'l': {
-            return readBinaryArray<qint64>(in, position);
+            return in.readArray<qint64>();
         }
         case 'i': {
-            return readBinaryArray<qint32>(in, position);
+            return in.readArray<qint32>();
         }
         case 'b': {
-            return readBinaryArray<bool>(in, position);
+            return in.readArray<bool>();
         }
         case 'S':
         case 'R': {
-            quint32 length;
-            in >> length;
-            position += sizeof(quint32) + length;
-            return QVariant::fromValue(in.device()->read(length));
+            quint32 length = in.read<quint32>();
+            return QVariant::fromValue(hifi::ByteArray(in.readRaw(length), (int)length));
         }
         default:
             throw QString("Unknown property type: ") + ch;
     }
 }
 
-FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPositions = false) {
+FBXNode parseBinaryFBXNode(BinaryFBXReader& in, bool has64BitPositions = false) {
     qint64 endOffset;
     quint64 propertyCount;
     quint64 propertyListLength;
-    quint8 nameLength;
 
     // FBX 2016 and beyond uses 64bit positions in the node headers, pre-2016 used 32bit values
     // our code generally doesn't care about the size that much, so we will use 64bit values
-    // from here on out, but if the file is an older format we read the stream into temp 32bit 
-    // values and then assign to our actual 64bit values.
+    // from here on out, but if the file is an older format we read the 32bit values
+    // and then assign to our actual 64bit values.
     if (has64BitPositions) {
-        in >> endOffset;
-        in >> propertyCount;
-        in >> propertyListLength;
-        position += sizeof(quint64) * 3;
+        endOffset = in.read<qint64>();
+        propertyCount = in.read<quint64>();
+        propertyListLength = in.read<quint64>();
     } else {
-        qint32 tempEndOffset;
-        quint32 tempPropertyCount;
-        quint32 tempPropertyListLength;
-        in >> tempEndOffset;
-        in >> tempPropertyCount;
-        in >> tempPropertyListLength;
-        position += sizeof(quint32) * 3;
-        endOffset = tempEndOffset;
-        propertyCount = tempPropertyCount;
-        propertyListLength = tempPropertyListLength;
-    }
-    in >> nameLength;
-    position += sizeof(quint8);
+        endOffset = in.read<qint32>();
+        propertyCount = in.read<quint32>();
+        propertyListLength = in.read<quint32>();
+    }
+    Q_UNUSED(propertyListLength);
+    quint8 nameLength = in.read<quint8>();
 
     FBXNode node;
     const int MIN_VALID_OFFSET = 40;
@@ -211,15 +209,14 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
         // use a null name to indicate a null node
         return node;
     }
-    node.name = in.device()->read(nameLength);
-    position += nameLength;
+    node.name = hifi::ByteArray(in.readRaw(nameLength), nameLength);
 
-    for (quint32 i = 0; i < propertyCount; i++) {
-        node.properties.append(parseBinaryFBXProperty(in, position));
+    for (quint64 i = 0; i < propertyCount; i++) {
+        node.properties.append(parseBinaryFBXProperty(in));
     }
 
-    while (endOffset > position) {
-        FBXNode child = parseBinaryFBXNode(in, position, has64BitPositions);
+    while (endOffset > (qint64)in.getPosition()) {
+        FBXNode child = parseBinaryFBXNode(in, has64BitPositions);
         if (!child.name.isNull()) {
             node.children.append(child);
         }
@@ -228,6 +225,34 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
     return node;
 }
 
+FBXNode parseBinaryFBX(const hifi::ByteArray& data) {
+    // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
+    // of the FBX binary format
+    BinaryFBXReader in(data);
+
+    // The first 27 bytes contain the header.
+    //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
+    //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
+    //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
+    in.skip(FBX_HEADER_BYTES_BEFORE_VERSION);
+    quint32 fileVersion = in.read<quint32>();
+    bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
+
+    // parse the top-level node
+    FBXNode top;
+    while (!in.atEnd()) {
+        FBXNode next = parseBinaryFBXNode(in, has64BitPositions);
+        if (next.name.isNull()) {
+            break;
+        } else {
+            top.children.append(next);
+        }
+    }
+
+    in.inflateDeferredArrays();
+    return top;
+}
+
 class Tokenizer {
 public:
 
@@ -351,6 +376,16 @@ FBXNode parseTextFBXNode(Tokenizer& tokenizer) {
     return node;
 }
 
+FBXNode FBXSerializer::parseFBX(const hifi::ByteArray& data) {
+    if (!data.startsWith(FBX_BINARY_PROLOG)) {
+        QBuffer buffer(const_cast<hifi::ByteArray*>(&data));
+        buffer.open(QIODevice::ReadOnly);
+        return parseFBX(&buffer);
+    }
+    PROFILE_RANGE_EX(resource_parse, __FUNCTION__, 0xff0000ff, data.size());
+    return parseBinaryFBX(data);
+}
+
 FBXNode FBXSerializer::parseFBX(QIODevice* device) {
     PROFILE_RANGE_EX(resource_parse, __FUNCTION__, 0xff0000ff, device);
     // verify the prolog
@@ -369,37 +404,9 @@ FBXNode FBXSerializer::parseFBX(QIODevice* device) {
         }
         return top;
     }
-    QDataStream in(device);
-    in.setByteOrder(QDataStream::LittleEndian);
-    in.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-
-    // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
-    // of the FBX binary format
-
-    // The first 27 bytes contain the header.
-    //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
-    //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
-    //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
-    in.skipRawData(FBX_HEADER_BYTES_BEFORE_VERSION);
-    int position = FBX_HEADER_BYTES_BEFORE_VERSION;
-    quint32 fileVersion;
-    in >> fileVersion;
-    position += sizeof(fileVersion);
-    bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
-
-    // parse the top-level node
-    FBXNode top;
-    while (device->bytesAvailable()) {
-        FBXNode next = parseBinaryFBXNode(in, position, has64BitPositions);
-        if (next.name.isNull()) {
-            return top;
-
-        } else {
-            top.children.append(next);
-        }
-    }
 
-    return top;
+    // the binary parser works on memory, prefer parseFBX(const hifi::ByteArray&) to avoid this copy
+    return parseBinaryFBX(device->readAll());
 }
 
 
@@ -360,6 +360,14 @@ public:
 
     protected:
         std::shared_ptr<storage::FileStorage> maybeOpenFile() const;
+        void resetLevelStates();
+        bool checkLevel(const storage::Storage& storage, uint16 level) const;
+
+        enum LevelState : uint8_t {
+            LevelUnchecked = 0,
+            LevelValid,
+            LevelInvalid,
+        };
 
         mutable std::shared_ptr<std::mutex> _cacheFileMutex { std::make_shared<std::mutex>() };
         mutable std::weak_ptr<storage::FileStorage> _cacheFile;
@@ -374,6 +382,7 @@ public:
         size_t _offsetToMinMipKV;
 
         ktx::KTXDescriptorPointer _ktxDescriptor;
+        std::unique_ptr<std::atomic<uint8_t>[]> _levelStates;
         friend class Texture;
         friend class Serializer;
         friend class Deserializer;
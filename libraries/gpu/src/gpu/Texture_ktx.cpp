@@ -12,9 +12,12 @@
 
 #include "Texture.h"
 
+#include <limits>
+
 #include <QtCore/QByteArray>
 
 #include <ktx/KTX.h>
+#include <ktx/StreamingReader.h>
 
 #include "GPULogging.h"
 
@@ -160,11 +163,16 @@ struct IrradianceKTXPayload {
 const std::string IrradianceKTXPayload::KEY{ "hifi.irradianceSH" };
 
 KtxStorage::KtxStorage(const storage::StoragePointer& storage) : _storage(storage) {
-    auto ktxPointer = ktx::KTX::create(storage);
-    _ktxDescriptor.reset(new ktx::KTXDescriptor(ktxPointer->toDescriptor()));
-    if (_ktxDescriptor->images.size() < _ktxDescriptor->header.numberOfMipmapLevels) {
+    auto ktxReader = ktx::StreamingReader::create(storage);
+    if (!ktxReader) {
+        // No mips are ever read from an empty descriptor
         qWarning() << "Bad images found in ktx";
+        _ktxDescriptor.reset(new ktx::KTXDescriptor(ktx::Header(), ktx::KeyValues(), ktx::ImageDescriptors()));
+        _minMipLevelAvailable = std::numeric_limits<uint8_t>::max();
+        return;
     }
+    _ktxDescriptor.reset(new ktx::KTXDescriptor(ktxReader->toDescriptor()));
+    resetLevelStates();
 
     _offsetToMinMipKV = _ktxDescriptor->getValueOffsetForKey(ktx::HIFI_MIN_POPULATED_MIP_KEY);
     if (_offsetToMinMipKV) {
@@ -189,13 +197,18 @@ KtxStorage::KtxStorage(const cache::FilePointer& cacheEntry) : KtxStorage(cacheE
 
 KtxStorage::KtxStorage(const std::string& filename) : _filename(filename) {
     {
-        // We are doing a lot of work here just to get descriptor data
+        // Only the header and key-values are read here, the mips stay on disk until they're requested
         ktx::StoragePointer storage{ new storage::FileStorage(_filename.c_str()) };
-        auto ktxPointer = ktx::KTX::create(storage);
-        _ktxDescriptor.reset(new ktx::KTXDescriptor(ktxPointer->toDescriptor()));
-        if (_ktxDescriptor->images.size() < _ktxDescriptor->header.numberOfMipmapLevels) {
+        auto ktxReader = ktx::StreamingReader::create(storage);
+        if (!ktxReader) {
+            // No mips are ever read from an empty descriptor
             qWarning() << "Bad images found in ktx";
+            _ktxDescriptor.reset(new ktx::KTXDescriptor(ktx::Header(), ktx::KeyValues(), ktx::ImageDescriptors()));
+            _minMipLevelAvailable = std::numeric_limits<uint8_t>::max();
+            return;
         }
+        _ktxDescriptor.reset(new ktx::KTXDescriptor(ktxReader->toDescriptor()));
+        resetLevelStates();
 
         _offsetToMinMipKV = _ktxDescriptor->getValueOffsetForKey(ktx::HIFI_MIN_POPULATED_MIP_KEY);
         if (_offsetToMinMipKV) {
@@ -216,6 +229,14 @@ KtxStorage::KtxStorage(const std::string& filename) : _filename(filename) {
     }
 }
 
+void KtxStorage::resetLevelStates() {
+    auto numLevels = _ktxDescriptor->images.size();
+    _levelStates.reset(new std::atomic<uint8_t>[numLevels]);
+    for (size_t level = 0; level < numLevels; ++level) {
+        _levelStates[level] = LevelUnchecked;
+    }
+}
+
 // maybeOpenFile should be called with _cacheFileMutex already held to avoid modifying the file from multiple threads
 std::shared_ptr<storage::FileStorage> KtxStorage::maybeOpenFile() const {
     // Try to get the shared_ptr
@@ -249,26 +270,44 @@ void KtxStorage::releaseOpenKtxFiles() {
     }
 }
 
+// Only the header and key-values were checked on load, each level is checked the first time it is read
+bool KtxStorage::checkLevel(const storage::Storage& storage, uint16 level) const {
+    if (level >= _ktxDescriptor->images.size()) {
+        return false;
+    }
+    auto& state = _levelStates[level];
+    auto currentState = state.load();
+    if (currentState != LevelUnchecked) {
+        return currentState == LevelValid;
+    }
+    bool valid = ktx::StreamingReader::checkLevel(storage, _ktxDescriptor->images[level], level);
+    state.store(valid ? LevelValid : LevelInvalid);
+    return valid;
+}
+
 PixelsPointer KtxStorage::getMipFace(uint16 level, uint8 face) const {
     auto faceOffset = _ktxDescriptor->getMipFaceTexelsOffset(level, face);
     auto faceSize = _ktxDescriptor->getMipFaceTexelsSize(level, face);
     storage::StoragePointer storageView;
     if (faceSize != 0 && faceOffset != 0) {
         if (_storage) {
-            storageView = _storage->createView(faceSize, faceOffset);
+            if (checkLevel(*_storage, level)) {
+                storageView = _storage->createView(faceSize, faceOffset);
+            }
         } else {
             std::lock_guard<std::mutex> lock(*_cacheFileMutex);
             auto file = maybeOpenFile();
-            if (file) {
-                storageView = file->createView(faceSize, faceOffset);
-            } else {
+            if (!file) {
                 qWarning() << "Failed to get a valid file out of maybeOpenFile " << QString::fromStdString(_filename);
+            } else if (checkLevel(*file, level)) {
+                storageView = file->createView(faceSize, faceOffset);
             }
         }
     }
     if (!storageView) {
         qWarning() << "Failed to get a valid storageView for faceSize=" << faceSize << "  faceOffset=" << faceOffset
                     << "out of valid file " << QString::fromStdString(_filename);
+        return nullptr;
     }
     return storageView->toMemoryStorage();
 }
@@ -339,8 +378,9 @@ void KtxStorage::assignMipFaceData(uint16 level, uint8 face, const storage::Stor
 }
 
 bool validKtx(const storage::StoragePointer& storage) {
-    auto ktxPointer = ktx::KTX::create(storage);
-    if (!ktxPointer) {
+    // The levels are checked as KtxStorage reads them
+    auto ktxReader = ktx::StreamingReader::create(storage);
+    if (!ktxReader) {
         return false;
     }
     return true;
@@ -573,12 +613,12 @@ TexturePointer Texture::build(const ktx::KTXDescriptor& descriptor) {
 }
 
 TexturePointer Texture::unserialize(const cache::FilePointer& cacheEntry, const std::string& source) {
-    std::unique_ptr<ktx::KTX> ktxPointer = ktx::KTX::create(std::make_shared<storage::FileStorage>(cacheEntry->getFilepath().c_str()));
-    if (!ktxPointer) {
+    auto ktxReader = ktx::StreamingReader::create(std::make_shared<storage::FileStorage>(cacheEntry->getFilepath().c_str()));
+    if (!ktxReader) {
         return nullptr;
     }
 
-    auto texture = build(ktxPointer->toDescriptor());
+    auto texture = build(ktxReader->toDescriptor());
     if (texture) {
         texture->setKtxBacking(cacheEntry);
         if (texture->source().empty()) {
@@ -590,12 +630,12 @@ TexturePointer Texture::unserialize(const cache::FilePointer& cacheEntry, const
 }
 
 TexturePointer Texture::unserialize(const std::string& ktxfile) {
-    std::unique_ptr<ktx::KTX> ktxPointer = ktx::KTX::create(std::make_shared<storage::FileStorage>(ktxfile.c_str()));
-    if (!ktxPointer) {
+    auto ktxReader = ktx::StreamingReader::create(std::make_shared<storage::FileStorage>(ktxfile.c_str()));
+    if (!ktxReader) {
         return nullptr;
     }
 
-    auto texture = build(ktxPointer->toDescriptor());
+    auto texture = build(ktxReader->toDescriptor());
     if (texture) {
         texture->setKtxBacking(ktxfile);
         texture->setSource(ktxfile);
@@ -18,11 +18,13 @@
 #include <QRgb>
 #include <QBuffer>
 #include <QImageReader>
+#include <QThreadPool>
 
 #include <Finally.h>
 #include <Profile.h>
 #include <StatTracker.h>
 #include <GLMHelpers.h>
+#include <TBBHelpers.h>
 
 #include "TGAReader.h"
 #if !defined(Q_OS_ANDROID)
@@ -501,23 +503,46 @@ struct MyErrorHandler : public nvtt::ErrorHandler {
 };
 
 #if defined(NVTT_API)
-class SequentialTaskDispatcher : public nvtt::TaskDispatcher {
+// Spreads the blocks nvtt hands us over the TBB pool, so a single large mip uses every core
+class ParallelTaskDispatcher : public nvtt::TaskDispatcher {
 public:
-    SequentialTaskDispatcher(const std::atomic<bool>& abortProcessing = false) : _abortProcessing(abortProcessing) {
+    ParallelTaskDispatcher(const std::atomic<bool>& abortProcessing = false) : _abortProcessing(abortProcessing) {
     }
 
     const std::atomic<bool>& _abortProcessing;
 
     void dispatch(nvtt::Task* task, void* context, int count) override {
-        for (int i = 0; i < count; i++) {
+        tbb::parallel_for(0, count, [&](int i) {
             if (!_abortProcessing.load()) {
                 task(context, i);
-            } else {
-                break;
             }
-        }
+        });
     }
 };
+
+// Compresses the level it is given, then builds and compresses each smaller one in turn, so only a single level of
+// the chain is ever held. The blocks of each level are spread over the TBB pool, and nvtt hands the compressed level to
+// the output handler on the calling thread.
+void compressMips(nvtt::Surface& surface, bool buildMips, int face, int mipLevel, const nvtt::CompressionOptions& compressionOptions,
+                  nvtt::OutputHandler* outputHandler, const std::atomic<bool>& abortProcessing) {
+    nvtt::OutputOptions outputOptions;
+    outputOptions.setOutputHeader(false);
+    outputOptions.setOutputHandler(outputHandler);
+    MyErrorHandler errorHandler;
+    outputOptions.setErrorHandler(&errorHandler);
+
+    ParallelTaskDispatcher dispatcher(abortProcessing);
+    nvtt::Context context;
+    context.setTaskDispatcher(&dispatcher);
+
+    context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
+    if (buildMips) {
+        while (surface.canMakeNextMipmap() && !abortProcessing.load()) {
+            surface.buildNextMipmap(nvtt::MipmapFilter_Box);
+            context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
+        }
+    }
+}
 #endif
 
 void convertToFloatFromPacked(const unsigned char* source, int width, int height, size_t srcLineByteStride, gpu::Element sourceFormat,
@@ -604,35 +629,19 @@ void convertImageToHDRTexture(gpu::Texture* texture, Image&& image, BackendTarge
     const int width = localCopy.getWidth();
     const int height = localCopy.getHeight();
 
-    nvtt::OutputOptions outputOptions;
-    outputOptions.setOutputHeader(false);
-
     nvtt::CompressionOptions compressionOptions;
     std::unique_ptr<nvtt::OutputHandler> outputHandler{ getNVTTCompressionOutputHandler(texture, face, compressionOptions) };
-
-    MyErrorHandler errorHandler;
-    outputOptions.setErrorHandler(&errorHandler);
-    nvtt::Context context;
-    int mipLevel = baseMipLevel;
-
-    outputOptions.setOutputHandler(outputHandler.get());
+    if (!outputHandler) {
+        return;
+    }
 
     nvtt::Surface surface;
     surface.setImage(nvtt::InputFormat_RGBA_32F, width, height, 1, localCopy.getBits());
     surface.setAlphaMode(nvtt::AlphaMode_None);
     surface.setWrapMode(nvtt::WrapMode_Mirror);
+    localCopy = Image();
 
-    SequentialTaskDispatcher dispatcher(abortProcessing);
-    nvtt::Compressor compressor;
-    context.setTaskDispatcher(&dispatcher);
-
-    context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
-    if (buildMips) {
-        while (surface.canMakeNextMipmap() && !abortProcessing.load()) {
-            surface.buildNextMipmap(nvtt::MipmapFilter_Box);
-            context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
-        }
-    }
+    compressMips(surface, buildMips, face, baseMipLevel, compressionOptions, outputHandler.get(), abortProcessing);
 }
 
 void convertImageToLDRTexture(gpu::Texture* texture, Image&& image, BackendTarget target, int baseMipLevel, bool buildMips, const std::atomic<bool>& abortProcessing, int face) {
@@ -752,23 +761,8 @@ void convertImageToLDRTexture(gpu::Texture* texture, Image&& image, BackendTarge
             return;
         }
 
-        nvtt::OutputOptions outputOptions;
-        outputOptions.setOutputHeader(false);
         OutputHandler outputHandler(texture, face);
-        outputOptions.setOutputHandler(&outputHandler);
-        MyErrorHandler errorHandler;
-        outputOptions.setErrorHandler(&errorHandler);
-
-        SequentialTaskDispatcher dispatcher(abortProcessing);
-        nvtt::Compressor context;
-
-        context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
-        if (buildMips) {
-            while (surface.canMakeNextMipmap() && !abortProcessing.load()) {
-                surface.buildNextMipmap(nvtt::MipmapFilter_Box);
-                context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
-            }
-        }
+        compressMips(surface, buildMips, face, mipLevel, compressionOptions, &outputHandler, abortProcessing);
     } else {
         int numMips = 1;
     
@@ -807,7 +801,11 @@ void convertImageToLDRTexture(gpu::Texture* texture, Image&& image, BackendTarge
 
         const Etc::ErrorMetric errorMetric = Etc::ErrorMetric::RGBA;
         const float effort = 1.0f;
-        const int numEncodeThreads = 4;
+        // Etc2Comp runs its own encoding threads on top of the texture processing pool we're called from.
+        // Only take the threads the pool has spare, the slot of the calling thread included.
+        auto texturePool = QThreadPool::globalInstance();
+        const int spareThreads = texturePool->maxThreadCount() - texturePool->activeThreadCount() + 1;
+        const int numEncodeThreads = std::max(1, std::min(spareThreads, tbb::this_task_arena::max_concurrency()));
         int encodingTime;
 
         if (localCopy.getFormat() != Image::Format_RGBAF) {
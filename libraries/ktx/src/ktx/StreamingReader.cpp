@@ -0,0 +1,113 @@
+//
+//  StreamingReader.cpp
+//  ktx/src/ktx
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "StreamingReader.h"
+
+#include <QtCore/QDebug>
+
+using namespace ktx;
+
+std::unique_ptr<StreamingReader> StreamingReader::create(const StoragePointer& storage) {
+    if (!storage || !(*storage)) {
+        return nullptr;
+    }
+
+    if (!KTX::checkHeaderFromStorage(storage->size(), storage->data())) {
+        return nullptr;
+    }
+
+    Header header;
+    memcpy(&header, storage->data(), sizeof(Header));
+    auto keyValues = KTX::parseKeyValues(header.bytesOfKeyValueData, storage->data() + sizeof(Header));
+
+    std::unique_ptr<StreamingReader> result(new StreamingReader(storage, header, keyValues));
+    if (!result->computeImages()) {
+        return nullptr;
+    }
+    return result;
+}
+
+bool StreamingReader::checkLevel(const Storage& storage, const ImageDescriptor& image, uint16_t level) {
+    const size_t prefixOffset = image._faceOffsets.front() - IMAGE_SIZE_WIDTH;
+    const size_t imageEnd = prefixOffset + IMAGE_SIZE_WIDTH + image._imageSize;
+    if (imageEnd > storage.size()) {
+        qWarning() << "KTX storage is too short for level" << level << "," << storage.size() << "bytes, expected" << imageEnd;
+        return false;
+    }
+
+    uint32_t imageSize;
+    memcpy(&imageSize, storage.data() + prefixOffset, sizeof(uint32_t));
+    if (imageSize != image._faceSize) {
+        qWarning() << "KTX level" << level << "has image size" << imageSize << "expected" << image._faceSize;
+        return false;
+    }
+    return true;
+}
+
+StreamingReader::StreamingReader(const StoragePointer& storage, const Header& header, const KeyValues& keyValues) :
+    _storage(storage),
+    _header(header),
+    _keyValues(keyValues) {
+}
+
+bool StreamingReader::computeImages() {
+    const size_t texelsStart = sizeof(Header) + _header.bytesOfKeyValueData;
+    const bool isCube = (_header.numberOfFaces == NUM_CUBEMAPFACES);
+    const uint32_t numFaces = isCube ? NUM_CUBEMAPFACES : 1;
+    const uint32_t numLevels = _header.getNumberOfLevels();
+
+    // Offsets follow from the header alone, nothing past the key-values is read here
+    size_t imageOffset = 0;
+    _images.reserve(numLevels);
+    for (uint32_t level = 0; level < numLevels; ++level) {
+        // The image size is the face size for cube maps
+        auto faceSize = _header.evalImageSize(level);
+        if (faceSize == 0 || !checkAlignment(faceSize)) {
+            qWarning() << "KTX level" << level << "has an invalid size";
+            return false;
+        }
+
+        size_t imageSize = faceSize * numFaces;
+        uint32_t padding = evalPadding(imageSize);
+        ImageHeader::FaceOffsets offsets(numFaces);
+        for (uint32_t face = 0; face < numFaces; ++face) {
+            offsets[face] = texelsStart + imageOffset + IMAGE_SIZE_WIDTH + face * faceSize;
+        }
+        _images.emplace_back(ImageHeader(isCube, imageOffset, (uint32_t)faceSize, padding), offsets);
+
+        imageOffset += IMAGE_SIZE_WIDTH + imageSize + padding;
+    }
+
+    _levelStates.reset(new std::atomic<uint8_t>[numLevels]);
+    for (uint32_t level = 0; level < numLevels; ++level) {
+        _levelStates[level] = Unchecked;
+    }
+    return true;
+}
+
+bool StreamingReader::isLevelValid(uint16_t level) const {
+    auto& state = _levelStates[level];
+    auto currentState = state.load();
+    if (currentState != Unchecked) {
+        return currentState == Valid;
+    }
+
+    // Checking twice from two threads is harmless, both get the same answer
+    bool valid = checkLevel(*_storage, _images[level], level);
+    state.store(valid ? Valid : Invalid);
+    return valid;
+}
+
+StoragePointer StreamingReader::getMipFaceTexelsData(uint16_t mip, uint8_t face) const {
+    if (mip >= _images.size() || face >= _images[mip]._numFaces || !isLevelValid(mip)) {
+        return nullptr;
+    }
+    const auto& image = _images[mip];
+    return _storage->createView(image._faceSize, image._faceOffsets[face]);
+}
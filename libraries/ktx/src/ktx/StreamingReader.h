@@ -0,0 +1,66 @@
+//
+//  StreamingReader.h
+//  ktx/src/ktx
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_ktx_StreamingReader_h
+#define hifi_ktx_StreamingReader_h
+
+#include <atomic>
+
+#include "KTX.h"
+
+namespace ktx {
+
+    // Reads a KTX in place, typically over a memory-mapped FileStorage.
+    //
+    // Only the header and key-values are read and checked up front, the image table is computed from the header alone.
+    // Each level is checked against the storage the first time one of its faces is requested, so a texture that only
+    // ever shows its small mips never touches the pages of its large ones.
+    class StreamingReader {
+    public:
+        // Returns nullptr if the header or key-values are invalid, a bad level only fails when it is requested
+        static std::unique_ptr<StreamingReader> create(const StoragePointer& storage);
+
+        // Checks that a level lies within the storage and that its image size prefix matches the header.
+        // Only the 4 byte prefix is read.
+        static bool checkLevel(const Storage& storage, const ImageDescriptor& image, uint16_t level);
+
+        const Header& getHeader() const { return _header; }
+        const KeyValues& getKeyValues() const { return _keyValues; }
+        const StoragePointer& getStorage() const { return _storage; }
+        uint16_t getNumLevels() const { return (uint16_t)_images.size(); }
+
+        // Checks the level on its first request, returns nullptr if it is invalid
+        StoragePointer getMipFaceTexelsData(uint16_t mip = 0, uint8_t face = 0) const;
+
+        // Same layout KTX::toDescriptor() produces, without reading any image
+        KTXDescriptor toDescriptor() const { return { _header, _keyValues, _images }; }
+
+    private:
+        StreamingReader(const StoragePointer& storage, const Header& header, const KeyValues& keyValues);
+        bool computeImages();
+        bool isLevelValid(uint16_t level) const;
+
+        enum LevelState : uint8_t {
+            Unchecked = 0,
+            Valid,
+            Invalid,
+        };
+
+        const StoragePointer _storage;
+        const Header _header;
+        const KeyValues _keyValues;
+        ImageDescriptors _images;
+        std::unique_ptr<std::atomic<uint8_t>[]> _levelStates;
+    };
+
+}
+
+#endif // hifi_ktx_StreamingReader_h
@@ -33,6 +33,7 @@
 
 #include <gl/GLHelpers.h>
 #include <gpu/Batch.h>
+#include <ktx/StreamingReader.h>
 
 #include <image/TextureProcessing.h>
 
@@ -604,13 +605,13 @@ void NetworkTexture::makeLocalRequest() {
     path = FileUtils::selectFile(path);
 
     auto storage = std::make_shared<storage::FileStorage>(path);
-    std::unique_ptr<ktx::KTX> ktxFile;
+    std::unique_ptr<ktx::StreamingReader> ktxReader;
     if (storage) {
-        ktxFile = ktx::KTX::create(storage);
+        ktxReader = ktx::StreamingReader::create(storage);
     }
     std::shared_ptr<ktx::KTXDescriptor> ktxDescriptor;
-    if (ktxFile) {
-        ktxDescriptor = std::make_shared<ktx::KTXDescriptor>(ktxFile->toDescriptor());
+    if (ktxReader) {
+        ktxDescriptor = std::make_shared<ktx::KTXDescriptor>(ktxReader->toDescriptor());
     }
 
     gpu::TexturePointer texture;
@@ -24,6 +24,7 @@
 #include "BuildDracoMeshTask.h"
 #include "ParseFlowDataTask.h"
 #include <hfm/HFMModelMath.h>
+#include <TBBHelpers.h>
 
 namespace baker {
 
@@ -63,11 +64,11 @@ namespace baker {
             indexedTrianglesMeshOut.clear();
             indexedTrianglesMeshOut.resize(meshesIn.size());
 
-            for (size_t i = 0; i < meshesIn.size(); i++) {
+            tbb::parallel_for((size_t)0, meshesIn.size(), [&](size_t i) {
                 auto& mesh = meshesIn[i];
                 const auto verticesStd = mesh.vertices.toStdVector();
                 indexedTrianglesMeshOut[i] = hfm::generateTriangleListMesh(verticesStd, mesh.parts);
-            }
+            });
         }
     };
 
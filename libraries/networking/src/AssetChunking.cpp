@@ -0,0 +1,155 @@
+//
+//  AssetChunking.cpp
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetChunking.h"
+
+#include <algorithm>
+#include <array>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+
+namespace AssetUtils {
+
+static const quint8 MANIFEST_VERSION = 1;
+
+// Below the average size a boundary needs more zero bits than above it, which keeps
+// chunk sizes close to the average (normalized chunking)
+static const uint64_t SMALL_CHUNK_MASK = ((1ULL << 18) - 1) << (64 - 18);
+static const uint64_t LARGE_CHUNK_MASK = ((1ULL << 14) - 1) << (64 - 14);
+
+using GearTable = std::array<uint64_t, 256>;
+
+static GearTable createGearTable() {
+    // splitmix64 from a fixed seed, every build must produce the same table
+    GearTable table;
+    uint64_t state = 0x6a09e667f3bcc908ULL;
+    for (auto& value : table) {
+        state += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        value = z ^ (z >> 31);
+    }
+    return table;
+}
+
+DataOffset findChunkSize(const char* data, DataOffset size) {
+    static const GearTable GEAR = createGearTable();
+
+    if (size <= MIN_CHUNK_SIZE) {
+        return size;
+    }
+
+    auto bytes = reinterpret_cast<const uint8_t*>(data);
+    DataOffset end = std::min(size, MAX_CHUNK_SIZE);
+    DataOffset normal = std::min(end, AVERAGE_CHUNK_SIZE);
+
+    uint64_t fingerprint = 0;
+    DataOffset i = MIN_CHUNK_SIZE;
+    for (; i < normal; ++i) {
+        fingerprint = (fingerprint << 1) + GEAR[bytes[i]];
+        if (!(fingerprint & SMALL_CHUNK_MASK)) {
+            return i + 1;
+        }
+    }
+    for (; i < end; ++i) {
+        fingerprint = (fingerprint << 1) + GEAR[bytes[i]];
+        if (!(fingerprint & LARGE_CHUNK_MASK)) {
+            return i + 1;
+        }
+    }
+    return end;
+}
+
+AssetManifest createManifest(const char* data, DataOffset size) {
+    AssetManifest manifest;
+    manifest.size = size;
+    manifest.chunks.reserve(size / AVERAGE_CHUNK_SIZE + 1);
+
+    QCryptographicHash assetHash(QCryptographicHash::Sha256);
+    QCryptographicHash chunkHash(QCryptographicHash::Sha256);
+
+    DataOffset offset = 0;
+    while (offset < size) {
+        auto chunkSize = findChunkSize(data + offset, size - offset);
+
+        chunkHash.reset();
+        chunkHash.addData(data + offset, (int)chunkSize);
+        assetHash.addData(data + offset, (int)chunkSize);
+
+        manifest.chunks.push_back({ chunkHash.result(), offset, chunkSize });
+        offset += chunkSize;
+    }
+    manifest.hash = assetHash.result();
+
+    return manifest;
+}
+
+bool AssetManifest::isValid() const {
+    if (hash.size() != (int)SHA256_HASH_LENGTH) {
+        return false;
+    }
+    DataOffset offset = 0;
+    for (const auto& chunk : chunks) {
+        if (chunk.offset != offset || chunk.size <= 0 || chunk.size > MAX_CHUNK_SIZE ||
+            chunk.hash.size() != (int)SHA256_HASH_LENGTH) {
+            return false;
+        }
+        offset += chunk.size;
+    }
+    return offset == size;
+}
+
+QByteArray AssetManifest::toByteArray() const {
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+
+    stream << MANIFEST_VERSION << (qint64)size << (quint32)chunks.size();
+    stream.writeRawData(hash.constData(), hash.size());
+    for (const auto& chunk : chunks) {
+        stream << (quint32)chunk.size;
+        stream.writeRawData(chunk.hash.constData(), chunk.hash.size());
+    }
+    return bytes;
+}
+
+bool AssetManifest::fromByteArray(const QByteArray& bytes, AssetManifest& manifest) {
+    QDataStream stream(bytes);
+
+    quint8 version;
+    qint64 size;
+    quint32 numChunks;
+    stream >> version >> size >> numChunks;
+    if (stream.status() != QDataStream::Ok || version != MANIFEST_VERSION || size < 0 ||
+        numChunks > (quint64)size / MIN_CHUNK_SIZE + 1) {
+        return false;
+    }
+
+    manifest.size = size;
+    manifest.hash.resize(SHA256_HASH_LENGTH);
+    stream.readRawData(manifest.hash.data(), SHA256_HASH_LENGTH);
+
+    manifest.chunks.clear();
+    manifest.chunks.reserve(numChunks);
+    DataOffset offset = 0;
+    for (quint32 i = 0; i < numChunks; ++i) {
+        quint32 chunkSize;
+        stream >> chunkSize;
+        QByteArray chunkHash(SHA256_HASH_LENGTH, 0);
+        stream.readRawData(chunkHash.data(), SHA256_HASH_LENGTH);
+        manifest.chunks.push_back({ chunkHash, offset, chunkSize });
+        offset += chunkSize;
+    }
+
+    return stream.status() == QDataStream::Ok && manifest.isValid();
+}
+
+} // namespace AssetUtils
@@ -0,0 +1,58 @@
+//
+//  AssetChunking.h
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetChunking_h
+#define hifi_AssetChunking_h
+
+#include <vector>
+
+#include <QtCore/QByteArray>
+
+#include "AssetUtils.h"
+
+// Content-defined chunking of assets, so that an edit only changes the chunks around it.
+// Chunk boundaries come from a rolling gear hash over the content (FastCDC with normalized chunking),
+// not from fixed offsets, so inserting or removing bytes does not shift every following chunk.
+// Client and server must cut identical chunks: the gear table and the sizes below are part of the protocol.
+namespace AssetUtils {
+
+const DataOffset MIN_CHUNK_SIZE = 16 * 1024;
+const DataOffset AVERAGE_CHUNK_SIZE = 64 * 1024;
+const DataOffset MAX_CHUNK_SIZE = 256 * 1024;
+
+// Smaller assets are transferred whole, the chunk round trip would cost more than it saves
+const DataOffset MIN_CHUNKED_ASSET_SIZE = 1024 * 1024;
+
+struct AssetChunk {
+    QByteArray hash; // SHA-256 of the chunk, raw bytes
+    DataOffset offset;
+    DataOffset size;
+};
+
+struct AssetManifest {
+    QByteArray hash; // SHA-256 of the whole asset, raw bytes
+    DataOffset size { 0 };
+    std::vector<AssetChunk> chunks;
+
+    bool isValid() const;
+
+    QByteArray toByteArray() const;
+    static bool fromByteArray(const QByteArray& bytes, AssetManifest& manifest);
+};
+
+// Size of the chunk starting at `data`, at most `size`
+DataOffset findChunkSize(const char* data, DataOffset size);
+
+AssetManifest createManifest(const char* data, DataOffset size);
+inline AssetManifest createManifest(const QByteArray& data) { return createManifest(data.constData(), data.size()); }
+
+} // namespace AssetUtils
+
+#endif // hifi_AssetChunking_h
@@ -14,8 +14,15 @@
 #include <cstdint>
 
 #include <QtCore/QBuffer>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QPointer>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <QtScript/QScriptEngine>
 #include <QtNetwork/QNetworkDiskCache>
 
@@ -34,6 +41,20 @@
 
 MessageID AssetClient::_currentID = 0;
 
+// Records appended to the local chunk index before it is rewritten without the stale ones
+static const int MIN_LOCAL_CHUNK_RECORDS_TO_COMPACT = 64;
+
+// Copies and verifies the locally cached chunks of an asset, off the AssetClient thread
+class LocalChunksTask : public QRunnable {
+public:
+    LocalChunksTask(std::function<void()> fill) : _fill(fill) {}
+
+    void run() override { _fill(); }
+
+private:
+    std::function<void()> _fill;
+};
+
 AssetClient::AssetClient() {
     _cacheDir = qApp->property(hifi::properties::APP_LOCAL_DATA_PATH).toString();
     setCustomDeleter([](Dependency* dependency){
@@ -47,6 +68,7 @@ AssetClient::AssetClient() {
     packetReceiver.registerListener(PacketType::AssetGetInfoReply, this, "handleAssetGetInfoReply");
     packetReceiver.registerListener(PacketType::AssetGetReply, this, "handleAssetGetReply", true);
     packetReceiver.registerListener(PacketType::AssetUploadReply, this, "handleAssetUploadReply");
+    packetReceiver.registerListener(PacketType::AssetChunkQueryReply, this, "handleAssetChunkQueryReply");
 
     connect(nodeList.data(), &LimitedNodeList::nodeKilled, this, &AssetClient::handleNodeKilled);
     connect(nodeList.data(), &LimitedNodeList::clientConnectionToNodeReset,
@@ -79,6 +101,8 @@ void AssetClient::initCaching() {
                 << "(size:" << cache->maximumCacheSize() / BYTES_PER_GIGABYTES << "GB)";
     }
 
+    loadLocalChunks();
+
 }
 
 namespace {
@@ -311,6 +335,14 @@ void AssetClient::clearCache() {
     if (auto cache = NetworkAccessManager::getInstance().cache()) {
         qInfo() << "AssetClient::clearCache(): Clearing disk cache.";
         cache->clear();
+
+        // the chunks went with the assets holding them
+        _localChunks.clear();
+        _localChunkManifests.clear();
+        _localChunkAssets.clear();
+        _localChunkAssetsSize = 0;
+        _numLocalChunkRecords = 0;
+        QFile::remove(getLocalChunksPath());
     } else {
         qCWarning(asset_client) << "No disk cache to clear.";
     }
@@ -882,6 +914,17 @@ bool AssetClient::cancelGetAssetRequest(MessageID id) {
     return false;
 }
 
+bool AssetClient::cancelChunkQuery(MessageID id) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    for (auto& kv : _pendingChunkQueries) {
+        if (kv.second.erase(id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool AssetClient::cancelUploadAssetRequest(MessageID id) {
     Q_ASSERT(QThread::currentThread() == thread());
 
@@ -961,6 +1004,322 @@ void AssetClient::handleAssetUploadReply(QSharedPointer<ReceivedMessage> message
     }
 }
 
+MessageID AssetClient::getAssetManifest(const AssetUtils::AssetHash& hash, ManifestCallback callback) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    SharedNodePointer assetServer = nodeList->soloNodeOfType(NodeType::AssetServer);
+
+    if (assetServer) {
+        auto messageID = ++_currentID;
+
+        auto payloadSize = sizeof(messageID) + sizeof(AssetUtils::AssetChunkQueryType) + AssetUtils::SHA256_HASH_LENGTH;
+        auto packet = NLPacket::create(PacketType::AssetChunkQuery, payloadSize, true);
+
+        packet->writePrimitive(messageID);
+        packet->writePrimitive(AssetUtils::AssetChunkQueryType::GetManifest);
+        packet->write(QByteArray::fromHex(hash.toLatin1()));
+
+        if (nodeList->sendPacket(std::move(packet), *assetServer) != -1) {
+            _pendingChunkQueries[assetServer][messageID] = [callback](bool responseReceived, AssetUtils::AssetServerError error,
+                                                                      QSharedPointer<ReceivedMessage> message) {
+                AssetUtils::AssetManifest manifest;
+                QByteArray assetData;
+                if (responseReceived && error == AssetUtils::AssetServerError::NoError) {
+                    AssetUtils::AssetManifestReplyType replyType;
+                    message->readPrimitive(&replyType);
+                    if (replyType == AssetUtils::AssetManifestReplyType::ChunkManifest) {
+                        AssetUtils::AssetManifest::fromByteArray(message->readAll(), manifest);
+                    } else {
+                        assetData = message->readAll();
+                    }
+                }
+                callback(responseReceived, error, manifest, assetData);
+            };
+
+            return messageID;
+        }
+    }
+
+    callback(false, AssetUtils::AssetServerError::NoError, AssetUtils::AssetManifest(), QByteArray());
+    return INVALID_MESSAGE_ID;
+}
+
+MessageID AssetClient::queryChunks(const AssetUtils::AssetManifest& manifest, HasChunksCallback callback) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    SharedNodePointer assetServer = nodeList->soloNodeOfType(NodeType::AssetServer);
+
+    if (assetServer) {
+        auto packetList = NLPacketList::create(PacketType::AssetChunkQuery, QByteArray(), true, true);
+
+        auto messageID = ++_currentID;
+        packetList->writePrimitive(messageID);
+        packetList->writePrimitive(AssetUtils::AssetChunkQueryType::HasChunks);
+
+        uint32_t numChunks = (uint32_t)manifest.chunks.size();
+        packetList->writePrimitive(numChunks);
+        for (const auto& chunk : manifest.chunks) {
+            packetList->write(chunk.hash);
+        }
+
+        if (nodeList->sendPacketList(std::move(packetList), *assetServer) != -1) {
+            _pendingChunkQueries[assetServer][messageID] = [callback, numChunks](bool responseReceived, AssetUtils::AssetServerError error,
+                                                                                 QSharedPointer<ReceivedMessage> message) {
+                std::vector<bool> hasChunks(numChunks, false);
+                if (responseReceived && error == AssetUtils::AssetServerError::NoError) {
+                    auto flags = message->read(numChunks);
+                    for (int i = 0; i < flags.size(); ++i) {
+                        hasChunks[i] = flags[i] != 0;
+                    }
+                }
+                callback(responseReceived, error, hasChunks);
+            };
+
+            return messageID;
+        }
+    }
+
+    callback(false, AssetUtils::AssetServerError::NoError, std::vector<bool>());
+    return INVALID_MESSAGE_ID;
+}
+
+MessageID AssetClient::uploadAssetChunked(const QByteArray& data, const AssetUtils::AssetManifest& manifest,
+                                          const std::vector<bool>& sendChunks, UploadResultCallback callback) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    SharedNodePointer assetServer = nodeList->soloNodeOfType(NodeType::AssetServer);
+
+    if (assetServer && sendChunks.size() == manifest.chunks.size()) {
+        auto packetList = NLPacketList::create(PacketType::AssetUploadChunked, QByteArray(), true, true);
+
+        auto messageID = ++_currentID;
+        packetList->writePrimitive(messageID);
+
+        auto manifestBytes = manifest.toByteArray();
+        packetList->writePrimitive((uint32_t)manifestBytes.size());
+        packetList->write(manifestBytes);
+
+        for (size_t i = 0; i < manifest.chunks.size(); ++i) {
+            const auto& chunk = manifest.chunks[i];
+            uint8_t included = sendChunks[i] ? 1 : 0;
+            packetList->writePrimitive(included);
+            if (included) {
+                packetList->write(data.constData() + chunk.offset, chunk.size);
+            }
+        }
+
+        if (nodeList->sendPacketList(std::move(packetList), *assetServer) != -1) {
+            _pendingUploads[assetServer][messageID] = callback;
+
+            return messageID;
+        }
+    }
+
+    callback(false, AssetUtils::AssetServerError::NoError, QString());
+    return INVALID_MESSAGE_ID;
+}
+
+void AssetClient::handleAssetChunkQueryReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    MessageID messageID;
+    message->readPrimitive(&messageID);
+
+    AssetUtils::AssetServerError error;
+    message->readPrimitive(&error);
+
+    auto messageMapIt = _pendingChunkQueries.find(senderNode);
+    if (messageMapIt != _pendingChunkQueries.end()) {
+        auto& messageCallbackMap = messageMapIt->second;
+
+        auto requestIt = messageCallbackMap.find(messageID);
+        if (requestIt != messageCallbackMap.end()) {
+            auto callback = requestIt->second;
+            messageCallbackMap.erase(requestIt);
+            callback(true, error, message);
+        }
+    }
+}
+
+QString AssetClient::getLocalChunksPath() const {
+    if (auto cache = qobject_cast<QNetworkDiskCache*>(NetworkAccessManager::getInstance().cache())) {
+        return QDir(cache->cacheDirectory()).filePath("assetChunks");
+    }
+    return QString();
+}
+
+void AssetClient::loadLocalChunks() {
+    QFile file { getLocalChunksPath() };
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    // records are appended as assets are cached, stop at the first one that was cut short
+    QDataStream stream(&file);
+    while (!stream.atEnd()) {
+        QString hash;
+        QByteArray manifestBytes;
+        stream >> hash >> manifestBytes;
+
+        AssetUtils::AssetManifest manifest;
+        if (stream.status() != QDataStream::Ok || !AssetUtils::AssetManifest::fromByteArray(manifestBytes, manifest)) {
+            break;
+        }
+        indexLocalChunks(hash, manifest);
+        ++_numLocalChunkRecords;
+    }
+    file.close();
+
+    evictLocalChunks();
+    compactLocalChunks();
+
+    qCDebug(asset_client) << "Loaded" << _localChunks.size() << "local chunks of" << _localChunkAssets.size() << "assets";
+}
+
+void AssetClient::indexLocalChunks(const AssetUtils::AssetHash& hash, const AssetUtils::AssetManifest& manifest) {
+    // an asset cached again becomes the newest
+    removeLocalChunks(hash);
+
+    for (const auto& chunk : manifest.chunks) {
+        _localChunks.insert(chunk.hash, { hash, chunk.offset, chunk.size });
+    }
+    _localChunkManifests.insert(hash, manifest);
+    _localChunkAssets.append(hash);
+    _localChunkAssetsSize += manifest.size;
+}
+
+void AssetClient::removeLocalChunks(const AssetUtils::AssetHash& hash) {
+    auto manifest = _localChunkManifests.find(hash);
+    if (manifest == _localChunkManifests.end()) {
+        return;
+    }
+
+    for (const auto& chunk : manifest->chunks) {
+        // a chunk shared with an asset indexed since is found in that one
+        auto it = _localChunks.find(chunk.hash);
+        if (it != _localChunks.end() && it->asset == hash) {
+            _localChunks.erase(it);
+        }
+    }
+    _localChunkAssetsSize -= manifest->size;
+    _localChunkManifests.erase(manifest);
+    _localChunkAssets.removeOne(hash);
+}
+
+void AssetClient::evictLocalChunks() {
+    auto cache = qobject_cast<QNetworkDiskCache*>(NetworkAccessManager::getInstance().cache());
+    if (!cache) {
+        return;
+    }
+
+    // the disk cache can't hold more than this, older assets have been evicted from it
+    while (_localChunkAssetsSize > cache->maximumCacheSize() && !_localChunkAssets.isEmpty()) {
+        removeLocalChunks(_localChunkAssets.first());
+    }
+}
+
+void AssetClient::compactLocalChunks() {
+    if (_numLocalChunkRecords <= std::max(2 * _localChunkAssets.size(), MIN_LOCAL_CHUNK_RECORDS_TO_COMPACT)) {
+        return;
+    }
+
+    QSaveFile file { getLocalChunksPath() };
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    QDataStream stream(&file);
+    for (const auto& hash : _localChunkAssets) {
+        stream << hash << _localChunkManifests.value(hash).toByteArray();
+    }
+    if (file.commit()) {
+        _numLocalChunkRecords = _localChunkAssets.size();
+    }
+}
+
+void AssetClient::addLocalChunks(const AssetUtils::AssetHash& hash, const AssetUtils::AssetManifest& manifest) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    indexLocalChunks(hash, manifest);
+
+    QFile file { getLocalChunksPath() };
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        QDataStream stream(&file);
+        stream << hash << manifest.toByteArray();
+        ++_numLocalChunkRecords;
+    }
+    file.close();
+
+    evictLocalChunks();
+    compactLocalChunks();
+}
+
+void AssetClient::fillFromLocalChunks(const AssetUtils::AssetManifest& manifest, LocalChunksCallback callback) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    // the chunks are located and the cached assets holding them opened here, where the disk cache lives,
+    // copying and hashing them is left to a worker
+    std::vector<LocalChunk> locations(manifest.chunks.size());
+    auto sources = std::make_shared<QHash<AssetUtils::AssetHash, std::shared_ptr<QIODevice>>>();
+    auto cache = NetworkAccessManager::getInstance().cache();
+    for (size_t i = 0; i < manifest.chunks.size(); ++i) {
+        auto it = _localChunks.find(manifest.chunks[i].hash);
+        if (it == _localChunks.end()) {
+            continue;
+        }
+        locations[i] = *it;
+        if (cache && !sources->contains(it->asset)) {
+            sources->insert(it->asset, std::shared_ptr<QIODevice>(cache->data(AssetUtils::getATPUrl(it->asset))));
+        }
+    }
+
+    auto that = QPointer<AssetClient>(this);
+    QThreadPool::globalInstance()->start(new LocalChunksTask([that, manifest, locations, sources, callback] {
+        QByteArray data;
+        data.resize(manifest.size);
+        std::vector<bool> missing(manifest.chunks.size(), true);
+        QSet<AssetUtils::AssetHash> staleAssets;
+
+        for (size_t i = 0; i < manifest.chunks.size(); ++i) {
+            const auto& chunk = manifest.chunks[i];
+            const auto& location = locations[i];
+            if (location.asset.isEmpty()) {
+                continue;
+            }
+
+            QByteArray chunkData;
+            auto source = sources->value(location.asset);
+            if (source && source->seek(location.offset)) {
+                chunkData = source->read(location.size);
+            }
+            if (chunkData.size() == chunk.size && AssetUtils::hashData(chunkData) == chunk.hash) {
+                memcpy(data.data() + chunk.offset, chunkData.constData(), chunk.size);
+                missing[i] = false;
+            } else {
+                // the asset holding this chunk left the cache
+                staleAssets.insert(location.asset);
+            }
+        }
+
+        if (!that) {
+            return;
+        }
+        QMetaObject::invokeMethod(that.data(), [that, data, missing, staleAssets, sources, callback] {
+            // the cached assets are closed on the thread that opened them
+            sources->clear();
+            for (const auto& asset : staleAssets) {
+                that->removeLocalChunks(asset);
+            }
+            if (!staleAssets.isEmpty()) {
+                that->compactLocalChunks();
+            }
+            callback(data, missing);
+        }, Qt::QueuedConnection);
+    }));
+}
+
 void AssetClient::handleNodeKilled(SharedNodePointer node) {
     Q_ASSERT(QThread::currentThread() == thread());
 
@@ -1032,4 +1391,15 @@ void AssetClient::forceFailureOfPendingRequests(SharedNodePointer node) {
             messageMapIt->second.clear();
         }
     }
+
+    {
+        auto messageMapIt = _pendingChunkQueries.find(node);
+        if (messageMapIt != _pendingChunkQueries.end()) {
+            auto callbacks = std::move(messageMapIt->second);
+            messageMapIt->second.clear();
+            for (const auto& value : callbacks) {
+                value.second(false, AssetUtils::AssetServerError::NoError, QSharedPointer<ReceivedMessage>());
+            }
+        }
+    }
 }
@@ -12,6 +12,7 @@
 #ifndef hifi_AssetClient_h
 #define hifi_AssetClient_h
 
+#include <QHash>
 #include <QStandardItemModel>
 #include <QtQml/QJSEngine>
 #include <QString>
@@ -21,6 +22,7 @@
 #include <DependencyManager.h>
 #include <shared/MiniPromises.h>
 
+#include "AssetChunking.h"
 #include "AssetUtils.h"
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
@@ -47,6 +49,13 @@ using ReceivedAssetCallback = std::function<void(bool responseReceived, AssetUti
 using GetInfoCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError, AssetInfo info)>;
 using UploadResultCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError, const QString& hash)>;
 using ProgressCallback = std::function<void(qint64 totalReceived, qint64 total)>;
+// An asset too small to be chunked comes back whole in assetData, with an empty manifest
+using ManifestCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError,
+                                            const AssetUtils::AssetManifest& manifest, const QByteArray& assetData)>;
+using HasChunksCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError, const std::vector<bool>& hasChunks)>;
+using ChunkQueryReplyCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError, QSharedPointer<ReceivedMessage> message)>;
+// The asset assembled from the chunks found locally, and which of its chunks are still missing
+using LocalChunksCallback = std::function<void(const QByteArray& data, const std::vector<bool>& missing)>;
 
 class AssetClient : public QObject, public Dependency {
     Q_OBJECT
@@ -78,6 +87,7 @@ private slots:
     void handleAssetGetInfoReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAssetGetReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleAssetUploadReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleAssetChunkQueryReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
     void handleNodeKilled(SharedNodePointer node);
     void handleNodeClientConnectionReset(SharedNodePointer node);
@@ -95,10 +105,24 @@ private:
                   ReceivedAssetCallback callback, ProgressCallback progressCallback);
     MessageID uploadAsset(const QByteArray& data, UploadResultCallback callback);
 
+    // Chunked transfers, see AssetChunking.h
+    MessageID getAssetManifest(const AssetUtils::AssetHash& hash, ManifestCallback callback);
+    MessageID queryChunks(const AssetUtils::AssetManifest& manifest, HasChunksCallback callback);
+    // Send the manifest and the data of the chunks flagged in `sendChunks`, the server has the others
+    MessageID uploadAssetChunked(const QByteArray& data, const AssetUtils::AssetManifest& manifest,
+                                 const std::vector<bool>& sendChunks, UploadResultCallback callback);
+
+    // Chunks of the assets in the local cache, so a new version of an asset only downloads what changed
+    bool hasLocalChunks() const { return !_localChunks.isEmpty(); }
+    void addLocalChunks(const AssetUtils::AssetHash& hash, const AssetUtils::AssetManifest& manifest);
+    // Copy the chunks found locally into the asset, off this thread, and call back on it with what is still missing
+    void fillFromLocalChunks(const AssetUtils::AssetManifest& manifest, LocalChunksCallback callback);
+
     bool cancelMappingRequest(MessageID id);
     bool cancelGetAssetInfoRequest(MessageID id);
     bool cancelGetAssetRequest(MessageID id);
     bool cancelUploadAssetRequest(MessageID id);
+    bool cancelChunkQuery(MessageID id);
 
     void handleProgressCallback(const QWeakPointer<Node>& node, MessageID messageID, qint64 size, AssetUtils::DataOffset length);
     void handleCompleteCallback(const QWeakPointer<Node>& node, MessageID messageID, AssetUtils::DataOffset length);
@@ -116,9 +140,33 @@ private:
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetAssetRequestData>> _pendingRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetInfoCallback>> _pendingInfoRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, UploadResultCallback>> _pendingUploads;
+    std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, ChunkQueryReplyCallback>> _pendingChunkQueries;
 
     QString _cacheDir;
 
+    struct LocalChunk {
+        AssetUtils::AssetHash asset;
+        AssetUtils::DataOffset offset;
+        AssetUtils::DataOffset size;
+    };
+    QHash<QByteArray, LocalChunk> _localChunks;
+
+    // The index only covers what the disk cache can hold, oldest assets first, and is rewritten once most of its
+    // records on disk are stale
+    QHash<AssetUtils::AssetHash, AssetUtils::AssetManifest> _localChunkManifests;
+    QList<AssetUtils::AssetHash> _localChunkAssets;
+    qint64 _localChunkAssetsSize { 0 };
+    int _numLocalChunkRecords { 0 };
+
+    void loadLocalChunks();
+    void indexLocalChunks(const AssetUtils::AssetHash& hash, const AssetUtils::AssetManifest& manifest);
+    void removeLocalChunks(const AssetUtils::AssetHash& hash);
+    // Drop the oldest assets past what the disk cache can hold
+    void evictLocalChunks();
+    // Rewrite the index file without its stale records once they make up most of it
+    void compactLocalChunks();
+    QString getLocalChunksPath() const;
+
     friend class AssetRequest;
     friend class AssetUpload;
     friend class MappingRequest;
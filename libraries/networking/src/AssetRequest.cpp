@@ -38,6 +38,12 @@ AssetRequest::~AssetRequest() {
     if (_assetRequestID) {
         assetClient->cancelGetAssetRequest(_assetRequestID);
     }
+    if (_manifestRequestID) {
+        assetClient->cancelChunkQuery(_manifestRequestID);
+    }
+    for (auto rangeRequestID : _rangeRequestIDs) {
+        assetClient->cancelGetAssetRequest(rangeRequestID);
+    }
 }
 
 void AssetRequest::start() {
@@ -75,6 +81,50 @@ void AssetRequest::start() {
 
     _state = WaitingForData;
 
+    // with chunks of other assets in the cache, only download the chunks of this one we don't have
+    auto assetClient = DependencyManager::get<AssetClient>();
+    if (_chunkingEnabled && !_byteRange.isSet() && assetClient->hasLocalChunks()) {
+        auto that = QPointer<AssetRequest>(this);
+        _manifestRequestID = assetClient->getAssetManifest(_hash,
+            [this, that](bool responseReceived, AssetUtils::AssetServerError serverError,
+                         const AssetUtils::AssetManifest& manifest, const QByteArray& assetData) {
+            if (!that) {
+                return;
+            }
+            _manifestRequestID = INVALID_MESSAGE_ID;
+
+            if (!responseReceived) {
+                requestWhole();
+            } else if (serverError != AssetUtils::AssetServerError::NoError || !manifest.isValid()) {
+                // an asset too small to be chunked came with the reply, so did a missing one
+                receiveWhole(true, serverError, assetData);
+            } else if (manifest.hash.toHex() == _hash) {
+                requestMissingChunks(manifest);
+            } else {
+                requestWhole();
+            }
+        });
+        return;
+    }
+
+    requestWhole();
+}
+
+void AssetRequest::setServerError(AssetUtils::AssetServerError serverError) {
+    switch (serverError) {
+        case AssetUtils::AssetServerError::AssetNotFound:
+            _error = NotFound;
+            break;
+        case AssetUtils::AssetServerError::InvalidByteRange:
+            _error = InvalidByteRange;
+            break;
+        default:
+            _error = UnknownError;
+            break;
+    }
+}
+
+void AssetRequest::requestWhole() {
     auto assetClient = DependencyManager::get<AssetClient>();
     auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
     auto hash = _hash;
@@ -89,52 +139,158 @@ void AssetRequest::start() {
         }
         _assetRequestID = INVALID_MESSAGE_ID;
 
-        if (!responseReceived) {
-            _error = NetworkError;
-        } else if (serverError != AssetUtils::AssetServerError::NoError) {
-            switch (serverError) {
-                case AssetUtils::AssetServerError::AssetNotFound:
-                    _error = NotFound;
-                    break;
-                case AssetUtils::AssetServerError::InvalidByteRange:
-                    _error = InvalidByteRange;
-                    break;
-                default:
-                    _error = UnknownError;
-                    break;
-            }
-        } else {
-            if (!_byteRange.isSet() && AssetUtils::hashData(data).toHex() != _hash) {
-                // the hash of the received data does not match what we expect, so we return an error
-                _error = HashVerificationFailed;
-            }
+        receiveWhole(responseReceived, serverError, data);
+    }, [this, that](qint64 totalReceived, qint64 total) {
+        if (!that) {
+            // If the request is dead, return
+            return;
+        }
+        emit progress(totalReceived, total);
+    });
+}
+
+void AssetRequest::receiveWhole(bool responseReceived, AssetUtils::AssetServerError serverError, const QByteArray& data) {
+    if (!responseReceived) {
+        _error = NetworkError;
+    } else if (serverError != AssetUtils::AssetServerError::NoError) {
+        setServerError(serverError);
+    } else {
+        if (!_byteRange.isSet() && AssetUtils::hashData(data).toHex() != _hash) {
+            // the hash of the received data does not match what we expect, so we return an error
+            _error = HashVerificationFailed;
+        }
+
+        if (_error == NoError) {
+            _data = data;
+            _totalReceived += data.size();
+            emit progress(_totalReceived, data.size());
 
-            if (_error == NoError) {
-                _data = data;
-                _totalReceived += data.size();
-                emit progress(_totalReceived, data.size());
+            if (!_byteRange.isSet()) {
+                bool cached = AssetUtils::saveToCache(getUrl(), data);
 
-                if (!_byteRange.isSet()) {
-                    AssetUtils::saveToCache(getUrl(), data);
+                // remember its chunks so the next version of this asset can reuse them
+                if (cached && _chunkingEnabled && data.size() >= AssetUtils::MIN_CHUNKED_ASSET_SIZE) {
+                    DependencyManager::get<AssetClient>()->addLocalChunks(_hash, AssetUtils::createManifest(data));
                 }
             }
         }
-        
-        if (_error != NoError) {
-            qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
-        }
-        
-        _state = Finished;
-        emit finished(this);
-    }, [this, that](qint64 totalReceived, qint64 total) {
+    }
+    
+    if (_error != NoError) {
+        qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
+    }
+    
+    _state = Finished;
+    emit finished(this);
+}
+
+void AssetRequest::requestMissingChunks(const AssetUtils::AssetManifest& manifest) {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto that = QPointer<AssetRequest>(this);
+
+    _manifest = manifest;
+    assetClient->fillFromLocalChunks(manifest, [this, that](const QByteArray& data, const std::vector<bool>& missing) {
         if (!that) {
-            // If the request is dead, return
             return;
         }
-        emit progress(totalReceived, total);
+        _data = data;
+        requestMissingRanges(missing);
     });
 }
 
+void AssetRequest::requestMissingRanges(const std::vector<bool>& missing) {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    const auto& manifest = _manifest;
+
+    // adjacent missing chunks are fetched as one byte range
+    std::vector<ByteRange> ranges;
+    AssetUtils::DataOffset missingBytes = 0;
+    for (size_t i = 0; i < missing.size(); ++i) {
+        if (!missing[i]) {
+            continue;
+        }
+        const auto& chunk = manifest.chunks[i];
+        if (!ranges.empty() && ranges.back().toExclusive == chunk.offset) {
+            ranges.back().toExclusive += chunk.size;
+        } else {
+            ByteRange range;
+            range.fromInclusive = chunk.offset;
+            range.toExclusive = chunk.offset + chunk.size;
+            ranges.push_back(range);
+        }
+        missingBytes += chunk.size;
+    }
+
+    if (missingBytes == manifest.size) {
+        // nothing to reuse, a single request is cheaper
+        _data.clear();
+        requestWhole();
+        return;
+    }
+
+    qCDebug(asset_client) << "Reusing" << (manifest.size - missingBytes) << "of" << manifest.size << "bytes of" << _hash
+        << "from cached chunks, requesting" << ranges.size() << "ranges";
+
+    _numPendingRequests = (int)ranges.size();
+    if (_numPendingRequests == 0) {
+        finishChunkedRequest();
+        return;
+    }
+
+    auto that = QPointer<AssetRequest>(this);
+    for (const auto& range : ranges) {
+        auto offset = range.fromInclusive;
+        auto size = range.toExclusive - range.fromInclusive;
+        auto rangeRequestID = assetClient->getAsset(_hash, range.fromInclusive, range.toExclusive,
+            [this, that, offset, size](bool responseReceived, AssetUtils::AssetServerError serverError, const QByteArray& data) {
+            if (!that) {
+                return;
+            }
+
+            if (!responseReceived) {
+                _error = NetworkError;
+            } else if (serverError != AssetUtils::AssetServerError::NoError) {
+                setServerError(serverError);
+            } else if (data.size() != size) {
+                _error = SizeVerificationFailed;
+            } else if (_error == NoError) {
+                memcpy(_data.data() + offset, data.constData(), size);
+                _totalReceived += size;
+            }
+
+            if (--_numPendingRequests == 0) {
+                finishChunkedRequest();
+            }
+        }, [this, that, missingBytes](qint64 totalReceived, qint64 total) {
+            if (!that) {
+                return;
+            }
+            emit progress(_totalReceived + totalReceived, missingBytes);
+        });
+        _rangeRequestIDs.push_back(rangeRequestID);
+    }
+}
+
+void AssetRequest::finishChunkedRequest() {
+    _rangeRequestIDs.clear();
+
+    if (_error == NoError && AssetUtils::hashData(_data) != _manifest.hash) {
+        _error = HashVerificationFailed;
+    }
+
+    if (_error == NoError) {
+        if (AssetUtils::saveToCache(getUrl(), _data)) {
+            DependencyManager::get<AssetClient>()->addLocalChunks(_hash, _manifest);
+        }
+    } else {
+        qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
+        _data.clear();
+    }
+
+    _state = Finished;
+    emit finished(this);
+}
+
 
 const QString AssetRequest::getErrorString() const {
     QString result;
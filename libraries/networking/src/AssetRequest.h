@@ -57,11 +57,22 @@ public:
 
     bool loadedFromCache() const { return _loadedFromCache; }
 
+    // Bytes of asset data received from the asset server
+    uint64_t getBytesReceived() const { return _totalReceived; }
+    void setChunkingEnabled(bool enabled) { _chunkingEnabled = enabled; }
+
 signals:
     void finished(AssetRequest* thisRequest);
     void progress(qint64 totalReceived, qint64 total);
 
 private:
+    void requestWhole();
+    void receiveWhole(bool responseReceived, AssetUtils::AssetServerError serverError, const QByteArray& data);
+    void requestMissingChunks(const AssetUtils::AssetManifest& manifest);
+    void requestMissingRanges(const std::vector<bool>& missing);
+    void finishChunkedRequest();
+    void setServerError(AssetUtils::AssetServerError serverError);
+
     int _requestID;
     State _state = NotStarted;
     Error _error = NoError;
@@ -72,6 +83,11 @@ private:
     MessageID _assetRequestID { INVALID_MESSAGE_ID };
     const ByteRange _byteRange;
     bool _loadedFromCache { false };
+
+    bool _chunkingEnabled { true };
+    MessageID _manifestRequestID { INVALID_MESSAGE_ID };
+    std::vector<MessageID> _rangeRequestIDs;
+    AssetUtils::AssetManifest _manifest;
 };
 
 #endif
@@ -74,40 +74,99 @@ void AssetUpload::start() {
         }
     }
     
-    // ask the AssetClient to upload the asset and emit the proper signals from the passed callback
-    auto assetClient = DependencyManager::get<AssetClient>();
-   
     if (!_filename.isEmpty()) {
         qCDebug(asset_client) << "Attempting to upload" << _filename << "to asset-server.";
     }
-    
-    assetClient->uploadAsset(_data, [this](bool responseReceived, AssetUtils::AssetServerError error, const QString& hash){
-        if (!responseReceived) {
-            _error = NetworkError;
-        } else {
-            switch (error) {
-                case AssetUtils::AssetServerError::NoError:
-                    _error = NoError;
-                    break;
-                case AssetUtils::AssetServerError::AssetTooLarge:
-                    _error = TooLarge;
-                    break;
-                case AssetUtils::AssetServerError::PermissionDenied:
-                    _error = PermissionDenied;
-                    break;
-                case AssetUtils::AssetServerError::FileOperationFailed:
-                    _error = ServerFileError;
-                    break;
-                default:
-                    _error = FileOpenError;
-                    break;
-            }
+
+    if (_chunkingEnabled && _data.size() >= AssetUtils::MIN_CHUNKED_ASSET_SIZE) {
+        uploadChunked();
+    } else {
+        uploadWhole();
+    }
+}
+
+void AssetUpload::uploadWhole() {
+    // ask the AssetClient to upload the asset and emit the proper signals from the passed callback
+    auto assetClient = DependencyManager::get<AssetClient>();
+
+    _bytesSent = _data.size();
+    _numChunks = 0;
+    _numChunksSent = 0;
+
+    assetClient->uploadAsset(_data, [this](bool responseReceived, AssetUtils::AssetServerError error, const QString& hash) {
+        handleUploadResult(responseReceived, error, hash);
+    });
+}
+
+void AssetUpload::uploadChunked() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+
+    _manifest = AssetUtils::createManifest(_data);
+
+    // ask which chunks the server already stores, then send only the others
+    assetClient->queryChunks(_manifest, [this](bool responseReceived, AssetUtils::AssetServerError error,
+                                               const std::vector<bool>& hasChunks) {
+        if (!responseReceived || error != AssetUtils::AssetServerError::NoError || hasChunks.size() != _manifest.chunks.size()) {
+            uploadWhole();
+            return;
         }
-        
-        if (_error == NoError && hash == AssetUtils::hashData(_data).toHex()) {
-            AssetUtils::saveToCache(AssetUtils::getATPUrl(hash), _data);
+
+        std::vector<bool> sendChunks(hasChunks.size());
+        _bytesSent = 0;
+        _numChunks = _manifest.chunks.size();
+        _numChunksSent = 0;
+        for (size_t i = 0; i < hasChunks.size(); ++i) {
+            sendChunks[i] = !hasChunks[i];
+            if (sendChunks[i]) {
+                _bytesSent += _manifest.chunks[i].size;
+                ++_numChunksSent;
+            }
         }
-        
-        emit finished(this, hash);
+
+        qCDebug(asset_client) << "Uploading" << _numChunksSent << "of" << _numChunks << "chunks," << _bytesSent << "of"
+            << _data.size() << "bytes";
+
+        auto assetClient = DependencyManager::get<AssetClient>();
+        assetClient->uploadAssetChunked(_data, _manifest, sendChunks,
+                                        [this](bool responseReceived, AssetUtils::AssetServerError error, const QString& hash) {
+            if (responseReceived && error == AssetUtils::AssetServerError::MissingChunks) {
+                // a chunk we skipped was removed on the server in the meantime
+                uploadWhole();
+                return;
+            }
+            handleUploadResult(responseReceived, error, hash);
+        });
     });
 }
+
+void AssetUpload::handleUploadResult(bool responseReceived, AssetUtils::AssetServerError error, const QString& hash) {
+    if (!responseReceived) {
+        _error = NetworkError;
+    } else {
+        switch (error) {
+            case AssetUtils::AssetServerError::NoError:
+                _error = NoError;
+                break;
+            case AssetUtils::AssetServerError::AssetTooLarge:
+                _error = TooLarge;
+                break;
+            case AssetUtils::AssetServerError::PermissionDenied:
+                _error = PermissionDenied;
+                break;
+            case AssetUtils::AssetServerError::FileOperationFailed:
+                _error = ServerFileError;
+                break;
+            default:
+                _error = FileOpenError;
+                break;
+        }
+    }
+
+    if (_error == NoError && hash == AssetUtils::hashData(_data).toHex()) {
+        if (AssetUtils::saveToCache(AssetUtils::getATPUrl(hash), _data) && !_manifest.chunks.empty()) {
+            DependencyManager::get<AssetClient>()->addLocalChunks(hash, _manifest);
+        }
+    }
+
+    emit finished(this, hash);
+}
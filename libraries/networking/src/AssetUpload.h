@@ -18,6 +18,9 @@
 
 #include <cstdint>
 
+#include "AssetChunking.h"
+#include "AssetUtils.h"
+
 // You should be able to upload an asset from any thread, and handle the responses in a safe way
 // on your own thread. Everything should happen on AssetClient's thread, the caller should
 // receive events by connecting to signals on an object that lives on AssetClient's threads.
@@ -46,15 +49,31 @@ public:
     const QString& getFilename() const { return _filename; }
     const Error& getError() const { return _error; }
     QString getErrorString() const;
+
+    // Assets larger than AssetUtils::MIN_CHUNKED_ASSET_SIZE only send the chunks the server doesn't have
+    void setChunkingEnabled(bool enabled) { _chunkingEnabled = enabled; }
+    uint64_t getBytesSent() const { return _bytesSent; }
+    size_t getNumChunks() const { return _numChunks; }
+    size_t getNumChunksSent() const { return _numChunksSent; }
     
 signals:
     void finished(AssetUpload* upload, const QString& hash);
     void progress(uint64_t totalReceived, uint64_t total);
     
 private:
+    void uploadWhole();
+    void uploadChunked();
+    void handleUploadResult(bool responseReceived, AssetUtils::AssetServerError error, const QString& hash);
+
     QString _filename;
     QByteArray _data;
     Error _error;
+
+    bool _chunkingEnabled { true };
+    AssetUtils::AssetManifest _manifest;
+    uint64_t _bytesSent { 0 };
+    size_t _numChunks { 0 };
+    size_t _numChunksSent { 0 };
 };
 
 #endif // hifi_AssetUpload_h
@@ -46,7 +46,8 @@ enum AssetServerError : uint8_t {
     MappingOperationFailed,
     FileOperationFailed,
     NoAssetServer,
-    LostConnection
+    LostConnection,
+    MissingChunks
 };
 
 enum AssetMappingOperationType : uint8_t {
@@ -58,6 +59,17 @@ enum AssetMappingOperationType : uint8_t {
     SetBakingEnabled
 };
 
+enum AssetChunkQueryType : uint8_t {
+    GetManifest = 0,
+    HasChunks
+};
+
+// What follows the error code of a successful GetManifest reply
+enum AssetManifestReplyType : uint8_t {
+    ChunkManifest = 0,
+    WholeAsset // an asset too small to be chunked comes with the reply, a GET for it would be another round trip
+};
+
 enum BakingStatus {
     Irrelevant,
     NotBaked,
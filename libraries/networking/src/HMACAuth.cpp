@@ -15,13 +15,16 @@
 #include <openssl/hmac.h>
 
 #include <QUuid>
+#include <QtCore/QtEndian>
 #include "NetworkLogging.h"
 #include <cassert>
+#include <cstring>
 
 #if OPENSSL_VERSION_NUMBER >= 0x10100000
 HMACAuth::HMACAuth(AuthMethod authMethod)
     : _hmacContext(HMAC_CTX_new())
-    , _authMethod(authMethod) { }
+    , _authMethod(authMethod)
+    , _nextAuthMethod(authMethod) { }
 
 HMACAuth::~HMACAuth()
 {
@@ -32,7 +35,8 @@ HMACAuth::~HMACAuth()
 
 HMACAuth::HMACAuth(AuthMethod authMethod)
     : _hmacContext(new HMAC_CTX())
-    , _authMethod(authMethod) {
+    , _authMethod(authMethod)
+    , _nextAuthMethod(authMethod) {
     HMAC_CTX_init(_hmacContext);
 }
 
@@ -42,10 +46,17 @@ HMACAuth::~HMACAuth() {
 }
 #endif
 
+void HMACAuth::setAuthMethod(AuthMethod authMethod) {
+    QMutexLocker lock(&_lock);
+    _nextAuthMethod = authMethod;
+}
+
 bool HMACAuth::setKey(const char* keyValue, int keyLen) {
     const EVP_MD* sslStruct = nullptr;
 
-    switch (_authMethod) {
+    // hashes keep using the current method and key until the new ones are both in place
+    QMutexLocker lock(&_lock);
+    switch (_nextAuthMethod) {
     case MD5:
         sslStruct = EVP_md5();
         break;
@@ -66,11 +77,25 @@ bool HMACAuth::setKey(const char* keyValue, int keyLen) {
         sslStruct = EVP_ripemd160();
         break;
 
+    case SIPHASH: {
+        // the key is 128 bits, fold longer ones into that
+        unsigned char key[2 * sizeof(quint64)] = {};
+        for (int i = 0; i < keyLen; ++i) {
+            key[i % sizeof(key)] ^= (unsigned char)keyValue[i];
+        }
+
+        _authMethod = SIPHASH;
+        _sipHashKey[0] = qFromLittleEndian<quint64>(key);
+        _sipHashKey[1] = qFromLittleEndian<quint64>(key + sizeof(quint64));
+        _sipHashData.clear();
+        return true;
+    }
+
     default:
         return false;
     }
 
-    QMutexLocker lock(&_lock);
+    _authMethod = _nextAuthMethod;
     return (bool) HMAC_Init_ex(_hmacContext, keyValue, keyLen, sslStruct, nullptr);
 }
 
@@ -81,13 +106,24 @@ bool HMACAuth::setKey(const QUuid& uidKey) {
 
 bool HMACAuth::addData(const char* data, int dataLen) {
     QMutexLocker lock(&_lock);
+    if (_authMethod == SIPHASH) {
+        _sipHashData.insert(_sipHashData.end(), data, data + dataLen);
+        return true;
+    }
     return (bool) HMAC_Update(_hmacContext, reinterpret_cast<const unsigned char*>(data), dataLen);
 }
 
 HMACAuth::HMACHash HMACAuth::result() {
+    QMutexLocker lock(&_lock);
+    if (_authMethod == SIPHASH) {
+        HMACHash hashValue(SIPHASH_RESULT_SIZE);
+        calculateSipHash(&hashValue[0], _sipHashData.data(), (int)_sipHashData.size());
+        _sipHashData.clear();
+        return hashValue;
+    }
+
     HMACHash hashValue(EVP_MAX_MD_SIZE);
     unsigned int hashLen;
-    QMutexLocker lock(&_lock);
     
     auto hmacResult = HMAC_Final(_hmacContext, &hashValue[0], &hashLen);
     
@@ -106,6 +142,12 @@ HMACAuth::HMACHash HMACAuth::result() {
 
 bool HMACAuth::calculateHash(HMACHash& hashResult, const char* data, int dataLen) {
     QMutexLocker lock(&_lock);
+    if (_authMethod == SIPHASH) {
+        hashResult.resize(SIPHASH_RESULT_SIZE);
+        calculateSipHash(&hashResult[0], data, dataLen);
+        return true;
+    }
+
     if (!addData(data, dataLen)) {
         qCWarning(networking) << "Error occured calling HMACAuth::addData()";
         assert(false);
@@ -115,3 +157,87 @@ bool HMACAuth::calculateHash(HMACHash& hashResult, const char* data, int dataLen
     hashResult = result();
     return true;
 }
+
+bool HMACAuth::verifyHash(const char* data, int dataLen, const char* hash, int hashLen) {
+    unsigned char hashResult[EVP_MAX_MD_SIZE];
+    unsigned int hashResultLen;
+    QMutexLocker lock(&_lock);
+
+    if (_authMethod == SIPHASH) {
+        calculateSipHash(hashResult, data, dataLen);
+        hashResultLen = SIPHASH_RESULT_SIZE;
+    } else {
+        bool hmacResult = HMAC_Update(_hmacContext, reinterpret_cast<const unsigned char*>(data), dataLen)
+            && HMAC_Final(_hmacContext, hashResult, &hashResultLen);
+
+        // Clear state for possible reuse.
+        HMAC_Init_ex(_hmacContext, nullptr, 0, nullptr, nullptr);
+
+        if (!hmacResult) {
+            qCWarning(networking) << "Error occured calling HMAC_Final";
+            return false;
+        }
+    }
+
+    if ((int)hashResultLen != hashLen) {
+        return false;
+    }
+
+    // look at every byte, so how long this takes doesn't tell how much of a forged hash was right
+    unsigned char difference = 0;
+    for (int i = 0; i < hashLen; ++i) {
+        difference |= hashResult[i] ^ (unsigned char)hash[i];
+    }
+    return difference == 0;
+}
+
+static inline quint64 rotateLeft(quint64 value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline void sipRound(quint64& v0, quint64& v1, quint64& v2, quint64& v3) {
+    v0 += v1; v1 = rotateLeft(v1, 13); v1 ^= v0; v0 = rotateLeft(v0, 32);
+    v2 += v3; v3 = rotateLeft(v3, 16); v3 ^= v2;
+    v0 += v3; v3 = rotateLeft(v3, 21); v3 ^= v0;
+    v2 += v1; v1 = rotateLeft(v1, 17); v1 ^= v2; v2 = rotateLeft(v2, 32);
+}
+
+void HMACAuth::calculateSipHash(unsigned char* hashResult, const char* data, int dataLen) const {
+    // SipHash-2-4-128, see https://131002.net/siphash/
+    quint64 v0 = 0x736f6d6570736575ULL ^ _sipHashKey[0];
+    quint64 v1 = 0x646f72616e646f6dULL ^ _sipHashKey[1] ^ 0xee;
+    quint64 v2 = 0x6c7967656e657261ULL ^ _sipHashKey[0];
+    quint64 v3 = 0x7465646279746573ULL ^ _sipHashKey[1];
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* lastWord = bytes + (dataLen - dataLen % sizeof(quint64));
+
+    for (; bytes != lastWord; bytes += sizeof(quint64)) {
+        quint64 word = qFromLittleEndian<quint64>(bytes);
+        v3 ^= word;
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        v0 ^= word;
+    }
+
+    // the last word holds the bytes that are left and the length
+    unsigned char remainder[sizeof(quint64)] = {};
+    memcpy(remainder, lastWord, dataLen % sizeof(quint64));
+    quint64 word = ((quint64)dataLen << 56) | qFromLittleEndian<quint64>(remainder);
+    v3 ^= word;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    v0 ^= word;
+
+    v2 ^= 0xee;
+    for (int i = 0; i < 4; ++i) {
+        sipRound(v0, v1, v2, v3);
+    }
+    qToLittleEndian<quint64>(v0 ^ v1 ^ v2 ^ v3, hashResult);
+
+    v1 ^= 0xdd;
+    for (int i = 0; i < 4; ++i) {
+        sipRound(v0, v1, v2, v3);
+    }
+    qToLittleEndian<quint64>(v0 ^ v1 ^ v2 ^ v3, hashResult + sizeof(quint64));
+}
@@ -15,22 +15,32 @@
 #include <vector>
 #include <memory>
 #include <QtCore/QMutex>
+#include <QtCore/QtGlobal>
 
 class QUuid;
 
 class HMACAuth {
 public:
-    enum AuthMethod { MD5, SHA1, SHA224, SHA256, RIPEMD160 };
+    // SIPHASH is SipHash-2-4 with a 128 bit result, a keyed hash made for short messages that needs
+    // a fraction of the work of an HMAC - it is what the domain-server hands out with connection secrets
+    enum AuthMethod { MD5, SHA1, SHA224, SHA256, RIPEMD160, SIPHASH };
     using HMACHash = std::vector<unsigned char>;
     
     explicit HMACAuth(AuthMethod authMethod = MD5);
     ~HMACAuth();
 
+    AuthMethod getAuthMethod() const { return _authMethod; }
+    // Takes effect with the next setKey(), until then hashes are still calculated with the current method and key
+    void setAuthMethod(AuthMethod authMethod);
+
     bool setKey(const char* keyValue, int keyLen);
     bool setKey(const QUuid& uidKey);
     // Calculate complete hash in one.
     bool calculateHash(HMACHash& hashResult, const char* data, int dataLen);
 
+    // Check the hash of the data against the one given, without any allocations.
+    bool verifyHash(const char* data, int dataLen, const char* hash, int hashLen);
+
     // Append to data to be hashed.
     bool addData(const char* data, int dataLen);
     // Get the resulting hash from calls to addData().
@@ -39,9 +49,16 @@ public:
     HMACHash result();
 
 private:
+    static const int SIPHASH_RESULT_SIZE = 16;
+    void calculateSipHash(unsigned char* hashResult, const char* data, int dataLen) const;
+
     QMutex _lock { QMutex::Recursive };
     struct hmac_ctx_st* _hmacContext;
     AuthMethod _authMethod;
+    AuthMethod _nextAuthMethod;
+
+    quint64 _sipHashKey[2] { 0, 0 };
+    std::vector<char> _sipHashData; // for addData(), SipHash is computed in one go by result()
 };
 
 #endif  // hifi_HMACAuth_h
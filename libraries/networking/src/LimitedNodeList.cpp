@@ -110,7 +110,9 @@ LimitedNodeList::LimitedNodeList(int socketListenPort, int dtlsListenPort) :
 
     // set our isPacketVerified method as the verify operator for the udt::Socket
     using std::placeholders::_1;
+    using std::placeholders::_2;
     _nodeSocket.setPacketFilterOperator(std::bind(&LimitedNodeList::isPacketVerified, this, _1));
+    _nodeSocket.setPacketBatchFilterOperator(std::bind(&LimitedNodeList::verifyPackets, this, _1, _2));
 
     // set our socketBelongsToNode method as the connection creation filter operator for the udt::Socket
     _nodeSocket.setConnectionCreationFilterOperator(std::bind(&LimitedNodeList::sockAddrBelongsToNode, this, _1));
@@ -237,6 +239,39 @@ bool LimitedNodeList::isPacketVerifiedWithSource(const udt::Packet& packet, Node
     return packetVersionMatch(packet) && packetSourceAndHashMatchAndTrackBandwidth(packet, sourceNode);
 }
 
+void LimitedNodeList::setPacketFilterOperator(udt::PacketFilterOperator filterOperator) {
+    // our batched verification would skip the new operator
+    _nodeSocket.setPacketBatchFilterOperator(nullptr);
+    _nodeSocket.setPacketFilterOperator(filterOperator);
+}
+
+void LimitedNodeList::verifyPackets(const udt::PacketBatch& packets, std::vector<bool>& isVerified) {
+    // the packets of a batch mostly come from a handful of nodes, look each of those up (and take the node lock) once
+    _batchSourceNodes.clear();
+
+    for (size_t i = 0; i < packets.size(); ++i) {
+        const auto& packet = *packets[i];
+
+        Node* sourceNode = nullptr;
+        if (!PacketTypeEnum::getNonSourcedPackets().contains(NLPacket::typeInHeader(packet))) {
+            auto sourceLocalID = NLPacket::sourceIDInHeader(packet);
+
+            auto it = std::find_if(_batchSourceNodes.begin(), _batchSourceNodes.end(), [&](const auto& source) {
+                return source.first == sourceLocalID;
+            });
+            if (it == _batchSourceNodes.end()) {
+                it = _batchSourceNodes.emplace(_batchSourceNodes.end(), sourceLocalID, nodeWithLocalID(sourceLocalID));
+            }
+            sourceNode = it->second.data();
+        }
+
+        isVerified[i] = isPacketVerifiedWithSource(packet, sourceNode);
+    }
+
+    // don't hold on to the nodes past the batch
+    _batchSourceNodes.clear();
+}
+
 bool LimitedNodeList::packetVersionMatch(const udt::Packet& packet) {
     PacketType headerType = NLPacket::typeInHeader(packet);
     PacketVersion headerVersion = NLPacket::versionInHeader(packet);
@@ -347,18 +382,19 @@ bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packe
 
             if (verifiedPacket && verificationEnabled) {
 
-                QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
-                QByteArray expectedHash;
                 auto sourceNodeHMACAuth = sourceNode->getAuthenticateHash();
-                if (sourceNode->getAuthenticateHash()) {
-                    expectedHash = NLPacket::hashForPacketAndHMAC(packet, *sourceNodeHMACAuth);
-                }
 
-                // check if the HMAC-md5 hash in the header matches the hash we would expect
-                if (!sourceNodeHMACAuth || packetHeaderHash != expectedHash) {
+                // check if the hash in the header matches the hash we would expect
+                if (!sourceNodeHMACAuth || !NLPacket::hashInHeaderMatches(packet, *sourceNodeHMACAuth)) {
                     static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
 
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
+                        QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
+                        QByteArray expectedHash;
+                        if (sourceNodeHMACAuth) {
+                            expectedHash = NLPacket::hashForPacketAndHMAC(packet, *sourceNodeHMACAuth);
+                        }
+
                         qCDebug(networking) << "Packet hash mismatch on" << headerType << "- Sender" << sourceID;
                         qCDebug(networking) << "Packet len:" << packet.getDataSize() << "Expected hash:" <<
                             expectedHash.toHex() << "Actual:" << packetHeaderHash.toHex();
@@ -673,13 +709,14 @@ void LimitedNodeList::handleNodeKill(const SharedNodePointer& node, ConnectionID
 SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t nodeType,
                                                    const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                                    Node::LocalID localID, bool isReplicated, bool isUpstream,
-                                                   const QUuid& connectionSecret, const NodePermissions& permissions) {
+                                                   const QUuid& connectionSecret, const NodePermissions& permissions,
+                                                   HMACAuth::AuthMethod authMethod) {
     auto matchingNode = nodeWithUUID(uuid);
     if (matchingNode) {
         matchingNode->setPublicSocket(publicSocket);
         matchingNode->setLocalSocket(localSocket);
         matchingNode->setPermissions(permissions);
-        matchingNode->setConnectionSecret(connectionSecret);
+        matchingNode->setConnectionSecret(connectionSecret, authMethod);
         matchingNode->setIsReplicated(isReplicated);
         matchingNode->setIsUpstream(isUpstream || NodeType::isUpstream(nodeType));
         matchingNode->setLocalID(localID);
@@ -718,7 +755,7 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
     Node* newNode = new Node(uuid, nodeType, publicSocket, localSocket);
     newNode->setIsReplicated(isReplicated);
     newNode->setIsUpstream(isUpstream || NodeType::isUpstream(nodeType));
-    newNode->setConnectionSecret(connectionSecret);
+    newNode->setConnectionSecret(connectionSecret, authMethod);
     newNode->setPermissions(permissions);
     newNode->setLocalID(localID);
 
@@ -774,7 +811,7 @@ void LimitedNodeList::addNewNode(NewNodeInfo info) {
 
     SharedNodePointer node = addOrUpdateNode(info.uuid, info.type, info.publicSocket, info.localSocket,
                                              info.sessionLocalID, info.isReplicated, false,
-                                             info.connectionSecretUUID, info.permissions);
+                                             info.connectionSecretUUID, info.permissions, info.authMethod);
 
     ++_nodesAddedInCurrentTimeSlice;
 }
@@ -116,6 +116,12 @@ public:
     };
     Q_ENUM(ConnectReason);
 
+    // what each entry after the header of a DomainList packet is - a node to add or update, or one that has gone
+    enum DomainListEntry : quint8 {
+        DomainListNode = 0,
+        DomainListRemovedNode
+    };
+
     QUuid getSessionUUID() const;
     void setSessionUUID(const QUuid& sessionUUID);
     Node::LocalID getSessionLocalID() const;
@@ -175,7 +181,8 @@ public:
                                       const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                       Node::LocalID localID = Node::NULL_LOCAL_ID, bool isReplicated = false,
                                       bool isUpstream = false, const QUuid& connectionSecret = QUuid(),
-                                      const NodePermissions& permissions = DEFAULT_AGENT_PERMISSIONS);
+                                      const NodePermissions& permissions = DEFAULT_AGENT_PERMISSIONS,
+                                      HMACAuth::AuthMethod authMethod = HMACAuth::MD5);
 
     static bool parseSTUNResponse(udt::BasePacket* packet, QHostAddress& newPublicAddress, uint16_t& newPublicPort);
     bool hasCompletedInitialSTUN() const { return _hasCompletedInitialSTUN; }
@@ -311,11 +318,12 @@ public:
 
     void setConnectionMaxBandwidth(int maxBandwidth) { _nodeSocket.setConnectionMaxBandwidth(maxBandwidth); }
 
-    void setPacketFilterOperator(udt::PacketFilterOperator filterOperator) { _nodeSocket.setPacketFilterOperator(filterOperator); }
+    void setPacketFilterOperator(udt::PacketFilterOperator filterOperator);
     bool packetVersionMatch(const udt::Packet& packet);
 
     bool isPacketVerifiedWithSource(const udt::Packet& packet, Node* sourceNode = nullptr);
     bool isPacketVerified(const udt::Packet& packet) { return isPacketVerifiedWithSource(packet); }
+    void verifyPackets(const udt::PacketBatch& packets, std::vector<bool>& isVerified);
     void setAuthenticatePackets(bool useAuthentication) { _useAuthentication = useAuthentication; }
     bool getAuthenticatePackets() const { return _useAuthentication; }
 
@@ -343,7 +351,6 @@ public:
         NodeType::AudioMixer,
         NodeType::AssetServer,
         NodeType::EntityServer,
-        NodeType::MessagesMixer,
         NodeType::EntityScriptServer
     };
 
@@ -407,6 +414,7 @@ protected:
         bool isReplicated;
         Node::LocalID sessionLocalID;
         QUuid connectionSecretUUID;
+        HMACAuth::AuthMethod authMethod;
     };
 
     LimitedNodeList(int socketListenPort = INVALID_PORT, int dtlsListenPort = INVALID_PORT);
@@ -422,7 +430,7 @@ protected:
     bool packetSourceAndHashMatchAndTrackBandwidth(const udt::Packet& packet, Node* sourceNode = nullptr);
     void processSTUNResponse(std::unique_ptr<udt::BasePacket> packet);
 
-    void handleNodeKill(const SharedNodePointer& node, ConnectionID newConnectionID = NULL_CONNECTION_ID);
+    virtual void handleNodeKill(const SharedNodePointer& node, ConnectionID newConnectionID = NULL_CONNECTION_ID);
 
     void stopInitialSTUNUpdate(bool success);
 
@@ -493,6 +501,8 @@ private:
     size_t _nodesAddedInCurrentTimeSlice { 0 };
     std::vector<NewNodeInfo> _delayedNodeAdds;
 
+    std::vector<std::pair<Node::LocalID, SharedNodePointer>> _batchSourceNodes; // see verifyPackets()
+
     int _inboundPPS { 0 };
     int _outboundPPS { 0 };
     float _inboundKbps { 0.0f };
@@ -11,6 +11,7 @@
 
 #include "MessagesClient.h"
 
+#include <algorithm>
 #include <cstdint>
 
 #include <QtCore/QBuffer>
@@ -29,7 +30,10 @@ MessagesClient::MessagesClient() {
     auto nodeList = DependencyManager::get<NodeList>();
     auto& packetReceiver = nodeList->getPacketReceiver();
     packetReceiver.registerListener(PacketType::MessagesData, this, "handleMessagesPacket");
+    connect(nodeList.data(), &LimitedNodeList::nodeAdded, this, &MessagesClient::handleNodeAdded);
     connect(nodeList.data(), &LimitedNodeList::nodeActivated, this, &MessagesClient::handleNodeActivated);
+    connect(nodeList.data(), &LimitedNodeList::nodeKilled, this, &MessagesClient::handleNodeKilled);
+    updateMessagesMixers();
 }
 
 void MessagesClient::decodeMessagesPacket(QSharedPointer<ReceivedMessage> receivedMessage, QString& channel, 
@@ -59,58 +63,118 @@ void MessagesClient::decodeMessagesPacket(QSharedPointer<ReceivedMessage> receiv
     }
 }
 
-std::unique_ptr<NLPacketList> MessagesClient::encodeMessagesPacket(QString channel, QString message, QUuid senderID) {
-    auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
-
+QByteArray MessagesClient::encodeMessagesPayload(QString channel, bool isText, QByteArray message, QUuid senderID) {
     auto channelUtf8 = channel.toUtf8();
     quint16 channelLength = channelUtf8.length();
-    packetList->writePrimitive(channelLength);
-    packetList->write(channelUtf8);
-
-    bool isTextMessage = true;
-    packetList->writePrimitive(isTextMessage);
-
-    auto messageUtf8 = message.toUtf8();
-    quint32 messageLength = messageUtf8.length();
-    packetList->writePrimitive(messageLength);
-    packetList->write(messageUtf8);
-
-    packetList->write(senderID.toRfc4122());
+    quint32 messageLength = message.length();
+
+    QByteArray payload;
+    payload.reserve(sizeof(channelLength) + channelLength + sizeof(isText) + sizeof(messageLength) + messageLength
+                    + NUM_BYTES_RFC4122_UUID);
+    payload.append(reinterpret_cast<const char*>(&channelLength), sizeof(channelLength));
+    payload.append(channelUtf8);
+    payload.append(reinterpret_cast<const char*>(&isText), sizeof(isText));
+    payload.append(reinterpret_cast<const char*>(&messageLength), sizeof(messageLength));
+    payload.append(message);
+    payload.append(senderID.toRfc4122());
+
+    return payload;
+}
 
+std::unique_ptr<NLPacketList> MessagesClient::encodeMessagesPacket(QString channel, QString message, QUuid senderID) {
+    auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+    packetList->write(encodeMessagesPayload(channel, true, message.toUtf8(), senderID));
     return packetList;
 }
 
 std::unique_ptr<NLPacketList> MessagesClient::encodeMessagesDataPacket(QString channel, QByteArray data, QUuid senderID) {
     auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+    packetList->write(encodeMessagesPayload(channel, false, data, senderID));
+    return packetList;
+}
 
-    auto channelUtf8 = channel.toUtf8();
-    quint16 channelLength = channelUtf8.length();
-    packetList->writePrimitive(channelLength);
-    packetList->write(channelUtf8);
 
-    bool isTextMessage = false;
-    packetList->writePrimitive(isTextMessage);
+// FNV-1a, qHash is seeded differently in each process and everybody has to agree on the owners
+static quint64 hashBytes(const QByteArray& bytes, quint64 hash = 14695981039346656037ULL) {
+    for (char byte : bytes) {
+        hash ^= (quint8)byte;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
 
-    quint32 dataLength = data.length();
-    packetList->writePrimitive(dataLength);
-    packetList->write(data);
+// the splitmix64 finalizer, so that the weights of channels that hash close together aren't related
+static quint64 mixHash(quint64 hash) {
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
 
-    packetList->write(senderID.toRfc4122());
+QUuid MessagesClient::channelOwner(const QString& channel, const std::vector<QUuid>& messagesMixerIDs) {
+    // rendezvous hashing: the mixer with the highest weight for the channel owns it, so when a mixer comes or goes
+    // only the channels it owns move, and the order everybody learned about the mixers in doesn't matter
+    quint64 channelHash = hashBytes(channel.toUtf8());
+
+    QUuid owner;
+    quint64 ownerWeight = 0;
+    for (const auto& messagesMixerID : messagesMixerIDs) {
+        quint64 weight = mixHash(hashBytes(messagesMixerID.toRfc4122(), channelHash));
+        if (owner.isNull() || weight > ownerWeight || (weight == ownerWeight && messagesMixerID < owner)) {
+            owner = messagesMixerID;
+            ownerWeight = weight;
+        }
+    }
+    return owner;
+}
 
-    return packetList;
+void MessagesClient::updateMessagesMixers() {
+    SharedNodePointer anyMessagesMixer;
+    std::vector<SharedNodePointer> activeMessagesMixers;
+    std::vector<QUuid> activeMessagesMixerIDs;
+    DependencyManager::get<NodeList>()->eachMatchingNode([](const SharedNodePointer& node)->bool {
+        return node->getType() == NodeType::MessagesMixer;
+    }, [&](const SharedNodePointer& node) {
+        anyMessagesMixer = node;
+        if (node->getActiveSocket()) {
+            activeMessagesMixers.push_back(node);
+            activeMessagesMixerIDs.push_back(node->getUUID());
+        }
+    });
+
+    QMutexLocker lock(&_messagesMixersLock);
+    _anyMessagesMixer = anyMessagesMixer;
+    _activeMessagesMixers.swap(activeMessagesMixers);
+    _activeMessagesMixerIDs.swap(activeMessagesMixerIDs);
 }
 
+SharedNodePointer MessagesClient::messagesMixerForChannel(const QString& channel) {
+    QMutexLocker lock(&_messagesMixersLock);
+
+    // only the ones we can reach have a say in who owns the channel
+    if (_activeMessagesMixers.size() <= 1) {
+        return _activeMessagesMixers.empty() ? _anyMessagesMixer : _activeMessagesMixers[0];
+    }
+
+    auto owner = channelOwner(channel, _activeMessagesMixerIDs);
+    return *std::find_if(_activeMessagesMixers.begin(), _activeMessagesMixers.end(), [&](const SharedNodePointer& node) {
+        return node->getUUID() == owner;
+    });
+}
 
 void MessagesClient::handleMessagesPacket(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
     QString channel, message;
     QByteArray data;
     bool isText { false };
     QUuid senderID;
-    decodeMessagesPacket(receivedMessage, channel, isText, message, data, senderID);
-    if (isText) {
-        emit messageReceived(channel, message, senderID, false);
-    } else {
-        emit dataReceived(channel, data, senderID, false);
+
+    // the messages mixer may have put more than one message in this packet list
+    while (receivedMessage->getBytesLeftToRead() > 0) {
+        decodeMessagesPacket(receivedMessage, channel, isText, message, data, senderID);
+        if (isText) {
+            emit messageReceived(channel, message, senderID, false);
+        } else {
+            emit dataReceived(channel, data, senderID, false);
+        }
     }
 }
 
@@ -120,7 +184,7 @@ void MessagesClient::sendMessage(QString channel, QString message, bool localOnl
     if (localOnly) {
         emit messageReceived(channel, message, senderID, true);
     } else {
-        SharedNodePointer messagesMixer = nodeList->soloNodeOfType(NodeType::MessagesMixer);
+        SharedNodePointer messagesMixer = messagesMixerForChannel(channel);
         if (messagesMixer) {
             auto packetList = encodeMessagesPacket(channel, message, senderID);
             nodeList->sendPacketList(std::move(packetList), *messagesMixer);
@@ -136,7 +200,7 @@ void MessagesClient::sendData(QString channel, QByteArray data, bool localOnly)
     if (localOnly) {
         emit dataReceived(channel, data, senderID, true);
     } else {
-        SharedNodePointer messagesMixer = nodeList->soloNodeOfType(NodeType::MessagesMixer);
+        SharedNodePointer messagesMixer = messagesMixerForChannel(channel);
         if (messagesMixer) {
             QUuid senderID = nodeList->getSessionUUID();
             auto packetList = encodeMessagesDataPacket(channel, data, senderID);
@@ -154,7 +218,7 @@ void MessagesClient::sendLocalMessage(QString channel, QString message) {
 void MessagesClient::subscribe(QString channel) {
     _subscribedChannels << channel;
     auto nodeList = DependencyManager::get<NodeList>();
-    SharedNodePointer messagesMixer = nodeList->soloNodeOfType(NodeType::MessagesMixer);
+    SharedNodePointer messagesMixer = messagesMixerForChannel(channel);
 
     if (messagesMixer) {
         auto packetList = NLPacketList::create(PacketType::MessagesSubscribe, QByteArray(), true, true);
@@ -166,7 +230,7 @@ void MessagesClient::subscribe(QString channel) {
 void MessagesClient::unsubscribe(QString channel) {
     _subscribedChannels.remove(channel);
     auto nodeList = DependencyManager::get<NodeList>();
-    SharedNodePointer messagesMixer = nodeList->soloNodeOfType(NodeType::MessagesMixer);
+    SharedNodePointer messagesMixer = messagesMixerForChannel(channel);
 
     if (messagesMixer) {
         auto packetList = NLPacketList::create(PacketType::MessagesUnsubscribe, QByteArray(), true, true);
@@ -175,8 +239,28 @@ void MessagesClient::unsubscribe(QString channel) {
     }
 }
 
+void MessagesClient::handleNodeAdded(SharedNodePointer node) {
+    if (node->getType() == NodeType::MessagesMixer) {
+        updateMessagesMixers();
+    }
+}
+
 void MessagesClient::handleNodeActivated(SharedNodePointer node) {
     if (node->getType() == NodeType::MessagesMixer) {
+        updateMessagesMixers();
+
+        // some of our channels may belong to this one now, subscribing again where we already are does no harm
+        for (const auto& channel : _subscribedChannels) {
+            subscribe(channel);
+        }
+    }
+}
+
+void MessagesClient::handleNodeKilled(SharedNodePointer node) {
+    if (node->getType() == NodeType::MessagesMixer) {
+        updateMessagesMixers();
+
+        // the channels of the one that went away belong to the others now
         for (const auto& channel : _subscribedChannels) {
             subscribe(channel);
         }
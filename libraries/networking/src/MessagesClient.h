@@ -13,8 +13,11 @@
 #ifndef hifi_MessagesClient_h
 #define hifi_MessagesClient_h
 
+#include <vector>
+
 #include <QString>
 #include <QByteArray>
+#include <QtCore/QMutex>
 
 #include <DependencyManager.h>
 
@@ -164,9 +167,15 @@ public:
     static void decodeMessagesPacket(QSharedPointer<ReceivedMessage> receivedMessage, QString& channel, 
                                            bool& isText, QString& message, QByteArray& data, QUuid& senderID);
 
+    // the body of a MessagesData packet list for one message, the messages mixer encodes it once for all the subscribers
+    static QByteArray encodeMessagesPayload(QString channel, bool isText, QByteArray message, QUuid senderID);
     static std::unique_ptr<NLPacketList> encodeMessagesPacket(QString channel, QString message, QUuid senderID);
     static std::unique_ptr<NLPacketList> encodeMessagesDataPacket(QString channel, QByteArray data, QUuid senderID);
 
+    // when the domain runs more than one messages mixer, each channel belongs to one of them,
+    // the same one for everybody that knows the same messages mixers
+    static QUuid channelOwner(const QString& channel, const std::vector<QUuid>& messagesMixerIDs);
+
 signals:
     /**jsdoc
      * Triggered when a text message is received.
@@ -199,10 +208,22 @@ signals:
 
 private slots:
     void handleMessagesPacket(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode);
+    void handleNodeAdded(SharedNodePointer node);
     void handleNodeActivated(SharedNodePointer node);
+    void handleNodeKilled(SharedNodePointer node);
 
 protected:
+    void updateMessagesMixers();
+    SharedNodePointer messagesMixerForChannel(const QString& channel);
+
     QSet<QString> _subscribedChannels;
+
+    // the messages mixers we know about, updated as they come and go rather than looked up for every message,
+    // which scripts send from their own threads
+    QMutex _messagesMixersLock;
+    SharedNodePointer _anyMessagesMixer;
+    std::vector<SharedNodePointer> _activeMessagesMixers;
+    std::vector<QUuid> _activeMessagesMixerIDs;
 };
 
 #endif
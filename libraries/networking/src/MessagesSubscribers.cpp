@@ -0,0 +1,105 @@
+//
+//  MessagesSubscribers.cpp
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MessagesSubscribers.h"
+
+#include <algorithm>
+
+bool MessagesSubscribers::subscribe(const QString& channel, const SharedNodePointer& node) {
+    auto& channels = _nodeChannels[node->getUUID()];
+    if (channels.contains(channel)) {
+        return false;
+    }
+
+    channels.insert(channel);
+    _channelSubscribers[channel].push_back(node);
+    ++_numSubscriptions;
+    return true;
+}
+
+bool MessagesSubscribers::unsubscribe(const QString& channel, const QUuid& nodeID) {
+    auto it = _nodeChannels.find(nodeID);
+    if (it == _nodeChannels.end() || !it->remove(channel)) {
+        return false;
+    }
+
+    if (it->isEmpty()) {
+        _nodeChannels.erase(it);
+    }
+    removeFromChannel(channel, nodeID);
+    return true;
+}
+
+void MessagesSubscribers::removeNode(const QUuid& nodeID) {
+    auto it = _nodeChannels.find(nodeID);
+    if (it == _nodeChannels.end()) {
+        return;
+    }
+
+    for (const auto& channel : *it) {
+        removeFromChannel(channel, nodeID);
+    }
+    _nodeChannels.erase(it);
+}
+
+void MessagesSubscribers::removeChannel(const QString& channel) {
+    auto it = _channelSubscribers.find(channel);
+    if (it == _channelSubscribers.end()) {
+        return;
+    }
+
+    for (const auto& node : *it) {
+        auto nodeChannels = _nodeChannels.find(node->getUUID());
+        if (nodeChannels != _nodeChannels.end()) {
+            nodeChannels->remove(channel);
+            if (nodeChannels->isEmpty()) {
+                _nodeChannels.erase(nodeChannels);
+            }
+        }
+    }
+
+    _numSubscriptions -= (int)it->size();
+    _channelSubscribers.erase(it);
+}
+
+const MessagesSubscribers::Subscribers& MessagesSubscribers::getSubscribers(const QString& channel) const {
+    static const Subscribers NO_SUBSCRIBERS;
+
+    auto it = _channelSubscribers.find(channel);
+    return it != _channelSubscribers.end() ? *it : NO_SUBSCRIBERS;
+}
+
+std::vector<QString> MessagesSubscribers::getChannels() const {
+    auto channels = _channelSubscribers.keys();
+    return std::vector<QString>(channels.begin(), channels.end());
+}
+
+void MessagesSubscribers::removeFromChannel(const QString& channel, const QUuid& nodeID) {
+    auto it = _channelSubscribers.find(channel);
+    if (it == _channelSubscribers.end()) {
+        return;
+    }
+
+    auto& subscribers = *it;
+    auto subscriber = std::find_if(subscribers.begin(), subscribers.end(), [&](const SharedNodePointer& node) {
+        return node->getUUID() == nodeID;
+    });
+
+    if (subscriber != subscribers.end()) {
+        // the order we send to subscribers in doesn't matter, swap in the last one rather than shift them all
+        *subscriber = std::move(subscribers.back());
+        subscribers.pop_back();
+        --_numSubscriptions;
+    }
+
+    if (subscribers.empty()) {
+        _channelSubscribers.erase(it);
+    }
+}
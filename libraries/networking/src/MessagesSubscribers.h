@@ -0,0 +1,51 @@
+//
+//  MessagesSubscribers.h
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MessagesSubscribers_h
+#define hifi_MessagesSubscribers_h
+
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+#include "Node.h"
+
+/// The nodes subscribed to each messages channel, indexed by channel so that a message only visits its own subscribers
+///   MessagesSubscribers is not thread-safe! It should be used from a single thread.
+class MessagesSubscribers {
+public:
+    using Subscribers = std::vector<SharedNodePointer>;
+
+    // returns false if the node was already subscribed to the channel
+    bool subscribe(const QString& channel, const SharedNodePointer& node);
+    // returns false if the node wasn't subscribed to the channel
+    bool unsubscribe(const QString& channel, const QUuid& nodeID);
+    void removeNode(const QUuid& nodeID);
+    void removeChannel(const QString& channel);
+
+    // the subscribers to a channel, empty if there are none
+    const Subscribers& getSubscribers(const QString& channel) const;
+    std::vector<QString> getChannels() const;
+
+    int getNumChannels() const { return _channelSubscribers.size(); }
+    int getNumSubscriptions() const { return _numSubscriptions; }
+
+private:
+    void removeFromChannel(const QString& channel, const QUuid& nodeID);
+
+    QHash<QString, Subscribers> _channelSubscribers;
+    QHash<QUuid, QSet<QString>> _nodeChannels;
+    int _numSubscriptions { 0 };
+};
+
+#endif // hifi_MessagesSubscribers_h
@@ -164,6 +164,15 @@ QByteArray NLPacket::hashForPacketAndHMAC(const udt::Packet& packet, HMACAuth& h
     return QByteArray((const char*) hashResult.data(), (int) hashResult.size());
 }
 
+bool NLPacket::hashInHeaderMatches(const udt::Packet& packet, HMACAuth& hash) {
+    int hashOffset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
+        + NUM_BYTES_LOCALID;
+    int offset = hashOffset + NUM_BYTES_MD5_HASH;
+
+    return hash.verifyHash(packet.getData() + offset, packet.getDataSize() - offset,
+                           packet.getData() + hashOffset, NUM_BYTES_MD5_HASH);
+}
+
 void NLPacket::writeTypeAndVersion() {
     auto headerOffset = Packet::totalHeaderSize(isPartOfMessage());
     
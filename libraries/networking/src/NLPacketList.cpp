@@ -41,6 +41,12 @@ NLPacketList::NLPacketList(PacketList&& other) : PacketList(std::move(other)) {
     }
 }
 
+std::unique_ptr<NLPacketList> NLPacketList::createNextSegment() {
+    auto nextSegment = create(getType(), getExtendedHeader(), isReliable(), isOrdered());
+    continueMessageIn(*nextSegment);
+    return nextSegment;
+}
+
 std::unique_ptr<udt::Packet> NLPacketList::createPacket() {
     return NLPacket::create(getType(), -1, isReliable(), isOrdered());
 }
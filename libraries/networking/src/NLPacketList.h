@@ -25,6 +25,9 @@ public:
     NLPacket::LocalID getSourceID() const { return _sourceID; }
 
     qint64 getMaxSegmentSize() const override { return NLPacket::maxPayloadSize(_packetType, _isOrdered); }
+
+    // Ends this list as a segment of a longer message and returns the list that continues it, see continueMessageIn()
+    std::unique_ptr<NLPacketList> createNextSegment();
     
 private:
     NLPacketList(PacketType packetType, QByteArray extendedHeader = QByteArray(), bool isReliable = false,
@@ -207,13 +207,17 @@ QDebug operator<<(QDebug debug, const Node& node) {
     return debug.nospace();
 }
 
-void Node::setConnectionSecret(const QUuid& connectionSecret) {
-    if (_connectionSecret == connectionSecret) {
+void Node::setConnectionSecret(const QUuid& connectionSecret, HMACAuth::AuthMethod authMethod) {
+    if (_connectionSecret == connectionSecret
+        && (!_authenticateHash || _authenticateHash->getAuthMethod() == authMethod)) {
         return;
     }
 
     if (!_authenticateHash) {
-        _authenticateHash.reset(new HMACAuth());
+        _authenticateHash.reset(new HMACAuth(authMethod));
+    } else {
+        // other threads may be using this one to sign packets, so it is switched over rather than replaced
+        _authenticateHash->setAuthMethod(authMethod);
     }
 
     _connectionSecret = connectionSecret;
@@ -17,6 +17,7 @@
 #include <QtCore/QDebug>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QMetaEnum>
+#include <QtCore/QProcessEnvironment>
 #include <QtCore/QUrl>
 #include <QtCore/QThread>
 #include <QtNetwork/QHostInfo>
@@ -46,6 +47,13 @@ using namespace std::chrono;
 const int KEEPALIVE_PING_INTERVAL_MS = 1000;
 const int MAX_SYSTEM_INFO_SIZE = 1000;
 
+// names the congestion control ("vegas" or "bbr") to use instead of the default for our node type
+const QString HIFI_UDT_CONGESTION_CONTROL_ENV = "HIFI_UDT_CONGESTION_CONTROL";
+
+// asks the mixers to follow every N unreliable packets with their parity, so one lost audio or avatar frame
+// in N can be rebuilt without waiting for the next one - off (0) by default
+const QString HIFI_UDT_FEC_GROUP_SIZE_ENV = "HIFI_UDT_FEC_GROUP_SIZE";
+
 NodeList::NodeList(char newOwnerType, int socketListenPort, int dtlsListenPort) :
     LimitedNodeList(socketListenPort, dtlsListenPort),
     _ownerType(newOwnerType),
@@ -110,6 +118,9 @@ NodeList::NodeList(char newOwnerType, int socketListenPort, int dtlsListenPort)
     // anytime we get a new node we may need to re-send our set of ignored node IDs to it
     connect(this, &LimitedNodeList::nodeActivated, this, &NodeList::maybeSendIgnoreSetToNode);
 
+    // and we may want parity on the streams it sends us
+    connect(this, &LimitedNodeList::nodeActivated, this, &NodeList::maybeRequestFECFromNode);
+
     // setup our timer to send keepalive pings (it's started and stopped on domain connect/disconnect)
     _keepAlivePingTimer.setInterval(KEEPALIVE_PING_INTERVAL_MS); // 1s, Qt::CoarseTimer acceptable
     connect(&_keepAlivePingTimer, &QTimer::timeout, this, &NodeList::sendKeepAlivePings);
@@ -126,6 +137,8 @@ NodeList::NodeList(char newOwnerType, int socketListenPort, int dtlsListenPort)
     using std::placeholders::_1;
     _nodeSocket.setConnectionCreationFilterOperator(std::bind(&NodeList::sockAddrBelongsToDomainOrNode, this, _1));
 
+    updateCongestionControl();
+
     // we definitely want STUN to update our public socket, so call the LNL to kick that off
     startSTUNPublicSocketUpdate();
 
@@ -146,6 +159,33 @@ NodeList::NodeList(char newOwnerType, int socketListenPort, int dtlsListenPort)
     packetReceiver.registerListener(PacketType::UsernameFromIDReply, this, "processUsernameFromIDReply");
 }
 
+void NodeList::setOwnerType(NodeType_t ownerType) {
+    _ownerType.store(ownerType);
+    updateCongestionControl();
+}
+
+void NodeList::updateCongestionControl() {
+    // the asset server sends the large baked assets clients download, BBR keeps those transfers
+    // at the bottleneck bandwidth without bloating buffers, everything else stays on TCP Vegas
+    QString congestionControl = _ownerType == NodeType::AssetServer ? "bbr" : "vegas";
+
+    auto environment = QProcessEnvironment::systemEnvironment();
+    if (environment.contains(HIFI_UDT_CONGESTION_CONTROL_ENV)) {
+        congestionControl = environment.value(HIFI_UDT_CONGESTION_CONTROL_ENV);
+    }
+
+    auto factory = udt::createCongestionControlFactory(congestionControl);
+    if (!factory) {
+        qCWarning(networking) << "Unknown congestion control" << congestionControl << "- using TCP Vegas";
+        congestionControl = "vegas";
+        factory = udt::createCongestionControlFactory(congestionControl);
+    }
+
+    qCDebug(networking) << "Using" << congestionControl << "congestion control for new connections of"
+        << NodeType::getNodeTypeName(_ownerType);
+    _nodeSocket.setCongestionControlFactory(std::move(factory));
+}
+
 qint64 NodeList::sendStats(QJsonObject statsObject, HifiSockAddr destination) {
     if (thread() != QThread::currentThread()) {
         QMetaObject::invokeMethod(this, "sendStats", Qt::QueuedConnection,
@@ -288,6 +328,10 @@ void NodeList::reset(QString reason, bool skipDomainHandlerReset) {
     setSessionUUID(QUuid());
     setSessionLocalID(Node::NULL_LOCAL_ID);
 
+    // whatever domain-server we hear from next, we don't have any of its lists
+    _domainListVersion = 0;
+    _pendingDomainListVersion = 0;
+
     // if we setup the DTLS socket, also disconnect from the DTLS socket readyRead() so it can handle handshaking
     if (_dtlsSocket) {
         disconnect(_dtlsSocket, 0, this, 0);
@@ -466,6 +510,11 @@ void NodeList::sendDomainServerCheckIn() {
         packetStream << _ownerType.load() << publicSockAddr << localSockAddr << _nodeTypesOfInterest.toList();
         packetStream << DependencyManager::get<AddressManager>()->getPlaceName();
 
+        if (domainPacketType == PacketType::DomainListRequest) {
+            // so the domain-server only needs to send us what has changed since
+            packetStream << _domainListVersion.load();
+        }
+
         if (!domainIsConnected) {
             DataServerAccountInfo& accountInfo = accountManager->getAccountInfo();
             packetStream << accountInfo.getUsername();
@@ -707,9 +756,23 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     bool newConnection;
     packetStream >> newConnection;
 
+    // which list this is, the list it only has the changes since (or zero if it's everything), and its number of entries
+    quint32 domainListVersion;
+    packetStream >> domainListVersion;
+
+    quint32 baseDomainListVersion;
+    packetStream >> baseDomainListVersion;
+
+    quint32 numDomainListEntries;
+    packetStream >> numDomainListEntries;
+
     if (newConnection) {
         _nodeConnectTimestamp = usecTimestampNow();
         _connectReason = Connect;
+
+        // the version numbers we had were from a previous connection
+        _domainListVersion = 0;
+        _pendingDomainListVersion = 0;
     }
 
     qint64 pingLagTime = (now - qint64(connectRequestTimestamp)) / qint64(USECS_PER_MSEC);
@@ -786,9 +849,39 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     setPermissions(newPermissions);
     setAuthenticatePackets(isAuthenticated);
 
+    if (domainListVersion < _domainListVersion) {
+        // this list was overtaken by one we already have all of, its nodes could have gone since
+        return;
+    }
+
+    if (domainListVersion != _pendingDomainListVersion || domainServerPingSendTime != _pendingDomainListSendTime) {
+        // the first packet we've seen of this list
+        _pendingDomainListVersion = domainListVersion;
+        _pendingDomainListSendTime = domainServerPingSendTime;
+        _pendingDomainListEntryIDs.clear();
+        _pendingDomainListNumLocalKills = _numLocalKills;
+    }
+
     // pull each node in the packet
     while (packetStream.device()->pos() < message->getSize()) {
-        parseNodeFromPacketStream(packetStream);
+        quint8 entryType;
+        packetStream >> entryType;
+
+        if (entryType == DomainListRemovedNode) {
+            QUuid nodeUUID;
+            packetStream >> nodeUUID;
+            killNodeRemovedByDomainServer(nodeUUID);
+            _pendingDomainListEntryIDs.insert(nodeUUID);
+        } else {
+            // by ID, so that a packet that shows up twice doesn't count its entries twice
+            _pendingDomainListEntryIDs.insert(parseNodeFromPacketStream(packetStream));
+        }
+    }
+
+    if ((quint32)_pendingDomainListEntryIDs.size() >= numDomainListEntries &&
+        _pendingDomainListNumLocalKills == _numLocalKills) {
+        // we have all of this list, the next one can be a delta on top of it
+        _domainListVersion = domainListVersion;
     }
 }
 
@@ -804,11 +897,32 @@ void NodeList::processDomainServerRemovedNode(QSharedPointer<ReceivedMessage> me
     // read the UUID from the packet, remove it if it exists
     QUuid nodeUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
     qCDebug(networking) << "Received packet from domain-server to remove node with UUID" << uuidStringWithoutCurlyBraces(nodeUUID);
+    killNodeRemovedByDomainServer(nodeUUID);
+}
+
+// set while we kill a node because the domain-server told us to - the silent node timer kills from its own thread
+static thread_local bool isKillingNodeRemovedByDomainServer { false };
+
+void NodeList::killNodeRemovedByDomainServer(const QUuid& nodeUUID) {
+    isKillingNodeRemovedByDomainServer = true;
     killNodeWithUUID(nodeUUID);
+    isKillingNodeRemovedByDomainServer = false;
+
     removeDelayedAdd(nodeUUID);
 }
 
-void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
+void NodeList::handleNodeKill(const SharedNodePointer& node, ConnectionID newConnectionID) {
+    if (!isKillingNodeRemovedByDomainServer) {
+        // the domain-server still has this node in the lists we have all of, so a delta on top of them wouldn't
+        // send it again - ask for a full list with our next check-in, and don't take one we're partway through
+        ++_numLocalKills;
+        _domainListVersion = 0;
+    }
+
+    LimitedNodeList::handleNodeKill(node, newConnectionID);
+}
+
+QUuid NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
     NewNodeInfo info;
 
     packetStream >> info.type
@@ -820,6 +934,11 @@ void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
                  >> info.sessionLocalID
                  >> info.connectionSecretUUID;
 
+    // the domain-server tells us how packets signed with that secret are hashed
+    quint8 authMethod;
+    packetStream >> authMethod;
+    info.authMethod = authMethod <= HMACAuth::SIPHASH ? (HMACAuth::AuthMethod)authMethod : HMACAuth::MD5;
+
     // if the public socket address is 0 then it's reachable at the same IP
     // as the domain server
     if (info.publicSocket.getAddress().isNull()) {
@@ -827,6 +946,8 @@ void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
     }
 
     addNewNode(info);
+
+    return info.uuid;
 }
 
 void NodeList::sendAssignment(Assignment& assignment) {
@@ -1085,6 +1206,22 @@ bool NodeList::isPersonalMutingNode(const QUuid& nodeID) const {
     return _personalMutedNodeIDs.find(nodeID) != _personalMutedNodeIDs.cend();
 }
 
+void NodeList::maybeRequestFECFromNode(SharedNodePointer newNode) {
+    static const int fecGroupSize = QProcessEnvironment::systemEnvironment().value(HIFI_UDT_FEC_GROUP_SIZE_ENV, "0").toInt();
+    // a node only gets an active socket once it answers our pings, which it drops unless their version matches,
+    // so builds that don't know the FEC control packets are never sent any
+    if (fecGroupSize <= 0 || !newNode->getActiveSocket()) {
+        return;
+    }
+
+    // only the audio and avatar streams between the agents and the mixers are worth the extra bandwidth
+    bool nodeIsMixer = newNode->getType() == NodeType::AudioMixer || newNode->getType() == NodeType::AvatarMixer;
+    bool ownerIsMixer = _ownerType == NodeType::AudioMixer || _ownerType == NodeType::AvatarMixer;
+    if ((_ownerType == NodeType::Agent && nodeIsMixer) || (ownerIsMixer && newNode->getType() == NodeType::Agent)) {
+        _nodeSocket.requestFEC(*newNode->getActiveSocket(), fecGroupSize);
+    }
+}
+
 void NodeList::maybeSendIgnoreSetToNode(SharedNodePointer newNode) {
     if (newNode->getType() == NodeType::AudioMixer) {
         // this is a mixer that we just added - it's unlikely it knows who we were previously ignoring in this session,
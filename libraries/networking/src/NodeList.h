@@ -55,7 +55,7 @@ class NodeList : public LimitedNodeList {
 public:
     void startThread();
     NodeType_t getOwnerType() const { return _ownerType.load(); }
-    void setOwnerType(NodeType_t ownerType) { _ownerType.store(ownerType); }
+    void setOwnerType(NodeType_t ownerType);
 
     Q_INVOKABLE qint64 sendStats(QJsonObject statsObject, HifiSockAddr destination);
     Q_INVOKABLE qint64 sendStatsToDomainServer(QJsonObject statsObject);
@@ -146,6 +146,7 @@ private slots:
     void sendKeepAlivePings();
 
     void maybeSendIgnoreSetToNode(SharedNodePointer node);
+    void maybeRequestFECFromNode(SharedNodePointer node);
 
 private:
     NodeList() : LimitedNodeList(INVALID_PORT, INVALID_PORT) { assert(false); } // Not implemented, needed for DependencyManager templates compile
@@ -160,12 +161,17 @@ private:
 
     void sendDSPathQuery(const QString& newPath);
 
-    void parseNodeFromPacketStream(QDataStream& packetStream);
+    QUuid parseNodeFromPacketStream(QDataStream& packetStream);
+    void killNodeRemovedByDomainServer(const QUuid& nodeUUID);
+    void handleNodeKill(const SharedNodePointer& node, ConnectionID newConnectionID = NULL_CONNECTION_ID) override;
 
     void pingPunchForInactiveNode(const SharedNodePointer& node);
 
     bool sockAddrBelongsToDomainOrNode(const HifiSockAddr& sockAddr);
 
+    // picks the congestion control for new connections from our owner type, see HIFI_UDT_CONGESTION_CONTROL_ENV
+    void updateCongestionControl();
+
     std::atomic<NodeType_t> _ownerType;
     NodeSet _nodeTypesOfInterest;
     DomainHandler _domainHandler;
@@ -176,6 +182,16 @@ private:
 
     bool _sendDomainServerCheckInEnabled { true };
 
+    // the domain-server sends us the nodes that changed since the last domain list we had all of, which we tell it
+    // in our check-ins - a list is only complete once every entry it says it has has shown up, and a node we drop
+    // ourselves puts us back on full lists since no delta would bring it back
+    quint32 _pendingDomainListVersion { 0 };
+    quint64 _pendingDomainListSendTime { 0 };
+    QSet<QUuid> _pendingDomainListEntryIDs;
+    quint32 _pendingDomainListNumLocalKills { 0 };
+    std::atomic<quint32> _numLocalKills { 0 };
+    std::atomic<quint32> _domainListVersion { 0 };
+
     mutable QReadWriteLock _ignoredSetLock;
     tbb::concurrent_unordered_set<QUuid, UUIDHasher> _ignoredNodeIDs;
     mutable QReadWriteLock _personalMutedSetLock;
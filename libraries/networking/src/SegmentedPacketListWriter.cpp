@@ -0,0 +1,141 @@
+//
+//  SegmentedPacketListWriter.cpp
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SegmentedPacketListWriter.h"
+
+#include <algorithm>
+
+const qint64 SegmentedPacketListWriter::DEFAULT_SEGMENT_SIZE = 1 << 20;
+
+// one segment going out and one behind it, reading the next waits for the first to be taken
+const int SegmentedPacketListWriter::MAX_QUEUED_SEGMENTS = 2;
+
+std::shared_ptr<SegmentedPacketListWriter> SegmentedPacketListWriter::create(std::unique_ptr<NLPacketList> packetList, qint64 size,
+                                                                             Source source, Sender sender, Scheduler scheduler,
+                                                                             qint64 segmentSize) {
+    return std::shared_ptr<SegmentedPacketListWriter>(new SegmentedPacketListWriter(std::move(packetList), size, source,
+                                                                                    sender, scheduler, segmentSize));
+}
+
+SegmentedPacketListWriter::SegmentedPacketListWriter(std::unique_ptr<NLPacketList> packetList, qint64 size, Source source,
+                                                     Sender sender, Scheduler scheduler, qint64 segmentSize) :
+    _packetList(std::move(packetList)),
+    _bytesLeft(std::max(size, (qint64)0)),
+    _source(source),
+    _sender(sender),
+    _scheduler(scheduler),
+    _segmentSize(std::max(segmentSize, (qint64)1))
+{
+}
+
+bool SegmentedPacketListWriter::start() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isReading = true;
+    }
+
+    if (!readSegment()) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isReading = false;
+        _isFinished = true;
+        return false;
+    }
+    sendSegment();
+    readSegments();
+    return true;
+}
+
+bool SegmentedPacketListWriter::readSegment() {
+    qint64 bytesToRead = std::min(_bytesLeft, _segmentSize);
+    _bytesLeft -= bytesToRead;
+    return _source(bytesToRead, [this](const char* data, qint64 size) {
+        return _packetList->write(data, size) == size;
+    });
+}
+
+void SegmentedPacketListWriter::sendSegment() {
+    if (_bytesLeft == 0) {
+        // an empty packet still carries the end of the message
+        _packetList->closeCurrentPacket(true);
+        finish(_sender(std::move(_packetList)));
+        return;
+    }
+
+    // the next segment only starts once there's more to read, so the last one is never empty
+    auto nextSegment = _packetList->createNextSegment();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_numQueuedSegments;
+    }
+    auto self = shared_from_this();
+    _packetList->setSegmentSentCallback([self](bool sent) {
+        self->segmentSent(sent);
+    });
+
+    // a segment that doesn't make it to a send queue calls back as dropped
+    _sender(std::move(_packetList));
+    _packetList = std::move(nextSegment);
+}
+
+void SegmentedPacketListWriter::readSegments() {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_isFinished || _numQueuedSegments >= MAX_QUEUED_SEGMENTS) {
+                _isReading = false;
+                return;
+            }
+        }
+
+        if (!readSegment()) {
+            // the start of the message is already out, ending it short fails it on the receiver
+            _packetList->closeCurrentPacket(true);
+            _sender(std::move(_packetList));
+            finish(false);
+            return;
+        }
+        sendSegment();
+    }
+}
+
+void SegmentedPacketListWriter::segmentSent(bool sent) {
+    bool shouldRead = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        --_numQueuedSegments;
+        if (sent && !_isFinished && !_isReading) {
+            _isReading = true;
+            shouldRead = true;
+        }
+    }
+
+    if (!sent) {
+        finish(false);
+    } else if (shouldRead) {
+        auto self = shared_from_this();
+        _scheduler([self] {
+            self->readSegments();
+        });
+    }
+}
+
+void SegmentedPacketListWriter::finish(bool success) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_isFinished) {
+            return;
+        }
+        _isFinished = true;
+    }
+
+    if (_finishedCallback) {
+        _finishedCallback(success);
+    }
+}
@@ -0,0 +1,74 @@
+//
+//  SegmentedPacketListWriter.h
+//  libraries/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SegmentedPacketListWriter_h
+#define hifi_SegmentedPacketListWriter_h
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "NLPacketList.h"
+
+// Sends one reliable, ordered message of any length a bounded segment at a time, without holding a thread while it goes out.
+// A segment is read from the source and handed to the sender, and the next one is only read once the send queue has
+// taken the one before it, from a callback of the queue, so no more than two segments of the message are held in memory.
+// The writer keeps itself alive for as long as one of its segments is queued. If a segment is dropped, as it is when
+// its connection goes away, the rest of the message is abandoned.
+class SegmentedPacketListWriter : public std::enable_shared_from_this<SegmentedPacketListWriter> {
+public:
+    using Sender = std::function<bool(std::unique_ptr<NLPacketList> segment)>;
+    using ChunkWriter = std::function<bool(const char* data, qint64 size)>;
+    // Hands the next size bytes of the message to the writer, in order
+    using Source = std::function<bool(qint64 size, const ChunkWriter& writer)>;
+    // Runs the reading of a segment off the thread of the send queue, which calls back when a segment has been taken
+    using Scheduler = std::function<void(std::function<void()> work)>;
+    // Called once the whole message is handed to the sender, or with false when it was cut short or abandoned
+    using FinishedCallback = std::function<void(bool success)>;
+
+    static const qint64 DEFAULT_SEGMENT_SIZE;
+
+    static std::shared_ptr<SegmentedPacketListWriter> create(std::unique_ptr<NLPacketList> packetList, qint64 size,
+                                                             Source source, Sender sender, Scheduler scheduler,
+                                                             qint64 segmentSize = DEFAULT_SEGMENT_SIZE);
+
+    void setFinishedCallback(FinishedCallback callback) { _finishedCallback = callback; }
+
+    // Reads and queues the first segment, the rest of the size bytes after what the packet list already holds follow
+    // as the send queue takes them. Returns false if the first segment couldn't be read, then nothing was sent.
+    bool start();
+
+private:
+    static const int MAX_QUEUED_SEGMENTS;
+
+    SegmentedPacketListWriter(std::unique_ptr<NLPacketList> packetList, qint64 size, Source source, Sender sender,
+                              Scheduler scheduler, qint64 segmentSize);
+
+    bool readSegment();
+    void sendSegment();
+    void readSegments();
+    void segmentSent(bool sent);
+    void finish(bool success);
+
+    std::unique_ptr<NLPacketList> _packetList; // the segment being read into
+    qint64 _bytesLeft;
+    Source _source;
+    Sender _sender;
+    Scheduler _scheduler;
+    qint64 _segmentSize;
+    FinishedCallback _finishedCallback;
+
+    std::mutex _mutex; // protects the state below, shared with the send queue callbacks
+    int _numQueuedSegments { 0 };
+    bool _isReading { false };
+    bool _isFinished { false };
+};
+
+#endif // hifi_SegmentedPacketListWriter_h
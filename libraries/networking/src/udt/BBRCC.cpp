@@ -0,0 +1,390 @@
+//
+//  BBRCC.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BBRCC.h"
+
+#include <algorithm>
+
+#include <QtCore/QtGlobal>
+
+using namespace udt;
+using namespace std::chrono;
+
+static const double USECS_PER_SECOND = 1000000.0;
+
+// 2 / ln(2), the smallest gain that doubles the sending rate every round trip
+static const double HIGH_GAIN = 2.885;
+static const double DRAIN_GAIN = 1.0 / HIGH_GAIN;
+// Startup keeps the congestion window gain at 2 instead of HIGH_GAIN, we only learn of losses one at a time
+// from cumulative ACKs, so the queue Startup builds must not overflow the bottleneck buffer
+static const double STARTUP_CONGESTION_WINDOW_GAIN = 2.0;
+static const double CONGESTION_WINDOW_GAIN = 2.0;
+
+// probe for more bandwidth for a round trip, drain the queue that made for a round trip, then cruise for six
+static const double PACING_GAIN_CYCLE[] = { 1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+static const int PACING_GAIN_CYCLE_LENGTH = sizeof(PACING_GAIN_CYCLE) / sizeof(PACING_GAIN_CYCLE[0]);
+static const int CRUISE_CYCLE_INDEX = 2;
+
+static const int BANDWIDTH_WINDOW_ROUNDS = 10;
+static const microseconds MIN_RTT_WINDOW = seconds(10);
+static const microseconds PROBE_RTT_DURATION = milliseconds(200);
+
+// the pipe is full once the bandwidth grew less than 25% for three rounds in a row
+static const double FULL_BANDWIDTH_GROWTH = 1.25;
+static const int FULL_BANDWIDTH_ROUNDS = 3;
+
+static const int INITIAL_CONGESTION_WINDOW_PACKETS = 16;
+static const int MIN_CONGESTION_WINDOW_PACKETS = 4;
+// allowance for the packets held up by delayed and stretched ACKs
+static const int CONGESTION_WINDOW_QUANTA_PACKETS = 3;
+
+static const int FAST_RETRANSMIT_DUPLICATE_COUNT = 3;
+// until we have an RTT sample the timeout is TCP's initial one (RFC 6298), a shorter one would have us re-send
+// the first packets of every path slower than it, and re-sent packets give no RTT samples
+static const int INITIAL_TIMEOUT_USECS = 1000000;
+static const int MAX_RTT_SAMPLE_MICROSECONDS = 10000000;
+
+// a send this long after the last, with room in the window, means the sender ran out of data
+static const microseconds APP_LIMITED_GAP_SLACK = milliseconds(1);
+
+BBRCC::BBRCC() {
+    // we don't pace until we have a first delivery rate sample
+    _packetSendPeriod = 0.0;
+    _congestionWindowSize = INITIAL_CONGESTION_WINDOW_PACKETS;
+
+    _pacingGain = HIGH_GAIN;
+    _congestionWindowGain = STARTUP_CONGESTION_WINDOW_GAIN;
+}
+
+bool BBRCC::onACK(SequenceNumber ack, p_high_resolution_clock::time_point receiveTime) {
+    bool wasDuplicateACK = (ack == _lastACK);
+    if (wasDuplicateACK) {
+        ++_duplicateACKCount;
+    } else {
+        _lastACK = ack;
+        _duplicateACKCount = 0;
+    }
+
+    // ACKs are cumulative, everything up to this one was delivered
+    int ackedPackets = 0;
+    SentPacketData newestACKed;
+    while (!_sentPacketDatas.empty() && _sentPacketDatas.front().sequenceNumber <= ack) {
+        newestACKed = _sentPacketDatas.front();
+        _sentPacketDatas.pop_front();
+        ++ackedPackets;
+    }
+
+    _isRoundStart = false;
+    if (ackedPackets > 0) {
+        _delivered += ackedPackets;
+        _deliveredTime = receiveTime;
+
+        // a round trip ends when a packet sent after the start of the round is ACKed
+        if (newestACKed.delivered >= _nextRoundDelivered) {
+            _nextRoundDelivered = _delivered;
+            ++_roundCount;
+            _isRoundStart = true;
+        }
+
+        // packets that were re-sent can't tell which send was ACKed, so they give no RTT or rate samples
+        if (!newestACKed.wasResent) {
+            int rtt = (int)duration_cast<microseconds>(receiveTime - newestACKed.sendTime).count();
+            updateRTT(std::min(std::max(rtt, 1), MAX_RTT_SAMPLE_MICROSECONDS), receiveTime);
+            updateBandwidth(newestACKed, receiveTime);
+        }
+
+        _firstSentTime = newestACKed.sendTime;
+    }
+
+    if (_isRecovering && ack >= _recoverySequenceNumber) {
+        // everything that was outstanding at the timeout has been delivered
+        _isRecovering = false;
+        _congestionWindowSize = std::max(_congestionWindowSize, _priorCongestionWindowSize);
+    }
+
+    updateMode(receiveTime);
+    updateCongestionWindow(ackedPackets);
+    updatePacketSendPeriod();
+
+    return needsFastRetransmit(ack, receiveTime);
+}
+
+bool BBRCC::needsFastRetransmit(SequenceNumber ack, p_high_resolution_clock::time_point now) {
+    if (_sentPacketDatas.empty() || _sentPacketDatas.front().sequenceNumber != ack + 1) {
+        return false;
+    }
+
+    // the packet after the ACK is lost if it has been outstanding for longer than our estimated timeout,
+    // or on the third duplicate ACK like TCP Reno, unless we re-sent it since then
+    auto& next = _sentPacketDatas.front();
+    bool hasTimedOut = duration_cast<microseconds>(now - next.sendTime).count() >= estimatedTimeout();
+    if (hasTimedOut || (_duplicateACKCount >= FAST_RETRANSMIT_DUPLICATE_COUNT && !next.wasResent)) {
+        _duplicateACKCount = 0;
+
+        // don't ask for it again until it has had the time to make it
+        next.sendTime = now;
+        next.wasResent = true;
+        return true;
+    }
+
+    return false;
+}
+
+void BBRCC::onTimeout() {
+    // everything outstanding is about to be re-sent, only let new packets out once that made it through
+    if (!_isRecovering) {
+        _priorCongestionWindowSize = _mode == Mode::ProbeRTT ?
+            std::max(_congestionWindowSize, _priorCongestionWindowSize) : _congestionWindowSize;
+    }
+    _isRecovering = true;
+    _recoverySequenceNumber = _sendCurrSeqNum;
+    _congestionWindowSize = MIN_CONGESTION_WINDOW_PACKETS;
+    _duplicateACKCount = 0;
+}
+
+void BBRCC::onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+    if (_sentPacketDatas.empty()) {
+        // nothing in flight, the next delivery rate interval starts with this packet
+        _firstSentTime = timePoint;
+        _deliveredTime = timePoint;
+    } else {
+        // a gap the pacing and the window don't explain means we had nothing to send,
+        // and until what is in flight now is delivered the delivery rate only measures how much we had
+        bool wasWindowLimited = getPacketsInFlight() >= _congestionWindowSize;
+        auto gap = timePoint - _lastSendTime;
+        if (!wasWindowLimited && gap > microseconds((int64_t)(2 * _packetSendPeriod)) + APP_LIMITED_GAP_SLACK) {
+            _appLimitedUntil = std::max(_appLimitedUntil, _delivered + getPacketsInFlight());
+        }
+    }
+
+    SentPacketData sentPacketData;
+    sentPacketData.sequenceNumber = seqNum;
+    sentPacketData.sendTime = timePoint;
+    sentPacketData.firstSentTime = _firstSentTime;
+    sentPacketData.deliveredTime = _deliveredTime;
+    sentPacketData.delivered = _delivered;
+    sentPacketData.isAppLimited = _appLimitedUntil > _delivered;
+    _sentPacketDatas.push_back(sentPacketData);
+
+    _lastSendTime = timePoint;
+}
+
+void BBRCC::onPacketReSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) {
+    auto it = std::lower_bound(_sentPacketDatas.begin(), _sentPacketDatas.end(), seqNum,
+                               [](const SentPacketData& sentPacketData, SequenceNumber seqNum) {
+        return sentPacketData.sequenceNumber < seqNum;
+    });
+
+    // if we found information for this packet (it hasn't been erased because it hasn't yet been ACKed)
+    // then mark it as re-sent so we know it cannot be used for RTT or rate samples
+    if (it != _sentPacketDatas.end() && it->sequenceNumber == seqNum) {
+        it->wasResent = true;
+        it->sendTime = timePoint;
+    }
+}
+
+int BBRCC::estimatedTimeout() const {
+    return _ewmaRTT == -1 ? INITIAL_TIMEOUT_USECS : _ewmaRTT + _rttVariance * 4;
+}
+
+void BBRCC::updateRTT(int rtt, p_high_resolution_clock::time_point now) {
+    // the min RTT is the propagation delay, as long as we measured it with empty queues recently enough
+    bool isMinRTTExpired = _minRTT != -1 && now - _minRTTTime > MIN_RTT_WINDOW;
+    if (_minRTT == -1 || rtt <= _minRTT || isMinRTTExpired) {
+        _minRTT = rtt;
+        _minRTTTime = now;
+    }
+
+    if (isMinRTTExpired && _mode != Mode::ProbeRTT) {
+        enterProbeRTT(now);
+    }
+
+    // Jacobson's estimator, for the timeout
+    if (_ewmaRTT == -1) {
+        _ewmaRTT = rtt;
+        _rttVariance = rtt / 2;
+    } else {
+        static const int RTT_ESTIMATION_ALPHA = 8;
+        static const int RTT_ESTIMATION_VARIANCE_ALPHA = 4;
+
+        _ewmaRTT = (_ewmaRTT * (RTT_ESTIMATION_ALPHA - 1) + rtt) / RTT_ESTIMATION_ALPHA;
+        _rttVariance = (_rttVariance * (RTT_ESTIMATION_VARIANCE_ALPHA - 1)
+                        + abs(rtt - _ewmaRTT)) / RTT_ESTIMATION_VARIANCE_ALPHA;
+    }
+}
+
+void BBRCC::updateBandwidth(const SentPacketData& packet, p_high_resolution_clock::time_point now) {
+    // the delivery rate is the packets delivered while this one was in flight, over the longer of
+    // the time it took to send them and the time it took to ACK them, so ACK compression doesn't inflate it
+    auto sendElapsed = duration_cast<microseconds>(packet.sendTime - packet.firstSentTime).count();
+    auto ackElapsed = duration_cast<microseconds>(now - packet.deliveredTime).count();
+    auto interval = std::max(sendElapsed, ackElapsed);
+    if (interval <= 0 || (_minRTT != -1 && interval < _minRTT)) {
+        // too short to be a meaningful sample
+        return;
+    }
+
+    double packetsPerSecond = (_delivered - packet.delivered) * USECS_PER_SECOND / interval;
+    if (packet.isAppLimited && packetsPerSecond < getBandwidth()) {
+        // we didn't have enough to send to know this is all the path can do
+        return;
+    }
+
+    if (!_bandwidthSamples.empty() && _bandwidthSamples.back().round == _roundCount) {
+        _bandwidthSamples.back().packetsPerSecond = std::max(_bandwidthSamples.back().packetsPerSecond, packetsPerSecond);
+    } else {
+        _bandwidthSamples.push_back({ _roundCount, packetsPerSecond });
+    }
+    while (_bandwidthSamples.front().round <= _roundCount - BANDWIDTH_WINDOW_ROUNDS) {
+        _bandwidthSamples.pop_front();
+    }
+}
+
+void BBRCC::updateMode(p_high_resolution_clock::time_point now) {
+    if (!_isPipeFilled && _isRoundStart) {
+        double bandwidth = getBandwidth();
+        if (bandwidth >= _fullBandwidth * FULL_BANDWIDTH_GROWTH) {
+            _fullBandwidth = bandwidth;
+            _fullBandwidthRounds = 0;
+        } else if (++_fullBandwidthRounds >= FULL_BANDWIDTH_ROUNDS) {
+            _isPipeFilled = true;
+        }
+    }
+
+    if (_mode == Mode::Startup && _isPipeFilled) {
+        _mode = Mode::Drain;
+        _pacingGain = DRAIN_GAIN;
+        _congestionWindowGain = STARTUP_CONGESTION_WINDOW_GAIN;
+    }
+
+    if (_mode == Mode::Drain && getPacketsInFlight() <= getBandwidthDelayProduct(1.0)) {
+        _mode = Mode::ProbeBandwidth;
+        _cycleIndex = CRUISE_CYCLE_INDEX;
+        _cycleStartTime = now;
+        _pacingGain = PACING_GAIN_CYCLE[_cycleIndex];
+        _congestionWindowGain = CONGESTION_WINDOW_GAIN;
+    }
+
+    if (_mode == Mode::ProbeBandwidth) {
+        bool isPhaseOver = duration_cast<microseconds>(now - _cycleStartTime).count() > _minRTT;
+        bool shouldAdvance;
+        if (_pacingGain > 1.0) {
+            // keep probing until we actually put the extra packets in flight
+            shouldAdvance = isPhaseOver && getPacketsInFlight() >= getBandwidthDelayProduct(_pacingGain);
+        } else if (_pacingGain < 1.0) {
+            // stop draining as soon as the queue is gone
+            shouldAdvance = isPhaseOver || getPacketsInFlight() <= getBandwidthDelayProduct(1.0);
+        } else {
+            shouldAdvance = isPhaseOver;
+        }
+
+        if (shouldAdvance) {
+            _cycleIndex = (_cycleIndex + 1) % PACING_GAIN_CYCLE_LENGTH;
+            _cycleStartTime = now;
+            _pacingGain = PACING_GAIN_CYCLE[_cycleIndex];
+        }
+    }
+
+    if (_mode == Mode::ProbeRTT) {
+        if (!_isProbeRTTTimed) {
+            if (getPacketsInFlight() <= MIN_CONGESTION_WINDOW_PACKETS) {
+                // the queues are drained, hold this for a while and at least a round trip
+                _probeRTTDoneTime = now + PROBE_RTT_DURATION;
+                _isProbeRTTTimed = true;
+                _isProbeRTTRoundDone = false;
+                _nextRoundDelivered = _delivered;
+            }
+        } else {
+            if (_isRoundStart) {
+                _isProbeRTTRoundDone = true;
+            }
+            if (_isProbeRTTRoundDone && now >= _probeRTTDoneTime) {
+                exitProbeRTT(now);
+            }
+        }
+    }
+}
+
+void BBRCC::enterProbeRTT(p_high_resolution_clock::time_point now) {
+    _mode = Mode::ProbeRTT;
+    _pacingGain = 1.0;
+    _congestionWindowGain = 1.0;
+    _priorCongestionWindowSize = _isRecovering ? _priorCongestionWindowSize : _congestionWindowSize;
+    _isProbeRTTTimed = false;
+}
+
+void BBRCC::exitProbeRTT(p_high_resolution_clock::time_point now) {
+    _minRTTTime = now;
+    _congestionWindowSize = std::max(_congestionWindowSize, _priorCongestionWindowSize);
+
+    if (_isPipeFilled) {
+        _mode = Mode::ProbeBandwidth;
+        _cycleIndex = CRUISE_CYCLE_INDEX;
+        _cycleStartTime = now;
+        _pacingGain = PACING_GAIN_CYCLE[_cycleIndex];
+        _congestionWindowGain = CONGESTION_WINDOW_GAIN;
+    } else {
+        _mode = Mode::Startup;
+        _pacingGain = HIGH_GAIN;
+        _congestionWindowGain = STARTUP_CONGESTION_WINDOW_GAIN;
+    }
+}
+
+void BBRCC::updateCongestionWindow(int ackedPackets) {
+    if (_mode == Mode::ProbeRTT) {
+        _congestionWindowSize = std::min(_congestionWindowSize, MIN_CONGESTION_WINDOW_PACKETS);
+        return;
+    }
+
+    if (_isRecovering || getBandwidth() <= 0.0) {
+        // without a model yet, or after a timeout, grow by what was delivered like slow start
+        _congestionWindowSize += ackedPackets;
+    } else {
+        int target = getBandwidthDelayProduct(_congestionWindowGain) + CONGESTION_WINDOW_QUANTA_PACKETS;
+        if (_isPipeFilled) {
+            _congestionWindowSize = std::min(_congestionWindowSize + ackedPackets, target);
+        } else if (_congestionWindowSize < target || _delivered < INITIAL_CONGESTION_WINDOW_PACKETS) {
+            _congestionWindowSize += ackedPackets;
+        }
+    }
+
+    _congestionWindowSize = std::max(std::min(_congestionWindowSize, udt::MAX_PACKETS_IN_FLIGHT),
+                                     MIN_CONGESTION_WINDOW_PACKETS);
+}
+
+void BBRCC::updatePacketSendPeriod() {
+    double bandwidth = getBandwidth();
+    if (bandwidth <= 0.0) {
+        return;
+    }
+
+    double packetSendPeriod = USECS_PER_SECOND / (_pacingGain * bandwidth);
+    if (!_isPipeFilled && _packetSendPeriod > 0.0 && packetSendPeriod > _packetSendPeriod) {
+        // never slow down in Startup, a lower sample there only means the model isn't caught up yet
+        return;
+    }
+
+    setPacketSendPeriod(packetSendPeriod);
+}
+
+double BBRCC::getBandwidth() const {
+    double bandwidth = 0.0;
+    for (auto& sample : _bandwidthSamples) {
+        bandwidth = std::max(bandwidth, sample.packetsPerSecond);
+    }
+    return bandwidth;
+}
+
+int BBRCC::getBandwidthDelayProduct(double gain) const {
+    if (_minRTT == -1 || getBandwidth() <= 0.0) {
+        return INITIAL_CONGESTION_WINDOW_PACKETS;
+    }
+    return (int)(gain * getBandwidth() * _minRTT / USECS_PER_SECOND);
+}
@@ -0,0 +1,130 @@
+//
+//  BBRCC.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_BBRCC_h
+#define hifi_BBRCC_h
+
+#include <deque>
+
+#include "CongestionControl.h"
+#include "Constants.h"
+
+namespace udt {
+
+// Congestion control after BBR (https://queue.acm.org/detail.cfm?id=3022184).
+// Instead of reacting to loss or to RTT increases, it keeps a model of the path - the bottleneck bandwidth
+// (the max delivery rate over the last rounds) and the propagation delay (the min RTT over the last seconds) -
+// and paces at the bottleneck bandwidth with about one bandwidth-delay product in flight.
+// That keeps jittery links full without filling up the buffers on the way.
+class BBRCC : public CongestionControl {
+public:
+    BBRCC();
+
+    virtual bool onACK(SequenceNumber ackNum, p_high_resolution_clock::time_point receiveTime) override;
+    virtual void onTimeout() override;
+
+    virtual void onPacketSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) override;
+    virtual void onPacketReSent(int wireSize, SequenceNumber seqNum, p_high_resolution_clock::time_point timePoint) override;
+
+    virtual int estimatedTimeout() const override;
+
+protected:
+    virtual void setInitialSendSequenceNumber(SequenceNumber seqNum) override { _lastACK = seqNum - 1; }
+
+private:
+    enum class Mode {
+        Startup, // grow the sending rate exponentially to find the bottleneck bandwidth
+        Drain, // drain the queue Startup created
+        ProbeBandwidth, // cycle the sending rate around the bottleneck bandwidth to find more of it
+        ProbeRTT // briefly send almost nothing, to measure the propagation delay with empty queues
+    };
+
+    struct SentPacketData {
+        SequenceNumber sequenceNumber;
+        p_high_resolution_clock::time_point sendTime; // of the last send, for RTT and fast re-transmit
+        p_high_resolution_clock::time_point firstSentTime; // send time of the newest ACKed packet when this was sent
+        p_high_resolution_clock::time_point deliveredTime; // time of the last delivery when this was sent
+        int64_t delivered; // packets delivered when this was sent
+        bool isAppLimited;
+        bool wasResent { false };
+    };
+
+    struct BandwidthSample {
+        int64_t round;
+        double packetsPerSecond;
+    };
+
+    bool needsFastRetransmit(SequenceNumber ack, p_high_resolution_clock::time_point now);
+    void updateRTT(int rtt, p_high_resolution_clock::time_point now);
+    void updateBandwidth(const SentPacketData& packet, p_high_resolution_clock::time_point now);
+    void updateMode(p_high_resolution_clock::time_point now);
+    void updateCongestionWindow(int ackedPackets);
+    void updatePacketSendPeriod();
+
+    void enterProbeRTT(p_high_resolution_clock::time_point now);
+    void exitProbeRTT(p_high_resolution_clock::time_point now);
+
+    double getBandwidth() const; // max delivery rate over the bandwidth window, in packets per second
+    int getBandwidthDelayProduct(double gain) const; // in packets
+    int getPacketsInFlight() const { return (int)_sentPacketDatas.size(); }
+
+    std::deque<SentPacketData> _sentPacketDatas; // packets sent and not yet ACKed, in sequence order
+
+    Mode _mode { Mode::Startup };
+    double _pacingGain;
+    double _congestionWindowGain;
+
+    // delivery rate estimation
+    int64_t _delivered { 0 }; // packets ACKed so far
+    p_high_resolution_clock::time_point _deliveredTime;
+    p_high_resolution_clock::time_point _firstSentTime;
+    p_high_resolution_clock::time_point _lastSendTime;
+    int64_t _appLimitedUntil { 0 }; // samples are app limited until this many packets are delivered
+    std::deque<BandwidthSample> _bandwidthSamples; // max rate of each of the last rounds
+
+    // round trips, counted in deliveries
+    int64_t _roundCount { 0 };
+    int64_t _nextRoundDelivered { 0 };
+    bool _isRoundStart { false };
+
+    // Startup exit
+    bool _isPipeFilled { false };
+    double _fullBandwidth { 0.0 };
+    int _fullBandwidthRounds { 0 };
+
+    // ProbeBandwidth gain cycling
+    int _cycleIndex { 0 };
+    p_high_resolution_clock::time_point _cycleStartTime;
+
+    // min RTT and ProbeRTT
+    int _minRTT { -1 }; // in microseconds
+    p_high_resolution_clock::time_point _minRTTTime;
+    p_high_resolution_clock::time_point _probeRTTDoneTime;
+    bool _isProbeRTTTimed { false };
+    bool _isProbeRTTRoundDone { false };
+    int _priorCongestionWindowSize { 0 };
+
+    // loss recovery after a timeout
+    bool _isRecovering { false };
+    SequenceNumber _recoverySequenceNumber;
+
+    // estimated timeout, as in TCP
+    int _ewmaRTT { -1 };
+    int _rttVariance { 0 };
+
+    SequenceNumber _lastACK; // Sequence number of last packet that was ACKed
+    int _duplicateACKCount { 0 };
+};
+
+}
+
+#endif // hifi_BBRCC_h
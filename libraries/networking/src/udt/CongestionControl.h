@@ -16,6 +16,8 @@
 #include <memory>
 #include <vector>
 
+#include <QtCore/QString>
+
 #include <PortableHighResolutionClock.h>
 
 #include "LossList.h"
@@ -81,6 +83,10 @@ public:
     virtual ~CongestionControlFactory() {}
     virtual std::unique_ptr<CongestionControl> create() override { return std::unique_ptr<T>(new T()); }
 };
+
+// Returns the factory for a congestion control by name, "vegas" (TCPVegasCC) or "bbr" (BBRCC),
+// or nullptr if there is no congestion control by that name
+std::unique_ptr<CongestionControlVirtualFactory> createCongestionControlFactory(const QString& name);
     
 }
 
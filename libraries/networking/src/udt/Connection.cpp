@@ -11,10 +11,9 @@
 
 #include "Connection.h"
 
+#include <algorithm>
 #include <random>
 
-#include <QtCore/QThread>
-
 #include <NumericalConstants.h>
 
 #include "../HifiSockAddr.h"
@@ -67,21 +66,13 @@ Connection::~Connection() {
 }
 
 void Connection::stopSendQueue() {
-    if (auto sendQueue = _sendQueue.release()) {
-        // grab the send queue thread so we can wait on it
-        QThread* sendQueueThread = sendQueue->thread();
-        
-        // tell the send queue to stop and be deleted
-        
-        sendQueue->stop();
+    if (_sendQueue) {
+        // tell the send queue to stop and delete it, which waits for the SendScheduler to be done with it
+        _sendQueue->stop();
 
-        _lastMessageNumber = sendQueue->getCurrentMessageNumber();
+        _lastMessageNumber = _sendQueue->getCurrentMessageNumber();
 
-        sendQueue->deleteLater();
-        
-        // wait on the send queue thread so we know the send queue is gone
-        sendQueueThread->quit();
-        sendQueueThread->wait();
+        _sendQueue.reset();
     }
 }
 
@@ -204,8 +195,70 @@ void Connection::recordSentUnreliablePackets(int wireSize, int payloadSize) {
     _stats.recordUnreliableSentPackets(payloadSize, wireSize);
 }
 
-void Connection::recordReceivedUnreliablePackets(int wireSize, int payloadSize) {
-    _stats.recordUnreliableReceivedPackets(payloadSize, wireSize);
+bool Connection::processReceivedUnreliablePacket(const Packet& packet) {
+    _stats.recordUnreliableReceivedPackets(packet.getPayloadSize(), packet.getWireSize());
+
+    if (!_fecDecoder) {
+        return true;
+    }
+
+    if (!_hasReceivedFECParity) {
+        // our request, or the connection it set up on the other end, may be gone - keep asking until parity comes in
+        static const auto FEC_REQUEST_INTERVAL = seconds(1);
+        if (p_high_resolution_clock::now() - _lastFECRequestTime > FEC_REQUEST_INTERVAL) {
+            sendFECRequest();
+        }
+    }
+
+    FECDecoder::Datagrams recovered;
+    bool shouldProcess = _fecDecoder->addDatagram(packet.getSequenceNumber(), packet.getData(), packet.getDataSize(),
+                                                  recovered);
+    processRecoveredDatagrams(recovered);
+
+    return shouldProcess;
+}
+
+void Connection::requestFEC(int groupSize) {
+    if (groupSize > 0) {
+        _requestedFECGroupSize = std::min(std::max(groupSize, MIN_FEC_GROUP_SIZE), MAX_FEC_GROUP_SIZE);
+        if (!_fecDecoder) {
+            _fecDecoder.reset(new FECDecoder());
+        }
+    } else {
+        _requestedFECGroupSize = 0;
+        _fecDecoder.reset();
+    }
+
+    _hasReceivedFECParity = false;
+    sendFECRequest();
+}
+
+void Connection::sendFECRequest() {
+    static const int FEC_REQUEST_PAYLOAD_BYTES = sizeof(uint8_t);
+
+    auto fecRequestPacket = ControlPacket::create(ControlPacket::FECRequest, FEC_REQUEST_PAYLOAD_BYTES);
+    fecRequestPacket->writePrimitive((uint8_t)_requestedFECGroupSize);
+    _parentSocket->writeBasePacket(*fecRequestPacket, _destination);
+
+    _lastFECRequestTime = p_high_resolution_clock::now();
+}
+
+Connection::ControlPacketPointer Connection::protectUnreliablePacket(const Packet& packet) {
+    std::lock_guard<std::mutex> lock(_fecEncoderLock);
+
+    auto parityPacket = _fecEncoder.addDatagram(packet.getSequenceNumber(), packet.getData(), packet.getDataSize());
+    if (parityPacket) {
+        _stats.recordSentParityPackets(parityPacket->getWireSize());
+    }
+
+    return parityPacket;
+}
+
+void Connection::processRecoveredDatagrams(const FECDecoder::Datagrams& recovered) {
+    for (auto& datagram : recovered) {
+        _stats.recordRecoveredUnreliablePacket();
+        _parentSocket->processRecoveredDatagram(datagram, _destination);
+    }
 }
 
 void Connection::sendACK() {
@@ -317,6 +370,15 @@ void Connection::processControl(ControlPacketPointer controlPacket) {
                 stopSendQueue();
             }
             break;
+        case ControlPacket::FECRequest:
+            processFECRequest(move(controlPacket));
+            break;
+        case ControlPacket::FECParity:
+            processFECParity(move(controlPacket));
+            break;
+        default:
+            // from a newer peer, it'll do without our answer
+            break;
     }
 }
 
@@ -406,6 +468,45 @@ void Connection::processHandshakeACK(ControlPacketPointer controlPacket) {
     }
 }
 
+void Connection::processFECRequest(ControlPacketPointer controlPacket) {
+    uint8_t groupSize;
+    if (controlPacket->bytesLeftToRead() < (qint64)sizeof(groupSize)) {
+        return;
+    }
+    controlPacket->readPrimitive(&groupSize);
+
+    if (groupSize != 0 && (groupSize < MIN_FEC_GROUP_SIZE || groupSize > MAX_FEC_GROUP_SIZE)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_fecEncoderLock);
+
+    // requests are repeated until parity comes in, don't break up the group in progress for those
+    if (_fecEncoder.getGroupSize() != groupSize) {
+        if (groupSize > 0) {
+            qCDebug(networking) << "Sending parity every" << groupSize << "unreliable packets to" << _destination;
+        } else {
+            qCDebug(networking) << "No longer sending parity to" << _destination;
+        }
+        _fecEncoder.setGroupSize(groupSize);
+    }
+}
+
+void Connection::processFECParity(ControlPacketPointer controlPacket) {
+    _stats.recordReceivedParityPackets(controlPacket->getWireSize());
+
+    if (!_fecDecoder) {
+        // we didn't ask for this, or have since asked to stop
+        return;
+    }
+
+    _hasReceivedFECParity = true;
+
+    FECDecoder::Datagrams recovered;
+    _fecDecoder->addParity(*controlPacket, recovered);
+    processRecoveredDatagrams(recovered);
+}
+
 void Connection::resetReceiveState() {
     
     // reset all SequenceNumber member variables back to default
@@ -14,6 +14,7 @@
 
 #include <list>
 #include <memory>
+#include <mutex>
 
 #include <QtCore/QObject>
 
@@ -21,6 +22,7 @@
 
 #include "ConnectionStats.h"
 #include "Constants.h"
+#include "ForwardErrorCorrection.h"
 #include "LossList.h"
 #include "SendQueue.h"
 #include "../HifiSockAddr.h"
@@ -76,7 +78,17 @@ public:
     bool hasReceivedHandshake() const { return _hasReceivedHandshake; }
     
     void recordSentUnreliablePackets(int wireSize, int payloadSize);
-    void recordReceivedUnreliablePackets(int wireSize, int payloadSize);
+
+    // return indicates if this unreliable packet should be processed
+    bool processReceivedUnreliablePacket(const Packet& packet);
+
+    // asks the peer to follow every groupSize unreliable packets with their parity, 0 asks it to stop
+    void requestFEC(int groupSize);
+
+    // called with each unreliable packet once it has its sequence number, in sequence number order,
+    // returns the parity packet to send after it if that completed a group
+    ControlPacketPointer protectUnreliablePacket(const Packet& packet);
+
     void setDestinationAddress(const HifiSockAddr& destination);
 
 signals:
@@ -97,6 +109,11 @@ private:
     void processACK(ControlPacketPointer controlPacket);
     void processHandshake(ControlPacketPointer controlPacket);
     void processHandshakeACK(ControlPacketPointer controlPacket);
+    void processFECRequest(ControlPacketPointer controlPacket);
+    void processFECParity(ControlPacketPointer controlPacket);
+
+    void sendFECRequest();
+    void processRecoveredDatagrams(const FECDecoder::Datagrams& recovered);
     
     void resetReceiveState();
     
@@ -137,6 +154,16 @@ private:
     ControlPacketPointer _handshakeACK;
 
     ConnectionStats _stats;
+
+    // parity we send, written to by the threads sending unreliable packets
+    std::mutex _fecEncoderLock;
+    FECEncoder _fecEncoder;
+
+    // parity we asked for
+    int _requestedFECGroupSize { 0 };
+    bool _hasReceivedFECParity { false };
+    p_high_resolution_clock::time_point _lastFECRequestTime;
+    std::unique_ptr<FECDecoder> _fecDecoder;
 };
     
 }
@@ -82,6 +82,20 @@ void ConnectionStats::recordUnreliableReceivedPackets(int payload, int total) {
     _currentSample.receivedUnreliableBytes += total;
 }
 
+void ConnectionStats::recordSentParityPackets(int size) {
+    ++_currentSample.sentParityPackets;
+    recordUnreliableSentPackets(0, size);
+}
+
+void ConnectionStats::recordReceivedParityPackets(int size) {
+    ++_currentSample.receivedParityPackets;
+    recordUnreliableReceivedPackets(0, size);
+}
+
+void ConnectionStats::recordRecoveredUnreliablePacket() {
+    ++_currentSample.recoveredUnreliablePackets;
+}
+
 void ConnectionStats::recordCongestionWindowSize(int sample) {
     _currentSample.congestionWindowSize = sample;
 }
@@ -106,6 +120,9 @@ QDebug& operator<<(QDebug&& debug, const udt::ConnectionStats::Stats& stats) {
     debug << "\n     Duplicate packets: " << stats.duplicatePackets;
     debug << "\n     Sent util bytes: " << stats.sentUtilBytes;
     debug << "\n     Sent bytes: " << stats.sentBytes;
-    debug << "\n     Received bytes: " << stats.receivedBytes << "\n";
+    debug << "\n     Received bytes: " << stats.receivedBytes;
+    debug << "\n     Sent parity packets: " << stats.sentParityPackets;
+    debug << "\n     Received parity packets: " << stats.receivedParityPackets;
+    debug << "\n     Recovered unreliable packets: " << stats.recoveredUnreliablePackets << "\n";
     return debug;
 }
@@ -60,6 +60,11 @@ public:
         uint64_t receivedUnreliableUtilBytes { 0 };
         uint64_t sentUnreliableBytes { 0 };
         uint64_t receivedUnreliableBytes { 0 };
+
+        // forward error correction of unreliable packets
+        uint32_t sentParityPackets { 0 };
+        uint32_t receivedParityPackets { 0 };
+        uint32_t recoveredUnreliablePackets { 0 };
        
         // the following stats are trailing averages in the result, not totals
         int sendRate { 0 };
@@ -91,6 +96,10 @@ public:
     void recordUnreliableSentPackets(int payload, int total);
     void recordUnreliableReceivedPackets(int payload, int total);
 
+    void recordSentParityPackets(int size);
+    void recordReceivedParityPackets(int size);
+    void recordRecoveredUnreliablePacket();
+
     void recordCongestionWindowSize(int sample);
     void recordPacketSendPeriod(int sample);
     
@@ -99,8 +99,8 @@ void ControlPacket::readType() {
     
     Q_ASSERT_X(bitAndType & CONTROL_BIT_MASK, "ControlPacket::readHeader()", "This should be a control packet");
     
+    // types added by newer peers are read as they are, the connection ignores the ones it doesn't know
     uint16_t packetType = (bitAndType & ~CONTROL_BIT_MASK) >> (8 * sizeof(Type));
-    Q_ASSERT_X(packetType <= ControlPacket::Type::HandshakeRequest, "ControlPacket::readType()", "Received a control packet with wrong type");
     
     // read the type
     _type = (Type) packetType;
@@ -0,0 +1,203 @@
+//
+//  ForwardErrorCorrection.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ForwardErrorCorrection.h"
+
+#include <algorithm>
+
+#include "ControlPacket.h"
+
+using namespace udt;
+
+static const int PARITY_HEADER_SIZE = sizeof(SequenceNumber) + sizeof(uint8_t) + sizeof(uint16_t);
+
+static void xorInto(char* destination, const char* source, int size) {
+    for (int i = 0; i < size; ++i) {
+        destination[i] ^= source[i];
+    }
+}
+
+int FECEncoder::maxProtectedDatagramSize() {
+    return ControlPacket::maxPayloadSize() - PARITY_HEADER_SIZE;
+}
+
+void FECEncoder::setGroupSize(int groupSize) {
+    Q_ASSERT_X(groupSize == 0 || (groupSize >= MIN_FEC_GROUP_SIZE && groupSize <= MAX_FEC_GROUP_SIZE),
+               "FECEncoder::setGroupSize()", "Invalid group size");
+
+    _groupSize = groupSize;
+
+    // start over with the next datagram
+    _count = 0;
+}
+
+std::unique_ptr<ControlPacket> FECEncoder::addDatagram(SequenceNumber sequenceNumber, const char* data, int size) {
+    if (_groupSize == 0) {
+        return nullptr;
+    }
+
+    std::unique_ptr<ControlPacket> parityPacket;
+
+    if (size > maxProtectedDatagramSize()) {
+        // groups are consecutive datagrams, so this one ends the group without being part of it
+        if (_count >= MIN_FEC_GROUP_SIZE) {
+            parityPacket = finishGroup();
+        }
+        _count = 0;
+        return parityPacket;
+    }
+
+    if (_count == 0) {
+        _firstSequenceNumber = sequenceNumber;
+        _sizeParity = 0;
+        _paritySize = 0;
+        _parity.resize(maxProtectedDatagramSize());
+    }
+
+    // the bytes past the end of a datagram are zeros, that leaves the parity as is
+    if (size > _paritySize) {
+        std::fill(_parity.begin() + _paritySize, _parity.begin() + size, 0);
+        _paritySize = size;
+    }
+    xorInto(_parity.data(), data, size);
+    _sizeParity ^= (uint16_t)size;
+
+    if (++_count == _groupSize) {
+        parityPacket = finishGroup();
+        _count = 0;
+    }
+
+    return parityPacket;
+}
+
+std::unique_ptr<ControlPacket> FECEncoder::finishGroup() {
+    auto parityPacket = ControlPacket::create(ControlPacket::FECParity, PARITY_HEADER_SIZE + _paritySize);
+    parityPacket->writePrimitive(_firstSequenceNumber);
+    parityPacket->writePrimitive((uint8_t)_count);
+    parityPacket->writePrimitive(_sizeParity);
+    parityPacket->write(_parity.data(), _paritySize);
+    return parityPacket;
+}
+
+bool FECDecoder::addDatagram(SequenceNumber sequenceNumber, const char* data, int size, Datagrams& recovered) {
+    auto& datagram = _history[(uint32_t)sequenceNumber % HISTORY_SIZE];
+
+    if (datagram.isValid && datagram.sequenceNumber == sequenceNumber) {
+        // we have it already, only tell about the copies of the ones we recovered, the others go through as they did
+        return !datagram.wasRecovered;
+    }
+
+    datagram.sequenceNumber = sequenceNumber;
+    datagram.isValid = true;
+    datagram.wasRecovered = false;
+    datagram.size = size;
+    datagram.data.assign(data, data + size);
+
+    // this may be the one a parity was waiting for
+    for (auto& parity : _pendingParities) {
+        if (parity.count > 0 && seqoff(parity.firstSequenceNumber, sequenceNumber) >= 0
+            && seqoff(parity.firstSequenceNumber, sequenceNumber) < parity.count) {
+            if (tryRecovery(parity, recovered)) {
+                parity.count = 0;
+            }
+        }
+    }
+
+    return true;
+}
+
+void FECDecoder::addParity(ControlPacket& parityPacket, Datagrams& recovered) {
+    if (parityPacket.bytesLeftToRead() < PARITY_HEADER_SIZE) {
+        return;
+    }
+
+    SequenceNumber firstSequenceNumber;
+    uint8_t count;
+    uint16_t sizeParity;
+    parityPacket.readPrimitive(&firstSequenceNumber);
+    parityPacket.readPrimitive(&count);
+    parityPacket.readPrimitive(&sizeParity);
+
+    int paritySize = (int)parityPacket.bytesLeftToRead();
+    if (count < MIN_FEC_GROUP_SIZE || count > MAX_FEC_GROUP_SIZE || paritySize <= 0) {
+        return;
+    }
+
+    auto& parity = _pendingParities[_nextPendingParity];
+    parity.firstSequenceNumber = firstSequenceNumber;
+    parity.sizeParity = sizeParity;
+    parity.paritySize = paritySize;
+    parity.parity.resize(parity.paritySize);
+    parityPacket.read(parity.parity.data(), parity.paritySize);
+    parity.count = count;
+
+    if (tryRecovery(parity, recovered)) {
+        parity.count = 0;
+    } else {
+        // more than one is missing for now, keep it in case they come in late
+        _nextPendingParity = (_nextPendingParity + 1) % MAX_PENDING_PARITIES;
+    }
+}
+
+FECDecoder::ReceivedDatagram* FECDecoder::findDatagram(SequenceNumber sequenceNumber) {
+    auto& datagram = _history[(uint32_t)sequenceNumber % HISTORY_SIZE];
+    return datagram.isValid && datagram.sequenceNumber == sequenceNumber ? &datagram : nullptr;
+}
+
+bool FECDecoder::tryRecovery(PendingParity& parity, Datagrams& recovered) {
+    ReceivedDatagram* missingSlot = nullptr;
+    SequenceNumber missingSequenceNumber;
+    int missingCount = 0;
+
+    for (int i = 0; i < parity.count; ++i) {
+        auto sequenceNumber = parity.firstSequenceNumber + i;
+        if (!findDatagram(sequenceNumber)) {
+            auto& slot = _history[(uint32_t)sequenceNumber % HISTORY_SIZE];
+            if (slot.isValid && seqoff(sequenceNumber, slot.sequenceNumber) > 0) {
+                // newer datagrams took its place, too late to do anything for this group
+                return true;
+            }
+
+            missingSlot = &slot;
+            missingSequenceNumber = sequenceNumber;
+            ++missingCount;
+        }
+    }
+
+    if (missingCount != 1) {
+        // either nothing was lost, or this parity can't rebuild what was, yet
+        return missingCount == 0;
+    }
+
+    // the parity of everything we have and the group's parity is the datagram we don't have
+    uint16_t size = parity.sizeParity;
+    std::vector<char> data(parity.parity);
+    for (int i = 0; i < parity.count; ++i) {
+        auto datagram = findDatagram(parity.firstSequenceNumber + i);
+        if (datagram) {
+            size ^= (uint16_t)datagram->size;
+            xorInto(data.data(), datagram->data.data(), std::min(datagram->size, parity.paritySize));
+        }
+    }
+
+    if (size == 0 || size > parity.paritySize) {
+        // this doesn't add up, this parity wasn't for these datagrams
+        return true;
+    }
+
+    missingSlot->sequenceNumber = missingSequenceNumber;
+    missingSlot->isValid = true;
+    missingSlot->wasRecovered = true;
+    missingSlot->size = size;
+    missingSlot->data.assign(data.begin(), data.begin() + size);
+
+    recovered.emplace_back(data.data(), size);
+    return true;
+}
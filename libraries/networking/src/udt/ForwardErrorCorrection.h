@@ -0,0 +1,102 @@
+//
+//  ForwardErrorCorrection.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ForwardErrorCorrection_h
+#define hifi_ForwardErrorCorrection_h
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QByteArray>
+
+#include "SequenceNumber.h"
+
+namespace udt {
+
+class ControlPacket;
+
+// XOR parity over groups of consecutive unreliable datagrams. The parity of a group lets the receiver rebuild
+// any one datagram of it that was lost, without waiting for a re-transmission.
+//
+// The parity is sent as a FECParity control packet:
+//  - the sequence number of the first datagram of the group
+//  - the number of datagrams in the group (uint8_t)
+//  - the XOR of their sizes (uint16_t)
+//  - the XOR of their bytes, each padded with zeros to the size of the largest
+static const int MIN_FEC_GROUP_SIZE = 2;
+static const int MAX_FEC_GROUP_SIZE = 16;
+
+class FECEncoder {
+public:
+    // datagrams larger than this don't leave room for the parity header and aren't protected
+    static int maxProtectedDatagramSize();
+
+    void setGroupSize(int groupSize); // 0 turns parity off
+    int getGroupSize() const { return _groupSize; }
+
+    // adds a datagram that was just given the next unreliable sequence number,
+    // returns the parity packet once that completes a group
+    std::unique_ptr<ControlPacket> addDatagram(SequenceNumber sequenceNumber, const char* data, int size);
+
+private:
+    std::unique_ptr<ControlPacket> finishGroup();
+
+    int _groupSize { 0 };
+    SequenceNumber _firstSequenceNumber;
+    int _count { 0 };
+    uint16_t _sizeParity { 0 };
+    int _paritySize { 0 };
+    std::vector<char> _parity;
+};
+
+class FECDecoder {
+public:
+    using Datagrams = std::vector<QByteArray>;
+
+    // keeps a copy of a received datagram in case a parity needs it, and appends the datagrams that it let us recover
+    // returns false if this is a late copy of a datagram we already recovered
+    bool addDatagram(SequenceNumber sequenceNumber, const char* data, int size, Datagrams& recovered);
+
+    // appends the datagram that the parity let us recover, if any
+    void addParity(ControlPacket& parityPacket, Datagrams& recovered);
+
+private:
+    // the datagrams received last, by sequence number modulo the history size
+    static const int HISTORY_SIZE = 2 * MAX_FEC_GROUP_SIZE;
+    static const int MAX_PENDING_PARITIES = 4;
+
+    struct ReceivedDatagram {
+        SequenceNumber sequenceNumber;
+        bool isValid { false };
+        bool wasRecovered { false };
+        int size { 0 };
+        std::vector<char> data;
+    };
+
+    struct PendingParity {
+        SequenceNumber firstSequenceNumber;
+        int count { 0 };
+        uint16_t sizeParity { 0 };
+        int paritySize { 0 };
+        std::vector<char> parity;
+    };
+
+    ReceivedDatagram* findDatagram(SequenceNumber sequenceNumber);
+    bool tryRecovery(PendingParity& parity, Datagrams& recovered); // true when the parity has nothing left to give
+
+    std::array<ReceivedDatagram, HISTORY_SIZE> _history;
+    std::array<PendingParity, MAX_PENDING_PARITIES> _pendingParities;
+    int _nextPendingParity { 0 };
+};
+
+}
+
+#endif // hifi_ForwardErrorCorrection_h
@@ -11,154 +11,161 @@
 
 #include "LossList.h"
 
+#include <algorithm>
+
+#include <QtCore/QtAlgorithms>
+
 #include "ControlPacket.h"
 
 using namespace udt;
 using namespace std;
 
+static const int BITS_PER_WORD = 64;
+static const int MIN_RING_CAPACITY = 1024; // in sequence numbers, grows by doubling from there
+
+static uint64_t lowBits(int count) {
+    return count == BITS_PER_WORD ? ~0ULL : (1ULL << count) - 1;
+}
+
+template <typename F>
+void LossList::forEachWord(int offset, int count, F function) const {
+    // calls function with the index of each word the range touches and the mask of its bits in that word,
+    // until it returns false. The ring is a whole number of words, so no part of a range wraps inside a word.
+    uint32_t ringMask = (uint32_t)(_bits.size() * BITS_PER_WORD) - 1;
+    uint32_t position = (_head + offset) & ringMask;
+
+    while (count > 0) {
+        int shift = position % BITS_PER_WORD;
+        int bitCount = std::min(count, BITS_PER_WORD - shift);
+
+        if (!function(position / BITS_PER_WORD, lowBits(bitCount) << shift, shift, offset)) {
+            return;
+        }
+
+        position = (position + bitCount) & ringMask;
+        offset += bitCount;
+        count -= bitCount;
+    }
+}
+
+void LossList::clear() {
+    std::fill(_bits.begin(), _bits.end(), 0);
+    _head = 0;
+    _span = 0;
+    _length = 0;
+}
+
 void LossList::append(SequenceNumber seq) {
-    Q_ASSERT_X(_lossList.empty() || (_lossList.back().second < seq), "LossList::append(SequenceNumber)",
+    Q_ASSERT_X(isEmpty() || seqoff(_first, seq) >= _span, "LossList::append(SequenceNumber)",
                "SequenceNumber appended is not greater than the last SequenceNumber in the list");
-    
-    if (getLength() > 0 && _lossList.back().second + 1 == seq) {
-        ++_lossList.back().second;
-    } else {
-        _lossList.push_back(make_pair(seq, seq));
-    }
-    _length += 1;
+
+    insert(seq, seq);
 }
 
 void LossList::append(SequenceNumber start, SequenceNumber end) {
-    Q_ASSERT_X(_lossList.empty() || (_lossList.back().second < start),
+    Q_ASSERT_X(isEmpty() || seqoff(_first, start) >= _span,
                "LossList::append(SequenceNumber, SequenceNumber)",
                "SequenceNumber range appended is not greater than the last SequenceNumber in the list");
     Q_ASSERT_X(start <= end,
                "LossList::append(SequenceNumber, SequenceNumber)", "Range start greater than range end");
 
-    if (getLength() > 0 && _lossList.back().second + 1 == start) {
-        _lossList.back().second = end;
-    } else {
-        _lossList.push_back(make_pair(start, end));
-    }
-    _length += seqlen(start, end);
+    insert(start, end);
 }
 
 void LossList::insert(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::insert(SequenceNumber, SequenceNumber)", "Range start greater than range end");
-    
-    auto it = find_if_not(_lossList.begin(), _lossList.end(), [&start](pair<SequenceNumber, SequenceNumber> pair){
-        return pair.second < start;
-    });
-    
-    if (it == _lossList.end() || end < it->first) {
-        // No overlap, simply insert
-        _length += seqlen(start, end);
-        _lossList.insert(it, make_pair(start, end));
-    } else {
-        // If it starts before segment, extend segment
-        if (start < it->first) {
-            _length += seqlen(start, it->first - 1);
-            it->first = start;
-        }
-        
-        // If it ends after segment, extend segment
-        if (end > it->second) {
-            _length += seqlen(it->second + 1, end);
-            it->second = end;
-        }
-        
-        auto it2 = it;
-        ++it2;
-        // For all ranges touching the current range
-        while (it2 != _lossList.end() && it->second >= it2->first - 1) {
-            // extend current range if necessary
-            if (it->second < it2->second) {
-                _length += seqlen(it->second + 1, it2->second);
-                it->second = it2->second;
-            }
-            
-            // Remove overlapping range
-            _length -= seqlen(it2->first, it2->second);
-            it2 = _lossList.erase(it2);
-        }
+
+    if (isEmpty()) {
+        _first = start;
+        _span = 0;
     }
+
+    int from = seqoff(_first, start);
+    int to = seqoff(_first, end) + 1;
+    reserve(std::max(_span, to) - std::min(from, 0));
+
+    if (from < 0) {
+        // this is before the first loss, move the start of the ring back to it
+        uint32_t ringMask = (uint32_t)(_bits.size() * BITS_PER_WORD) - 1;
+        _head = (_head - (uint32_t)(-from)) & ringMask;
+        _first = start;
+        _span -= from;
+        to -= from;
+        from = 0;
+    }
+
+    forEachWord(from, to - from, [&](size_t index, uint64_t mask, int shift, int offset) {
+        _length += (int)qPopulationCount(mask & ~_bits[index]);
+        _bits[index] |= mask;
+        return true;
+    });
+    _span = std::max(_span, to);
 }
 
 bool LossList::remove(SequenceNumber seq) {
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&seq](pair<SequenceNumber, SequenceNumber> pair) {
-        return pair.first <= seq && seq <= pair.second;
-    });
-    
-    if (it != end(_lossList)) {
-        if (it->first == it->second) {
-            _lossList.erase(it);
-        } else if (seq == it->first) {
-            ++it->first;
-        } else if (seq == it->second) {
-            --it->second;
-        } else {
-            auto temp = it->second;
-            it->second = seq - 1;
-            _lossList.insert(++it, make_pair(seq + 1, temp));
-        }
-        _length -= 1;
-        
-        // this sequence number was found in the loss list, return true
-        return true;
-    } else {
+    if (isEmpty()) {
+        return false;
+    }
+
+    int offset = seqoff(_first, seq);
+    if (offset < 0 || offset >= _span) {
+        return false;
+    }
+
+    uint32_t ringMask = (uint32_t)(_bits.size() * BITS_PER_WORD) - 1;
+    uint32_t position = (_head + offset) & ringMask;
+    uint64_t bit = 1ULL << (position % BITS_PER_WORD);
+    auto& word = _bits[position / BITS_PER_WORD];
+
+    if (!(word & bit)) {
         // this sequence number was not found in the loss list, return false
         return false;
     }
+
+    word &= ~bit;
+    _length -= 1;
+
+    if (offset == 0) {
+        trimFront();
+    } else if (offset == _span - 1) {
+        trimBack();
+    }
+
+    // this sequence number was found in the loss list, return true
+    return true;
 }
 
 void LossList::remove(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::remove(SequenceNumber, SequenceNumber)", "Range start greater than range end");
-    // Find the first segment sharing sequence numbers
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&start, &end](pair<SequenceNumber, SequenceNumber> pair) {
-        return (pair.first <= start && start <= pair.second) || (start <= pair.first && pair.first <= end);
+
+    if (isEmpty()) {
+        return;
+    }
+
+    int from = std::max(seqoff(_first, start), 0);
+    int to = std::min(seqoff(_first, end) + 1, _span);
+    if (from >= to) {
+        return;
+    }
+
+    forEachWord(from, to - from, [&](size_t index, uint64_t mask, int shift, int offset) {
+        _length -= (int)qPopulationCount(_bits[index] & mask);
+        _bits[index] &= ~mask;
+        return true;
     });
-    
-    // If we found one
-    if (it != _lossList.end()) {
-        
-        // While the end of the current segment is contained, either shorten it (first one only - sometimes)
-        // or remove it altogether since it is fully contained it the range
-        while (it != _lossList.end() && end >= it->second) {
-            if (start <= it->first) {
-                // Segment is contained, update new length and erase it.
-                _length -= seqlen(it->first, it->second);
-                it = _lossList.erase(it);
-            } else {
-                // Beginning of segment not contained, modify end of segment.
-                // Will only occur sometimes one the first loop
-                _length -= seqlen(start, it->second);
-                it->second = start - 1;
-                ++it;
-            }
-        }
-        
-        // There might be more to remove
-        if (it != _lossList.end() && it->first <= end) {
-            if (start <= it->first) {
-                // Truncate beginning of segment
-                _length -= seqlen(it->first, end);
-                it->first = end + 1;
-            } else {
-                // Cut it in half if the range we are removing is contained within one segment
-                _length -= seqlen(start, end);
-                auto temp = it->second;
-                it->second = start - 1;
-                _lossList.insert(++it, make_pair(end + 1, temp));
-            }
-        }
+
+    if (from == 0) {
+        trimFront();
+    } else if (to == _span) {
+        trimBack();
     }
 }
 
 SequenceNumber LossList::getFirstSequenceNumber() const {
     Q_ASSERT_X(getLength() > 0, "LossList::getFirstSequenceNumber()", "Trying to get first element of an empty list");
-    return _lossList.front().first;
+    return _first;
 }
 
 SequenceNumber LossList::popFirstSequenceNumber() {
@@ -169,16 +176,106 @@ SequenceNumber LossList::popFirstSequenceNumber() {
 
 void LossList::write(ControlPacket& packet, int maxPairs) {
     int writtenPairs = 0;
-    
-    for (const auto& pair : _lossList) {
-        packet.writePrimitive(pair.first);
-        packet.writePrimitive(pair.second);
-        
+
+    int start = find(0, _span, true);
+    while (start != -1) {
+        int end = find(start, _span, false);
+        if (end == -1) {
+            end = _span;
+        }
+
+        packet.writePrimitive(_first + start);
+        packet.writePrimitive(_first + (end - 1));
+
         ++writtenPairs;
-        
+
         // check if we've written the maximum number we were told to write
         if (maxPairs != -1 && writtenPairs >= maxPairs) {
             break;
         }
+
+        start = find(end, _span, true);
+    }
+}
+
+int LossList::find(int from, int to, bool isSet) const {
+    int result = -1;
+    if (from >= to) {
+        return result;
     }
+
+    forEachWord(from, to - from, [&](size_t index, uint64_t mask, int shift, int offset) {
+        uint64_t word = (isSet ? _bits[index] : ~_bits[index]) & mask;
+        if (word) {
+            result = offset + (int)qCountTrailingZeroBits(word) - shift;
+            return false;
+        }
+        return true;
+    });
+    return result;
+}
+
+int LossList::findLast(int from, int to) const {
+    uint32_t ringMask = (uint32_t)(_bits.size() * BITS_PER_WORD) - 1;
+
+    // walk back a word at a time from the end
+    while (to > from) {
+        uint32_t position = (_head + to - 1) & ringMask;
+        int shift = position % BITS_PER_WORD;
+        int bitCount = std::min(to - from, shift + 1);
+
+        uint64_t word = _bits[position / BITS_PER_WORD] & (lowBits(bitCount) << (shift + 1 - bitCount));
+        if (word) {
+            int highestBit = BITS_PER_WORD - 1 - (int)qCountLeadingZeroBits(word);
+            return to - 1 - (shift - highestBit);
+        }
+
+        to -= bitCount;
+    }
+    return -1;
+}
+
+void LossList::reserve(int span) {
+    int capacity = (int)_bits.size() * BITS_PER_WORD;
+    if (span <= capacity) {
+        return;
+    }
+
+    int newCapacity = std::max(capacity, MIN_RING_CAPACITY);
+    while (newCapacity < span) {
+        newCapacity *= 2;
+    }
+
+    // unroll the ring into the new one, so that the first loss is at the start
+    std::vector<uint64_t> bits(newCapacity / BITS_PER_WORD, 0);
+    forEachWord(0, _span, [&](size_t index, uint64_t mask, int shift, int offset) {
+        uint64_t chunk = (_bits[index] & mask) >> shift;
+        int newShift = offset % BITS_PER_WORD;
+        bits[offset / BITS_PER_WORD] |= chunk << newShift;
+        if (newShift != 0 && (chunk >> (BITS_PER_WORD - newShift)) != 0) {
+            bits[offset / BITS_PER_WORD + 1] |= chunk >> (BITS_PER_WORD - newShift);
+        }
+        return true;
+    });
+
+    _bits.swap(bits);
+    _head = 0;
+}
+
+void LossList::trimFront() {
+    if (isEmpty()) {
+        _span = 0;
+        return;
+    }
+
+    // the ring now starts at the next loss
+    int next = find(0, _span, true);
+    uint32_t ringMask = (uint32_t)(_bits.size() * BITS_PER_WORD) - 1;
+    _head = (_head + next) & ringMask;
+    _first = _first + next;
+    _span -= next;
+}
+
+void LossList::trimBack() {
+    _span = isEmpty() ? 0 : findLast(0, _span) + 1;
 }
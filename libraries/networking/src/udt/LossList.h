@@ -12,42 +12,58 @@
 #ifndef hifi_LossList_h
 #define hifi_LossList_h
 
-#include <list>
+#include <cstdint>
+#include <vector>
 
 #include "SequenceNumber.h"
 
 namespace udt {
 
 class ControlPacket;
-    
+
+// Lost sequence numbers, as one bit per sequence number in a ring that starts at the first loss.
+// Adding, removing and looking up a sequence number is O(1), ranges cost one operation per 64 sequence numbers,
+// and nothing is allocated once the ring is as large as the spread of the losses.
 class LossList {
 public:
     LossList() {}
-    
-    void clear() { _length = 0; _lossList.clear(); }
-    
-    // must always add at the end - faster than insert
+
+    void clear();
+
+    // must always add at the end
     void append(SequenceNumber seq);
     void append(SequenceNumber start, SequenceNumber end);
-    
-    // inserts anywhere - MUCH slower
+
+    // inserts anywhere
     void insert(SequenceNumber start, SequenceNumber end);
-    
+
     bool remove(SequenceNumber seq);
     void remove(SequenceNumber start, SequenceNumber end);
-    
+
     int getLength() const { return _length; }
     bool isEmpty() const { return _length == 0; }
     SequenceNumber getFirstSequenceNumber() const;
     SequenceNumber popFirstSequenceNumber();
-    
+
     void write(ControlPacket& packet, int maxPairs = -1);
-    
+
 private:
-    std::list<std::pair<SequenceNumber, SequenceNumber>> _lossList;
+    // offsets are relative to _first, bit i of the ring is for _first + i and lives at ring position _head + i
+    template <typename F> void forEachWord(int offset, int count, F function) const;
+    int find(int from, int to, bool isSet) const; // first offset in [from, to) with the bit set or cleared, or -1
+    int findLast(int from, int to) const; // last offset in [from, to) with the bit set, or -1
+
+    void reserve(int span);
+    void trimFront();
+    void trimBack();
+
+    std::vector<uint64_t> _bits; // the ring, every bit outside of [0, _span) is cleared
+    uint32_t _head { 0 }; // ring position of _first
+    SequenceNumber _first; // first lost sequence number, when not empty
+    int _span { 0 }; // offset after the last lost sequence number
     int _length { 0 };
 };
-    
+
 }
 
 #endif // hifi_LossList_h
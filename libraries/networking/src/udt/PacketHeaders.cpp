@@ -27,7 +27,9 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::StunResponse:
             return 17;
         case PacketType::DomainList:
-            return static_cast<PacketVersion>(DomainListVersion::HasConnectReason);
+            return static_cast<PacketVersion>(DomainListVersion::HasListVersions);
+        case PacketType::DomainListRequest:
+            return static_cast<PacketVersion>(DomainListRequestVersion::HasAckedListVersion);
         case PacketType::EntityAdd:
         case PacketType::EntityClone:
         case PacketType::EntityEdit:
@@ -43,7 +45,7 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::KillAvatar:
             return static_cast<PacketVersion>(AvatarMixerPacketVersion::ARKitBlendshapes);
         case PacketType::MessagesData:
-            return static_cast<PacketVersion>(MessageDataVersion::TextOrBinaryData);
+            return static_cast<PacketVersion>(MessageDataVersion::CoalescedMessages);
         // ICE packets
         case PacketType::ICEServerPeerInformation:
             return 17;
@@ -64,7 +66,10 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::AssetGetInfo:
         case PacketType::AssetGet:
         case PacketType::AssetUpload:
-            return static_cast<PacketVersion>(AssetServerPacketVersion::BakingTextureMeta);
+        case PacketType::AssetChunkQuery:
+        case PacketType::AssetChunkQueryReply:
+        case PacketType::AssetUploadChunked:
+            return static_cast<PacketVersion>(AssetServerPacketVersion::SmallAssetsInManifestReply);
         case PacketType::NodeIgnoreRequest:
             return 18; // Introduction of node ignore request (which replaced an unused packet tpye)
 
@@ -75,7 +80,7 @@ PacketVersion versionForPacketType(PacketType packetType) {
             return static_cast<PacketVersion>(DomainConnectRequestVersion::HasCompressedSystemInfo);
 
         case PacketType::DomainServerAddedNode:
-            return static_cast<PacketVersion>(DomainServerAddedNodeVersion::PermissionsGrid);
+            return static_cast<PacketVersion>(DomainServerAddedNodeVersion::HasAuthMethod);
 
         case PacketType::EntityScriptCallMethod:
             return static_cast<PacketVersion>(EntityScriptCallMethodVersion::ClientCallable);
@@ -91,7 +96,7 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::DomainSettings:
             return 18;  // replace min_avatar_scale and max_avatar_scale with min_avatar_height and max_avatar_height
         case PacketType::Ping:
-            return static_cast<PacketVersion>(PingVersion::IncludeConnectionID);
+            return static_cast<PacketVersion>(PingVersion::SupportsFEC);
         case PacketType::AvatarQuery:
             return static_cast<PacketVersion>(AvatarQueryVersion::ConicalFrustums);
         case PacketType::EntityQueryInitialResultsComplete:
@@ -136,6 +136,9 @@ public:
         BulkAvatarTraitsAck,
         StopInjector,
         AvatarZonePresence,
+        AssetChunkQuery,
+        AssetChunkQueryReply,
+        AssetUploadChunked,
         NUM_PACKET_TYPE
     };
 
@@ -195,7 +198,9 @@ public:
         const static QSet<PacketTypeEnum::Value> DOMAIN_SOURCED_PACKETS = QSet<PacketTypeEnum::Value>()
             << PacketTypeEnum::Value::AssetMappingOperation
             << PacketTypeEnum::Value::AssetGet
-            << PacketTypeEnum::Value::AssetUpload;
+            << PacketTypeEnum::Value::AssetUpload
+            << PacketTypeEnum::Value::AssetChunkQuery
+            << PacketTypeEnum::Value::AssetUploadChunked;
         return DOMAIN_SOURCED_PACKETS;
     }
 
@@ -203,7 +208,8 @@ public:
         const static QSet<PacketTypeEnum::Value> DOMAIN_IGNORED_VERIFICATION_PACKETS = QSet<PacketTypeEnum::Value>()
             << PacketTypeEnum::Value::AssetMappingOperationReply
             << PacketTypeEnum::Value::AssetGetReply
-            << PacketTypeEnum::Value::AssetUploadReply;
+            << PacketTypeEnum::Value::AssetUploadReply
+            << PacketTypeEnum::Value::AssetChunkQueryReply;
         return DOMAIN_IGNORED_VERIFICATION_PACKETS;
     }
 };
@@ -301,7 +307,9 @@ enum class AssetServerPacketVersion: PacketVersion {
     VegasCongestionControl = 19,
     RangeRequestSupport,
     RedirectedMappings,
-    BakingTextureMeta
+    BakingTextureMeta,
+    ChunkedTransfer,
+    SmallAssetsInManifestReply
 };
 
 enum class AvatarMixerPacketVersion : PacketVersion {
@@ -366,7 +374,8 @@ enum class DomainConnectionDeniedVersion : PacketVersion {
 
 enum class DomainServerAddedNodeVersion : PacketVersion {
     PrePermissionsGrid = 17,
-    PermissionsGrid
+    PermissionsGrid,
+    HasAuthMethod
 };
 
 enum class DomainListVersion : PacketVersion {
@@ -376,7 +385,14 @@ enum class DomainListVersion : PacketVersion {
     GetMachineFingerprintFromUUIDSupport,
     AuthenticationOptional,
     HasTimestamp,
-    HasConnectReason
+    HasConnectReason,
+    HasAuthMethod,
+    HasListVersions
+};
+
+enum class DomainListRequestVersion : PacketVersion {
+    PreAckedListVersion = 22,
+    HasAckedListVersion
 };
 
 enum class AudioVersion : PacketVersion {
@@ -391,7 +407,8 @@ enum class AudioVersion : PacketVersion {
 };
 
 enum class MessageDataVersion : PacketVersion {
-    TextOrBinaryData = 18
+    TextOrBinaryData = 18,
+    CoalescedMessages
 };
 
 enum class IcePingVersion : PacketVersion {
@@ -399,7 +416,8 @@ enum class IcePingVersion : PacketVersion {
 };
 
 enum class PingVersion : PacketVersion {
-    IncludeConnectionID = 18
+    IncludeConnectionID = 18,
+    SupportsFEC
 };
 
 enum class AvatarQueryVersion : PacketVersion {
@@ -49,8 +49,17 @@ PacketList::PacketList(PacketList&& other) :
     _packets(std::move(other._packets)),
     _isOrdered(other._isOrdered),
     _isReliable(other._isReliable),
-    _extendedHeader(std::move(other._extendedHeader))
+    _extendedHeader(std::move(other._extendedHeader)),
+    _segmentSentCallback(std::move(other._segmentSentCallback))
 {
+    other._segmentSentCallback = nullptr;
+}
+
+PacketList::~PacketList() {
+    // a list that never made it to a send queue was dropped
+    if (_segmentSentCallback) {
+        _segmentSentCallback(false);
+    }
 }
 
 HifiSockAddr PacketList::getSenderSockAddr() const {
@@ -65,6 +74,19 @@ void PacketList::endSegment() {
     _segmentStartIndex = -1;
 }
 
+void PacketList::continueMessageIn(PacketList& nextSegment) {
+    Q_ASSERT_X(_isOrdered && nextSegment._isOrdered, "PacketList::continueMessageIn",
+               "Only ordered PacketLists can be sent in segments");
+
+    if (!_messageSegments) {
+        _messageSegments = std::make_shared<MessageSegments>();
+    }
+    closeCurrentPacket();
+    _isLastSegment = false;
+
+    nextSegment._messageSegments = _messageSegments;
+}
+
 size_t PacketList::getDataSize() const {
     size_t totalBytes = 0;
     for (const auto& packet : _packets) {
@@ -143,19 +165,29 @@ QByteArray PacketList::getMessage() const {
 
 void PacketList::preparePackets(MessageNumber messageNumber) {
     Q_ASSERT(_packets.size() > 0);
-    
-    if (_packets.size() == 1) {
-        _packets.front()->writeMessageNumber(messageNumber, Packet::PacketPosition::ONLY, 0);
-    } else {
-        const auto second = ++_packets.begin();
-        const auto last = --_packets.end();
-        Packet::MessagePartNumber messagePartNumber = 0;
-        std::for_each(second, last, [&](const PacketPointer& packet) {
-            packet->writeMessageNumber(messageNumber, Packet::PacketPosition::MIDDLE, ++messagePartNumber);
-        });
-        
-        _packets.front()->writeMessageNumber(messageNumber, Packet::PacketPosition::FIRST, 0);
-        _packets.back()->writeMessageNumber(messageNumber, Packet::PacketPosition::LAST, ++messagePartNumber);
+
+    // a segment carries on the part numbers of the one before it, only the first and last segments hold
+    // the first and last packets of the message
+    Packet::MessagePartNumber messagePartNumber = _messageSegments ? _messageSegments->nextPartNumber : 0;
+    const bool hasFirstPacket = messagePartNumber == 0;
+    const auto last = --_packets.end();
+    for (auto it = _packets.begin(); it != _packets.end(); ++it) {
+        bool isFirst = hasFirstPacket && it == _packets.begin();
+        bool isLast = _isLastSegment && it == last;
+
+        Packet::PacketPosition position = Packet::PacketPosition::MIDDLE;
+        if (isFirst && isLast) {
+            position = Packet::PacketPosition::ONLY;
+        } else if (isFirst) {
+            position = Packet::PacketPosition::FIRST;
+        } else if (isLast) {
+            position = Packet::PacketPosition::LAST;
+        }
+        (*it)->writeMessageNumber(messageNumber, position, messagePartNumber++);
+    }
+
+    if (_messageSegments) {
+        _messageSegments->nextPartNumber = messagePartNumber;
     }
 }
 
@@ -12,6 +12,7 @@
 #ifndef hifi_PacketList_h
 #define hifi_PacketList_h
 
+#include <functional>
 #include <memory>
 
 #include "../ExtendedIODevice.h"
@@ -29,10 +30,13 @@ class PacketList : public ExtendedIODevice {
 public:
     using MessageNumber = uint32_t;
     using PacketPointer = std::unique_ptr<Packet>;
+    using SegmentSentCallback = std::function<void(bool sent)>;
     
     static std::unique_ptr<PacketList> create(PacketType packetType, QByteArray extendedHeader = QByteArray(),
                                               bool isReliable = false, bool isOrdered = false);
     static std::unique_ptr<PacketList> fromReceivedPackets(std::list<std::unique_ptr<Packet>>&& packets);
+
+    virtual ~PacketList();
     
     PacketType getType() const { return _packetType; }
     bool isReliable() const { return _isReliable; }
@@ -48,6 +52,14 @@ public:
     void startSegment();
     void endSegment();
 
+    // Ends this ordered list as one segment of a longer message, continued in nextSegment, so that a message
+    // too large to hold in memory can be written and sent a segment at a time.
+    // The segments must be sent in order to the same destination, and the last one must not be empty.
+    void continueMessageIn(PacketList& nextSegment);
+    // Called once, with true when the last packet of this reliable list has been taken off the send queue,
+    // or with false when the list is dropped before that, as it is when its connection goes away
+    void setSegmentSentCallback(SegmentSentCallback callback) { _segmentSentCallback = std::move(callback); }
+
     virtual qint64 getMaxSegmentSize() const { return Packet::maxPayloadSize(_isOrdered); }
 
     HifiSockAddr getSenderSockAddr() const;
@@ -96,6 +108,16 @@ private:
     
     Packet::MessageNumber _messageNumber;
     bool _isReliable = false;
+
+    // shared by the segments of a message, only touched by the send queue once they're sent
+    struct MessageSegments {
+        bool hasMessageNumber { false };
+        MessageNumber messageNumber { 0 };
+        Packet::MessagePartNumber nextPartNumber { 0 };
+    };
+    std::shared_ptr<MessageSegments> _messageSegments;
+    SegmentSentCallback _segmentSentCallback;
+    bool _isLastSegment = true;
     
     std::unique_ptr<Packet> _currentPacket;
     
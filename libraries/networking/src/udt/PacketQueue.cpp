@@ -16,7 +16,7 @@
 using namespace udt;
 
 PacketQueue::PacketQueue(MessageNumber messageNumber) : _currentMessageNumber(messageNumber) {
-    _channels.emplace_front(new std::list<PacketPointer>());
+    _channels.emplace_front(new RawChannel());
     _currentChannel = _channels.begin();
 }
 
@@ -30,10 +30,27 @@ bool PacketQueue::isEmpty() const {
     LockGuard locker(_packetsLock);
 
     // Only the main channel and it is empty
-    return _channels.size() == 1 && _channels.front()->empty();
+    return _channels.size() == 1 && _channels.front()->packets.empty();
+}
+
+PacketQueue::RawChannel::~RawChannel() {
+    // still holding packets, the channel was dropped with its queue
+    if (segmentSent) {
+        segmentSent(false);
+    }
 }
 
 PacketQueue::PacketPointer PacketQueue::takePacket() {
+    // called once out of the lock, the sender may queue the next segment of its message from it
+    SegmentSentCallback segmentSent;
+    PacketPointer packet = takePacket(segmentSent);
+    if (segmentSent) {
+        segmentSent(true);
+    }
+    return packet;
+}
+
+PacketQueue::PacketPointer PacketQueue::takePacket(SegmentSentCallback& segmentSent) {
     LockGuard locker(_packetsLock);
 
     if (isEmpty()) {
@@ -41,7 +58,7 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
     }
 
     // handle the case where we are looking at the first channel and it is empty
-    if (_currentChannel == _channels.begin() && (*_currentChannel)->empty()) {
+    if (_currentChannel == _channels.begin() && (*_currentChannel)->packets.empty()) {
         ++_currentChannel;
     }
 
@@ -50,14 +67,15 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
 
     auto& channel = *_currentChannel;
 
-    Q_ASSERT(!channel->empty());
+    Q_ASSERT(!channel->packets.empty());
 
     // Take front packet
-    auto packet = std::move(channel->front());
-    channel->pop_front();
+    auto packet = std::move(channel->packets.front());
+    channel->packets.pop_front();
 
     // Remove now empty channel (Don't remove the main channel)
-    if (channel->empty() && _currentChannel != _channels.begin()) {
+    if (channel->packets.empty() && _currentChannel != _channels.begin()) {
+        segmentSent.swap(channel->segmentSent);
         // erase the current channel and slide the iterator to the next channel
         _currentChannel = _channels.erase(_currentChannel);
     } else {
@@ -81,15 +99,26 @@ PacketQueue::PacketPointer PacketQueue::takePacket() {
 
 void PacketQueue::queuePacket(PacketPointer packet) {
     LockGuard locker(_packetsLock);
-    _channels.front()->push_back(std::move(packet));
+    _channels.front()->packets.push_back(std::move(packet));
 }
 
 void PacketQueue::queuePacketList(PacketListPointer packetList) {
     if (packetList->isOrdered()) {
-        packetList->preparePackets(getNextMessageNumber());
+        auto& messageSegments = packetList->_messageSegments;
+        if (!messageSegments) {
+            packetList->preparePackets(getNextMessageNumber());
+        } else {
+            // every segment of a message goes out under the number given to the first one
+            if (!messageSegments->hasMessageNumber) {
+                messageSegments->messageNumber = getNextMessageNumber();
+                messageSegments->hasMessageNumber = true;
+            }
+            packetList->preparePackets(messageSegments->messageNumber);
+        }
     }
 
     LockGuard locker(_packetsLock);
-    _channels.emplace_back(new std::list<PacketPointer>());
-    _channels.back()->swap(packetList->_packets);
+    _channels.emplace_back(new RawChannel());
+    _channels.back()->packets.swap(packetList->_packets);
+    _channels.back()->segmentSent.swap(packetList->_segmentSentCallback);
 }
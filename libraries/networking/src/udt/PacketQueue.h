@@ -12,6 +12,7 @@
 #ifndef hifi_PacketQueue_h
 #define hifi_PacketQueue_h
 
+#include <functional>
 #include <list>
 #include <vector>
 #include <memory>
@@ -30,7 +31,12 @@ class PacketQueue {
     using LockGuard = std::lock_guard<Mutex>;
     using PacketPointer = std::unique_ptr<Packet>;
     using PacketListPointer = std::unique_ptr<PacketList>;
-    using RawChannel = std::list<PacketPointer>;
+    using SegmentSentCallback = std::function<void(bool sent)>;
+    struct RawChannel {
+        ~RawChannel();
+        std::list<PacketPointer> packets;
+        SegmentSentCallback segmentSent; // the sent callback of the packet list this channel was queued from
+    };
     using Channel = std::unique_ptr<RawChannel>;
     using Channels = std::list<Channel>;
     
@@ -48,6 +54,7 @@ public:
     
 private:
     MessageNumber getNextMessageNumber();
+    PacketPointer takePacket(SegmentSentCallback& segmentSent);
 
     MessageNumber _currentMessageNumber { 0 };
     
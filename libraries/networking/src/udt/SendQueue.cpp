@@ -12,12 +12,9 @@
 #include "SendQueue.h"
 
 #include <algorithm>
-#include <thread>
 
-#include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtCore/QJsonObject>
-#include <QtCore/QThread>
 
 #include <LogHandler.h>
 #include <NumericalConstants.h>
@@ -28,6 +25,7 @@
 #include "Packet.h"
 #include "PacketList.h"
 #include "../UserActivityLogger.h"
+#include "SendScheduler.h"
 #include "Socket.h"
 #include <Trace.h>
 #include <Profile.h>
@@ -71,19 +69,8 @@ std::unique_ptr<SendQueue> SendQueue::create(Socket* socket, HifiSockAddr destin
     auto queue = std::unique_ptr<SendQueue>(new SendQueue(socket, destination, currentSequenceNumber,
                                                           currentMessageNumber, hasReceivedHandshakeACK));
 
-    // Setup queue private thread
-    QThread* thread = new QThread;
-    thread->setObjectName("Networking: SendQueue " + destination.objectName()); // Name thread for easier debug
-    
-    connect(thread, &QThread::started, queue.get(), &SendQueue::run);
-    
-    connect(queue.get(), &QObject::destroyed, thread, &QThread::quit); // Thread auto cleanup
-    connect(thread, &QThread::finished, thread, &QThread::deleteLater); // Thread auto cleanup
-    
-    // Move queue to private thread and start it
-    queue->moveToThread(thread);
-    
-    thread->start();
+    // Hand the queue to one of the shared pacing threads, it starts with the handshake
+    SendScheduler::getInstance().add(queue.get());
     
     return queue;
 }
@@ -103,41 +90,38 @@ SendQueue::SendQueue(Socket* socket, HifiSockAddr dest, SequenceNumber currentSe
 }
 
 SendQueue::~SendQueue() {
+    // waits for a service step in progress on the pacing thread
+    SendScheduler::getInstance().remove(this);
+}
+
+void SendQueue::wakeIfWaiting() {
+    // the pacing thread publishes _isWaitingForWork before it looks at the queues, so either it sees our change
+    // or we see that it's waiting
+    if (_isWaitingForWork) {
+        SendScheduler::getInstance().wake(this);
+    }
 }
 
 void SendQueue::queuePacket(std::unique_ptr<Packet> packet) {
     _packets.queuePacket(std::move(packet));
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for packets
-    _emptyCondition.notify_one();
-    
-    if (!thread()->isRunning() && _state == State::NotStarted) {
-        thread()->start();
-    }
+    // wake the queue in case it is waiting for packets
+    wakeIfWaiting();
 }
 
 void SendQueue::queuePacketList(std::unique_ptr<PacketList> packetList) {
     _packets.queuePacketList(std::move(packetList));
     
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for packets
-    _emptyCondition.notify_one();
-    
-    if (!thread()->isRunning() && _state == State::NotStarted) {
-        thread()->start();
-    }
+    // wake the queue in case it is waiting for packets
+    wakeIfWaiting();
 }
 
 void SendQueue::stop() {
-    
     _state = State::Stopped;
-    
-    // Notify all conditions in case we're waiting somewhere
-    _handshakeACKCondition.notify_one();
-    _emptyCondition.notify_one();
 }
     
 int SendQueue::sendPacket(const Packet& packet) {
-    _lastPacketSentAt = std::chrono::high_resolution_clock::now();
+    _lastPacketSentAt = Clock::now();
     return _socket->writeDatagram(packet.getData(), packet.getDataSize(), _destination);
 }
     
@@ -159,28 +143,32 @@ void SendQueue::ack(SequenceNumber ack) {
         
         if (!_naks.isEmpty() && _naks.getFirstSequenceNumber() <= ack) {
             _naks.remove(_naks.getFirstSequenceNumber(), ack);
+            _hasNAKs = !_naks.isEmpty();
         }
     }
     
     _lastACKSequenceNumber = (uint32_t) ack;
 
-    // call notify_one on the condition_variable_any in case the send thread is sleeping with a full congestion window
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting with a full congestion window
+    wakeIfWaiting();
 }
 
 void SendQueue::fastRetransmit(udt::SequenceNumber ack) {
     {
         std::lock_guard<std::mutex> nakLocker(_naksLock);
         _naks.insert(ack, ack);
+        _hasNAKs = true;
     }
 
-    // call notify_one on the condition_variable_any in case the send thread is sleeping waiting for losses to re-send
-    _emptyCondition.notify_one();
+    // wake the queue in case it is waiting for losses to re-send
+    wakeIfWaiting();
 }
 
-void SendQueue::sendHandshake() {
-    std::unique_lock<std::mutex> handshakeLock { _handshakeMutex };
-    if (!_hasReceivedHandshakeACK) {
+SendQueue::Clock::time_point SendQueue::sendHandshake(Clock::time_point now) {
+    // we wait for the ACK or the re-send interval to expire
+    _isWaitingForWork = true;
+
+    if (!_hasReceivedHandshakeACK && now >= _nextHandshakeTime) {
         // we haven't received a handshake ACK from the client, send another now
         // if the handshake hasn't been completed, then the initial sequence number
         // should be the current sequence number + 1
@@ -189,20 +177,17 @@ void SendQueue::sendHandshake() {
         handshakePacket->writePrimitive(initialSequenceNumber);
         _socket->writeBasePacket(*handshakePacket, _destination);
         
-        // we wait for the ACK or the re-send interval to expire
         static const auto HANDSHAKE_RESEND_INTERVAL = std::chrono::milliseconds(100);
-        _handshakeACKCondition.wait_for(handshakeLock, HANDSHAKE_RESEND_INTERVAL);
+        _nextHandshakeTime = now + HANDSHAKE_RESEND_INTERVAL;
     }
+    return _nextHandshakeTime;
 }
 
 void SendQueue::handshakeACK() {
-    {
-        std::lock_guard<std::mutex> locker { _handshakeMutex };
-        _hasReceivedHandshakeACK = true;
-    }
+    _hasReceivedHandshakeACK = true;
 
-    // Notify on the handshake ACK condition
-    _handshakeACKCondition.notify_one();
+    // wake the queue so it starts sending
+    wakeIfWaiting();
 }
 
 SequenceNumber SendQueue::getNextSequenceNumber() {
@@ -238,6 +223,7 @@ bool SendQueue::sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket,
         {
             std::lock_guard<std::mutex> nakLocker(_naksLock);
             _naks.append(sequenceNumber);
+            _hasNAKs = true;
         }
 
         return false;
@@ -246,113 +232,114 @@ bool SendQueue::sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket,
     }
 }
 
-void SendQueue::run() {
-    if (_state == State::Stopped) {
-        // we've already been asked to stop before we even got a chance to start
-        // don't start now
-#ifdef UDT_CONNECTION_DEBUG
-        qCDebug(networking) << "SendQueue asked to run after being told to stop. Will not run.";
-#endif
-        return;
-    } else if (_state == State::Running) {
-#ifdef UDT_CONNECTION_DEBUG
-        qCDebug(networking) << "SendQueue asked to run but is already running (according to state). Will not re-run.";
-#endif
-        return;
+SendQueue::Clock::time_point SendQueue::service(Clock::time_point now) {
+    static const auto STOPPED = Clock::time_point::max();
+
+    auto notStarted = State::NotStarted;
+    if (!_state.compare_exchange_strong(notStarted, State::Running) && notStarted != State::Running) {
+        // we've already been asked to stop
+        return STOPPED;
     }
-    
-    _state = State::Running;
-    
+
+    // we're looking at the queues now, anything that changes from here on is seen by this step
+    _isWaitingForWork = false;
+
+    if (_hasPendingDestination) {
+        std::lock_guard<std::mutex> locker(_destinationLock);
+        _destination = _pendingDestination;
+        _hasPendingDestination = false;
+    }
+
     // Wait for handshake to be complete
-    while (_state == State::Running && !_hasReceivedHandshakeACK) {
-        sendHandshake();
+    if (!_hasReceivedHandshakeACK) {
+        // no packets will be sent until we receive the handshake ACK
+        return sendHandshake(now);
+    }
 
-        // Keep processing events
-        QCoreApplication::sendPostedEvents(this);
-        
-        // Once we're here we've either received the handshake ACK or it's going to be time to re-send a handshake.
-        // Either way let's continue processing - no packets will be sent if no handshake ACK has been received.
+    if (!_isPacing) {
+        // Keep an HRC to know when the next packet should have been
+        _nextPacketTimestamp = now;
+        _isPacing = true;
     }
 
-    // Keep an HRC to know when the next packet should have been
-    auto nextPacketTimestamp = p_high_resolution_clock::now();
+    bool attemptedToSendPacket = maybeResendPacket();
 
-    while (_state == State::Running) {
-        bool attemptedToSendPacket = maybeResendPacket();
-        
-        // if we didn't find a packet to re-send AND we think we can fit a new packet on the wire
-        // (this is according to the current flow window size) then we send out a new packet
-        auto newPacketCount = 0;
-        if (!attemptedToSendPacket) {
-            newPacketCount = maybeSendNewPacket();
-            attemptedToSendPacket = (newPacketCount > 0);
-        }
-        
-        // since we're a while loop, give the thread a chance to process events
-        QCoreApplication::sendPostedEvents(this);
-        
-        // we just processed events so check now if we were just told to stop
-        // If the send queue has been innactive, skip the sleep for
-        // Either _isRunning will have been set to false and we'll break
-        // Or something happened and we'll keep going
-        if (_state != State::Running || isInactive(attemptedToSendPacket)) {
-            return;
-        }
+    // if we didn't find a packet to re-send AND we think we can fit a new packet on the wire
+    // (this is according to the current flow window size) then we send out a new packet
+    auto newPacketCount = 0;
+    if (!attemptedToSendPacket) {
+        newPacketCount = maybeSendNewPacket();
+        attemptedToSendPacket = (newPacketCount > 0);
+    }
 
-        if (_packetSendPeriod > 0) {
-            // push the next packet timestamp forwards by the current packet send period
-            auto nextPacketDelta = (newPacketCount == 2 ? 2 : 1) * _packetSendPeriod;
-            nextPacketTimestamp += std::chrono::microseconds(nextPacketDelta);
+    if (_state != State::Running) {
+        return STOPPED;
+    }
 
-            // sleep as long as we need for next packet send, if we can
-            auto now = p_high_resolution_clock::now();
+    if (!attemptedToSendPacket) {
+        // don't bank send credit while blocked on the flow window or on the application,
+        // or the queue would burst unpaced once it can send again
+        _isPacing = false;
+        return checkInactivity(now);
+    }
 
-            auto timeToSleep = duration_cast<microseconds>(nextPacketTimestamp - now);
+    _inactivityDeadline = Clock::time_point::max();
+    return nextPacketTime(now, newPacketCount);
+}
 
-            // we use nextPacketTimestamp so that we don't fall behind, not to force long sleeps
-            // we'll never allow nextPacketTimestamp to force us to sleep for more than nextPacketDelta
-            // so cap it to that value
-            if (timeToSleep > std::chrono::microseconds(nextPacketDelta)) {
-                // reset the nextPacketTimestamp so that it is correct next time we come around
-                nextPacketTimestamp = now + std::chrono::microseconds(nextPacketDelta);
+SendQueue::Clock::time_point SendQueue::nextPacketTime(Clock::time_point now, int newPacketCount) {
+    if (_packetSendPeriod <= 0) {
+        return now;
+    }
 
-                timeToSleep = std::chrono::microseconds(nextPacketDelta);
-            }
+    // push the next packet timestamp forwards by the current packet send period
+    auto nextPacketDelta = (newPacketCount == 2 ? 2 : 1) * _packetSendPeriod;
+    _nextPacketTimestamp += std::chrono::microseconds(nextPacketDelta);
 
-            // we're seeing SendQueues sleep for a long period of time here,
-            // which can lock the NodeList if it's attempting to clear connections
-            // for now we guard this by capping the time this thread and sleep for
-
-            const microseconds MAX_SEND_QUEUE_SLEEP_USECS { 2000000 };
-            if (timeToSleep > MAX_SEND_QUEUE_SLEEP_USECS) {
-                qWarning() << "udt::SendQueue wanted to sleep for" << timeToSleep.count() << "microseconds";
-                qWarning() << "Capping sleep to" << MAX_SEND_QUEUE_SLEEP_USECS.count();
-                qWarning() << "PSP:" << _packetSendPeriod << "NPD:" << nextPacketDelta
-                << "NPT:" << nextPacketTimestamp.time_since_epoch().count()
-                << "NOW:" << now.time_since_epoch().count();
-
-                // alright, we're in a weird state
-                // we want to know why this is happening so we can implement a better fix than this guard
-                // send some details up to the API (if the user allows us) that indicate how we could such a large timeToSleep
-                static const QString SEND_QUEUE_LONG_SLEEP_ACTION = "sendqueue-sleep";
-
-                // setup a json object with the details we want
-                QJsonObject longSleepObject;
-                longSleepObject["timeToSleep"] = qint64(timeToSleep.count());
-                longSleepObject["packetSendPeriod"] = _packetSendPeriod.load();
-                longSleepObject["nextPacketDelta"] = nextPacketDelta;
-                longSleepObject["nextPacketTimestamp"] = qint64(nextPacketTimestamp.time_since_epoch().count());
-                longSleepObject["then"] = qint64(now.time_since_epoch().count());
-
-                // hopefully send this event using the user activity logger
-                UserActivityLogger::getInstance().logAction(SEND_QUEUE_LONG_SLEEP_ACTION, longSleepObject);
-                
-                timeToSleep = MAX_SEND_QUEUE_SLEEP_USECS;
-            }
-            
-            std::this_thread::sleep_for(timeToSleep);
-        }
+    auto timeToSleep = duration_cast<microseconds>(_nextPacketTimestamp - now);
+
+    // we use _nextPacketTimestamp so that we don't fall behind, not to force long sleeps
+    // we'll never allow _nextPacketTimestamp to force us to sleep for more than nextPacketDelta
+    // so cap it to that value
+    if (timeToSleep > std::chrono::microseconds(nextPacketDelta)) {
+        // reset the _nextPacketTimestamp so that it is correct next time we come around
+        _nextPacketTimestamp = now + std::chrono::microseconds(nextPacketDelta);
+
+        timeToSleep = std::chrono::microseconds(nextPacketDelta);
     }
+
+    // we're seeing SendQueues sleep for a long period of time here,
+    // which can lock the NodeList if it's attempting to clear connections
+    // for now we guard this by capping the time this queue can wait
+
+    const microseconds MAX_SEND_QUEUE_SLEEP_USECS { 2000000 };
+    if (timeToSleep > MAX_SEND_QUEUE_SLEEP_USECS) {
+        qWarning() << "udt::SendQueue wanted to sleep for" << timeToSleep.count() << "microseconds";
+        qWarning() << "Capping sleep to" << MAX_SEND_QUEUE_SLEEP_USECS.count();
+        qWarning() << "PSP:" << _packetSendPeriod << "NPD:" << nextPacketDelta
+        << "NPT:" << _nextPacketTimestamp.time_since_epoch().count()
+        << "NOW:" << now.time_since_epoch().count();
+
+        // alright, we're in a weird state
+        // we want to know why this is happening so we can implement a better fix than this guard
+        // send some details up to the API (if the user allows us) that indicate how we could such a large timeToSleep
+        static const QString SEND_QUEUE_LONG_SLEEP_ACTION = "sendqueue-sleep";
+
+        // setup a json object with the details we want
+        QJsonObject longSleepObject;
+        longSleepObject["timeToSleep"] = qint64(timeToSleep.count());
+        longSleepObject["packetSendPeriod"] = _packetSendPeriod.load();
+        longSleepObject["nextPacketDelta"] = nextPacketDelta;
+        longSleepObject["nextPacketTimestamp"] = qint64(_nextPacketTimestamp.time_since_epoch().count());
+        longSleepObject["then"] = qint64(now.time_since_epoch().count());
+
+        // hopefully send this event using the user activity logger
+        UserActivityLogger::getInstance().logAction(SEND_QUEUE_LONG_SLEEP_ACTION, longSleepObject);
+
+        timeToSleep = MAX_SEND_QUEUE_SLEEP_USECS;
+    }
+
+    return now + timeToSleep;
 }
 
 int SendQueue::maybeSendNewPacket() {
@@ -382,13 +369,15 @@ int SendQueue::maybeSendNewPacket() {
 bool SendQueue::maybeResendPacket() {
     
     // the following while makes sure that we find a packet to re-send, if there is one
-    while (true) {
+    // anything added to the naks wakes us up, so the lock is only needed when there is something in them
+    while (_hasNAKs) {
         
         std::unique_lock<std::mutex> naksLocker(_naksLock);
         
         if (!_naks.isEmpty()) {
             // pull the sequence number we need to re-send
             SequenceNumber resendNumber = _naks.popFirstSequenceNumber();
+            _hasNAKs = !_naks.isEmpty();
             naksLocker.unlock();
             
             // pull the packet to re-send from the sent packets list
@@ -463,88 +452,87 @@ bool SendQueue::maybeResendPacket() {
     return false;
 }
 
-bool SendQueue::isInactive(bool attemptedToSendPacket) {
-    // check for connection timeout first
+SendQueue::Clock::time_point SendQueue::checkInactivity(Clock::time_point now) {
+    // During our processing we didn't send any packets, so we wait until we have data to handle.
+    // Anything that may give us data wakes us up before the deadline, and we then start the wait over,
+    // so the deadline only passes once we have been waiting for that long.
 
-    if (!attemptedToSendPacket) {
-        // During our processing above we didn't send any packets
-        
-        // If that is still the case we should use a condition_variable_any to sleep until we have data to handle.
-        // To confirm that the queue of packets and the NAKs list are still both empty we'll need to use the DoubleLock
-        using DoubleLock = DoubleLock<std::recursive_mutex, std::mutex>;
-        DoubleLock doubleLock(_packets.getLock(), _naksLock);
-        DoubleLock::Lock locker(doubleLock, std::try_to_lock);
-        
-        if (locker.owns_lock() && (_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty()) {
-            // The packets queue and loss list mutexes are now both locked and they're both empty
-            
-            if (uint32_t(_lastACKSequenceNumber) == uint32_t(_currentSequenceNumber)) {
-                // we've sent the client as much data as we have (and they've ACKed it)
-                // either wait for new data to send or 5 seconds before cleaning up the queue
-                static const auto EMPTY_QUEUES_INACTIVE_TIMEOUT = std::chrono::seconds(5);
-                
-                // use our condition_variable_any to wait
-                auto cvStatus = _emptyCondition.wait_for(locker, EMPTY_QUEUES_INACTIVE_TIMEOUT);
-                
-                if (cvStatus == std::cv_status::timeout && (_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty()) {
+    // To confirm that the queue of packets and the NAKs list are still both empty we'll need to use the DoubleLock
+    using DoubleLock = DoubleLock<std::recursive_mutex, std::mutex>;
+    DoubleLock doubleLock(_packets.getLock(), _naksLock);
+    DoubleLock::Lock locker(doubleLock);
 
+    // anything queued, ACKed or lost after this point wakes us up
+    _isWaitingForWork = true;
+
+    if (!((_packets.isEmpty() || isFlowWindowFull()) && _naks.isEmpty())) {
+        // something came in since we looked, go around again
+        _isWaitingForWork = false;
+        return now;
+    }
+
+    bool isWaitingForNewData = uint32_t(_lastACKSequenceNumber) == uint32_t(_currentSequenceNumber);
+    bool deadlinePassed = isWaitingForNewData == _inactivityWaitIsForNewData && now >= _inactivityDeadline;
+    _inactivityWaitIsForNewData = isWaitingForNewData;
+
+    if (isWaitingForNewData) {
+        // we've sent the client as much data as we have (and they've ACKed it)
+        // either wait for new data to send or 5 seconds before cleaning up the queue
+        static const auto EMPTY_QUEUES_INACTIVE_TIMEOUT = std::chrono::seconds(5);
+
+        if (deadlinePassed) {
 #ifdef UDT_CONNECTION_DEBUG
-                    qCDebug(networking) << "SendQueue to" << _destination << "has been empty for"
-                        << EMPTY_QUEUES_INACTIVE_TIMEOUT.count()
-                        << "seconds and receiver has ACKed all packets."
-                        << "The queue is now inactive and will be stopped.";
+            qCDebug(networking) << "SendQueue to" << _destination << "has been empty for"
+                << EMPTY_QUEUES_INACTIVE_TIMEOUT.count()
+                << "seconds and receiver has ACKed all packets."
+                << "The queue is now inactive and will be stopped.";
 #endif
 
-                    // we have the lock again - Make sure to unlock it
-                    locker.unlock();
-                    
-                    // Deactivate queue
-                    deactivate();
-                    return true;
-                }
+            // Make sure to unlock before we emit
+            locker.unlock();
 
-            } else {
-                // We think the client is still waiting for data (based on the sequence number gap)
-                // Let's wait either for a response from the client or until the estimated timeout
-                // (plus the sync interval to allow the client to respond) has elapsed
-
-                auto estimatedTimeout = std::chrono::microseconds(_estimatedTimeout);
-
-                // Clamp timeout beween 10 ms and 5 s
-                estimatedTimeout = std::min(MAXIMUM_ESTIMATED_TIMEOUT, std::max(MINIMUM_ESTIMATED_TIMEOUT, estimatedTimeout));
-
-                // use our condition_variable_any to wait
-                auto cvStatus = _emptyCondition.wait_for(locker, estimatedTimeout);
-
-                // when we wake-up check if we're "stuck" either if we've slept for the estimated timeout
-                // or it has been that long since the last time we sent a packet
-
-                // we are stuck if all of the following are true
-                // - there are no new packets to send or the flow window is full and we can't send any new packets
-                // - there are no packets to resend
-                // - the client has yet to ACK some sent packets
-                auto now = std::chrono::high_resolution_clock::now();
-
-                if ((cvStatus == std::cv_status::timeout || (now - _lastPacketSentAt > estimatedTimeout))
-                    && (_packets.isEmpty() || isFlowWindowFull())
-                    && _naks.isEmpty()
-                    && SequenceNumber(_lastACKSequenceNumber) < _currentSequenceNumber) {
-                    // after a timeout if we still have sent packets that the client hasn't ACKed we
-                    // add them to the loss list
-                    
-                    // Note that thanks to the DoubleLock we have the _naksLock right now
-                    _naks.append(SequenceNumber(_lastACKSequenceNumber) + 1, _currentSequenceNumber);
-
-                    // we have the lock again - time to unlock it
-                    locker.unlock();
-                    
-                    emit timeout();
-                }
-            }
+            // Deactivate queue
+            deactivate();
+            return Clock::time_point::max();
         }
+
+        _inactivityDeadline = now + EMPTY_QUEUES_INACTIVE_TIMEOUT;
+        return _inactivityDeadline;
     }
-    
-    return false;
+
+    // We think the client is still waiting for data (based on the sequence number gap)
+    // Let's wait either for a response from the client or until the estimated timeout
+    // (plus the sync interval to allow the client to respond) has elapsed
+
+    auto estimatedTimeout = std::chrono::microseconds(_estimatedTimeout);
+
+    // Clamp timeout beween 10 ms and 5 s
+    estimatedTimeout = std::min(MAXIMUM_ESTIMATED_TIMEOUT, std::max(MINIMUM_ESTIMATED_TIMEOUT, estimatedTimeout));
+
+    // we are stuck if we've waited for the estimated timeout or it has been that long since the last time we sent
+    // a packet, and the client has yet to ACK some sent packets
+    if ((deadlinePassed || (now - _lastPacketSentAt > estimatedTimeout))
+        && SequenceNumber(_lastACKSequenceNumber) < _currentSequenceNumber) {
+        // after a timeout if we still have sent packets that the client hasn't ACKed we
+        // add them to the loss list
+
+        // Note that thanks to the DoubleLock we have the _naksLock right now
+        _naks.append(SequenceNumber(_lastACKSequenceNumber) + 1, _currentSequenceNumber);
+        _hasNAKs = true;
+
+        // time to unlock before we emit
+        locker.unlock();
+
+        _isWaitingForWork = false;
+        _inactivityDeadline = Clock::time_point::max();
+        emit timeout();
+
+        // go around again to re-send them
+        return now;
+    }
+
+    _inactivityDeadline = now + estimatedTimeout;
+    return _inactivityDeadline;
 }
 
 void SendQueue::deactivate() {
@@ -559,5 +547,8 @@ bool SendQueue::isFlowWindowFull() const {
 }
 
 void SendQueue::updateDestinationAddress(HifiSockAddr newAddress) {
-    _destination = newAddress;
+    // the pacing thread switches over on its next service step
+    std::lock_guard<std::mutex> locker(_destinationLock);
+    _pendingDestination = newAddress;
+    _hasPendingDestination = true;
 }
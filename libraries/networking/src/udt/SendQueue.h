@@ -13,7 +13,6 @@
 #define hifi_SendQueue_h
 
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -38,12 +37,16 @@ class BasePacket;
 class ControlPacket;
 class Packet;
 class PacketList;
+class SendScheduler;
 class Socket;
     
+// Packets for one reliable connection, paced by the shared SendScheduler
 class SendQueue : public QObject {
     Q_OBJECT
     
 public:
+    using Clock = p_high_resolution_clock;
+
     enum class State {
         NotStarted,
         Running,
@@ -68,6 +71,10 @@ public:
     void setPacketSendPeriod(int newPeriod) { _packetSendPeriod = newPeriod; }
     
     void setEstimatedTimeout(int estimatedTimeout) { _estimatedTimeout = estimatedTimeout; }
+
+    // Called by the SendScheduler to send or re-send at most one packet.
+    // Returns when the queue should be serviced next, or Clock::time_point::max() once it has stopped.
+    Clock::time_point service(Clock::time_point now);
     
 public slots:
     void stop();
@@ -85,16 +92,17 @@ signals:
 
     void timeout();
     
-private slots:
-    void run();
-    
 private:
+    friend class SendScheduler;
+
+
     SendQueue(Socket* socket, HifiSockAddr dest, SequenceNumber currentSequenceNumber,
               MessageNumber currentMessageNumber, bool hasReceivedHandshakeACK);
     SendQueue(SendQueue& other) = delete;
     SendQueue(SendQueue&& other) = delete;
     
-    void sendHandshake();
+    Clock::time_point sendHandshake(Clock::time_point now);
+    Clock::time_point nextPacketTime(Clock::time_point now, int newPacketCount);
     
     int sendPacket(const Packet& packet);
     bool sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket, SequenceNumber sequenceNumber);
@@ -102,8 +110,10 @@ private:
     int maybeSendNewPacket(); // Figures out what packet to send next
     bool maybeResendPacket(); // Determines whether to resend a packet and which one
     
-    bool isInactive(bool attemptedToSendPacket);
+    // Waits for new data or ACKs when there was nothing to send, returns when to check again
+    Clock::time_point checkInactivity(Clock::time_point now);
     void deactivate(); // makes the queue inactive and cleans it up
+    void wakeIfWaiting();
 
     bool isFlowWindowFull() const;
     
@@ -113,7 +123,11 @@ private:
     PacketQueue _packets;
     
     Socket* _socket { nullptr }; // Socket to send packet on
-    HifiSockAddr _destination; // Destination addr
+    HifiSockAddr _destination; // Destination addr, only touched while servicing
+
+    std::mutex _destinationLock; // Protects the pending destination address
+    HifiSockAddr _pendingDestination; // Destination to switch to on the next service step
+    std::atomic<bool> _hasPendingDestination { false };
     
     std::atomic<uint32_t> _lastACKSequenceNumber { 0 }; // Last ACKed sequence number
     
@@ -129,18 +143,27 @@ private:
     
     mutable std::mutex _naksLock; // Protects the naks list.
     LossList _naks; // Sequence numbers of packets to resend
+    std::atomic<bool> _hasNAKs { false }; // Published after each change to the naks list, read without the lock
     
     mutable QReadWriteLock _sentLock; // Protects the sent packet list
     using PacketResendPair = std::pair<uint8_t, std::unique_ptr<Packet>>; // Number of resend + packet ptr
     std::unordered_map<SequenceNumber, PacketResendPair> _sentPackets; // Packets waiting for ACK.
     
-    std::mutex _handshakeMutex; // Protects the handshake ACK condition_variable
     std::atomic<bool> _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
-    std::condition_variable _handshakeACKCondition;
-    
-    std::condition_variable_any _emptyCondition;
+    Clock::time_point _nextHandshakeTime; // when to re-send the handshake if it hasn't been ACKed
+
+    // Set while the queue is waiting for work rather than pacing, so that new packets, ACKs and losses wake it up.
+    // Wake ups never cut a packet send period short.
+    std::atomic<bool> _isWaitingForWork { false };
+
+    bool _isPacing { false }; // whether _nextPacketTimestamp has been started
+    Clock::time_point _nextPacketTimestamp; // when the next packet should be sent, to keep the send period
+    Clock::time_point _inactivityDeadline { Clock::time_point::max() }; // end of the current wait for work
+    bool _inactivityWaitIsForNewData { false }; // whether that wait is for new data or for ACKs
+
+    std::atomic<int> _schedulerWorker { -1 }; // SendScheduler thread servicing this queue
 
-    std::chrono::high_resolution_clock::time_point _lastPacketSentAt;
+    Clock::time_point _lastPacketSentAt;
 
     static const std::chrono::microseconds MAXIMUM_ESTIMATED_TIMEOUT;
     static const std::chrono::microseconds MINIMUM_ESTIMATED_TIMEOUT;
@@ -0,0 +1,248 @@
+//
+//  SendScheduler.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SendScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include <QtCore/QThread>
+
+#include "../NetworkLogging.h"
+#include "SendQueue.h"
+#include "TimerWheel.h"
+
+using namespace udt;
+
+static const int MAX_SEND_SCHEDULER_THREADS = 4;
+
+class SendScheduler::Worker : public QThread {
+public:
+    Worker(int index) {
+        setObjectName("Networking: SendScheduler " + QString::number(index));
+    }
+
+    void stop();
+
+    void add(SendQueue* queue);
+    void remove(SendQueue* queue);
+    void wake(SendQueue* queue);
+
+    size_t getQueueCount() const { return _queueCount; }
+
+protected:
+    void run() override;
+
+private:
+    struct Timer {
+        SendQueue* queue;
+        uint64_t generation;
+    };
+
+    struct QueueState {
+        uint64_t generation { 0 }; // timers from an older generation are stale
+        bool isReady { false }; // in the ready list
+        bool isServicing { false };
+        bool wakeRequested { false };
+        bool isRemoved { false };
+    };
+
+    void scheduleLocked(SendQueue* queue, QueueState& state, Clock::time_point due);
+
+    std::mutex _mutex;
+    std::condition_variable _condition; // wakes up the pacing thread
+    std::condition_variable _servicedCondition; // signals the end of a service step to remove()
+
+    TimerWheel<Timer> _wheel;
+    std::deque<Timer> _ready;
+    std::unordered_map<SendQueue*, QueueState> _queues;
+    std::atomic<size_t> _queueCount { 0 };
+    uint64_t _nextGeneration { 0 };
+    bool _isRunning { true };
+};
+
+void SendScheduler::Worker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isRunning = false;
+    }
+    _condition.notify_one();
+    wait();
+}
+
+void SendScheduler::Worker::scheduleLocked(SendQueue* queue, QueueState& state, Clock::time_point due) {
+    if (state.isReady) {
+        // it is going to be serviced as soon as possible already
+        return;
+    }
+
+    // a new generation makes any timer still in the wheel for this queue stale
+    state.generation = ++_nextGeneration;
+    if (due <= Clock::now()) {
+        state.isReady = true;
+        _ready.push_back({ queue, state.generation });
+    } else {
+        _wheel.schedule({ queue, state.generation }, due);
+    }
+}
+
+void SendScheduler::Worker::add(SendQueue* queue) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto& state = _queues[queue];
+        state = QueueState();
+        ++_queueCount;
+        scheduleLocked(queue, state, Clock::now());
+    }
+    _condition.notify_one();
+}
+
+void SendScheduler::Worker::remove(SendQueue* queue) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto it = _queues.find(queue);
+    if (it == _queues.end()) {
+        return;
+    }
+
+    // references to unordered_map elements survive rehashing, so this is safe to hold while waiting
+    auto& state = it->second;
+    state.isRemoved = true;
+    if (QThread::currentThread() != this) {
+        _servicedCondition.wait(lock, [&state] { return !state.isServicing; });
+    }
+
+    // any timers left for the queue are dropped when they come up
+    _queues.erase(queue);
+    --_queueCount;
+}
+
+void SendScheduler::Worker::wake(SendQueue* queue) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _queues.find(queue);
+        if (it == _queues.end()) {
+            return;
+        }
+
+        auto& state = it->second;
+        if (state.isServicing) {
+            // reschedule right away once the current step is done, it may have missed what woke us
+            state.wakeRequested = true;
+            return;
+        }
+        scheduleLocked(queue, state, Clock::now());
+    }
+    _condition.notify_one();
+}
+
+void SendScheduler::Worker::run() {
+    std::vector<Timer> expired;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_isRunning) {
+        _wheel.advance(Clock::now(), expired);
+        for (auto& timer : expired) {
+            auto it = _queues.find(timer.queue);
+            if (it != _queues.end() && it->second.generation == timer.generation && !it->second.isReady) {
+                it->second.isReady = true;
+                _ready.push_back(timer);
+            }
+        }
+        expired.clear();
+
+        if (_ready.empty()) {
+            auto deadline = _wheel.nextDeadline();
+            if (deadline == Clock::time_point::max()) {
+                _condition.wait(lock);
+            } else {
+                _condition.wait_until(lock, deadline);
+            }
+            continue;
+        }
+
+        auto timer = _ready.front();
+        _ready.pop_front();
+
+        auto it = _queues.find(timer.queue);
+        if (it == _queues.end() || it->second.generation != timer.generation) {
+            continue;
+        }
+
+        auto& state = it->second;
+        state.isReady = false;
+        state.isServicing = true;
+        state.wakeRequested = false;
+
+        lock.unlock();
+        auto next = timer.queue->service(Clock::now());
+        lock.lock();
+
+        state.isServicing = false;
+        if (state.isRemoved) {
+            _servicedCondition.notify_all();
+            continue;
+        }
+
+        if (state.wakeRequested) {
+            state.wakeRequested = false;
+            next = Clock::now();
+        }
+
+        if (next != Clock::time_point::max()) {
+            // queues that are due again right away go to the back of the ready list, so busy queues take turns
+            scheduleLocked(timer.queue, state, next);
+        }
+    }
+}
+
+SendScheduler& SendScheduler::getInstance() {
+    static SendScheduler instance(std::max(1, std::min(MAX_SEND_SCHEDULER_THREADS, QThread::idealThreadCount() / 2)));
+    return instance;
+}
+
+SendScheduler::SendScheduler(int threadCount) {
+    for (int i = 0; i < threadCount; ++i) {
+        _workers.emplace_back(new Worker(i));
+        _workers.back()->start(QThread::HighPriority);
+    }
+    qCDebug(networking) << "SendScheduler pacing send queues on" << threadCount << "threads";
+}
+
+SendScheduler::~SendScheduler() {
+    for (auto& worker : _workers) {
+        worker->stop();
+    }
+}
+
+void SendScheduler::add(SendQueue* queue) {
+    auto leastBusy = std::min_element(_workers.begin(), _workers.end(), [](const auto& a, const auto& b) {
+        return a->getQueueCount() < b->getQueueCount();
+    });
+    queue->_schedulerWorker = (int)(leastBusy - _workers.begin());
+    (*leastBusy)->add(queue);
+}
+
+void SendScheduler::remove(SendQueue* queue) {
+    int worker = queue->_schedulerWorker.exchange(-1);
+    if (worker >= 0) {
+        _workers[worker]->remove(queue);
+    }
+}
+
+void SendScheduler::wake(SendQueue* queue) {
+    int worker = queue->_schedulerWorker;
+    if (worker >= 0) {
+        _workers[worker]->wake(queue);
+    }
+}
@@ -0,0 +1,53 @@
+//
+//  SendScheduler.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SendScheduler_h
+#define hifi_SendScheduler_h
+
+#include <memory>
+#include <vector>
+
+#include <PortableHighResolutionClock.h>
+
+namespace udt {
+
+class SendQueue;
+
+// Paces every SendQueue in the process on a small fixed pool of threads.
+// Each thread owns a timer wheel of the queues it services. A queue is serviced when its next packet is due or when
+// it is woken up, and its service step returns when it next wants to run.
+class SendScheduler {
+public:
+    using Clock = p_high_resolution_clock;
+
+    static SendScheduler& getInstance();
+
+    ~SendScheduler();
+
+    // Starts servicing the queue, on the thread with the fewest queues
+    void add(SendQueue* queue);
+    // Stops servicing the queue, waiting for a service step in progress on another thread to finish
+    void remove(SendQueue* queue);
+    // Services the queue as soon as possible, e.g. when it has new packets or its flow window opened
+    void wake(SendQueue* queue);
+
+    int getThreadCount() const { return (int)_workers.size(); }
+
+private:
+    class Worker;
+
+    SendScheduler(int threadCount);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+};
+
+}
+
+#endif // hifi_SendScheduler_h
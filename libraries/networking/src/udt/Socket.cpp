@@ -136,22 +136,33 @@ qint64 Socket::writeBasePacket(const udt::BasePacket& packet, const HifiSockAddr
 qint64 Socket::writePacket(const Packet& packet, const HifiSockAddr& sockAddr) {
     Q_ASSERT_X(!packet.isReliable(), "Socket::writePacket", "Cannot send a reliable packet unreliably");
 
-    SequenceNumber sequenceNumber;
-    {
-        Lock lock(_unreliableSequenceNumbersMutex);
-        sequenceNumber = ++_unreliableSequenceNumbers[sockAddr];
-    }
-
     auto connection = findOrCreateConnection(sockAddr, true);
     if (connection) {
         connection->recordSentUnreliablePackets(packet.getWireSize(),
                                                 packet.getPayloadSize());
     }
 
-    // write the correct sequence number to the Packet here
-    packet.writeSequenceNumber(sequenceNumber);
+    std::unique_ptr<ControlPacket> parityPacket;
+    {
+        Lock lock(_unreliableSequenceNumbersMutex);
+        auto sequenceNumber = ++_unreliableSequenceNumbers[sockAddr];
 
-    return writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
+        // write the correct sequence number to the Packet here
+        packet.writeSequenceNumber(sequenceNumber);
+
+        // parity groups are runs of sequence numbers, so packets are added in the order those are handed out
+        if (connection) {
+            parityPacket = connection->protectUnreliablePacket(packet);
+        }
+    }
+
+    auto bytesWritten = writeDatagram(packet.getData(), packet.getDataSize(), sockAddr);
+
+    if (parityPacket) {
+        writeBasePacket(*parityPacket, sockAddr);
+    }
+
+    return bytesWritten;
 }
 
 qint64 Socket::writePacket(std::unique_ptr<Packet> packet, const HifiSockAddr& sockAddr) {
@@ -368,6 +379,7 @@ void Socket::checkForReadyReadBackup() {
 void Socket::readPendingDatagrams() {
     using namespace std::chrono;
     static const auto MAX_PROCESS_TIME { 100ms };
+    static const size_t MAX_PACKET_BATCH_SIZE = 32;
     const auto abortTime = system_clock::now() + MAX_PROCESS_TIME;
     int packetSizeWithHeader = -1;
 
@@ -413,6 +425,8 @@ void Socket::readPendingDatagrams() {
         auto it = _unfilteredHandlers.find(senderSockAddr);
 
         if (it != _unfilteredHandlers.end()) {
+            processPendingDataPackets();
+
             // we have a registered unfiltered handler for this HifiSockAddr - call that and return
             if (it->second) {
                 auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
@@ -427,6 +441,9 @@ void Socket::readPendingDatagrams() {
         bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
 
         if (isControlPacket) {
+            // keep the order the packets came in
+            processPendingDataPackets();
+
             // setup a control packet from the data we just read
             auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
             controlPacket->setReceiveTime(receiveTime);
@@ -446,40 +463,103 @@ void Socket::readPendingDatagrams() {
             // save the sequence number in case this is the packet that sticks readyRead
             _lastReceivedSequenceNumber = packet->getSequenceNumber();
 
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                auto connection = findOrCreateConnection(senderSockAddr, true);
+            // verify the data packets a batch at a time
+            _pendingDataPackets.push_back(std::move(packet));
+            if (_pendingDataPackets.size() >= MAX_PACKET_BATCH_SIZE) {
+                processPendingDataPackets();
+            }
+        }
+    }
+
+    processPendingDataPackets();
+}
 
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
+void Socket::processPendingDataPackets() {
+    if (_pendingDataPackets.empty()) {
+        return;
+    }
+
+    if (_packetBatchFilterOperator) {
+        _pendingDataPacketsVerified.assign(_pendingDataPackets.size(), false);
+        _packetBatchFilterOperator(_pendingDataPackets, _pendingDataPacketsVerified);
+
+        for (size_t i = 0; i < _pendingDataPackets.size(); ++i) {
+            if (_pendingDataPacketsVerified[i]) {
+                dispatchDataPacket(std::move(_pendingDataPackets[i]), false);
+            }
+        }
+    } else {
+        for (auto& packet : _pendingDataPackets) {
+            processDataPacket(std::move(packet));
+        }
+    }
 
-                    if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                                  packet->getDataSize(),
-                                                                                  packet->getPayloadSize())) {
-                        // the connection could not be created or indicated that we should not continue processing this packet
+    _pendingDataPackets.clear();
+}
+
+void Socket::processDataPacket(std::unique_ptr<Packet> packet, bool wasRecovered) {
+    // call our verification operator to see if this packet is verified
+    if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+        dispatchDataPacket(std::move(packet), wasRecovered);
+    }
+}
+
+void Socket::dispatchDataPacket(std::unique_ptr<Packet> packet, bool wasRecovered) {
+    auto connection = findOrCreateConnection(packet->getSenderSockAddr(), true);
+
+    if (packet->isReliable()) {
+        // if this was a reliable packet then signal the matching connection with the sequence number
+
+        if (!connection || !connection->processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                                      packet->getDataSize(),
+                                                                      packet->getPayloadSize())) {
+            // the connection could not be created or indicated that we should not continue processing this packet
 #ifdef UDT_CONNECTION_DEBUG
-                        qCDebug(networking) << "Can't process packet: version" << (unsigned int)NLPacket::versionInHeader(*packet)
-                            << ", type" << NLPacket::typeInHeader(*packet);
+            qCDebug(networking) << "Can't process packet: version" << (unsigned int)NLPacket::versionInHeader(*packet)
+                << ", type" << NLPacket::typeInHeader(*packet);
 #endif
-                        continue;
-                    }
-                } else if (connection) {
-                    connection->recordReceivedUnreliablePackets(packet->getWireSize(),
-                                                                packet->getPayloadSize());
-                }
-
-                if (packet->isPartOfMessage()) {
-                    auto connection = findOrCreateConnection(senderSockAddr, true);
-                    if (connection) {
-                        connection->queueReceivedMessagePacket(std::move(packet));
-                    }
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
-                }
-            }
+            return;
+        }
+    } else if (connection && !wasRecovered) {
+        // the connection keeps unreliable packets around for parity, which may have rebuilt this one already
+        if (!connection->processReceivedUnreliablePacket(*packet)) {
+            return;
         }
     }
+
+    if (packet->isPartOfMessage()) {
+        if (connection) {
+            connection->queueReceivedMessagePacket(std::move(packet));
+        }
+    } else if (_packetHandler) {
+        // call the verified packet callback to let it handle this packet
+        _packetHandler(std::move(packet));
+    }
+}
+
+void Socket::processRecoveredDatagram(const QByteArray& datagram, const HifiSockAddr& senderSockAddr) {
+    // only unreliable packets are covered by parity, anything else means it didn't rebuild what was sent
+    if (datagram.size() < (int)sizeof(uint32_t) || *reinterpret_cast<const uint32_t*>(datagram.data()) & CONTROL_BIT_MASK) {
+        return;
+    }
+
+    auto buffer = std::unique_ptr<char[]>(new char[datagram.size()]);
+    memcpy(buffer.get(), datagram.data(), datagram.size());
+
+    auto packet = Packet::fromReceivedPacket(std::move(buffer), datagram.size(), senderSockAddr);
+    if (packet->isReliable()) {
+        return;
+    }
+    packet->setReceiveTime(p_high_resolution_clock::now());
+
+    processDataPacket(std::move(packet), true);
+}
+
+void Socket::requestFEC(const HifiSockAddr& sockAddr, int groupSize) {
+    auto connection = findOrCreateConnection(sockAddr, true);
+    if (connection) {
+        connection->requestFEC(groupSize);
+    }
 }
 
 void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* receiver, const char* slot) {
@@ -491,6 +571,9 @@ void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* r
 }
 
 void Socket::setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory) {
+    // connections are created under the same lock, so this can be called from any thread
+    Lock connectionsLock(_connectionsHashMutex);
+
     // swap the current unique_ptr for the new factory
     _ccFactory.swap(ccFactory);
 }
@@ -18,6 +18,7 @@
 #include <unordered_map>
 #include <mutex>
 #include <list>
+#include <vector>
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
@@ -39,6 +40,9 @@ class PacketList;
 class SequenceNumber;
 
 using PacketFilterOperator = std::function<bool(const Packet&)>;
+using PacketBatch = std::vector<std::unique_ptr<Packet>>;
+// sets isVerified[i] for each packet of the batch, which lets it share the work between them
+using PacketBatchFilterOperator = std::function<void(const PacketBatch&, std::vector<bool>& isVerified)>;
 using ConnectionCreationFilterOperator = std::function<bool(const HifiSockAddr&)>;
 
 using BasePacketHandler = std::function<void(std::unique_ptr<BasePacket>)>;
@@ -72,6 +76,8 @@ public:
     void rebind();
 
     void setPacketFilterOperator(PacketFilterOperator filterOperator) { _packetFilterOperator = filterOperator; }
+    void setPacketBatchFilterOperator(PacketBatchFilterOperator filterOperator)
+        { _packetBatchFilterOperator = filterOperator; }
     void setPacketHandler(PacketHandler handler) { _packetHandler = handler; }
     void setMessageHandler(MessageHandler handler) { _messageHandler = handler; }
     void setMessageFailureHandler(MessageFailureHandler handler) { _messageFailureHandler = handler; }
@@ -86,6 +92,10 @@ public:
 
     void messageReceived(std::unique_ptr<Packet> packet);
     void messageFailed(Connection* connection, Packet::MessageNumber messageNumber);
+
+    // asks the peer to send parity for its unreliable packets, see ForwardErrorCorrection.h
+    void requestFEC(const HifiSockAddr& sockAddr, int groupSize);
+    void processRecoveredDatagram(const QByteArray& datagram, const HifiSockAddr& senderSockAddr);
     
     StatsVector sampleStatsForAllConnections();
 
@@ -111,6 +121,9 @@ private slots:
 private:
     void setSystemBufferSizes();
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr, bool filterCreation = false);
+    void processDataPacket(std::unique_ptr<Packet> packet, bool wasRecovered = false);
+    void processPendingDataPackets();
+    void dispatchDataPacket(std::unique_ptr<Packet> packet, bool wasRecovered);
    
     // privatized methods used by UDTTest - they are private since they must be called on the Socket thread
     ConnectionStats::Stats sampleStatsForConnection(const HifiSockAddr& destination);
@@ -123,6 +136,7 @@ private:
     
     QUdpSocket _udpSocket { this };
     PacketFilterOperator _packetFilterOperator;
+    PacketBatchFilterOperator _packetBatchFilterOperator;
     PacketHandler _packetHandler;
     MessageHandler _messageHandler;
     MessageFailureHandler _messageFailureHandler;
@@ -137,6 +151,10 @@ private:
 
     QTimer* _readyReadBackupTimer { nullptr };
 
+    // data packets read but not yet verified, see PacketBatchFilterOperator
+    PacketBatch _pendingDataPackets;
+    std::vector<bool> _pendingDataPacketsVerified;
+
     int _maxBandwidth { -1 };
 
     std::unique_ptr<CongestionControlVirtualFactory> _ccFactory { new CongestionControlFactory<TCPVegasCC>() };
@@ -116,9 +116,13 @@ bool TCPVegasCC::onACK(SequenceNumber ack, p_high_resolution_clock::time_point r
         }
     }
 
-    auto sinceLastAdjustment = duration_cast<microseconds>(p_high_resolution_clock::now() - _lastAdjustmentTime).count();
+    // decisions are timed from when the ACK was received, not from when we got to it
+    auto sinceLastAdjustment = duration_cast<microseconds>(receiveTime - _lastAdjustmentTime).count();
     if (sinceLastAdjustment >= _ewmaRTT) {
         performCongestionAvoidance(ack);
+
+        // mark this as the last adjustment time
+        _lastAdjustmentTime = receiveTime;
     }
 
     ++_numACKSinceFastRetransmit;
@@ -126,7 +130,7 @@ bool TCPVegasCC::onACK(SequenceNumber ack, p_high_resolution_clock::time_point r
     // perform the fast re-transmit check if this is a duplicate ACK or if this is the first or second ACK
     // after a previous fast re-transmit
     if (wasDuplicateACK || _numACKSinceFastRetransmit < 3) {
-        return needsFastRetransmit(ack, wasDuplicateACK);
+        return needsFastRetransmit(ack, wasDuplicateACK, receiveTime);
     } else {
         _duplicateACKCount = 0;
     }
@@ -135,7 +139,7 @@ bool TCPVegasCC::onACK(SequenceNumber ack, p_high_resolution_clock::time_point r
     return false;
 }
 
-bool TCPVegasCC::needsFastRetransmit(SequenceNumber ack, bool wasDuplicateACK) {
+bool TCPVegasCC::needsFastRetransmit(SequenceNumber ack, bool wasDuplicateACK, p_high_resolution_clock::time_point now) {
     // we may need to re-send ackNum + 1 if it has been more than our estimated timeout since it was sent
 
     auto nextIt = std::find_if(_sentPacketDatas.begin(), _sentPacketDatas.end(), [ack](SentPacketData& packetTime){
@@ -143,7 +147,6 @@ bool TCPVegasCC::needsFastRetransmit(SequenceNumber ack, bool wasDuplicateACK) {
     });
 
     if (nextIt != _sentPacketDatas.end()) {
-        auto now = p_high_resolution_clock::now();
         auto sinceSend = duration_cast<microseconds>(now - nextIt->timePoint).count();
 
         if (sinceSend >= estimatedTimeout()) {
@@ -239,9 +242,6 @@ void TCPVegasCC::performCongestionAvoidance(udt::SequenceNumber ack) {
         _congestionWindowSize = udt::MAX_PACKETS_IN_FLIGHT;
     }
 
-    // mark this as the last adjustment time
-    _lastAdjustmentTime = p_high_resolution_clock::now();
-
     // reset our state for the next RTT
     _currentMinRTT = std::numeric_limits<int>::max();
 
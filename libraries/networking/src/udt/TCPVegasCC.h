@@ -39,7 +39,7 @@ protected:
     virtual void setInitialSendSequenceNumber(SequenceNumber seqNum) override { _lastACK = seqNum - 1; }
 private:
     bool calculateRTT(p_high_resolution_clock::time_point sendTime, p_high_resolution_clock::time_point receiveTime);
-    bool needsFastRetransmit(SequenceNumber ack, bool wasDuplicateACK);
+    bool needsFastRetransmit(SequenceNumber ack, bool wasDuplicateACK, p_high_resolution_clock::time_point now);
 
     bool isCongestionWindowLimited();
     void performRenoCongestionAvoidance(SequenceNumber ack);
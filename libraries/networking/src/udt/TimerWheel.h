@@ -0,0 +1,157 @@
+//
+//  TimerWheel.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TimerWheel_h
+#define hifi_TimerWheel_h
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <PortableHighResolutionClock.h>
+
+namespace udt {
+
+// Hierarchical timing wheel: scheduling is O(1), and advancing costs O(1) per elapsed tick plus the timers that expire.
+// Timers fire on the first tick at or after their due time, never before it.
+// Three levels of 256, 64 and 64 slots cover 2^20 ticks, about 105 seconds at the default 100us tick.
+// Timers further out are parked in the last level and rescheduled when it comes around.
+// Not thread safe, the owner serializes access.
+template <typename T>
+class TimerWheel {
+public:
+    using Clock = p_high_resolution_clock;
+    using Tick = uint64_t;
+
+    static const int DEFAULT_TICK_USECS = 100;
+
+    TimerWheel(Clock::time_point start = Clock::now(),
+               Clock::duration tickDuration = std::chrono::microseconds((int64_t)DEFAULT_TICK_USECS)) :
+        _start(start), _tickDuration(tickDuration) {}
+
+    void schedule(T value, Clock::time_point due) {
+        // Anything already due goes in the next tick
+        insert({ std::max(toTick(due), _currentTick + 1), std::move(value) });
+        ++_count;
+    }
+
+    // Moves the wheel forward to now, appending the timers that expired in the order of their ticks
+    void advance(Clock::time_point now, std::vector<T>& expired) {
+        Tick target = now > _start ? Tick((now - _start) / _tickDuration) : 0;
+        if (_count == 0) {
+            _currentTick = std::max(_currentTick, target);
+            return;
+        }
+
+        while (_currentTick < target && _count > 0) {
+            ++_currentTick;
+            if ((_currentTick & LEVEL_0_MASK) == 0) {
+                if (((_currentTick >> LEVEL_0_BITS) & LEVEL_N_MASK) == 0) {
+                    cascade(_level2[(_currentTick >> (LEVEL_0_BITS + LEVEL_N_BITS)) & LEVEL_N_MASK]);
+                }
+                cascade(_level1[(_currentTick >> LEVEL_0_BITS) & LEVEL_N_MASK]);
+            }
+
+            auto& slot = _level0[_currentTick & LEVEL_0_MASK];
+            if (!slot.empty()) {
+                _count -= slot.size();
+                for (auto& timer : slot) {
+                    expired.push_back(std::move(timer.value));
+                }
+                slot.clear();
+            }
+        }
+        _currentTick = std::max(_currentTick, target);
+    }
+
+    // Time of the next tick that needs processing, or Clock::time_point::max() when there are no timers
+    Clock::time_point nextDeadline() const {
+        if (_count == 0) {
+            return Clock::time_point::max();
+        }
+        for (Tick tick = _currentTick + 1; tick <= _currentTick + LEVEL_0_SIZE; ++tick) {
+            if (!_level0[tick & LEVEL_0_MASK].empty() || (tick & LEVEL_0_MASK) == 0) {
+                return toTimePoint(tick);
+            }
+        }
+        return toTimePoint(_currentTick + LEVEL_0_SIZE);
+    }
+
+    size_t size() const { return _count; }
+    bool isEmpty() const { return _count == 0; }
+
+private:
+    static const int LEVEL_0_BITS = 8;
+    static const int LEVEL_N_BITS = 6;
+    static const Tick LEVEL_0_SIZE = Tick(1) << LEVEL_0_BITS;
+    static const Tick LEVEL_N_SIZE = Tick(1) << LEVEL_N_BITS;
+    static const Tick LEVEL_0_MASK = LEVEL_0_SIZE - 1;
+    static const Tick LEVEL_N_MASK = LEVEL_N_SIZE - 1;
+    static const Tick LEVEL_1_RANGE = LEVEL_0_SIZE * LEVEL_N_SIZE;
+    static const Tick WHEEL_RANGE = LEVEL_1_RANGE * LEVEL_N_SIZE;
+
+    struct Timer {
+        Tick tick;
+        T value;
+    };
+    using Slot = std::vector<Timer>;
+
+    Tick toTick(Clock::time_point timePoint) const {
+        if (timePoint <= _start) {
+            return 0;
+        }
+        if (timePoint == Clock::time_point::max()) {
+            return std::numeric_limits<Tick>::max();
+        }
+        auto elapsed = timePoint - _start;
+        return Tick((elapsed + _tickDuration - Clock::duration(1)) / _tickDuration);
+    }
+
+    Clock::time_point toTimePoint(Tick tick) const {
+        return _start + _tickDuration * (Clock::duration::rep)tick;
+    }
+
+    void insert(Timer&& timer) {
+        // timers past the range of the wheel are placed at its far end, and cascade back up from there
+        Tick tick = std::min(timer.tick, _currentTick + WHEEL_RANGE - 1);
+        Tick delta = tick - _currentTick;
+        if (delta < LEVEL_0_SIZE) {
+            _level0[tick & LEVEL_0_MASK].push_back(std::move(timer));
+        } else if (delta < LEVEL_1_RANGE) {
+            _level1[(tick >> LEVEL_0_BITS) & LEVEL_N_MASK].push_back(std::move(timer));
+        } else {
+            _level2[(tick >> (LEVEL_0_BITS + LEVEL_N_BITS)) & LEVEL_N_MASK].push_back(std::move(timer));
+        }
+    }
+
+    void cascade(Slot& slot) {
+        Slot timers;
+        timers.swap(slot);
+        for (auto& timer : timers) {
+            insert(std::move(timer));
+        }
+    }
+
+    Clock::time_point _start;
+    Clock::duration _tickDuration;
+    Tick _currentTick { 0 };
+    size_t _count { 0 };
+
+    std::array<Slot, LEVEL_0_SIZE> _level0;
+    std::array<Slot, LEVEL_N_SIZE> _level1;
+    std::array<Slot, LEVEL_N_SIZE> _level2;
+};
+
+}
+
+#endif // hifi_TimerWheel_h
@@ -13,6 +13,7 @@
 
 #include "impl/FileClip.h"
 #include "impl/BufferClip.h"
+#include "impl/ClipIndex.h"
 
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -55,7 +56,7 @@ float Clip::position() const {
 }
 
 // FIXME move to frame?
-bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
+bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true, FrameSize* writtenSize = nullptr) {
     if (frame.type == Frame::TYPE_INVALID) {
         qWarning() << "Attempting to write invalid frame";
         return true;
@@ -80,6 +81,9 @@ bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
     if (written != sizeof(uint16_t)) {
         return false;
     }
+    if (writtenSize) {
+        *writtenSize = dataSize;
+    }
 
     if (dataSize != 0) {
         written = output.write(frameData);
@@ -110,10 +114,32 @@ bool Clip::write(QIODevice& output) {
         return false;
     }
 
+    uint64_t offset = ClipIndex::FRAME_HEADER_SIZE + headerFrameData.size();
+
     seek(0);
 
+    std::vector<ClipIndex::Entry> indexEntries;
+    indexEntries.reserve(frameCount());
     for (auto frame = nextFrame(); frame; frame = nextFrame()) {
-        if (!writeFrame(output, *frame)) {
+        FrameSize dataSize { 0 };
+        if (!writeFrame(output, *frame, true, &dataSize)) {
+            return false;
+        }
+        if (frame->type == Frame::TYPE_INVALID) {
+            continue;
+        }
+        ClipIndex::Entry entry;
+        entry.fileOffset = offset + ClipIndex::FRAME_HEADER_SIZE;
+        entry.timeOffset = frame->timeOffset;
+        entry.type = frame->type;
+        entry.size = dataSize;
+        indexEntries.push_back(entry);
+        offset += ClipIndex::FRAME_HEADER_SIZE + dataSize;
+    }
+
+    // The index goes after the frames so readers that predate it still parse the clip
+    for (const auto& indexFrame : ClipIndex::createFrames(std::move(indexEntries), offset)) {
+        if (!writeFrame(output, indexFrame, false)) {
             return false;
         }
     }
@@ -10,6 +10,8 @@
 
 #include <QThread>
 
+#include <NetworkingConstants.h>
+#include <PathUtils.h>
 #include <shared/QtHelpers.h>
 
 #include "impl/PointerClip.h"
@@ -31,6 +33,50 @@ void NetworkClip::init(const QByteArray& clipData) {
     PointerClip::init((uchar*)_clipData.data(), _clipData.size());
 }
 
+NetworkClip::~NetworkClip() {
+    Locker lock(_mutex);
+    if (_file.isOpen()) {
+        _file.unmap(_data);
+        _file.close();
+    }
+    reset();
+}
+
+bool NetworkClip::initFromFile(const QString& filePath) {
+    _file.setFileName(filePath);
+    auto size = _file.size();
+    if (!_file.open(QIODevice::ReadOnly)) {
+        qCWarning(recordingLog) << "Unable to open file " << filePath;
+        return false;
+    }
+    auto mappedFile = _file.map(0, size, QFile::MapPrivateOption);
+    if (!mappedFile) {
+        qCWarning(recordingLog) << "Unable to map file " << filePath;
+        _file.close();
+        return false;
+    }
+    PointerClip::init(mappedFile, size);
+    return true;
+}
+
+void NetworkClipLoader::makeRequest() {
+    if (_activeUrl.scheme() != HIFI_URL_SCHEME_FILE) {
+        Resource::makeRequest();
+        return;
+    }
+
+    auto filePath = PathUtils::expandToLocalDataAbsolutePath(_activeUrl).toLocalFile();
+    bool success = _clip->initFromFile(filePath);
+    ClipCache::requestCompleted(_self);
+    if (!success) {
+        emit failed(QNetworkReply::ContentNotFoundError);
+        finishedLoading(false);
+        return;
+    }
+    finishedLoading(true);
+    emit clipLoaded();
+}
+
 void NetworkClipLoader::downloadFinished(const QByteArray& data) {
     _clip->init(data);
     finishedLoading(true);
@@ -9,6 +9,8 @@
 #ifndef hifi_Recording_ClipCache_h
 #define hifi_Recording_ClipCache_h
 
+#include <QtCore/QFile>
+
 #include <ResourceCache.h>
 
 #include "Forward.h"
@@ -21,11 +23,15 @@ public:
     using Pointer = std::shared_ptr<NetworkClip>;
 
     NetworkClip(const QUrl& url) : _url(url) {}
+    virtual ~NetworkClip();
     virtual void init(const QByteArray& clipData);
+    // Maps a local clip instead of reading it, so decks playing the same file share its pages
+    bool initFromFile(const QString& filePath);
     virtual QString getName() const override { return _url.toString(); }
 
 private:
     QByteArray _clipData;
+    QFile _file;
     QUrl _url;
 };
 
@@ -42,6 +48,9 @@ public:
 signals:
     void clipLoaded();
 
+protected:
+    virtual void makeRequest() override;
+
 private:
     const NetworkClip::Pointer _clip;
 };
@@ -60,6 +69,8 @@ protected:
     QSharedPointer<Resource> createResourceCopy(const QSharedPointer<Resource>& resource) override;
 
 private:
+    friend class NetworkClipLoader;
+
     ClipCache(QObject* parent = nullptr);
 };
 
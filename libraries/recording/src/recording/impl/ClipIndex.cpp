@@ -0,0 +1,138 @@
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ClipIndex.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtCore/QByteArray>
+
+#include "../Logging.h"
+
+using namespace recording;
+
+std::vector<Frame> ClipIndex::createFrames(std::vector<Entry> entries, uint64_t chunksOffset) {
+    // Group the entries into one track per frame type, keeping them in time order within each track
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.type < b.type;
+    });
+
+    std::vector<Track> tracks;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (tracks.empty() || tracks.back().type != entries[i].type) {
+            Track track;
+            track.type = entries[i].type;
+            track.count = 0;
+            track.firstEntry = i;
+            tracks.push_back(track);
+        }
+        ++tracks.back().count;
+    }
+
+    std::vector<Frame> frames;
+    for (size_t first = 0; first < entries.size(); first += ENTRIES_PER_CHUNK) {
+        size_t count = std::min(entries.size() - first, (size_t)ENTRIES_PER_CHUNK);
+        frames.emplace_back(TYPE_CHUNK, 0.0f, QByteArray((const char*)&entries[first], (int)(count * sizeof(Entry))));
+    }
+
+    uint64_t chunksSize = 0;
+    for (const auto& frame : frames) {
+        chunksSize += FRAME_HEADER_SIZE + frame.data.size();
+    }
+    frames.emplace_back(TYPE_TRACKS, 0.0f, QByteArray((const char*)tracks.data(), (int)(tracks.size() * sizeof(Track))));
+
+    Locator locator;
+    locator.magic = MAGIC;
+    locator.version = VERSION;
+    locator.chunksOffset = chunksOffset;
+    locator.tracksOffset = chunksOffset + chunksSize + FRAME_HEADER_SIZE;
+    locator.entryCount = entries.size();
+    frames.emplace_back(TYPE_LOCATOR, 0.0f, QByteArray((const char*)&locator, sizeof(Locator)));
+    return frames;
+}
+
+bool ClipIndex::init(const uchar* data, size_t size) {
+    _data = nullptr;
+    _tracks.clear();
+    if (!data || size < LOCATOR_FRAME_SIZE) {
+        return false;
+    }
+
+    const uchar* locatorFrame = data + size - LOCATOR_FRAME_SIZE;
+    FrameType type;
+    FrameSize frameSize;
+    memcpy(&type, locatorFrame, sizeof(FrameType));
+    memcpy(&frameSize, locatorFrame + sizeof(FrameType) + sizeof(Frame::Time), sizeof(FrameSize));
+    if (type != TYPE_LOCATOR || frameSize != sizeof(Locator)) {
+        return false;
+    }
+
+    Locator locator;
+    memcpy(&locator, locatorFrame + FRAME_HEADER_SIZE, sizeof(Locator));
+    if (locator.magic != MAGIC || locator.version != VERSION) {
+        return false;
+    }
+
+    // Everything the index points at has to be inside the clip
+    uint64_t numChunks = (locator.entryCount + ENTRIES_PER_CHUNK - 1) / ENTRIES_PER_CHUNK;
+    uint64_t chunksSize = numChunks * FRAME_HEADER_SIZE + locator.entryCount * sizeof(Entry);
+    if (locator.chunksOffset > size || chunksSize > size - locator.chunksOffset ||
+        locator.tracksOffset < FRAME_HEADER_SIZE || locator.tracksOffset > size) {
+        qCWarning(recordingLog) << "Clip index is out of bounds, ignoring it";
+        return false;
+    }
+
+    FrameSize tracksSize;
+    memcpy(&tracksSize, data + locator.tracksOffset - sizeof(FrameSize), sizeof(FrameSize));
+    if (tracksSize % sizeof(Track) != 0 || tracksSize > size - locator.tracksOffset) {
+        qCWarning(recordingLog) << "Clip index track table is invalid, ignoring it";
+        return false;
+    }
+
+    _tracks.resize(tracksSize / sizeof(Track));
+    if (!_tracks.empty()) {
+        memcpy(_tracks.data(), data + locator.tracksOffset, tracksSize);
+    }
+    for (const auto& track : _tracks) {
+        if (track.firstEntry + track.count > locator.entryCount) {
+            qCWarning(recordingLog) << "Clip index track is out of bounds, ignoring the index";
+            _tracks.clear();
+            return false;
+        }
+    }
+
+    _data = data;
+    _size = size;
+    _chunksOffset = locator.chunksOffset;
+    _entryCount = locator.entryCount;
+    return true;
+}
+
+ClipIndex::Entry ClipIndex::getEntry(size_t track, size_t position) const {
+    uint64_t index = _tracks[track].firstEntry + position;
+    uint64_t offset = _chunksOffset + (index / ENTRIES_PER_CHUNK) * CHUNK_FRAME_SIZE +
+        FRAME_HEADER_SIZE + (index % ENTRIES_PER_CHUNK) * sizeof(Entry);
+    Entry entry;
+    memcpy(&entry, _data + offset, sizeof(Entry));
+    return entry;
+}
+
+size_t ClipIndex::lowerBound(size_t track, Frame::Time time) const {
+    size_t first = 0;
+    size_t count = _tracks[track].count;
+    while (count > 0) {
+        size_t step = count / 2;
+        if (getEntry(track, first + step).timeOffset < time) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
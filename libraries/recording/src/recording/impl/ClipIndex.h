@@ -0,0 +1,90 @@
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_Impl_ClipIndex_h
+#define hifi_Recording_Impl_ClipIndex_h
+
+#include <vector>
+
+#include "../Frame.h"
+
+namespace recording {
+
+// An index of every frame in a clip, appended after the last frame by Clip::write.
+//
+// It is stored as frames of reserved types that are never in the header's frame type map,
+// so readers that don't know about it skip it like any other unknown frame:
+//
+//   [chunk frame]*     Entry records grouped by frame type into tracks, in time order within each track
+//   [tracks frame]     Track records
+//   [locator frame]    Locator, always the last LOCATOR_FRAME_SIZE bytes of the clip
+//
+// The index is read in place, so opening a clip doesn't touch its frames and clips mapped from
+// the same file share the index pages.
+class ClipIndex {
+public:
+    static const FrameType TYPE_CHUNK = 0xFFFC;
+    static const FrameType TYPE_TRACKS = 0xFFFD;
+    static const FrameType TYPE_LOCATOR = 0xFFFE;
+
+    static const uint32_t MAGIC = 0x58444948; // "HIDX"
+    static const uint32_t VERSION = 1;
+    static const size_t FRAME_HEADER_SIZE = sizeof(FrameType) + sizeof(Frame::Time) + sizeof(FrameSize);
+
+    struct Entry {
+        uint64_t fileOffset; // of the frame data
+        Frame::Time timeOffset;
+        FrameType type;
+        FrameSize size;
+    };
+
+    struct Track {
+        FrameType type;
+        uint16_t padding { 0 };
+        uint32_t count;
+        uint64_t firstEntry;
+    };
+
+    struct Locator {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t chunksOffset; // of the first chunk frame header
+        uint64_t tracksOffset; // of the tracks frame data
+        uint64_t entryCount;
+    };
+
+    static const size_t ENTRIES_PER_CHUNK = 4000;
+    static const size_t CHUNK_FRAME_SIZE = FRAME_HEADER_SIZE + ENTRIES_PER_CHUNK * sizeof(Entry);
+    static const size_t LOCATOR_FRAME_SIZE = FRAME_HEADER_SIZE + sizeof(Locator);
+
+    // Creates the index frames for entries listed in file order, for a clip whose index starts at chunksOffset
+    static std::vector<Frame> createFrames(std::vector<Entry> entries, uint64_t chunksOffset);
+
+    // Returns false if the clip has no valid index
+    bool init(const uchar* data, size_t size);
+    bool isValid() const { return _data != nullptr; }
+
+    size_t getTrackCount() const { return _tracks.size(); }
+    FrameType getTrackType(size_t track) const { return _tracks[track].type; }
+    size_t getTrackSize(size_t track) const { return _tracks[track].count; }
+
+    Entry getEntry(size_t track, size_t position) const;
+    // Position of the first frame of the track at or after time, in O(log n)
+    size_t lowerBound(size_t track, Frame::Time time) const;
+
+private:
+    const uchar* _data { nullptr };
+    size_t _size { 0 };
+    uint64_t _chunksOffset { 0 };
+    uint64_t _entryCount { 0 };
+    std::vector<Track> _tracks;
+};
+
+}
+
+#endif
@@ -79,6 +79,50 @@ void PointerClip::reset() {
     _data = nullptr;
     _size = 0;
     _header = QJsonDocument();
+    _index = ClipIndex();
+    _indexTracks.clear();
+    _indexedFrameCount = 0;
+    _indexedDuration = 0;
+}
+
+bool PointerClip::initFromIndex() {
+    ClipIndex index;
+    if (!index.init(_data, _size)) {
+        return false;
+    }
+
+    // The file header is always the first frame
+    PointerFrameHeader fileHeaderFrameHeader;
+    memcpy(&(fileHeaderFrameHeader.type), _data, sizeof(FrameType));
+    memcpy(&(fileHeaderFrameHeader.size), _data + sizeof(FrameType) + sizeof(Frame::Time), sizeof(FrameSize));
+    if (fileHeaderFrameHeader.type != Frame::TYPE_HEADER || fileHeaderFrameHeader.size > _size - MINIMUM_FRAME_SIZE) {
+        return false;
+    }
+    QByteArray fileHeaderData((char*)_data + MINIMUM_FRAME_SIZE, fileHeaderFrameHeader.size);
+    _header = QJsonDocument::fromBinaryData(fileHeaderData);
+    _compressed = _header.object()[FRAME_COMREPSSION_FLAG].toBool();
+
+    FrameTranslationMap translationMap = parseTranslationMap(_header);
+    if (translationMap.empty()) {
+        return false;
+    }
+
+    // Tracks of frame types we don't know about are skipped as a whole
+    for (size_t track = 0; track < index.getTrackCount(); ++track) {
+        auto trackSize = index.getTrackSize(track);
+        if (0 == trackSize || !translationMap.contains(index.getTrackType(track))) {
+            continue;
+        }
+        IndexTrack indexTrack;
+        indexTrack.track = track;
+        indexTrack.type = translationMap[index.getTrackType(track)];
+        _indexTracks.push_back(indexTrack);
+        _indexedFrameCount += trackSize;
+        _indexedDuration = std::max(_indexedDuration, index.getEntry(track, trackSize - 1).timeOffset);
+    }
+    _index = index;
+    qDebug(recordingLog) << "Loaded clip index with " << _indexedFrameCount << " frames in " << _indexTracks.size() << " tracks";
+    return true;
 }
 
 void PointerClip::init(uchar* data, size_t size) {
@@ -87,6 +131,13 @@ void PointerClip::init(uchar* data, size_t size) {
     _data = data;
     _size = size;
 
+    if (initFromIndex()) {
+        return;
+    }
+    _indexTracks.clear();
+    _indexedFrameCount = 0;
+    _indexedDuration = 0;
+
     auto parsedFrameHeaders = parseFrameHeaders(data, size);
     // Verify that at least one frame exists and that the first frame is a header
     if (0 == parsedFrameHeaders.size()) {
@@ -138,22 +189,158 @@ void PointerClip::init(uchar* data, size_t size) {
 
 // Internal only function, needs no locking
 FrameConstPointer PointerClip::readFrame(size_t frameIndex) const {
-    FramePointer result;
+    FrameConstPointer result;
     if (frameIndex < _frames.size()) {
-        result = std::make_shared<Frame>();
-        const auto& header = _frames[frameIndex];
-        result->type = header.type;
-        result->timeOffset = header.timeOffset;
-        if (header.size) {
-            result->data.insert(0, reinterpret_cast<char*>(_data)+header.fileOffset, header.size);
-            if (_compressed) {
-                result->data = qUncompress(result->data);
-            }
+        result = readFrame(_frames[frameIndex]);
+    }
+    return result;
+}
+
+// Internal only function, needs no locking
+FrameConstPointer PointerClip::readFrame(const PointerFrameHeader& header) const {
+    auto result = std::make_shared<Frame>();
+    result->type = header.type;
+    result->timeOffset = header.timeOffset;
+    if (header.size) {
+        if (header.fileOffset > _size || header.size > _size - header.fileOffset) {
+            qCWarning(recordingLog) << "Frame at offset " << header.fileOffset << " is past the end of the clip";
+            return result;
+        }
+        result->data.insert(0, reinterpret_cast<char*>(_data)+header.fileOffset, header.size);
+        if (_compressed) {
+            result->data = qUncompress(result->data);
         }
     }
     return result;
 }
 
+// Internal only function, needs no locking
+PointerFrameHeader PointerClip::getIndexHeader(const IndexTrack& track) const {
+    auto entry = _index.getEntry(track.track, track.position);
+    PointerFrameHeader header;
+    header.type = track.type;
+    header.timeOffset = entry.timeOffset;
+    header.size = entry.size;
+    header.fileOffset = entry.fileOffset;
+    return header;
+}
+
+// Internal only function, needs no locking
+int PointerClip::nextIndexTrack(const std::vector<IndexTrack>& tracks) const {
+    // Merge the tracks back into file order, which is time order for anything written by Clip::write
+    int result = -1;
+    ClipIndex::Entry next {};
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        const auto& track = tracks[i];
+        if (track.position >= _index.getTrackSize(track.track)) {
+            continue;
+        }
+        auto entry = _index.getEntry(track.track, track.position);
+        if (-1 == result || entry.timeOffset < next.timeOffset ||
+            (entry.timeOffset == next.timeOffset && entry.fileOffset < next.fileOffset)) {
+            result = (int)i;
+            next = entry;
+        }
+    }
+    return result;
+}
+
+float PointerClip::duration() const {
+    Locker lock(_mutex);
+    if (!_index.isValid()) {
+        return ArrayClip::duration();
+    }
+    return Frame::frameTimeToSeconds(_indexedDuration);
+}
+
+size_t PointerClip::frameCount() const {
+    Locker lock(_mutex);
+    if (!_index.isValid()) {
+        return ArrayClip::frameCount();
+    }
+    return _indexedFrameCount;
+}
+
+Clip::Pointer PointerClip::duplicate() const {
+    Locker lock(_mutex);
+    if (!_index.isValid()) {
+        return ArrayClip::duplicate();
+    }
+    auto result = newClip();
+    auto tracks = _indexTracks;
+    for (auto& track : tracks) {
+        track.position = 0;
+    }
+    for (int next = nextIndexTrack(tracks); -1 != next; next = nextIndexTrack(tracks)) {
+        result->addFrame(readFrame(getIndexHeader(tracks[next])));
+        ++tracks[next].position;
+    }
+    return result;
+}
+
+void PointerClip::seekFrameTime(Frame::Time offset) {
+    Locker lock(_mutex);
+    if (!_index.isValid()) {
+        ArrayClip::seekFrameTime(offset);
+        return;
+    }
+    for (auto& track : _indexTracks) {
+        track.position = _index.lowerBound(track.track, offset);
+    }
+}
+
+Frame::Time PointerClip::positionFrameTime() const {
+    Locker lock(_mutex);
+    if (!_index.isValid()) {
+        return ArrayClip::positionFrameTime();
+    }
+    Frame::Time result = Frame::INVALID_TIME;
+    int next = nextIndexTrack(_indexTracks);
+    if (-1 != next) {
+        result = getIndexHeader(_indexTracks[next]).timeOffset;
+    }
+    return result;
+}
+
+FrameConstPointer PointerClip::peekFrame() const {
+    Locker lock(_mutex);
+    if (!_index.isValid()) {
+        return ArrayClip::peekFrame();
+    }
+    FrameConstPointer result;
+    int next = nextIndexTrack(_indexTracks);
+    if (-1 != next) {
+        result = readFrame(getIndexHeader(_indexTracks[next]));
+    }
+    return result;
+}
+
+FrameConstPointer PointerClip::nextFrame() {
+    Locker lock(_mutex);
+    if (!_index.isValid()) {
+        return ArrayClip::nextFrame();
+    }
+    FrameConstPointer result;
+    int next = nextIndexTrack(_indexTracks);
+    if (-1 != next) {
+        result = readFrame(getIndexHeader(_indexTracks[next]));
+        ++_indexTracks[next].position;
+    }
+    return result;
+}
+
+void PointerClip::skipFrame() {
+    Locker lock(_mutex);
+    if (!_index.isValid()) {
+        ArrayClip::skipFrame();
+        return;
+    }
+    int next = nextIndexTrack(_indexTracks);
+    if (-1 != next) {
+        ++_indexTracks[next].position;
+    }
+}
+
 void PointerClip::addFrame(FrameConstPointer) {
     throw std::runtime_error("Pointer clips are read only, use duplicate to create a read/write clip");
 }
@@ -11,6 +11,7 @@
 #define hifi_Recording_Impl_PointerClip_h
 
 #include "ArrayClip.h"
+#include "ClipIndex.h"
 
 #include <mutex>
 
@@ -41,16 +42,44 @@ public:
     const QJsonDocument& getHeader() const {
         return _header;
     }
+    bool isIndexed() const { return _index.isValid(); }
+
+    // Clips written with an index are played back straight from it, without a per frame header list
+    virtual float duration() const override;
+    virtual size_t frameCount() const override;
+    virtual Clip::Pointer duplicate() const override;
+    virtual void seekFrameTime(Frame::Time offset) override;
+    virtual Frame::Time positionFrameTime() const override;
+    virtual FrameConstPointer peekFrame() const override;
+    virtual FrameConstPointer nextFrame() override;
+    virtual void skipFrame() override;
 
     // FIXME move to frame?
     static const qint64 MINIMUM_FRAME_SIZE = sizeof(FrameType) + sizeof(Frame::Time) + sizeof(FrameSize);
 protected:
+    struct IndexTrack {
+        size_t track;
+        FrameType type;
+        size_t position { 0 };
+    };
+
     void reset() override;
+    bool initFromIndex();
     virtual FrameConstPointer readFrame(size_t index) const override;
+    FrameConstPointer readFrame(const PointerFrameHeader& header) const;
+    // Returns the track holding the next frame in playback order, or -1 at the end of the clip
+    int nextIndexTrack(const std::vector<IndexTrack>& tracks) const;
+    PointerFrameHeader getIndexHeader(const IndexTrack& track) const;
+
     QJsonDocument _header;
     uchar* _data { nullptr };
     size_t _size { 0 };
     bool _compressed { true };
+
+    ClipIndex _index;
+    std::vector<IndexTrack> _indexTracks;
+    size_t _indexedFrameCount { 0 };
+    Frame::Time _indexedDuration { 0 };
 };
 
 }
@@ -0,0 +1,62 @@
+//
+//  SpatialTree_avx2.cpp
+//  render/src/avx2
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <stdint.h>
+#include <immintrin.h>
+
+// Classify 8 cubes of the same size against the 6 frustum planes.
+// Result per lane: 0 = Outside, 1 = Intersect, 2 = Inside (see Octree::Location::Intersection)
+void intersectCellLanes_AVX2(const float* minX, const float* minY, const float* minZ, float size,
+                             const float (*frustum)[4], uint8_t* intersections) {
+
+    __m256 x = _mm256_loadu_ps(minX);
+    __m256 y = _mm256_loadu_ps(minY);
+    __m256 z = _mm256_loadu_ps(minZ);
+    __m256 zero = _mm256_setzero_ps();
+
+    __m256 outside = zero;
+    __m256 partial = zero;
+
+    for (int p = 0; p < 6; p++) {
+        const float* plane = frustum[p];
+
+        // the corner furthest along the normal decides Outside, the nearest one decides Intersect
+        float posX = (plane[0] >= 0.0f) ? size : 0.0f;
+        float posY = (plane[1] >= 0.0f) ? size : 0.0f;
+        float posZ = (plane[2] >= 0.0f) ? size : 0.0f;
+        float negX = (plane[0] <= 0.0f) ? size : 0.0f;
+        float negY = (plane[1] <= 0.0f) ? size : 0.0f;
+        float negZ = (plane[2] <= 0.0f) ? size : 0.0f;
+
+        __m256 nx = _mm256_set1_ps(plane[0]);
+        __m256 ny = _mm256_set1_ps(plane[1]);
+        __m256 nz = _mm256_set1_ps(plane[2]);
+        __m256 d = _mm256_set1_ps(plane[3]);
+
+        __m256 pos = _mm256_fmadd_ps(nx, _mm256_add_ps(x, _mm256_set1_ps(posX)), d);
+        pos = _mm256_fmadd_ps(ny, _mm256_add_ps(y, _mm256_set1_ps(posY)), pos);
+        pos = _mm256_fmadd_ps(nz, _mm256_add_ps(z, _mm256_set1_ps(posZ)), pos);
+
+        __m256 neg = _mm256_fmadd_ps(nx, _mm256_add_ps(x, _mm256_set1_ps(negX)), d);
+        neg = _mm256_fmadd_ps(ny, _mm256_add_ps(y, _mm256_set1_ps(negY)), neg);
+        neg = _mm256_fmadd_ps(nz, _mm256_add_ps(z, _mm256_set1_ps(negZ)), neg);
+
+        outside = _mm256_or_ps(outside, _mm256_cmp_ps(pos, zero, _CMP_LT_OQ));
+        partial = _mm256_or_ps(partial, _mm256_cmp_ps(neg, zero, _CMP_LT_OQ));
+    }
+
+    int outsideMask = _mm256_movemask_ps(outside);
+    int partialMask = _mm256_movemask_ps(partial);
+    for (int i = 0; i < 8; i++) {
+        intersections[i] = (outsideMask & (1 << i)) ? 0 : ((partialMask & (1 << i)) ? 1 : 2);
+    }
+}
+
+#endif
@@ -16,9 +16,14 @@
 
 #include <PerfStat.h>
 #include <OctreeUtils.h>
+#include <TBBHelpers.h>
 
 using namespace render;
 
+// Item lists shorter than this are culled on the calling thread, splitting them is not worth the scheduling
+static const size_t MIN_ITEMS_FOR_PARALLEL_CULL = 2048;
+static const size_t CULL_CHUNK_SIZE = 512;
+
 CullTest::CullTest(CullFunctor& functor, RenderArgs* pargs, RenderDetails::Item& renderDetails, ViewFrustumPointer antiFrustum) :
     _functor(functor),
     _args(pargs),
@@ -173,6 +178,55 @@ void CullSpatialSelection::configure(const Config& config) {
     _justFrozeFrustum = _justFrozeFrustum || (config.freezeFrustum && !_freezeFrustum);
     _freezeFrustum = config.freezeFrustum;
     _skipCulling = config.skipCulling;
+    _parallel = config.parallel;
+}
+
+void CullSpatialSelection::cullSelectedItems(Scene& scene, const ItemFilter& filter, RenderArgs* args, RenderDetails::Item& details,
+                                             const ItemIDs& inItems, bool frustumTest, bool solidAngleTest, ItemBounds& outItems) {
+    auto cullRange = [&](CullTest& test, size_t begin, size_t end, ItemBounds& rangeOutItems) {
+        for (size_t i = begin; i < end; i++) {
+            auto id = inItems[i];
+            auto& item = scene.getItem(id);
+            if (filter.test(item.getKey())) {
+                ItemBound itemBound(id, item.getBound());
+                if ((!frustumTest || test.frustumTest(itemBound.bound)) &&
+                    (!solidAngleTest || test.solidAngleTest(itemBound.bound))) {
+                    rangeOutItems.emplace_back(itemBound);
+                    if (item.getKey().isMetaCullGroup()) {
+                        item.fetchMetaSubItemBounds(rangeOutItems, scene);
+                    }
+                }
+            }
+        }
+    };
+
+    if (!_parallel || inItems.size() < MIN_ITEMS_FOR_PARALLEL_CULL) {
+        CullTest test(_cullFunctor, args, details);
+        cullRange(test, 0, inItems.size(), outItems);
+        return;
+    }
+
+    // The selection lists are gathered brick after brick so fixed size chunks keep neighbouring cells together.
+    // Every chunk culls into its own list with its own counters, the lists are then appended in chunk order
+    // so the output is identical to the serial version whatever the scheduling.
+    size_t numChunks = (inItems.size() + CULL_CHUNK_SIZE - 1) / CULL_CHUNK_SIZE;
+    std::vector<ItemBounds> chunkOutItems(numChunks);
+    std::vector<RenderDetails::Item> chunkDetails(numChunks);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numChunks), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t chunk = range.begin(); chunk != range.end(); ++chunk) {
+            CullTest test(_cullFunctor, args, chunkDetails[chunk]);
+            size_t begin = chunk * CULL_CHUNK_SIZE;
+            size_t end = std::min(begin + CULL_CHUNK_SIZE, inItems.size());
+            chunkOutItems[chunk].reserve(end - begin);
+            cullRange(test, begin, end, chunkOutItems[chunk]);
+        }
+    });
+
+    for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+        outItems.insert(outItems.end(), chunkOutItems[chunk].begin(), chunkOutItems[chunk].end());
+        details._outOfView += chunkDetails[chunk]._outOfView;
+        details._tooSmall += chunkDetails[chunk]._tooSmall;
+    }
 }
 
 void CullSpatialSelection::run(const RenderContextPointer& renderContext,
@@ -195,8 +249,6 @@ void CullSpatialSelection::run(const RenderContextPointer& renderContext,
         args->pushViewFrustum(_frozenFrustum); // replace the true view frustum by the frozen one
     }
 
-    CullTest test(_cullFunctor, args, details);
-
     // Now we have a selection of items to render
     outItems.clear();
     outItems.reserve(inSelection.numItems());
@@ -209,136 +261,27 @@ void CullSpatialSelection::run(const RenderContextPointer& renderContext,
         // filter individually against the _filter
         // visibility cull if partially selected ( octree cell contianing it was partial)
         // distance cull if was a subcell item ( octree cell is way bigger than the item bound itself, so now need to test per item)
-        if (_skipCulling) {
-            // inside & fit items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("insideFitItems");
-                for (auto id : inSelection.insideItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
-            // inside & subcell items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("insideSmallItems");
-                for (auto id : inSelection.insideSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
-            // partial & fit items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("partialFitItems");
-                for (auto id : inSelection.partialItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
-            // partial & subcell items: filter only, culling is disabled
-            {
-                PerformanceTimer perfTimer("partialSmallItems");
-                for (auto id : inSelection.partialSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
-        } else {
-
+        // When culling is disabled all the items are only filtered.
+        bool cull = !_skipCulling;
+        {
             // inside & fit items: easy, just filter
-            {
-                PerformanceTimer perfTimer("insideFitItems");
-                for (auto id : inSelection.insideItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        outItems.emplace_back(itemBound);
-                        if (item.getKey().isMetaCullGroup()) {
-                            item.fetchMetaSubItemBounds(outItems, (*scene));
-                        }
-                    }
-                }
-            }
-
+            PerformanceTimer perfTimer("insideFitItems");
+            cullSelectedItems(*scene, filter, args, details, inSelection.insideItems, false, false, outItems);
+        }
+        {
             // inside & subcell items: filter & distance cull
-            {
-                PerformanceTimer perfTimer("insideSmallItems");
-                for (auto id : inSelection.insideSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        if (test.solidAngleTest(itemBound.bound)) {
-                            outItems.emplace_back(itemBound);
-                            if (item.getKey().isMetaCullGroup()) {
-                                item.fetchMetaSubItemBounds(outItems, (*scene));
-                            }
-                        }
-                    }
-                }
-            }
-
+            PerformanceTimer perfTimer("insideSmallItems");
+            cullSelectedItems(*scene, filter, args, details, inSelection.insideSubcellItems, false, cull, outItems);
+        }
+        {
             // partial & fit items: filter & frustum cull
-            {
-                PerformanceTimer perfTimer("partialFitItems");
-                for (auto id : inSelection.partialItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        if (test.frustumTest(itemBound.bound)) {
-                            outItems.emplace_back(itemBound);
-                            if (item.getKey().isMetaCullGroup()) {
-                                item.fetchMetaSubItemBounds(outItems, (*scene));
-                            }
-                        }
-                    }
-                }
-            }
-
+            PerformanceTimer perfTimer("partialFitItems");
+            cullSelectedItems(*scene, filter, args, details, inSelection.partialItems, cull, false, outItems);
+        }
+        {
             // partial & subcell items:: filter & frutum cull & solidangle cull
-            {
-                PerformanceTimer perfTimer("partialSmallItems");
-                for (auto id : inSelection.partialSubcellItems) {
-                    auto& item = scene->getItem(id);
-                    if (filter.test(item.getKey())) {
-                        ItemBound itemBound(id, item.getBound());
-                        if (test.frustumTest(itemBound.bound)) {
-                            if (test.solidAngleTest(itemBound.bound)) {
-                                outItems.emplace_back(itemBound);
-                                if (item.getKey().isMetaCullGroup()) {
-                                    item.fetchMetaSubItemBounds(outItems, (*scene));
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+            PerformanceTimer perfTimer("partialSmallItems");
+            cullSelectedItems(*scene, filter, args, details, inSelection.partialSubcellItems, cull, cull, outItems);
         }
     }
 
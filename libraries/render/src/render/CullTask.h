@@ -86,15 +86,18 @@ namespace render {
         Q_PROPERTY(int numItems READ getNumItems)
         Q_PROPERTY(bool freezeFrustum MEMBER freezeFrustum WRITE setFreezeFrustum)
         Q_PROPERTY(bool skipCulling MEMBER skipCulling WRITE setSkipCulling)
+        Q_PROPERTY(bool parallel MEMBER parallel WRITE setParallel)
     public:
         int numItems{ 0 };
         int getNumItems() { return numItems; }
 
         bool freezeFrustum{ false };
         bool skipCulling{ false };
+        bool parallel{ true };
     public slots:
         void setFreezeFrustum(bool enabled) { freezeFrustum = enabled; emit dirty(); }
         void setSkipCulling(bool enabled) { skipCulling = enabled; emit dirty(); }
+        void setParallel(bool enabled) { parallel = enabled; emit dirty(); }
     signals:
         void dirty();
     };
@@ -103,6 +106,7 @@ namespace render {
         bool _freezeFrustum{ false }; // initialized by Config
         bool _justFrozeFrustum{ false };
         bool _skipCulling{ false };
+        bool _parallel{ true };
         ViewFrustum _frozenFrustum;
     public:
         using Config = CullSpatialSelectionConfig;
@@ -122,6 +126,11 @@ namespace render {
 
         void configure(const Config& config);
         void run(const RenderContextPointer& renderContext, const Inputs& inputs, ItemBounds& outItems);
+
+    protected:
+        // Filter and cull one of the selection item lists, spreading large lists over the tbb workers
+        void cullSelectedItems(Scene& scene, const ItemFilter& filter, RenderArgs* args, RenderDetails::Item& details,
+                               const ItemIDs& inItems, bool frustumTest, bool solidAngleTest, ItemBounds& outItems);
     };
 
     class CullShapeBounds {
@@ -11,7 +11,9 @@
 #include "Scene.h"
 
 #include <numeric>
+#include <unordered_set>
 #include <gpu/Batch.h>
+#include <SharedUtil.h>
 #include "Logging.h"
 #include "TransitionStage.h"
 #include "HighlightStage.h"
@@ -180,6 +182,52 @@ void Transaction::clear() {
     _highlightQueries.clear();
 }
 
+size_t Transaction::coalesce() {
+    size_t numDropped = 0;
+
+    if (_resetItems.size() > 1) {
+        std::unordered_map<ItemID, size_t> lastResets;
+        lastResets.reserve(_resetItems.size());
+        for (size_t i = 0; i < _resetItems.size(); ++i) {
+            lastResets[std::get<0>(_resetItems[i])] = i;
+        }
+        if (lastResets.size() < _resetItems.size()) {
+            Resets resets;
+            resets.reserve(lastResets.size());
+            for (size_t i = 0; i < _resetItems.size(); ++i) {
+                if (lastResets[std::get<0>(_resetItems[i])] == i) {
+                    resets.emplace_back(std::move(_resetItems[i]));
+                }
+            }
+            numDropped += _resetItems.size() - resets.size();
+            _resetItems.swap(resets);
+        }
+    }
+
+    if (!_updatedItems.empty()) {
+        // A null update only refreshes the key and bound, which a later update or a remove makes useless
+        std::unordered_set<ItemID> updatedOrRemoved(_removedItems.begin(), _removedItems.end());
+        Updates updates;
+        updates.reserve(_updatedItems.size());
+        for (auto itr = _updatedItems.rbegin(); itr != _updatedItems.rend(); ++itr) {
+            auto id = std::get<0>(*itr);
+            bool isNull = !std::get<1>(*itr);
+            if (isNull && updatedOrRemoved.count(id)) {
+                continue;
+            }
+            updatedOrRemoved.insert(id);
+            updates.emplace_back(std::move(*itr));
+        }
+        if (updates.size() < _updatedItems.size()) {
+            numDropped += _updatedItems.size() - updates.size();
+            std::reverse(updates.begin(), updates.end());
+            _updatedItems.swap(updates);
+        }
+    }
+
+    return numDropped;
+}
+
 
 Scene::Scene(glm::vec3 origin, float size) :
     _masterSpatialTree(origin, size)
@@ -219,11 +267,13 @@ uint32_t Scene::enqueueFrame() {
         localTransactionQueue.swap(_transactionQueue);
     }
 
+    uint32_t numTransactions = (uint32_t)localTransactionQueue.size();
     Transaction consolidatedTransaction;
     consolidatedTransaction.merge(std::move(localTransactionQueue));
     {
         std::unique_lock<std::mutex> lock(_transactionFramesMutex);
-        _transactionFrames.push_back(consolidatedTransaction);
+        _transactionFrames.push_back(std::move(consolidatedTransaction));
+        _transactionFrameSizes.push_back(numTransactions);
     }
 
     return ++_transactionFrameNumber;
@@ -232,23 +282,49 @@ uint32_t Scene::enqueueFrame() {
  
 void Scene::processTransactionQueue() {
     PROFILE_RANGE(render, __FUNCTION__);
+    uint64_t startTime = usecTimestampNow();
+    uint64_t budget = _transactionTimeBudget.load();
+    uint64_t deadline = (budget > 0) ? startTime + budget : 0;
 
     static TransactionFrames queuedFrames;
+    static std::vector<uint32_t> queuedFrameSizes;
     {
         // capture the queued frames and clear the queue
         std::unique_lock<std::mutex> lock(_transactionFramesMutex);
         queuedFrames.swap(_transactionFrames);
+        queuedFrameSizes.swap(_transactionFrameSizes);
     }
 
+    TransactionStats stats;
+    stats.numFrames = (uint32_t)queuedFrames.size();
+    stats.numQueuedTransactions = std::accumulate(queuedFrameSizes.begin(), queuedFrameSizes.end(), 0U);
+
+    // the resets left over by the previous calls go first
+    processPendingResets(deadline, stats);
+
     // go through the queue of frames and process them
     for (auto& frame : queuedFrames) {
-        processTransactionFrame(frame);
+        stats.numCoalesced += (uint32_t)frame.coalesce();
+        processTransactionFrame(frame, deadline, stats);
     }
 
     queuedFrames.clear();
+    queuedFrameSizes.clear();
+
+    stats.numPendingResets = (uint32_t)_pendingResetIndices.size();
+    stats.processingTime = usecTimestampNow() - startTime;
+    {
+        std::unique_lock<std::mutex> lock(_transactionStatsMutex);
+        _transactionStats = stats;
+    }
 }
 
-void Scene::processTransactionFrame(const Transaction& transaction) {
+Scene::TransactionStats Scene::getTransactionStats() const {
+    std::unique_lock<std::mutex> lock(_transactionStatsMutex);
+    return _transactionStats;
+}
+
+void Scene::processTransactionFrame(const Transaction& transaction, uint64_t deadline, TransactionStats& stats) {
     PROFILE_RANGE(render, __FUNCTION__);
     {
         std::unique_lock<std::mutex> lock(_itemsMutex);
@@ -262,18 +338,26 @@ void Scene::processTransactionFrame(const Transaction& transaction) {
         // capture anything coming from the transaction
 
         // resets and potential NEW items
-        resetItems(transaction._resetItems);
+        stats.numResets += (uint32_t)resetItems(transaction._resetItems, deadline);
 
         // Update the numItemsAtomic counter AFTER the reset changes went through
         _numAllocatedItems.exchange(maxID);
 
         // updates
+        applyPendingResets(transaction._updatedItems);
         updateItems(transaction._updatedItems);
+        stats.numUpdates += (uint32_t)transaction._updatedItems.size();
 
         // removes
+        discardPendingResets(transaction._removedItems);
         removeItems(transaction._removedItems);
+        stats.numRemoves += (uint32_t)transaction._removedItems.size();
 
         // add transitions
+        applyPendingResets(transaction._resetTransitions);
+        applyPendingResets(transaction._removeTransitions);
+        applyPendingResets(transaction._queriedTransitions);
+        applyPendingResets(transaction._transitionFinishedOperators);
         resetTransitionItems(transaction._resetTransitions);
         removeTransitionItems(transaction._removeTransitions);
         queryTransitionItems(transaction._queriedTransitions);
@@ -290,8 +374,61 @@ void Scene::processTransactionFrame(const Transaction& transaction) {
     queryHighlights(transaction._highlightQueries);
 }
 
-void Scene::resetItems(const Transaction::Resets& transactions) {
-    for (auto& reset : transactions) {
+// Resets are applied by batches of this size, checking the time budget in between
+static const size_t RESET_BATCH_SIZE = 256;
+
+// Below this many new spatial items in a batch they are inserted one at a time in the spatial tree
+static const size_t MIN_ITEMS_FOR_BULK_INSERT = 32;
+
+size_t Scene::resetItems(const Transaction::Resets& transactions, uint64_t deadline) {
+    size_t numApplied = 0;
+    size_t numResets = transactions.size();
+    size_t i = 0;
+    while (i < numResets) {
+        // Out of time, the rest waits for the next frames
+        if (deadline > 0 && usecTimestampNow() > deadline) {
+            break;
+        }
+
+        // A reset on an item already pending replaces the pending one so the item resets stay in order
+        auto pending = _pendingResetIndices.find(std::get<0>(transactions[i]));
+        if (pending != _pendingResetIndices.end()) {
+            _pendingResets[pending->second] = transactions[i];
+            ++i;
+            continue;
+        }
+
+        size_t batchEnd = i + 1;
+        while (batchEnd < numResets && (batchEnd - i) < RESET_BATCH_SIZE &&
+               (_pendingResetIndices.empty() || !_pendingResetIndices.count(std::get<0>(transactions[batchEnd])))) {
+            ++batchEnd;
+        }
+        resetItemsBatch(transactions.data() + i, transactions.data() + batchEnd);
+        numApplied += batchEnd - i;
+        i = batchEnd;
+    }
+
+    for (; i < numResets; ++i) {
+        auto itemId = std::get<0>(transactions[i]);
+        auto pending = _pendingResetIndices.find(itemId);
+        if (pending != _pendingResetIndices.end()) {
+            _pendingResets[pending->second] = transactions[i];
+        } else {
+            _pendingResetIndices[itemId] = _pendingResets.size();
+            _pendingResets.push_back(transactions[i]);
+        }
+    }
+    return numApplied;
+}
+
+void Scene::resetItemsBatch(const Transaction::Reset* begin, const Transaction::Reset* end) {
+    // The new spatial items are collected to be inserted together in the spatial tree
+    ItemBounds newItems;
+    std::vector<ItemKey> newKeys;
+    bool bulkInsert = (size_t)(end - begin) >= MIN_ITEMS_FOR_BULK_INSERT;
+
+    for (auto itr = begin; itr != end; ++itr) {
+        auto& reset = *itr;
         // Access the true item
         auto itemId = std::get<0>(reset);
         auto& item = _items[itemId];
@@ -305,12 +442,102 @@ void Scene::resetItems(const Transaction::Resets& transactions) {
         // Update the item's container
         assert((oldKey.isSpatial() == newKey.isSpatial()) || oldKey._flags.none());
         if (newKey.isSpatial()) {
-            auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), itemId, newKey);
-            item.resetCell(newCell, newKey.isSmall());
+            if (bulkInsert && oldCell == ItemSpatialTree::INVALID_CELL) {
+                newItems.emplace_back(itemId, item.getBound());
+                newKeys.push_back(newKey);
+            } else {
+                auto newCell = _masterSpatialTree.resetItem(oldCell, oldKey, item.getBound(), itemId, newKey);
+                item.resetCell(newCell, newKey.isSmall());
+            }
         } else {
             _masterNonspatialSet.insert(itemId);
         }
     }
+
+    if (!newItems.empty()) {
+        ItemSpatialTree::Indices newCells;
+        _masterSpatialTree.insertItems(newItems, newKeys, newCells);
+        for (size_t i = 0; i < newItems.size(); ++i) {
+            _items[newItems[i].id].resetCell(newCells[i], newKeys[i].isSmall());
+        }
+    }
+}
+
+void Scene::processPendingResets(uint64_t deadline, TransactionStats& stats) {
+    if (_pendingResetIndices.empty()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_itemsMutex);
+    ItemID maxID = _IDAllocator.load();
+    if (maxID > _items.size()) {
+        _items.resize(maxID + 100); // allocate the maxId and more
+    }
+
+    // At least one batch goes through every call so the pending resets always drain
+    while (_pendingResetsHead < _pendingResets.size()) {
+        // Gather the next batch of resets still pending
+        Transaction::Resets batch;
+        batch.reserve(RESET_BATCH_SIZE);
+        while (_pendingResetsHead < _pendingResets.size() && batch.size() < RESET_BATCH_SIZE) {
+            auto& reset = _pendingResets[_pendingResetsHead++];
+            if (std::get<1>(reset)) {
+                _pendingResetIndices.erase(std::get<0>(reset));
+                batch.emplace_back(std::move(reset));
+            }
+        }
+        resetItemsBatch(batch.data(), batch.data() + batch.size());
+        stats.numResets += (uint32_t)batch.size();
+
+        if (deadline > 0 && usecTimestampNow() > deadline) {
+            break;
+        }
+    }
+
+    if (_pendingResetsHead >= _pendingResets.size()) {
+        _pendingResets.clear();
+        _pendingResetsHead = 0;
+    } else if (_pendingResetsHead > _pendingResets.size() / 2) {
+        // Drop the consumed head so a steady inflow doesn't grow the list forever
+        _pendingResets.erase(_pendingResets.begin(), _pendingResets.begin() + _pendingResetsHead);
+        _pendingResetsHead = 0;
+        for (size_t i = 0; i < _pendingResets.size(); ++i) {
+            if (std::get<1>(_pendingResets[i])) {
+                _pendingResetIndices[std::get<0>(_pendingResets[i])] = i;
+            }
+        }
+    }
+}
+
+void Scene::applyPendingReset(ItemID id) {
+    auto pending = _pendingResetIndices.find(id);
+    if (pending == _pendingResetIndices.end()) {
+        return;
+    }
+    auto& reset = _pendingResets[pending->second];
+    resetItemsBatch(&reset, &reset + 1);
+    std::get<1>(reset).reset();
+    _pendingResetIndices.erase(pending);
+}
+
+void Scene::applyPendingResets(const ItemIDs& ids) {
+    if (!_pendingResetIndices.empty()) {
+        for (auto id : ids) {
+            applyPendingReset(id);
+        }
+    }
+}
+
+void Scene::discardPendingResets(const ItemIDs& ids) {
+    if (!_pendingResetIndices.empty()) {
+        for (auto id : ids) {
+            auto pending = _pendingResetIndices.find(id);
+            if (pending != _pendingResetIndices.end()) {
+                std::get<1>(_pendingResets[pending->second]).reset();
+                _pendingResetIndices.erase(pending);
+            }
+        }
+    }
 }
 
 void Scene::removeItems(const Transaction::Removes& transactions) {
@@ -76,6 +76,11 @@ public:
     void merge(Transaction&& transaction);
     void clear();
 
+    // Drop the item commands made redundant by later ones in the same transaction:
+    // only the last reset of an item is kept, and a null update is dropped if the item is updated again later
+    // or removed. Returns the number of commands dropped.
+    size_t coalesce();
+
 protected:
 
     using Reset = std::tuple<ItemID, PayloadPointer>;
@@ -156,8 +161,28 @@ public:
     uint32_t enqueueFrame();
 
     // Process the pending transactions queued
+    // With a time budget, the item resets not applied in time are kept pending for the next calls.
+    // Any other command on a pending item applies its reset first.
     void processTransactionQueue();
 
+    // Time budget in usec for processTransactionQueue, 0 for unlimited
+    void setTransactionTimeBudget(uint64_t budget) { _transactionTimeBudget = budget; }
+    uint64_t getTransactionTimeBudget() const { return _transactionTimeBudget; }
+
+    // Metrics of the last processTransactionQueue call
+    struct TransactionStats {
+        uint32_t numQueuedTransactions { 0 }; // transactions consolidated in the frames processed
+        uint32_t numFrames { 0 };
+        uint32_t numResets { 0 };
+        uint32_t numUpdates { 0 };
+        uint32_t numRemoves { 0 };
+        uint32_t numCoalesced { 0 };
+        uint32_t numPendingResets { 0 };      // resets left for the next calls
+        uint64_t processingTime { 0 };        // usec
+    };
+    // Thread safe
+    TransactionStats getTransactionStats() const;
+
     // Access a particular selection (empty if doesn't exist)
     // Thread safe
     Selection getSelection(const Selection::Name& name) const;
@@ -206,10 +231,33 @@ protected:
     std::mutex _transactionFramesMutex;
     using TransactionFrames = std::vector<Transaction>;
     TransactionFrames _transactionFrames;
+    std::vector<uint32_t> _transactionFrameSizes; // number of transactions consolidated in each frame
     uint32_t _transactionFrameNumber{ 0 };
 
+    std::atomic<uint64_t> _transactionTimeBudget { 0 };
+    mutable std::mutex _transactionStatsMutex;
+    TransactionStats _transactionStats;
+
     // Process one transaction frame 
-    void processTransactionFrame(const Transaction& transaction);
+    void processTransactionFrame(const Transaction& transaction, uint64_t deadline, TransactionStats& stats);
+
+    // The resets deferred by the time budget, in submission order.
+    // Applied ones are nulled in place, the index map gives the position of each pending item.
+    Transaction::Resets _pendingResets;
+    size_t _pendingResetsHead { 0 };
+    std::unordered_map<ItemID, size_t> _pendingResetIndices;
+
+    void processPendingResets(uint64_t deadline, TransactionStats& stats);
+    void applyPendingReset(ItemID id);
+    void discardPendingResets(const ItemIDs& ids);
+    void applyPendingResets(const ItemIDs& ids);
+    template <class T> void applyPendingResets(const std::vector<T>& commands) {
+        if (!_pendingResetIndices.empty()) {
+            for (auto& command : commands) {
+                applyPendingReset(std::get<0>(command));
+            }
+        }
+    }
 
     // The actual database
     // database of items is protected for editing by a mutex
@@ -218,7 +266,9 @@ protected:
     ItemSpatialTree _masterSpatialTree;
     ItemIDSet _masterNonspatialSet;
 
-    void resetItems(const Transaction::Resets& transactions);
+    // Apply the resets until the deadline (0 for none) and keep the rest pending, returns the number applied
+    size_t resetItems(const Transaction::Resets& transactions, uint64_t deadline = 0);
+    void resetItemsBatch(const Transaction::Reset* begin, const Transaction::Reset* end);
     void resetTransitionFinishedOperator(const Transaction::TransitionFinishedOperators& transactions);
     void removeItems(const Transaction::Removes& transactions);
     void updateItems(const Transaction::Updates& transactions);
@@ -14,6 +14,7 @@
 
 #include <assert.h>
 #include <ViewFrustum.h>
+#include <TBBHelpers.h>
 
 using namespace render;
 
@@ -28,51 +29,66 @@ struct ItemBoundSort {
     ItemBoundSort(float centerDepth, float nearDepth, float farDepth, ItemID id, const AABox& bounds) : _centerDepth(centerDepth), _nearDepth(nearDepth), _farDepth(farDepth), _id(id), _bounds(bounds) {}
 };
 
+// Below this many items the sorting jobs stay on the calling thread
+static const size_t MIN_ITEMS_FOR_PARALLEL_SORT = 4096;
+
+// Items at the same depth are ordered by id so the result does not depend on the sort algorithm or the scheduling
 struct FrontToBackSort {
-    bool operator() (const ItemBoundSort& left, const ItemBoundSort& right) {
-        return (left._centerDepth < right._centerDepth);
+    bool operator() (const ItemBoundSort& left, const ItemBoundSort& right) const {
+        return (left._centerDepth < right._centerDepth) || (left._centerDepth == right._centerDepth && left._id < right._id);
     }
 };
 
 struct BackToFrontSort {
-    bool operator() (const ItemBoundSort& left, const ItemBoundSort& right) {
-        return (left._centerDepth > right._centerDepth);
+    bool operator() (const ItemBoundSort& left, const ItemBoundSort& right) const {
+        return (left._centerDepth > right._centerDepth) || (left._centerDepth == right._centerDepth && left._id < right._id);
     }
 };
 
+template <typename Sort>
+static void sortItemBounds(std::vector<ItemBoundSort>& itemBoundSorts, const Sort& sort, bool parallel) {
+    if (parallel) {
+        tbb::parallel_sort(itemBoundSorts.begin(), itemBoundSorts.end(), sort);
+    } else {
+        std::sort(itemBoundSorts.begin(), itemBoundSorts.end(), sort);
+    }
+}
+
 void render::depthSortItems(const RenderContextPointer& renderContext, bool frontToBack, 
                             const ItemBounds& inItems, ItemBounds& outItems, AABox* bounds) {
     assert(renderContext->args);
     assert(renderContext->args->hasViewFrustum());
 
-    auto& scene = renderContext->_scene;
     RenderArgs* args = renderContext->args;
-
+    const ViewFrustum& frustum = args->getViewFrustum();
+    bool parallel = inItems.size() >= MIN_ITEMS_FOR_PARALLEL_SORT;
 
     // Allocate and simply copy
     outItems.clear();
     outItems.reserve(inItems.size());
 
-
     // Make a local dataset of the center distance and closest point distance
-    std::vector<ItemBoundSort> itemBoundSorts;
-    itemBoundSorts.reserve(outItems.size());
-
-    for (auto itemDetails : inItems) {
-        auto item = scene->getItem(itemDetails.id);
-        auto bound = itemDetails.bound; // item.getBound();
-        float distanceSquared = args->getViewFrustum().distanceToCameraSquared(bound.calcCenter());
-
-        itemBoundSorts.emplace_back(ItemBoundSort(distanceSquared, distanceSquared, distanceSquared, itemDetails.id, bound));
+    std::vector<ItemBoundSort> itemBoundSorts(inItems.size());
+    auto evalItemBoundSorts = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const auto& bound = inItems[i].bound;
+            float distanceSquared = frustum.distanceToCameraSquared(bound.calcCenter());
+            itemBoundSorts[i] = ItemBoundSort(distanceSquared, distanceSquared, distanceSquared, inItems[i].id, bound);
+        }
+    };
+    if (parallel) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, inItems.size()), [&](const tbb::blocked_range<size_t>& range) {
+            evalItemBoundSorts(range.begin(), range.end());
+        });
+    } else {
+        evalItemBoundSorts(0, inItems.size());
     }
 
     // sort against Z
     if (frontToBack) {
-        FrontToBackSort frontToBackSort;
-        std::sort(itemBoundSorts.begin(), itemBoundSorts.end(), frontToBackSort);
+        sortItemBounds(itemBoundSorts, FrontToBackSort(), parallel);
     } else {
-        BackToFrontSort  backToFrontSort;
-        std::sort(itemBoundSorts.begin(), itemBoundSorts.end(), backToFrontSort);
+        sortItemBounds(itemBoundSorts, BackToFrontSort(), parallel);
     }
 
     // Finally once sorted result to a list of itemID and keep uniques
@@ -102,15 +118,31 @@ void PipelineSortShapes::run(const RenderContextPointer& renderContext, const It
     auto& scene = renderContext->_scene;
     outShapes.clear();
 
-    for (const auto& item : inItems) {
-        auto key = scene->getItem(item.id).getShapeKey();
+    // Fetching the shape keys goes through the item payloads, do it up front and in parallel for large lists
+    std::vector<ShapeKey> shapeKeys(inItems.size());
+    auto fetchShapeKeys = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            shapeKeys[i] = scene->getItem(inItems[i].id).getShapeKey();
+        }
+    };
+    if (inItems.size() >= MIN_ITEMS_FOR_PARALLEL_SORT) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, inItems.size()), [&](const tbb::blocked_range<size_t>& range) {
+            fetchShapeKeys(range.begin(), range.end());
+        });
+    } else {
+        fetchShapeKeys(0, inItems.size());
+    }
+
+    // Bucketing stays serial so every bucket keeps the input order
+    for (size_t i = 0; i < inItems.size(); i++) {
+        const auto& key = shapeKeys[i];
         auto outItems = outShapes.find(key);
         if (outItems == outShapes.end()) {
             outItems = outShapes.insert(std::make_pair(key, ItemBounds{})).first;
             outItems->second.reserve(inItems.size());
         }
 
-        outItems->second.push_back(item);
+        outItems->second.push_back(inItems[i]);
     }
 
     for (auto& items : outShapes) {
@@ -118,40 +150,55 @@ void PipelineSortShapes::run(const RenderContextPointer& renderContext, const It
     }
 }
 
-void DepthSortShapes::run(const RenderContextPointer& renderContext, const ShapeBounds& inShapes, ShapeBounds& outShapes) {
+// Depth sort every pipeline bucket, the buckets being independent they are sorted concurrently
+static void depthSortShapes(const RenderContextPointer& renderContext, bool frontToBack, const ShapeBounds& inShapes,
+                            ShapeBounds& outShapes, AABox* outBounds) {
     outShapes.clear();
     outShapes.reserve(inShapes.size());
 
+    std::vector<std::pair<const ItemBounds*, ItemBounds*>> buckets;
+    buckets.reserve(inShapes.size());
+    size_t numItems = 0;
     for (auto& pipeline : inShapes) {
-        auto& inItems = pipeline.second;
         auto outItems = outShapes.find(pipeline.first);
         if (outItems == outShapes.end()) {
             outItems = outShapes.insert(std::make_pair(pipeline.first, ItemBounds{})).first;
         }
+        buckets.emplace_back(&pipeline.second, &outItems->second);
+        numItems += pipeline.second.size();
+    }
+
+    std::vector<AABox> bucketBounds(buckets.size());
+    auto sortBuckets = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            depthSortItems(renderContext, frontToBack, *buckets[i].first, *buckets[i].second, outBounds ? &bucketBounds[i] : nullptr);
+        }
+    };
+    if (buckets.size() > 1 && numItems >= MIN_ITEMS_FOR_PARALLEL_SORT) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, buckets.size(), 1), [&](const tbb::blocked_range<size_t>& range) {
+            sortBuckets(range.begin(), range.end());
+        });
+    } else {
+        sortBuckets(0, buckets.size());
+    }
 
-        depthSortItems(renderContext, _frontToBack, inItems, outItems->second);
+    if (outBounds) {
+        for (auto& bounds : bucketBounds) {
+            *outBounds += bounds;
+        }
     }
 }
 
+void DepthSortShapes::run(const RenderContextPointer& renderContext, const ShapeBounds& inShapes, ShapeBounds& outShapes) {
+    depthSortShapes(renderContext, _frontToBack, inShapes, outShapes, nullptr);
+}
+
 void DepthSortShapesAndComputeBounds::run(const RenderContextPointer& renderContext, const ShapeBounds& inShapes, Outputs& outputs) {
     auto& outShapes = outputs.edit0();
     auto& outBounds = outputs.edit1();
 
-    outShapes.clear();
-    outShapes.reserve(inShapes.size());
     outBounds = AABox();
-
-    for (auto& pipeline : inShapes) {
-        auto& inItems = pipeline.second;
-        auto outItems = outShapes.find(pipeline.first);
-        if (outItems == outShapes.end()) {
-            outItems = outShapes.insert(std::make_pair(pipeline.first, ItemBounds{})).first;
-        }
-        AABox bounds;
-
-        depthSortItems(renderContext, _frontToBack, inItems, outItems->second, &bounds);
-        outBounds += bounds;
-    }
+    depthSortShapes(renderContext, _frontToBack, inShapes, outShapes, &outBounds);
 }
 
 void DepthSortItems::run(const RenderContextPointer& renderContext, const ItemBounds& inItems, ItemBounds& outItems) {
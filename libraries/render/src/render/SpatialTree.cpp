@@ -10,7 +10,10 @@
 //
 #include "SpatialTree.h"
 
+#include <numeric>
+
 #include <ViewFrustum.h>
+#include <TBBHelpers.h>
 
 using namespace render;
 
@@ -32,6 +35,128 @@ float Octree::OrthographicSelector::testThreshold(const Coord3f& point, float si
     return (size * size) - squareMinSize;
 }
 
+void Octree::PerspectiveSelector::testThresholds(const CellLanes& lanes, float tests[CellLanes::NUM_LANES]) const {
+    // Same test as testThreshold() on the center of every lane, all the lanes share the same size
+    float halfSize = 0.5f * lanes.size;
+    float size = Octree::getCoordSubcellWidth(lanes.depth);
+    float squareSize = size * size;
+    for (int i = 0; i < CellLanes::NUM_LANES; i++) {
+        float dx = (lanes.minX[i] + halfSize) - eyePos.x;
+        float dy = (lanes.minY[i] + halfSize) - eyePos.y;
+        float dz = (lanes.minZ[i] + halfSize) - eyePos.z;
+        tests[i] = (squareSize / (dx * dx + dy * dy + dz * dz)) - squareTanAlpha;
+    }
+}
+
+void Octree::OrthographicSelector::testThresholds(const CellLanes& lanes, float tests[CellLanes::NUM_LANES]) const {
+    float size = Octree::getCoordSubcellWidth(lanes.depth);
+    float test = (size * size) - squareMinSize;
+    for (int i = 0; i < CellLanes::NUM_LANES; i++) {
+        tests[i] = test;
+    }
+}
+
+void Octree::CellLanes::setChildrenOf(const Location& parent) {
+    depth = Depth(parent.depth + 1);
+    size = Octree::getInvDepthDimension(depth);
+
+    Coord3f parentPos = Coord3f(parent.pos << Coord3(1)) * size;
+    for (int i = 0; i < NUM_LANES; i++) {
+        minX[i] = parentPos.x + ((i & XAxis) ? size : 0.0f);
+        minY[i] = parentPos.y + ((i & YAxis) ? size : 0.0f);
+        minZ[i] = parentPos.z + ((i & ZAxis) ? size : 0.0f);
+    }
+}
+
+// Portable reference of the lane intersection, one lane at a time
+void intersectCellLanes_ref(const float* minX, const float* minY, const float* minZ, float size,
+                            const float (*frustum)[4], uint8_t* intersections) {
+    for (int i = 0; i < Octree::CellLanes::NUM_LANES; i++) {
+        bool outside = false;
+        bool partial = false;
+        for (int p = 0; p < ViewFrustum::NUM_PLANES; p++) {
+            const float* plane = frustum[p];
+            float posDist = plane[0] * (minX[i] + ((plane[0] >= 0.0f) ? size : 0.0f)) +
+                            plane[1] * (minY[i] + ((plane[1] >= 0.0f) ? size : 0.0f)) +
+                            plane[2] * (minZ[i] + ((plane[2] >= 0.0f) ? size : 0.0f)) + plane[3];
+            float negDist = plane[0] * (minX[i] + ((plane[0] <= 0.0f) ? size : 0.0f)) +
+                            plane[1] * (minY[i] + ((plane[1] <= 0.0f) ? size : 0.0f)) +
+                            plane[2] * (minZ[i] + ((plane[2] <= 0.0f) ? size : 0.0f)) + plane[3];
+            outside |= (posDist < 0.0f);
+            partial |= (negDist < 0.0f);
+        }
+        intersections[i] = outside ? Octree::Location::Outside : (partial ? Octree::Location::Intersect : Octree::Location::Inside);
+    }
+}
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+// SSE2 version of the lane intersection, 2 blocks of 4 lanes
+static void intersectCellLanes_SSE(const float* minX, const float* minY, const float* minZ, float size,
+                                   const float (*frustum)[4], uint8_t* intersections) {
+    __m128 zero = _mm_setzero_ps();
+
+    for (int b = 0; b < Octree::CellLanes::NUM_LANES; b += 4) {
+        __m128 x = _mm_loadu_ps(minX + b);
+        __m128 y = _mm_loadu_ps(minY + b);
+        __m128 z = _mm_loadu_ps(minZ + b);
+
+        __m128 outside = zero;
+        __m128 partial = zero;
+
+        for (int p = 0; p < ViewFrustum::NUM_PLANES; p++) {
+            const float* plane = frustum[p];
+            __m128 nx = _mm_set1_ps(plane[0]);
+            __m128 ny = _mm_set1_ps(plane[1]);
+            __m128 nz = _mm_set1_ps(plane[2]);
+
+            __m128 pos = _mm_mul_ps(nx, _mm_add_ps(x, _mm_set1_ps((plane[0] >= 0.0f) ? size : 0.0f)));
+            pos = _mm_add_ps(pos, _mm_mul_ps(ny, _mm_add_ps(y, _mm_set1_ps((plane[1] >= 0.0f) ? size : 0.0f))));
+            pos = _mm_add_ps(pos, _mm_mul_ps(nz, _mm_add_ps(z, _mm_set1_ps((plane[2] >= 0.0f) ? size : 0.0f))));
+            pos = _mm_add_ps(pos, _mm_set1_ps(plane[3]));
+
+            __m128 neg = _mm_mul_ps(nx, _mm_add_ps(x, _mm_set1_ps((plane[0] <= 0.0f) ? size : 0.0f)));
+            neg = _mm_add_ps(neg, _mm_mul_ps(ny, _mm_add_ps(y, _mm_set1_ps((plane[1] <= 0.0f) ? size : 0.0f))));
+            neg = _mm_add_ps(neg, _mm_mul_ps(nz, _mm_add_ps(z, _mm_set1_ps((plane[2] <= 0.0f) ? size : 0.0f))));
+            neg = _mm_add_ps(neg, _mm_set1_ps(plane[3]));
+
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(pos, zero));
+            partial = _mm_or_ps(partial, _mm_cmplt_ps(neg, zero));
+        }
+
+        int outsideMask = _mm_movemask_ps(outside);
+        int partialMask = _mm_movemask_ps(partial);
+        for (int i = 0; i < 4; i++) {
+            intersections[b + i] = (outsideMask & (1 << i)) ? Octree::Location::Outside :
+                ((partialMask & (1 << i)) ? Octree::Location::Intersect : Octree::Location::Inside);
+        }
+    }
+}
+
+//
+// Runtime CPU dispatch
+//
+#include <CPUDetect.h>
+
+void intersectCellLanes_AVX2(const float* minX, const float* minY, const float* minZ, float size,
+                             const float (*frustum)[4], uint8_t* intersections);
+
+void Octree::CellLanes::intersect(const Coord4f frustum[6], uint8_t intersections[NUM_LANES]) const {
+    static auto f = cpuSupportsAVX2() ? intersectCellLanes_AVX2 : intersectCellLanes_SSE;
+    static_assert(sizeof(Coord4f) == 4 * sizeof(float), "Coord4f size doesn't match.");
+    (*f)(minX, minY, minZ, size, (const float(*)[4])frustum, intersections);
+}
+
+#else   // portable reference code
+
+void Octree::CellLanes::intersect(const Coord4f frustum[6], uint8_t intersections[NUM_LANES]) const {
+    intersectCellLanes_ref(minX, minY, minZ, size, (const float(*)[4])frustum, intersections);
+}
+
+#endif
+
 
 const float Octree::INV_DEPTH_DIM[] = {
     1.0f,
@@ -436,26 +561,49 @@ ItemSpatialTree::Index ItemSpatialTree::resetItem(Index oldCell, const ItemKey&
 }
 
 int Octree::select(CellSelection& selection, const FrustumSelector& selector) const {
-
-    Index cellID = ROOT_CELL;
-    auto cell = getConcreteCell(cellID);
     int numSelectedsIn = (int)selection.size();
 
     // Always include the root cell partially containing potentially outer objects
-    selectCellBrick(cellID, selection, false);
+    selectCellBrick(ROOT_CELL, selection, false);
 
-    // then traverse deeper
+    // then traverse deeper, testing the children of each cell together
+    selectChildren(ROOT_CELL, selection, selector, false);
+
+    return (int)selection.size() - numSelectedsIn;
+}
+
+void Octree::selectChildren(Index cellID, CellSelection& selection, const FrustumSelector& selector, bool inside) const {
+    const auto& cell = getConcreteCell(cellID);
+    if (!cell.hasChildren()) {
+        return;
+    }
+
+    CellLanes lanes;
+    lanes.setChildrenOf(cell.getlocation());
+
+    // Children of a cell fully inside are fully inside too, no need to test them
+    uint8_t intersections[CellLanes::NUM_LANES];
+    if (inside) {
+        std::fill(intersections, intersections + CellLanes::NUM_LANES, (uint8_t)Location::Inside);
+    } else {
+        lanes.intersect(selector.frustum, intersections);
+    }
+
+    float tests[CellLanes::NUM_LANES];
+    selector.testThresholds(lanes, tests);
+
+    // Same order and same outcome as selectTraverse() / selectBranch()
     for (int i = 0; i < NUM_OCTANTS; i++) {
         Index subCellID = cell.child((Link)i);
-        if (subCellID != INVALID_CELL) {
-            selectTraverse(subCellID, selection, selector);
+        if (subCellID == INVALID_CELL || intersections[i] == Location::Outside || tests[i] < 0.0f) {
+            continue;
         }
+        bool subCellInside = (intersections[i] == Location::Inside);
+        selectCellBrick(subCellID, selection, subCellInside);
+        selectChildren(subCellID, selection, selector, subCellInside);
     }
-
-    return (int)selection.size() - numSelectedsIn;
 }
 
-
 Octree::Location::Intersection Octree::Location::intersectCell(const Location& cell, const Coord4f frustum[6]) {
     const Coord3f CornerOffsets[8] = {
         { 0.0, 0.0, 0.0 },
@@ -627,29 +775,114 @@ int ItemSpatialTree::selectCells(CellSelection& selection, const ViewFrustum& fr
     }
 }
 
-int ItemSpatialTree::selectCellItems(ItemSelection& selection, const ItemFilter& filter, const ViewFrustum& frustum, 
-                                     float threshold) const {
-    selectCells(selection.cellSelection, frustum, threshold);
+// Below this many items the locations are evaluated on the calling thread
+static const size_t MIN_ITEMS_FOR_PARALLEL_INSERT = 1024;
 
-    // Just grab the items in every selected bricks
-    for (auto brickId : selection.cellSelection.insideBricks) {
-        auto& brickItems = getConcreteBrick(brickId).items;
-        selection.insideItems.insert(selection.insideItems.end(), brickItems.begin(), brickItems.end());
+void ItemSpatialTree::insertItems(const ItemBounds& items, std::vector<ItemKey>& keys, Indices& outCells) {
+    assert(items.size() == keys.size());
+    size_t numItems = items.size();
+    outCells.assign(numItems, INVALID_CELL);
 
-        auto& brickSubcellItems = getConcreteBrick(brickId).subcellItems;
-        selection.insideSubcellItems.insert(selection.insideSubcellItems.end(), brickSubcellItems.begin(), brickSubcellItems.end());
+    // Eval the location of every item and tag the small ones, same as resetItem()
+    Locations locations(numItems);
+    auto evalItem = [&](size_t i) {
+        auto& key = keys[i];
+        if (key.isViewSpace()) {
+            return;
+        }
+        Coord3f minCoordf, maxCoordf;
+        locations[i] = evalLocation(items[i].bound, minCoordf, maxCoordf);
+        auto rangeSizef = maxCoordf - minCoordf;
+        float cellHalfSize = 0.5f * getCellWidth(locations[i].depth);
+        key.setSmaller(std::max(std::max(rangeSizef.x, rangeSizef.y), rangeSizef.z) < cellHalfSize);
+    };
+    if (numItems < MIN_ITEMS_FOR_PARALLEL_INSERT) {
+        for (size_t i = 0; i < numItems; ++i) {
+            evalItem(i);
+        }
+    } else {
+        tbb::parallel_for((size_t)0, numItems, evalItem);
     }
 
-    for (auto brickId : selection.cellSelection.partialBricks) {
-        auto& brickItems = getConcreteBrick(brickId).items;
-        selection.partialItems.insert(selection.partialItems.end(), brickItems.begin(), brickItems.end());
+    // Walk the items grouped by location, keeping the submission order within a location
+    std::vector<uint32_t> order(numItems);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        const auto& la = locations[a];
+        const auto& lb = locations[b];
+        if (la.depth != lb.depth) {
+            return la.depth < lb.depth;
+        }
+        if (la.pos.x != lb.pos.x) {
+            return la.pos.x < lb.pos.x;
+        }
+        if (la.pos.y != lb.pos.y) {
+            return la.pos.y < lb.pos.y;
+        }
+        return la.pos.z < lb.pos.z;
+    });
+
+    Index cell = INVALID_CELL;
+    Location cellLocation;
+    for (size_t o = 0; o < numItems; ++o) {
+        auto i = order[o];
+        if (keys[i].isViewSpace()) {
+            continue;
+        }
+        if (cell == INVALID_CELL || !(locations[i] == cellLocation)) {
+            cellLocation = locations[i];
+            cell = indexCell(cellLocation);
+        }
+        if (cell != INVALID_CELL) {
+            insertItem(cell, keys[i], items[i].id);
+            outCells[i] = cell;
+        }
+    }
+}
+
+// Below this many selected bricks the items are gathered on the calling thread
+static const size_t MIN_BRICKS_FOR_PARALLEL_GATHER = 256;
+
+// Append the items of the selected bricks to the flat item lists.
+// Destination offsets are computed first so the copies can run in parallel and still land in brick order.
+static void gatherBrickItems(const Octree& tree, const Octree::Indices& bricks, ItemIDs& items, ItemIDs& subcellItems) {
+    if (bricks.size() < MIN_BRICKS_FOR_PARALLEL_GATHER) {
+        for (auto brickId : bricks) {
+            auto& brick = tree.getConcreteBrick(brickId);
+            items.insert(items.end(), brick.items.begin(), brick.items.end());
+            subcellItems.insert(subcellItems.end(), brick.subcellItems.begin(), brick.subcellItems.end());
+        }
+        return;
+    }
 
-        auto& brickSubcellItems = getConcreteBrick(brickId).subcellItems;
-        selection.partialSubcellItems.insert(selection.partialSubcellItems.end(), brickSubcellItems.begin(), brickSubcellItems.end());
+    std::vector<size_t> itemOffsets(bricks.size() + 1);
+    std::vector<size_t> subcellItemOffsets(bricks.size() + 1);
+    itemOffsets[0] = items.size();
+    subcellItemOffsets[0] = subcellItems.size();
+    for (size_t i = 0; i < bricks.size(); i++) {
+        auto& brick = tree.getConcreteBrick(bricks[i]);
+        itemOffsets[i + 1] = itemOffsets[i] + brick.items.size();
+        subcellItemOffsets[i + 1] = subcellItemOffsets[i] + brick.subcellItems.size();
     }
+    items.resize(itemOffsets.back());
+    subcellItems.resize(subcellItemOffsets.back());
 
-    return (int) selection.numItems();
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, bricks.size()), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+            auto& brick = tree.getConcreteBrick(bricks[i]);
+            std::copy(brick.items.begin(), brick.items.end(), items.begin() + itemOffsets[i]);
+            std::copy(brick.subcellItems.begin(), brick.subcellItems.end(), subcellItems.begin() + subcellItemOffsets[i]);
+        }
+    });
 }
 
+int ItemSpatialTree::selectCellItems(ItemSelection& selection, const ItemFilter& filter, const ViewFrustum& frustum, 
+                                     float threshold) const {
+    selectCells(selection.cellSelection, frustum, threshold);
 
+    // Just grab the items in every selected bricks
+    gatherBrickItems(*this, selection.cellSelection.insideBricks, selection.insideItems, selection.insideSubcellItems);
+    gatherBrickItems(*this, selection.cellSelection.partialBricks, selection.partialItems, selection.partialSubcellItems);
 
+    return (int) selection.numItems();
+}
@@ -165,6 +165,25 @@ namespace render {
             };
             static Intersection intersectCell(const Location& cell, const Coord4f frustum[6]);
         };
+
+        // The boxes of the 8 children of a cell in normalized octree space, one lane per octant.
+        // Children all share the same size, the min corners are stored as separate arrays
+        // so the frustum and solid angle tests can run on 4 or 8 lanes at once.
+        struct CellLanes {
+            static const int NUM_LANES = 8;
+
+            float minX[NUM_LANES];
+            float minY[NUM_LANES];
+            float minZ[NUM_LANES];
+            float size { 0.0f };
+            Depth depth { ROOT_DEPTH };
+
+            // Fill the lanes with the children boxes of the cell at the specified location
+            void setChildrenOf(const Location& parent);
+
+            // Eval the intersection of every lane against a frustum, same semantic as Location::intersectCell
+            void intersect(const Coord4f frustum[6], uint8_t intersections[NUM_LANES]) const;
+        };
         using Locations = Location::vector;
 
         // Cell or Brick Indexing
@@ -315,6 +334,7 @@ namespace render {
             
             virtual ~FrustumSelector() {}
             virtual float testThreshold(const Coord3f& point, float size) const = 0;
+            virtual void testThresholds(const CellLanes& lanes, float tests[CellLanes::NUM_LANES]) const = 0;
         };
 
         class PerspectiveSelector : public FrustumSelector {
@@ -325,6 +345,7 @@ namespace render {
 
             void setAngle(float a);
             float testThreshold(const Coord3f& point, float size) const override;
+            void testThresholds(const CellLanes& lanes, float tests[CellLanes::NUM_LANES]) const override;
         };
 
         class OrthographicSelector : public FrustumSelector {
@@ -333,8 +354,10 @@ namespace render {
 
             void setSize(float a) { squareMinSize = a * a; }
             float testThreshold(const Coord3f& point, float size) const override;
+            void testThresholds(const CellLanes& lanes, float tests[CellLanes::NUM_LANES]) const override;
         };
 
+        // Select the cells testing the children of a cell together in CellLanes
         int select(CellSelection& selection, const FrustumSelector& selector) const;
         int selectTraverse(Index cellID, CellSelection& selection, const FrustumSelector& selector) const;
         int selectBranch(Index cellID, CellSelection& selection, const FrustumSelector& selector) const;
@@ -345,6 +368,8 @@ namespace render {
         int getNumFreeCells() const { return (int)_freeCells.size(); }
             
     protected:
+        void selectChildren(Index cellID, CellSelection& selection, const FrustumSelector& selector, bool inside) const;
+
         Index allocateCell(Index parent, const Location& location);
         void freeCell(Index index);
 
@@ -446,6 +471,12 @@ namespace render {
 
         Index resetItem(Index oldCell, const ItemKey& oldKey, const AABox& bound, const ItemID& item, ItemKey& newKey);
 
+        // Insert items not in the tree yet, same outcome as calling resetItem(INVALID_CELL, ...) on each of them.
+        // The locations are evaluated in parallel and the items inserted sorted by location,
+        // so the cell of each distinct location is indexed only once.
+        // keys are tagged small as in resetItem, the cell of each item is returned in outCells
+        void insertItems(const ItemBounds& items, std::vector<ItemKey>& keys, Indices& outCells);
+
         // Selection and traverse
         int selectCells(CellSelection& selection, const ViewFrustum& frustum, float threshold) const;
 
@@ -18,8 +18,114 @@
 
 #include <glm/gtx/quaternion.hpp>
 
+#include <TBBHelpers.h>
+
 using namespace workload;
 
+// Below this many proxies to classify the work stays on the calling thread
+static const uint32_t MIN_PROXIES_FOR_PARALLEL_CLASSIFY = 4096;
+static const uint32_t CLASSIFY_CHUNK_SIZE = 1024;
+
+// Past this fraction of dirty proxies a full pass over the packed spheres is cheaper than gathering them
+static const uint32_t FULL_CLASSIFICATION_DIRTY_RATIO = 4;
+
+// Classify a single sphere against the tracked regions of the views:
+// the result is the smallest region touched by any view, or R4 when none is touched.
+static uint8_t classifySphere(float x, float y, float z, float radius, const Sphere* regions, uint32_t numViews) {
+    uint8_t region = Region::R4;
+    for (uint32_t j = 0; j < numViews; ++j) {
+        const Sphere* viewRegions = regions + j * Region::NUM_TRACKED_REGIONS;
+        // for each 'view' we need only increment 'k' below the current value of 'region'
+        for (uint8_t k = 0; k < region; ++k) {
+            float dx = x - viewRegions[k].x;
+            float dy = y - viewRegions[k].y;
+            float dz = z - viewRegions[k].z;
+            float touchDistance = radius + viewRegions[k].w;
+            if (dx * dx + dy * dy + dz * dz < touchDistance * touchDistance) {
+                region = k;
+                break;
+            }
+        }
+    }
+    return region;
+}
+
+// Gather the tracked region spheres of all the views in a single array
+static void flattenRegions(const Views& views, std::vector<Sphere>& regions) {
+    regions.reserve(views.size() * Region::NUM_TRACKED_REGIONS);
+    for (auto& view : views) {
+        regions.insert(regions.end(), view.regions, view.regions + Region::NUM_TRACKED_REGIONS);
+    }
+}
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+// Classify contiguous packed spheres, 4 at a time
+static void classifySpheres(const float* x, const float* y, const float* z, const float* radius, uint32_t numSpheres,
+                            const Sphere* regions, uint32_t numViews, uint8_t* regionsOut) {
+    uint32_t i = 0;
+    for (; i + 4 <= numSpheres; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 pz = _mm_loadu_ps(z + i);
+        __m128 pr = _mm_loadu_ps(radius + i);
+
+        int touchMasks[Region::NUM_TRACKED_REGIONS] = { 0 };
+        for (uint32_t j = 0; j < numViews; ++j) {
+            const Sphere* viewRegions = regions + j * Region::NUM_TRACKED_REGIONS;
+            for (uint32_t k = 0; k < Region::NUM_TRACKED_REGIONS; ++k) {
+                __m128 dx = _mm_sub_ps(px, _mm_set1_ps(viewRegions[k].x));
+                __m128 dy = _mm_sub_ps(py, _mm_set1_ps(viewRegions[k].y));
+                __m128 dz = _mm_sub_ps(pz, _mm_set1_ps(viewRegions[k].z));
+                __m128 touch = _mm_add_ps(pr, _mm_set1_ps(viewRegions[k].w));
+                __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                touchMasks[k] |= _mm_movemask_ps(_mm_cmplt_ps(d2, _mm_mul_ps(touch, touch)));
+            }
+        }
+
+        for (uint32_t l = 0; l < 4; ++l) {
+            uint8_t region = Region::R4;
+            for (uint8_t k = 0; k < Region::NUM_TRACKED_REGIONS; ++k) {
+                if (touchMasks[k] & (1 << l)) {
+                    region = k;
+                    break;
+                }
+            }
+            regionsOut[i + l] = region;
+        }
+    }
+    for (; i < numSpheres; ++i) {
+        regionsOut[i] = classifySphere(x[i], y[i], z[i], radius[i], regions, numViews);
+    }
+}
+
+#else   // portable reference code
+
+static void classifySpheres(const float* x, const float* y, const float* z, const float* radius, uint32_t numSpheres,
+                            const Sphere* regions, uint32_t numViews, uint8_t* regionsOut) {
+    for (uint32_t i = 0; i < numSpheres; ++i) {
+        regionsOut[i] = classifySphere(x[i], y[i], z[i], radius[i], regions, numViews);
+    }
+}
+
+#endif
+
+void Space::PackedSpheres::resize(size_t size) {
+    x.resize(size, 0.0f);
+    y.resize(size, 0.0f);
+    z.resize(size, 0.0f);
+    radius.resize(size, 0.0f);
+}
+
+void Space::PackedSpheres::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+    radius.clear();
+}
+
 Space::Space() : Collection() {
 }
 
@@ -31,6 +137,8 @@ void Space::processTransactionFrame(const Transaction& transaction) {
     if (maxID > (Index) _proxies.size()) {
         _proxies.resize(maxID + 100); // allocate the maxId and more
         _owners.resize(maxID + 100);
+        _packedSpheres.resize(maxID + 100);
+        _dirtyFlags.resize(maxID + 100, 0);
     }
     // Now we know for sure that we have enough items in the array to
     // capture anything coming from the transaction
@@ -54,6 +162,8 @@ void Space::processResets(const Transaction::Resets& transactions) {
         // Reset the item with a new payload
         item.sphere = (std::get<1>(reset));
         item.prevRegion = item.region = Region::UNKNOWN;
+        setPackedSphere(proxyID, item.sphere);
+        markProxyDirty(proxyID);
 
         _owners[proxyID] = (std::get<2>(reset));
     }
@@ -87,37 +197,122 @@ void Space::processUpdates(const Transaction::Updates& transactions) {
 
         // Update the item
         item.sphere = (std::get<1>(update));
+        setPackedSphere(updateID, item.sphere);
+        markProxyDirty(updateID);
+    }
+}
+
+void Space::setPackedSphere(int32_t proxyID, const Sphere& sphere) {
+    _packedSpheres.x[proxyID] = sphere.x;
+    _packedSpheres.y[proxyID] = sphere.y;
+    _packedSpheres.z[proxyID] = sphere.z;
+    _packedSpheres.radius[proxyID] = sphere.w;
+}
+
+void Space::markProxyDirty(int32_t proxyID) {
+    if (!_dirtyFlags[proxyID]) {
+        _dirtyFlags[proxyID] = 1;
+        _dirtyProxies.push_back(proxyID);
     }
 }
 
 void Space::categorizeAndGetChanges(std::vector<Space::Change>& changes) {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
+
+    // The proxies which changed region last time settle in it, as a reclassification would do
+    for (auto proxyID : _changedProxies) {
+        Proxy& proxy = _proxies[proxyID];
+        if (proxy.region < Region::INVALID) {
+            proxy.prevRegion = proxy.region;
+        }
+    }
+    _changedProxies.clear();
+
+    size_t numChangesIn = changes.size();
+    uint32_t numProxies = (uint32_t)_proxies.size();
+    if (_needsFullClassification || (uint32_t)_dirtyProxies.size() * FULL_CLASSIFICATION_DIRTY_RATIO > numProxies) {
+        classifyAllProxies(changes);
+    } else {
+        classifyDirtyProxies(changes);
+    }
+    _needsFullClassification = false;
+
+    for (size_t i = numChangesIn; i < changes.size(); ++i) {
+        _changedProxies.push_back(changes[i].proxyId);
+    }
+}
+
+void Space::classifyAllProxies(std::vector<Space::Change>& changes) {
+    for (auto proxyID : _dirtyProxies) {
+        _dirtyFlags[proxyID] = 0;
+    }
+    _dirtyProxies.clear();
+
     uint32_t numProxies = (uint32_t)_proxies.size();
     uint32_t numViews = (uint32_t)_views.size();
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        Proxy& proxy = _proxies[i];
-        if (proxy.region < Region::INVALID) {
-            glm::vec3 proxyCenter = glm::vec3(proxy.sphere);
-            float proxyRadius = proxy.sphere.w;
-            uint8_t region = Region::R4;
-            for (uint32_t j = 0; j < numViews; ++j) {
-                auto& view = _views[j];
-                // for each 'view' we need only increment 'k' below the current value of 'region'
-                for (uint8_t k = 0; k < region; ++k) {
-                    float touchDistance = proxyRadius + view.regions[k].w;
-                    if (distance2(proxyCenter, glm::vec3(view.regions[k])) < touchDistance * touchDistance) {
-                        region = k;
-                        break;
-                    }
+    std::vector<Sphere> regions;
+    flattenRegions(_views, regions);
+
+    // Each chunk collects its own changes, concatenated in chunk order to keep them sorted by proxy
+    uint32_t numChunks = (numProxies + CLASSIFY_CHUNK_SIZE - 1) / CLASSIFY_CHUNK_SIZE;
+    std::vector<std::vector<Space::Change>> chunkChanges(numChunks);
+    auto classifyChunk = [&](uint32_t chunk) {
+        uint32_t begin = chunk * CLASSIFY_CHUNK_SIZE;
+        uint32_t end = std::min(begin + CLASSIFY_CHUNK_SIZE, numProxies);
+        uint8_t chunkRegions[CLASSIFY_CHUNK_SIZE];
+        classifySpheres(_packedSpheres.x.data() + begin, _packedSpheres.y.data() + begin, _packedSpheres.z.data() + begin,
+            _packedSpheres.radius.data() + begin, end - begin, regions.data(), numViews, chunkRegions);
+
+        auto& outChanges = chunkChanges[chunk];
+        for (uint32_t i = begin; i < end; ++i) {
+            Proxy& proxy = _proxies[i];
+            if (proxy.region < Region::INVALID) {
+                proxy.prevRegion = proxy.region;
+                proxy.region = chunkRegions[i - begin];
+                if (proxy.region != proxy.prevRegion) {
+                    outChanges.emplace_back(Space::Change((int32_t)i, proxy.region, proxy.prevRegion));
                 }
             }
+        }
+    };
+
+    if (numProxies < MIN_PROXIES_FOR_PARALLEL_CLASSIFY) {
+        for (uint32_t chunk = 0; chunk < numChunks; ++chunk) {
+            classifyChunk(chunk);
+        }
+    } else {
+        tbb::parallel_for((uint32_t)0, numChunks, classifyChunk);
+    }
+
+    for (auto& outChanges : chunkChanges) {
+        changes.insert(changes.end(), outChanges.begin(), outChanges.end());
+    }
+    _numClassifiedProxies = numProxies;
+}
+
+void Space::classifyDirtyProxies(std::vector<Space::Change>& changes) {
+    // Keep the changes sorted by proxy like a full pass would
+    IndexVector dirtyProxies;
+    dirtyProxies.swap(_dirtyProxies);
+    std::sort(dirtyProxies.begin(), dirtyProxies.end());
+
+    uint32_t numViews = (uint32_t)_views.size();
+    std::vector<Sphere> regions;
+    flattenRegions(_views, regions);
+
+    for (auto proxyID : dirtyProxies) {
+        _dirtyFlags[proxyID] = 0;
+        Proxy& proxy = _proxies[proxyID];
+        if (proxy.region < Region::INVALID) {
             proxy.prevRegion = proxy.region;
-            proxy.region = region;
+            proxy.region = classifySphere(_packedSpheres.x[proxyID], _packedSpheres.y[proxyID], _packedSpheres.z[proxyID],
+                _packedSpheres.radius[proxyID], regions.data(), numViews);
             if (proxy.region != proxy.prevRegion) {
-                changes.emplace_back(Space::Change((int32_t)i, proxy.region, proxy.prevRegion));
+                changes.emplace_back(Space::Change(proxyID, proxy.region, proxy.prevRegion));
             }
         }
     }
+    _numClassifiedProxies = (uint32_t)dirtyProxies.size();
 }
 
 uint32_t Space::copyProxyValues(Proxy* proxies, uint32_t numDestProxies) const {
@@ -161,10 +356,30 @@ void Space::clear() {
     _IDAllocator.clear();
     _proxies.clear();
     _owners.clear();
+    _packedSpheres.clear();
+    _dirtyFlags.clear();
+    _dirtyProxies.clear();
+    _changedProxies.clear();
+    _needsFullClassification = true;
+    _numClassifiedProxies = 0;
     _views.clear();
 }
 
 void Space::setViews(const Views& views) {
+    // Only the region spheres drive the classification, any change in them requires a full pass
+    std::unique_lock<std::mutex> lock(_proxiesMutex);
+    bool changed = (views.size() != _views.size());
+    for (size_t i = 0; !changed && i < views.size(); ++i) {
+        for (uint32_t k = 0; k < Region::NUM_TRACKED_REGIONS; ++k) {
+            if (views[i].regions[k] != _views[i].regions[k]) {
+                changed = true;
+                break;
+            }
+        }
+    }
+    if (changed) {
+        _needsFullClassification = true;
+    }
     _views = views;
 }
 
@@ -45,7 +45,13 @@ public:
     uint32_t getNumObjects() const { return _IDAllocator.getNumLiveIndices(); }
     uint32_t getNumAllocatedProxies() const { return (uint32_t)(_IDAllocator.getNumAllocatedIndices()); }
 
+    // Classify the proxies in regions and collect the ones changing region since last call.
+    // Only the proxies reset or updated since then are reclassified unless the views changed.
     void categorizeAndGetChanges(std::vector<Change>& changes);
+
+    // Number of proxies classified by the last call to categorizeAndGetChanges()
+    uint32_t getNumClassifiedProxies() const { return _numClassifiedProxies; }
+
     uint32_t copyProxyValues(Proxy* proxies, uint32_t numDestProxies) const;
     uint32_t copySelectedProxyValues(Proxy::Vector& proxies, const workload::indexed_container::Indices& indices) const;
 
@@ -60,11 +66,35 @@ private:
     void processRemoves(const Transaction::Removes& transactions);
     void processUpdates(const Transaction::Updates& transactions);
 
+    void setPackedSphere(int32_t proxyID, const Sphere& sphere);
+    void markProxyDirty(int32_t proxyID);
+    void classifyAllProxies(std::vector<Change>& changes);
+    void classifyDirtyProxies(std::vector<Change>& changes);
+
     // The database of proxies is protected for editing by a mutex
     mutable std::mutex _proxiesMutex;
     Proxy::Vector _proxies;
     std::vector<Owner> _owners;
 
+    // The proxy spheres are mirrored as separate arrays of centers and radius to classify 4 proxies at once
+    struct PackedSpheres {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> radius;
+
+        void resize(size_t size);
+        void clear();
+    };
+    PackedSpheres _packedSpheres;
+
+    // The proxies to reclassify at the next categorizeAndGetChanges()
+    std::vector<uint8_t> _dirtyFlags;
+    IndexVector _dirtyProxies;
+    IndexVector _changedProxies;
+    bool _needsFullClassification { true };
+    uint32_t _numClassifiedProxies { 0 };
+
     Views _views;
 };
 
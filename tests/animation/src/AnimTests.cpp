@@ -15,6 +15,7 @@
 #include <AnimVariant.h>
 #include <AnimExpression.h>
 #include <AnimUtil.h>
+#include <Rig.h>
 #include <NodeList.h>
 #include <AddressManager.h>
 #include <AccountManager.h>
@@ -697,3 +698,58 @@ void AnimTests::testExpressionEvaluator() {
 }
 
 
+
+void AnimTests::testAnimLOD() {
+    Rig::AnimLODConfig config;
+    config.reducedScreenSize = 0.1f;
+    config.minimalScreenSize = 0.01f;
+    config.reducedUpdateRate = 10.0f;
+    config.minimalUpdateRate = 2.0f;
+    Rig::setAnimLODConfig(config);
+
+    int numFull = Rig::getNumRigsInAnimLOD(Rig::AnimLOD::Full);
+    int numMinimal = Rig::getNumRigsInAnimLOD(Rig::AnimLOD::Minimal);
+    {
+        Rig rig;
+        QVERIFY(rig.getAnimLOD() == Rig::AnimLOD::Full);
+        QCOMPARE(Rig::getNumRigsInAnimLOD(Rig::AnimLOD::Full), numFull + 1);
+
+        // full rigs take on new joint data every frame, but only use up a tick when there is some
+        QVERIFY(rig.tickAnimLOD(0.016f, true));
+        QVERIFY(!rig.tickAnimLOD(0.016f, false));
+        QVERIFY(!rig.interpolateAnimLOD());
+
+        rig.setAnimLODScreenSize(0.005f);
+        QVERIFY(rig.getAnimLOD() == Rig::AnimLOD::Minimal);
+        QCOMPARE(Rig::getNumRigsInAnimLOD(Rig::AnimLOD::Full), numFull);
+        QCOMPARE(Rig::getNumRigsInAnimLOD(Rig::AnimLOD::Minimal), numMinimal + 1);
+
+        // minimal rigs wait for a full period at minimalUpdateRate
+        const float DELTA_TIME = 0.1f;
+        for (int i = 1; i < 5; i++) {
+            QVERIFY(!rig.tickAnimLOD(DELTA_TIME, true));
+        }
+        QVERIFY(rig.tickAnimLOD(DELTA_TIME + EPSILON, true));
+
+        // without new joint data the tick isn't used up, so the next joint data is taken on right away
+        for (int i = 0; i < 10; i++) {
+            QVERIFY(!rig.tickAnimLOD(DELTA_TIME, false));
+        }
+        QVERIFY(rig.tickAnimLOD(DELTA_TIME, true));
+        QVERIFY(!rig.tickAnimLOD(DELTA_TIME, true));
+
+        // hysteresis keeps the rig in its band just above the threshold
+        rig.setAnimLODScreenSize(0.0105f);
+        QVERIFY(rig.getAnimLOD() == Rig::AnimLOD::Minimal);
+        rig.setAnimLODScreenSize(0.05f);
+        QVERIFY(rig.getAnimLOD() == Rig::AnimLOD::Reduced);
+        rig.setAnimLODScreenSize(0.5f);
+        QVERIFY(rig.getAnimLOD() == Rig::AnimLOD::Full);
+
+        rig.setAnimLODScreenSize(0.005f);
+    }
+    QCOMPARE(Rig::getNumRigsInAnimLOD(Rig::AnimLOD::Full), numFull);
+    QCOMPARE(Rig::getNumRigsInAnimLOD(Rig::AnimLOD::Minimal), numMinimal);
+
+    Rig::setAnimLODConfig(Rig::AnimLODConfig());
+}
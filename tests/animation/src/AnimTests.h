@@ -30,6 +30,7 @@ private slots:
     void testExpressionTokenizer();
     void testExpressionParser();
     void testExpressionEvaluator();
+    void testAnimLOD();
 };
 
 #endif // hifi_AnimTests_h
@@ -0,0 +1,361 @@
+//
+//  AssetFileReaderTests.cpp
+//  tests/assignment-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetFileReaderTests.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#ifndef Q_OS_WIN
+#include <sys/resource.h>
+#endif
+
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QThreadPool>
+
+#include <AssetFileReader.h>
+#include <NLPacketList.h>
+#include <SegmentedPacketListWriter.h>
+#include <SharedUtil.h>
+#include <udt/PacketQueue.h>
+#include <udt/Socket.h>
+
+QTEST_MAIN(AssetFileReaderTests)
+
+static QByteArray randomBytes(int size) {
+    QByteArray bytes(size, 0);
+    for (int i = 0; i < size; ++i) {
+        bytes[i] = (char)(rand() & 0xff);
+    }
+    return bytes;
+}
+
+static bool writeTemporaryFile(QTemporaryFile& file, const QByteArray& contents) {
+    if (!file.open()) {
+        return false;
+    }
+    bool written = file.write(contents) == contents.size();
+    file.close();
+    return written;
+}
+
+void AssetFileReaderTests::testReadRange() {
+    const int FILE_SIZE = 100 * 1000 + 17;
+    const qint64 CHUNK_SIZE = 4096;
+    srand(0);
+    auto contents = randomBytes(FILE_SIZE);
+    QTemporaryFile file;
+    QVERIFY(writeTemporaryFile(file, contents));
+
+    AssetFileReader reader(file.fileName(), CHUNK_SIZE);
+    QVERIFY(reader.open());
+    QCOMPARE(reader.size(), (qint64)FILE_SIZE);
+
+    const qint64 ranges[][2] = { { 0, FILE_SIZE }, { 1, 9 }, { 5000, 3 * CHUNK_SIZE + 1 }, { FILE_SIZE - 10, 10 }, { 0, 0 } };
+    for (auto& range : ranges) {
+        QByteArray read;
+        bool success = reader.readRange(range[0], range[1], [&](const char* data, qint64 size) {
+            if (size > CHUNK_SIZE) {
+                return false;
+            }
+            read.append(data, (int)size);
+            return true;
+        });
+        QVERIFY(success);
+        QCOMPARE(read, contents.mid((int)range[0], (int)range[1]));
+    }
+
+    // ranges out of the file are refused, and so are writer failures
+    auto sink = [](const char* data, qint64 size) { return true; };
+    QVERIFY(!reader.readRange(FILE_SIZE - 10, 11, sink));
+    QVERIFY(!reader.readRange(-1, 10, sink));
+    QVERIFY(!reader.readRange(0, FILE_SIZE, [](const char* data, qint64 size) { return false; }));
+}
+
+void AssetFileReaderTests::testPacketListMatchesFile() {
+    const int FILE_SIZE = 3 * 1000 * 1000 + 5;
+    srand(1);
+    auto contents = randomBytes(FILE_SIZE);
+    QTemporaryFile file;
+    QVERIFY(writeTemporaryFile(file, contents));
+
+    AssetFileReader reader(file.fileName());
+    QVERIFY(reader.open());
+
+    auto packetList = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+    QVERIFY(reader.readRange(0, FILE_SIZE, [&](const char* data, qint64 size) {
+        return packetList->write(data, size) == size;
+    }));
+    packetList->closeCurrentPacket();
+    QCOMPARE(packetList->getMessage(), contents);
+}
+
+// Reads consecutive ranges of the file, the way SendAssetTask feeds a reply
+static SegmentedPacketListWriter::Source fileSource(std::shared_ptr<AssetFileReader> reader, qint64 offset) {
+    return [reader, offset](qint64 size, const SegmentedPacketListWriter::ChunkWriter& writer) mutable {
+        bool read = reader->readRange(offset, size, writer);
+        offset += size;
+        return read;
+    };
+}
+
+void AssetFileReaderTests::testSegmentedReply() {
+    const int FILE_SIZE = 1000 * 1000 + 3;
+    const qint64 SEGMENT_SIZE = 64 * 1000;
+    const QByteArray HEADER { "header" };
+    srand(2);
+    auto contents = randomBytes(FILE_SIZE);
+    QTemporaryFile file;
+    QVERIFY(writeTemporaryFile(file, contents));
+
+    auto reader = std::make_shared<AssetFileReader>(file.fileName());
+    QVERIFY(reader->open());
+
+    // segments go through a send queue that the test drains, as a connection would
+    udt::PacketQueue queue;
+    int numSegments = 0;
+    size_t largestSegment = 0;
+    auto sender = [&](std::unique_ptr<NLPacketList> segment) {
+        segment->closeCurrentPacket();
+        largestSegment = std::max(largestSegment, segment->getMessageSize());
+        queue.queuePacketList(std::move(segment));
+        ++numSegments;
+        return true;
+    };
+    std::vector<std::function<void()>> scheduled;
+    auto scheduler = [&](std::function<void()> work) {
+        scheduled.push_back(work);
+    };
+
+    auto packetList = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+    packetList->write(HEADER);
+    auto writer = SegmentedPacketListWriter::create(std::move(packetList), FILE_SIZE, fileSource(reader, 0), sender,
+                                                    scheduler, SEGMENT_SIZE);
+    int numFinished = 0;
+    bool success = false;
+    writer->setFinishedCallback([&](bool finishedSuccessfully) {
+        ++numFinished;
+        success = finishedSuccessfully;
+    });
+    QVERIFY(writer->start());
+
+    // nothing more is read until the queue takes a segment
+    QCOMPARE(numSegments, 2);
+    QVERIFY(scheduled.empty());
+
+    std::vector<std::unique_ptr<udt::Packet>> sent;
+    while (!queue.isEmpty() || !scheduled.empty()) {
+        while (auto packet = queue.takePacket()) {
+            sent.push_back(std::move(packet));
+        }
+        QVERIFY(scheduled.size() <= 2);
+        auto work = std::move(scheduled);
+        scheduled.clear();
+        for (auto& read : work) {
+            read();
+        }
+    }
+    QCOMPARE(numFinished, 1);
+    QVERIFY(success);
+    QCOMPARE(numSegments, (int)((FILE_SIZE + SEGMENT_SIZE - 1) / SEGMENT_SIZE));
+    QCOMPARE(largestSegment, (size_t)(HEADER.size() + SEGMENT_SIZE));
+
+    // all the segments make up a single message
+    QByteArray message;
+    for (size_t i = 0; i < sent.size(); ++i) {
+        const auto& packet = sent[i];
+        QCOMPARE(packet->getMessageNumber(), sent.front()->getMessageNumber());
+        QCOMPARE(packet->getMessagePartNumber(), (udt::Packet::MessagePartNumber)i);
+        auto expectedPosition = (i == 0) ? udt::Packet::FIRST : (i == sent.size() - 1) ? udt::Packet::LAST : udt::Packet::MIDDLE;
+        QCOMPARE(packet->getPacketPosition(), expectedPosition);
+        message.append(packet->getPayload(), (int)packet->getPayloadSize());
+    }
+    QCOMPARE(message, HEADER + contents);
+}
+
+void AssetFileReaderTests::testSegmentedReplyDropped() {
+    const qint64 SEGMENT_SIZE = 1000;
+    const qint64 MESSAGE_SIZE = 10 * SEGMENT_SIZE;
+    QByteArray data(MESSAGE_SIZE, 'x');
+    auto source = [&data](qint64 size, const SegmentedPacketListWriter::ChunkWriter& writer) {
+        return writer(data.constData(), size);
+    };
+    auto scheduler = [](std::function<void()> work) {
+        work();
+    };
+
+    // nothing leaves this queue, then it goes away with its connection and takes the queued segments with it
+    auto queue = std::make_shared<udt::PacketQueue>();
+    int numSegments = 0;
+    auto sender = [&](std::unique_ptr<NLPacketList> segment) {
+        segment->closeCurrentPacket();
+        queue->queuePacketList(std::move(segment));
+        ++numSegments;
+        return true;
+    };
+
+    auto writer = SegmentedPacketListWriter::create(NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true),
+                                                    MESSAGE_SIZE, source, sender, scheduler, SEGMENT_SIZE);
+    int numFinished = 0;
+    bool success = true;
+    writer->setFinishedCallback([&](bool finishedSuccessfully) {
+        ++numFinished;
+        success = finishedSuccessfully;
+    });
+    QVERIFY(writer->start());
+    QCOMPARE(numSegments, 2);
+    QCOMPARE(numFinished, 0);
+
+    // the queued segments hold the writer, not the other way around
+    std::weak_ptr<SegmentedPacketListWriter> weakWriter = writer;
+    writer.reset();
+    QVERIFY(!weakWriter.expired());
+
+    queue.reset();
+    QCOMPARE(numSegments, 2);
+    QCOMPARE(numFinished, 1);
+    QVERIFY(!success);
+    QVERIFY(weakWriter.expired());
+
+    // a segment that never reaches a send queue is dropped too
+    numSegments = 0;
+    numFinished = 0;
+    auto droppingSender = [&](std::unique_ptr<NLPacketList> segment) {
+        ++numSegments;
+        return false;
+    };
+    writer = SegmentedPacketListWriter::create(NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true),
+                                               MESSAGE_SIZE, source, droppingSender, scheduler, SEGMENT_SIZE);
+    writer->setFinishedCallback([&](bool finishedSuccessfully) {
+        ++numFinished;
+        success = finishedSuccessfully;
+    });
+    QVERIFY(writer->start());
+    QCOMPARE(numSegments, 1);
+    QCOMPARE(numFinished, 1);
+    QVERIFY(!success);
+
+    // and when the start of the message can't be read, nothing is sent
+    numSegments = 0;
+    writer = SegmentedPacketListWriter::create(NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true),
+                                               MESSAGE_SIZE, [](qint64 size, const SegmentedPacketListWriter::ChunkWriter& writer) {
+        return false;
+    }, droppingSender, scheduler, SEGMENT_SIZE);
+    QVERIFY(!writer->start());
+    QCOMPARE(numSegments, 0);
+}
+
+#ifdef MANUAL_TEST
+
+static long peakResidentKB() {
+#ifndef Q_OS_WIN
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return -1;
+#endif
+}
+
+class ReadSegmentTask : public QRunnable {
+public:
+    ReadSegmentTask(std::function<void()> read) : _read(read) {}
+
+    void run() override { _read(); }
+
+private:
+    std::function<void()> _read;
+};
+
+// Serve the whole file to numClients concurrent requests, each sent as one AssetGetReply over its own localhost
+// udt connection, either as a single NLPacketList holding the whole range or a segment at a time
+static void serveConcurrently(const QString& filePath, int numClients, bool segmented) {
+    udt::Socket receiver;
+    receiver.bind(QHostAddress::LocalHost);
+    std::atomic<qint64> bytesReceived { 0 };
+    std::atomic<int> messagesReceived { 0 };
+    receiver.setMessageHandler([&](std::unique_ptr<udt::Packet> packet) {
+        bytesReceived += packet->getPayloadSize();
+        if (packet->getPacketPosition() == udt::Packet::LAST || packet->getPacketPosition() == udt::Packet::ONLY) {
+            ++messagesReceived;
+        }
+    });
+    HifiSockAddr receiverAddress { QHostAddress::LocalHost, receiver.localPort() };
+
+    std::vector<std::unique_ptr<udt::Socket>> senders;
+    for (int c = 0; c < numClients; ++c) {
+        senders.emplace_back(new udt::Socket());
+        senders.back()->bind(QHostAddress::LocalHost);
+    }
+
+    uint64_t startTime = usecTimestampNow();
+    std::vector<std::thread> clients;
+    for (int c = 0; c < numClients; ++c) {
+        udt::Socket* sender = senders[c].get();
+        clients.emplace_back([&, sender] {
+            auto send = [sender, receiverAddress](std::unique_ptr<NLPacketList> packetList) {
+                packetList->closeCurrentPacket();
+                return sender->writePacketList(std::move(packetList), receiverAddress) >= 0;
+            };
+
+            // the file source keeps the reader for as long as the reply is sent
+            auto reader = std::make_shared<AssetFileReader>(filePath);
+            if (!reader->open()) {
+                return;
+            }
+            auto packetList = NLPacketList::create(PacketType::AssetGetReply, QByteArray(), true, true);
+            if (segmented) {
+                // the client thread is done once the first segments are queued, the rest are read on the global pool
+                auto writer = SegmentedPacketListWriter::create(std::move(packetList), reader->size(), fileSource(reader, 0),
+                                                                send, [](std::function<void()> work) {
+                    QThreadPool::globalInstance()->start(new ReadSegmentTask(work));
+                });
+                writer->start();
+            } else {
+                // the previous SendAssetTask path: the whole range is written to a single list first
+                reader->readRange(0, reader->size(), [&](const char* data, qint64 size) {
+                    return packetList->write(data, size) == size;
+                });
+                send(std::move(packetList));
+            }
+        });
+    }
+
+    // the sockets live on this thread
+    const quint64 MAX_SERVE_USECS = 300 * USECS_PER_SECOND;
+    while (messagesReceived < numClients && usecTimestampNow() - startTime < MAX_SERVE_USECS) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    uint64_t usecs = usecTimestampNow() - startTime;
+    for (auto& client : clients) {
+        client.join();
+    }
+
+    double megabytes = (double)bytesReceived.load() / (1024.0 * 1024.0);
+    std::cout << numClients << " clients, " << (segmented ? "segmented" : "single list") << ": "
+        << messagesReceived.load() << " replies, " << (megabytes * USECS_PER_SECOND / (double)usecs) << " MB/s, peak RSS = "
+        << peakResidentKB() / 1024 << " MB" << std::endl;
+}
+
+void AssetFileReaderTests::benchmark() {
+    const int FILE_SIZE = 50 * 1024 * 1024;
+    const int NUM_CLIENTS = 10;
+    QTemporaryFile file;
+    QVERIFY(writeTemporaryFile(file, QByteArray(FILE_SIZE, 'x')));
+
+    // the peak RSS only grows, the segmented path runs first
+    serveConcurrently(file.fileName(), NUM_CLIENTS, true);
+    serveConcurrently(file.fileName(), NUM_CLIENTS, false);
+}
+
+#endif // MANUAL_TEST
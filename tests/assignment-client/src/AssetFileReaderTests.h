@@ -0,0 +1,30 @@
+//
+//  AssetFileReaderTests.h
+//  tests/assignment-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetFileReaderTests_h
+#define hifi_AssetFileReaderTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class AssetFileReaderTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testReadRange();
+    void testPacketListMatchesFile();
+    void testSegmentedReply();
+    void testSegmentedReplyDropped();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_AssetFileReaderTests_h
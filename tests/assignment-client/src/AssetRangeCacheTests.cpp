@@ -0,0 +1,235 @@
+//
+//  AssetRangeCacheTests.cpp
+//  tests/assignment-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetRangeCacheTests.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QTemporaryDir>
+
+#include <AssetFileReader.h>
+#include <AssetRangeCache.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AssetRangeCacheTests)
+
+static AssetRangeCache::Loader makeLoader(char fill, qint64 size, std::atomic<int>& loads) {
+    return [fill, size, &loads](QByteArray& data) {
+        ++loads;
+        data = QByteArray((int)size, fill);
+        return true;
+    };
+}
+
+void AssetRangeCacheTests::testHitsAndEvictions() {
+    const qint64 RANGE_SIZE = 1000;
+    AssetRangeCache cache(3 * RANGE_SIZE, RANGE_SIZE);
+    std::atomic<int> loads { 0 };
+    QByteArray data;
+
+    QVERIFY(!cache.isCacheable(0));
+    QVERIFY(!cache.isCacheable(RANGE_SIZE + 1));
+
+    QVERIFY(cache.get("a", 0, RANGE_SIZE, makeLoader('a', RANGE_SIZE, loads), data));
+    QVERIFY(cache.get("b", 0, RANGE_SIZE, makeLoader('b', RANGE_SIZE, loads), data));
+    QVERIFY(cache.get("c", 0, RANGE_SIZE, makeLoader('c', RANGE_SIZE, loads), data));
+    QCOMPARE(loads.load(), 3);
+
+    // touch "a" so that "b" is the least recently used
+    QVERIFY(cache.get("a", 0, RANGE_SIZE, makeLoader('x', RANGE_SIZE, loads), data));
+    QCOMPARE(data, QByteArray((int)RANGE_SIZE, 'a'));
+    QCOMPARE(loads.load(), 3);
+
+    QVERIFY(cache.get("d", 0, RANGE_SIZE, makeLoader('d', RANGE_SIZE, loads), data));
+    QCOMPARE(loads.load(), 4);
+
+    // "b" was evicted, "a" and "c" were not
+    QVERIFY(cache.get("c", 0, RANGE_SIZE, makeLoader('x', RANGE_SIZE, loads), data));
+    QVERIFY(cache.get("a", 0, RANGE_SIZE, makeLoader('x', RANGE_SIZE, loads), data));
+    QCOMPARE(loads.load(), 4);
+    QVERIFY(cache.get("b", 0, RANGE_SIZE, makeLoader('b', RANGE_SIZE, loads), data));
+    QCOMPARE(loads.load(), 5);
+
+    // the same asset at another offset is another range
+    QVERIFY(cache.get("a", 1, RANGE_SIZE, makeLoader('a', RANGE_SIZE, loads), data));
+    QCOMPARE(loads.load(), 6);
+
+    // a failed or short load is not cached
+    QVERIFY(!cache.get("e", 0, RANGE_SIZE, [](QByteArray& data) { return false; }, data));
+    QVERIFY(!cache.get("e", 0, RANGE_SIZE, makeLoader('e', RANGE_SIZE - 1, loads), data));
+
+    auto stats = cache.getStats();
+    QCOMPARE(stats.hits, (uint64_t)3);
+    QCOMPARE(stats.misses, (uint64_t)8);
+    QCOMPARE(stats.evictions, (uint64_t)3);
+    QCOMPARE(stats.bytesServedFromMemory, (uint64_t)(3 * RANGE_SIZE));
+    QCOMPARE(stats.numEntries, (size_t)3);
+    QCOMPARE(stats.usedBytes, 3 * RANGE_SIZE);
+}
+
+void AssetRangeCacheTests::testCoalescing() {
+    const qint64 RANGE_SIZE = 4096;
+    const int NUM_THREADS = 16;
+    AssetRangeCache cache;
+    std::atomic<int> loads { 0 };
+    std::atomic<int> matches { 0 };
+
+    auto slowLoader = [&](QByteArray& data) {
+        ++loads;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        data = QByteArray((int)RANGE_SIZE, 'z');
+        return true;
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([&] {
+            QByteArray data;
+            if (cache.get("hot", 0, RANGE_SIZE, slowLoader, data) && data == QByteArray((int)RANGE_SIZE, 'z')) {
+                ++matches;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    QCOMPARE(matches.load(), NUM_THREADS);
+    QCOMPARE(loads.load(), 1);
+    auto stats = cache.getStats();
+    QCOMPARE(stats.misses, (uint64_t)1);
+    QCOMPARE(stats.hits + stats.coalesced, (uint64_t)(NUM_THREADS - 1));
+    QCOMPARE(stats.bytesServedFromMemory, (uint64_t)((NUM_THREADS - 1) * RANGE_SIZE));
+}
+
+void AssetRangeCacheTests::testInvalidate() {
+    const qint64 RANGE_SIZE = 100;
+    AssetRangeCache cache;
+    std::atomic<int> loads { 0 };
+    QByteArray data;
+
+    QVERIFY(cache.get("a", 0, RANGE_SIZE, makeLoader('a', RANGE_SIZE, loads), data));
+    QVERIFY(cache.get("a", 10, RANGE_SIZE, makeLoader('a', RANGE_SIZE, loads), data));
+    QVERIFY(cache.get("b", 0, RANGE_SIZE, makeLoader('b', RANGE_SIZE, loads), data));
+
+    cache.invalidate("a");
+    auto stats = cache.getStats();
+    QCOMPARE(stats.numEntries, (size_t)1);
+    QCOMPARE(stats.usedBytes, RANGE_SIZE);
+    QCOMPARE(stats.evictions, (uint64_t)0);
+
+    QVERIFY(cache.get("a", 0, RANGE_SIZE, makeLoader('a', RANGE_SIZE, loads), data));
+    QCOMPARE(loads.load(), 4);
+}
+
+void AssetRangeCacheTests::testLoaderThrows() {
+    const qint64 RANGE_SIZE = 100;
+    const int NUM_WAITERS = 8;
+    AssetRangeCache cache;
+    std::atomic<int> loads { 0 };
+    std::atomic<int> exceptions { 0 };
+
+    auto throwingLoader = [&](QByteArray& data) -> bool {
+        ++loads;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        throw std::runtime_error("read failed");
+    };
+
+    // every request coalesced onto the failing load gets its exception instead of waiting forever
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_WAITERS; ++i) {
+        threads.emplace_back([&] {
+            QByteArray data;
+            try {
+                cache.get("a", 0, RANGE_SIZE, throwingLoader, data);
+            } catch (const std::runtime_error&) {
+                ++exceptions;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    QCOMPARE(exceptions.load(), NUM_WAITERS);
+    QCOMPARE(loads.load(), 1);
+
+    // nothing was left in flight, the next request loads the range again
+    QByteArray data;
+    QVERIFY(cache.get("a", 0, RANGE_SIZE, makeLoader('a', RANGE_SIZE, loads), data));
+    QCOMPARE(data, QByteArray((int)RANGE_SIZE, 'a'));
+    QCOMPARE(loads.load(), 2);
+    QCOMPARE(cache.getStats().numEntries, (size_t)1);
+}
+
+#ifdef MANUAL_TEST
+void AssetRangeCacheTests::benchmark() {
+    // 200 clients requesting the same 40 textures, as at the start of a domain event
+    const int NUM_ASSETS = 40;
+    const int NUM_CLIENTS = 200;
+    const int NUM_THREADS = 20;
+    const int ASSET_SIZE = 2 * 1024 * 1024;
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QStringList paths;
+    for (int i = 0; i < NUM_ASSETS; ++i) {
+        QFile file(dir.filePath(QString::number(i)));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(ASSET_SIZE, (char)i));
+        paths << file.fileName();
+    }
+
+    for (bool useCache : { false, true }) {
+        AssetRangeCache cache;
+        std::atomic<int> next { 0 };
+        std::atomic<uint64_t> served { 0 };
+
+        auto start = usecTimestampNow();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < NUM_THREADS; ++t) {
+            threads.emplace_back([&] {
+                for (int request = next++; request < NUM_CLIENTS * NUM_ASSETS; request = next++) {
+                    const auto& path = paths[request % NUM_ASSETS];
+                    AssetFileReader file(path);
+                    if (!file.open()) {
+                        continue;
+                    }
+                    QByteArray data;
+                    auto load = [&](QByteArray& loaded) {
+                        loaded.reserve(ASSET_SIZE);
+                        return file.readRange(0, ASSET_SIZE, [&](const char* chunk, qint64 chunkSize) {
+                            loaded.append(chunk, chunkSize);
+                            return true;
+                        });
+                    };
+                    if (useCache ? cache.get(path, 0, ASSET_SIZE, load, data) : load(data)) {
+                        served += data.size();
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto elapsed = usecTimestampNow() - start;
+
+        auto stats = cache.getStats();
+        std::cout << (useCache ? "cached:   " : "uncached: ") << (double)elapsed / USECS_PER_MSEC << " ms, "
+                  << (served / (1024.0 * 1024.0)) / ((double)elapsed / USECS_PER_SECOND) << " MB/s, "
+                  << "hits " << stats.hits << " misses " << stats.misses << " coalesced " << stats.coalesced << std::endl;
+    }
+}
+#endif // MANUAL_TEST
@@ -0,0 +1,30 @@
+//
+//  AssetRangeCacheTests.h
+//  tests/assignment-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetRangeCacheTests_h
+#define hifi_AssetRangeCacheTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class AssetRangeCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testHitsAndEvictions();
+    void testCoalescing();
+    void testInvalidate();
+    void testLoaderThrows();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_AssetRangeCacheTests_h
@@ -0,0 +1,195 @@
+//
+//  BakeSchedulerTests.cpp
+//  tests/assignment-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakeSchedulerTests.h"
+
+#include <memory>
+
+#include <QtCore/QMutex>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+
+#include <BakeAssetTask.h>
+#include <BakeScheduler.h>
+
+QTEST_MAIN(BakeSchedulerTests)
+
+// Stands in for an oven: notes when the scheduler starts it, then holds its pool thread until the test finishes it
+class FakeBakeTask : public BakeAssetTask {
+public:
+    FakeBakeTask(const AssetUtils::AssetHash& hash, QStringList& started, QMutex& startedMutex) :
+        BakeAssetTask(hash, hash, QString()),
+        _hash(hash),
+        _started(started),
+        _startedMutex(startedMutex)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override {
+        {
+            QMutexLocker locker(&_startedMutex);
+            _started << _hash;
+        }
+        _finish.acquire();
+        emit bakeComplete(_hash, _hash, QString());
+    }
+
+    void finish() { _finish.release(); }
+
+private:
+    AssetUtils::AssetHash _hash;
+    QStringList& _started;
+    QMutex& _startedMutex;
+    QSemaphore _finish;
+};
+
+class BakeFixture {
+public:
+    BakeFixture(int maxConcurrentBakes, qint64 memoryBudget = BakeScheduler::DEFAULT_MEMORY_BUDGET) : scheduler(pool) {
+        scheduler.setLimits(maxConcurrentBakes, memoryBudget);
+    }
+
+    ~BakeFixture() {
+        for (auto& task : _tasks) {
+            task->finish();
+        }
+        pool.waitForDone();
+    }
+
+    void schedule(const AssetUtils::AssetHash& hash, qint64 assetSize) {
+        auto& task = _tasks[hash];
+        if (!task) {
+            task = std::make_shared<FakeBakeTask>(hash, _started, _startedMutex);
+        }
+        scheduler.schedule(task, hash, hash, assetSize);
+    }
+
+    void finish(const AssetUtils::AssetHash& hash) { _tasks[hash]->finish(); }
+
+    QStringList getStarted() {
+        QMutexLocker locker(&_startedMutex);
+        return _started;
+    }
+
+    QThreadPool pool;
+    BakeScheduler scheduler;
+
+private:
+    QMutex _startedMutex;
+    QStringList _started;
+    QHash<AssetUtils::AssetHash, std::shared_ptr<FakeBakeTask>> _tasks;
+};
+
+void BakeSchedulerTests::testSmallestFirst() {
+    BakeFixture bakes(1);
+
+    bakes.schedule("blocker", 10);
+    QTRY_COMPARE(bakes.getStarted(), QStringList({ "blocker" }));
+
+    bakes.schedule("big", 3000);
+    bakes.schedule("small", 1000);
+    bakes.schedule("medium", 2000);
+    QCOMPARE(bakes.scheduler.getQueueDepth(), 3);
+    QCOMPARE(bakes.scheduler.getNumRunning(), 1);
+
+    // a bake that is already queued or running is not queued again
+    bakes.schedule("small", 1000);
+    bakes.schedule("blocker", 10);
+    QCOMPARE(bakes.scheduler.getQueueDepth(), 3);
+
+    bakes.finish("blocker");
+    QTRY_COMPARE(bakes.getStarted(), QStringList({ "blocker", "small" }));
+    bakes.finish("small");
+    QTRY_COMPARE(bakes.getStarted(), QStringList({ "blocker", "small", "medium" }));
+    bakes.finish("medium");
+    QTRY_COMPARE(bakes.getStarted(), QStringList({ "blocker", "small", "medium", "big" }));
+    bakes.finish("big");
+
+    QTRY_COMPARE(bakes.scheduler.getNumRunning(), 0);
+    QCOMPARE(bakes.scheduler.getQueueDepth(), 0);
+    QCOMPARE(bakes.scheduler.getStats()["6. Completed"].toInt(), 4);
+}
+
+void BakeSchedulerTests::testDemandBump() {
+    BakeFixture bakes(1);
+
+    bakes.schedule("blocker", 10);
+    bakes.schedule("a", 1000);
+    bakes.schedule("b", 2000);
+    bakes.schedule("c", 3000);
+
+    // demand outranks size, and only queued bakes count it
+    bakes.scheduler.noteDemand("c");
+    bakes.scheduler.noteDemand("c");
+    bakes.scheduler.noteDemand("b");
+    bakes.scheduler.noteDemand("blocker");
+    bakes.scheduler.noteDemand("unknown");
+    QCOMPARE(bakes.scheduler.getQueueDepth(), 3);
+
+    bakes.finish("blocker");
+    QTRY_COMPARE(bakes.getStarted(), QStringList({ "blocker", "c" }));
+    bakes.finish("c");
+    QTRY_COMPARE(bakes.getStarted(), QStringList({ "blocker", "c", "b" }));
+    bakes.finish("b");
+    QTRY_COMPARE(bakes.getStarted(), QStringList({ "blocker", "c", "b", "a" }));
+}
+
+void BakeSchedulerTests::testConcurrencyLimit() {
+    BakeFixture bakes(2);
+
+    bakes.schedule("a", 1000);
+    bakes.schedule("b", 1000);
+    bakes.schedule("c", 1000);
+    bakes.schedule("d", 1000);
+    QCOMPARE(bakes.scheduler.getNumRunning(), 2);
+    QCOMPARE(bakes.scheduler.getQueueDepth(), 2);
+    QTRY_COMPARE(bakes.getStarted().size(), 2);
+
+    // raising the limit starts queued bakes right away
+    bakes.scheduler.setLimits(3, BakeScheduler::DEFAULT_MEMORY_BUDGET);
+    QCOMPARE(bakes.scheduler.getNumRunning(), 3);
+    QCOMPARE(bakes.scheduler.getQueueDepth(), 1);
+    QTRY_COMPARE(bakes.getStarted().size(), 3);
+
+    bakes.finish(bakes.getStarted().first());
+    QTRY_COMPARE(bakes.scheduler.getQueueDepth(), 0);
+    QCOMPARE(bakes.scheduler.getNumRunning(), 3);
+    QTRY_COMPARE(bakes.getStarted().size(), 4);
+}
+
+void BakeSchedulerTests::testMemoryBudget() {
+    const qint64 ASSET_SIZE = 1000;
+    BakeFixture bakes(4, 2 * BakeScheduler::estimateBakeMemory(ASSET_SIZE));
+
+    // the process limit would allow all three, the memory budget only two
+    bakes.schedule("a", ASSET_SIZE);
+    bakes.schedule("b", ASSET_SIZE);
+    bakes.schedule("c", ASSET_SIZE);
+    QCOMPARE(bakes.scheduler.getNumRunning(), 2);
+    QCOMPARE(bakes.scheduler.getQueueDepth(), 1);
+
+    bakes.finish("a");
+    QTRY_COMPARE(bakes.scheduler.getQueueDepth(), 0);
+    QCOMPARE(bakes.scheduler.getNumRunning(), 2);
+
+    bakes.finish("b");
+    bakes.finish("c");
+    QTRY_COMPARE(bakes.scheduler.getNumRunning(), 0);
+
+    // a bake over the whole budget still runs once nothing else is, but alone
+    bakes.schedule("huge", 100 * ASSET_SIZE);
+    bakes.schedule("d", ASSET_SIZE);
+    QCOMPARE(bakes.scheduler.getNumRunning(), 1);
+    QCOMPARE(bakes.scheduler.getQueueDepth(), 1);
+
+    QCOMPARE(bakes.scheduler.clearQueue(), QList<AssetUtils::AssetHash>({ "d" }));
+    QCOMPARE(bakes.scheduler.getQueueDepth(), 0);
+}
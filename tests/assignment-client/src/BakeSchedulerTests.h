@@ -0,0 +1,25 @@
+//
+//  BakeSchedulerTests.h
+//  tests/assignment-client/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakeSchedulerTests_h
+#define hifi_BakeSchedulerTests_h
+
+#include <QtTest/QtTest>
+
+class BakeSchedulerTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testSmallestFirst();
+    void testDemandBump();
+    void testConcurrencyLimit();
+    void testMemoryBudget();
+};
+
+#endif // hifi_BakeSchedulerTests_h
@@ -0,0 +1,198 @@
+//
+//  BakeCacheTests.cpp
+//  tests/baking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakeCacheTests.h"
+
+#include <QtCore/QTemporaryDir>
+
+#include <BakeCache.h>
+
+QTEST_GUILESS_MAIN(BakeCacheTests)
+
+static const QString TEST_VERSION { "test" };
+
+static bool writeFile(const QString& path, const QByteArray& data) {
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file { path };
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(data) == data.size();
+}
+
+static QByteArray readFile(const QString& path) {
+    QFile file { path };
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+static void setLastUsed(const BakeCache& cache, const QString& key, const QDateTime& time) {
+    QFile entryFile { cache.getPath() + "/" + key.left(2) + "/" + key + "/entry.json" };
+    QVERIFY(entryFile.open(QIODevice::ReadWrite));
+    QVERIFY(entryFile.setFileTime(time, QFileDevice::FileModificationTime));
+}
+
+// A bake of source that also read texture, with two outputs under output
+class FakeBake {
+public:
+    FakeBake(const QTemporaryDir& dir, const QString& name) :
+        source(dir.filePath("source/" + name + ".fbx")),
+        texture(dir.filePath("textures/" + name + ".png")),
+        output(dir.filePath("output/" + name)) {
+        writeFile(source, name.toUtf8());
+        writeFile(texture, "texture of " + name.toUtf8());
+        writeFile(output + "/baked/" + name + ".fst", "fst of " + name.toUtf8());
+        writeFile(output + "/baked/" + name + ".baked.fbx", QByteArray(1000, 'x'));
+    }
+
+    QString computeKey(BakeCache& cache) const {
+        return cache.computeKey("model", { cache.hashFile(source) }, { source });
+    }
+
+    bool store(BakeCache& cache) const {
+        return cache.store(computeKey(cache), output, { output + "/baked/" + QFileInfo(source).baseName() + ".fst",
+                           output + "/baked/" + QFileInfo(source).baseName() + ".baked.fbx" },
+                           output + "/baked/" + QFileInfo(source).baseName() + ".fst", { source, texture }, 10);
+    }
+
+    QString source;
+    QString texture;
+    QString output;
+};
+
+void BakeCacheTests::testKeyStability() {
+    QTemporaryDir dir;
+    BakeCache cache(dir.path(), TEST_VERSION);
+    QVERIFY(writeFile(dir.filePath("chair.fbx"), "chair"));
+    auto hash = cache.hashFile(dir.filePath("chair.fbx"));
+    QVERIFY(!hash.isEmpty());
+    QVERIFY(cache.hashFile(dir.filePath("missing.fbx")).isEmpty());
+
+    auto key = cache.computeKey("model", { hash }, { "a", "1" });
+    QCOMPARE(key.length(), 64);
+    QCOMPARE(cache.computeKey("model", { hash }, { "a", "1" }), key);
+    QCOMPARE(BakeCache(dir.path(), TEST_VERSION).computeKey("model", { hash }, { "a", "1" }), key);
+
+    // anything that changes the output changes the key
+    QVERIFY(cache.computeKey("texture", { hash }, { "a", "1" }) != key);
+    QVERIFY(cache.computeKey("model", { QByteArray(hash).append('x') }, { "a", "1" }) != key);
+    QVERIFY(cache.computeKey("model", { hash }, { "a", "0" }) != key);
+    QVERIFY(cache.computeKey("model", { hash }, { "a1" }) != key);
+    QVERIFY(BakeCache(dir.path(), "other").computeKey("model", { hash }, { "a", "1" }) != key);
+
+    // and the baker version is never empty
+    QVERIFY(!BakeCache::getBakerVersion().isEmpty());
+    QCOMPARE(BakeCache::getBakerVersion(), BakeCache::getBakerVersion());
+}
+
+void BakeCacheTests::testHitAndMiss() {
+    QTemporaryDir dir;
+    BakeCache cache(dir.filePath("cache"), TEST_VERSION);
+    QVERIFY(cache.isValid());
+    FakeBake bake(dir, "chair");
+
+    BakeCache::Entry entry;
+    QVERIFY(!cache.lookup(bake.computeKey(cache), entry));
+
+    QVERIFY(bake.store(cache));
+    QVERIFY(cache.lookup(bake.computeKey(cache), entry));
+    QCOMPARE(entry.result, QString("baked/chair.fst"));
+    QCOMPARE(entry.files.size(), 2);
+    QCOMPARE(entry.bakeTimeMsecs, (qint64)10);
+
+    QVERIFY(cache.restore(entry, dir.filePath("restored")));
+    QCOMPARE(readFile(dir.filePath("restored/baked/chair.fst")), QByteArray("fst of chair"));
+    QCOMPARE(readFile(dir.filePath("restored/baked/chair.baked.fbx")), QByteArray(1000, 'x'));
+
+    // another run hits the same entry
+    BakeCache nextRun(dir.filePath("cache"), TEST_VERSION);
+    QVERIFY(nextRun.lookup(bake.computeKey(nextRun), entry));
+
+    // another asset doesn't
+    FakeBake table(dir, "table");
+    QVERIFY(!nextRun.lookup(table.computeKey(nextRun), entry));
+
+    // outputs outside of the baker's folder can't be cached
+    QVERIFY(!cache.store(table.computeKey(cache), table.output, { bake.source }, bake.source, { table.source }, 10));
+    QVERIFY(!cache.lookup(table.computeKey(cache), entry));
+}
+
+void BakeCacheTests::testInvalidation() {
+    QTemporaryDir dir;
+    FakeBake bake(dir, "chair");
+    QString key;
+    {
+        BakeCache cache(dir.filePath("cache"), TEST_VERSION);
+        key = bake.computeKey(cache);
+        QVERIFY(bake.store(cache));
+    }
+
+    // a texture the bake read changed, the key is the same but the entry is stale
+    QVERIFY(writeFile(bake.texture, "new texture"));
+    {
+        BakeCache cache(dir.filePath("cache"), TEST_VERSION);
+        QCOMPARE(bake.computeKey(cache), key);
+        BakeCache::Entry entry;
+        QVERIFY(!cache.lookup(key, entry));
+
+        // baking again replaces it
+        QVERIFY(bake.store(cache));
+        QVERIFY(cache.lookup(key, entry));
+    }
+
+    // so does deleting one
+    QVERIFY(QFile::remove(bake.texture));
+    {
+        BakeCache cache(dir.filePath("cache"), TEST_VERSION);
+        BakeCache::Entry entry;
+        QVERIFY(!cache.lookup(key, entry));
+    }
+
+    // a different baker version never sees the entry, even under the same key
+    QVERIFY(writeFile(bake.texture, "new texture"));
+    {
+        BakeCache cache(dir.filePath("cache"), "other");
+        BakeCache::Entry entry;
+        QVERIFY(!cache.lookup(key, entry));
+    }
+}
+
+void BakeCacheTests::testEviction() {
+    QTemporaryDir dir;
+    BakeCache cache(dir.filePath("cache"), TEST_VERSION);
+    FakeBake chair(dir, "chair");
+    FakeBake table(dir, "table");
+    FakeBake lamp(dir, "lamp");
+    QVERIFY(chair.store(cache));
+    QVERIFY(table.store(cache));
+    QVERIFY(lamp.store(cache));
+
+    auto now = QDateTime::currentDateTimeUtc();
+    setLastUsed(cache, chair.computeKey(cache), now.addSecs(-300));
+    setLastUsed(cache, table.computeKey(cache), now.addSecs(-200));
+    setLastUsed(cache, lamp.computeKey(cache), now.addSecs(-100));
+
+    // nothing to do under the limits
+    QCOMPARE(cache.evict(), 0);
+
+    // a lookup counts as a use
+    BakeCache::Entry entry;
+    QVERIFY(cache.lookup(chair.computeKey(cache), entry));
+
+    // each entry is a bit over 1000 bytes, room for two leaves out the least recently used one
+    cache.setLimits(2500, BakeCache::DEFAULT_MAX_AGE_SECS);
+    QCOMPARE(cache.evict(), 1);
+    QVERIFY(!cache.lookup(table.computeKey(cache), entry));
+    QVERIFY(cache.lookup(lamp.computeKey(cache), entry));
+    QVERIFY(cache.lookup(chair.computeKey(cache), entry));
+
+    // entries past the age limit go whatever the size
+    setLastUsed(cache, lamp.computeKey(cache), now.addSecs(-3600));
+    cache.setLimits(BakeCache::DEFAULT_MAX_SIZE, 60);
+    QCOMPARE(cache.evict(), 1);
+    QVERIFY(!cache.lookup(lamp.computeKey(cache), entry));
+    QVERIFY(cache.lookup(chair.computeKey(cache), entry));
+}
@@ -0,0 +1,26 @@
+//
+//  BakeCacheTests.h
+//  tests/baking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_baking_BakeCacheTests_h
+#define hifi_baking_BakeCacheTests_h
+
+#include <QtTest/QtTest>
+
+class BakeCacheTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testKeyStability();
+    void testHitAndMiss();
+    void testInvalidation();
+    void testEviction();
+};
+
+#endif // hifi_baking_BakeCacheTests_h
@@ -0,0 +1,208 @@
+//
+//  FBXParserTests.cpp
+//  tests/baking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FBXParserTests.h"
+
+#include <iostream>
+
+#include <FBXSerializer.h>
+#include <FBXWriter.h>
+#include <SharedUtil.h>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+QTEST_GUILESS_MAIN(FBXParserTests)
+
+// A Geometry node shaped like the ones in real files; large arrays get compressed by the writer, small ones don't
+static FBXNode createGeometryNode(int numVertices) {
+    QVector<double> vertices;
+    QVector<qint32> indices;
+    QVector<float> weights;
+    QVector<qint64> ids;
+    QVector<bool> flags;
+    for (int i = 0; i < numVertices; ++i) {
+        vertices << (double)i << sin((double)i) << cos((double)i * 0.5);
+        indices << i << ((i + 1) % numVertices) << ~((i + 2) % numVertices);
+        weights << (float)(i % 17) / 17.0f;
+        ids << (qint64)i * 1000003;
+        flags << (i % 3 == 0);
+    }
+
+    FBXNode geometry;
+    geometry.name = "Geometry";
+    geometry.properties << QVariant::fromValue((qint64)42) << QVariant::fromValue(hifi::ByteArray("Mesh\x00\x01Geometry", 15))
+        << QVariant::fromValue(hifi::ByteArray("Mesh"));
+
+    FBXNode verticesNode;
+    verticesNode.name = "Vertices";
+    verticesNode.properties << QVariant::fromValue(vertices);
+    geometry.children << verticesNode;
+
+    FBXNode indicesNode;
+    indicesNode.name = "PolygonVertexIndex";
+    indicesNode.properties << QVariant::fromValue(indices);
+    geometry.children << indicesNode;
+
+    FBXNode weightsNode;
+    weightsNode.name = "Weights";
+    weightsNode.properties << QVariant::fromValue(weights) << QVariant::fromValue(ids) << QVariant::fromValue(flags);
+    geometry.children << weightsNode;
+
+    FBXNode smallNode;
+    smallNode.name = "Small";
+    smallNode.properties << QVariant::fromValue(QVector<qint32>({ 1, 2, 3 })) << QVariant::fromValue(QVector<double>())
+        << QVariant::fromValue((qint16)-7) << QVariant::fromValue(true) << QVariant::fromValue((qint32)-123456)
+        << QVariant::fromValue(1.5f) << QVariant::fromValue(2.25);
+    geometry.children << smallNode;
+
+    return geometry;
+}
+
+static FBXNode createDocument(int numGeometries, int numVertices) {
+    FBXNode root;
+    FBXNode objects;
+    objects.name = "Objects";
+    for (int i = 0; i < numGeometries; ++i) {
+        objects.children << createGeometryNode(numVertices + i);
+    }
+    root.children << objects;
+    return root;
+}
+
+template <typename T>
+static bool compareProperty(const QVariant& expected, const QVariant& actual) {
+    return expected.value<T>() == actual.value<T>();
+}
+
+static void compareNodes(const FBXNode& expected, const FBXNode& actual) {
+    QCOMPARE(actual.name, expected.name);
+    QCOMPARE(actual.properties.size(), expected.properties.size());
+    for (int i = 0; i < expected.properties.size(); ++i) {
+        const auto& expectedProperty = expected.properties[i];
+        const auto& actualProperty = actual.properties[i];
+        QCOMPARE(actualProperty.userType(), expectedProperty.userType());
+        if (expectedProperty.canConvert<QVector<double>>()) {
+            QVERIFY(compareProperty<QVector<double>>(expectedProperty, actualProperty));
+        } else if (expectedProperty.canConvert<QVector<float>>()) {
+            QVERIFY(compareProperty<QVector<float>>(expectedProperty, actualProperty));
+        } else if (expectedProperty.canConvert<QVector<qint64>>()) {
+            QVERIFY(compareProperty<QVector<qint64>>(expectedProperty, actualProperty));
+        } else if (expectedProperty.canConvert<QVector<qint32>>()) {
+            QVERIFY(compareProperty<QVector<qint32>>(expectedProperty, actualProperty));
+        } else if (expectedProperty.canConvert<QVector<bool>>()) {
+            QVERIFY(compareProperty<QVector<bool>>(expectedProperty, actualProperty));
+        } else {
+            QCOMPARE(actualProperty, expectedProperty);
+        }
+    }
+    QCOMPARE(actual.children.size(), expected.children.size());
+    for (int i = 0; i < expected.children.size(); ++i) {
+        compareNodes(expected.children[i], actual.children[i]);
+    }
+}
+
+void FBXParserTests::testBinaryRoundTrip() {
+    auto document = createDocument(8, 4000);
+    auto data = FBXWriter::encodeFBX(document);
+
+    auto parsed = FBXSerializer::parseFBX(data);
+    compareNodes(document, parsed);
+
+    // The source buffer doesn't need to outlive the parsed tree
+    {
+        auto copy = data;
+        parsed = FBXSerializer::parseFBX(QByteArray::fromRawData(copy.constData(), copy.size()));
+    }
+    compareNodes(document, parsed);
+
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    compareNodes(document, FBXSerializer::parseFBX(&buffer));
+}
+
+void FBXParserTests::testTruncatedFile() {
+    auto data = FBXWriter::encodeFBX(createDocument(1, 4000));
+
+    bool threw = false;
+    try {
+        FBXSerializer::parseFBX(data.left(data.size() / 2));
+    } catch (const QString&) {
+        threw = true;
+    }
+    QVERIFY(threw);
+}
+
+#ifdef MANUAL_TEST
+
+static long getPeakRSSKilobytes() {
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+static void benchmarkFile(const QString& name, const QString& path) {
+    QFile file { path };
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::cout << "Could not open " << path.toStdString() << std::endl;
+        return;
+    }
+
+    long startRSS = getPeakRSSKilobytes();
+    uint64_t startTime = usecTimestampNow();
+    uchar* mapped = file.map(0, file.size());
+    auto data = QByteArray::fromRawData((const char*)mapped, (int)file.size());
+    auto root = FBXSerializer::parseFBX(data);
+    double parseMsecs = (double)(usecTimestampNow() - startTime) / USECS_PER_MSEC;
+
+    hifi::VariantHash mapping;
+    mapping["deduplicateIndices"] = true;
+    startTime = usecTimestampNow();
+    auto model = FBXSerializer().read(data, mapping, QUrl::fromLocalFile(path));
+    double readMsecs = (double)(usecTimestampNow() - startTime) / USECS_PER_MSEC;
+
+    std::cout << name.toStdString() << " (" << file.size() / 1024 << " KB): parse " << parseMsecs << " ms, parse + extract "
+        << readMsecs << " ms, " << (model ? model->meshes.size() : 0) << " meshes, peak RSS grew by "
+        << (getPeakRSSKilobytes() - startRSS) << " KB" << std::endl;
+}
+
+// Set HIFI_FBX_BENCHMARK_DIR to a folder of .fbx files to benchmark them as well. Run once per file
+// for meaningful peak memory numbers, since the peak only ever grows over the life of the process.
+void FBXParserTests::benchmark() {
+    QTemporaryDir dir;
+    auto syntheticPath = dir.filePath("synthetic.fbx");
+    {
+        QFile synthetic { syntheticPath };
+        QVERIFY(synthetic.open(QIODevice::WriteOnly));
+        synthetic.write(FBXWriter::encodeFBX(createDocument(200, 20000)));
+    }
+
+    uint64_t startTime = usecTimestampNow();
+    QFile synthetic { syntheticPath };
+    QVERIFY(synthetic.open(QIODevice::ReadOnly));
+    FBXSerializer::parseFBX(&synthetic);
+    std::cout << "synthetic.fbx through QIODevice: " << (double)(usecTimestampNow() - startTime) / USECS_PER_MSEC << " ms" << std::endl;
+    benchmarkFile("synthetic.fbx", syntheticPath);
+
+    QDir modelDir { QProcessEnvironment::systemEnvironment().value("HIFI_FBX_BENCHMARK_DIR") };
+    if (modelDir.path().isEmpty() || modelDir.path() == ".") {
+        return;
+    }
+    for (const auto& fileInfo : modelDir.entryInfoList({ "*.fbx" }, QDir::Files)) {
+        benchmarkFile(fileInfo.fileName(), fileInfo.absoluteFilePath());
+    }
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,29 @@
+//
+//  FBXParserTests.h
+//  tests/baking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_baking_FBXParserTests_h
+#define hifi_baking_FBXParserTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class FBXParserTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testBinaryRoundTrip();
+    void testTruncatedFile();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_baking_FBXParserTests_h
@@ -0,0 +1,170 @@
+//
+//  ModelBakerTests.cpp
+//  tests/baking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ModelBakerTests.h"
+
+#include <functional>
+#include <iostream>
+
+#include <FBXSerializer.h>
+#include <GLTFSerializer.h>
+#include <model-baker/Baker.h>
+#include <model-baker/PrepareJointsTask.h>
+#include <SharedUtil.h>
+#include <TBBHelpers.h>
+
+QTEST_GUILESS_MAIN(ModelBakerTests)
+
+// A model made of many small, unshared grid meshes without normals or tangents, like a typical avatar
+static hfm::Model::Pointer createTestModel(int numMeshes, int gridSize) {
+    auto model = std::make_shared<hfm::Model>();
+
+    hfm::Joint joint;
+    joint.name = "root";
+    joint.parentIndex = -1;
+    model->joints.push_back(joint);
+
+    hfm::Material material;
+    material.materialID = "material";
+    model->materials.push_back(material);
+
+    for (int m = 0; m < numMeshes; ++m) {
+        hfm::Mesh mesh;
+        for (int y = 0; y <= gridSize; ++y) {
+            for (int x = 0; x <= gridSize; ++x) {
+                float height = 0.1f * sinf((float)(x * (m + 1)) * 0.3f) * cosf((float)y * 0.2f);
+                mesh.vertices.push_back(glm::vec3((float)x, height, (float)(y + m * gridSize)));
+                mesh.texCoords.push_back(glm::vec2((float)x / gridSize, (float)y / gridSize));
+            }
+        }
+
+        hfm::MeshPart part;
+        for (int y = 0; y < gridSize; ++y) {
+            for (int x = 0; x < gridSize; ++x) {
+                int corner = y * (gridSize + 1) + x;
+                part.triangleIndices << corner << corner + gridSize + 1 << corner + 1;
+                part.triangleIndices << corner + 1 << corner + gridSize + 1 << corner + gridSize + 2;
+            }
+        }
+        mesh.parts.push_back(part);
+        mesh.meshIndex = m;
+        model->meshes.push_back(mesh);
+
+        hfm::Shape shape;
+        shape.mesh = m;
+        shape.meshPart = 0;
+        shape.material = 0;
+        shape.joint = 0;
+        model->shapes.push_back(shape);
+    }
+    return model;
+}
+
+static std::shared_ptr<baker::Baker> bake(const hfm::Model::Pointer& model, int numThreads) {
+    auto baker = std::make_shared<baker::Baker>(model, hifi::VariantHash(), hifi::URL());
+    auto config = baker->getConfiguration();
+    config->getJobConfig("BuildDracoMesh")->setEnabled(true);
+    ((PrepareJointsConfig*)config->getJobConfig("PrepareJoints"))->passthrough = true;
+
+    tbb::task_arena arena(numThreads);
+    arena.execute([&] {
+        baker->run();
+    });
+    return baker;
+}
+
+void ModelBakerTests::testOutputIndependentOfThreadCount() {
+    const int NUM_MESHES = 64;
+    const int GRID_SIZE = 16;
+    // The baker edits the model it is given, so each run gets its own
+    auto sequential = bake(createTestModel(NUM_MESHES, GRID_SIZE), 1);
+    auto parallel = bake(createTestModel(NUM_MESHES, GRID_SIZE), 8);
+
+    auto expectedModel = sequential->getHFMModel();
+    auto actualModel = parallel->getHFMModel();
+    QCOMPARE(actualModel->meshes.size(), expectedModel->meshes.size());
+    for (size_t i = 0; i < expectedModel->meshes.size(); ++i) {
+        const auto& expected = expectedModel->meshes[i];
+        const auto& actual = actualModel->meshes[i];
+        QCOMPARE(actual.normals.size(), expected.vertices.size());
+        QCOMPARE(actual.normals, expected.normals);
+        QCOMPARE(actual.tangents, expected.tangents);
+        QVERIFY(actual._mesh && expected._mesh);
+        QCOMPARE(actual._mesh->getNumIndices(), expected._mesh->getNumIndices());
+        QCOMPARE(actual.triangleListMesh.vertices, expected.triangleListMesh.vertices);
+    }
+
+    const auto& expectedDraco = sequential->getDracoMeshes();
+    const auto& actualDraco = parallel->getDracoMeshes();
+    QCOMPARE(actualDraco.size(), expectedDraco.size());
+    for (size_t i = 0; i < expectedDraco.size(); ++i) {
+        QVERIFY(!expectedDraco[i].isEmpty());
+        QCOMPARE(actualDraco[i], expectedDraco[i]);
+    }
+    auto errors = parallel->getDracoErrors();
+    QVERIFY(std::find(errors.cbegin(), errors.cend(), true) == errors.cend());
+}
+
+#ifdef MANUAL_TEST
+
+static const char* BENCHMARKED_TASKS[] = {
+    "CalculateMeshNormals", "CalculateMeshTangents", "CalculateBlendshapeNormals", "CalculateBlendshapeTangents",
+    "CollectShapeVertices", "BuildMeshTriangleListTask", "BuildGraphicsMesh", "CalculateExtents", "BuildDracoMesh"
+};
+
+static void benchmarkModel(const QString& name, const std::function<hfm::Model::Pointer()>& loadModel) {
+    for (int numThreads : { 1, 4, 16 }) {
+        auto model = loadModel();
+        if (!model) {
+            std::cout << "Could not load " << name.toStdString() << std::endl;
+            return;
+        }
+
+        uint64_t startTime = usecTimestampNow();
+        auto baker = bake(model, numThreads);
+        double msecs = (double)(usecTimestampNow() - startTime) / USECS_PER_MSEC;
+
+        std::cout << name.toStdString() << " (" << model->meshes.size() << " meshes), " << numThreads << " threads: "
+            << msecs << " ms" << std::endl;
+        auto config = baker->getConfiguration();
+        for (auto task : BENCHMARKED_TASKS) {
+            std::cout << "    " << task << ": " << config->getJobConfig(task)->getCPURunTime() << " ms" << std::endl;
+        }
+    }
+}
+
+// Set HIFI_MODEL_BAKER_BENCHMARK_DIR to a folder of .fbx/.gltf/.glb files to benchmark them as well
+void ModelBakerTests::benchmark() {
+    benchmarkModel("synthetic avatar", [] { return createTestModel(200, 32); });
+
+    QDir modelDir { QProcessEnvironment::systemEnvironment().value("HIFI_MODEL_BAKER_BENCHMARK_DIR") };
+    if (modelDir.path().isEmpty() || modelDir.path() == ".") {
+        return;
+    }
+    for (const auto& fileInfo : modelDir.entryInfoList({ "*.fbx", "*.gltf", "*.glb" }, QDir::Files)) {
+        QFile file { fileInfo.absoluteFilePath() };
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        auto data = file.readAll();
+        auto url = QUrl::fromLocalFile(fileInfo.absoluteFilePath());
+        hifi::VariantHash mapping;
+        mapping["deduplicateIndices"] = true;
+
+        benchmarkModel(fileInfo.fileName(), [&]() -> hfm::Model::Pointer {
+            if (fileInfo.suffix().toLower() == "fbx") {
+                return FBXSerializer().read(data, mapping, url);
+            }
+            return GLTFSerializer().read(data, mapping, url);
+        });
+    }
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,28 @@
+//
+//  ModelBakerTests.h
+//  tests/baking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_baking_ModelBakerTests_h
+#define hifi_baking_ModelBakerTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class ModelBakerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testOutputIndependentOfThreadCount();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_baking_ModelBakerTests_h
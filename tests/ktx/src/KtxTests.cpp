@@ -8,13 +8,20 @@
 
 #include "KtxTests.h"
 
+#include <iostream>
 #include <mutex>
 
 #include <QtTest/QtTest>
 
 #include <ktx/KTX.h>
+#include <ktx/StreamingReader.h>
 #include <gpu/Texture.h>
 #include <image/Image.h>
+#include <SharedUtil.h>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
 
 
 QTEST_GUILESS_MAIN(KtxTests)
@@ -142,6 +149,163 @@ void KtxTests::testKtxSerialization() {
     testTexture->setKtxBacking(TEST_IMAGE_KTX.fileName().toStdString());
 }
 
+// An uncompressed RGBA mip chain where every byte of a level is the level number
+static std::unique_ptr<ktx::KTX> createMipChainKtx(uint32_t size) {
+    ktx::Header header;
+    header.pixelWidth = size;
+    header.pixelHeight = size;
+    header.numberOfMipmapLevels = 1;
+    while ((size >> header.numberOfMipmapLevels) > 0) {
+        header.numberOfMipmapLevels++;
+    }
+
+    std::vector<std::vector<ktx::Byte>> levels;
+    ktx::Images images;
+    for (uint32_t level = 0; level < header.numberOfMipmapLevels; ++level) {
+        auto imageSize = (uint32_t)header.evalImageSize(level);
+        levels.emplace_back(imageSize, (ktx::Byte)level);
+    }
+    for (uint32_t level = 0; level < header.numberOfMipmapLevels; ++level) {
+        images.emplace_back(ktx::Image(0, (uint32_t)levels[level].size(), 0, levels[level].data()));
+    }
+    return ktx::KTX::create(header, images);
+}
+
+void KtxTests::testStreamingReader() {
+    auto ktxMemory = createMipChainKtx(256);
+    QVERIFY(ktxMemory.get());
+    const auto& storage = ktxMemory->getStorage();
+
+    auto reader = ktx::StreamingReader::create(storage);
+    QVERIFY(reader.get());
+    QCOMPARE((uint32_t)reader->getNumLevels(), ktxMemory->getHeader().getNumberOfLevels());
+
+    // The descriptor is computed from the header alone but must match the parsed one
+    auto expected = ktxMemory->toDescriptor();
+    auto actual = reader->toDescriptor();
+    QCOMPARE(actual.images.size(), expected.images.size());
+    for (size_t i = 0; i < expected.images.size(); ++i) {
+        QCOMPARE(actual.images[i]._imageOffset, expected.images[i]._imageOffset);
+        QCOMPARE(actual.images[i]._faceSize, expected.images[i]._faceSize);
+        QCOMPARE(actual.images[i]._padding, expected.images[i]._padding);
+        QVERIFY(actual.images[i]._faceOffsets == expected.images[i]._faceOffsets);
+    }
+
+    for (uint16_t level = 0; level < reader->getNumLevels(); ++level) {
+        auto texels = reader->getMipFaceTexelsData(level);
+        QVERIFY(texels.get());
+        QCOMPARE(texels->size(), ktxMemory->getMipFaceTexelsData(level)->size());
+        QCOMPARE(texels->data()[0], (ktx::Byte)level);
+        QCOMPARE(texels->data()[texels->size() - 1], (ktx::Byte)level);
+    }
+    QVERIFY(!reader->getMipFaceTexelsData(reader->getNumLevels()));
+
+    // A header cut short is rejected up front
+    QVERIFY(!ktx::StreamingReader::create(storage->createView(ktx::KTX_HEADER_SIZE - 1)));
+
+    // A truncated file only fails on the levels it cut off, when they are requested
+    auto truncated = ktx::StreamingReader::create(storage->createView(storage->size() - 64));
+    QVERIFY(truncated.get());
+    QVERIFY(truncated->getMipFaceTexelsData(0).get());
+    QVERIFY(!truncated->getMipFaceTexelsData(truncated->getNumLevels() - 1));
+
+    // So does a corrupt image size, other levels stay readable
+    for (size_t level : { (size_t)0, expected.images.size() - 1 }) {
+        auto corrupt = std::make_shared<storage::MemoryStorage>(storage->size(), storage->data());
+        auto corruptOffset = expected.images[level]._faceOffsets[0] - ktx::IMAGE_SIZE_WIDTH;
+        corrupt->data()[corruptOffset] ^= 0xFF;
+        auto corruptReader = ktx::StreamingReader::create(corrupt);
+        QVERIFY(corruptReader.get());
+        QVERIFY(!corruptReader->getMipFaceTexelsData((uint16_t)level));
+        QVERIFY(!corruptReader->getMipFaceTexelsData((uint16_t)level));
+        QVERIFY(corruptReader->getMipFaceTexelsData(level == 0 ? 1 : 0).get());
+        QVERIFY(!ktx::StreamingReader::checkLevel(*corrupt, expected.images[level], (uint16_t)level));
+    }
+}
+
+#ifdef MANUAL_TEST
+
+static long getPeakRSSKilobytes() {
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+void KtxTests::benchmarkStreamingReader() {
+    const uint32_t SIZE = 4096;
+    const int NUM_FILES = 8;
+
+    QTemporaryDir dir;
+    QStringList files;
+    {
+        auto ktxMemory = createMipChainKtx(SIZE);
+        const auto& storage = ktxMemory->getStorage();
+        for (int i = 0; i < NUM_FILES; ++i) {
+            auto filename = dir.filePath(QString("%1.ktx").arg(i));
+            storage->toFileStorage(filename);
+            files.push_back(filename);
+        }
+    }
+    std::cout << NUM_FILES << " files of " << SIZE << "x" << SIZE << " RGBA, peak RSS before "
+        << getPeakRSSKilobytes() << " KB" << std::endl;
+
+    // Header only: both read the header and key-values and nothing else
+    uint64_t headerTime = 0;
+    for (const auto& filename : files) {
+        uint64_t startTime = usecTimestampNow();
+        auto reader = ktx::StreamingReader::create(std::make_shared<storage::FileStorage>(filename));
+        QVERIFY(reader.get());
+        headerTime += usecTimestampNow() - startTime;
+    }
+    std::cout << "streaming: header " << (headerTime / NUM_FILES) << " usec" << std::endl;
+
+    headerTime = 0;
+    for (const auto& filename : files) {
+        uint64_t startTime = usecTimestampNow();
+        auto storage = std::make_shared<storage::FileStorage>(filename);
+        QVERIFY(ktx::KTX::checkHeaderFromStorage(storage->size(), storage->data()));
+        ktx::Header header;
+        memcpy(&header, storage->data(), sizeof(ktx::Header));
+        auto keyValues = ktx::KTX::parseKeyValues(header.bytesOfKeyValueData, storage->data() + sizeof(ktx::Header));
+        headerTime += usecTimestampNow() - startTime;
+    }
+    std::cout << "whole file: header " << (headerTime / NUM_FILES) << " usec" << std::endl;
+
+    // One mip: both open the file and copy out the smallest mip, the way KtxStorage does.
+    // Streaming first, since peak RSS only ever grows
+    uint64_t mipTime = 0;
+    for (const auto& filename : files) {
+        uint64_t startTime = usecTimestampNow();
+        auto reader = ktx::StreamingReader::create(std::make_shared<storage::FileStorage>(filename));
+        QVERIFY(reader.get());
+        auto texels = reader->getMipFaceTexelsData(reader->getNumLevels() - 1);
+        QVERIFY(texels.get());
+        QVERIFY(texels->toMemoryStorage().get());
+        mipTime += usecTimestampNow() - startTime;
+    }
+    std::cout << "streaming: one mip " << (mipTime / NUM_FILES) << " usec, peak RSS "
+        << getPeakRSSKilobytes() << " KB" << std::endl;
+
+    mipTime = 0;
+    for (const auto& filename : files) {
+        uint64_t startTime = usecTimestampNow();
+        auto ktxFile = ktx::KTX::create(std::make_shared<storage::FileStorage>(filename));
+        QVERIFY(ktxFile.get());
+        auto texels = ktxFile->getMipFaceTexelsData((uint16_t)(ktxFile->_images.size() - 1));
+        QVERIFY(texels.get());
+        QVERIFY(texels->toMemoryStorage().get());
+        mipTime += usecTimestampNow() - startTime;
+    }
+    std::cout << "whole file: one mip " << (mipTime / NUM_FILES) << " usec, peak RSS "
+        << getPeakRSSKilobytes() << " KB" << std::endl;
+}
+
+#endif // MANUAL_TEST
+
 #if 0
 
 static const QString TEST_FOLDER { "H:/ktx_cacheold" };
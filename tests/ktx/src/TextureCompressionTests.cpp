@@ -0,0 +1,109 @@
+//
+//  TextureCompressionTests.cpp
+//  tests/ktx/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureCompressionTests.h"
+
+#include <iostream>
+
+#include <QImage>
+
+#include <gpu/Texture.h>
+#include <image/Image.h>
+#include <image/TextureProcessing.h>
+#include <SharedUtil.h>
+#include <TBBHelpers.h>
+
+QTEST_GUILESS_MAIN(TextureCompressionTests)
+
+// Smooth gradients with some high frequency detail so every encoder has real work to do
+static image::Image createTestImage(int size) {
+    QImage qimage(size, size, QImage::Format_ARGB32);
+    for (int y = 0; y < size; ++y) {
+        QRgb* line = reinterpret_cast<QRgb*>(qimage.scanLine(y));
+        for (int x = 0; x < size; ++x) {
+            int noise = ((x * 7919) ^ (y * 104729)) & 0x1F;
+            line[x] = qRgba((x * 255 / size + noise) & 0xFF, (y * 255 / size) & 0xFF, ((x + y) * 3) & 0xFF, (x ^ y) & 0xFF);
+        }
+    }
+    return image::Image(qimage);
+}
+
+static gpu::TexturePointer compress(const image::Image& source, const gpu::Element& format, gpu::BackendTarget target, int numThreads) {
+    auto texture = gpu::Texture::create2D(format, source.getWidth(), source.getHeight(), gpu::Texture::MAX_NUM_MIPS);
+    texture->setStoredMipFormat(format);
+
+    tbb::task_arena arena(numThreads);
+    arena.execute([&] {
+        image::Image copy = source;
+        image::convertToTextureWithMips(texture.get(), std::move(copy), target);
+    });
+    return texture;
+}
+
+void TextureCompressionTests::testMipChainIsComplete() {
+    const int SIZE = 256;
+    auto source = createTestImage(SIZE);
+    auto texture = compress(source, gpu::Element::COLOR_COMPRESSED_BCX_SRGBA, gpu::BackendTarget::GL45, 4);
+
+    QCOMPARE((int)texture->getNumMips(), 9);
+    for (gpu::uint16 level = 0; level < texture->getNumMips(); ++level) {
+        QVERIFY(texture->isStoredMipFaceAvailable(level));
+        QCOMPARE(texture->getStoredMipSize(level), texture->evalStoredMipSize(level, texture->getStoredMipFormat()));
+    }
+}
+
+void TextureCompressionTests::testOutputIndependentOfThreadCount() {
+    const int SIZE = 256;
+    auto source = createTestImage(SIZE);
+    auto sequential = compress(source, gpu::Element::COLOR_COMPRESSED_BCX_SRGB, gpu::BackendTarget::GL45, 1);
+    auto parallel = compress(source, gpu::Element::COLOR_COMPRESSED_BCX_SRGB, gpu::BackendTarget::GL45, 8);
+
+    QCOMPARE(sequential->getNumMips(), parallel->getNumMips());
+    for (gpu::uint16 level = 0; level < sequential->getNumMips(); ++level) {
+        auto expected = sequential->accessStoredMipFace(level);
+        auto actual = parallel->accessStoredMipFace(level);
+        QVERIFY(expected && actual);
+        QCOMPARE(actual->size(), expected->size());
+        QVERIFY(memcmp(actual->data(), expected->data(), expected->size()) == 0);
+    }
+}
+
+#ifdef MANUAL_TEST
+
+void TextureCompressionTests::benchmark() {
+    const int SIZE = 2048;
+    struct Encoding {
+        const char* name;
+        gpu::Element format;
+        gpu::BackendTarget target;
+    };
+    const Encoding encodings[] = {
+        { "BC1", gpu::Element::COLOR_COMPRESSED_BCX_SRGB, gpu::BackendTarget::GL45 },
+        { "BC3", gpu::Element::COLOR_COMPRESSED_BCX_SRGBA, gpu::BackendTarget::GL45 },
+        { "BC7", gpu::Element::COLOR_COMPRESSED_BCX_SRGBA_HIGH, gpu::BackendTarget::GL45 },
+        { "ETC2", gpu::Element::COLOR_COMPRESSED_ETC2_SRGBA, gpu::BackendTarget::GLES32 },
+    };
+
+    auto source = createTestImage(SIZE);
+    // The whole chain is about 4/3 of the base level
+    const double megapixels = (double)SIZE * SIZE * 4.0 / 3.0 / 1.0e6;
+
+    for (auto& encoding : encodings) {
+        for (int numThreads : { 1, 4, 16 }) {
+            uint64_t startTime = usecTimestampNow();
+            compress(source, encoding.format, encoding.target, numThreads);
+            double seconds = (double)(usecTimestampNow() - startTime) / USECS_PER_SECOND;
+            std::cout << encoding.name << " " << SIZE << "x" << SIZE << ", " << numThreads << " threads: "
+                << (megapixels / seconds) << " MP/s (" << seconds << " s)" << std::endl;
+        }
+    }
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,29 @@
+//
+//  TextureCompressionTests.h
+//  tests/ktx/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ktx_TextureCompressionTests_h
+#define hifi_ktx_TextureCompressionTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class TextureCompressionTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testMipChainIsComplete();
+    void testOutputIndependentOfThreadCount();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_ktx_TextureCompressionTests_h
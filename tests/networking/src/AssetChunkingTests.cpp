@@ -0,0 +1,161 @@
+//
+//  AssetChunkingTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetChunkingTests.h"
+
+#include <functional>
+#include <iostream>
+#include <random>
+
+#include <QtCore/QSet>
+
+#include <AssetChunking.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AssetChunkingTests)
+
+using namespace AssetUtils;
+
+static QByteArray randomBytes(int size, uint32_t seed) {
+    std::mt19937 generator(seed);
+    QByteArray bytes(size, 0);
+    for (int i = 0; i < size; ++i) {
+        bytes[i] = (char)(generator() & 0xff);
+    }
+    return bytes;
+}
+
+// Bytes of `edited` a receiver holding `original` would still have to transfer
+static DataOffset missingBytes(const AssetManifest& original, const AssetManifest& edited) {
+    QSet<QByteArray> known;
+    for (const auto& chunk : original.chunks) {
+        known.insert(chunk.hash);
+    }
+    DataOffset missing = 0;
+    for (const auto& chunk : edited.chunks) {
+        if (!known.contains(chunk.hash)) {
+            missing += chunk.size;
+        }
+    }
+    return missing;
+}
+
+void AssetChunkingTests::testChunkSizes() {
+    const int SIZE = 8 * 1024 * 1024 + 123;
+    auto data = randomBytes(SIZE, 1);
+    auto manifest = createManifest(data);
+
+    QVERIFY(manifest.isValid());
+    QCOMPARE(manifest.size, (DataOffset)SIZE);
+    QCOMPARE(manifest.hash, hashData(data));
+
+    for (size_t i = 0; i < manifest.chunks.size(); ++i) {
+        const auto& chunk = manifest.chunks[i];
+        QVERIFY(chunk.size <= MAX_CHUNK_SIZE);
+        if (i + 1 < manifest.chunks.size()) {
+            QVERIFY(chunk.size >= MIN_CHUNK_SIZE);
+        }
+        QCOMPARE(chunk.hash, hashData(data.mid(chunk.offset, chunk.size)));
+    }
+
+    auto averageSize = SIZE / (DataOffset)manifest.chunks.size();
+    QVERIFY(averageSize > AVERAGE_CHUNK_SIZE / 2);
+    QVERIFY(averageSize < AVERAGE_CHUNK_SIZE * 2);
+
+    // small inputs are a single chunk
+    auto small = createManifest(data.left(1000));
+    QCOMPARE(small.chunks.size(), (size_t)1);
+    QVERIFY(createManifest(QByteArray()).chunks.empty());
+}
+
+void AssetChunkingTests::testEditsOnlyChangeNearbyChunks() {
+    const int SIZE = 8 * 1024 * 1024;
+    auto data = randomBytes(SIZE, 2);
+    auto original = createManifest(data);
+
+    auto inserted = data;
+    inserted.insert(SIZE / 2, QByteArray(100, 'x'));
+    QVERIFY(missingBytes(original, createManifest(inserted)) <= 2 * MAX_CHUNK_SIZE);
+
+    auto removed = data;
+    removed.remove(SIZE / 3, 5000);
+    QVERIFY(missingBytes(original, createManifest(removed)) <= 2 * MAX_CHUNK_SIZE);
+
+    auto prepended = data;
+    prepended.prepend("header");
+    QVERIFY(missingBytes(original, createManifest(prepended)) <= 2 * MAX_CHUNK_SIZE);
+
+    QCOMPARE(missingBytes(original, createManifest(data)), (DataOffset)0);
+}
+
+void AssetChunkingTests::testManifestRoundTrip() {
+    auto data = randomBytes(3 * 1024 * 1024, 3);
+    auto manifest = createManifest(data);
+
+    AssetManifest decoded;
+    QVERIFY(AssetManifest::fromByteArray(manifest.toByteArray(), decoded));
+    QCOMPARE(decoded.hash, manifest.hash);
+    QCOMPARE(decoded.size, manifest.size);
+    QCOMPARE(decoded.chunks.size(), manifest.chunks.size());
+    for (size_t i = 0; i < manifest.chunks.size(); ++i) {
+        QCOMPARE(decoded.chunks[i].hash, manifest.chunks[i].hash);
+        QCOMPARE(decoded.chunks[i].offset, manifest.chunks[i].offset);
+        QCOMPARE(decoded.chunks[i].size, manifest.chunks[i].size);
+    }
+
+    // truncated or inconsistent manifests are rejected
+    auto bytes = manifest.toByteArray();
+    QVERIFY(!AssetManifest::fromByteArray(bytes.left(bytes.size() - 1), decoded));
+    auto wrongSize = manifest;
+    wrongSize.size += 1;
+    QVERIFY(!AssetManifest::fromByteArray(wrongSize.toByteArray(), decoded));
+}
+
+#ifdef MANUAL_TEST
+void AssetChunkingTests::benchmark() {
+    // a large model re-uploaded after typical edits
+    const int SIZE = 300 * 1024 * 1024;
+    auto data = randomBytes(SIZE, 4);
+
+    auto start = usecTimestampNow();
+    auto original = createManifest(data);
+    auto elapsed = usecTimestampNow() - start;
+    std::cout << "chunked " << SIZE / (1024 * 1024) << " MB into " << original.chunks.size() << " chunks at "
+              << (SIZE / (1024.0 * 1024.0)) / ((double)elapsed / USECS_PER_SECOND) << " MB/s" << std::endl;
+
+    struct Edit {
+        const char* name;
+        std::function<void(QByteArray&)> apply;
+    };
+    std::vector<Edit> edits {
+        { "prepend 16 bytes", [](QByteArray& bytes) { bytes.prepend(QByteArray(16, 'h')); } },
+        { "overwrite 4 KB in the middle", [](QByteArray& bytes) { bytes.replace(bytes.size() / 2, 4096, QByteArray(4096, 'o')); } },
+        { "insert 1 MB at a third", [](QByteArray& bytes) { bytes.insert(bytes.size() / 3, randomBytes(1024 * 1024, 5)); } },
+        { "remove 64 KB at two thirds", [](QByteArray& bytes) { bytes.remove(2 * bytes.size() / 3, 64 * 1024); } },
+        { "append 1 MB", [](QByteArray& bytes) { bytes.append(randomBytes(1024 * 1024, 6)); } },
+        { "10 scattered 100 byte edits", [](QByteArray& bytes) {
+            for (int i = 0; i < 10; ++i) {
+                bytes.replace((i * 2 + 1) * bytes.size() / 20, 100, QByteArray(100, 'e'));
+            }
+        } },
+    };
+
+    for (const auto& edit : edits) {
+        auto edited = data;
+        edit.apply(edited);
+        auto manifest = createManifest(edited);
+        auto missing = missingBytes(original, manifest);
+        auto manifestSize = manifest.toByteArray().size();
+        std::cout << edit.name << ": whole " << edited.size() << " bytes, chunked " << (missing + manifestSize)
+                  << " bytes (" << missing << " chunk data + " << manifestSize << " manifest), "
+                  << 100.0 * (missing + manifestSize) / edited.size() << "%" << std::endl;
+    }
+}
+#endif // MANUAL_TEST
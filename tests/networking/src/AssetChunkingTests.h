@@ -0,0 +1,29 @@
+//
+//  AssetChunkingTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetChunkingTests_h
+#define hifi_AssetChunkingTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class AssetChunkingTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testChunkSizes();
+    void testEditsOnlyChangeNearbyChunks();
+    void testManifestRoundTrip();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_AssetChunkingTests_h
@@ -0,0 +1,404 @@
+//
+//  CongestionControlTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CongestionControlTests.h"
+
+#include <algorithm>
+#include <deque>
+#include <queue>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include <udt/BBRCC.h>
+#include <udt/TCPVegasCC.h>
+
+QTEST_MAIN(CongestionControlTests)
+
+using namespace udt;
+using Clock = p_high_resolution_clock;
+using std::chrono::microseconds;
+using std::chrono::duration_cast;
+
+namespace {
+
+static const int PACKET_WIRE_SIZE = 1400;
+static const microseconds MIN_ESTIMATED_TIMEOUT { 10000 };
+static const microseconds MAX_ESTIMATED_TIMEOUT { 5000000 };
+
+struct LinkConditions {
+    int bottleneckPacketsPerSecond;
+    int oneWayDelayUsecs;
+    int jitterUsecs; // added to the forward delay, uniformly distributed, without reordering
+    double lossRate;
+    int bufferPackets; // the bottleneck drops packets that arrive to a full buffer
+};
+
+struct SimulationResult {
+    double goodput; // in order deliveries, as a fraction of the bottleneck bandwidth
+    double rttInflation; // mean RTT over the RTT of an empty path
+    int retransmissions;
+};
+
+// Exposes what Connection reads from and sets on a congestion control
+template <typename CC>
+class SimulatedCC : public CC {
+public:
+    void setInitialSequenceNumber(SequenceNumber seqNum) { this->setInitialSendSequenceNumber(seqNum); }
+    void setCurrentSequenceNumber(SequenceNumber seqNum) { this->setSendCurrentSequenceNumber(seqNum); }
+    double getPacketSendPeriod() const { return this->_packetSendPeriod; }
+    int getCongestionWindowSize() const { return this->_congestionWindowSize; }
+};
+
+// A sender with a backlog that never runs out, a receiver that ACKs every packet like Connection does,
+// and the link between them. Sequence numbers are kept as plain integers, the runs are too short to wrap.
+template <typename CC>
+class Simulation {
+public:
+    Simulation(const LinkConditions& link, uint32_t seed) : _link(link), _random(seed) {}
+
+    SimulationResult run(microseconds warmUp, microseconds duration);
+
+private:
+    enum class EventType { SenderService, SenderTimeout, DataArrival, ACKArrival };
+
+    struct Event {
+        Clock::time_point time;
+        uint64_t order;
+        EventType type;
+        int64_t value;
+
+        bool operator>(const Event& other) const {
+            return time != other.time ? time > other.time : order > other.order;
+        }
+    };
+
+    void schedule(Clock::time_point time, EventType type, int64_t value = 0) {
+        _events.push({ time, _nextEventOrder++, type, value });
+    }
+
+    void service(Clock::time_point now);
+    void timeout(Clock::time_point now, int64_t generation);
+    void transmit(int64_t sequenceNumber, Clock::time_point now);
+    void receive(int64_t sequenceNumber, Clock::time_point now);
+    void processACK(int64_t ack, Clock::time_point now);
+    void wakeIfWaiting(Clock::time_point now);
+    void updateCongestionControl();
+
+    LinkConditions _link;
+    std::mt19937 _random;
+    Clock::time_point _start;
+    Clock::time_point _measureStart;
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> _events;
+    uint64_t _nextEventOrder { 0 };
+
+    SimulatedCC<CC> _congestionControl;
+
+    // sender, as in SendQueue
+    int64_t _currentSequenceNumber { 1000 }; // last sent
+    int64_t _lastACK { 1000 };
+    std::set<int64_t> _naks;
+    double _packetSendPeriod { 0.0 };
+    int _flowWindowSize { 0 };
+    Clock::time_point _nextPacketTimestamp;
+    Clock::time_point _lastPacketSentAt;
+    bool _isPacing { false };
+    bool _isWaitingForWork { false };
+    int64_t _timeoutGeneration { 0 };
+    std::unordered_map<int64_t, Clock::time_point> _firstSendTimes;
+    std::set<int64_t> _resent;
+
+    // bottleneck
+    std::deque<Clock::time_point> _bottleneckDepartures;
+    Clock::time_point _lastDeparture;
+    Clock::time_point _lastArrival;
+
+    // receiver, as in Connection
+    int64_t _lastReceived { 1000 };
+    std::set<int64_t> _lossList;
+
+    // measurements
+    int64_t _measureStartACK { -1 };
+    double _rttSum { 0.0 };
+    int _rttSamples { 0 };
+    int _retransmissions { 0 };
+};
+
+template <typename CC>
+SimulationResult Simulation<CC>::run(microseconds warmUp, microseconds duration) {
+    _start = Clock::now();
+    _measureStart = _start + warmUp;
+    _lastDeparture = _start;
+    _lastArrival = _start;
+
+    _congestionControl.init();
+    _congestionControl.setInitialSequenceNumber(SequenceNumber((uint32_t)_currentSequenceNumber));
+    updateCongestionControl();
+
+    schedule(_start, EventType::SenderService);
+
+    auto end = _measureStart + duration;
+    while (!_events.empty() && _events.top().time < end) {
+        auto event = _events.top();
+        _events.pop();
+
+        if (_measureStartACK == -1 && event.time >= _measureStart) {
+            _measureStartACK = _lastACK;
+        }
+
+        switch (event.type) {
+            case EventType::SenderService:
+                service(event.time);
+                break;
+            case EventType::SenderTimeout:
+                timeout(event.time, event.value);
+                break;
+            case EventType::DataArrival:
+                receive(event.value, event.time);
+                break;
+            case EventType::ACKArrival:
+                processACK(event.value, event.time);
+                break;
+        }
+    }
+
+    auto serviceTime = microseconds(1000000 / _link.bottleneckPacketsPerSecond);
+    double emptyPathRTT = (double)(2 * _link.oneWayDelayUsecs + serviceTime.count());
+    double seconds = duration.count() / 1000000.0;
+
+    SimulationResult result;
+    result.goodput = (_lastACK - _measureStartACK) / (_link.bottleneckPacketsPerSecond * seconds);
+    result.rttInflation = _rttSamples > 0 ? (_rttSum / _rttSamples) / emptyPathRTT : 0.0;
+    result.retransmissions = _retransmissions;
+    return result;
+}
+
+template <typename CC>
+void Simulation<CC>::service(Clock::time_point now) {
+    _isWaitingForWork = false;
+
+    if (!_isPacing) {
+        _nextPacketTimestamp = now;
+        _isPacing = true;
+    }
+
+    // re-sends go first, and aren't limited by the flow window
+    bool didSend = false;
+    while (!_naks.empty()) {
+        int64_t sequenceNumber = *_naks.begin();
+        _naks.erase(_naks.begin());
+        if (sequenceNumber > _lastACK) {
+            transmit(sequenceNumber, now);
+            _resent.insert(sequenceNumber);
+            ++_retransmissions;
+            _congestionControl.onPacketReSent(PACKET_WIRE_SIZE, SequenceNumber((uint32_t)sequenceNumber), now);
+            didSend = true;
+            break;
+        }
+    }
+
+    if (!didSend && _currentSequenceNumber - _lastACK + 1 <= _flowWindowSize) {
+        ++_currentSequenceNumber;
+        transmit(_currentSequenceNumber, now);
+        _firstSendTimes[_currentSequenceNumber] = now;
+        _congestionControl.onPacketSent(PACKET_WIRE_SIZE, SequenceNumber((uint32_t)_currentSequenceNumber), now);
+        didSend = true;
+    }
+
+    if (!didSend) {
+        // wait for an ACK to open the window, or for the timeout, as in SendQueue::checkInactivity
+        _isWaitingForWork = true;
+        _isPacing = false;
+        auto estimatedTimeout = microseconds(_congestionControl.estimatedTimeout());
+        estimatedTimeout = std::min(MAX_ESTIMATED_TIMEOUT, std::max(MIN_ESTIMATED_TIMEOUT, estimatedTimeout));
+        if (now - _lastPacketSentAt > estimatedTimeout) {
+            timeout(now, ++_timeoutGeneration);
+        } else {
+            schedule(now + estimatedTimeout, EventType::SenderTimeout, ++_timeoutGeneration);
+        }
+        return;
+    }
+
+    _lastPacketSentAt = now;
+
+    // same pacing as SendQueue::nextPacketTime
+    if (_packetSendPeriod <= 0) {
+        schedule(now, EventType::SenderService);
+        return;
+    }
+
+    auto nextPacketDelta = microseconds((int64_t)_packetSendPeriod);
+    _nextPacketTimestamp += nextPacketDelta;
+    if (_nextPacketTimestamp - now > nextPacketDelta) {
+        _nextPacketTimestamp = now + nextPacketDelta;
+    }
+    schedule(std::max(now, _nextPacketTimestamp), EventType::SenderService);
+}
+
+template <typename CC>
+void Simulation<CC>::timeout(Clock::time_point now, int64_t generation) {
+    if (!_isWaitingForWork || generation != _timeoutGeneration) {
+        return;
+    }
+
+    if (_lastACK < _currentSequenceNumber) {
+        // nothing was ACKed for a whole timeout, re-send everything in flight
+        for (int64_t sequenceNumber = _lastACK + 1; sequenceNumber <= _currentSequenceNumber; ++sequenceNumber) {
+            _naks.insert(sequenceNumber);
+        }
+        _congestionControl.setCurrentSequenceNumber(SequenceNumber((uint32_t)_currentSequenceNumber));
+        _congestionControl.onTimeout();
+        updateCongestionControl();
+    }
+
+    service(now);
+}
+
+template <typename CC>
+void Simulation<CC>::transmit(int64_t sequenceNumber, Clock::time_point now) {
+    std::uniform_real_distribution<double> lossDistribution(0.0, 1.0);
+    if (lossDistribution(_random) < _link.lossRate) {
+        return;
+    }
+
+    while (!_bottleneckDepartures.empty() && _bottleneckDepartures.front() <= now) {
+        _bottleneckDepartures.pop_front();
+    }
+    if ((int)_bottleneckDepartures.size() >= _link.bufferPackets) {
+        // tail drop
+        return;
+    }
+
+    auto serviceTime = microseconds(1000000 / _link.bottleneckPacketsPerSecond);
+    _lastDeparture = std::max(now, _lastDeparture) + serviceTime;
+    _bottleneckDepartures.push_back(_lastDeparture);
+
+    std::uniform_int_distribution<int> jitterDistribution(0, _link.jitterUsecs);
+    auto arrival = _lastDeparture + microseconds(_link.oneWayDelayUsecs + jitterDistribution(_random));
+    _lastArrival = std::max(arrival, _lastArrival);
+    schedule(_lastArrival, EventType::DataArrival, sequenceNumber);
+}
+
+template <typename CC>
+void Simulation<CC>::receive(int64_t sequenceNumber, Clock::time_point now) {
+    if (sequenceNumber > _lastReceived + 1) {
+        for (int64_t lost = _lastReceived + 1; lost < sequenceNumber; ++lost) {
+            _lossList.insert(lost);
+        }
+    }
+
+    if (sequenceNumber > _lastReceived) {
+        _lastReceived = sequenceNumber;
+    } else {
+        _lossList.erase(sequenceNumber);
+    }
+
+    int64_t ack = _lossList.empty() ? _lastReceived : *_lossList.begin() - 1;
+    schedule(now + microseconds(_link.oneWayDelayUsecs), EventType::ACKArrival, ack);
+}
+
+template <typename CC>
+void Simulation<CC>::processACK(int64_t ack, Clock::time_point now) {
+    if (ack < _lastACK) {
+        return;
+    }
+
+    if (ack > _lastACK) {
+        if (now >= _measureStart && !_resent.count(ack)) {
+            _rttSum += duration_cast<microseconds>(now - _firstSendTimes[ack]).count();
+            ++_rttSamples;
+        }
+        for (int64_t acked = _lastACK + 1; acked <= ack; ++acked) {
+            _firstSendTimes.erase(acked);
+            _resent.erase(acked);
+        }
+        _naks.erase(_naks.begin(), _naks.upper_bound(ack));
+        _lastACK = ack;
+        wakeIfWaiting(now);
+    }
+
+    _congestionControl.setCurrentSequenceNumber(SequenceNumber((uint32_t)_currentSequenceNumber));
+    if (_congestionControl.onACK(SequenceNumber((uint32_t)ack), now)) {
+        _naks.insert(ack + 1);
+        wakeIfWaiting(now);
+    }
+    updateCongestionControl();
+}
+
+template <typename CC>
+void Simulation<CC>::wakeIfWaiting(Clock::time_point now) {
+    if (_isWaitingForWork) {
+        _isWaitingForWork = false;
+        ++_timeoutGeneration;
+        schedule(now, EventType::SenderService);
+    }
+}
+
+template <typename CC>
+void Simulation<CC>::updateCongestionControl() {
+    _packetSendPeriod = _congestionControl.getPacketSendPeriod();
+    _flowWindowSize = _congestionControl.getCongestionWindowSize();
+}
+
+template <typename CC>
+SimulationResult simulate(const LinkConditions& link) {
+    static const uint32_t SEED = 1234;
+    static const microseconds WARM_UP { 2000000 };
+    static const microseconds DURATION { 20000000 };
+
+    Simulation<CC> simulation(link, SEED);
+    return simulation.run(WARM_UP, DURATION);
+}
+
+void report(const char* name, const SimulationResult& vegas, const SimulationResult& bbr) {
+    qDebug() << name;
+    qDebug() << "  TCP Vegas: goodput" << vegas.goodput << "RTT inflation" << vegas.rttInflation
+        << "re-sent" << vegas.retransmissions;
+    qDebug() << "  BBR:       goodput" << bbr.goodput << "RTT inflation" << bbr.rttInflation
+        << "re-sent" << bbr.retransmissions;
+}
+
+}
+
+void CongestionControlTests::testJitteryLink() {
+    // 2000 packets per second with a 40ms RTT, up to 15ms of jitter and 0.5% random loss
+    LinkConditions link { 2000, 20000, 15000, 0.005, 200 };
+
+    auto vegas = simulate<TCPVegasCC>(link);
+    auto bbr = simulate<BBRCC>(link);
+    report("Jittery link", vegas, bbr);
+
+    // Vegas keeps timing out and re-sending its whole window here, BBR's model sees through the jitter
+    QVERIFY(bbr.goodput > 0.7);
+    QVERIFY(bbr.goodput > vegas.goodput);
+    QVERIFY(bbr.goodput <= 1.0);
+}
+
+void CongestionControlTests::testBufferbloat() {
+    // 1000 packets per second with a 40ms RTT behind a two second buffer
+    LinkConditions link { 1000, 20000, 0, 0.0, 2000 };
+
+    auto vegas = simulate<TCPVegasCC>(link);
+    auto bbr = simulate<BBRCC>(link);
+    report("Bufferbloat", vegas, bbr);
+
+    // BBR keeps the link full without filling the buffer
+    QVERIFY(bbr.goodput > 0.9);
+    QVERIFY(bbr.goodput > vegas.goodput);
+    QVERIFY(bbr.rttInflation < 2.0);
+}
+
+void CongestionControlTests::testFactoryNames() {
+    QVERIFY(createCongestionControlFactory("vegas") != nullptr);
+    QVERIFY(createCongestionControlFactory("BBR") != nullptr);
+    QVERIFY(createCongestionControlFactory("reno") == nullptr);
+}
@@ -0,0 +1,26 @@
+//
+//  CongestionControlTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CongestionControlTests_h
+#define hifi_CongestionControlTests_h
+
+#include <QtTest/QtTest>
+
+// Runs the congestion controls over a simulated link - a bottleneck with a finite buffer, propagation delay,
+// jitter and random loss - driven the way Connection and SendQueue drive them, in simulated time
+class CongestionControlTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testJitteryLink();
+    void testBufferbloat();
+    void testFactoryNames();
+};
+
+#endif // hifi_CongestionControlTests_h
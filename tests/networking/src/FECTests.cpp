@@ -0,0 +1,261 @@
+//
+//  FECTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FECTests.h"
+
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+
+#include <HifiSockAddr.h>
+#include <udt/Constants.h>
+#include <udt/ControlPacket.h>
+#include <udt/ForwardErrorCorrection.h>
+
+QTEST_MAIN(FECTests)
+
+using namespace udt;
+
+static SequenceNumber seq(int value) {
+    return SequenceNumber((uint32_t)value);
+}
+
+// a datagram that starts with its sequence number, like the packets do, so we can tell which one was recovered
+static QByteArray makeDatagram(std::mt19937& generator, SequenceNumber sequenceNumber, int size) {
+    QByteArray datagram(size, 0);
+    memcpy(datagram.data(), &sequenceNumber, sizeof(SequenceNumber));
+    for (int i = sizeof(SequenceNumber); i < size; ++i) {
+        datagram[i] = (char)generator();
+    }
+    return datagram;
+}
+
+// what the other end gets out of the parity packet we send
+static std::unique_ptr<ControlPacket> receive(const ControlPacket& packet) {
+    auto data = std::unique_ptr<char[]>(new char[packet.getDataSize()]);
+    memcpy(data.get(), packet.getData(), packet.getDataSize());
+    return ControlPacket::fromReceivedPacket(std::move(data), packet.getDataSize(), HifiSockAddr());
+}
+
+void FECTests::testRecoversSingleLoss() {
+    std::mt19937 generator(1);
+    FECEncoder encoder;
+    FECDecoder decoder;
+    encoder.setGroupSize(4);
+
+    const int sizes[] = { 120, 400, 37, 250 };
+    std::vector<QByteArray> sent;
+    std::unique_ptr<ControlPacket> parity;
+    FECDecoder::Datagrams recovered;
+
+    for (int i = 0; i < 4; ++i) {
+        sent.push_back(makeDatagram(generator, seq(100 + i), sizes[i]));
+        QVERIFY(!parity);
+        parity = encoder.addDatagram(seq(100 + i), sent.back().data(), sent.back().size());
+
+        // the largest one is lost
+        if (i != 1) {
+            QVERIFY(decoder.addDatagram(seq(100 + i), sent.back().data(), sent.back().size(), recovered));
+        }
+    }
+    QVERIFY(parity);
+    QVERIFY(recovered.empty());
+
+    decoder.addParity(*receive(*parity), recovered);
+    QCOMPARE((int)recovered.size(), 1);
+    QCOMPARE(recovered[0], sent[1]);
+
+    // nothing lost in the next group, nothing to recover
+    recovered.clear();
+    for (int i = 4; i < 8; ++i) {
+        auto datagram = makeDatagram(generator, seq(100 + i), 60);
+        parity = encoder.addDatagram(seq(100 + i), datagram.data(), datagram.size());
+        QVERIFY(decoder.addDatagram(seq(100 + i), datagram.data(), datagram.size(), recovered));
+    }
+    QVERIFY(parity);
+    decoder.addParity(*receive(*parity), recovered);
+    QVERIFY(recovered.empty());
+}
+
+void FECTests::testDropsLateDuplicates() {
+    std::mt19937 generator(2);
+    FECEncoder encoder;
+    FECDecoder decoder;
+    encoder.setGroupSize(3);
+
+    std::vector<QByteArray> sent;
+    std::unique_ptr<ControlPacket> parity;
+    FECDecoder::Datagrams recovered;
+
+    for (int i = 0; i < 3; ++i) {
+        sent.push_back(makeDatagram(generator, seq(i), 80 + i));
+        parity = encoder.addDatagram(seq(i), sent.back().data(), sent.back().size());
+    }
+
+    QVERIFY(decoder.addDatagram(seq(0), sent[0].data(), sent[0].size(), recovered));
+    QVERIFY(decoder.addDatagram(seq(2), sent[2].data(), sent[2].size(), recovered));
+    decoder.addParity(*receive(*parity), recovered);
+    QCOMPARE((int)recovered.size(), 1);
+    QCOMPARE(recovered[0], sent[1]);
+
+    // it was only late, it was already handed on when it was recovered
+    QVERIFY(!decoder.addDatagram(seq(1), sent[1].data(), sent[1].size(), recovered));
+
+    // duplicates of ones we received go through as they did without parity
+    QVERIFY(decoder.addDatagram(seq(0), sent[0].data(), sent[0].size(), recovered));
+    QCOMPARE((int)recovered.size(), 1);
+}
+
+void FECTests::testParityBeforeLateDatagram() {
+    std::mt19937 generator(3);
+    FECEncoder encoder;
+    FECDecoder decoder;
+    encoder.setGroupSize(5);
+
+    // the sequence numbers wrap in the middle of the group
+    const int first = SequenceNumber::MAX - 2;
+    std::vector<QByteArray> sent;
+    std::unique_ptr<ControlPacket> parity;
+    FECDecoder::Datagrams recovered;
+
+    for (int i = 0; i < 5; ++i) {
+        sent.push_back(makeDatagram(generator, seq(first) + i, 50 + 30 * i));
+        parity = encoder.addDatagram(seq(first) + i, sent.back().data(), sent.back().size());
+    }
+
+    // 1 is late and 3 is lost, the parity alone can't do anything yet
+    for (int i : { 0, 2, 4 }) {
+        QVERIFY(decoder.addDatagram(seq(first) + i, sent[i].data(), sent[i].size(), recovered));
+    }
+    decoder.addParity(*receive(*parity), recovered);
+    QVERIFY(recovered.empty());
+
+    QVERIFY(decoder.addDatagram(seq(first) + 1, sent[1].data(), sent[1].size(), recovered));
+    QCOMPARE((int)recovered.size(), 1);
+    QCOMPARE(recovered[0], sent[3]);
+}
+
+void FECTests::testUnprotectedDatagram() {
+    std::mt19937 generator(4);
+    FECEncoder encoder;
+    FECDecoder decoder;
+    encoder.setGroupSize(4);
+
+    auto small0 = makeDatagram(generator, seq(0), 100);
+    auto small1 = makeDatagram(generator, seq(1), 100);
+    auto large = makeDatagram(generator, seq(2), FECEncoder::maxProtectedDatagramSize() + 1);
+
+    QVERIFY(!encoder.addDatagram(seq(0), small0.data(), small0.size()));
+    QVERIFY(!encoder.addDatagram(seq(1), small1.data(), small1.size()));
+
+    // too large to be protected, it closes the group short
+    auto parity = encoder.addDatagram(seq(2), large.data(), large.size());
+    QVERIFY(parity);
+
+    FECDecoder::Datagrams recovered;
+    QVERIFY(decoder.addDatagram(seq(1), small1.data(), small1.size(), recovered));
+    decoder.addParity(*receive(*parity), recovered);
+    QCOMPARE((int)recovered.size(), 1);
+    QCOMPARE(recovered[0], small0);
+
+    // turning it off leaves the datagrams alone
+    encoder.setGroupSize(0);
+    for (int i = 3; i < 20; ++i) {
+        QVERIFY(!encoder.addDatagram(seq(i), small0.data(), small0.size()));
+    }
+}
+
+// sends audio sized frames, with their parity, through a lossy link and
+// returns the share of the lost frames that the parity rebuilt
+static float recoveredFrameRate(int groupSize, std::function<bool()> isLost) {
+    static const int NUM_FRAMES = 20000;
+
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<int> sizeDistribution(100, 500);
+    FECEncoder encoder;
+    FECDecoder decoder;
+    encoder.setGroupSize(groupSize);
+
+    std::map<int, QByteArray> lostFrames;
+    int numRecovered = 0;
+    FECDecoder::Datagrams recovered;
+
+    auto deliver = [&] {
+        for (auto& datagram : recovered) {
+            SequenceNumber sequenceNumber(datagram.data());
+            auto it = lostFrames.find((int)(uint32_t)sequenceNumber);
+            QVERIFY(it != lostFrames.end());
+            QCOMPARE(datagram, it->second);
+            lostFrames.erase(it);
+            ++numRecovered;
+        }
+        recovered.clear();
+    };
+
+    int numLost = 0;
+    for (int i = 0; i < NUM_FRAMES; ++i) {
+        auto datagram = makeDatagram(generator, seq(i), sizeDistribution(generator));
+        auto parity = encoder.addDatagram(seq(i), datagram.data(), datagram.size());
+
+        if (isLost()) {
+            lostFrames[i] = datagram;
+            ++numLost;
+        } else {
+            decoder.addDatagram(seq(i), datagram.data(), datagram.size(), recovered);
+            deliver();
+        }
+
+        if (parity && !isLost()) {
+            decoder.addParity(*receive(*parity), recovered);
+            deliver();
+        }
+    }
+
+    return numLost > 0 ? (float)numRecovered / numLost : 1.0f;
+}
+
+void FECTests::testRecoveredFrameRate() {
+    static const int GROUP_SIZE = 8;
+    std::mt19937 generator(6);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    // independent 5% loss, a lost frame is rebuilt when none of the other 8 packets of its group were lost: 0.95^8
+    auto randomRate = recoveredFrameRate(GROUP_SIZE, [&] {
+        return uniform(generator) < 0.05;
+    });
+
+    // about the same average loss in bursts (Gilbert-Elliott), which often take out several frames of a group at once,
+    // a single XOR parity only gets back around a fifth of those
+    bool isInBurst = false;
+    auto burstyRate = recoveredFrameRate(GROUP_SIZE, [&] {
+        isInBurst = isInBurst ? uniform(generator) > 0.25 : uniform(generator) < 0.02;
+        return uniform(generator) < (isInBurst ? 0.6 : 0.005);
+    });
+
+    std::cout << "Recovered frames with parity every " << GROUP_SIZE << ": random loss "
+        << randomRate * 100.0f << "%, bursty loss " << burstyRate * 100.0f << "%" << std::endl;
+
+    QVERIFY(randomRate > 0.6f);
+    QVERIFY(burstyRate > 0.15f);
+}
+
+void FECTests::testUnknownControlType() {
+    static const ControlPacket::ControlBitAndType UNKNOWN_TYPE = 200;
+
+    // a control packet of a type some later build added, it is read as it is rather than asserted on
+    auto packet = ControlPacket::create(ControlPacket::FECRequest, sizeof(uint8_t));
+    *reinterpret_cast<ControlPacket::ControlBitAndType*>(packet->getData()) =
+        CONTROL_BIT_MASK | (UNKNOWN_TYPE << (8 * sizeof(ControlPacket::Type)));
+
+    auto received = receive(*packet);
+    QCOMPARE((int)received->getType(), (int)UNKNOWN_TYPE);
+}
@@ -0,0 +1,27 @@
+//
+//  FECTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FECTests_h
+#define hifi_FECTests_h
+
+#include <QtTest/QtTest>
+
+class FECTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testRecoversSingleLoss();
+    void testDropsLateDuplicates();
+    void testParityBeforeLateDatagram();
+    void testUnprotectedDatagram();
+    void testRecoveredFrameRate();
+    void testUnknownControlType();
+};
+
+#endif // hifi_FECTests_h
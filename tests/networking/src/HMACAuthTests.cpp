@@ -0,0 +1,214 @@
+//
+//  HMACAuthTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "HMACAuthTests.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <QtCore/QUuid>
+
+#include <HMACAuth.h>
+
+QTEST_MAIN(HMACAuthTests)
+
+static const int HASH_SIZE = 16;
+
+static QByteArray referenceKey() {
+    QByteArray key;
+    for (int i = 0; i < HASH_SIZE; ++i) {
+        key.append((char)i);
+    }
+    return key;
+}
+
+static QByteArray randomBytes(std::mt19937& generator, int size) {
+    QByteArray bytes(size, 0);
+    for (int i = 0; i < size; ++i) {
+        bytes[i] = (char)generator();
+    }
+    return bytes;
+}
+
+void HMACAuthTests::testSipHashVectors() {
+    // SipHash-2-4-128 with the key 00 01 .. 0f, over the messages 00 01 .. (length - 1)
+    struct Vector {
+        int length;
+        const char* hash;
+    };
+    const Vector vectors[] = {
+        { 0, "a3817f04ba25a8e66df67214c7550293" },
+        { 15, "5493e99933b0a8117e08ec0f97cfc3d9" },
+        { 63, "5150d1772f50834a503e069a973fbd7c" }
+    };
+
+    HMACAuth hmacAuth(HMACAuth::SIPHASH);
+    auto key = referenceKey();
+    QVERIFY(hmacAuth.setKey(key.constData(), key.size()));
+
+    for (const auto& vector : vectors) {
+        QByteArray message;
+        for (int i = 0; i < vector.length; ++i) {
+            message.append((char)i);
+        }
+
+        HMACAuth::HMACHash hash;
+        QVERIFY(hmacAuth.calculateHash(hash, message.constData(), message.size()));
+        QCOMPARE(QByteArray((const char*)hash.data(), (int)hash.size()).toHex(), QByteArray(vector.hash));
+    }
+}
+
+void HMACAuthTests::testAddData() {
+    std::mt19937 generator(1);
+    auto data = randomBytes(generator, 300);
+
+    HMACAuth hmacAuth(HMACAuth::SIPHASH);
+    QVERIFY(hmacAuth.setKey(QUuid::createUuid()));
+
+    HMACAuth::HMACHash hash;
+    QVERIFY(hmacAuth.calculateHash(hash, data.constData(), data.size()));
+
+    // in pieces that don't line up with the 8 byte words
+    QVERIFY(hmacAuth.addData(data.constData(), 13));
+    QVERIFY(hmacAuth.addData(data.constData() + 13, 200));
+    QVERIFY(hmacAuth.addData(data.constData() + 213, 87));
+    QVERIFY(hmacAuth.result() == hash);
+
+    // and nothing carried over to the next one
+    QVERIFY(hmacAuth.addData(data.constData(), data.size()));
+    QVERIFY(hmacAuth.result() == hash);
+}
+
+void HMACAuthTests::testVerifyHash() {
+    std::mt19937 generator(2);
+    auto secret = QUuid::createUuid();
+
+    for (auto authMethod : { HMACAuth::MD5, HMACAuth::SIPHASH }) {
+        HMACAuth sender(authMethod);
+        HMACAuth receiver(authMethod);
+        QVERIFY(sender.setKey(secret));
+        QVERIFY(receiver.setKey(secret));
+
+        for (int size : { 0, 1, 8, 100, 1400 }) {
+            auto data = randomBytes(generator, size);
+
+            HMACAuth::HMACHash hash;
+            QVERIFY(sender.calculateHash(hash, data.constData(), data.size()));
+            QCOMPARE((int)hash.size(), HASH_SIZE);
+            QVERIFY(receiver.verifyHash(data.constData(), data.size(), (const char*)hash.data(), HASH_SIZE));
+
+            // a flipped bit in the hash, or in the data, doesn't get through
+            auto forgedHash = hash;
+            forgedHash[size % HASH_SIZE] ^= 0x10;
+            QVERIFY(!receiver.verifyHash(data.constData(), data.size(), (const char*)forgedHash.data(), HASH_SIZE));
+
+            if (size > 0) {
+                auto forgedData = data;
+                forgedData[size / 2] = forgedData[size / 2] ^ 0x01;
+                QVERIFY(!receiver.verifyHash(forgedData.constData(), size, (const char*)hash.data(), HASH_SIZE));
+            }
+
+            // nor does one from another secret
+            HMACAuth other(authMethod);
+            QVERIFY(other.setKey(QUuid::createUuid()));
+            QVERIFY(!other.verifyHash(data.constData(), data.size(), (const char*)hash.data(), HASH_SIZE));
+        }
+    }
+}
+
+void HMACAuthTests::testSwitchAuthMethod() {
+    std::mt19937 generator(3);
+    auto secret = QUuid::createUuid();
+    auto data = randomBytes(generator, 200);
+
+    HMACAuth md5(HMACAuth::MD5);
+    HMACAuth sipHash(HMACAuth::SIPHASH);
+    QVERIFY(md5.setKey(secret));
+    QVERIFY(sipHash.setKey(secret));
+
+    HMACAuth::HMACHash md5Hash, sipHashHash;
+    QVERIFY(md5.calculateHash(md5Hash, data.constData(), data.size()));
+    QVERIFY(sipHash.calculateHash(sipHashHash, data.constData(), data.size()));
+    QVERIFY(md5Hash != sipHashHash);
+
+    // what a node does when the domain-server hands out secrets for another method
+    HMACAuth hmacAuth(HMACAuth::MD5);
+    QVERIFY(hmacAuth.setKey(secret));
+    hmacAuth.setAuthMethod(HMACAuth::SIPHASH);
+    QCOMPARE(hmacAuth.getAuthMethod(), HMACAuth::MD5);
+    QVERIFY(hmacAuth.verifyHash(data.constData(), data.size(), (const char*)md5Hash.data(), HASH_SIZE));
+    QVERIFY(hmacAuth.setKey(secret));
+    QCOMPARE(hmacAuth.getAuthMethod(), HMACAuth::SIPHASH);
+    QVERIFY(hmacAuth.verifyHash(data.constData(), data.size(), (const char*)sipHashHash.data(), HASH_SIZE));
+
+    hmacAuth.setAuthMethod(HMACAuth::MD5);
+    QVERIFY(hmacAuth.setKey(secret));
+    QVERIFY(hmacAuth.verifyHash(data.constData(), data.size(), (const char*)md5Hash.data(), HASH_SIZE));
+}
+
+#ifdef MANUAL_TEST
+void HMACAuthTests::benchmark() {
+    using namespace std::chrono;
+    static const int NUM_PACKETS = 1024;
+    static const int NUM_ROUNDS = 200;
+
+    std::mt19937 generator(4);
+    auto secret = QUuid::createUuid();
+
+    // mixed audio is a couple of hundred bytes, avatar data fills the MTU
+    for (int size : { 250, 1400 }) {
+        std::vector<QByteArray> packets;
+        for (int i = 0; i < NUM_PACKETS; ++i) {
+            packets.push_back(randomBytes(generator, size));
+        }
+
+        for (auto authMethod : { HMACAuth::MD5, HMACAuth::SIPHASH }) {
+            HMACAuth hmacAuth(authMethod);
+            hmacAuth.setKey(secret);
+
+            std::vector<HMACAuth::HMACHash> hashes(NUM_PACKETS);
+            for (int i = 0; i < NUM_PACKETS; ++i) {
+                hmacAuth.calculateHash(hashes[i], packets[i].constData(), size);
+            }
+
+            // what the receive loop did before, a hash to compare to, in a new buffer for each packet
+            int verified = 0;
+            auto start = high_resolution_clock::now();
+            for (int round = 0; round < NUM_ROUNDS; ++round) {
+                for (int i = 0; i < NUM_PACKETS; ++i) {
+                    HMACAuth::HMACHash hash;
+                    hmacAuth.calculateHash(hash, packets[i].constData(), size);
+                    verified += QByteArray((const char*)hash.data(), (int)hash.size()) ==
+                        QByteArray((const char*)hashes[i].data(), (int)hashes[i].size());
+                }
+            }
+            auto calculateTime = duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
+            QCOMPARE(verified, NUM_PACKETS * NUM_ROUNDS);
+
+            verified = 0;
+            start = high_resolution_clock::now();
+            for (int round = 0; round < NUM_ROUNDS; ++round) {
+                for (int i = 0; i < NUM_PACKETS; ++i) {
+                    verified += hmacAuth.verifyHash(packets[i].constData(), size,
+                                                    (const char*)hashes[i].data(), HASH_SIZE);
+                }
+            }
+            auto verifyTime = duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
+            QCOMPARE(verified, NUM_PACKETS * NUM_ROUNDS);
+
+            std::cout << (authMethod == HMACAuth::MD5 ? "HMAC-MD5 " : "SipHash  ") << size << " bytes: "
+                << (int)(NUM_PACKETS * NUM_ROUNDS / calculateTime) << " hashed and compared/s, "
+                << (int)(NUM_PACKETS * NUM_ROUNDS / verifyTime) << " verified/s" << std::endl;
+        }
+    }
+}
+#endif // MANUAL_TEST
@@ -0,0 +1,324 @@
+//
+//  LossListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LossListTests.h"
+
+#include <ctime>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <udt/ControlPacket.h>
+#include <udt/LossList.h>
+
+QTEST_MAIN(LossListTests)
+
+using namespace udt;
+
+static SequenceNumber seq(int64_t value) {
+    // wraps like sequence numbers on the wire do
+    return SequenceNumber((uint32_t)(value & SequenceNumber::MAX));
+}
+
+void LossListTests::testRanges() {
+    LossList lossList;
+    QVERIFY(lossList.isEmpty());
+
+    lossList.append(seq(10));
+    lossList.append(seq(12), seq(20));
+    lossList.append(seq(21));
+    QCOMPARE(lossList.getLength(), 11);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(10));
+
+    // a range before the first loss, overlapping one
+    lossList.insert(seq(5), seq(11));
+    QCOMPARE(lossList.getLength(), 17);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(5));
+
+    QVERIFY(lossList.remove(seq(15)));
+    QVERIFY(!lossList.remove(seq(15)));
+    QVERIFY(!lossList.remove(seq(30)));
+    QVERIFY(!lossList.remove(seq(2)));
+    QCOMPARE(lossList.getLength(), 16);
+
+    // ACKs remove everything up to them
+    lossList.remove(seq(0), seq(13));
+    QCOMPARE(lossList.getLength(), 7);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(14));
+
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(14));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(16));
+    QCOMPARE(lossList.getLength(), 5);
+
+    lossList.remove(seq(17), seq(100));
+    QVERIFY(lossList.isEmpty());
+
+    // it starts over anywhere once empty
+    lossList.append(seq(5000), seq(5003));
+    QCOMPARE(lossList.getLength(), 4);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(5000));
+
+    lossList.clear();
+    QVERIFY(lossList.isEmpty());
+}
+
+void LossListTests::testWrapAround() {
+    LossList lossList;
+
+    lossList.append(seq(SequenceNumber::MAX - 2), seq(SequenceNumber::MAX + 3));
+    QCOMPARE(lossList.getLength(), 6);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(SequenceNumber::MAX - 2));
+
+    lossList.append(seq(SequenceNumber::MAX + 10));
+    QCOMPARE(lossList.getLength(), 7);
+
+    QVERIFY(lossList.remove(seq(SequenceNumber::MAX + 1)));
+    lossList.remove(seq(SequenceNumber::MAX - 10), seq(SequenceNumber::MAX));
+    QCOMPARE(lossList.getLength(), 3);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(SequenceNumber::MAX + 2));
+
+    // back before the wrap
+    lossList.insert(seq(SequenceNumber::MAX - 1), seq(SequenceNumber::MAX - 1));
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(SequenceNumber::MAX - 1));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(SequenceNumber::MAX - 1));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(SequenceNumber::MAX + 2));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(SequenceNumber::MAX + 3));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(SequenceNumber::MAX + 10));
+    QVERIFY(lossList.isEmpty());
+}
+
+void LossListTests::testMatchesReference() {
+    // random ranges over a window that grows the ring and crosses the wrap, checked against a set
+    const int64_t BASE = SequenceNumber::MAX - 30000;
+    const int WINDOW = 60000;
+
+    LossList lossList;
+    std::set<int64_t> reference;
+    std::mt19937 generator(7);
+    int64_t windowStart = BASE;
+
+    for (int i = 0; i < 20000; ++i) {
+        int64_t start = windowStart + generator() % WINDOW;
+        int64_t end = start + generator() % 200;
+
+        switch (generator() % 5) {
+            case 0:
+            case 1:
+                lossList.insert(seq(start), seq(end));
+                for (auto value = start; value <= end; ++value) {
+                    reference.insert(value);
+                }
+                break;
+            case 2: {
+                bool wasLost = reference.erase(start) > 0;
+                QCOMPARE(lossList.remove(seq(start)), wasLost);
+                break;
+            }
+            case 3:
+                lossList.remove(seq(start), seq(end));
+                reference.erase(reference.lower_bound(start), reference.upper_bound(end));
+                break;
+            case 4:
+                if (!reference.empty()) {
+                    QCOMPARE(lossList.popFirstSequenceNumber(), seq(*reference.begin()));
+                    reference.erase(reference.begin());
+                }
+                break;
+        }
+
+        QCOMPARE(lossList.getLength(), (int)reference.size());
+        if (!reference.empty()) {
+            QCOMPARE(lossList.getFirstSequenceNumber(), seq(*reference.begin()));
+        }
+
+        // slide the window forward like ACKs would, the list never spans more than it
+        if (i % 100 == 99) {
+            windowStart += 500;
+            lossList.remove(seq(windowStart - WINDOW), seq(windowStart - 1));
+            reference.erase(reference.begin(), reference.lower_bound(windowStart));
+        }
+    }
+
+    while (!reference.empty()) {
+        QCOMPARE(lossList.popFirstSequenceNumber(), seq(*reference.begin()));
+        reference.erase(reference.begin());
+    }
+    QVERIFY(lossList.isEmpty());
+}
+
+void LossListTests::testWrite() {
+    LossList lossList;
+    lossList.append(seq(SequenceNumber::MAX - 1), seq(SequenceNumber::MAX + 1));
+    lossList.append(seq(SequenceNumber::MAX + 70), seq(SequenceNumber::MAX + 200));
+    lossList.append(seq(SequenceNumber::MAX + 300));
+
+    auto packet = ControlPacket::create(ControlPacket::ACK, 6 * sizeof(SequenceNumber));
+    lossList.write(*packet);
+    packet->reset();
+
+    std::vector<SequenceNumber> written(6);
+    for (auto& sequenceNumber : written) {
+        packet->readPrimitive(&sequenceNumber);
+    }
+    QCOMPARE(written[0], seq(SequenceNumber::MAX - 1));
+    QCOMPARE(written[1], seq(SequenceNumber::MAX + 1));
+    QCOMPARE(written[2], seq(SequenceNumber::MAX + 70));
+    QCOMPARE(written[3], seq(SequenceNumber::MAX + 200));
+    QCOMPARE(written[4], seq(SequenceNumber::MAX + 300));
+    QCOMPARE(written[5], seq(SequenceNumber::MAX + 300));
+
+    // only as many ranges as asked for
+    auto shortPacket = ControlPacket::create(ControlPacket::ACK, 6 * sizeof(SequenceNumber));
+    lossList.write(*shortPacket, 1);
+    QCOMPARE(shortPacket->getPayloadSize(), (qint64)(2 * sizeof(SequenceNumber)));
+}
+
+#ifdef MANUAL_TEST
+void LossListTests::benchmark() {
+    // A 100 MB reliable transfer over a link that loses 5% of the packets in bursts. A loss is noticed a window
+    // later and re-sent, as with fast re-transmits, and when a re-send is lost too the sender times out and
+    // re-sends everything that isn't ACKed, as SendQueue does. The bookkeeping is recorded first, from a
+    // simulation against sets, then replayed against the loss lists of both ends so only LossList is timed.
+    const int64_t TRANSFER_SIZE = 100 * 1000 * 1000;
+    const int PAYLOAD_SIZE = 1200;
+    const int64_t NUM_PACKETS = TRANSFER_SIZE / PAYLOAD_SIZE;
+    const int WINDOW = 8192;
+
+    // bursts start on 0.5% of the packets and last 10 packets on average
+    const double BURST_START_PROBABILITY = 0.005;
+    const double BURST_END_PROBABILITY = 0.1;
+
+    enum class Operation { ReceiverAppend, ReceiverRemove, ReceiverACK, SenderInsert, SenderACK, SenderPop };
+    struct Step {
+        Operation operation;
+        int64_t start;
+        int64_t end;
+    };
+    std::vector<Step> steps;
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    bool isInBurst = false;
+
+    struct Detection {
+        int64_t slot;
+        int64_t sequenceNumber;
+        bool isTimeout;
+    };
+    std::deque<Detection> detections; // when the sender notices a loss, in order
+    std::set<int64_t> senderMissing;
+    std::set<int64_t> receiverMissing;
+    std::set<int64_t> resent;
+    int64_t nextSequenceNumber = 0;
+    int64_t lastReceived = -1;
+    int64_t lastACK = -1;
+    int64_t sentPackets = 0;
+    int64_t lostPackets = 0;
+
+    for (int64_t slot = 0; nextSequenceNumber < NUM_PACKETS || !detections.empty() || !senderMissing.empty(); ++slot) {
+        while (!detections.empty() && detections.front().slot <= slot) {
+            auto detection = detections.front();
+            detections.pop_front();
+            if (detection.sequenceNumber <= lastACK) {
+                continue;
+            }
+
+            auto start = detection.isTimeout ? lastACK + 1 : detection.sequenceNumber;
+            auto end = detection.isTimeout ? nextSequenceNumber - 1 : detection.sequenceNumber;
+            steps.push_back({ Operation::SenderInsert, start, end });
+            for (auto lost = start; lost <= end; ++lost) {
+                senderMissing.insert(lost);
+            }
+        }
+
+        // re-sends go first
+        int64_t sequenceNumber;
+        if (!senderMissing.empty()) {
+            steps.push_back({ Operation::SenderPop, 0, 0 });
+            sequenceNumber = *senderMissing.begin();
+            senderMissing.erase(senderMissing.begin());
+            resent.insert(sequenceNumber);
+        } else if (nextSequenceNumber < NUM_PACKETS) {
+            sequenceNumber = nextSequenceNumber++;
+        } else {
+            slot = detections.front().slot - 1;
+            continue;
+        }
+        ++sentPackets;
+
+        isInBurst = isInBurst ? uniform(generator) >= BURST_END_PROBABILITY : uniform(generator) < BURST_START_PROBABILITY;
+        if (isInBurst) {
+            ++lostPackets;
+            detections.push_back({ slot + WINDOW, sequenceNumber, resent.count(sequenceNumber) > 0 });
+            continue;
+        }
+
+        // as in Connection::processReceivedSequenceNumber
+        if (sequenceNumber > lastReceived + 1) {
+            steps.push_back({ Operation::ReceiverAppend, lastReceived + 1, sequenceNumber - 1 });
+            for (auto lost = lastReceived + 1; lost < sequenceNumber; ++lost) {
+                receiverMissing.insert(lost);
+            }
+        }
+        if (sequenceNumber > lastReceived) {
+            lastReceived = sequenceNumber;
+        } else {
+            steps.push_back({ Operation::ReceiverRemove, sequenceNumber, 0 });
+            receiverMissing.erase(sequenceNumber);
+        }
+
+        lastACK = receiverMissing.empty() ? lastReceived : *receiverMissing.begin() - 1;
+        steps.push_back({ Operation::ReceiverACK, 0, 0 });
+        steps.push_back({ Operation::SenderACK, lastACK, 0 });
+        senderMissing.erase(senderMissing.begin(), senderMissing.upper_bound(lastACK));
+    }
+
+    LossList receiverLossList;
+    LossList senderLossList;
+    int64_t checksum = 0;
+
+    auto start = std::clock();
+    for (const auto& step : steps) {
+        switch (step.operation) {
+            case Operation::ReceiverAppend:
+                receiverLossList.append(seq(step.start), seq(step.end));
+                break;
+            case Operation::ReceiverRemove:
+                checksum += receiverLossList.remove(seq(step.start));
+                break;
+            case Operation::ReceiverACK:
+                checksum += receiverLossList.isEmpty() ? 0 : (uint32_t)receiverLossList.getFirstSequenceNumber();
+                break;
+            case Operation::SenderInsert:
+                senderLossList.insert(seq(step.start), seq(step.end));
+                break;
+            case Operation::SenderACK:
+                // as in SendQueue::ack
+                if (!senderLossList.isEmpty() && senderLossList.getFirstSequenceNumber() <= seq(step.start)) {
+                    senderLossList.remove(senderLossList.getFirstSequenceNumber(), seq(step.start));
+                }
+                break;
+            case Operation::SenderPop:
+                checksum += (uint32_t)senderLossList.popFirstSequenceNumber();
+                break;
+        }
+    }
+    auto cpuSeconds = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+
+    QVERIFY(receiverLossList.isEmpty());
+    QVERIFY(senderLossList.isEmpty());
+
+    std::cout << sentPackets << " packets sent, " << (100.0 * lostPackets / sentPackets) << "% lost, "
+              << steps.size() << " loss list operations in " << cpuSeconds * 1000.0 << " ms of CPU time"
+              << " (checksum " << checksum << ")" << std::endl;
+}
+#endif // MANUAL_TEST
@@ -0,0 +1,30 @@
+//
+//  LossListTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LossListTests_h
+#define hifi_LossListTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class LossListTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testRanges();
+    void testWrapAround();
+    void testMatchesReference();
+    void testWrite();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_LossListTests_h
@@ -0,0 +1,392 @@
+//
+//  MessagesFanOutTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MessagesFanOutTests.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+
+#include <DependencyManager.h>
+#include <LimitedNodeList.h>
+#include <MessagesClient.h>
+#include <MessagesSubscribers.h>
+#include <Node.h>
+#include <ReceivedMessage.h>
+#include <StatTracker.h>
+
+QTEST_MAIN(MessagesFanOutTests)
+
+static SharedNodePointer makeAgent() {
+    return SharedNodePointer(new Node(QUuid::createUuid(), NodeType::Agent, HifiSockAddr(), HifiSockAddr()));
+}
+
+// agents subscribed to channels the way scripts tend to be: a few channels that most of them listen to,
+// and a long tail that only a handful do, kept both in the index and in what the messages mixer had before
+class SyntheticDomain {
+public:
+    SyntheticDomain(std::mt19937& generator, int numAgents, int numChannels) :
+        _generator(generator),
+        _numChannels(numChannels)
+    {
+        for (int i = 0; i < numAgents; ++i) {
+            join();
+        }
+    }
+
+    QString pickChannel() {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        return QString("com.highfidelity.synthetic.%1").arg((int)(_numChannels * std::pow(uniform(_generator), 3.0)));
+    }
+
+    SharedNodePointer pickAgent() {
+        return agents[std::uniform_int_distribution<size_t>(0, agents.size() - 1)(_generator)];
+    }
+
+    void join() {
+        static const int CHANNELS_PER_AGENT = 3;
+
+        auto agent = makeAgent();
+        agents.push_back(agent);
+        for (int i = 0; i < CHANNELS_PER_AGENT; ++i) {
+            subscribe(agent, pickChannel());
+        }
+    }
+
+    void leave() {
+        auto index = std::uniform_int_distribution<size_t>(0, agents.size() - 1)(_generator);
+        auto agent = agents[index];
+        agents.erase(agents.begin() + index);
+
+        for (auto& channel : channelSubscribers) {
+            channel.remove(agent->getUUID());
+        }
+        subscribers.removeNode(agent->getUUID());
+    }
+
+    void subscribe(const SharedNodePointer& agent, const QString& channel) {
+        channelSubscribers[channel] << agent->getUUID();
+        subscribers.subscribe(channel, agent);
+    }
+
+    void unsubscribe(const SharedNodePointer& agent, const QString& channel) {
+        if (channelSubscribers.contains(channel)) {
+            channelSubscribers[channel].remove(agent->getUUID());
+        }
+        subscribers.unsubscribe(channel, agent->getUUID());
+    }
+
+    std::vector<SharedNodePointer> agents;
+    QHash<QString, QSet<QUuid>> channelSubscribers;
+    MessagesSubscribers subscribers;
+
+private:
+    std::mt19937& _generator;
+    int _numChannels;
+};
+
+void MessagesFanOutTests::testSubscriptions() {
+    MessagesSubscribers subscribers;
+    auto first = makeAgent();
+    auto second = makeAgent();
+
+    QVERIFY(subscribers.subscribe("chat", first));
+    QVERIFY(!subscribers.subscribe("chat", first));
+    QVERIFY(subscribers.subscribe("chat", second));
+    QVERIFY(subscribers.subscribe("games", first));
+    QCOMPARE(subscribers.getNumChannels(), 2);
+    QCOMPARE(subscribers.getNumSubscriptions(), 3);
+    QCOMPARE((int)subscribers.getSubscribers("chat").size(), 2);
+    QVERIFY(subscribers.getSubscribers("nobody").empty());
+
+    QVERIFY(subscribers.unsubscribe("chat", first->getUUID()));
+    QVERIFY(!subscribers.unsubscribe("chat", first->getUUID()));
+    QVERIFY(!subscribers.unsubscribe("nobody", first->getUUID()));
+    QCOMPARE((int)subscribers.getSubscribers("chat").size(), 1);
+    QCOMPARE(subscribers.getSubscribers("chat")[0], second);
+
+    // a node that goes away leaves all of its channels, and channels nobody is left in go too
+    subscribers.removeNode(first->getUUID());
+    QVERIFY(subscribers.getSubscribers("games").empty());
+    QCOMPARE(subscribers.getNumChannels(), 1);
+    QCOMPARE(subscribers.getNumSubscriptions(), 1);
+
+    // and it can come back
+    QVERIFY(subscribers.subscribe("games", first));
+    QCOMPARE(subscribers.getNumSubscriptions(), 2);
+
+    // a channel that moved to another messages mixer goes with all of its subscribers
+    QVERIFY(subscribers.subscribe("chat", first));
+    subscribers.removeChannel("chat");
+    QCOMPARE(subscribers.getNumChannels(), 1);
+    QCOMPARE(subscribers.getNumSubscriptions(), 1);
+    QCOMPARE((int)subscribers.getChannels().size(), 1);
+    QVERIFY(subscribers.subscribe("chat", second));
+    subscribers.removeNode(first->getUUID());
+    QCOMPARE(subscribers.getNumSubscriptions(), 1);
+}
+
+void MessagesFanOutTests::testCoalescedPayloads() {
+    auto senderID = QUuid::createUuid();
+    QString text = QString::fromUtf8("h\xC3\xA9llo");
+    QByteArray data("\x01\x02\x00\x03", 4);
+
+    auto textPayload = MessagesClient::encodeMessagesPayload("chat", true, text.toUtf8(), senderID);
+    auto dataPayload = MessagesClient::encodeMessagesPayload("data", false, data, senderID);
+
+    // what the clients send is what the mixer forwards
+    auto packetList = MessagesClient::encodeMessagesPacket("chat", text, senderID);
+    packetList->closeCurrentPacket();
+    QCOMPARE(packetList->getMessage(), textPayload);
+
+    // a subscriber gets both in one packet list
+    QByteArray coalesced = textPayload + dataPayload;
+    auto receivedMessage = QSharedPointer<ReceivedMessage>::create(coalesced, PacketType::MessagesData,
+                                                                   versionForPacketType(PacketType::MessagesData),
+                                                                   HifiSockAddr());
+    QString channel, message;
+    QByteArray receivedData;
+    QUuid receivedSenderID;
+    bool isText { false };
+
+    MessagesClient::decodeMessagesPacket(receivedMessage, channel, isText, message, receivedData, receivedSenderID);
+    QCOMPARE(channel, QString("chat"));
+    QVERIFY(isText);
+    QCOMPARE(message, text);
+    QCOMPARE(receivedSenderID, senderID);
+
+    MessagesClient::decodeMessagesPacket(receivedMessage, channel, isText, message, receivedData, receivedSenderID);
+    QCOMPARE(channel, QString("data"));
+    QVERIFY(!isText);
+    QCOMPARE(receivedData, data);
+    QCOMPARE(receivedSenderID, senderID);
+    QCOMPARE(receivedMessage->getBytesLeftToRead(), (qint64)0);
+}
+
+void MessagesFanOutTests::testSyntheticAgents() {
+    static const int NUM_AGENTS = 500;
+    static const int NUM_CHANNELS = 200;
+    static const int NUM_MESSAGES = 5000;
+    static const int MESSAGES_PER_CHURN = 20;
+
+    std::mt19937 generator(1);
+    SyntheticDomain domain(generator, NUM_AGENTS, NUM_CHANNELS);
+
+    int numScanned = 0;
+    int numIndexed = 0;
+    int numRecipients = 0;
+
+    for (int i = 0; i < NUM_MESSAGES; ++i) {
+        auto channel = domain.pickChannel();
+
+        // every node, checked against the channel's set of IDs, as the messages mixer used to
+        std::set<QUuid> scannedRecipients;
+        for (const auto& agent : domain.agents) {
+            ++numScanned;
+            if (domain.channelSubscribers[channel].contains(agent->getUUID())) {
+                scannedRecipients.insert(agent->getUUID());
+            }
+        }
+
+        std::set<QUuid> indexedRecipients;
+        for (const auto& node : domain.subscribers.getSubscribers(channel)) {
+            ++numIndexed;
+            QVERIFY(indexedRecipients.insert(node->getUUID()).second);
+        }
+
+        QVERIFY(indexedRecipients == scannedRecipients);
+        numRecipients += (int)indexedRecipients.size();
+
+        // agents come and go, and scripts change what they listen to, while the messages flow
+        if (i % MESSAGES_PER_CHURN == 0) {
+            domain.leave();
+            domain.join();
+            domain.unsubscribe(domain.pickAgent(), domain.pickChannel());
+            domain.subscribe(domain.pickAgent(), domain.pickChannel());
+        }
+    }
+
+    std::cout << NUM_AGENTS << " synthetic agents: " << (float)numScanned / NUM_MESSAGES << " nodes visited per message "
+        << "scanning, " << (float)numIndexed / NUM_MESSAGES << " from the index, for "
+        << (float)numRecipients / NUM_MESSAGES << " recipients" << std::endl;
+
+    // the index visits exactly the recipients
+    QCOMPARE(numIndexed, numRecipients);
+    QCOMPARE(numScanned, NUM_AGENTS * NUM_MESSAGES);
+}
+
+void MessagesFanOutTests::testChannelOwners() {
+    static const int NUM_CHANNELS = 20000;
+    static const int NUM_MIXERS = 4;
+
+    std::mt19937 generator(3);
+    std::vector<QUuid> messagesMixerIDs;
+    for (int i = 0; i < NUM_MIXERS; ++i) {
+        messagesMixerIDs.push_back(QUuid::createUuid());
+    }
+    QVERIFY(MessagesClient::channelOwner("chat", {}).isNull());
+    QCOMPARE(MessagesClient::channelOwner("chat", { messagesMixerIDs[0] }), messagesMixerIDs[0]);
+
+    std::vector<QString> channels;
+    std::vector<QUuid> owners;
+    std::map<QUuid, int> numOwned;
+    for (int i = 0; i < NUM_CHANNELS; ++i) {
+        channels.push_back(QString("com.highfidelity.synthetic.%1").arg(i));
+        owners.push_back(MessagesClient::channelOwner(channels.back(), messagesMixerIDs));
+        ++numOwned[owners.back()];
+    }
+
+    // each mixer gets about its share
+    QCOMPARE((int)numOwned.size(), NUM_MIXERS);
+    for (const auto& owned : numOwned) {
+        QVERIFY(std::abs(owned.second - NUM_CHANNELS / NUM_MIXERS) < NUM_CHANNELS / NUM_MIXERS / 10);
+    }
+
+    // whatever order the mixers were learned about in
+    auto shuffledIDs = messagesMixerIDs;
+    std::shuffle(shuffledIDs.begin(), shuffledIDs.end(), generator);
+    for (int i = 0; i < NUM_CHANNELS; i += 97) {
+        QCOMPARE(MessagesClient::channelOwner(channels[i], shuffledIDs), owners[i]);
+    }
+
+    // another mixer only takes channels, about its share of them, the others keep the rest
+    auto newMixerID = QUuid::createUuid();
+    auto moreIDs = messagesMixerIDs;
+    moreIDs.push_back(newMixerID);
+    int numMoved = 0;
+    for (int i = 0; i < NUM_CHANNELS; ++i) {
+        auto owner = MessagesClient::channelOwner(channels[i], moreIDs);
+        if (owner != owners[i]) {
+            QCOMPARE(owner, newMixerID);
+            ++numMoved;
+        }
+    }
+    QVERIFY(std::abs(numMoved - NUM_CHANNELS / (NUM_MIXERS + 1)) < NUM_CHANNELS / (NUM_MIXERS + 1) / 10);
+
+    // and when one goes away, only its channels move
+    auto goneMixerID = messagesMixerIDs[1];
+    auto fewerIDs = messagesMixerIDs;
+    fewerIDs.erase(fewerIDs.begin() + 1);
+    for (int i = 0; i < NUM_CHANNELS; ++i) {
+        auto owner = MessagesClient::channelOwner(channels[i], fewerIDs);
+        QVERIFY(owners[i] == goneMixerID ? owner != goneMixerID : owner == owners[i]);
+    }
+}
+
+void MessagesFanOutTests::testMessagesMixersInNodeList() {
+    static const int NUM_MIXERS = 2;
+    static const int NUM_CHANNELS = 100;
+
+    DependencyManager::set<StatTracker>();
+    auto nodeList = DependencyManager::set<LimitedNodeList>();
+
+    auto countNodesOfType = [&](NodeType_t nodeType) {
+        int numNodes = 0;
+        nodeList->eachNode([&](const SharedNodePointer& node) {
+            numNodes += node->getType() == nodeType;
+        });
+        return numNodes;
+    };
+
+    // each messages mixer is its own node, adding another doesn't replace the one that was there
+    std::vector<QUuid> messagesMixerIDs;
+    for (int i = 0; i < NUM_MIXERS; ++i) {
+        HifiSockAddr sockAddr(QHostAddress::LocalHost, 40100 + i);
+        messagesMixerIDs.push_back(QUuid::createUuid());
+        nodeList->addOrUpdateNode(messagesMixerIDs.back(), NodeType::MessagesMixer, sockAddr, sockAddr, (Node::LocalID)(i + 1));
+    }
+    QCOMPARE(countNodesOfType(NodeType::MessagesMixer), NUM_MIXERS);
+    for (const auto& messagesMixerID : messagesMixerIDs) {
+        QVERIFY(nodeList->nodeWithUUID(messagesMixerID));
+    }
+
+    // while another audio mixer, still a solo node type, does replace the one that was there
+    for (int i = 0; i < NUM_MIXERS; ++i) {
+        HifiSockAddr sockAddr(QHostAddress::LocalHost, 40200 + i);
+        nodeList->addOrUpdateNode(QUuid::createUuid(), NodeType::AudioMixer, sockAddr, sockAddr, (Node::LocalID)(NUM_MIXERS + i + 1));
+    }
+    QCOMPARE(countNodesOfType(NodeType::AudioMixer), 1);
+    QCOMPARE(countNodesOfType(NodeType::MessagesMixer), NUM_MIXERS);
+
+    // and both mixers in the node list own some of the channels
+    std::set<QUuid> owners;
+    for (int i = 0; i < NUM_CHANNELS; ++i) {
+        owners.insert(MessagesClient::channelOwner(QString("com.highfidelity.synthetic.%1").arg(i), messagesMixerIDs));
+    }
+    QCOMPARE((int)owners.size(), NUM_MIXERS);
+
+    DependencyManager::destroy<LimitedNodeList>();
+    DependencyManager::destroy<StatTracker>();
+}
+
+#ifdef MANUAL_TEST
+void MessagesFanOutTests::benchmark() {
+    using namespace std::chrono;
+    static const int NUM_CHANNELS = 200;
+    static const int NUM_MESSAGES = 2000;
+
+    // a chat sized message
+    QString text(120, 'x');
+
+    for (int numAgents : { 100, 1000, 4000 }) {
+        std::mt19937 generator(2);
+        SyntheticDomain domain(generator, numAgents, NUM_CHANNELS);
+
+        std::vector<QString> channels;
+        for (int i = 0; i < NUM_MESSAGES; ++i) {
+            channels.push_back(domain.pickChannel());
+        }
+        auto senderID = domain.pickAgent()->getUUID();
+
+        // scan every node, and encode the message again for each recipient
+        int numPacketLists = 0;
+        auto start = high_resolution_clock::now();
+        for (const auto& channel : channels) {
+            for (const auto& agent : domain.agents) {
+                if (domain.channelSubscribers[channel].contains(agent->getUUID())) {
+                    auto packetList = MessagesClient::encodeMessagesPacket(channel, text, senderID);
+                    packetList->closeCurrentPacket();
+                    numPacketLists += (int)packetList->getNumPackets();
+                }
+            }
+        }
+        auto scanTime = duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
+
+        // go through the channel's subscribers, with the message encoded once
+        int numIndexedPacketLists = 0;
+        start = high_resolution_clock::now();
+        for (const auto& channel : channels) {
+            const auto& subscribers = domain.subscribers.getSubscribers(channel);
+            if (subscribers.empty()) {
+                continue;
+            }
+
+            auto payload = MessagesClient::encodeMessagesPayload(channel, true, text.toUtf8(), senderID);
+            for (size_t i = 0; i < subscribers.size(); ++i) {
+                auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+                packetList->write(payload);
+                packetList->closeCurrentPacket();
+                numIndexedPacketLists += (int)packetList->getNumPackets();
+            }
+        }
+        auto indexTime = duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
+        QCOMPARE(numIndexedPacketLists, numPacketLists);
+
+        std::cout << numAgents << " agents, " << (float)numPacketLists / NUM_MESSAGES << " recipients per message: "
+            << (int)(NUM_MESSAGES / scanTime) << " messages/s scanning, "
+            << (int)(NUM_MESSAGES / indexTime) << " messages/s indexed" << std::endl;
+    }
+}
+#endif // MANUAL_TEST
@@ -0,0 +1,104 @@
+//
+//  TimerWheelTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TimerWheelTests.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <udt/TimerWheel.h>
+
+QTEST_MAIN(TimerWheelTests)
+
+using namespace udt;
+using Clock = TimerWheel<int>::Clock;
+using std::chrono::microseconds;
+using std::chrono::seconds;
+
+static const microseconds TICK { (int64_t)TimerWheel<int>::DEFAULT_TICK_USECS };
+
+void TimerWheelTests::testFiresInOrderAndNeverEarly() {
+    auto start = Clock::now();
+    TimerWheel<int> wheel(start);
+
+    std::vector<Clock::time_point> dueTimes;
+    std::mt19937 generator(42);
+    for (int i = 0; i < 1000; ++i) {
+        dueTimes.push_back(start + microseconds(generator() % 100000));
+        wheel.schedule(i, dueTimes.back());
+    }
+    QCOMPARE(wheel.size(), (size_t)1000);
+
+    std::vector<int> expired;
+    std::vector<bool> fired(dueTimes.size(), false);
+    auto lastDue = start;
+    for (auto now = start; !wheel.isEmpty(); now += microseconds(250)) {
+        wheel.advance(now, expired);
+        for (int timer : expired) {
+            QVERIFY(!fired[timer]);
+            fired[timer] = true;
+
+            // at or after the due time, and no later than the tick that covers it
+            QVERIFY(dueTimes[timer] <= now);
+            QVERIFY(now - dueTimes[timer] < microseconds(250) + TICK);
+
+            // ticks expire in order, timers within the same tick may come in any order
+            QVERIFY(dueTimes[timer] + TICK > lastDue);
+            lastDue = std::max(lastDue, dueTimes[timer]);
+        }
+        expired.clear();
+    }
+    QVERIFY(std::all_of(fired.begin(), fired.end(), [](bool value) { return value; }));
+}
+
+void TimerWheelTests::testCascadesAcrossLevels() {
+    auto start = Clock::now();
+    TimerWheel<int> wheel(start);
+
+    // one timer for each level, and one past the range of the wheel
+    std::vector<Clock::time_point> dueTimes {
+        start + microseconds(5000), start + seconds(1), start + seconds(30), start + seconds(300)
+    };
+    for (int i = 0; i < (int)dueTimes.size(); ++i) {
+        wheel.schedule(i, dueTimes[i]);
+    }
+
+    std::vector<int> expired;
+    for (int i = 0; i < (int)dueTimes.size(); ++i) {
+        wheel.advance(dueTimes[i] - TICK, expired);
+        QVERIFY(expired.empty());
+        wheel.advance(dueTimes[i] + TICK, expired);
+        QCOMPARE(expired, std::vector<int> { i });
+        expired.clear();
+    }
+    QVERIFY(wheel.isEmpty());
+
+    // timers that are already due fire on the next tick
+    wheel.schedule(7, start);
+    wheel.advance(dueTimes.back() + 2 * TICK, expired);
+    QCOMPARE(expired, std::vector<int> { 7 });
+}
+
+void TimerWheelTests::testNextDeadline() {
+    auto start = Clock::now();
+    TimerWheel<int> wheel(start);
+    QCOMPARE(wheel.nextDeadline(), Clock::time_point::max());
+
+    wheel.schedule(0, start + microseconds(1050));
+    QCOMPARE(wheel.nextDeadline(), start + 11 * TICK);
+
+    // far timers need the wheel to wake up for cascades, never later than they are due
+    TimerWheel<int> farWheel(start);
+    farWheel.schedule(0, start + seconds(2));
+    auto deadline = farWheel.nextDeadline();
+    QVERIFY(deadline > start);
+    QVERIFY(deadline <= start + seconds(2));
+}
@@ -0,0 +1,24 @@
+//
+//  TimerWheelTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TimerWheelTests_h
+#define hifi_TimerWheelTests_h
+
+#include <QtTest/QtTest>
+
+class TimerWheelTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testFiresInOrderAndNeverEarly();
+    void testCascadesAcrossLevels();
+    void testNextDeadline();
+};
+
+#endif // hifi_TimerWheelTests_h
@@ -27,15 +27,25 @@
 #include <Windows.h>
 #endif
 
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#include <iostream>
+
 #include <recording/Clip.h>
 #include <recording/Frame.h>
+#include <recording/impl/FileClip.h>
 
 #include <SharedUtil.h>
 
 #include "Constants.h"
 
+//#define MANUAL_TEST
+
 using namespace recording;
 FrameType TEST_FRAME_TYPE { Frame::TYPE_INVALID };
+FrameType SECOND_TEST_FRAME_TYPE { Frame::TYPE_INVALID };
 
 void testFrameTypeRegistration() {
     TEST_FRAME_TYPE = Frame::registerFrameType(TEST_NAME);
@@ -119,10 +129,166 @@ void testClipOrdering() {
     Q_UNUSED(lastFrameTimeOffset); // FIXME - Unix build not yet upgraded to Qt 5.5.1 we can remove this once it is
 }
 
+// Two interleaved tracks at different rates, like avatar and audio frames in a real recording
+Clip::Pointer createTrackedClip(Frame::Time durationMsecs) {
+    auto clip = Clip::newClip();
+    for (Frame::Time time = 0; time < durationMsecs; time += 10) {
+        if (time % 30 == 0) {
+            clip->addFrame(std::make_shared<Frame>(TEST_FRAME_TYPE, (float)time, QByteArray(64, (char)(time / 30))));
+        }
+        clip->addFrame(std::make_shared<Frame>(SECOND_TEST_FRAME_TYPE, (float)time, QByteArray::number(time)));
+    }
+    return clip;
+}
+
+// Writes the clip with its index stripped, the way clips were written before the index existed
+void writeUnindexedClip(const QString& indexedFileName, const QString& fileName) {
+    QFile indexedFile(indexedFileName);
+    QFile file(fileName);
+    if (indexedFile.open(QIODevice::ReadOnly) && file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        // Cutting into the locator frame leaves a partial trailing frame, which the reader drops
+        auto data = indexedFile.readAll();
+        data.chop(1);
+        file.write(data);
+    }
+}
+
+void verifySameFrames(const Clip::Pointer& a, const Clip::Pointer& b, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        QVERIFY(a->positionFrameTime() == b->positionFrameTime());
+        auto frameA = a->nextFrame();
+        auto frameB = b->nextFrame();
+        QVERIFY((bool)frameA == (bool)frameB);
+        if (!frameA) {
+            return;
+        }
+        QVERIFY(frameA->type == frameB->type);
+        QVERIFY(frameA->timeOffset == frameB->timeOffset);
+        QVERIFY(frameA->data == frameB->data);
+    }
+}
+
+void testIndexedClip() {
+    SECOND_TEST_FRAME_TYPE = Frame::registerFrameType(SECOND_TEST_NAME);
+
+    QTemporaryFile indexedFile;
+    QTemporaryFile unindexedFile;
+    QVERIFY(indexedFile.open() && unindexedFile.open());
+    indexedFile.close();
+    unindexedFile.close();
+
+    auto writeClip = createTrackedClip(60 * 1000);
+    Clip::toFile(indexedFile.fileName(), writeClip);
+    writeUnindexedClip(indexedFile.fileName(), unindexedFile.fileName());
+
+    auto indexedClip = std::make_shared<FileClip>(indexedFile.fileName());
+    auto unindexedClip = std::make_shared<FileClip>(unindexedFile.fileName());
+    QVERIFY(indexedClip->isIndexed());
+    QVERIFY(!unindexedClip->isIndexed());
+    QVERIFY(indexedClip->frameCount() == writeClip->frameCount());
+    QVERIFY(unindexedClip->frameCount() == writeClip->frameCount());
+    QVERIFY(indexedClip->duration() == writeClip->duration());
+    QVERIFY(unindexedClip->duration() == writeClip->duration());
+
+    // Full playback
+    writeClip->seek(0);
+    indexedClip->seek(0);
+    unindexedClip->seek(0);
+    verifySameFrames(indexedClip, writeClip, writeClip->frameCount() + 1);
+    indexedClip->seek(0);
+    verifySameFrames(indexedClip, unindexedClip, writeClip->frameCount() + 1);
+
+    // Seeks onto frames, between frames, and past the end
+    for (Frame::Time time : { 0u, 15u, 30u, 12345u, 59990u, 59995u, 120000u }) {
+        indexedClip->seekFrameTime(time);
+        unindexedClip->seekFrameTime(time);
+        verifySameFrames(indexedClip, unindexedClip, 10);
+    }
+
+    // Skipping keeps the tracks in step
+    indexedClip->seekFrameTime(300);
+    unindexedClip->seekFrameTime(300);
+    indexedClip->skipFrame();
+    unindexedClip->skipFrame();
+    QVERIFY(indexedClip->peekFrame()->timeOffset == unindexedClip->peekFrame()->timeOffset);
+    QVERIFY(indexedClip->peekFrame()->type == unindexedClip->peekFrame()->type);
+
+    // Rewriting an indexed clip doesn't carry its old index frames into the new one
+    auto duplicate = indexedClip->duplicate();
+    QVERIFY(duplicate->frameCount() == writeClip->frameCount());
+    unindexedClip.reset();
+    Clip::toFile(unindexedFile.fileName(), indexedClip);
+    auto rewrittenClip = std::make_shared<FileClip>(unindexedFile.fileName());
+    QVERIFY(rewrittenClip->isIndexed());
+    QVERIFY(rewrittenClip->frameCount() == writeClip->frameCount());
+}
+
+#ifdef MANUAL_TEST
+
+static long getPeakRSSKilobytes() {
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+static void benchmarkClips(const QString& name, const QString& fileName) {
+    static const int CLIP_COUNT = 100;
+    static const int SEEK_COUNT = 1000;
+
+    auto startRSS = getPeakRSSKilobytes();
+    auto start = usecTimestampNow();
+    std::vector<FileClip::Pointer> clips;
+    for (int i = 0; i < CLIP_COUNT; ++i) {
+        clips.push_back(std::make_shared<FileClip>(fileName));
+    }
+    auto openUsecs = (usecTimestampNow() - start) / CLIP_COUNT;
+
+    auto durationMsecs = Frame::secondsToFrameTime(clips[0]->duration());
+    start = usecTimestampNow();
+    for (int i = 0; i < SEEK_COUNT; ++i) {
+        auto& clip = clips[i % CLIP_COUNT];
+        clip->seekFrameTime((Frame::Time)(((uint64_t)i * 7919 * 1000) % durationMsecs));
+        clip->nextFrame();
+    }
+    auto seekUsecs = (double)(usecTimestampNow() - start) / SEEK_COUNT;
+
+    std::cout << name.toStdString() << ": " << clips[0]->frameCount() << " frames, open " << openUsecs
+        << " usecs, seek " << seekUsecs << " usecs, peak RSS growth per clip "
+        << (getPeakRSSKilobytes() - startRSS) / CLIP_COUNT << " KB" << std::endl;
+}
+
+// An hour long recording played by many decks at once, as in a bot fleet
+void benchmarkClipSeek() {
+    QTemporaryFile indexedFile;
+    QTemporaryFile unindexedFile;
+    if (!indexedFile.open() || !unindexedFile.open()) {
+        return;
+    }
+    indexedFile.close();
+    unindexedFile.close();
+
+    Clip::toFile(indexedFile.fileName(), createTrackedClip(60 * 60 * 1000));
+    writeUnindexedClip(indexedFile.fileName(), unindexedFile.fileName());
+
+    // Indexed first, since peak RSS only grows
+    benchmarkClips("indexed", indexedFile.fileName());
+    benchmarkClips("unindexed", unindexedFile.fileName());
+}
+
+#endif // MANUAL_TEST
+
 int main(int, const char**) {
     setupHifiApplication("Recording Test");
 
     testFrameTypeRegistration();
     testFilePersist();
     testClipOrdering();
+    testIndexedClip();
+#ifdef MANUAL_TEST
+    benchmarkClipSeek();
+#endif // MANUAL_TEST
 }
@@ -0,0 +1,177 @@
+//
+//  CullSortTests.cpp
+//  tests/render/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CullSortTests.h"
+
+#include <iostream>
+
+#include <render/CullTask.h>
+#include <render/ShapePipeline.h>
+#include <render/SortTask.h>
+#include <SharedUtil.h>
+
+#include "RenderTestUtils.h"
+
+QTEST_MAIN(CullSortTests)
+
+static bool cullFunctor(const RenderArgs* args, const AABox& bound) {
+    // the solid angle test LODManager does, with a fixed lod angle
+    const float LOD_ANGLE_HALF_TAN_SQUARED = 0.005f * 0.005f;
+    float distanceSquared = args->getViewFrustum().distanceToCameraSquared(bound.calcCenter());
+    float halfSize = 0.5f * bound.getLargestDimension();
+    return distanceSquared < (halfSize * halfSize) / LOD_ANGLE_HALF_TAN_SQUARED;
+}
+
+class CullSortContext {
+public:
+    CullSortContext(const render::ScenePointer& scene) {
+        _args.setViewFrustum(buildFrustum());
+        _renderContext = std::make_shared<render::RenderContext>();
+        _renderContext->args = &_args;
+        _renderContext->_scene = scene;
+    }
+
+    void fetch(render::ItemSpatialTree::ItemSelection& selection) {
+        render::FetchSpatialTree fetchJob;
+        fetchJob.configure(render::FetchSpatialTree::Config());
+        _renderContext->jobConfig = std::make_shared<render::FetchSpatialTree::Config>();
+        fetchJob.run(_renderContext, render::FetchSpatialTree::Inputs(_filter, glm::ivec2(1920, 1080)), selection);
+    }
+
+    void cull(const render::ItemSpatialTree::ItemSelection& selection, bool parallel, render::ItemBounds& outItems) {
+        render::CullSpatialSelection cullJob(cullFunctor, render::RenderDetails::ITEM);
+        render::CullSpatialSelection::Config config;
+        config.parallel = parallel;
+        cullJob.configure(config);
+        _renderContext->jobConfig = std::make_shared<render::CullSpatialSelection::Config>();
+        cullJob.run(_renderContext, render::CullSpatialSelection::Inputs(selection, _filter), outItems);
+    }
+
+    void sort(const render::ItemBounds& items, render::ShapeBounds& outShapes) {
+        render::ShapeBounds shapes;
+        render::PipelineSortShapes().run(_renderContext, items, shapes);
+        render::DepthSortShapes(true).run(_renderContext, shapes, outShapes);
+    }
+
+    RenderArgs _args;
+    render::RenderContextPointer _renderContext;
+    render::ItemFilter _filter { render::ItemFilter::Builder::opaqueShape().build() };
+};
+
+static render::ItemIDs toItemIDs(const render::ItemBounds& items) {
+    render::ItemIDs ids;
+    ids.reserve(items.size());
+    for (auto& item : items) {
+        ids.push_back(item.id);
+    }
+    return ids;
+}
+
+void CullSortTests::testParallelCullMatchesSerial() {
+    const uint32_t NUM_ITEMS = 20000;
+    auto scene = buildScene(NUM_ITEMS);
+    CullSortContext context(scene);
+
+    render::ItemSpatialTree::ItemSelection selection;
+    context.fetch(selection);
+    QVERIFY(selection.numItems() > 0);
+
+    render::ItemBounds serialItems;
+    context.cull(selection, false, serialItems);
+    auto serialDetails = context._args._details._item;
+
+    context._args._details._item = render::RenderDetails::Item();
+    render::ItemBounds parallelItems;
+    context.cull(selection, true, parallelItems);
+    auto parallelDetails = context._args._details._item;
+
+    QVERIFY(serialItems.size() > 0);
+    QVERIFY(serialItems.size() < NUM_ITEMS);
+    QVERIFY(toItemIDs(serialItems) == toItemIDs(parallelItems));
+    QCOMPARE(parallelDetails._considered, serialDetails._considered);
+    QCOMPARE(parallelDetails._outOfView, serialDetails._outOfView);
+    QCOMPARE(parallelDetails._tooSmall, serialDetails._tooSmall);
+    QCOMPARE(parallelDetails._rendered, serialDetails._rendered);
+}
+
+void CullSortTests::testSortIsDeterministic() {
+    const uint32_t NUM_ITEMS = 20000;
+    auto scene = buildScene(NUM_ITEMS);
+    CullSortContext context(scene);
+
+    render::ItemSpatialTree::ItemSelection selection;
+    context.fetch(selection);
+    render::ItemBounds items;
+    context.cull(selection, true, items);
+
+    render::ShapeBounds firstShapes;
+    context.sort(items, firstShapes);
+    render::ShapeBounds secondShapes;
+    context.sort(items, secondShapes);
+
+    const auto& frustum = context._args.getViewFrustum();
+    size_t numSorted = 0;
+    QCOMPARE(firstShapes.size(), secondShapes.size());
+    for (auto& bucket : firstShapes) {
+        auto& otherBucket = secondShapes[bucket.first];
+        QVERIFY(toItemIDs(bucket.second) == toItemIDs(otherBucket));
+
+        float previousDistance = 0.0f;
+        for (auto& item : bucket.second) {
+            float distance = frustum.distanceToCameraSquared(item.bound.calcCenter());
+            QVERIFY(distance >= previousDistance);
+            previousDistance = distance;
+        }
+        numSorted += bucket.second.size();
+    }
+    QCOMPARE(numSorted, items.size());
+}
+
+#ifdef MANUAL_TEST
+
+void CullSortTests::benchmark() {
+    const uint32_t numItems[] = { 10000, 50000, 100000 };
+    const int NUM_FRAMES = 20;
+    for (auto n : numItems) {
+        auto scene = buildScene(n);
+        CullSortContext context(scene);
+
+        for (bool parallel : { false, true }) {
+            uint64_t fetchTime = 0;
+            uint64_t cullTime = 0;
+            uint64_t sortTime = 0;
+            size_t numCulled = 0;
+            for (int i = 0; i < NUM_FRAMES; ++i) {
+                render::ItemSpatialTree::ItemSelection selection;
+                uint64_t startTime = usecTimestampNow();
+                context.fetch(selection);
+                uint64_t fetchedTime = usecTimestampNow();
+
+                render::ItemBounds items;
+                context.cull(selection, parallel, items);
+                uint64_t culledTime = usecTimestampNow();
+
+                render::ShapeBounds shapes;
+                context.sort(items, shapes);
+                uint64_t sortedTime = usecTimestampNow();
+
+                fetchTime += fetchedTime - startTime;
+                cullTime += culledTime - fetchedTime;
+                sortTime += sortedTime - culledTime;
+                numCulled = items.size();
+            }
+            std::cout << n << " items, " << numCulled << " visible, " << (parallel ? "parallel" : "serial")
+                << " cull: fetch = " << (fetchTime / NUM_FRAMES) << " usec, cull = " << (cullTime / NUM_FRAMES)
+                << " usec, sort = " << (sortTime / NUM_FRAMES) << " usec" << std::endl;
+        }
+    }
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,29 @@
+//
+//  CullSortTests.h
+//  tests/render/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_CullSortTests_h
+#define hifi_render_CullSortTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class CullSortTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testParallelCullMatchesSerial();
+    void testSortIsDeterministic();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_render_CullSortTests_h
@@ -0,0 +1,109 @@
+//
+//  RenderTestUtils.h
+//  tests/render/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_RenderTestUtils_h
+#define hifi_render_RenderTestUtils_h
+
+#include <cstdlib>
+#include <memory>
+
+#include <render/Scene.h>
+#include <render/SpatialTree.h>
+#include <ViewFrustum.h>
+
+// The synthetic scene of the cull and sort tests and benchmark: random items spread over a 2km wide world around
+// the origin. The spatial tree and scene tests fill their trees and scenes the same way.
+
+const float WORLD_WIDTH = 2000.0f;
+const float MIN_ITEM_SIZE = 0.1f;
+const float MAX_ITEM_SIZE = 20.0f;
+
+inline float randomFloat() {
+    return (float)rand() / (float)RAND_MAX;
+}
+
+// Mostly small items, a few large ones
+inline AABox randomBound() {
+    glm::vec3 corner = WORLD_WIDTH * (glm::vec3(randomFloat(), randomFloat(), randomFloat()) - 0.5f);
+    float size = MIN_ITEM_SIZE + (MAX_ITEM_SIZE - MIN_ITEM_SIZE) * randomFloat() * randomFloat();
+    return AABox(corner, size);
+}
+
+// A render item with nothing but a bound and a shape key, enough to drive the scene, cull and sort without a gpu
+class SyntheticShape {
+public:
+    using Payload = render::Payload<SyntheticShape>;
+    using Pointer = Payload::DataPointer;
+
+    SyntheticShape(const AABox& bound, const render::ShapeKey& shapeKey = render::ShapeKey()) :
+        _bound(bound), _shapeKey(shapeKey) {}
+
+    AABox _bound;
+    render::ShapeKey _shapeKey;
+};
+
+namespace render {
+    template <> inline const ItemKey payloadGetKey(const SyntheticShape::Pointer& shape) {
+        return ItemKey::Builder::opaqueShape().withWorldSpace().build();
+    }
+    template <> inline const Item::Bound payloadGetBound(const SyntheticShape::Pointer& shape) {
+        return shape->_bound;
+    }
+    template <> inline const ShapeKey shapeGetShapeKey(const SyntheticShape::Pointer& shape) {
+        return shape->_shapeKey;
+    }
+}
+
+inline render::PayloadPointer makePayload(const AABox& bound, const render::ShapeKey& shapeKey = render::ShapeKey()) {
+    return std::make_shared<SyntheticShape::Payload>(std::make_shared<SyntheticShape>(bound, shapeKey));
+}
+
+// A scene of numItems random shapes, the same ones for the same count, with the transaction already processed
+inline render::ScenePointer buildScene(uint32_t numItems) {
+    srand(0);
+    auto scene = std::make_shared<render::Scene>(glm::vec3(-16384.0f), 32768.0f);
+
+    const render::ShapeKey shapeKeys[] = {
+        render::ShapeKey::Builder().build(),
+        render::ShapeKey::Builder().withMaterial().build(),
+        render::ShapeKey::Builder().withMaterial().withTangents().build(),
+        render::ShapeKey::Builder().withMaterial().withDeformed().build()
+    };
+
+    render::Transaction transaction;
+    for (uint32_t i = 0; i < numItems; ++i) {
+        transaction.resetItem(scene->allocateID(), makePayload(randomBound(), shapeKeys[i % 4]));
+    }
+    scene->enqueueTransaction(transaction);
+    scene->enqueueFrame();
+    scene->processTransactionQueue();
+    return scene;
+}
+
+// The same random bounds straight in a spatial tree, without a scene
+inline void buildTree(render::ItemSpatialTree& tree, uint32_t numItems) {
+    srand(0);
+    for (uint32_t i = 0; i < numItems; ++i) {
+        auto key = render::ItemKey::Builder::opaqueShape().build();
+        tree.resetItem(render::Octree::INVALID_CELL, key, randomBound(), i, key);
+    }
+}
+
+// A perspective frustum in the middle of the world, reaching its edges
+inline ViewFrustum buildFrustum(const glm::quat& orientation = glm::quat(), const glm::vec3& position = glm::vec3(0.0f)) {
+    ViewFrustum frustum;
+    frustum.setProjection(60.0f, 16.0f / 9.0f, 0.1f, WORLD_WIDTH);
+    frustum.setPosition(position);
+    frustum.setOrientation(orientation);
+    frustum.calculate();
+    return frustum;
+}
+
+#endif // hifi_render_RenderTestUtils_h
@@ -0,0 +1,142 @@
+//
+//  SceneTests.cpp
+//  tests/render/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SceneTests.h"
+
+#include <iostream>
+
+#include <SharedUtil.h>
+
+#include "RenderTestUtils.h"
+
+QTEST_MAIN(SceneTests)
+
+static render::ItemIDs resetItems(render::Scene& scene, uint32_t numItems) {
+    render::ItemIDs ids;
+    render::Transaction transaction;
+    for (uint32_t i = 0; i < numItems; ++i) {
+        ids.push_back(scene.allocateID());
+        transaction.resetItem(ids.back(), makePayload(randomBound()));
+    }
+    scene.enqueueTransaction(transaction);
+    scene.enqueueFrame();
+    return ids;
+}
+
+void SceneTests::testCoalesce() {
+    render::Transaction transaction;
+    auto bound = randomBound();
+
+    // the second reset of item 1 replaces the first one
+    transaction.resetItem(1, makePayload(bound));
+    transaction.resetItem(2, makePayload(bound));
+    transaction.resetItem(1, makePayload(bound));
+
+    // the null update of 1 is followed by another update, the one of 2 by a remove
+    transaction.updateItem(1);
+    transaction.updateItem<SyntheticShape>(1, [](SyntheticShape& item) {});
+    transaction.updateItem(2);
+    transaction.updateItem(3);
+    transaction.removeItem(2);
+
+    QCOMPARE(transaction.coalesce(), (size_t)3);
+    QCOMPARE(transaction.coalesce(), (size_t)0);
+}
+
+void SceneTests::testBulkInsertMatchesResetItem() {
+    const uint32_t NUM_ITEMS = 10000;
+    srand(0);
+    render::ItemBounds items;
+    for (uint32_t i = 0; i < NUM_ITEMS; ++i) {
+        items.emplace_back(i + 1, randomBound());
+    }
+
+    render::ItemSpatialTree tree(glm::vec3(-16384.0f), 32768.0f);
+    std::vector<render::ItemKey> keys(NUM_ITEMS, render::ItemKey::Builder::opaqueShape().build());
+    render::Octree::Indices cells;
+    tree.insertItems(items, keys, cells);
+
+    render::ItemSpatialTree reference(glm::vec3(-16384.0f), 32768.0f);
+    for (uint32_t i = 0; i < NUM_ITEMS; ++i) {
+        auto key = render::ItemKey::Builder::opaqueShape().build();
+        auto cell = reference.resetItem(render::Octree::INVALID_CELL, key, items[i].bound, items[i].id, key);
+        QVERIFY(cell != render::Octree::INVALID_CELL);
+        QVERIFY(tree.getCellLocation(cells[i]) == reference.getCellLocation(cell));
+        QCOMPARE(keys[i].isSmall(), key.isSmall());
+    }
+}
+
+void SceneTests::testTimeBudget() {
+    const uint32_t NUM_ITEMS = 20000;
+    srand(0);
+    render::Scene scene(glm::vec3(-16384.0f), 32768.0f);
+    scene.setTransactionTimeBudget(1);
+
+    auto ids = resetItems(scene, NUM_ITEMS);
+    scene.processTransactionQueue();
+    auto stats = scene.getTransactionStats();
+    QCOMPARE(stats.numQueuedTransactions, (uint32_t)1);
+    QVERIFY(stats.numPendingResets > 0);
+    QCOMPARE(stats.numResets + stats.numPendingResets, NUM_ITEMS);
+
+    // Any other command on a pending item applies its reset first
+    auto lastItem = ids.back();
+    QVERIFY(!scene.getItem(lastItem).exist());
+    bool updated = false;
+    render::Transaction transaction;
+    transaction.updateItem<SyntheticShape>(lastItem, [&](SyntheticShape& item) { updated = true; });
+    scene.enqueueTransaction(transaction);
+    scene.enqueueFrame();
+    scene.processTransactionQueue();
+    QVERIFY(updated);
+    QVERIFY(scene.getItem(lastItem).exist());
+
+    // The rest trickles in
+    int numCalls = 0;
+    while (scene.getTransactionStats().numPendingResets > 0 && numCalls < (int)NUM_ITEMS) {
+        scene.processTransactionQueue();
+        ++numCalls;
+    }
+    QCOMPARE(scene.getTransactionStats().numPendingResets, (uint32_t)0);
+    for (auto id : ids) {
+        QVERIFY(scene.getItem(id).exist());
+        QVERIFY(scene.getItem(id).getCell() != render::Octree::INVALID_CELL);
+    }
+}
+
+#ifdef MANUAL_TEST
+
+void SceneTests::benchmark() {
+    const uint32_t numItems[] = { 10000, 50000 };
+    for (auto n : numItems) {
+        for (uint64_t budget : { (uint64_t)0, (uint64_t)(4 * USECS_PER_MSEC) }) {
+            srand(0);
+            render::Scene scene(glm::vec3(-16384.0f), 32768.0f);
+            scene.setTransactionTimeBudget(budget);
+            resetItems(scene, n);
+
+            uint64_t maxFrameTime = 0;
+            uint64_t totalTime = 0;
+            int numFrames = 0;
+            do {
+                scene.processTransactionQueue();
+                auto stats = scene.getTransactionStats();
+                maxFrameTime = std::max(maxFrameTime, stats.processingTime);
+                totalTime += stats.processingTime;
+                ++numFrames;
+            } while (scene.getTransactionStats().numPendingResets > 0);
+
+            std::cout << n << " item resets, budget = " << budget << " usec: " << numFrames << " frames, max frame = "
+                << maxFrameTime << " usec, total = " << totalTime << " usec" << std::endl;
+        }
+    }
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,202 @@
+//
+//  SpatialTreeTests.cpp
+//  tests/render/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SpatialTreeTests.h"
+
+#include <cmath>
+#include <iostream>
+
+#include <SharedUtil.h>
+
+#include "RenderTestUtils.h"
+
+QTEST_MAIN(SpatialTreeTests)
+
+// The lane kernels behind Octree::CellLanes::intersect()
+void intersectCellLanes_ref(const float* minX, const float* minY, const float* minZ, float size,
+                            const float (*frustum)[4], uint8_t* intersections);
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <CPUDetect.h>
+
+void intersectCellLanes_AVX2(const float* minX, const float* minY, const float* minZ, float size,
+                             const float (*frustum)[4], uint8_t* intersections);
+#endif
+
+const float LOD_ANGLE = glm::radians(0.5f);
+
+// off the cell grid, so the planes through the eye don't run along cell faces
+const glm::vec3 EYE_POSITION(1.3f, 0.7f, -2.1f);
+
+static const glm::quat ORIENTATIONS[] = {
+    glm::quat(),
+    glm::angleAxis(glm::radians(37.0f), glm::vec3(0.0f, 1.0f, 0.0f)),
+    glm::angleAxis(glm::radians(-110.0f), glm::normalize(glm::vec3(1.0f, 1.0f, 0.0f))),
+};
+
+// The selector ItemSpatialTree::selectCells() builds for a perspective frustum, in normalized octree space
+static render::Octree::PerspectiveSelector buildSelector(const render::ItemSpatialTree& tree, const ViewFrustum& frustum) {
+    render::Octree::PerspectiveSelector selector;
+    auto worldPlanes = frustum.getPlanes();
+    for (int i = 0; i < ViewFrustum::NUM_PLANES; i++) {
+        ::Plane octPlane;
+        octPlane.setNormalAndPoint(worldPlanes[i].getNormal(), tree.evalCoordf(worldPlanes[i].getPoint(), render::Octree::ROOT_DEPTH));
+        selector.frustum[i] = render::Octree::Coord4f(octPlane.getNormal(), octPlane.getDCoefficient());
+    }
+
+    selector.eyePos = tree.evalCoordf(frustum.getPosition(), render::Octree::ROOT_DEPTH);
+    selector.setAngle(LOD_ANGLE);
+    return selector;
+}
+
+// The traversal Octree::select() replaced, testing the cells one at a time
+static void selectPerCell(const render::ItemSpatialTree& tree, const render::Octree::FrustumSelector& selector,
+                          render::Octree::CellSelection& selection) {
+    tree.selectCellBrick(render::Octree::ROOT_CELL, selection, false);
+
+    const auto& root = tree.getConcreteCell(render::Octree::ROOT_CELL);
+    for (int i = 0; i < render::Octree::NUM_OCTANTS; i++) {
+        auto subCellID = root.child((render::Octree::Link)i);
+        if (subCellID != render::Octree::INVALID_CELL) {
+            tree.selectTraverse(subCellID, selection, selector);
+        }
+    }
+}
+
+// Whether a corner of the cell is close enough to a frustum plane for rounding to decide which side it is on
+static bool isCornerOnPlane(const render::Octree::Location& cell, const render::Octree::Coord4f frustum[6]) {
+    const double EPSILON = 1.0e-6;
+    double size = render::Octree::getInvDepthDimension(cell.depth);
+    for (int p = 0; p < ViewFrustum::NUM_PLANES; p++) {
+        for (int corner = 0; corner < render::Octree::NUM_OCTANTS; corner++) {
+            double x = (cell.pos.x + ((corner & render::Octree::XAxis) ? 1 : 0)) * size;
+            double y = (cell.pos.y + ((corner & render::Octree::YAxis) ? 1 : 0)) * size;
+            double z = (cell.pos.z + ((corner & render::Octree::ZAxis) ? 1 : 0)) * size;
+            double distance = frustum[p].x * x + frustum[p].y * y + frustum[p].z * z + frustum[p].w;
+            if (std::abs(distance) < EPSILON) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void SpatialTreeTests::testLanesMatchPerCell() {
+    const uint32_t NUM_ITEMS = 10000;
+    render::ItemSpatialTree tree(glm::vec3(-16384.0f), 32768.0f);
+    buildTree(tree, NUM_ITEMS);
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+    bool testAVX2 = cpuSupportsAVX2();
+#endif
+
+    for (auto& orientation : ORIENTATIONS) {
+        auto selector = buildSelector(tree, buildFrustum(orientation, EYE_POSITION));
+        const float (*frustum)[4] = (const float(*)[4])selector.frustum;
+
+        int numPartial = 0;
+        for (render::Octree::Index cellID = 0; cellID < tree.getNumAllocatedCells(); cellID++) {
+            const auto& cell = tree.getConcreteCell(cellID);
+            if (!cell.hasChildren()) {
+                continue;
+            }
+
+            render::Octree::CellLanes lanes;
+            lanes.setChildrenOf(cell.getlocation());
+
+            render::Octree::Location children[render::Octree::CellLanes::NUM_LANES];
+            uint8_t expected[render::Octree::CellLanes::NUM_LANES];
+            for (int i = 0; i < render::Octree::CellLanes::NUM_LANES; i++) {
+                children[i] = cell.getlocation().child((render::Octree::Link)i);
+                expected[i] = (uint8_t)render::Octree::Location::intersectCell(children[i], selector.frustum);
+                numPartial += (expected[i] == render::Octree::Location::Intersect);
+            }
+
+            // FMA and the order of the sums can only move a cell that touches a plane to the other side of it
+            uint8_t intersections[render::Octree::CellLanes::NUM_LANES];
+            auto matchesPerCell = [&] {
+                for (int i = 0; i < render::Octree::CellLanes::NUM_LANES; i++) {
+                    if (intersections[i] != expected[i] && !isCornerOnPlane(children[i], selector.frustum)) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            // the scalar lanes, then whichever of SSE or AVX2 select() dispatches to
+            intersectCellLanes_ref(lanes.minX, lanes.minY, lanes.minZ, lanes.size, frustum, intersections);
+            QVERIFY(matchesPerCell());
+
+            lanes.intersect(selector.frustum, intersections);
+            QVERIFY(matchesPerCell());
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+            if (testAVX2) {
+                intersectCellLanes_AVX2(lanes.minX, lanes.minY, lanes.minZ, lanes.size, frustum, intersections);
+                QVERIFY(matchesPerCell());
+            }
+#endif
+        }
+        QVERIFY(numPartial > 0);
+    }
+}
+
+void SpatialTreeTests::testSelectMatchesPerCell() {
+    const uint32_t NUM_ITEMS = 100000;
+    render::ItemSpatialTree tree(glm::vec3(-16384.0f), 32768.0f);
+    buildTree(tree, NUM_ITEMS);
+
+    for (auto& orientation : ORIENTATIONS) {
+        auto frustum = buildFrustum(orientation, EYE_POSITION);
+
+        render::Octree::CellSelection selection;
+        tree.selectCells(selection, frustum, LOD_ANGLE);
+        render::Octree::CellSelection reference;
+        selectPerCell(tree, buildSelector(tree, frustum), reference);
+
+        QVERIFY(reference.size() > 1);
+        QVERIFY(selection.insideCells == reference.insideCells);
+        QVERIFY(selection.partialCells == reference.partialCells);
+        QVERIFY(selection.insideBricks == reference.insideBricks);
+        QVERIFY(selection.partialBricks == reference.partialBricks);
+    }
+}
+
+#ifdef MANUAL_TEST
+
+void SpatialTreeTests::benchmark() {
+    const uint32_t numItems[] = { 10000, 100000 };
+    const int NUM_FRAMES = 100;
+    for (auto n : numItems) {
+        render::ItemSpatialTree tree(glm::vec3(-16384.0f), 32768.0f);
+        buildTree(tree, n);
+        auto selector = buildSelector(tree, buildFrustum(glm::quat(), EYE_POSITION));
+
+        for (bool perCell : { true, false }) {
+            uint64_t selectTime = 0;
+            size_t numCells = 0;
+            for (int i = 0; i < NUM_FRAMES; ++i) {
+                render::Octree::CellSelection selection;
+                uint64_t startTime = usecTimestampNow();
+                if (perCell) {
+                    selectPerCell(tree, selector, selection);
+                } else {
+                    tree.select(selection, selector);
+                }
+                selectTime += usecTimestampNow() - startTime;
+                numCells = selection.size();
+            }
+            std::cout << n << " items, " << numCells << " cells selected, " << (perCell ? "per cell" : "lanes")
+                << " select = " << (selectTime / NUM_FRAMES) << " usec" << std::endl;
+        }
+    }
+}
+
+#endif // MANUAL_TEST
@@ -0,0 +1,29 @@
+//
+//  SpatialTreeTests.h
+//  tests/render/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_SpatialTreeTests_h
+#define hifi_render_SpatialTreeTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class SpatialTreeTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testLanesMatchPerCell();
+    void testSelectMatchesPerCell();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_render_SpatialTreeTests_h
@@ -22,10 +22,25 @@ const float INV_SQRT_3 = 1.0f / sqrtf(3.0f);
 
 QTEST_MAIN(SpaceTests)
 
+static workload::View makeView(const glm::vec3& center, float near, float mid, float far) {
+    workload::View view;
+    view.origin = center;
+    view.regions[workload::Region::R1] = workload::Sphere(center, near);
+    view.regions[workload::Region::R2] = workload::Sphere(center, mid);
+    view.regions[workload::Region::R3] = workload::Sphere(center, far);
+    return view;
+}
+
+static void applyTransaction(workload::Space& space, const workload::Transaction& transaction) {
+    space.enqueueTransaction(transaction);
+    space.enqueueFrame();
+    space.processTransactionQueue();
+}
+
 void SpaceTests::testOverlaps() {
     workload::Space space;
     using Changes = std::vector<workload::Space::Change>;
-    using Views = std::vector<workload::Space::View>;
+    using Views = workload::Views;
 
     glm::vec3 viewCenter(0.0f, 0.0f, 0.0f);
     float near = 1.0f;
@@ -33,74 +48,77 @@ void SpaceTests::testOverlaps() {
     float far = 3.0f;
 
     Views views;
-    views.push_back(workload::Space::View(viewCenter, near, mid, far));
+    views.push_back(makeView(viewCenter, near, mid, far));
     space.setViews(views);
 
     int32_t proxyId = 0;
     const float DELTA = 0.001f;
     float proxyRadius = 0.5f;
     glm::vec3 proxyPosition = viewCenter + glm::vec3(0.0f, 0.0f, far + proxyRadius + DELTA);
-    workload::Space::Sphere proxySphere(proxyPosition, proxyRadius);
+    workload::Sphere proxySphere(proxyPosition, proxyRadius);
 
     { // create very_far proxy
-        proxyId = space.createProxy(proxySphere);
+        proxyId = space.allocateID();
+        workload::Transaction transaction;
+        transaction.reset(proxyId, proxySphere, workload::Owner());
+        applyTransaction(space, transaction);
         QVERIFY(space.getNumObjects() == 1);
 
         Changes changes;
         space.categorizeAndGetChanges(changes);
-        QVERIFY(changes.size() == 0);
+        QVERIFY(changes.size() == 1);
+        QVERIFY(changes[0].proxyId == proxyId);
+        QVERIFY(changes[0].region == workload::Region::R4);
+        QVERIFY(changes[0].prevRegion == workload::Region::UNKNOWN);
     }
 
     { // move proxy far
         float newRadius = 1.0f;
         glm::vec3 newPosition = viewCenter + glm::vec3(0.0f, 0.0f, far + newRadius - DELTA);
-        workload::Space::Sphere newSphere(newPosition, newRadius);
-        std::vector<workload::Space::ProxyUpdate> updates;
-        updates.push_back(workload::Space::ProxyUpdate(proxyId, newSphere));
-        space.updateProxies(updates);
+        workload::Transaction transaction;
+        transaction.update(proxyId, workload::Sphere(newPosition, newRadius));
+        applyTransaction(space, transaction);
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 1);
         QVERIFY(changes[0].proxyId == proxyId);
-        QVERIFY(changes[0].region == workload::Space::REGION_FAR);
-        QVERIFY(changes[0].prevRegion == workload::Space::REGION_UNKNOWN);
+        QVERIFY(changes[0].region == workload::Region::R3);
+        QVERIFY(changes[0].prevRegion == workload::Region::R4);
     }
 
     { // move proxy mid
         float newRadius = 1.0f;
         glm::vec3 newPosition = viewCenter + glm::vec3(0.0f, 0.0f, mid + newRadius - DELTA);
-        workload::Space::Sphere newSphere(newPosition, newRadius);
-        std::vector<workload::Space::ProxyUpdate> updates;
-        updates.push_back(workload::Space::ProxyUpdate(proxyId, newSphere));
-        space.updateProxies(updates);
+        workload::Transaction transaction;
+        transaction.update(proxyId, workload::Sphere(newPosition, newRadius));
+        applyTransaction(space, transaction);
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 1);
         QVERIFY(changes[0].proxyId == proxyId);
-        QVERIFY(changes[0].region == workload::Space::REGION_MIDDLE);
-        QVERIFY(changes[0].prevRegion == workload::Space::REGION_FAR);
+        QVERIFY(changes[0].region == workload::Region::R2);
+        QVERIFY(changes[0].prevRegion == workload::Region::R3);
     }
 
     { // move proxy near
         float newRadius = 1.0f;
         glm::vec3 newPosition = viewCenter + glm::vec3(0.0f, 0.0f, near + newRadius - DELTA);
-        workload::Space::Sphere newSphere(newPosition, newRadius);
-        std::vector<workload::Space::ProxyUpdate> updates;
-        updates.push_back(workload::Space::ProxyUpdate(proxyId, newSphere));
-        space.updateProxies(updates);
+        workload::Transaction transaction;
+        transaction.update(proxyId, workload::Sphere(newPosition, newRadius));
+        applyTransaction(space, transaction);
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 1);
         QVERIFY(changes[0].proxyId == proxyId);
-        QVERIFY(changes[0].region == workload::Space::REGION_NEAR);
-        QVERIFY(changes[0].prevRegion == workload::Space::REGION_MIDDLE);
+        QVERIFY(changes[0].region == workload::Region::R1);
+        QVERIFY(changes[0].prevRegion == workload::Region::R2);
     }
 
     { // delete proxy
         // NOTE: atm deleting a proxy doesn't result in a "Change"
-        std::vector<int32_t> deadProxies;
-        deadProxies.push_back(proxyId);
-        space.deleteProxies(deadProxies);
+        workload::Transaction transaction;
+        transaction.remove(proxyId);
+        applyTransaction(space, transaction);
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 0);
@@ -108,8 +126,6 @@ void SpaceTests::testOverlaps() {
     }
 }
 
-#ifdef MANUAL_TEST
-
 const float WORLD_WIDTH = 1000.0f;
 const float MIN_RADIUS = 1.0f;
 const float MAX_RADIUS = 100.0f;
@@ -123,158 +139,146 @@ glm::vec3 randomVec3() {
     return v;
 }
 
-void generateSpheres(uint32_t numProxies, std::vector<workload::Space::Sphere>& spheres) {
+void generateSpheres(uint32_t numProxies, std::vector<workload::Sphere>& spheres) {
     spheres.reserve(numProxies);
     for (uint32_t i = 0; i < numProxies; ++i) {
-        workload::Space::Sphere sphere(
+        workload::Sphere sphere(
                 WORLD_WIDTH * randomFloat(),
                 WORLD_WIDTH * randomFloat(),
                 WORLD_WIDTH * randomFloat(),
-                (MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS)) * randomFloat());
+                MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS) * 0.5f * (randomFloat() + 1.0f));
         spheres.push_back(sphere);
     }
 }
 
-void generatePositions(uint32_t numProxies, std::vector<glm::vec3>& positions) {
-    positions.reserve(numProxies);
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        positions.push_back(WORLD_WIDTH * randomVec3());
-    }
+static workload::Views generateViews(const glm::vec3& offset) {
+    float radius0 = 0.25f * WORLD_WIDTH;
+    float radius1 = 0.50f * WORLD_WIDTH;
+    float radius2 = 0.75f * WORLD_WIDTH;
+    workload::Views views;
+    views.push_back(makeView(offset, radius0, radius1, radius2));
+    views.push_back(makeView(offset + glm::vec3(0.0f, 0.0f, 0.1f * WORLD_WIDTH), radius0, radius1, radius2));
+    return views;
 }
 
-void generateRadiuses(uint32_t numRadiuses, std::vector<float>& radiuses) {
-    radiuses.reserve(numRadiuses);
-    for (uint32_t i = 0; i < numRadiuses; ++i) {
-        radiuses.push_back(MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS) * randomFloat());
+static std::vector<int32_t> addProxies(workload::Space& space, const std::vector<workload::Sphere>& spheres) {
+    std::vector<int32_t> proxyKeys;
+    proxyKeys.reserve(spheres.size());
+    workload::Transaction transaction;
+    for (auto& sphere : spheres) {
+        int32_t key = space.allocateID();
+        transaction.reset(key, sphere, workload::Owner());
+        proxyKeys.push_back(key);
     }
+    applyTransaction(space, transaction);
+    return proxyKeys;
 }
 
-void SpaceTests::benchmark() {
-    uint32_t numProxies[] = { 100, 1000, 10000, 100000 };
-    uint32_t numTests = 4;
-    std::vector<uint64_t> timeToAddAll;
-    std::vector<uint64_t> timeToMoveView;
-    std::vector<uint64_t> timeToMoveProxies;
-    std::vector<uint64_t> timeToRemoveAll;
-    for (uint32_t i = 0; i < numTests; ++i) {
-
-        workload::Space space;
-
-        { // build the views
-            std::vector<glm::vec3> viewPositions;
-            viewPositions.push_back(glm::vec3(0.0f, 0.0f, 0.0f));
-            viewPositions.push_back(glm::vec3(0.0f, 0.0f, 0.1f * WORLD_WIDTH));
-            float radius0 = 0.25f * WORLD_WIDTH;
-            float radius1 = 0.50f * WORLD_WIDTH;
-            float radius2 = 0.75f * WORLD_WIDTH;
-            std::vector<workload::Space::View> views;
-            views.push_back(workload::Space::View(viewPositions[0], radius0, radius1, radius2));
-            views.push_back(workload::Space::View(viewPositions[1], radius0, radius1, radius2));
-            space.setViews(views);
-        }
-
-        // build the proxies
-        uint32_t n = numProxies[i];
-        std::vector<workload::Space::Sphere> proxySpheres;
-        generateSpheres(n, proxySpheres);
-        std::vector<int32_t> proxyKeys;
-        proxyKeys.reserve(n);
+static void moveProxies(workload::Space& space, const std::vector<int32_t>& proxyKeys,
+                        std::vector<workload::Sphere>& spheres, uint32_t step, float distance) {
+    workload::Transaction transaction;
+    for (uint32_t j = 0; j < proxyKeys.size(); j += step) {
+        spheres[j] += workload::Sphere(distance * randomVec3(), 0.0f);
+        transaction.update(proxyKeys[j], spheres[j]);
+    }
+    applyTransaction(space, transaction);
+}
 
-        // measure time to put proxies in the space
-        uint64_t startTime = usecTimestampNow();
-        for (uint32_t j = 0; j < n; ++j) {
-            int32_t key = space.createProxy(proxySpheres[j]);
-            proxyKeys.push_back(key);
-        }
-        uint64_t usec = usecTimestampNow() - startTime;
-        timeToAddAll.push_back(usec);
-
-        {
-            // build the views
-            std::vector<glm::vec3> viewPositions;
-            viewPositions.push_back(glm::vec3(1.0f, 2.0f, 3.0f));
-            viewPositions.push_back(glm::vec3(1.0f, 2.0f, 3.0f + 0.1f * WORLD_WIDTH));
-            float radius0 = 0.25f * WORLD_WIDTH;
-            float radius1 = 0.50f * WORLD_WIDTH;
-            float radius2 = 0.75f * WORLD_WIDTH;
-            std::vector<workload::Space::View> views;
-            views.push_back(workload::Space::View(viewPositions[0], radius0, radius1, radius2));
-            views.push_back(workload::Space::View(viewPositions[1], radius0, radius1, radius2));
-            space.setViews(views);
-        }
+void SpaceTests::testIncrementalClassification() {
+    // classify a space incrementally over several frames and compare with a space built from scratch
+    const uint32_t NUM_PROXIES = 10000;
+    const uint32_t MOVING_STEP = 20;
+    const int NUM_FRAMES = 4;
+    srand(0);
+    std::vector<workload::Sphere> spheres;
+    generateSpheres(NUM_PROXIES, spheres);
+    auto views = generateViews(glm::vec3(0.0f));
 
-        // measure time to categorizeAndGetChanges everything
-        std::vector<workload::Space::Change> changes;
-        startTime = usecTimestampNow();
-        space.categorizeAndGetChanges(changes);
-        usec = usecTimestampNow() - startTime;
-        timeToMoveView.push_back(usec);
-
-        // move every 10th proxy around
-        const float proxySpeed = 1.0f;
-        std::vector<workload::Space::Sphere> newSpheres;
-        uint32_t numMovingProxies = n / 10;
-        uint32_t jstep = n / numMovingProxies;
-        uint32_t maxJ = numMovingProxies * jstep - 1;
-        glm::vec3 direction;
-        for (uint32_t j = 0; j < maxJ - jstep; j += jstep) {
-            glm::vec3 position = (glm::vec3)proxySpheres[j];
-            glm::vec3 destination = (glm::vec3)proxySpheres[j + jstep];
-            direction = glm::normalize(destination - position);
-            glm::vec3 newPosition = position + proxySpeed * direction;
-            newSpheres.push_back(workload::Space::Sphere(newPosition, proxySpheres[j].w));
-        }
-        glm::vec3 position = (glm::vec3)proxySpheres[maxJ = jstep];
-        glm::vec3 destination = (glm::vec3)proxySpheres[0];
-        direction = glm::normalize(destination - position);
-        direction = position + proxySpeed * direction;
-        newSpheres.push_back(workload::Space::Sphere(direction, proxySpheres[0].w));
-        uint32_t k = 0;
-        startTime = usecTimestampNow();
-        for (uint32_t j = 0; j < maxJ; j += jstep) {
-            space.updateProxy(proxyKeys[j], newSpheres[k++]);
-        }
+    workload::Space space;
+    space.setViews(views);
+    auto proxyKeys = addProxies(space, spheres);
+    std::vector<workload::Space::Change> changes;
+    space.categorizeAndGetChanges(changes);
+    QVERIFY(space.getNumClassifiedProxies() >= NUM_PROXIES);
+
+    for (int i = 0; i < NUM_FRAMES; ++i) {
+        moveProxies(space, proxyKeys, spheres, MOVING_STEP, 0.1f * WORLD_WIDTH);
+        space.setViews(views);
         changes.clear();
         space.categorizeAndGetChanges(changes);
-        usec = usecTimestampNow() - startTime;
-        timeToMoveProxies.push_back(usec);
-
-        // measure time to remove proxies from space
-        startTime = usecTimestampNow();
-        for (uint32_t j = 0; j < n; ++j) {
-            space.deleteProxy(proxyKeys[j]);
+        QVERIFY(space.getNumClassifiedProxies() < NUM_PROXIES / 4);
+        for (size_t j = 1; j < changes.size(); ++j) {
+            QVERIFY(changes[j - 1].proxyId < changes[j].proxyId);
         }
-        usec = usecTimestampNow() - startTime;
-        timeToRemoveAll.push_back(usec);
     }
 
-    std::cout << "[numProxies, timeToAddAll] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToAddAll.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << ", " << timeToAddAll[i] << std::endl;
-    }
-    std::cout << "];" << std::endl;
+    workload::Space reference;
+    reference.setViews(views);
+    addProxies(reference, spheres);
+    changes.clear();
+    reference.categorizeAndGetChanges(changes);
 
-    std::cout << "[numProxies, timeToMoveView] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToMoveView.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << ", " << timeToMoveView[i] << std::endl;
+    for (auto key : proxyKeys) {
+        QCOMPARE(space.getRegion(key), reference.getRegion(key));
     }
-    std::cout << "];" << std::endl;
 
-    std::cout << "[numProxies, timeToMoveProxies] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToMoveProxies.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << "/10, " << timeToMoveProxies[i] << std::endl;
+    // a view change reclassifies everything
+    space.setViews(generateViews(glm::vec3(0.2f * WORLD_WIDTH)));
+    reference.setViews(generateViews(glm::vec3(0.2f * WORLD_WIDTH)));
+    changes.clear();
+    space.categorizeAndGetChanges(changes);
+    QVERIFY(space.getNumClassifiedProxies() >= NUM_PROXIES);
+    changes.clear();
+    reference.categorizeAndGetChanges(changes);
+    for (auto key : proxyKeys) {
+        QCOMPARE(space.getRegion(key), reference.getRegion(key));
     }
-    std::cout << "];" << std::endl;
+}
+
+#ifdef MANUAL_TEST
+
+void SpaceTests::benchmark() {
+    uint32_t numProxies[] = { 10000, 100000 };
+    const int NUM_FRAMES = 20;
+    const uint32_t MOVING_STEP = 10;
+    for (auto n : numProxies) {
+        srand(0);
+        workload::Space space;
+        std::vector<workload::Sphere> spheres;
+        generateSpheres(n, spheres);
+
+        uint64_t startTime = usecTimestampNow();
+        auto proxyKeys = addProxies(space, spheres);
+        uint64_t timeToAddAll = usecTimestampNow() - startTime;
+
+        // every frame the views move: every proxy is reclassified
+        std::vector<workload::Space::Change> changes;
+        uint64_t timeToMoveView = 0;
+        for (int i = 0; i < NUM_FRAMES; ++i) {
+            space.setViews(generateViews(glm::vec3((float)i, 2.0f, 3.0f)));
+            changes.clear();
+            startTime = usecTimestampNow();
+            space.categorizeAndGetChanges(changes);
+            timeToMoveView += usecTimestampNow() - startTime;
+        }
+
+        // every frame one proxy in 10 moves and the views stay put: only these are reclassified
+        auto views = generateViews(glm::vec3(1.0f, 2.0f, 3.0f));
+        uint64_t timeToMoveProxies = 0;
+        for (int i = 0; i < NUM_FRAMES; ++i) {
+            moveProxies(space, proxyKeys, spheres, MOVING_STEP, 1.0f);
+            space.setViews(views);
+            changes.clear();
+            startTime = usecTimestampNow();
+            space.categorizeAndGetChanges(changes);
+            timeToMoveProxies += usecTimestampNow() - startTime;
+        }
 
-    std::cout << "[numProxies, timeToRemoveAll] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToRemoveAll.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << ", " << timeToRemoveAll[i] << std::endl;
+        std::cout << n << " proxies: add all = " << timeToAddAll << " usec, "
+            << "classify all (view moving) = " << (timeToMoveView / NUM_FRAMES) << " usec/frame, "
+            << "classify moved (1/" << MOVING_STEP << " moving) = " << (timeToMoveProxies / NUM_FRAMES) << " usec/frame"
+            << std::endl;
     }
-    std::cout << "];" << std::endl;
 }
 
 #endif // MANUAL_TEST
@@ -21,6 +21,7 @@ class SpaceTests : public QObject {
 
 private slots:
     void testOverlaps();
+    void testIncrementalClassification();
 #ifdef MANUAL_TEST
     void benchmark();
 #endif // MANUAL_TEST
@@ -57,6 +57,9 @@ ATPClientApp::ATPClientApp(int argc, char* argv[]) :
     const QCommandLineOption listenPortOption("listenPort", "listen port", QString::number(INVALID_PORT));
     parser.addOption(listenPortOption);
 
+    const QCommandLineOption noChunkingOption("no-chunking", "always transfer whole assets, not only the chunks that changed");
+    parser.addOption(noChunkingOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -125,6 +128,8 @@ ATPClientApp::ATPClientApp(int argc, char* argv[]) :
         _listenPort = parser.value(listenPortOption).toInt();
     }
 
+    _chunkingEnabled = !parser.isSet(noChunkingOption);
+
     _domainServerAddress = QString("127.0.0.1") + ":" + QString::number(domainPort);
     if (parser.isSet(domainAddressOption)) {
         _domainServerAddress = parser.value(domainAddressOption);
@@ -291,10 +296,15 @@ void ATPClientApp::uploadAsset() {
     }
 
     auto upload = DependencyManager::get<AssetClient>()->createUpload(_localUploadFile);
+    upload->setChunkingEnabled(_chunkingEnabled);
     QObject::connect(upload, &AssetUpload::finished, this, [=](AssetUpload* upload, const QString& hash) mutable {
         if (upload->getError() != AssetUpload::NoError) {
             qDebug() << "upload failed: " << upload->getErrorString();
         } else {
+            if (_verbose) {
+                qDebug() << "sent" << upload->getBytesSent() << "bytes," << upload->getNumChunksSent() << "of"
+                    << upload->getNumChunks() << "chunks";
+            }
             setMapping(hash);
         }
 
@@ -363,10 +373,16 @@ void ATPClientApp::lookupAsset() {
 void ATPClientApp::download(AssetUtils::AssetHash hash) {
     auto assetClient = DependencyManager::get<AssetClient>();
     auto assetRequest = new AssetRequest(hash);
+    assetRequest->setChunkingEnabled(_chunkingEnabled);
 
     connect(assetRequest, &AssetRequest::finished, this, [this](AssetRequest* request) mutable {
         Q_ASSERT(request->getState() == AssetRequest::Finished);
 
+        if (_verbose) {
+            qDebug() << "received" << request->getBytesReceived() << "of" << request->getData().size() << "bytes"
+                << (request->loadedFromCache() ? "(cached)" : "");
+        }
+
         if (request->getError() == AssetRequest::Error::NoError) {
             QString data = QString::fromUtf8(request->getData());
             if (_localOutputFile == "" || _localOutputFile == "-") {
@@ -54,6 +54,7 @@ private:
     QString _localUploadFile;
 
     int _listenPort { INVALID_PORT };
+    bool _chunkingEnabled { true };
 
     QString _domainServerAddress;
 
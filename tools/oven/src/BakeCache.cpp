@@ -0,0 +1,294 @@
+//
+//  BakeCache.cpp
+//  tools/oven/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakeCache.h"
+
+#include <algorithm>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <BuildInfo.h>
+
+const qint64 BakeCache::DEFAULT_MAX_SIZE = 10LL * 1024 * 1024 * 1024;
+const qint64 BakeCache::DEFAULT_MAX_AGE_SECS = 30 * 24 * 60 * 60;
+
+static const QString ENTRY_FILENAME = "entry.json";
+static const QString ENTRY_FILES_FOLDER = "files";
+
+static const QString VERSION_KEY = "version";
+static const QString FILES_KEY = "files";
+static const QString INPUTS_KEY = "inputs";
+static const QString RESULT_KEY = "result";
+static const QString SIZE_KEY = "size";
+static const QString BAKE_TIME_KEY = "bakeTimeMsecs";
+
+QString BakeCache::getBakerVersion() {
+    // Dev builds all share one version string, the executable tells them apart
+    static const QString version = [] {
+        QString result = BuildInfo::VERSION;
+        QFile executable { QCoreApplication::applicationFilePath() };
+        QCryptographicHash hasher(QCryptographicHash::Sha256);
+        if (executable.open(QIODevice::ReadOnly) && hasher.addData(&executable)) {
+            result += "-" + QString::fromLatin1(hasher.result().toHex());
+        }
+        return result;
+    }();
+    return version;
+}
+
+BakeCache::BakeCache(const QString& cacheDirectory, const QString& version) :
+    _cacheDir(cacheDirectory),
+    _version(version)
+{
+    _isValid = _cacheDir.mkpath(".");
+    if (!_isValid) {
+        qWarning() << "Could not create bake cache folder" << cacheDirectory;
+    }
+}
+
+void BakeCache::setLimits(qint64 maxSize, qint64 maxAgeSecs) {
+    _maxSize = maxSize;
+    _maxAgeSecs = maxAgeSecs;
+}
+
+QByteArray BakeCache::hashFile(const QString& path) {
+    auto absolutePath = QFileInfo(path).absoluteFilePath();
+    auto it = _fileHashes.find(absolutePath);
+    if (it != _fileHashes.end()) {
+        return it.value();
+    }
+
+    QByteArray result;
+    QFile file { absolutePath };
+    if (file.open(QIODevice::ReadOnly)) {
+        QCryptographicHash hasher(QCryptographicHash::Sha256);
+        if (hasher.addData(&file)) {
+            result = hasher.result();
+        }
+    }
+    _fileHashes.insert(absolutePath, result);
+    return result;
+}
+
+QString BakeCache::computeKey(const QString& type, const QList<QByteArray>& inputHashes, const QStringList& options) const {
+    QCryptographicHash hasher(QCryptographicHash::Sha256);
+    hasher.addData(_version.toUtf8());
+    hasher.addData(type.toUtf8());
+    for (const auto& option : options) {
+        hasher.addData(option.toUtf8());
+        hasher.addData("\n", 1);
+    }
+    for (const auto& hash : inputHashes) {
+        hasher.addData(hash);
+    }
+    return hasher.result().toHex();
+}
+
+QString BakeCache::getEntryPath(const QString& key) const {
+    // Spread the entries over sub-folders so that no single folder gets too large
+    return _cacheDir.absoluteFilePath(key.left(2) + "/" + key);
+}
+
+bool BakeCache::lookup(const QString& key, Entry& entry) {
+    if (!_isValid) {
+        return false;
+    }
+
+    QDir entryDir { getEntryPath(key) };
+    QFile entryFile { entryDir.absoluteFilePath(ENTRY_FILENAME) };
+    if (!entryFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    auto json = QJsonDocument::fromJson(entryFile.readAll()).object();
+    entryFile.close();
+    if (json[VERSION_KEY].toString() != _version) {
+        return false;
+    }
+
+    auto inputs = json[INPUTS_KEY].toObject();
+    for (auto it = inputs.constBegin(); it != inputs.constEnd(); ++it) {
+        if (hashFile(it.key()).toHex() != it.value().toString().toLatin1()) {
+            qDebug() << "Bake cache entry" << key << "is stale," << it.key() << "changed";
+            return false;
+        }
+    }
+
+    entry.key = key;
+    entry.files.clear();
+    for (const auto& file : json[FILES_KEY].toArray()) {
+        auto relativePath = file.toString();
+        if (!QFileInfo::exists(entryDir.absoluteFilePath(ENTRY_FILES_FOLDER + "/" + relativePath))) {
+            qWarning() << "Bake cache entry" << key << "is missing" << relativePath;
+            return false;
+        }
+        entry.files << relativePath;
+    }
+    entry.result = json[RESULT_KEY].toString();
+    entry.bakeTimeMsecs = (qint64)json[BAKE_TIME_KEY].toDouble();
+    if (entry.files.isEmpty() || entry.result.isEmpty()) {
+        return false;
+    }
+
+    // The modification time of the entry file is its last use, eviction goes by it
+    if (entryFile.open(QIODevice::ReadWrite)) {
+        entryFile.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    }
+    return true;
+}
+
+bool BakeCache::restore(const Entry& entry, const QString& destination, const std::function<QString(const QString&)>& renameFile) const {
+    QDir filesDir { getEntryPath(entry.key) + "/" + ENTRY_FILES_FOLDER };
+    QDir destinationDir { destination };
+
+    for (const auto& relativePath : entry.files) {
+        auto destinationPath = destinationDir.absoluteFilePath(renameFile ? renameFile(relativePath) : relativePath);
+        if (!QDir().mkpath(QFileInfo(destinationPath).absolutePath())) {
+            return false;
+        }
+        QFile::remove(destinationPath);
+        if (!QFile::copy(filesDir.absoluteFilePath(relativePath), destinationPath)) {
+            qWarning() << "Could not restore" << relativePath << "from bake cache entry" << entry.key;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BakeCache::store(const QString& key, const QString& sourceRoot, const QStringList& files, const QString& result,
+                      const QStringList& inputFiles, qint64 bakeTimeMsecs) {
+    if (!_isValid) {
+        return false;
+    }
+
+    // Write the entry next to its final location and move it in place once complete, so that an interrupted
+    // bake never leaves a partial entry behind
+    auto entryPath = getEntryPath(key);
+    auto stagingPath = entryPath + ".staging-" + QString::number(QCoreApplication::applicationPid());
+    QDir stagingDir { stagingPath };
+    stagingDir.removeRecursively();
+    if (!QDir().mkpath(stagingDir.absoluteFilePath(ENTRY_FILES_FOLDER))) {
+        return false;
+    }
+
+    QDir sourceDir { sourceRoot };
+    QJsonArray fileArray;
+    qint64 size = 0;
+    for (const auto& file : files) {
+        auto relativePath = sourceDir.relativeFilePath(file);
+        if (relativePath.startsWith("..") || QDir::isAbsolutePath(relativePath)) {
+            // Only outputs that live under the baker's folder can be restored somewhere else
+            stagingDir.removeRecursively();
+            return false;
+        }
+
+        auto stagedPath = stagingDir.absoluteFilePath(ENTRY_FILES_FOLDER + "/" + relativePath);
+        if (!QDir().mkpath(QFileInfo(stagedPath).absolutePath()) || !QFile::copy(file, stagedPath)) {
+            stagingDir.removeRecursively();
+            return false;
+        }
+        fileArray.append(relativePath);
+        size += QFileInfo(stagedPath).size();
+    }
+
+    QJsonObject inputs;
+    for (const auto& inputFile : inputFiles) {
+        inputs[QFileInfo(inputFile).absoluteFilePath()] = QString::fromLatin1(hashFile(inputFile).toHex());
+    }
+
+    QJsonObject json;
+    json[VERSION_KEY] = _version;
+    json[FILES_KEY] = fileArray;
+    json[INPUTS_KEY] = inputs;
+    json[RESULT_KEY] = sourceDir.relativeFilePath(result);
+    json[SIZE_KEY] = (double)size;
+    json[BAKE_TIME_KEY] = (double)bakeTimeMsecs;
+
+    QFile entryFile { stagingDir.absoluteFilePath(ENTRY_FILENAME) };
+    if (!entryFile.open(QIODevice::WriteOnly) || entryFile.write(QJsonDocument(json).toJson()) == -1) {
+        stagingDir.removeRecursively();
+        return false;
+    }
+    entryFile.close();
+
+    // An entry already there went stale, or another oven stored the same bake meanwhile
+    QDir staleDir { entryPath + ".stale-" + QString::number(QCoreApplication::applicationPid()) };
+    staleDir.removeRecursively();
+    if (QFileInfo::exists(entryPath) && !QDir().rename(entryPath, staleDir.absolutePath())) {
+        stagingDir.removeRecursively();
+        return false;
+    }
+    staleDir.removeRecursively();
+
+    if (!QDir().rename(stagingPath, entryPath)) {
+        stagingDir.removeRecursively();
+        return false;
+    }
+    return true;
+}
+
+int BakeCache::evict() {
+    if (!_isValid) {
+        return 0;
+    }
+
+    struct EntryUse {
+        QString path;
+        QDateTime lastUsed;
+        qint64 size;
+    };
+    std::vector<EntryUse> entries;
+    qint64 totalSize = 0;
+    int numEvicted = 0;
+
+    auto oldest = QDateTime::currentDateTimeUtc().addSecs(-_maxAgeSecs);
+    for (const auto& prefix : _cacheDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        QDir prefixDir { _cacheDir.absoluteFilePath(prefix) };
+        for (const auto& name : prefixDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+            auto entryPath = prefixDir.absoluteFilePath(name);
+            QFile entryFile { entryPath + "/" + ENTRY_FILENAME };
+            QFileInfo entryInfo { entryFile };
+
+            // Left over by an oven that was interrupted, or an entry that is past the age limit
+            auto lastUsed = entryInfo.exists() ? entryInfo.lastModified() : QFileInfo(entryPath).lastModified();
+            if (lastUsed < oldest) {
+                QDir(entryPath).removeRecursively();
+                ++numEvicted;
+                continue;
+            }
+
+            if (name.contains('.') || !entryFile.open(QIODevice::ReadOnly)) {
+                continue;
+            }
+            auto size = (qint64)QJsonDocument::fromJson(entryFile.readAll()).object()[SIZE_KEY].toDouble();
+            entries.push_back({ entryPath, lastUsed, size });
+            totalSize += size;
+        }
+    }
+
+    // Least recently used first
+    std::sort(entries.begin(), entries.end(), [](const EntryUse& a, const EntryUse& b) {
+        return a.lastUsed < b.lastUsed;
+    });
+    for (auto it = entries.begin(); it != entries.end() && totalSize > _maxSize; ++it) {
+        QDir(it->path).removeRecursively();
+        totalSize -= it->size;
+        ++numEvicted;
+    }
+    return numEvicted;
+}
@@ -0,0 +1,82 @@
+//
+//  BakeCache.h
+//  tools/oven/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakeCache_h
+#define hifi_BakeCache_h
+
+#include <functional>
+
+#include <QtCore/QDir>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+
+// Persistent, content-addressed store of bake results.
+//
+// An entry is keyed by the hash of the asset being baked, the baker version and the options that change the output.
+// It records the hash of every local file the bake read, a texture outside the model's folder included, and is only
+// hit while all of them are unchanged. It holds a copy of every file the bake produced, relative to the folder the
+// baker wrote into, and the relative path of the file entity references are re-written to.
+//
+// Entries not used for longer than the age limit, then the least recently used ones over the size limit, are evicted.
+class BakeCache {
+public:
+    static const qint64 DEFAULT_MAX_SIZE; // bytes
+    static const qint64 DEFAULT_MAX_AGE_SECS;
+
+    // The oven build and a hash of its executable, so that entries baked by any other build of the bakers are never hit
+    static QString getBakerVersion();
+
+    struct Entry {
+        QString key;
+        QStringList files;
+        QString result;
+        qint64 bakeTimeMsecs { 0 };
+    };
+
+    BakeCache(const QString& cacheDirectory, const QString& version = getBakerVersion());
+
+    bool isValid() const { return _isValid; }
+    QString getPath() const { return _cacheDir.absolutePath(); }
+    const QString& getVersion() const { return _version; }
+
+    void setLimits(qint64 maxSize, qint64 maxAgeSecs);
+
+    // Memoized for the lifetime of the cache, an empty result means the file couldn't be read
+    QByteArray hashFile(const QString& path);
+
+    QString computeKey(const QString& type, const QList<QByteArray>& inputHashes, const QStringList& options) const;
+
+    // Misses if any file the entry was baked from changed since
+    bool lookup(const QString& key, Entry& entry);
+
+    // Copies the files of an entry under destination, renameFile can be used to change their names
+    bool restore(const Entry& entry, const QString& destination,
+                 const std::function<QString(const QString&)>& renameFile = nullptr) const;
+
+    // Files and result are absolute paths under sourceRoot, inputFiles are the local files the bake read.
+    // Replaces a stale entry with the same key.
+    bool store(const QString& key, const QString& sourceRoot, const QStringList& files, const QString& result,
+               const QStringList& inputFiles, qint64 bakeTimeMsecs);
+
+    // Returns the number of entries removed
+    int evict();
+
+private:
+    QString getEntryPath(const QString& key) const;
+
+    QDir _cacheDir;
+    QString _version;
+    bool _isValid { false };
+    qint64 _maxSize { DEFAULT_MAX_SIZE };
+    qint64 _maxAgeSecs { DEFAULT_MAX_AGE_SECS };
+    QHash<QString, QByteArray> _fileHashes;
+};
+
+#endif // hifi_BakeCache_h
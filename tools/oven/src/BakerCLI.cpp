@@ -15,6 +15,9 @@
 #include <QImageReader>
 #include <QtCore/QDebug>
 #include <QFile>
+#include <QFileInfo>
+
+#include <iostream>
 
 #include <unordered_map>
 
@@ -24,6 +27,7 @@
 #include "JSBaker.h"
 #include "TextureBaker.h"
 #include "MaterialBaker.h"
+#include "DomainBaker.h"
 
 BakerCLI::BakerCLI(OvenCLIApplication* parent) : QObject(parent) {
     
@@ -111,6 +115,51 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString& outputPath, const QString&
     connect(_baker.get(), &Baker::finished, this, &BakerCLI::handleFinishedBaker);
 }
 
+void BakerCLI::bakeDomain(QUrl entitiesFileUrl, const QString& outputPath, const QUrl& destinationUrl,
+                          const QString& cacheDirectory, bool rebakeOriginals) {
+    // if the URL doesn't have a scheme, assume it is a local file
+    if (entitiesFileUrl.scheme() != "http" && entitiesFileUrl.scheme() != "https" && entitiesFileUrl.scheme() != "file") {
+        entitiesFileUrl = QUrl::fromLocalFile(entitiesFileUrl.toString());
+    }
+
+    _outputPath = outputPath;
+
+    auto domainName = QFileInfo(entitiesFileUrl.path()).baseName();
+    auto domainBaker = new DomainBaker(entitiesFileUrl, domainName, outputPath, destinationUrl, rebakeOriginals);
+    _baker = std::unique_ptr<Baker> { domainBaker };
+
+    if (!cacheDirectory.isEmpty()) {
+        auto bakeCache = std::make_shared<BakeCache>(cacheDirectory);
+        if (!bakeCache->isValid()) {
+            qCDebug(model_baking) << "Could not use bake cache folder" << cacheDirectory;
+            QCoreApplication::exit(OVEN_STATUS_CODE_FAIL);
+            return;
+        }
+        domainBaker->setBakeCache(bakeCache);
+    }
+
+    // the domain baker farms its sub-bakes out to the other worker threads
+    _baker->moveToThread(Oven::instance().getNextWorkerThread());
+
+    connect(_baker.get(), &Baker::finished, this, &BakerCLI::handleFinishedDomainBaker);
+
+    // invoke the bake method on the baker thread
+    QMetaObject::invokeMethod(_baker.get(), "bake");
+}
+
+void BakerCLI::handleFinishedDomainBaker() {
+    auto domainBaker = static_cast<DomainBaker*>(_baker.get());
+
+    // Avoid Qt log spam
+    for (const auto& warning : domainBaker->getWarnings()) {
+        std::cout << "Warning: " << warning.toStdString() << std::endl;
+    }
+    std::cout << "Baked domain with " << domainBaker->getNumCacheHits() << " assets restored from the bake cache" << std::endl;
+    std::cout << "Bake report: " << domainBaker->getReportFilePath().toStdString() << std::endl;
+
+    handleFinishedBaker();
+}
+
 void BakerCLI::handleFinishedBaker() {
     qCDebug(model_baking) << "Finished baking file.";
     int exitCode = OVEN_STATUS_CODE_SUCCESS;
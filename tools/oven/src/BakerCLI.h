@@ -35,9 +35,12 @@ public:
 
 public slots:
     void bakeFile(QUrl inputUrl, const QString& outputPath, const QString& type = QString::null);
+    void bakeDomain(QUrl entitiesFileUrl, const QString& outputPath, const QUrl& destinationUrl,
+                    const QString& cacheDirectory, bool rebakeOriginals);
 
 private slots:
     void handleFinishedBaker();  
+    void handleFinishedDomainBaker();
 
 private:
     QDir _outputPath;
@@ -12,15 +12,23 @@
 #include "DomainBaker.h"
 
 #include <QtConcurrent>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
 #include <QtCore/QEventLoop>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QJsonObject>
 
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <TextureMeta.h>
+
 #include "Gzip.h"
 #include "Oven.h"
 #include "baking/BakerLibrary.h"
 
+static const QString BAKE_REPORT_FILENAME = "bake-report.json";
+
 DomainBaker::DomainBaker(const QUrl& localModelFileURL, const QString& domainName,
                          const QString& baseOutputPath, const QUrl& destinationPath,
                          bool shouldRebakeOriginals) :
@@ -56,6 +64,8 @@ void DomainBaker::bake() {
         return;
     }
 
+    applyCachedBakes();
+
     // in case we've baked and re-written all of our entities already, check if we're done
     checkIfRewritingComplete();
 }
@@ -149,7 +159,16 @@ void DomainBaker::addModelBaker(const QString& property, const QString& url, con
     QUrl bakeableModelURL = getBakeableModelURL(url);
     if (!bakeableModelURL.isEmpty() && (_shouldRebakeOriginals || !isModelBaked(bakeableModelURL))) {
         // setup a ModelBaker for this URL, as long as we don't already have one
-        bool haveBaker = _modelBakers.contains(bakeableModelURL);
+        bool haveBaker = _modelBakers.contains(bakeableModelURL) || _cachedBakes.contains(bakeableModelURL.toString());
+        QString cacheKey;
+        if (!haveBaker && _bakeCache && bakeableModelURL.isLocalFile()) {
+            // The entry also records every other file the bake read, and only hits while they are unchanged.
+            // Those are resolved relative to the model, so its location is part of the key.
+            auto modelPath = QFileInfo(bakeableModelURL.toLocalFile()).absoluteFilePath();
+            cacheKey = _bakeCache->computeKey("model", { _bakeCache->hashFile(modelPath) },
+                                              { modelPath, QString::number(TextureBaker::isCompressionEnabled()) });
+            haveBaker = restoreModelFromCache(cacheKey, bakeableModelURL, url);
+        }
         if (!haveBaker) {
             QSharedPointer<ModelBaker> baker = QSharedPointer<ModelBaker>(getModelBaker(bakeableModelURL, _contentOutputPath).release(), &Baker::deleteLater);
             if (baker) {
@@ -167,6 +186,11 @@ void DomainBaker::addModelBaker(const QString& property, const QString& url, con
                 _modelBakers.insert(bakeableModelURL, baker);
                 haveBaker = true;
 
+                _bakeStartTimes.insert(bakeableModelURL.toString(), usecTimestampNow());
+                if (!cacheKey.isEmpty()) {
+                    _cacheKeys.insert(bakeableModelURL.toString(), cacheKey);
+                }
+
                 // move the baker to the baker thread
                 // and kickoff the bake
                 baker->moveToThread(Oven::instance().getNextWorkerThread());
@@ -194,11 +218,23 @@ void DomainBaker::addTextureBaker(const QString& property, const QString& url, i
         // grab a clean version of the URL without a query or fragment
         QUrl textureURL = QUrl(url).adjusted(QUrl::RemoveQuery | QUrl::RemoveFragment);
         TextureKey key = { textureURL, type };
+        // it doesn't really matter what this key is as long as it's consistent
+        QString rewriteKey = textureURL.toDisplayString() + "^" + QString::number(type);
 
         // setup a texture baker for this URL, as long as we aren't baking a texture already
-        if (!_textureBakers.contains(key)) {
+        if (!_textureBakers.contains(key) && !_cachedBakes.contains(rewriteKey)) {
             auto baseTextureFileName = _textureFileNamer.createBaseTextureFileName(textureURL.fileName(), type);
 
+            QString cacheKey;
+            if (_bakeCache && textureURL.isLocalFile()) {
+                cacheKey = _bakeCache->computeKey("texture", { _bakeCache->hashFile(textureURL.toLocalFile()) },
+                                                  { QString::number(type), QString::number(TextureBaker::isCompressionEnabled()) });
+                if (restoreTextureFromCache(cacheKey, rewriteKey, baseTextureFileName)) {
+                    _entitiesNeedingRewrite.insert(rewriteKey, { property, jsonRef });
+                    return;
+                }
+            }
+
             // setup a baker for this texture
             QSharedPointer<TextureBaker> textureBaker {
                 new TextureBaker(textureURL, type, _contentOutputPath, baseTextureFileName),
@@ -211,6 +247,11 @@ void DomainBaker::addTextureBaker(const QString& property, const QString& url, i
             // insert it into our bakers hash so we hold a strong pointer to it
             _textureBakers.insert(key, textureBaker);
 
+            _bakeStartTimes.insert(rewriteKey, usecTimestampNow());
+            if (!cacheKey.isEmpty()) {
+                _cacheKeys.insert(rewriteKey, cacheKey);
+            }
+
             // move the baker to a worker thread and kickoff the bake
             textureBaker->moveToThread(Oven::instance().getNextWorkerThread());
             QMetaObject::invokeMethod(textureBaker.data(), "bake", Qt::QueuedConnection);
@@ -221,8 +262,7 @@ void DomainBaker::addTextureBaker(const QString& property, const QString& url, i
 
         // add this QJsonValueRef to our multi hash so that it can re-write the texture URL
         // to the baked version once the baker is complete
-        // it doesn't really matter what this key is as long as it's consistent
-        _entitiesNeedingRewrite.insert(textureURL.toDisplayString() + "^" + QString::number(type), { property, jsonRef });
+        _entitiesNeedingRewrite.insert(rewriteKey, { property, jsonRef });
     } else {
         qDebug() << "Texture extension not supported: " << extension;
     }
@@ -246,6 +286,7 @@ void DomainBaker::addScriptBaker(const QString& property, const QString& url, co
 
         // insert it into our bakers hash so we hold a strong pointer to it
         _scriptBakers.insert(scriptURL, scriptBaker);
+        _bakeStartTimes.insert(scriptURL.toString(), usecTimestampNow());
 
         // move the baker to a worker thread and kickoff the bake
         scriptBaker->moveToThread(Oven::instance().getNextWorkerThread());
@@ -283,6 +324,7 @@ void DomainBaker::addMaterialBaker(const QString& property, const QString& data,
 
         // insert it into our bakers hash so we hold a strong pointer to it
         _materialBakers.insert(materialData, materialBaker);
+        _bakeStartTimes.insert(materialData, usecTimestampNow());
 
         // move the baker to a worker thread and kickoff the bake
         materialBaker->moveToThread(Oven::instance().getNextWorkerThread());
@@ -443,47 +485,28 @@ void DomainBaker::handleFinishedModelBaker() {
 
             QUrl newURL = _destinationPath.resolved(relativeMappingFilePath);
 
-            // enumerate the QJsonRef values for the URL of this model from our multi hash of
-            // entity objects needing a URL re-write
-            for (auto propertyEntityPair : _entitiesNeedingRewrite.values(baker->getOriginalInputModelURL())) {
-                QString property = propertyEntityPair.first;
-                // convert the entity QJsonValueRef to a QJsonObject so we can modify its URL
-                auto entity = propertyEntityPair.second.toObject();
+            // The fragment, query, and user info from the original model URL should now be present on the filename in the FST file
+            rewriteEntityURLs(baker->getOriginalInputModelURL(), newURL, false);
 
-                if (!property.contains(".")) {
-                    // grab the old URL
-                    QUrl oldURL = entity[property].toString();
-
-                    // set the new URL as the value in our temp QJsonObject
-                    // The fragment, query, and user info from the original model URL should now be present on the filename in the FST file
-                    entity[property] = newURL.toString();
-                } else {
-                    // Group property
-                    QStringList propertySplit = property.split(".");
-                    assert(propertySplit.length() == 2);
-                    // grab the old URL
-                    auto oldObject = entity[propertySplit[0]].toObject();
-                    QUrl oldURL = oldObject[propertySplit[1]].toString();
-
-                    // copy the fragment and query, and user info from the old model URL
-                    newURL.setQuery(oldURL.query());
-                    newURL.setFragment(oldURL.fragment());
-                    newURL.setUserInfo(oldURL.userInfo());
-
-                    // set the new URL as the value in our temp QJsonObject
-                    oldObject[propertySplit[1]] = newURL.toString();
-                    entity[propertySplit[0]] = oldObject;
-                }
-
-                // replace our temp object with the value referenced by our QJsonValueRef
-                propertyEntityPair.second = entity;
+            // The whole sub-folder the model was baked into is what gets cached
+            auto mappingFilePath = baker->getFullOutputMappingURL().adjusted(QUrl::RemoveQuery | QUrl::RemoveFragment | QUrl::RemoveUserInfo).toString();
+            auto modelOutputPath = QFileInfo(QFileInfo(mappingFilePath).absolutePath()).absolutePath();
+            QStringList outputFiles;
+            QDirIterator outputIterator(modelOutputPath, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+            while (outputIterator.hasNext()) {
+                outputFiles << outputIterator.next();
             }
+            storeInCache(baker->getOriginalInputModelURL().toString(), modelOutputPath, outputFiles, mappingFilePath,
+                         baker->getInputFiles());
         } else {
             // this model failed to bake - this doesn't fail the entire bake but we need to add
             // the errors from the model to our warnings
             _warningList << baker->getErrors();
         }
 
+        addReportEntry("model", baker->getOriginalInputModelURL().toString(), baker->getOriginalInputModelURL().toString(),
+                       false, baker->getErrors());
+
         // remove the baked URL from the multi hash of entities needing a re-write
         _entitiesNeedingRewrite.remove(baker->getOriginalInputModelURL());
 
@@ -514,52 +537,22 @@ void DomainBaker::handleFinishedTextureBaker() {
                 relativeTextureFilePath = relativeTextureFilePath.right(relativeTextureFilePath.length() - 1);
             }
             auto newURL = _destinationPath.resolved(relativeTextureFilePath);
+            rewriteEntityURLs(rewriteKey, newURL, true);
 
-            // enumerate the QJsonRef values for the URL of this texture from our multi hash of
-            // entity objects needing a URL re-write
-            for (auto propertyEntityPair : _entitiesNeedingRewrite.values(rewriteKey)) {
-                QString property = propertyEntityPair.first;
-                // convert the entity QJsonValueRef to a QJsonObject so we can modify its URL
-                auto entity = propertyEntityPair.second.toObject();
-
-                if (!property.contains(".")) {
-                    // grab the old URL
-                    QUrl oldURL = entity[property].toString();
-
-                    // copy the fragment and query, and user info from the old texture URL
-                    newURL.setQuery(oldURL.query());
-                    newURL.setFragment(oldURL.fragment());
-                    newURL.setUserInfo(oldURL.userInfo());
-
-                    // set the new URL as the value in our temp QJsonObject
-                    entity[property] = newURL.toString();
-                } else {
-                    // Group property
-                    QStringList propertySplit = property.split(".");
-                    assert(propertySplit.length() == 2);
-                    // grab the old URL
-                    auto oldObject = entity[propertySplit[0]].toObject();
-                    QUrl oldURL = oldObject[propertySplit[1]].toString();
-
-                    // copy the fragment and query, and user info from the old texture URL
-                    newURL.setQuery(oldURL.query());
-                    newURL.setFragment(oldURL.fragment());
-                    newURL.setUserInfo(oldURL.userInfo());
-
-                    // set the new URL as the value in our temp QJsonObject
-                    oldObject[propertySplit[1]] = newURL.toString();
-                    entity[propertySplit[0]] = oldObject;
-                }
-
-                // replace our temp object with the value referenced by our QJsonValueRef
-                propertyEntityPair.second = entity;
+            QStringList outputFiles;
+            for (const auto& file : baker->getOutputFiles()) {
+                outputFiles << file;
             }
+            storeInCache(rewriteKey.toString(), _contentOutputPath, outputFiles, baker->getMetaTextureFileName(),
+                         baker->getInputFiles());
         } else {
             // this texture failed to bake - this doesn't fail the entire bake but we need to add the errors from
             // the texture to our warnings
             _warningList << baker->getWarnings();
         }
 
+        addReportEntry("texture", rewriteKey.toString(), baker->getTextureURL().toDisplayString(), false, baker->getErrors());
+
         // remove the baked URL from the multi hash of entities needing a re-write
         _entitiesNeedingRewrite.remove(rewriteKey);
 
@@ -588,52 +581,15 @@ void DomainBaker::handleFinishedScriptBaker() {
                 relativeScriptFilePath = relativeScriptFilePath.right(relativeScriptFilePath.length() - 1);
             }
             auto newURL = _destinationPath.resolved(relativeScriptFilePath);
-
-            // enumerate the QJsonRef values for the URL of this script from our multi hash of
-            // entity objects needing a URL re-write
-            for (auto propertyEntityPair : _entitiesNeedingRewrite.values(baker->getJSPath())) {
-                QString property = propertyEntityPair.first;
-                // convert the entity QJsonValueRef to a QJsonObject so we can modify its URL
-                auto entity = propertyEntityPair.second.toObject();
-
-                if (!property.contains(".")) {
-                    // grab the old URL
-                    QUrl oldURL = entity[property].toString();
-
-                    // copy the fragment and query, and user info from the old script URL
-                    newURL.setQuery(oldURL.query());
-                    newURL.setFragment(oldURL.fragment());
-                    newURL.setUserInfo(oldURL.userInfo());
-
-                    // set the new URL as the value in our temp QJsonObject
-                    entity[property] = newURL.toString();
-                } else {
-                    // Group property
-                    QStringList propertySplit = property.split(".");
-                    assert(propertySplit.length() == 2);
-                    // grab the old URL
-                    auto oldObject = entity[propertySplit[0]].toObject();
-                    QUrl oldURL = oldObject[propertySplit[1]].toString();
-
-                    // copy the fragment and query, and user info from the old script URL
-                    newURL.setQuery(oldURL.query());
-                    newURL.setFragment(oldURL.fragment());
-                    newURL.setUserInfo(oldURL.userInfo());
-
-                    // set the new URL as the value in our temp QJsonObject
-                    oldObject[propertySplit[1]] = newURL.toString();
-                    entity[propertySplit[0]] = oldObject;
-                }
-
-                // replace our temp object with the value referenced by our QJsonValueRef
-                propertyEntityPair.second = entity;
-            }
+            rewriteEntityURLs(baker->getJSPath(), newURL, true);
         } else {
             // this script failed to bake - this doesn't fail the entire bake but we need to add
             // the errors from the script to our warnings
             _warningList << baker->getErrors();
         }
 
+        addReportEntry("script", baker->getJSPath().toString(), baker->getJSPath().toString(), false, baker->getErrors());
+
         // remove the baked URL from the multi hash of entities needing a re-write
         _entitiesNeedingRewrite.remove(baker->getJSPath());
 
@@ -724,6 +680,9 @@ void DomainBaker::handleFinishedMaterialBaker() {
             _warningList << baker->getErrors();
         }
 
+        addReportEntry("material", baker->getMaterialData(), baker->isURL() ? baker->getMaterialData() : MATERIAL_DATA_KEY,
+                       false, baker->getErrors());
+
         // remove the baked URL from the multi hash of entities needing a re-write
         _entitiesNeedingRewrite.remove(baker->getMaterialData());
 
@@ -738,6 +697,187 @@ void DomainBaker::handleFinishedMaterialBaker() {
     }
 }
 
+void DomainBaker::rewriteEntityURLs(const QUrl& rewriteKey, QUrl newURL, bool copyURLSuffixToTopLevel) {
+    // enumerate the QJsonRef values for this URL from our multi hash of entity objects needing a URL re-write
+    for (auto propertyEntityPair : _entitiesNeedingRewrite.values(rewriteKey)) {
+        QString property = propertyEntityPair.first;
+        // convert the entity QJsonValueRef to a QJsonObject so we can modify its URL
+        auto entity = propertyEntityPair.second.toObject();
+
+        if (!property.contains(".")) {
+            // grab the old URL
+            QUrl oldURL = entity[property].toString();
+
+            // copy the fragment and query, and user info from the old URL
+            if (copyURLSuffixToTopLevel) {
+                newURL.setQuery(oldURL.query());
+                newURL.setFragment(oldURL.fragment());
+                newURL.setUserInfo(oldURL.userInfo());
+            }
+
+            // set the new URL as the value in our temp QJsonObject
+            entity[property] = newURL.toString();
+        } else {
+            // Group property
+            QStringList propertySplit = property.split(".");
+            assert(propertySplit.length() == 2);
+            // grab the old URL
+            auto oldObject = entity[propertySplit[0]].toObject();
+            QUrl oldURL = oldObject[propertySplit[1]].toString();
+
+            // copy the fragment and query, and user info from the old URL
+            newURL.setQuery(oldURL.query());
+            newURL.setFragment(oldURL.fragment());
+            newURL.setUserInfo(oldURL.userInfo());
+
+            // set the new URL as the value in our temp QJsonObject
+            oldObject[propertySplit[1]] = newURL.toString();
+            entity[propertySplit[0]] = oldObject;
+        }
+
+        // replace our temp object with the value referenced by our QJsonValueRef
+        propertyEntityPair.second = entity;
+    }
+}
+
+void DomainBaker::applyCachedBakes() {
+    for (auto it = _cachedBakes.constBegin(); it != _cachedBakes.constEnd(); ++it) {
+        rewriteEntityURLs(it.key(), it.value().newURL, it.value().copyURLSuffixToTopLevel);
+        _entitiesNeedingRewrite.remove(it.key());
+    }
+
+    if (!_cachedBakes.isEmpty()) {
+        _totalNumberOfSubBakes += _cachedBakes.size();
+        _completedSubBakes += _cachedBakes.size();
+        emit bakeProgress(_completedSubBakes, _totalNumberOfSubBakes);
+    }
+}
+
+bool DomainBaker::restoreModelFromCache(const QString& cacheKey, const QUrl& bakeableModelURL, const QString& url) {
+    BakeCache::Entry entry;
+    if (!_bakeCache->lookup(cacheKey, entry)) {
+        return false;
+    }
+
+    auto rewriteKey = bakeableModelURL.toString();
+    _bakeStartTimes.insert(rewriteKey, usecTimestampNow());
+
+    // Pick a unique sub-folder the same way getModelBaker does
+    auto filename = bakeableModelURL.fileName();
+    auto baseName = filename.left(filename.lastIndexOf('.')).left(filename.lastIndexOf(".baked"));
+    auto subDirName = "/" + baseName;
+    int i = 1;
+    while (QDir(_contentOutputPath + subDirName).exists()) {
+        subDirName = "/" + baseName + "-" + QString::number(i++);
+    }
+    auto modelOutputPath = _contentOutputPath + subDirName;
+
+    if (!_bakeCache->restore(entry, modelOutputPath)) {
+        QDir(modelOutputPath).removeRecursively();
+        _bakeStartTimes.remove(rewriteKey);
+        return false;
+    }
+
+    auto relativeMappingFilePath = QDir(_contentOutputPath).relativeFilePath(modelOutputPath + "/" + entry.result);
+    QUrl newURL = _destinationPath.resolved(relativeMappingFilePath);
+
+    // keep the suffix ModelBaker::getFullOutputMappingURL would have kept
+    QUrl outputURLSuffix = url;
+    newURL.setQuery(outputURLSuffix.query());
+    newURL.setFragment(outputURLSuffix.fragment());
+    newURL.setUserInfo(outputURLSuffix.userInfo());
+
+    qDebug() << "Restored" << bakeableModelURL << "from the bake cache";
+    _cachedBakes.insert(rewriteKey, { newURL, false });
+    addReportEntry("model", rewriteKey, rewriteKey, true, QStringList());
+    ++_numCacheHits;
+    return true;
+}
+
+bool DomainBaker::restoreTextureFromCache(const QString& cacheKey, const QString& rewriteKey, const QString& baseTextureFileName) {
+    BakeCache::Entry entry;
+    if (!_bakeCache->lookup(cacheKey, entry) || !entry.result.endsWith(BAKED_META_TEXTURE_SUFFIX)) {
+        return false;
+    }
+
+    _bakeStartTimes.insert(rewriteKey, usecTimestampNow());
+
+    // Every file of a baked texture is named after its base name, which is only unique within a single bake
+    auto cachedBaseName = entry.result.left(entry.result.length() - BAKED_META_TEXTURE_SUFFIX.length());
+    auto renameFile = [&](const QString& file) {
+        return file.startsWith(cachedBaseName) ? baseTextureFileName + file.mid(cachedBaseName.length()) : file;
+    };
+
+    bool restored = _bakeCache->restore(entry, _contentOutputPath, renameFile);
+
+    // the meta file refers to the other files by name
+    auto metaFilePath = QDir(_contentOutputPath).absoluteFilePath(renameFile(entry.result));
+    TextureMeta meta;
+    QFile metaFile { metaFilePath };
+    restored = restored && metaFile.open(QIODevice::ReadOnly) && TextureMeta::deserialize(metaFile.readAll(), &meta);
+    metaFile.close();
+    if (restored) {
+        auto renameURL = [&](const QUrl& fileURL) {
+            return fileURL.isEmpty() ? fileURL : QUrl(renameFile(fileURL.toString()));
+        };
+        meta.original = renameURL(meta.original);
+        meta.uncompressed = renameURL(meta.uncompressed);
+        for (auto& textureType : meta.availableTextureTypes) {
+            textureType.second = renameURL(textureType.second);
+        }
+        restored = metaFile.open(QIODevice::WriteOnly | QIODevice::Truncate) && metaFile.write(meta.serialize()) != -1;
+    }
+
+    if (!restored) {
+        _bakeStartTimes.remove(rewriteKey);
+        return false;
+    }
+
+    auto newURL = _destinationPath.resolved(QDir(_contentOutputPath).relativeFilePath(metaFilePath));
+    qDebug() << "Restored" << rewriteKey << "from the bake cache";
+    _cachedBakes.insert(rewriteKey, { newURL, true });
+    addReportEntry("texture", rewriteKey, rewriteKey.left(rewriteKey.lastIndexOf('^')), true, QStringList());
+    ++_numCacheHits;
+    return true;
+}
+
+void DomainBaker::storeInCache(const QString& rewriteKey, const QString& sourceRoot, const QStringList& files, const QString& result,
+                               const std::vector<QString>& inputFiles) {
+    auto cacheKey = _cacheKeys.take(rewriteKey);
+    if (!_bakeCache || cacheKey.isEmpty()) {
+        return;
+    }
+
+    QStringList inputFileList;
+    for (const auto& inputFile : inputFiles) {
+        inputFileList << inputFile;
+    }
+
+    auto bakeTimeMsecs = (qint64)((usecTimestampNow() - _bakeStartTimes.value(rewriteKey)) / USECS_PER_MSEC);
+    if (!_bakeCache->store(cacheKey, sourceRoot, files, result, inputFileList, bakeTimeMsecs)) {
+        qWarning() << "Could not add" << rewriteKey << "to the bake cache";
+    }
+}
+
+void DomainBaker::addReportEntry(const QString& type, const QString& rewriteKey, const QString& input, bool cacheHit, const QStringList& errors) {
+    auto startTime = _bakeStartTimes.take(rewriteKey);
+
+    QJsonObject entry;
+    entry["type"] = type;
+    entry["input"] = input;
+    entry["cacheHit"] = cacheHit;
+    entry["succeeded"] = errors.isEmpty();
+    entry["timeMsecs"] = (double)((usecTimestampNow() - startTime) / USECS_PER_MSEC);
+    if (!errors.isEmpty()) {
+        entry["errors"] = QJsonArray::fromStringList(errors);
+    }
+    _report.append(entry);
+}
+
+QString DomainBaker::getReportFilePath() const {
+    return QDir(_uniqueOutputPath).filePath(BAKE_REPORT_FILENAME);
+}
+
 void DomainBaker::checkIfRewritingComplete() {
     if (_entitiesNeedingRewrite.isEmpty()) {
         writeNewEntitiesFile();
@@ -746,6 +886,15 @@ void DomainBaker::checkIfRewritingComplete() {
             return;
         }
 
+        writeBakeReport();
+
+        if (_bakeCache) {
+            auto numEvicted = _bakeCache->evict();
+            if (numEvicted > 0) {
+                qDebug() << "Evicted" << numEvicted << "entries from the bake cache";
+            }
+        }
+
         // we've now written out our new models file - time to say that we are finished up
         emit finished();
     }
@@ -783,3 +932,32 @@ void DomainBaker::writeNewEntitiesFile() {
 
     qDebug() << "Exported baked entities file to" << bakedEntitiesFilePath;
 }
+
+void DomainBaker::writeBakeReport() {
+    qint64 totalTimeMsecs = 0;
+    int numFailed = 0;
+    for (const auto& value : _report) {
+        auto entry = value.toObject();
+        totalTimeMsecs += (qint64)entry["timeMsecs"].toDouble();
+        if (!entry["succeeded"].toBool()) {
+            ++numFailed;
+        }
+    }
+
+    QJsonObject json;
+    json["numAssets"] = _report.size();
+    json["numCacheHits"] = _numCacheHits;
+    json["numFailed"] = numFailed;
+    json["totalBakeTimeMsecs"] = (double)totalTimeMsecs;
+    json["cacheDirectory"] = _bakeCache ? _bakeCache->getPath() : QString();
+    json["assets"] = _report;
+
+    QFile reportFile { getReportFilePath() };
+    if (!reportFile.open(QIODevice::WriteOnly) || reportFile.write(QJsonDocument(json).toJson()) == -1) {
+        // the report is informational, not being able to write it doesn't fail the bake
+        qWarning() << "Could not write bake report to" << reportFile.fileName();
+        return;
+    }
+
+    qDebug() << "Baked" << _report.size() << "assets," << _numCacheHits << "from the bake cache, report written to" << reportFile.fileName();
+}
@@ -18,10 +18,13 @@
 #include <QtCore/QUrl>
 #include <QtCore/QThread>
 
+#include <memory>
+
 #include "ModelBaker.h"
 #include "TextureBaker.h"
 #include "JSBaker.h"
 #include "MaterialBaker.h"
+#include "BakeCache.h"
 
 class DomainBaker : public Baker {
     Q_OBJECT
@@ -33,6 +36,12 @@ public:
                 const QString& baseOutputPath, const QUrl& destinationPath,
                 bool shouldRebakeOriginals);
 
+    // Models and textures read from local files are looked up in, and added to, this cache
+    void setBakeCache(const std::shared_ptr<BakeCache>& bakeCache) { _bakeCache = bakeCache; }
+
+    QString getReportFilePath() const;
+    int getNumCacheHits() const { return _numCacheHits; }
+
 signals:
     void allModelsFinished();
     void bakeProgress(int baked, int total);
@@ -50,6 +59,15 @@ private:
     void enumerateEntities();
     void checkIfRewritingComplete();
     void writeNewEntitiesFile();
+    void writeBakeReport();
+
+    void rewriteEntityURLs(const QUrl& rewriteKey, QUrl newURL, bool copyURLSuffixToTopLevel);
+    void applyCachedBakes();
+    bool restoreModelFromCache(const QString& cacheKey, const QUrl& bakeableModelURL, const QString& url);
+    bool restoreTextureFromCache(const QString& cacheKey, const QString& rewriteKey, const QString& baseTextureFileName);
+    void storeInCache(const QString& rewriteKey, const QString& sourceRoot, const QStringList& files, const QString& result,
+                      const std::vector<QString>& inputFiles);
+    void addReportEntry(const QString& type, const QString& rewriteKey, const QString& input, bool cacheHit, const QStringList& errors);
 
     QUrl _localEntitiesFileURL;
     QString _domainName;
@@ -76,6 +94,17 @@ private:
 
     bool _shouldRebakeOriginals { false };
 
+    std::shared_ptr<BakeCache> _bakeCache;
+    QHash<QString, QString> _cacheKeys; // rewrite key to the cache key of a bake in progress
+    struct CachedBake {
+        QUrl newURL;
+        bool copyURLSuffixToTopLevel;
+    };
+    QHash<QString, CachedBake> _cachedBakes; // rewrite key to a bake restored from the cache
+    QHash<QString, quint64> _bakeStartTimes;
+    QJsonArray _report;
+    int _numCacheHits { 0 };
+
     void addModelBaker(const QString& property, const QString& url, const QJsonValueRef& jsonRef);
     void addTextureBaker(const QString& property, const QString& url, image::TextureUsage::Type type, const QJsonValueRef& jsonRef);
     void addScriptBaker(const QString& property, const QString& url, const QJsonValueRef& jsonRef);
@@ -25,17 +25,31 @@ static const QString CLI_INPUT_PARAMETER = "i";
 static const QString CLI_OUTPUT_PARAMETER = "o";
 static const QString CLI_TYPE_PARAMETER = "t";
 static const QString CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER = "disable-texture-compression";
+static const QString CLI_DESTINATION_PARAMETER = "destination";
+static const QString CLI_CACHE_PARAMETER = "cache";
+static const QString CLI_REBAKE_ORIGINALS_PARAMETER = "rebake-originals";
+
+static const QString DOMAIN_TYPE = "domain";
 
 QUrl OvenCLIApplication::_inputUrlParameter;
 QUrl OvenCLIApplication::_outputUrlParameter;
 QString OvenCLIApplication::_typeParameter;
+QUrl OvenCLIApplication::_destinationUrlParameter;
+QString OvenCLIApplication::_cacheDirectoryParameter;
+bool OvenCLIApplication::_rebakeOriginalsParameter { false };
 
 OvenCLIApplication::OvenCLIApplication(int argc, char* argv[]) :
     QCoreApplication(argc, argv)
 {
     BakerCLI* cli = new BakerCLI(this);
-    QMetaObject::invokeMethod(cli, "bakeFile", Qt::QueuedConnection, Q_ARG(QUrl, _inputUrlParameter),
-                              Q_ARG(QString, _outputUrlParameter.toString()), Q_ARG(QString, _typeParameter));
+    if (_typeParameter == DOMAIN_TYPE) {
+        QMetaObject::invokeMethod(cli, "bakeDomain", Qt::QueuedConnection, Q_ARG(QUrl, _inputUrlParameter),
+                                  Q_ARG(QString, _outputUrlParameter.toString()), Q_ARG(QUrl, _destinationUrlParameter),
+                                  Q_ARG(QString, _cacheDirectoryParameter), Q_ARG(bool, _rebakeOriginalsParameter));
+    } else {
+        QMetaObject::invokeMethod(cli, "bakeFile", Qt::QueuedConnection, Q_ARG(QUrl, _inputUrlParameter),
+                                  Q_ARG(QString, _outputUrlParameter.toString()), Q_ARG(QString, _typeParameter));
+    }
 }
 
 void OvenCLIApplication::parseCommandLine(int argc, char* argv[]) {
@@ -46,8 +60,11 @@ void OvenCLIApplication::parseCommandLine(int argc, char* argv[]) {
     parser.addOptions({
         { CLI_INPUT_PARAMETER, "Path to file that you would like to bake.", "input" },
         { CLI_OUTPUT_PARAMETER, "Path to folder that will be used as output.", "output" },
-        { CLI_TYPE_PARAMETER, "Type of asset. [model|material]"/*|js]"*/, "type" },
-        { CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER, "Disable texture compression." }
+        { CLI_TYPE_PARAMETER, "Type of asset. [model|material|domain]"/*|js]"*/, "type" },
+        { CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER, "Disable texture compression." },
+        { CLI_DESTINATION_PARAMETER, "URL prefix the baked domain assets will be served from (domain only).", "destination" },
+        { CLI_CACHE_PARAMETER, "Folder to keep baked assets in, so unchanged assets are not baked again (domain only).", "cache" },
+        { CLI_REBAKE_ORIGINALS_PARAMETER, "Re-bake models that are already baked (domain only)." }
     });
 
     auto versionOption = parser.addVersionOption();
@@ -87,6 +104,18 @@ void OvenCLIApplication::parseCommandLine(int argc, char* argv[]) {
 
     _typeParameter = parser.isSet(CLI_TYPE_PARAMETER) ? parser.value(CLI_TYPE_PARAMETER) : QString::null;
 
+    if (_typeParameter == DOMAIN_TYPE) {
+        if (!parser.isSet(CLI_DESTINATION_PARAMETER)) {
+            std::cout << "Error: Destination not set" << std::endl; // Avoid Qt log spam
+            QCoreApplication mockApp(argc, argv); // required for call to showHelp()
+            parser.showHelp();
+            Q_UNREACHABLE();
+        }
+        _destinationUrlParameter = parser.value(CLI_DESTINATION_PARAMETER);
+        _cacheDirectoryParameter = parser.isSet(CLI_CACHE_PARAMETER) ? parser.value(CLI_CACHE_PARAMETER) : QString();
+        _rebakeOriginalsParameter = parser.isSet(CLI_REBAKE_ORIGINALS_PARAMETER);
+    }
+
     if (parser.isSet(CLI_DISABLE_TEXTURE_COMPRESSION_PARAMETER)) {
         qDebug() << "Disabling texture compression";
         TextureBaker::setCompressionEnabled(false);
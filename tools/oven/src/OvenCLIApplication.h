@@ -29,6 +29,9 @@ private:
     static QUrl _inputUrlParameter;
     static QUrl _outputUrlParameter;
     static QString _typeParameter;
+    static QUrl _destinationUrlParameter;
+    static QString _cacheDirectoryParameter;
+    static bool _rebakeOriginalsParameter;
 };
 
 #endif // hifi_OvenCLIApplication_h
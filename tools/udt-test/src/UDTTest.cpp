@@ -11,13 +11,25 @@
 
 #include "UDTTest.h"
 
+#include <algorithm>
+#include <limits>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
 #include <QtCore/QDebug>
+#include <QtCore/QThread>
 
+#include <udt/CongestionControl.h>
 #include <udt/Constants.h>
 #include <udt/Packet.h>
 #include <udt/PacketList.h>
+#include <udt/SendScheduler.h>
 
 #include <LogHandler.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
 
 const QCommandLineOption PORT_OPTION { "p", "listening port for socket (defaults to random)", "port", 0 };
 const QCommandLineOption TARGET_OPTION {
@@ -55,6 +67,51 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption PACING_CONNECTIONS {
+    "pacing-connections", "run the pacing scenario over this many local connections, e.g. 10, 100 or 1000", "connections"
+};
+const QCommandLineOption PACING_RATE {
+    "pacing-rate", "packets per second per connection in the pacing scenario (default is 100)", "packets"
+};
+const QCommandLineOption PACING_DURATION {
+    "pacing-duration", "seconds to measure the pacing scenario for (default is 10)", "seconds"
+};
+
+// Holds the packet send period at the scenario rate, so pacing is measured against a known target
+class FixedRateCC : public udt::CongestionControl {
+public:
+    FixedRateCC(int packetsPerSecond) {
+        _packetSendPeriod = (double)USECS_PER_SECOND / packetsPerSecond;
+        _congestionWindowSize = 1000;
+    }
+
+    virtual int estimatedTimeout() const override { return 100 * USECS_PER_MSEC; }
+
+protected:
+    virtual void setInitialSendSequenceNumber(udt::SequenceNumber seqNum) override {}
+};
+
+class FixedRateCCFactory : public udt::CongestionControlVirtualFactory {
+public:
+    FixedRateCCFactory(int packetsPerSecond) : _packetsPerSecond(packetsPerSecond) {}
+    virtual std::unique_ptr<udt::CongestionControl> create() override {
+        return std::unique_ptr<udt::CongestionControl>(new FixedRateCC(_packetsPerSecond));
+    }
+
+private:
+    int _packetsPerSecond;
+};
+
+static quint64 getProcessCPUUsecs() {
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (quint64)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * USECS_PER_SECOND
+        + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#else
+    return 0;
+#endif
+}
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (Mb/s)", "Est. Max (Mb/s)", "RTT (ms)", "CW (P)", "Period (us)",
@@ -76,6 +133,17 @@ UDTTest::UDTTest(int& argc, char** argv) :
 
     _socket.bind(QHostAddress::AnyIPv4, _argumentParser.value(PORT_OPTION).toUInt());
     qDebug() << "Test socket is listening on" << _socket.localPort();
+
+    if (_argumentParser.isSet(PACING_CONNECTIONS)) {
+        if (_argumentParser.isSet(PACING_RATE)) {
+            _pacingRate = std::max(1, _argumentParser.value(PACING_RATE).toInt());
+        }
+        if (_argumentParser.isSet(PACING_DURATION)) {
+            _pacingDuration = std::max(1, _argumentParser.value(PACING_DURATION).toInt());
+        }
+        startPacingScenario(_argumentParser.value(PACING_CONNECTIONS).toInt());
+        return;
+    }
     
     if (_argumentParser.isSet(TARGET_OPTION)) {
         // parse the IP and port combination for this target
@@ -224,7 +292,7 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, PACING_CONNECTIONS, PACING_RATE, PACING_DURATION
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -331,6 +399,90 @@ void UDTTest::sendPacket() {
     
 }
 
+static const int PACING_REFILL_INTERVAL_MSECS = 100;
+static const int PACING_PAYLOAD_SIZE = 100;
+
+void UDTTest::startPacingScenario(int connections) {
+    if (connections <= 0) {
+        qCritical() << "The pacing scenario needs at least one connection.";
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        return;
+    }
+
+    _pacingTarget = HifiSockAddr(QHostAddress::LocalHost, _socket.localPort());
+    for (int i = 0; i < connections; ++i) {
+        auto socket = std::unique_ptr<udt::Socket>(new udt::Socket());
+        socket->setCongestionControlFactory(std::unique_ptr<udt::CongestionControlVirtualFactory>(
+            new FixedRateCCFactory(_pacingRate)));
+        socket->bind(QHostAddress::LocalHost);
+        _pacingSockets.push_back(std::move(socket));
+    }
+
+    qDebug() << "Pacing" << connections << "connections at" << _pacingRate << "packets per second each, on"
+        << udt::SendScheduler::getInstance().getThreadCount() << "send threads";
+
+    // start with two refills worth of backlog, so that the queues never run dry between refills
+    refillPacingQueues();
+    refillPacingQueues();
+
+    QTimer* refillTimer = new QTimer(this);
+    connect(refillTimer, &QTimer::timeout, this, &UDTTest::refillPacingQueues);
+    refillTimer->start(PACING_REFILL_INTERVAL_MSECS);
+
+    // give the handshakes and the first sends a second to settle before we measure
+    QTimer::singleShot(MSECS_PER_SECOND, this, &UDTTest::startPacingMeasurement);
+}
+
+void UDTTest::refillPacingQueues() {
+    int packetsPerRefill = std::max(1, (_pacingRate * PACING_REFILL_INTERVAL_MSECS) / (int)MSECS_PER_SECOND);
+    for (auto& socket : _pacingSockets) {
+        for (int i = 0; i < packetsPerRefill; ++i) {
+            auto packet = udt::Packet::create(PACING_PAYLOAD_SIZE, true);
+            packet->setPayloadSize(PACING_PAYLOAD_SIZE);
+            socket->writePacket(std::move(packet), _pacingTarget);
+        }
+    }
+}
+
+void UDTTest::startPacingMeasurement() {
+    // sampling resets the connection counters
+    for (auto& socket : _pacingSockets) {
+        socket->sampleStatsForConnection(_pacingTarget);
+    }
+    _pacingStartUsecs = usecTimestampNow();
+    _pacingStartCPUUsecs = getProcessCPUUsecs();
+
+    QTimer::singleShot(_pacingDuration * MSECS_PER_SECOND, this, &UDTTest::finishPacingMeasurement);
+}
+
+void UDTTest::finishPacingMeasurement() {
+    double elapsedSeconds = (double)(usecTimestampNow() - _pacingStartUsecs) / USECS_PER_SECOND;
+    double cpuSeconds = (double)(getProcessCPUUsecs() - _pacingStartCPUUsecs) / USECS_PER_SECOND;
+    double expectedPackets = _pacingRate * elapsedSeconds;
+
+    // pacing accuracy is the packets each connection put on the wire over the ones its send period allows
+    double minAccuracy = std::numeric_limits<double>::max();
+    double maxAccuracy = 0.0;
+    double totalAccuracy = 0.0;
+    for (auto& socket : _pacingSockets) {
+        auto stats = socket->sampleStatsForConnection(_pacingTarget);
+        double accuracy = (stats.sentPackets + stats.retransmittedPackets) / expectedPackets;
+        minAccuracy = std::min(minAccuracy, accuracy);
+        maxAccuracy = std::max(maxAccuracy, accuracy);
+        totalAccuracy += accuracy;
+    }
+
+    qDebug() << "Connections:" << _pacingSockets.size()
+        << "| Send threads:" << udt::SendScheduler::getInstance().getThreadCount()
+        << "| CPU:" << QString::number(100.0 * cpuSeconds / elapsedSeconds, 'f', 1) + "%"
+        << "| Pacing accuracy mean/min/max:"
+        << QString::number(100.0 * totalAccuracy / _pacingSockets.size(), 'f', 1) + "%"
+        << QString::number(100.0 * minAccuracy, 'f', 1) + "%"
+        << QString::number(100.0 * maxAccuracy, 'f', 1) + "%";
+
+    QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+}
+
 void UDTTest::handleMessage(std::unique_ptr<Message> message) {
     // generate the byte array that should match this message - using the same seed the sender did
     
@@ -15,7 +15,9 @@
 #define hifi_UDTTest_h
 
 
+#include <memory>
 #include <random>
+#include <vector>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QCommandLineParser>
@@ -38,6 +40,10 @@ public:
 public slots:
     void refillPacket() { sendPacket(); } // adds a new packet to the queue when we are told one is sent
     void sampleStats();
+
+    void refillPacingQueues(); // keeps every pacing connection backlogged
+    void startPacingMeasurement();
+    void finishPacingMeasurement();
     
 private:
     void parseArguments();
@@ -45,6 +51,9 @@ private:
     
     void sendInitialPackets(); // fills the queue with packets to start
     void sendPacket(); // constructs and sends a packet according to the test parameters
+
+    // paces packets from many local sockets to ours at a fixed rate, and reports CPU use and pacing accuracy
+    void startPacingScenario(int connections);
     
     QCommandLineParser _argumentParser;
     udt::Socket _socket;
@@ -71,6 +80,13 @@ private:
     int _totalQueuedBytes { 0 }; // keeps track of the number of bytes we have already queued
     
     int _statsInterval { 100 }; // recording interval for stats in milliseconds
+
+    std::vector<std::unique_ptr<udt::Socket>> _pacingSockets; // one connection to our socket per pacing socket
+    HifiSockAddr _pacingTarget;
+    int _pacingRate { 100 }; // packets per second per connection
+    int _pacingDuration { 10 }; // measured seconds, after one second of warm up
+    quint64 _pacingStartUsecs { 0 };
+    quint64 _pacingStartCPUUsecs { 0 };
 };
 
 #endif // hifi_UDTTest_h